@@ -41,6 +41,8 @@ constexpr const char* distanceThreshold = "distance_threshold";
 constexpr const char* wavefunctionOutput = "wavefunction";
 constexpr const char* thermochemistry = "thermochemistry";
 constexpr const char* unrestrictedCalculation = "unrestricted_calculation";
+constexpr const char* checkpointKey = "checkpoint";
+constexpr const char* checkpointFile = "checkpoint_file";
 
 } // namespace
 
@@ -89,6 +91,7 @@ CommandLineOptions::CommandLineOptions(int argc, char* argv[]) : pImpl_(std::mak
   auto descriptionOption = combineNamesForOptions(calculationDescription, ",D");
   auto logOption = combineNamesForOptions(Utils::SettingsNames::loggerVerbosity, ",l");
   auto logFilenameOption = combineNamesForOptions(logFilename, ",f");
+  auto checkpointOption = combineNamesForOptions(checkpointKey, ",K");
 
   // clang-format off
   pImpl_->desc_.add_options()
@@ -131,6 +134,8 @@ CommandLineOptions::CommandLineOptions(int argc, char* argv[]) : pImpl_(std::mak
     (maxMemoryOption.c_str(), value<double>(), "sets the maximum amount of memory that can be used by the calculation")
     (wavefunctionOption.c_str(), "outputs a molden file for the visualization of orbitals")
     (descriptionOption.c_str(), value<std::string>(), "sets a calculation description which will appear in the output")
+    (checkpointOption.c_str(), value<std::string>(), "sets the checkpoint file from which an interrupted calculation is resumed "
+     "and to which finished steps are saved")
     (logOption.c_str(), value<std::string>()->default_value("warning"), "sets whether warnings and errors are printed. Levels other than"
      "none, error, warning, output, debug throw an exception.")
     (logFilenameOption.c_str(), value<std::string>()->default_value(""), "Sets the name of the file where the logging is piped.");
@@ -235,6 +240,17 @@ bool CommandLineOptions::pruneBasis() const {
   return pImpl_->vm_.count(Utils::SettingsNames::pruneBasis) > 0;
 }
 
+bool CommandLineOptions::checkpointRequired() const {
+  return pImpl_->vm_.count(checkpointKey) > 0;
+}
+
+std::string CommandLineOptions::getCheckpointFile() const {
+  if (pImpl_->vm_.count(checkpointKey) > 0) {
+    return pImpl_->vm_[checkpointKey].as<std::string>();
+  }
+  return "";
+}
+
 template<class CharPtrType, class StringType>
 std::string CommandLineOptions::combineNamesForOptions(CharPtrType nameOfOption, StringType abbreviatedOption) const {
   auto combinedString = static_cast<std::string>(nameOfOption) + static_cast<std::string>(abbreviatedOption);
@@ -321,6 +337,10 @@ void CommandLineOptions::updateSettings(Utils::Settings& settingsToUpdate) const
   if (validOptionToSet(symmetryNumber, settingsToUpdate)) {
     settingsToUpdate.modifyInt(symmetryNumber, pImpl_->vm_[symmetryNumber].as<int>());
   }
+  // The calculators restore from and save to the checkpoint themselves
+  if (checkpointRequired() && settingsToUpdate.valueExists(checkpointFile)) {
+    settingsToUpdate.modifyString(checkpointFile, getCheckpointFile());
+  }
 }
 
 void CommandLineOptions::updateExcitedStatesSettings(Utils::Settings& settingsToUpdate) const {
@@ -352,6 +372,9 @@ void CommandLineOptions::updateExcitedStatesSettings(Utils::Settings& settingsTo
   if (validOptionToSet(distanceThreshold, settingsToUpdate)) {
     settingsToUpdate.modifyDouble(distanceThreshold, pImpl_->vm_[distanceThreshold].as<double>());
   }
+  if (checkpointRequired() && settingsToUpdate.valueExists(checkpointFile)) {
+    settingsToUpdate.modifyString(checkpointFile, getCheckpointFile());
+  }
   if (pruneBasis()) { // If new pruning methods are implemented, this needs to change.
     if (validOptionToSet(SettingsNames::pruneBasis, settingsToUpdate)) {
       settingsToUpdate.modifyString(SettingsNames::pruneBasis, "energy");
@@ -72,6 +72,10 @@ class CommandLineOptions {
   bool thermochemistryRequired() const;
   /** @brief returns whether the excited state basis needs to be pruned. */
   bool pruneBasis() const;
+  /** @brief returns whether the calculation is checkpointed. */
+  bool checkpointRequired() const;
+  /** @brief returns the checkpoint file, empty if none is given. */
+  std::string getCheckpointFile() const;
 
   /** @brief updates a logger with the verbosity parsed from the command line. */
   void updateLogger(Core::Log& log) const;
@@ -19,7 +19,10 @@ file(GLOB_RECURSE SPARROW_TEST_CPPS ${CMAKE_CURRENT_SOURCE_DIR}/Tests/*.cpp)
 list(FILTER SPARROW_TEST_CPPS EXCLUDE REGEX ".*Slow.*Test.cpp")
 set(SPARROW_TEST_SLOW_FILES
   ${CMAKE_CURRENT_SOURCE_DIR}/Tests/Dipole/SlowDipoleTest.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/Tests/MethodsTests/SlowFragmentDensityGuessTest.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/Tests/MethodsTests/SlowScfAcceleratorTest.cpp
   ${CMAKE_CURRENT_SOURCE_DIR}/Tests/TimeDependent/SlowExcitedStatesTest.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/Tests/TimeDependent/SlowTDDFTBSigmaVectorTest.cpp
   )
 
 set(SPARROW_TEST_FILES ${SPARROW_TEST_HEADERS} ${SPARROW_TEST_CPPS})
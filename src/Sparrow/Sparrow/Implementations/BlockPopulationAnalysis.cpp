@@ -0,0 +1,216 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "BlockPopulationAnalysis.h"
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+
+namespace Scine {
+namespace Sparrow {
+
+BlockPopulationAnalysis::BlockPopulationAnalysis(const Utils::DensityMatrix& densityMatrix,
+                                                 const Eigen::MatrixXd& overlapMatrix,
+                                                 const Utils::AtomsOrbitalsIndexes& aoIndexes,
+                                                 std::vector<double> coreCharges, bool orthogonalBasis,
+                                                 double blockThreshold)
+  : densityMatrix_(densityMatrix),
+    overlapMatrix_(overlapMatrix),
+    aoIndexes_(aoIndexes),
+    coreCharges_(std::move(coreCharges)),
+    orthogonalBasis_(orthogonalBasis) {
+  findNeighbors(blockThreshold);
+}
+
+void BlockPopulationAnalysis::findNeighbors(double blockThreshold) {
+  const int nAtoms = aoIndexes_.getNAtoms();
+  const Eigen::MatrixXd& screened = orthogonalBasis_ ? densityMatrix_.restrictedMatrix() : overlapMatrix_;
+  // Only the lower triangle is scanned, the neighbors b < a are added to the list of b afterwards
+  std::vector<std::vector<int>> lowerNeighbors(nAtoms);
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < nAtoms; ++a) {
+    const int indexA = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOsA = aoIndexes_.getNOrbitals(a);
+    for (int b = 0; b < a; ++b) {
+      auto block = screened.block(indexA, aoIndexes_.getFirstOrbitalIndex(b), nAOsA, aoIndexes_.getNOrbitals(b));
+      if (block.cwiseAbs().maxCoeff() > blockThreshold) {
+        lowerNeighbors[a].push_back(b);
+      }
+    }
+  }
+
+  neighbors_.assign(nAtoms, {});
+  for (int a = 0; a < nAtoms; ++a) {
+    for (int b : lowerNeighbors[a]) {
+      neighbors_[a].push_back(b);
+      neighbors_[b].push_back(a);
+    }
+    neighbors_[a].push_back(a);
+  }
+  for (auto& atomNeighbors : neighbors_) {
+    std::sort(atomNeighbors.begin(), atomNeighbors.end());
+  }
+}
+
+const std::vector<std::vector<int>>& BlockPopulationAnalysis::getNeighbors() const {
+  return neighbors_;
+}
+
+Eigen::MatrixXd BlockPopulationAnalysis::overlapBlock(int a, int b) const {
+  const int indexA = aoIndexes_.getFirstOrbitalIndex(a);
+  const int indexB = aoIndexes_.getFirstOrbitalIndex(b);
+  const int nAOsA = aoIndexes_.getNOrbitals(a);
+  const int nAOsB = aoIndexes_.getNOrbitals(b);
+  if (orthogonalBasis_) {
+    return a == b ? Eigen::MatrixXd::Identity(nAOsA, nAOsB) : Eigen::MatrixXd(Eigen::MatrixXd::Zero(nAOsA, nAOsB));
+  }
+  if (a > b) {
+    return overlapMatrix_.block(indexA, indexB, nAOsA, nAOsB);
+  }
+  if (a < b) {
+    return overlapMatrix_.block(indexB, indexA, nAOsB, nAOsA).transpose();
+  }
+  return overlapMatrix_.block(indexA, indexA, nAOsA, nAOsA).selfadjointView<Eigen::Lower>();
+}
+
+Eigen::MatrixXd BlockPopulationAnalysis::densityOverlapBlock(const Eigen::MatrixXd& density, int a, int b) const {
+  const int indexA = aoIndexes_.getFirstOrbitalIndex(a);
+  const int nAOsA = aoIndexes_.getNOrbitals(a);
+  if (orthogonalBasis_) {
+    return density.block(indexA, aoIndexes_.getFirstOrbitalIndex(b), nAOsA, aoIndexes_.getNOrbitals(b));
+  }
+  Eigen::MatrixXd product = Eigen::MatrixXd::Zero(nAOsA, aoIndexes_.getNOrbitals(b));
+  for (int c : neighbors_[b]) {
+    auto densityBlock = density.block(indexA, aoIndexes_.getFirstOrbitalIndex(c), nAOsA, aoIndexes_.getNOrbitals(c));
+    product.noalias() += densityBlock * overlapBlock(c, b);
+  }
+  return product;
+}
+
+double BlockPopulationAnalysis::mayerContribution(const Eigen::MatrixXd& density, int a, int b) const {
+  const Eigen::MatrixXd productAB = densityOverlapBlock(density, a, b);
+  const Eigen::MatrixXd productBA = densityOverlapBlock(density, b, a);
+  return productAB.cwiseProduct(productBA.transpose()).sum();
+}
+
+double BlockPopulationAnalysis::getBondOrder(int a, int b) const {
+  if (!densityMatrix_.unrestricted()) {
+    return mayerContribution(densityMatrix_.restrictedMatrix(), a, b);
+  }
+  return 2 * (mayerContribution(densityMatrix_.alphaMatrix(), a, b) +
+              mayerContribution(densityMatrix_.betaMatrix(), a, b));
+}
+
+Utils::BondOrderCollection
+BlockPopulationAnalysis::getBondOrders(const std::vector<std::pair<int, int>>& atomPairs) const {
+  const int nPairs = atomPairs.size();
+  std::vector<double> orders(nPairs);
+#pragma omp parallel for schedule(dynamic)
+  for (int pair = 0; pair < nPairs; ++pair) {
+    orders[pair] = getBondOrder(atomPairs[pair].first, atomPairs[pair].second);
+  }
+  Utils::BondOrderCollection bondOrders(aoIndexes_.getNAtoms());
+  for (int pair = 0; pair < nPairs; ++pair) {
+    bondOrders.setOrder(atomPairs[pair].first, atomPairs[pair].second, orders[pair]);
+  }
+  return bondOrders;
+}
+
+Utils::BondOrderCollection BlockPopulationAnalysis::getBondOrders() const {
+  std::vector<std::pair<int, int>> atomPairs;
+  for (int a = 0; a < static_cast<int>(neighbors_.size()); ++a) {
+    for (int b : neighbors_[a]) {
+      if (b > a) {
+        atomPairs.emplace_back(a, b);
+      }
+    }
+  }
+  return getBondOrders(atomPairs);
+}
+
+Utils::BondOrderCollection BlockPopulationAnalysis::getAllBondOrders() const {
+  const int nAtoms = aoIndexes_.getNAtoms();
+  std::vector<std::pair<int, int>> atomPairs;
+  atomPairs.reserve(nAtoms * (nAtoms - 1) / 2);
+  for (int a = 0; a < nAtoms; ++a) {
+    for (int b = a + 1; b < nAtoms; ++b) {
+      atomPairs.emplace_back(a, b);
+    }
+  }
+  return getBondOrders(atomPairs);
+}
+
+Eigen::VectorXd BlockPopulationAnalysis::mullikenPopulations(const Eigen::MatrixXd& density) const {
+  const int nAtoms = aoIndexes_.getNAtoms();
+  Eigen::VectorXd populations(nAtoms);
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < nAtoms; ++a) {
+    const int indexA = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOsA = aoIndexes_.getNOrbitals(a);
+    if (orthogonalBasis_) {
+      populations[a] = density.diagonal().segment(indexA, nAOsA).sum();
+      continue;
+    }
+    double population = 0.0;
+    for (int b : neighbors_[a]) {
+      auto densityBlock = density.block(indexA, aoIndexes_.getFirstOrbitalIndex(b), nAOsA, aoIndexes_.getNOrbitals(b));
+      population += densityBlock.cwiseProduct(overlapBlock(a, b)).sum();
+    }
+    populations[a] = population;
+  }
+  return populations;
+}
+
+Eigen::VectorXd BlockPopulationAnalysis::lowdinPopulations() const {
+  const Eigen::MatrixXd& density = densityMatrix_.restrictedMatrix();
+  if (orthogonalBasis_) {
+    return mullikenPopulations(density);
+  }
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(overlapMatrix_.selfadjointView<Eigen::Lower>());
+  const Eigen::MatrixXd sqrtOverlap = eigenSolver.operatorSqrt();
+  const Eigen::MatrixXd product = density * sqrtOverlap;
+  // Diagonal of S^1/2 P S^1/2
+  const int nAOs = density.cols();
+  Eigen::VectorXd orbitalPopulations(nAOs);
+  for (int mu = 0; mu < nAOs; ++mu) {
+    orbitalPopulations[mu] = sqrtOverlap.col(mu).dot(product.col(mu));
+  }
+  const int nAtoms = aoIndexes_.getNAtoms();
+  Eigen::VectorXd populations(nAtoms);
+  for (int a = 0; a < nAtoms; ++a) {
+    populations[a] = orbitalPopulations.segment(aoIndexes_.getFirstOrbitalIndex(a), aoIndexes_.getNOrbitals(a)).sum();
+  }
+  return populations;
+}
+
+std::vector<double> BlockPopulationAnalysis::toCharges(const Eigen::VectorXd& populations) const {
+  std::vector<double> charges(coreCharges_);
+  for (int a = 0; a < populations.size(); ++a) {
+    charges[a] -= populations[a];
+  }
+  return charges;
+}
+
+std::vector<double> BlockPopulationAnalysis::getMullikenCharges() const {
+  return toCharges(mullikenPopulations(densityMatrix_.restrictedMatrix()));
+}
+
+std::vector<double> BlockPopulationAnalysis::getLowdinCharges() const {
+  return toCharges(lowdinPopulations());
+}
+
+Eigen::VectorXd BlockPopulationAnalysis::getMullikenSpinPopulations() const {
+  if (!densityMatrix_.unrestricted()) {
+    return Eigen::VectorXd::Zero(aoIndexes_.getNAtoms());
+  }
+  return mullikenPopulations(densityMatrix_.alphaMatrix() - densityMatrix_.betaMatrix());
+}
+
+} // namespace Sparrow
+} // namespace Scine
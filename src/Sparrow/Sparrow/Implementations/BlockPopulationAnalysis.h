@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_BLOCKPOPULATIONANALYSIS_H
+#define SPARROW_BLOCKPOPULATIONANALYSIS_H
+
+#include <Eigen/Core>
+#include <utility>
+#include <vector>
+
+namespace Scine {
+
+namespace Utils {
+class AtomsOrbitalsIndexes;
+class BondOrderCollection;
+class DensityMatrix;
+} // namespace Utils
+
+namespace Sparrow {
+
+/**
+ * @brief Atomic charges and bond orders evaluated from the atom blocks of the density and overlap matrices.
+ *
+ * The Mulliken population of an atom and the Mayer bond order of an atom pair only involve the blocks P_ab and S_ab
+ * of the atoms with non-negligible overlap, such that no product P S of the full matrices is formed. Two atoms are
+ * neighbors if their block of the overlap matrix has an element above the block threshold; for an orthogonal basis,
+ * as in the NDDO methods, the overlap metric is the identity, the density blocks are screened instead, and the Mayer
+ * bond order reduces to the Wiberg bond order. The cost of the populations of all atoms and of the bond order of one
+ * pair is then proportional to the number of neighbors times the cube of the block size.
+ * Atoms and pairs are evaluated in parallel. The Löwdin populations need the square root of the overlap matrix and
+ * are the only dense O(N^3) step; for an orthogonal basis, they are equal to the Mulliken populations.
+ * The matrices are referenced, not copied, and must outlive the analysis.
+ */
+class BlockPopulationAnalysis {
+ public:
+  /**
+   * @param densityMatrix   The density matrix, restricted or unrestricted.
+   * @param overlapMatrix   The overlap matrix, only its lower triangle is read. Not read for an orthogonal basis.
+   * @param aoIndexes       The atomic orbitals of the atoms.
+   * @param coreCharges     Charges of the atomic cores, from which the electronic populations are subtracted.
+   * @param orthogonalBasis Whether the overlap metric is the identity.
+   * @param blockThreshold  Atom pairs whose overlap (or density) blocks are below this value are not neighbors.
+   */
+  BlockPopulationAnalysis(const Utils::DensityMatrix& densityMatrix, const Eigen::MatrixXd& overlapMatrix,
+                          const Utils::AtomsOrbitalsIndexes& aoIndexes, std::vector<double> coreCharges,
+                          bool orthogonalBasis, double blockThreshold = 1e-8);
+
+  //! @brief Mulliken charges of the atoms.
+  std::vector<double> getMullikenCharges() const;
+  //! @brief Löwdin charges of the atoms.
+  std::vector<double> getLowdinCharges() const;
+  //! @brief Mulliken populations of the difference of the alpha and beta densities, zero if restricted.
+  Eigen::VectorXd getMullikenSpinPopulations() const;
+  //! @brief Mayer (Wiberg for an orthogonal basis) bond order of two different atoms.
+  double getBondOrder(int a, int b) const;
+  //! @brief Bond orders of the given atom pairs, the other entries of the collection are zero.
+  Utils::BondOrderCollection getBondOrders(const std::vector<std::pair<int, int>>& atomPairs) const;
+  //! @brief Bond orders of all pairs of neighbors.
+  Utils::BondOrderCollection getBondOrders() const;
+  //! @brief Bond orders of all atom pairs, as from the full matrices.
+  Utils::BondOrderCollection getAllBondOrders() const;
+  //! @brief Sorted neighbors of every atom, including the atom itself.
+  const std::vector<std::vector<int>>& getNeighbors() const;
+
+ private:
+  void findNeighbors(double blockThreshold);
+  // Block S_ab of the overlap matrix, the identity or zero for an orthogonal basis
+  Eigen::MatrixXd overlapBlock(int a, int b) const;
+  // Block (P S)_ab = sum_c P_ac S_cb, with c running over the neighbors of b
+  Eigen::MatrixXd densityOverlapBlock(const Eigen::MatrixXd& density, int a, int b) const;
+  // sum_{mu in a, nu in b} (P S)_munu (P S)_numu
+  double mayerContribution(const Eigen::MatrixXd& density, int a, int b) const;
+  Eigen::VectorXd mullikenPopulations(const Eigen::MatrixXd& density) const;
+  Eigen::VectorXd lowdinPopulations() const;
+  std::vector<double> toCharges(const Eigen::VectorXd& populations) const;
+
+  const Utils::DensityMatrix& densityMatrix_;
+  const Eigen::MatrixXd& overlapMatrix_;
+  const Utils::AtomsOrbitalsIndexes& aoIndexes_;
+  std::vector<double> coreCharges_;
+  bool orthogonalBasis_;
+  std::vector<std::vector<int>> neighbors_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_BLOCKPOPULATIONANALYSIS_H
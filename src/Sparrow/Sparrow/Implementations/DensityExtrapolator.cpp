@@ -0,0 +1,213 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "DensityExtrapolator.h"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+double binomial(int n, int k) {
+  if (k < 0 || k > n) {
+    return 0.0;
+  }
+  double result = 1.0;
+  for (int i = 1; i <= k; ++i) {
+    result *= static_cast<double>(n - k + i) / i;
+  }
+  return result;
+}
+
+bool samePositions(const Utils::PositionCollection& a, const Utils::PositionCollection& b) {
+  return a.rows() == b.rows() && (a - b).cwiseAbs().maxCoeff() < 1e-10;
+}
+
+// S^1/2 if inverse is false, S^-1/2 otherwise.
+Eigen::MatrixXd overlapPower(const Eigen::MatrixXd& overlap, bool inverse) {
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(overlap);
+  return inverse ? solver.operatorInverseSqrt() : solver.operatorSqrt();
+}
+
+// Idempotent density with the nOccupied natural orbitals of largest occupation of an orthogonal-basis density.
+Eigen::MatrixXd purify(const Eigen::MatrixXd& density, int nOccupied, double occupation) {
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(density);
+  // Eigenvalues are sorted in increasing order
+  Eigen::MatrixXd occupied = solver.eigenvectors().rightCols(nOccupied);
+  return occupation * occupied * occupied.transpose();
+}
+} // namespace
+
+DensityExtrapolator::Mode DensityExtrapolator::modeFromString(const std::string& mode) {
+  if (mode == "none") {
+    return Mode::None;
+  }
+  if (mode == "aspc") {
+    return Mode::Aspc;
+  }
+  if (mode == "lowdin") {
+    return Mode::Lowdin;
+  }
+  throw std::runtime_error("Unknown density extrapolation " + mode + ".");
+}
+
+std::vector<double> DensityExtrapolator::aspcCoefficients(int order) {
+  std::vector<double> coefficients(order + 2);
+  const double denominator = binomial(2 * order + 2, order + 1);
+  for (int j = 1; j <= order + 2; ++j) {
+    const double sign = j % 2 == 1 ? 1.0 : -1.0;
+    coefficients[j - 1] = sign * j * binomial(2 * order + 4, order + 2 - j) / denominator;
+  }
+  return coefficients;
+}
+
+void DensityExtrapolator::setMode(Mode mode, int order) {
+  if (order < 0) {
+    throw std::runtime_error("The order of the density extrapolation must not be negative.");
+  }
+  if (mode != mode_ || order != order_) {
+    clear();
+  }
+  mode_ = mode;
+  order_ = order;
+}
+
+DensityExtrapolator::Mode DensityExtrapolator::getMode() const {
+  return mode_;
+}
+
+int DensityExtrapolator::getOrder() const {
+  return order_;
+}
+
+void DensityExtrapolator::setMaxStepDisplacement(double displacement) {
+  maxStepDisplacement_ = displacement;
+}
+
+void DensityExtrapolator::clear() {
+  history_.clear();
+  prediction_ = Step{};
+}
+
+int DensityExtrapolator::historySize() const {
+  return static_cast<int>(history_.size());
+}
+
+bool DensityExtrapolator::continuesHistory(const Utils::PositionCollection& positions) const {
+  if (history_.empty() || history_.front().positions.rows() != positions.rows()) {
+    return false;
+  }
+  return (positions - history_.front().positions).rowwise().norm().maxCoeff() <= maxStepDisplacement_;
+}
+
+std::vector<Eigen::MatrixXd> DensityExtrapolator::toExtrapolationBasis(const Utils::DensityMatrix& density,
+                                                                       const Eigen::MatrixXd& overlap) const {
+  std::vector<Eigen::MatrixXd> densities;
+  if (density.unrestricted()) {
+    densities = {density.alphaMatrix(), density.betaMatrix()};
+  }
+  else {
+    densities = {density.restrictedMatrix()};
+  }
+  if (mode_ == Mode::Lowdin && overlap.size() != 0) {
+    const Eigen::MatrixXd sqrtOverlap = overlapPower(overlap, false);
+    for (auto& d : densities) {
+      d = sqrtOverlap * d * sqrtOverlap;
+    }
+  }
+  return densities;
+}
+
+bool DensityExtrapolator::extrapolate(const Utils::PositionCollection& positions, const Eigen::MatrixXd& overlap,
+                                      Utils::DensityMatrix& guess) {
+  prediction_ = Step{};
+  // A recalculation at the last geometry starts best from its own density
+  if (mode_ == Mode::None || history_.size() < 2 || !continuesHistory(positions) ||
+      samePositions(positions, history_.front().positions)) {
+    return false;
+  }
+  const int nAOs = static_cast<int>(history_.front().densities.front().rows());
+  if (overlap.size() != 0 && overlap.rows() != nAOs) {
+    return false;
+  }
+
+  // Lower order until the history is long enough
+  const int order = std::min(order_, static_cast<int>(history_.size()) - 2);
+  const auto coefficients = aspcCoefficients(order);
+  prediction_.positions = positions;
+  prediction_.densities.assign(history_.front().densities.size(), Eigen::MatrixXd::Zero(nAOs, nAOs));
+  for (int j = 0; j < order + 2; ++j) {
+    for (unsigned spin = 0; spin < prediction_.densities.size(); ++spin) {
+      prediction_.densities[spin] += coefficients[j] * history_[j].densities[spin];
+    }
+  }
+
+  std::vector<Eigen::MatrixXd> densities = prediction_.densities;
+  if (mode_ == Mode::Lowdin) {
+    if (unrestricted_) {
+      densities[0] = purify(densities[0], nAlphaElectrons_, 1.0);
+      densities[1] = purify(densities[1], nBetaElectrons_, 1.0);
+    }
+    else if (nAlphaElectrons_ == nBetaElectrons_) {
+      densities[0] = purify(densities[0], nAlphaElectrons_, 2.0);
+    }
+    if (overlap.size() != 0) {
+      const Eigen::MatrixXd inverseSqrtOverlap = overlapPower(overlap, true);
+      for (auto& d : densities) {
+        d = inverseSqrtOverlap * d * inverseSqrtOverlap;
+      }
+    }
+  }
+
+  if (unrestricted_) {
+    guess.setDensity(std::move(densities[0]), std::move(densities[1]), nAlphaElectrons_, nBetaElectrons_);
+  }
+  else {
+    guess.setDensity(std::move(densities[0]), nAlphaElectrons_ + nBetaElectrons_);
+  }
+  return true;
+}
+
+void DensityExtrapolator::addStep(const Utils::PositionCollection& positions, const Eigen::MatrixXd& overlap,
+                                  const Utils::DensityMatrix& density) {
+  if (mode_ == Mode::None) {
+    return;
+  }
+  const bool unrestricted = density.unrestricted();
+  const int nAlpha = unrestricted ? density.numberElectronsInAlphaMatrix() : density.numberElectrons() / 2;
+  const int nBeta = unrestricted ? density.numberElectronsInBetaMatrix() : density.numberElectrons() - nAlpha;
+  Step step{positions, toExtrapolationBasis(density, overlap)};
+  bool compatible = continuesHistory(positions) && unrestricted == unrestricted_ && nAlpha == nAlphaElectrons_ &&
+                    nBeta == nBetaElectrons_ && step.densities.front().rows() == history_.front().densities.front().rows();
+  if (!compatible) {
+    clear();
+  }
+  unrestricted_ = unrestricted;
+  nAlphaElectrons_ = nAlpha;
+  nBetaElectrons_ = nBeta;
+
+  // Corrector step, if this geometry was predicted from the current history
+  if (compatible && samePositions(prediction_.positions, positions) &&
+      prediction_.densities.size() == step.densities.size()) {
+    const int order = std::min(order_, static_cast<int>(history_.size()) - 2);
+    const double weight = (order + 2.0) / (2.0 * order + 3.0);
+    for (unsigned spin = 0; spin < step.densities.size(); ++spin) {
+      step.densities[spin] = weight * step.densities[spin] + (1.0 - weight) * prediction_.densities[spin];
+    }
+  }
+  prediction_ = Step{};
+
+  history_.push_front(std::move(step));
+  while (static_cast<int>(history_.size()) > order_ + 2) {
+    history_.pop_back();
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
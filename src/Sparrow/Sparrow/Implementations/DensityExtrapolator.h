@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_DENSITYEXTRAPOLATOR_H
+#define SPARROW_DENSITYEXTRAPOLATOR_H
+
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Predicts the initial density matrix of an SCF calculation from the converged densities of the previous
+ *        steps of a trajectory or of an optimization.
+ *
+ * The prediction is the always stable predictor-corrector (ASPC) scheme of Kolafa (J. Comput. Chem. 25, 335, 2004):
+ * the guess is a linear combination of the k + 2 previous densities with time-reversible coefficients, see
+ * aspcCoefficients(), and the density stored for a step is the converged density mixed with its prediction,
+ * P = w P_scf + (1 - w) P_pred with w = (k + 2) / (2k + 3). The mixing damps the errors of the prediction and keeps
+ * the extrapolated sequence time-reversible to the order of the predictor.
+ * Two variants are available:
+ *  - Aspc: the density matrices are extrapolated in the atomic orbital basis.
+ *  - Lowdin: the densities are extrapolated in the Löwdin-orthogonalized basis S^1/2 P S^1/2, which follows the
+ *    rotation of the atomic orbitals with the geometry. The prediction is made idempotent again by occupying its
+ *    natural orbitals with the largest occupation, and transformed back with the overlap matrix of the new geometry.
+ *    The guess thus corresponds to a set of orthonormal molecular orbitals with the right number of electrons.
+ *    For orthogonal basis sets, as in the NDDO methods, only the purification differs from Aspc.
+ * The history is cleared if the atoms move by more than a given displacement between two steps, as after a jump to
+ * an unrelated structure, or if the number of orbitals or electrons changes.
+ */
+class DensityExtrapolator {
+ public:
+  enum class Mode { None, Aspc, Lowdin };
+
+  //! @brief Mode from the values of the setting "density_extrapolation": "none", "aspc" or "lowdin".
+  static Mode modeFromString(const std::string& mode);
+  /**
+   * @brief Coefficients B_j of the ASPC predictor of order k, P_pred = sum_j B_j P(n - j) for j = 1, ..., k + 2.
+   * B_j = (-1)^(j+1) j binom(2k + 4, k + 2 - j) / binom(2k + 2, k + 1); they sum up to one.
+   */
+  static std::vector<double> aspcCoefficients(int order);
+
+  //! @brief Sets the mode and the order k of the predictor. The history is cleared if any of them changes.
+  void setMode(Mode mode, int order);
+  Mode getMode() const;
+  int getOrder() const;
+  //! @brief Largest atomic displacement, in bohr, between two consecutive steps of a continuous sequence.
+  void setMaxStepDisplacement(double displacement);
+  void clear();
+  //! @brief Number of steps in the history, at most order + 2.
+  int historySize() const;
+
+  /**
+   * @brief Predicts the density matrix at the given positions.
+   * @param overlap Overlap matrix at the new positions, full and symmetric. Empty for orthogonal basis sets.
+   * @param guess   Written only if a prediction is possible.
+   * @return false if the history is too short or does not continue to the new positions.
+   */
+  bool extrapolate(const Utils::PositionCollection& positions, const Eigen::MatrixXd& overlap,
+                   Utils::DensityMatrix& guess);
+  /**
+   * @brief Adds the converged density matrix at the given positions to the history.
+   * @param overlap Overlap matrix at these positions, full and symmetric. Empty for orthogonal basis sets.
+   */
+  void addStep(const Utils::PositionCollection& positions, const Eigen::MatrixXd& overlap,
+               const Utils::DensityMatrix& density);
+
+ private:
+  struct Step {
+    Utils::PositionCollection positions;
+    // Restricted, or alpha and beta density matrices, in the basis the extrapolation is done in
+    std::vector<Eigen::MatrixXd> densities;
+  };
+  // Densities of the spin channels in the extrapolation basis.
+  std::vector<Eigen::MatrixXd> toExtrapolationBasis(const Utils::DensityMatrix& density,
+                                                    const Eigen::MatrixXd& overlap) const;
+  bool continuesHistory(const Utils::PositionCollection& positions) const;
+
+  Mode mode_ = Mode::None;
+  int order_ = 2;
+  double maxStepDisplacement_ = 0.5;
+  // Most recent step first
+  std::deque<Step> history_;
+  // Prediction for the step being calculated, used as corrector when the step is added
+  Step prediction_;
+  bool unrestricted_ = false;
+  int nAlphaElectrons_ = 0;
+  int nBetaElectrons_ = 0;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_DENSITYEXTRAPOLATOR_H
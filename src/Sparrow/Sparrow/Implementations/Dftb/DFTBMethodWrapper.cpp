@@ -9,6 +9,7 @@
 #include <Sparrow/Implementations/Dftb/TimeDependent/LinearResponse/TDDFTBData.h>
 #include <Sparrow/Implementations/Dftb/Utils/DipoleUtils/DFTBDipoleMatrixCalculator.h>
 #include <Utils/CalculatorBasics/PropertyList.h>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -44,9 +45,24 @@ bool DFTBMethodWrapper::getZPVEInclusion() const {
   return false;
 }
 
-TDDFTBData DFTBMethodWrapper::getTDDFTBData() const {
+TDDFTBData DFTBMethodWrapper::getTDDFTBData() {
+  restoreMethodState();
   return getTDDFTBDataImpl();
 }
 
+void DFTBMethodWrapper::addResponseDerivatives(Utils::GradientCollection& gradients,
+                                               const Eigen::MatrixXd& densityMatrix,
+                                               const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                                               const Eigen::MatrixXd& gammaDerivativeMultiplier) const {
+  addResponseDerivativesImpl(gradients, densityMatrix, overlapDerivativeMultiplier, gammaDerivativeMultiplier);
+}
+
+void DFTBMethodWrapper::addResponseDerivativesImpl(Utils::GradientCollection& /*gradients*/,
+                                                   const Eigen::MatrixXd& /*densityMatrix*/,
+                                                   const Eigen::MatrixXd& /*overlapDerivativeMultiplier*/,
+                                                   const Eigen::MatrixXd& /*gammaDerivativeMultiplier*/) const {
+  throw std::runtime_error("Excited-state gradients are not available for " + name() + ", only for DFTB2.");
+}
+
 } // namespace Sparrow
 } // namespace Scine
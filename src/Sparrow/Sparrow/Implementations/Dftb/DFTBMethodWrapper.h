@@ -28,13 +28,23 @@ class DFTBMethodWrapper : public Utils::CloneInterface<Utils::Abstract<DFTBMetho
    * If they diverge, override this in each method wrapper.
    */
   Utils::PropertyList possibleProperties() const final;
-  TDDFTBData getTDDFTBData() const;
+  TDDFTBData getTDDFTBData();
+  /**
+   * @brief Adds the derivatives of the integrals contracted with the response densities of an excited state to the
+   *        gradients, see dftb::DFTB2::addResponseDerivatives(). Throws for the methods other than DFTB2.
+   */
+  void addResponseDerivatives(Utils::GradientCollection& gradients, const Eigen::MatrixXd& densityMatrix,
+                              const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                              const Eigen::MatrixXd& gammaDerivativeMultiplier) const;
 
  private:
   void assembleResults(const std::string& description) final;
 
  protected:
   virtual TDDFTBData getTDDFTBDataImpl() const = 0;
+  virtual void addResponseDerivativesImpl(Utils::GradientCollection& gradients, const Eigen::MatrixXd& densityMatrix,
+                                          const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                                          const Eigen::MatrixXd& gammaDerivativeMultiplier) const;
 
   // Extracted method from all copy constructors and copy assignment operators.
   template<class DFTBMethod>
@@ -44,6 +54,7 @@ class DFTBMethodWrapper : public Utils::CloneInterface<Utils::Abstract<DFTBMetho
     // Concurrent calling of the logger introduces race conditions
     // that eventually trigger a segfault
     instance.setStructure(*classToCopy.getStructure());
+    instance.copyPointChargeEmbedding(classToCopy);
     instance.results() = std::move(results);
     instance.loadState(classToCopy.getState());
     instance.setLog(classToCopy.getLog());
@@ -50,6 +50,16 @@ Eigen::MatrixXd DFTB0::calculateGammaMatrix() const {
 std::shared_ptr<Eigen::VectorXd> DFTB0::calculateSpinConstantVector() const {
   return nullptr;
 }
+
+void DFTB0::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  matricesCalculator_->setPeriodicCell(cell);
+  dynamic_cast<dftb::Repulsion&>(*rep_).setPeriodicCell(std::move(cell));
+}
+
+Eigen::Matrix3d DFTB0::calculateStrainDerivatives() const {
+  return matricesCalculator_->calculateStrainDerivatives(energyWeightedDensityMatrix_) +
+         dynamic_cast<const dftb::Repulsion&>(*rep_).getStrainDerivatives();
+}
 } // namespace dftb
 } // namespace Sparrow
 } // namespace Scine
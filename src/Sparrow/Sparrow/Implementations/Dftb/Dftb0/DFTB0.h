@@ -19,6 +19,7 @@ class OverlapCalculator;
 class ElectronicContributionCalculator;
 } // namespace Utils
 namespace Sparrow {
+class PeriodicCell;
 
 namespace dftb {
 class ZeroOrderMatricesCalculator;
@@ -31,6 +32,10 @@ class DFTB0 : public Utils::LcaoMethod {
   std::shared_ptr<DFTBCommon> getInitializer() const;
   Eigen::MatrixXd calculateGammaMatrix() const;
   std::shared_ptr<Eigen::VectorXd> calculateSpinConstantVector() const;
+  //! @brief Sets the periodic cell, nullptr or a non-periodic cell for none, see ZeroOrderMatricesCalculator.
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  //! @brief Derivative of the energy of the last calculation with gradients with respect to a homogeneous strain.
+  Eigen::Matrix3d calculateStrainDerivatives() const;
 
  private:
   DFTBCommon::AtomicParameterContainer atomParameters;   // parameters for atoms
@@ -48,6 +48,7 @@ void DFTB0MethodWrapper::applySettings() {
   if (settings_->valid()) {
     int molecularCharge = settings_->getInt(Utils::SettingsNames::molecularCharge);
     method_.setMolecularCharge(molecularCharge);
+    method_.setPeriodicCell(periodicCell_);
   }
   else {
     settings_->throwIncorrectSettings();
@@ -101,10 +102,22 @@ TDDFTBData DFTB0MethodWrapper::getTDDFTBDataImpl() const {
   return TDDFTBData::constructTDDFTBDataFromDFTBMethod(method_);
 }
 
+bool DFTB0MethodWrapper::supportsPeriodicBoundaries() const {
+  return true;
+}
+
+Eigen::Matrix3d DFTB0MethodWrapper::getStrainDerivatives() const {
+  return method_.calculateStrainDerivatives();
+}
+
 bool DFTB0MethodWrapper::successfulCalculation() const {
   return true;
 }
 
+std::vector<double> DFTB0MethodWrapper::getCoreCharges() const {
+  return method_.getInitializer()->getCoreCharges();
+}
+
 void DFTB0MethodWrapper::loadState(std::shared_ptr<Core::State> /*state*/) {
 }
 
@@ -54,6 +54,9 @@ class DFTB0MethodWrapper final : public Utils::CloneInterface<DFTB0MethodWrapper
  private:
   TDDFTBData getTDDFTBDataImpl() const final;
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  bool supportsPeriodicBoundaries() const final;
+  Eigen::Matrix3d getStrainDerivatives() const final;
   //! This function hides the templated generic function in @file DFTBMethodWrapper.h.
   void copyInto(DFTB0MethodWrapper& instance, const DFTB0MethodWrapper& classToCopy);
   Utils::DensityMatrix getDensityMatrixGuess() const final;
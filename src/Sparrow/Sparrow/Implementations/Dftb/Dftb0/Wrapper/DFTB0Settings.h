@@ -8,6 +8,7 @@
 #ifndef SPARROW_DFTB0SETTINGS_H
 #define SPARROW_DFTB0SETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 
@@ -26,6 +27,9 @@ class DFTB0Settings : public Scine::Utils::Settings {
     Utils::UniversalSettings::SettingPopulator::populateLcaoSettings(_fields);
     Utils::UniversalSettings::SettingPopulator::populateSemiEmpiricalSettings(_fields, "3ob-3-1");
 
+    SparrowSettingPopulator::populatePeriodicBoundarySettings(_fields, "Calculations are done at the Gamma point.");
+    SparrowSettingPopulator::populateBondOrderSettings(_fields);
+
     // Method
     Utils::UniversalSettings::StringDescriptor method("The method to be used.");
     method.setDefaultValue("dftb0");
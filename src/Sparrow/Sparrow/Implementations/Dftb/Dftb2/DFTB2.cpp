@@ -12,7 +12,10 @@
 #include "Sparrow/Implementations/Dftb/Utils/Repulsion.h"
 #include "Sparrow/Implementations/Dftb/Utils/SecondOrderFock.h"
 #include "Sparrow/Implementations/Dftb/Utils/ZeroOrderMatricesCalculator.h"
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -47,7 +50,59 @@ std::shared_ptr<DFTBCommon> DFTB2::getInitializer() const {
   return dftbBase;
 }
 
+void DFTB2::setFragmentDensityGuess(bool enabled, int maxFragmentSize) {
+  auto guess = FragmentDensityGuess::switchGuess(
+      densityMatrixGuess_.get(), enabled, maxFragmentSize, elementTypes_, positions_, aoIndexes_, coreCharges_,
+      nElectrons_, [this]() { return std::make_unique<dftb::DensityGuess>(aoIndexes_, coreCharges_, nElectrons_); },
+      [this]() {
+        // The fragment methods share the parameters loaded once for the structure
+        auto method = std::make_unique<DFTB2>();
+        method->getInitializer()->setMethodDetails(dftbBase->getParameterPath(), dftbBase->getDftbType());
+        method->getInitializer()->setParameterSet(dftbBase->getFragmentParameterSet());
+        return method;
+      },
+      false);
+  if (guess) {
+    densityMatrixGuess_ = std::move(guess);
+  }
+}
+
+void DFTB2::setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding) {
+  std::dynamic_pointer_cast<ScfFock>(electronicPart_)->setPointChargeEmbedding(std::move(embedding));
+}
+
+void DFTB2::setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator) {
+  std::dynamic_pointer_cast<ScfFock>(electronicPart_)->setScfAccelerator(std::move(accelerator));
+}
+
+void DFTB2::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  matricesCalculator_->setPeriodicCell(cell);
+  std::dynamic_pointer_cast<SecondOrderFock>(electronicPart_)->setPeriodicCell(cell);
+  dynamic_cast<dftb::Repulsion&>(*rep_).setPeriodicCell(cell);
+  periodicCell_ = std::move(cell);
+}
+
+Eigen::Matrix3d DFTB2::calculateStrainDerivatives() const {
+  return std::dynamic_pointer_cast<SecondOrderFock>(electronicPart_)->calculateStrainDerivatives() +
+         dynamic_cast<const dftb::Repulsion&>(*rep_).getStrainDerivatives();
+}
+
+void DFTB2::addResponseDerivatives(DerivativeContainerType<Utils::Derivative::First>& derivatives,
+                                   const Eigen::MatrixXd& densityMatrix,
+                                   const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                                   const Eigen::MatrixXd& gammaDerivativeMultiplier) const {
+  if (periodicCell_ && periodicCell_->isPeriodic()) {
+    throw std::runtime_error("Excited-state gradients are not available with periodic boundaries.");
+  }
+  matricesCalculator_->addDerivatives(derivatives, densityMatrix, overlapDerivativeMultiplier);
+  auto secondOrderFock = std::dynamic_pointer_cast<SecondOrderFock>(electronicPart_);
+  secondOrderFock->addGammaDerivatives(derivatives, gammaDerivativeMultiplier);
+}
+
 Eigen::MatrixXd DFTB2::calculateGammaMatrix() const {
+  if (periodicCell_ && periodicCell_->isPeriodic()) {
+    throw std::runtime_error("Excited states are not available with periodic boundaries.");
+  }
   auto secondOrderFock = std::dynamic_pointer_cast<SecondOrderFock>(electronicPart_);
   Eigen::MatrixXd gammaMatrix(elementTypes_.size(), elementTypes_.size());
   for (int atom = 0; atom < static_cast<int>(elementTypes_.size()); ++atom) {
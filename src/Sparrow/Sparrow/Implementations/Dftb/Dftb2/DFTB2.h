@@ -18,6 +18,9 @@
 
 namespace Scine {
 namespace Sparrow {
+class PeriodicCell;
+class PointChargeEmbedding;
+class ScfAccelerator;
 
 namespace dftb {
 class ZeroOrderMatricesCalculator;
@@ -31,12 +34,36 @@ class DFTB2 : public Utils::ScfMethod {
   Eigen::MatrixXd calculateGammaMatrix() const;
   std::shared_ptr<Eigen::VectorXd> calculateSpinConstantVector() const;
   std::shared_ptr<DFTBCommon> getInitializer() const;
+  /**
+   * @brief Switches between the standard and the fragment-based initial density guess.
+   * An active fragment guess is kept with its cache of fragment densities, only its size limit is updated.
+   * @param maxFragmentSize Maximal number of heavy atoms per fragment, see FragmentDensityGuess.
+   */
+  void setFragmentDensityGuess(bool enabled, int maxFragmentSize);
+  //! @brief Sets the point charges embedding the molecule, nullptr for none, see ScfFock::setPointChargeEmbedding().
+  void setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding);
+  //! @brief Sets the SCF convergence accelerator, nullptr for none, see ScfFock::setScfAccelerator().
+  void setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator);
+  //! @brief Sets the periodic cell, nullptr or a non-periodic cell for none, see SecondOrderFock::setPeriodicCell().
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  //! @brief Derivative of the energy of the last calculation with gradients with respect to a homogeneous strain.
+  Eigen::Matrix3d calculateStrainDerivatives() const;
+  /**
+   * @brief Adds the derivatives of tr(H0 D) - tr(W S) + sum_{a<b} G(a, b) gamma(a, b) for given matrices D, W and G,
+   *        the derivatives of the integrals contracted with the response densities of an excited state.
+   * @pre The last calculation included the gradients, without periodic boundaries.
+   */
+  void addResponseDerivatives(
+      Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
+      const Eigen::MatrixXd& densityMatrix, const Eigen::MatrixXd& overlapDerivativeMultiplier,
+      const Eigen::MatrixXd& gammaDerivativeMultiplier) const;
 
  private:
   DFTBCommon::AtomicParameterContainer atomParameters;   // parameters for atoms
   DFTBCommon::DiatomicParameterContainer pairParameters; // List of pointers to parameters
   std::shared_ptr<DFTBCommon> dftbBase;
   std::unique_ptr<dftb::ZeroOrderMatricesCalculator> matricesCalculator_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
 };
 
 } // namespace dftb
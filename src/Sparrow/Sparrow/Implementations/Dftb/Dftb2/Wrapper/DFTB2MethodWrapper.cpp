@@ -77,7 +77,16 @@ void DFTB2MethodWrapper::applySettings() {
     method_.setSpinMultiplicity(spinMultiplicity);
     method_.setConvergenceCriteria({selfConsistenceCriterion, densityRmsdThreshold});
     method_.setMaxIterations(maxScfIterations);
+    // The SCF accelerator replaces the mixer of the SCF method
+    if (scfAccelerator_->getMode() != ScfAccelerator::Mode::None) {
+      scfMixerType = Utils::scf_mixer_t::none;
+    }
     method_.setScfMixer(scfMixerType);
+    method_.setFragmentDensityGuess(settings_->getBool(SparrowSettingsNames::fragmentDensityGuess),
+                                    settings_->getInt(SparrowSettingsNames::maxFragmentSize));
+    method_.setPointChargeEmbedding(pointChargeEmbedding_);
+    method_.setScfAccelerator(scfAccelerator_);
+    method_.setPeriodicCell(periodicCell_);
   }
   else {
     settings_->throwIncorrectSettings();
@@ -122,9 +131,32 @@ TDDFTBData DFTB2MethodWrapper::getTDDFTBDataImpl() const {
   return TDDFTBData::constructTDDFTBDataFromDFTBMethod(method_);
 }
 
+void DFTB2MethodWrapper::addResponseDerivativesImpl(Utils::GradientCollection& gradients,
+                                                    const Eigen::MatrixXd& densityMatrix,
+                                                    const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                                                    const Eigen::MatrixXd& gammaDerivativeMultiplier) const {
+  method_.addResponseDerivatives(gradients, densityMatrix, overlapDerivativeMultiplier, gammaDerivativeMultiplier);
+}
+
+bool DFTB2MethodWrapper::supportsPeriodicBoundaries() const {
+  return true;
+}
+
+Eigen::Matrix3d DFTB2MethodWrapper::getStrainDerivatives() const {
+  return method_.calculateStrainDerivatives();
+}
+
 bool DFTB2MethodWrapper::successfulCalculation() const {
   return method_.hasConverged();
 }
 
+std::vector<double> DFTB2MethodWrapper::getCoreCharges() const {
+  return method_.getInitializer()->getCoreCharges();
+}
+
+bool DFTB2MethodWrapper::supportsPointChargeEmbedding() const {
+  return true;
+}
+
 } /* namespace Sparrow */
 } /* namespace Scine */
@@ -55,7 +55,14 @@ class DFTB2MethodWrapper final : public Utils::CloneInterface<DFTB2MethodWrapper
 
  private:
   TDDFTBData getTDDFTBDataImpl() const final;
+  void addResponseDerivativesImpl(Utils::GradientCollection& gradients, const Eigen::MatrixXd& densityMatrix,
+                                  const Eigen::MatrixXd& overlapDerivativeMultiplier,
+                                  const Eigen::MatrixXd& gammaDerivativeMultiplier) const final;
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  bool supportsPeriodicBoundaries() const final;
+  Eigen::Matrix3d getStrainDerivatives() const final;
+  bool supportsPointChargeEmbedding() const final;
   Utils::DensityMatrix getDensityMatrixGuess() const final;
   //! Initializes a method with the parameter file present in the settings.
   void initialize() final;
@@ -8,6 +8,7 @@
 #ifndef SPARROW_DFTB2SETTINGS_H
 #define SPARROW_DFTB2SETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 
@@ -25,6 +26,9 @@ class DFTB2Settings : public Scine::Utils::Settings {
     Utils::UniversalSettings::SettingPopulator::populateScfSettings(_fields);
     Utils::UniversalSettings::SettingPopulator::populateSemiEmpiricalSettings(_fields, "mio-1-1");
 
+    SparrowSettingPopulator::populateScfMethodSettings(_fields, true);
+    SparrowSettingPopulator::populatePeriodicBoundarySettings(_fields, "Calculations are done at the Gamma point.");
+
     // Method
     Utils::UniversalSettings::StringDescriptor method("The method to be used.");
     method.setDefaultValue("dftb2");
@@ -13,6 +13,7 @@
 #include "Sparrow/Implementations/Dftb/Utils/SecondOrderFock.h"
 #include "Sparrow/Implementations/Dftb/Utils/ThirdOrderFock.h"
 #include "Sparrow/Implementations/Dftb/Utils/ZeroOrderMatricesCalculator.h"
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
 
 namespace Scine {
@@ -48,6 +49,31 @@ std::shared_ptr<DFTBCommon> DFTB3::getInitializer() const {
   return dftbBase;
 }
 
+void DFTB3::setFragmentDensityGuess(bool enabled, int maxFragmentSize) {
+  auto guess = FragmentDensityGuess::switchGuess(
+      densityMatrixGuess_.get(), enabled, maxFragmentSize, elementTypes_, positions_, aoIndexes_, coreCharges_,
+      nElectrons_, [this]() { return std::make_unique<dftb::DensityGuess>(aoIndexes_, coreCharges_, nElectrons_); },
+      [this]() {
+        // The fragment methods share the parameters loaded once for the structure
+        auto method = std::make_unique<DFTB3>();
+        method->getInitializer()->setMethodDetails(dftbBase->getParameterPath(), dftbBase->getDftbType());
+        method->getInitializer()->setParameterSet(dftbBase->getFragmentParameterSet());
+        return method;
+      },
+      false);
+  if (guess) {
+    densityMatrixGuess_ = std::move(guess);
+  }
+}
+
+void DFTB3::setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding) {
+  std::dynamic_pointer_cast<ScfFock>(electronicPart_)->setPointChargeEmbedding(std::move(embedding));
+}
+
+void DFTB3::setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator) {
+  std::dynamic_pointer_cast<ScfFock>(electronicPart_)->setScfAccelerator(std::move(accelerator));
+}
+
 Eigen::MatrixXd DFTB3::calculateGammaMatrix() const {
   auto thirdOrderFock = std::dynamic_pointer_cast<ThirdOrderFock>(electronicPart_);
   return thirdOrderFock->getGammaMatrix().selfadjointView<Eigen::Lower>();
@@ -18,6 +18,8 @@
 
 namespace Scine {
 namespace Sparrow {
+class PointChargeEmbedding;
+class ScfAccelerator;
 
 namespace dftb {
 class ZeroOrderMatricesCalculator;
@@ -28,6 +30,16 @@ class DFTB3 : public Utils::ScfMethod {
   ~DFTB3() override;
   void initializeFromParameterPath(const std::string& path);
   std::shared_ptr<DFTBCommon> getInitializer() const;
+  /**
+   * @brief Switches between the standard and the fragment-based initial density guess.
+   * An active fragment guess is kept with its cache of fragment densities, only its size limit is updated.
+   * @param maxFragmentSize Maximal number of heavy atoms per fragment, see FragmentDensityGuess.
+   */
+  void setFragmentDensityGuess(bool enabled, int maxFragmentSize);
+  //! @brief Sets the point charges embedding the molecule, nullptr for none, see ScfFock::setPointChargeEmbedding().
+  void setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding);
+  //! @brief Sets the SCF convergence accelerator, nullptr for none, see ScfFock::setScfAccelerator().
+  void setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator);
   Eigen::MatrixXd calculateGammaMatrix() const;
   std::shared_ptr<Eigen::VectorXd> calculateSpinConstantVector() const;
 
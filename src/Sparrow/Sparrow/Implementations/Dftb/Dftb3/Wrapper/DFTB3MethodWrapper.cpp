@@ -78,7 +78,15 @@ void DFTB3MethodWrapper::applySettings() {
     method_.setSpinMultiplicity(spinMultiplicity);
     method_.setConvergenceCriteria({selfConsistenceCriterion, densityRmsdThreshold});
     method_.setMaxIterations(maxScfIterations);
+    // The SCF accelerator replaces the mixer of the SCF method
+    if (scfAccelerator_->getMode() != ScfAccelerator::Mode::None) {
+      scfMixerType = Utils::scf_mixer_t::none;
+    }
     method_.setScfMixer(scfMixerType);
+    method_.setFragmentDensityGuess(settings_->getBool(SparrowSettingsNames::fragmentDensityGuess),
+                                    settings_->getInt(SparrowSettingsNames::maxFragmentSize));
+    method_.setPointChargeEmbedding(pointChargeEmbedding_);
+    method_.setScfAccelerator(scfAccelerator_);
   }
   else {
     settings_->throwIncorrectSettings();
@@ -127,5 +135,13 @@ bool DFTB3MethodWrapper::successfulCalculation() const {
   return method_.hasConverged();
 }
 
+std::vector<double> DFTB3MethodWrapper::getCoreCharges() const {
+  return method_.getInitializer()->getCoreCharges();
+}
+
+bool DFTB3MethodWrapper::supportsPointChargeEmbedding() const {
+  return true;
+}
+
 } /* namespace Sparrow */
 } /* namespace Scine */
@@ -56,6 +56,8 @@ class DFTB3MethodWrapper final : public Utils::CloneInterface<DFTB3MethodWrapper
  private:
   TDDFTBData getTDDFTBDataImpl() const final;
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  bool supportsPointChargeEmbedding() const final;
   Utils::DensityMatrix getDensityMatrixGuess() const final;
   //! Initializes a method with the parameter file present in the settings.
   void initialize() final;
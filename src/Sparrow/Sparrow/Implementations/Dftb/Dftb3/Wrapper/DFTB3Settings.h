@@ -8,6 +8,7 @@
 #ifndef SPARROW_DFTB3SETTINGS_H
 #define SPARROW_DFTB3SETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 
@@ -25,6 +26,8 @@ class DFTB3Settings : public Scine::Utils::Settings {
     Utils::UniversalSettings::SettingPopulator::populateScfSettings(_fields);
     Utils::UniversalSettings::SettingPopulator::populateSemiEmpiricalSettings(_fields, "3ob-3-1");
 
+    SparrowSettingPopulator::populateScfMethodSettings(_fields, true);
+
     // Method
     Utils::UniversalSettings::StringDescriptor method("The method to be used.");
     method.setDefaultValue("dftb3");
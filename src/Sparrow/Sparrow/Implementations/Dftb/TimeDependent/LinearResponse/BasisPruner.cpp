@@ -10,6 +10,8 @@
 #include <Sparrow/Implementations/Exceptions.h>
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
 #include <Utils/Constants.h>
+#include <algorithm>
+#include <cmath>
 
 namespace Scine {
 namespace Sparrow {
@@ -100,95 +102,173 @@ auto BasisPruner<restrictedness>::perturbativeCorrection(PerturbativeThreshold p
 
   isIncluded_.head(nBasisFunctionsUnderThreshold_).array() = true;
 
-  if (numberOfSecondary != 0) {
-    Eigen::VectorXd perturbationContributions = perturbationContributionVector(numberOfSecondary, spinBlock);
+  selection_ = std::make_shared<PruningSelection>();
+  selection_->reference = restrictedness;
+  selection_->spinBlock = spinBlock;
+  selection_->perturbativeThreshold = ptThresh.threshold;
+  for (int primaryIndex = 0; primaryIndex < nBasisFunctionsUnderThreshold_; ++primaryIndex) {
+    selection_->primaryConfigurations.insert(configurationKey(primaryIndex));
+  }
+
+  std::vector<int> secondaryIndices = reusePreviousSelection(ptThresh, spinBlock);
+  nTestedBasisFunctions_ = static_cast<int>(secondaryIndices.size());
+  if (secondaryIndices.empty()) {
+    return;
+  }
+  assert(static_cast<int>(secondaryIndices.size()) <= numberOfSecondary);
 
-    assert(perturbationContributions.size() == numberOfSecondary);
+  Eigen::VectorXd contributions = perturbationContributions(secondaryIndices, spinBlock);
+  assert(contributions.size() == static_cast<Eigen::Index>(secondaryIndices.size()));
 
-    for (int secondaryIndex = 0; secondaryIndex < numberOfSecondary; ++secondaryIndex) {
-      if (std::abs(perturbationContributions(secondaryIndex)) >= ptThresh.threshold) {
-        isIncluded_(nBasisFunctionsUnderThreshold_ + secondaryIndex) = true;
-      }
+  for (int index = 0; index < contributions.size(); ++index) {
+    const int secondaryIndex = secondaryIndices[index];
+    selection_->perturbationContributions[configurationKey(secondaryIndex)] = contributions(index);
+    if (std::abs(contributions(index)) >= ptThresh.threshold) {
+      isIncluded_(secondaryIndex) = true;
     }
   }
 }
 
 template<Utils::Reference restrictedness>
-auto BasisPruner<restrictedness>::perturbationContributionVector(int nOfSecondary, Utils::SpinTransition spinBlock)
-    -> Eigen::VectorXd {
-  // Cols: transitions Rows: atoms
-  // Loop needed in stead of colwise needed because of a known bug in the MKL
-  // assignment in Eigen/3.2.2, Bug 1527 in changelog.
-  // Original version:
-  // enWtransCharges.array().colwise() *= input_.energyDifferences().array().sqrt();
-  Eigen::MatrixXd enWtransCharges = input_.transitionCharges();
-  for (int col = 0; col < int(enWtransCharges.cols()); ++col) {
-    enWtransCharges.col(col).array() *= input_.energyDifferences().array().sqrt();
+auto BasisPruner<restrictedness>::reusePreviousSelection(PerturbativeThreshold ptThresh,
+                                                         Utils::SpinTransition spinBlock) -> std::vector<int> {
+  const int nConfigurations = input_.energyDifferences().size();
+  std::vector<int> secondaryIndices;
+  secondaryIndices.reserve(nConfigurations - nBasisFunctionsUnderThreshold_);
+
+  // The perturbative contributions only stay comparable if they are estimated in the same primary space.
+  const bool isCompatible = previousSelection_ && previousSelection_->reference == restrictedness &&
+                            previousSelection_->spinBlock == spinBlock &&
+                            previousSelection_->perturbativeThreshold == ptThresh.threshold &&
+                            previousSelection_->primaryConfigurations == selection_->primaryConfigurations;
+
+  for (int index = nBasisFunctionsUnderThreshold_; index < nConfigurations; ++index) {
+    if (isCompatible) {
+      const auto key = configurationKey(index);
+      auto previous = previousSelection_->perturbationContributions.find(key);
+      if (previous != previousSelection_->perturbationContributions.end()) {
+        const double contribution = std::abs(previous->second);
+        if (contribution < retestMargin_ * ptThresh.threshold || contribution * retestMargin_ > ptThresh.threshold) {
+          selection_->perturbationContributions.insert(*previous);
+          isIncluded_(index) = contribution >= ptThresh.threshold;
+          continue;
+        }
+      }
+    }
+    secondaryIndices.push_back(index);
   }
-  const Eigen::MatrixXd primaryCharges = enWtransCharges.topRows(nBasisFunctionsUnderThreshold_);
-  const Eigen::MatrixXd secondaryCharges = enWtransCharges.bottomRows(nOfSecondary);
-
-  return (generatePerturbationMatrix(primaryCharges, secondaryCharges, spinBlock).array().square() *
-          generateEnergyWeightingMatrix(spinBlock).array())
-      .colwise()
-      .sum();
+  return secondaryIndices;
 }
 
 template<Utils::Reference restrictedness>
-auto BasisPruner<restrictedness>::generateEnergyWeightingMatrix(Utils::SpinTransition /*spinBlock*/) {
-  int nPrimary = std::count(isIncluded_.data(), isIncluded_.data() + isIncluded_.size(), true);
-  int nSecondary = isIncluded_.size() - nPrimary;
-  Eigen::MatrixXd energyWeighting = Eigen::MatrixXd::Zero(nPrimary, nSecondary);
+auto BasisPruner<restrictedness>::perturbationContributions(const std::vector<int>& secondaryIndices,
+                                                            Utils::SpinTransition spinBlock) const -> Eigen::VectorXd {
+  const int nSecondary = static_cast<int>(secondaryIndices.size());
+  const Eigen::MatrixXd primaryCouplings = generatePrimaryCouplingMatrix(spinBlock);
 
   // Calculate the diagonal elements of the coupling matrix
   // I tried to also use the complete diagonal (energy squared + coupling matrix element)
   // but it made almost no difference, except for the very last roots, but also not
   // extremely much. I had an error on the last root of 40 with 2140 transitions of 0.09 eV instead of 0.04 eV.
   // All roots except last 3 were perfectly matching.
-  Eigen::VectorXd diagonalElements = input_.energyDifferences().array().square();
-
-  int indexIncluded = 0;
-  int indexExcluded = 0;
-  for (int i = 0; i < isIncluded_.size(); ++i) {
-    if (isIncluded_(i)) {
-      energyWeighting.array().row(indexIncluded++) += diagonalElements(i);
-    }
-    else {
-      energyWeighting.array().col(indexExcluded++) -= diagonalElements(i);
+  const Eigen::ArrayXd primaryDiagonal =
+      input_.energyDifferences().head(nBasisFunctionsUnderThreshold_).array().square();
+
+  Eigen::VectorXd contributions(nSecondary);
+  const int nBlocks = (nSecondary + secondaryBlockSize_ - 1) / secondaryBlockSize_;
+#pragma omp parallel
+  {
+    Eigen::MatrixXd secondaryCharges;
+    Eigen::MatrixXd couplings;
+#pragma omp for schedule(dynamic)
+    for (int block = 0; block < nBlocks; ++block) {
+      const int first = block * secondaryBlockSize_;
+      const int nInBlock = std::min(static_cast<int>(secondaryBlockSize_), nSecondary - first);
+      gatherSecondaryCharges(secondaryIndices, first, nInBlock, secondaryCharges);
+      couplings.noalias() = primaryCouplings * secondaryCharges.transpose();
+      for (int secondary = 0; secondary < nInBlock; ++secondary) {
+        const double secondaryDiagonal = std::pow(input_.energyDifferences()(secondaryIndices[first + secondary]), 2);
+        contributions(first + secondary) =
+            (couplings.col(secondary).array().square() / (primaryDiagonal - secondaryDiagonal)).sum();
+      }
     }
   }
-
-  energyWeighting = Eigen::inverse(energyWeighting.array()).eval();
-  return energyWeighting;
+  return contributions;
 }
 
 template<>
-inline auto BasisPruner<Utils::Reference::Restricted>::generatePerturbationMatrix(const Eigen::MatrixXd& primaryCharges,
-                                                                                  const Eigen::MatrixXd& secondaryCharges,
-                                                                                  Utils::SpinTransition spinBlock)
+inline auto
+BasisPruner<Utils::Reference::Restricted>::generatePrimaryCouplingMatrix(Utils::SpinTransition spinBlock) const
     -> Eigen::MatrixXd {
-  return 4.0 * ((spinBlock == Utils::SpinTransition::Singlet)
-                    ? Eigen::MatrixXd(primaryCharges * gammaMatrix_->selfadjointView<Eigen::Lower>() * secondaryCharges.transpose())
-                    : Eigen::MatrixXd(primaryCharges * spinConstants_->asDiagonal() * secondaryCharges.transpose()));
+  const int nPrimary = nBasisFunctionsUnderThreshold_;
+  const Eigen::MatrixXd primaryCharges =
+      input_.energyDifferences().head(nPrimary).cwiseSqrt().asDiagonal() * input_.transitionCharges().topRows(nPrimary);
+  if (spinBlock == Utils::SpinTransition::Singlet) {
+    return 4.0 * (gammaMatrix_->selfadjointView<Eigen::Lower>() * primaryCharges.transpose()).transpose();
+  }
+  return 4.0 * primaryCharges * spinConstants_->asDiagonal();
 }
 
 template<>
-inline auto BasisPruner<Utils::Reference::Unrestricted>::generatePerturbationMatrix(const Eigen::MatrixXd& primaryCharges,
-                                                                                    const Eigen::MatrixXd& secondaryCharges,
-                                                                                    Utils::SpinTransition /*spinBlock*/)
+inline auto
+BasisPruner<Utils::Reference::Unrestricted>::generatePrimaryCouplingMatrix(Utils::SpinTransition /*spinBlock*/) const
     -> Eigen::MatrixXd {
-  assert(input_.isBeta().size() == (primaryCharges.rows() + secondaryCharges.rows()));
-
-  Eigen::MatrixXd magnetizationComponent = primaryCharges * spinConstants_->asDiagonal() * secondaryCharges.transpose();
-  for (int i = 0; i < primaryCharges.rows(); ++i) {
-    for (int j = 0; j < secondaryCharges.rows(); ++j) {
-      if (input_.isBeta()(i) != input_.isBeta()(primaryCharges.rows() + j)) {
-        magnetizationComponent(i, j) *= -1.0;
-      }
+  const int nPrimary = nBasisFunctionsUnderThreshold_;
+  const int nAtoms = input_.transitionCharges().cols();
+  const Eigen::MatrixXd primaryCharges =
+      input_.energyDifferences().head(nPrimary).cwiseSqrt().asDiagonal() * input_.transitionCharges().topRows(nPrimary);
+  // The magnetization coupling changes sign between alpha and beta configurations: with s = +1 for alpha and -1
+  // for beta, it is s_u q_u W q_v^T s_v, so that the signs are absorbed in the charges of both sides.
+  Eigen::MatrixXd couplings(nPrimary, 2 * nAtoms);
+  couplings.leftCols(nAtoms) = (gammaMatrix_->selfadjointView<Eigen::Lower>() * primaryCharges.transpose()).transpose();
+  couplings.rightCols(nAtoms) = primaryCharges * spinConstants_->asDiagonal();
+  for (int primary = 0; primary < nPrimary; ++primary) {
+    if (input_.isBeta()(primary)) {
+      couplings.row(primary).tail(nAtoms) *= -1.0;
     }
   }
-  return 2.0 * (primaryCharges * gammaMatrix_->selfadjointView<Eigen::Lower>() * secondaryCharges.transpose() +
-                magnetizationComponent);
+  return 2.0 * couplings;
+}
+
+template<>
+inline auto BasisPruner<Utils::Reference::Restricted>::gatherSecondaryCharges(const std::vector<int>& secondaryIndices,
+                                                                              int first, int nSecondary,
+                                                                              Eigen::MatrixXd& secondaryCharges) const
+    -> void {
+  secondaryCharges.resize(nSecondary, input_.transitionCharges().cols());
+  for (int secondary = 0; secondary < nSecondary; ++secondary) {
+    const int index = secondaryIndices[first + secondary];
+    secondaryCharges.row(secondary) =
+        std::sqrt(input_.energyDifferences()(index)) * input_.transitionCharges().row(index);
+  }
+}
+
+template<>
+inline auto
+BasisPruner<Utils::Reference::Unrestricted>::gatherSecondaryCharges(const std::vector<int>& secondaryIndices, int first,
+                                                                    int nSecondary,
+                                                                    Eigen::MatrixXd& secondaryCharges) const -> void {
+  const int nAtoms = input_.transitionCharges().cols();
+  secondaryCharges.resize(nSecondary, 2 * nAtoms);
+  for (int secondary = 0; secondary < nSecondary; ++secondary) {
+    const int index = secondaryIndices[first + secondary];
+    secondaryCharges.row(secondary).head(nAtoms) =
+        std::sqrt(input_.energyDifferences()(index)) * input_.transitionCharges().row(index);
+    secondaryCharges.row(secondary).tail(nAtoms) =
+        (input_.isBeta()(index) ? -1.0 : 1.0) * secondaryCharges.row(secondary).head(nAtoms);
+  }
+}
+
+template<>
+inline auto BasisPruner<Utils::Reference::Restricted>::configurationKey(int index) const
+    -> PruningSelection::ConfigurationKey {
+  return std::make_tuple(input_.excitations()[index].occ, input_.excitations()[index].vir, false);
+}
+
+template<>
+inline auto BasisPruner<Utils::Reference::Unrestricted>::configurationKey(int index) const
+    -> PruningSelection::ConfigurationKey {
+  return std::make_tuple(input_.excitations()[index].occ, input_.excitations()[index].vir, input_.isBeta()(index));
 }
 
 template<Utils::Reference restrictedness>
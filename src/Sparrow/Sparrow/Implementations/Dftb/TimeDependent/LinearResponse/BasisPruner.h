@@ -11,6 +11,10 @@
 #include <Sparrow/Implementations/TimeDependent/LinearResponseCalculator.h>
 #include <Utils/Math/IterativeDiagonalizer/SigmaVectorEvaluator.h>
 #include <Utils/Math/IterativeDiagonalizer/SpinAdaptedEigenContainer.h>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
 #include <vector>
 
 namespace Scine {
@@ -47,6 +51,23 @@ struct PerturbativeThreshold {
   double threshold;
 };
 
+/**
+ * @brief Selection of a previous pruning, used to prune the next frame of a trajectory incrementally.
+ * @struct PruningSelection
+ * The configurations are identified by their occupied and virtual orbital and by whether they are beta
+ * transitions, as their position in the energy order may change from one frame to the next.
+ */
+struct PruningSelection {
+  //! @brief (occupied orbital, virtual orbital, isBeta) of a configuration.
+  using ConfigurationKey = std::tuple<int, int, bool>;
+  Utils::Reference reference;
+  Utils::SpinTransition spinBlock;
+  double perturbativeThreshold;
+  std::set<ConfigurationKey> primaryConfigurations;
+  //! @brief The estimated interaction with the primary space of every secondary configuration.
+  std::map<ConfigurationKey, double> perturbationContributions;
+};
+
 /**
  * @brief This class takes care of pruning the singly excited determinant space. It is called when a pruned calculation
  * is started. It prunes the vector of energy differences of the substituted orbitals in a determinant and the
@@ -64,6 +85,12 @@ struct PerturbativeThreshold {
  * as estimated by perturbation theory. The contribution of all the other basis functions is estimated by
  * perturbation theory and added to the diagonal of the matrix (added to the energy difference vector).
  *
+ * The perturbative contributions are evaluated in parallel over blocks of secondary configurations, each block
+ * forming its couplings to the primary space with a single matrix product. If the selection of a previous frame
+ * is given with setPreviousSelection() and the primary space is unchanged, only the secondary configurations
+ * whose previous contribution is close to the perturbative threshold are tested again, all the others keep their
+ * previous inclusion.
+ *
  * TODO: Pruning with the intensity criterion.
  * Pruning with the intensity criterion(pruningWithIntensity) builds a vector of all excitations that have a
  * corresponding dipole matrix element ($f|r^2|$f) that is higher than the threshold.
@@ -129,6 +156,37 @@ class BasisPruner {
     return nBasisFunctionsUnderThreshold_;
   }
 
+  /**
+   * @brief Returns the number of configurations in the pruned space.
+   */
+  auto getNumberOfConfigurationsAfterPruning() const -> int {
+    return nBasisFunctionsAfterPruning_;
+  }
+
+  /**
+   * @brief Returns the number of secondary configurations whose perturbative contribution was evaluated.
+   * Smaller than the number of secondary configurations only if a previous selection was reused.
+   */
+  auto getNumberOfTestedConfigurations() const -> int {
+    return nTestedBasisFunctions_;
+  }
+
+  /**
+   * @brief Sets the selection of a previous frame, reused in the next pruning if compatible.
+   * The selection is compatible if the reference, the spin block, the perturbative threshold and
+   * the set of primary configurations are the same.
+   */
+  auto setPreviousSelection(std::shared_ptr<const PruningSelection> previousSelection) -> void {
+    previousSelection_ = std::move(previousSelection);
+  }
+
+  /**
+   * @brief Returns the selection of the last pruning, to be given to the pruner of the next frame.
+   */
+  auto getSelection() const -> std::shared_ptr<const PruningSelection> {
+    return selection_;
+  }
+
   /**
    * @brief Prunes a matrix with the already calculated isIncluded_ private member.
    * The matrix will have less-equal rows.
@@ -145,18 +203,34 @@ class BasisPruner {
                                   Utils::SpinTransition spinBlock) -> void;
   auto perturbativeCorrection(PerturbativeThreshold ptThresh, Utils::SpinTransition spinBlock) -> void;
   auto assembleResult(Utils::SpinTransition spinBlock) -> OrderedInput<restrictedness>;
-  auto perturbationContributionVector(int nOfSecondary, Utils::SpinTransition spinBlock) -> Eigen::VectorXd;
-  auto generateEnergyWeightingMatrix(Utils::SpinTransition spinBlock);
-
   /**
    * @brief Estimates with perturbation theory the importance of basis functions above the energy threshold.
    * The estimated contribution of basis function u is given by:
    *
    * E_u = \sum_v^PBF |A_uv|^2 / (E_u - E_v)
    *
+   * The couplings A_uv of a block of secondary configurations are formed as the product of the
+   * primary coupling matrix with the matrix of the secondary charges of the block.
+   * @param secondaryIndices The indices of the secondary configurations to test.
+   */
+  auto perturbationContributions(const std::vector<int>& secondaryIndices, Utils::SpinTransition spinBlock) const
+      -> Eigen::VectorXd;
+  /**
+   * @brief Generates the matrix whose product with the secondary charges gives the couplings to the primary space.
+   * Has a row for every primary configuration.
+   */
+  auto generatePrimaryCouplingMatrix(Utils::SpinTransition spinBlock) const -> Eigen::MatrixXd;
+  /**
+   * @brief Gathers the energy weighted transition charges of the secondary configurations
+   * secondaryIndices[first], ..., secondaryIndices[first + nSecondary - 1] in the rows of secondaryCharges.
+   */
+  auto gatherSecondaryCharges(const std::vector<int>& secondaryIndices, int first, int nSecondary,
+                              Eigen::MatrixXd& secondaryCharges) const -> void;
+  /**
+   * @brief Selects the secondary configurations to test, takes the inclusion of the others from the previous selection.
    */
-  auto generatePerturbationMatrix(const Eigen::MatrixXd& primaryCharges, const Eigen::MatrixXd& secondaryCharges,
-                                  Utils::SpinTransition spinBlock) -> Eigen::MatrixXd;
+  auto reusePreviousSelection(PerturbativeThreshold ptThresh, Utils::SpinTransition spinBlock) -> std::vector<int>;
+  auto configurationKey(int index) const -> PruningSelection::ConfigurationKey;
 
   /**
    * @brief Conditionally fills the result with the "isBeta" bool vector.
@@ -173,7 +247,14 @@ class BasisPruner {
   OrderedInput<restrictedness> input_;
   int nBasisFunctionsAfterPruning_;
   int nBasisFunctionsUnderThreshold_;
+  int nTestedBasisFunctions_ = 0;
   BoolVector isIncluded_;
+  std::shared_ptr<const PruningSelection> previousSelection_;
+  std::shared_ptr<PruningSelection> selection_;
+  // Number of secondary configurations whose couplings are formed in one matrix product.
+  static constexpr int secondaryBlockSize_ = 256;
+  // Previous contributions within a factor of retestMargin_ of the perturbative threshold are tested again.
+  static constexpr double retestMargin_ = 0.5;
 };
 
 } // namespace Sparrow
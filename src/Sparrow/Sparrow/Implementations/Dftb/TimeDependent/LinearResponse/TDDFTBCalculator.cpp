@@ -8,6 +8,7 @@
 #include "TDDFTBCalculator.h"
 #include "BasisPruner.h"
 #include "TDDFTBData.h"
+#include "TDDFTBExcitedStateGradient.h"
 #include "TDDFTBEigenvalueSolver.h"
 #include "TDDFTBSettings.h"
 #include <Sparrow/Implementations/Dftb/DFTBMethodWrapper.h>
@@ -16,6 +17,7 @@
 #include <Sparrow/Implementations/Exceptions.h>
 #include <Sparrow/Implementations/TimeDependent/DiagonalPreconditionerEvaluator.h>
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
+#include <Sparrow/StatesHandling/SparrowCheckpoint.h>
 /* External dependencies */
 #include <Core/Interfaces/Calculator.h>
 #include <Core/Log.h>
@@ -61,7 +63,12 @@ void TDDFTBCalculator::referenceCalculation() {
       dftbMethod_->settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion) > 1e-8) {
     dftbMethod_->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-8);
   }
-  dftbMethod_->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixMO);
+  // The gradients are kept if they were required, they are needed for the gradients of the excited states.
+  Utils::PropertyList requiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixMO);
+  if (dftbMethod_->getRequiredProperties().containsSubSet(Utils::Property::Gradients)) {
+    requiredProperties.addProperty(Utils::Property::Gradients);
+  }
+  dftbMethod_->setRequiredProperties(requiredProperties);
   dftbMethod_->calculate("TDDFTB reference calculation.");
   tddftbData_ = std::make_unique<TDDFTBData>(dftbMethod_->getTDDFTBData());
 }
@@ -132,7 +139,17 @@ const Utils::Results& TDDFTBCalculator::calculate() {
     throw InvalidReferenceCalculationException();
   }
 
+  // The guess is only available for restricted references
+  const bool checkpointed = tddftbData_->occupation.isRestricted();
+  if (!guess_ && checkpointed) {
+    SparrowCheckpoint::loadExcitedStatesGuess(*this);
+  }
   Utils::SpinAdaptedElectronicTransitionResult transitionResult{};
+  iterationCounts_ = IterationCounts{};
+  pruningStatistics_ = PruningStatistics{};
+  singletResponseVectors_.resize(0, 0);
+  tripletResponseVectors_.resize(0, 0);
+  responseVectorsFromTDA_ = settings_->getBool("tda");
 
   bool is_unrestricted = tddftbData_->occupation.isUnrestricted();
 
@@ -157,6 +174,9 @@ const Utils::Results& TDDFTBCalculator::calculate() {
 
   results_.set<Utils::Property::ExcitedStates>(std::move(transitionResult));
   guess_.reset();
+  if (checkpointed) {
+    SparrowCheckpoint::saveExcitedStatesGuess(*this);
+  }
   return results_;
 }
 
@@ -203,7 +223,11 @@ void TDDFTBCalculator::evalImpl(Utils::SpinAdaptedElectronicTransitionResult& tr
   std::unique_ptr<TDDFTBEigenvalueSolver<restrictedness>> evSolver;
 
   if (prunedCalculation) {
+    auto startPruning = std::chrono::steady_clock::now();
     auto pruner = BasisPruner<restrictedness>(orderedInput, tddftbData_->gammaMatrix, tddftbData_->spinConstants);
+    if (settings().getBool("incremental_pruning")) {
+      pruner.setPreviousSelection(pruningSelection_);
+    }
     auto pt = PerturbativeThreshold{settings().getDouble(Utils::SettingsNames::perturbativeThreshold)};
     std::unique_ptr<OrderedInput<restrictedness>> prunedData;
     auto en = EnergyThreshold{settings().getDouble(Utils::SettingsNames::energyThreshold)};
@@ -217,6 +241,16 @@ void TDDFTBCalculator::evalImpl(Utils::SpinAdaptedElectronicTransitionResult& tr
       prunedData = std::make_unique<OrderedInput<restrictedness>>(pruner.prune(en, pt));
       numberOfRoots = pruner.getNumberOfRootsUnderThreshold();
     }
+    pruningSelection_ = pruner.getSelection();
+    pruningStatistics_.nConfigurations = orderedInput.energyDifferences().size();
+    pruningStatistics_.nPrunedConfigurations = pruner.getNumberOfConfigurationsAfterPruning();
+    pruningStatistics_.nTestedConfigurations = pruner.getNumberOfTestedConfigurations();
+    pruningStatistics_.pruningTime =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - startPruning).count();
+    getLog().output << "Pruned space: " << pruningStatistics_.nPrunedConfigurations << " of "
+                    << pruningStatistics_.nConfigurations << " configurations ("
+                    << pruningStatistics_.nTestedConfigurations << " tested perturbatively) in "
+                    << pruningStatistics_.pruningTime << " s." << Core::Log::endl;
 
     excitations_ = prunedData->excitations();
     transitionResult.transitionLabels = detail::getLabels(*prunedData);
@@ -260,10 +294,14 @@ void TDDFTBCalculator::solveEigenvalueProblem<Utils::Reference::Restricted>(
     if (spinBlock == Utils::SettingsNames::SpinBlocks::singlet || spinBlock == "both") { // If singlet
       transitionResult.singlet = std::make_shared<Utils::ElectronicTransitionResult>(
           solver->solve(numberOfRoots, initialSubspaceDimension, Utils::SpinTransition::Singlet));
+      iterationCounts_.singlet = solver->getIterationCounts();
+      singletResponseVectors_ = solver->getResponseVectors();
     }
     if (spinBlock == Utils::SettingsNames::SpinBlocks::triplet || spinBlock == "both") { // If triplet
       transitionResult.triplet = std::make_shared<Utils::ElectronicTransitionResult>(
           solver->solve(numberOfRoots, initialSubspaceDimension, Utils::SpinTransition::Triplet));
+      iterationCounts_.triplet = solver->getIterationCounts();
+      tripletResponseVectors_ = solver->getResponseVectors();
     }
   }
 }
@@ -275,12 +313,57 @@ void TDDFTBCalculator::solveEigenvalueProblem<Utils::Reference::Unrestricted>(
     int initialSubspaceDimension) {
   transitionResult.unrestricted =
       std::make_shared<Utils::ElectronicTransitionResult>(solver->solve(numberOfRoots, initialSubspaceDimension));
+  iterationCounts_.unrestricted = solver->getIterationCounts();
 }
 
 bool TDDFTBCalculator::isDFTB0(std::shared_ptr<DFTBMethodWrapper> method) const {
   return static_cast<bool>(std::dynamic_pointer_cast<DFTB0MethodWrapper>(method));
 }
 
+auto TDDFTBCalculator::getIterationCounts() const -> const IterationCounts& {
+  return iterationCounts_;
+}
+
+auto TDDFTBCalculator::getPruningStatistics() const -> const PruningStatistics& {
+  return pruningStatistics_;
+}
+
+Utils::GradientCollection TDDFTBCalculator::getExcitedStateGradients(int root, Utils::SpinTransition spinBlock) {
+  if (!results_.has<Utils::Property::ExcitedStates>()) {
+    throw std::runtime_error("No excited states were calculated.");
+  }
+  if (!dftbMethod_->results().has<Utils::Property::Gradients>()) {
+    throw std::runtime_error("The gradients of the excited states need the ones of the reference calculation.");
+  }
+  if (pruningStatistics_.nPrunedConfigurations != 0) {
+    throw std::runtime_error("Excited-state gradients are not available with a pruned basis.");
+  }
+  if (!dftbMethod_->getPointChargeEmbedding().empty()) {
+    throw std::runtime_error("Excited-state gradients are not available with point charges.");
+  }
+  const auto& excitedStates = results_.get<Utils::Property::ExcitedStates>();
+  const bool singlet = spinBlock == Utils::SpinTransition::Singlet;
+  const auto& transitionResult = singlet ? excitedStates.singlet : excitedStates.triplet;
+  const Eigen::MatrixXd& responseVectors = singlet ? singletResponseVectors_ : tripletResponseVectors_;
+  if (tddftbData_->occupation.isUnrestricted() || !transitionResult || responseVectors.size() == 0) {
+    throw std::runtime_error("No SCC excited states of a restricted reference were calculated for this spin block.");
+  }
+  if (root < 0 || root >= responseVectors.cols()) {
+    throw std::runtime_error("The excited state " + std::to_string(root) + " was not calculated.");
+  }
+  Eigen::VectorXd responseVector;
+  TimeDependentUtils::transformOrder(responseVectors.col(root), responseVector, orderMap_,
+                                     TimeDependentUtils::Direction::From);
+
+  TDDFTBExcitedStateGradient gradient(*dftbMethod_, *tddftbData_, spinBlock,
+                                      responseVectorsFromTDA_ ? TDDFTBType::TDA : TDDFTBType::TDDFTB);
+  Utils::GradientCollection gradients = dftbMethod_->results().get<Utils::Property::Gradients>();
+  gradients += gradient.calculate(responseVector, transitionResult->eigenStates.eigenValues(root));
+  getLog().output << "Z-vector iterations of the excited-state gradient: " << gradient.getNumberOfZVectorIterations()
+                  << Core::Log::endl;
+  return gradients;
+}
+
 void TDDFTBCalculator::setGuess(std::shared_ptr<GuessSpecifier> guessVectorMatrix) {
   guess_ = std::move(guessVectorMatrix);
 }
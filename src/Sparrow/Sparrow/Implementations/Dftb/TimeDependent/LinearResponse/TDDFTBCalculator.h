@@ -36,6 +36,7 @@ namespace Sparrow {
 
 class DFTBMethodWrapper;
 class TDDFTBData;
+struct PruningSelection;
 template<Utils::Reference restrictedness>
 class OrderedInput;
 template<Utils::Reference restrictedness>
@@ -72,6 +73,19 @@ class TDDFTBEigenvalueSolver;
 class TDDFTBCalculator final : public LinearResponseCalculator {
  public:
   constexpr static const char* model = "TD-DFTB";
+  /**
+   * @brief Size and timing of the basis pruning of the last calculation, all zero if the basis was not pruned.
+   */
+  struct PruningStatistics {
+    //! @brief The number of configurations of the full space.
+    int nConfigurations = 0;
+    //! @brief The number of configurations in the pruned space.
+    int nPrunedConfigurations = 0;
+    //! @brief The number of secondary configurations whose perturbative contribution was evaluated.
+    int nTestedConfigurations = 0;
+    //! @brief The wall time of the pruning in seconds.
+    double pruningTime = 0.0;
+  };
   TDDFTBCalculator();
   ~TDDFTBCalculator() final;
 
@@ -149,6 +163,21 @@ class TDDFTBCalculator final : public LinearResponseCalculator {
    */
   void setGuess(std::shared_ptr<GuessSpecifier> guessVectorMatrix) final;
   auto getGuess() const -> std::shared_ptr<GuessSpecifier> final;
+  /**
+   * @brief Returns the Davidson iteration at which every root of the last calculation converged.
+   * Empty for DFTB0, whose excitation energies are the orbital energy differences.
+   */
+  auto getIterationCounts() const -> const IterationCounts& final;
+  /**
+   * @brief Returns the size and timing of the basis pruning of the last calculation.
+   */
+  auto getPruningStatistics() const -> const PruningStatistics&;
+  /**
+   * @brief Analytical gradients of an excited state of the last calculation, @see TDDFTBExcitedStateGradient.
+   * Only available for DFTB2 with a restricted reference, without pruning of the basis, point charges or periodic
+   * boundaries.
+   */
+  Utils::GradientCollection getExcitedStateGradients(int root, Utils::SpinTransition spinBlock) final;
 
  private:
   void checkMemoryRequirement(int excitationsDim, int numberOfEnergyLevels);
@@ -166,10 +195,17 @@ class TDDFTBCalculator final : public LinearResponseCalculator {
                               int initialSubspaceDimension);
   std::shared_ptr<DFTBMethodWrapper> dftbMethod_;
   std::shared_ptr<GuessSpecifier> guess_;
+  IterationCounts iterationCounts_;
+  PruningStatistics pruningStatistics_;
+  // Selection of the last pruned calculation, reused by the next one if incremental pruning is switched on.
+  std::shared_ptr<const PruningSelection> pruningSelection_;
   std::unique_ptr<Utils::Settings> settings_;
   std::unique_ptr<TDDFTBData> tddftbData_;
   std::vector<int> orderMap_;
   std::vector<Utils::Excitation> excitations_;
+  // Signed eigenvectors of the Davidson solver of the last calculation in energy order, for the gradients.
+  Eigen::MatrixXd singletResponseVectors_, tripletResponseVectors_;
+  bool responseVectorsFromTDA_ = false;
   Utils::Results results_;
 };
 } // namespace Sparrow
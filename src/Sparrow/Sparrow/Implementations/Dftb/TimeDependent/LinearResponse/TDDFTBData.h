@@ -13,6 +13,7 @@
 #include <Utils/DataStructures/SingleParticleEnergies.h>
 #include <Utils/Typenames.h>
 #include <memory>
+#include <vector>
 
 namespace Scine {
 namespace Sparrow {
@@ -30,12 +31,16 @@ class TDDFTBData : public LinearResponseData {
   std::shared_ptr<Eigen::MatrixXd> gammaMatrix;
   /// @brief Magnetic Hubbard parameters (spin constants) size: nAtoms
   std::shared_ptr<Eigen::VectorXd> spinConstants;
+  /// @brief Mulliken charges of the reference, size: nAtoms
+  const std::vector<double>& atomicCharges;
 
   TDDFTBData(const Utils::MolecularOrbitals& MOs, const Utils::SingleParticleEnergies& orbitalEnergies,
              Utils::AtomsOrbitalsIndexes aoIndex, const Utils::ElementTypeCollection& elements,
              const Utils::LcaoUtils::ElectronicOccupation& occupation, const Eigen::MatrixXd& overlapMatrix,
-             const Eigen::MatrixXd& gMatrix, std::shared_ptr<Eigen::VectorXd> spinConstantVector)
-    : LinearResponseData(MOs, orbitalEnergies, std::move(aoIndex), elements, occupation, overlapMatrix) {
+             const Eigen::MatrixXd& gMatrix, std::shared_ptr<Eigen::VectorXd> spinConstantVector,
+             const std::vector<double>& referenceAtomicCharges)
+    : LinearResponseData(MOs, orbitalEnergies, std::move(aoIndex), elements, occupation, overlapMatrix),
+      atomicCharges(referenceAtomicCharges) {
     gammaMatrix = std::make_shared<Eigen::MatrixXd>(gMatrix);
     spinConstants = std::move(spinConstantVector);
   }
@@ -45,7 +50,7 @@ class TDDFTBData : public LinearResponseData {
     return TDDFTBData(method.getMolecularOrbitals(), method.getSingleParticleEnergies(),
                       method.getInitializer()->getAtomsOrbitalsIndexes(), method.getElementTypes(),
                       method.getElectronicOccupation(), method.getOverlapMatrix(), method.calculateGammaMatrix(),
-                      method.calculateSpinConstantVector());
+                      method.calculateSpinConstantVector(), method.getAtomicCharges());
   }
 };
 } // namespace Sparrow
@@ -9,9 +9,11 @@
 
 #include "BasisPruner.h"
 #include "TDDFTBSigmaVectorEvaluator.h"
+#include <Sparrow/Implementations/TimeDependent/DavidsonGuessBuilder.h>
 #include <Sparrow/Implementations/TimeDependent/DiagonalPreconditionerEvaluator.h>
 #include <Sparrow/Implementations/TimeDependent/LinearResponseCalculator.h>
 #include <Sparrow/Implementations/TimeDependent/LinearResponseSettings.h>
+#include <Sparrow/Implementations/TimeDependent/RootConvergenceMonitor.h>
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
 #include <Utils/Math/IterativeDiagonalizer/DavidsonDiagonalizer.h>
 #include <Utils/Math/IterativeDiagonalizer/DiagonalizerSettings.h>
@@ -19,6 +21,15 @@
 namespace Scine {
 namespace Sparrow {
 
+namespace detail {
+inline auto getIsBeta(const OrderedInput<Utils::Reference::Restricted>& /*input*/) -> Eigen::Matrix<bool, -1, 1> {
+  return {};
+}
+inline auto getIsBeta(const OrderedInput<Utils::Reference::Unrestricted>& input) -> Eigen::Matrix<bool, -1, 1> {
+  return input.isBeta();
+}
+} // namespace detail
+
 template<Utils::Reference restrictedness>
 class TDDFTBEigenvalueSolver {
  public:
@@ -50,6 +61,21 @@ class TDDFTBEigenvalueSolver {
     guess_ = std::move(guess);
   }
 
+  /**
+   * @brief The Davidson iteration at which every root of the last call to solve() converged.
+   */
+  auto getIterationCounts() const -> const std::vector<int>& {
+    return iterationCounts_;
+  }
+  /**
+   * @brief The normalized eigenvectors of the last call to solve(), in the order of the configurations of the input:
+   *        the amplitudes X in the Tamm-Dancoff approximation, the eigenvectors F of the Omega matrix otherwise.
+   * Unlike the coefficients of the results, they keep their signs, as required by the excited-state gradients.
+   */
+  auto getResponseVectors() const -> const Eigen::MatrixXd& {
+    return responseVectors_;
+  }
+
  private:
   void checkAndCorrectNumberOfRoots(int& numberOfEnergyLevels, int& initialSubspaceDimension, int nConfigurations);
   void generateTransitionDipoleMoments(Utils::ElectronicTransitionResult& excitedStatesResults,
@@ -81,6 +107,8 @@ class TDDFTBEigenvalueSolver {
   std::shared_ptr<Utils::DipoleMatrix> dipoleMatrix_;
   std::shared_ptr<LinearResponseCalculator::GuessSpecifier> guess_;
   OrderedInput<restrictedness> input_;
+  std::vector<int> iterationCounts_;
+  Eigen::MatrixXd responseVectors_;
   Core::Log& log_;
 };
 
@@ -93,6 +121,35 @@ Utils::ElectronicTransitionResult TDDFTBEigenvalueSolver<restrictedness>::solve(
 
   checkAndCorrectNumberOfRoots(numberOfEnergyLevels, initialSubspaceDimension, nConfigurations);
 
+  auto sigmaVectorEvaluator = std::make_unique<TDDFTBSigmaVectorEvaluator<restrictedness>>(
+      gammaMatrix_, spinConstants_, input_, spinBlock, type);
+
+  // The guess and the preconditioner from the diagonal including the coupling, unless given or asked otherwise
+  auto guess = generateGuess(nConfigurations, spinBlock);
+  const std::string guessType = settings_.getString("davidson_guess");
+  const bool coupledPreconditioner = settings_.getString("preconditioner") == "coupled_diagonal";
+  const bool guessFromDiagonal = !guess && guessType != "energy_differences";
+  Eigen::VectorXd diagonal;
+  if (coupledPreconditioner || guessFromDiagonal) {
+    diagonal = sigmaVectorEvaluator->diagonal();
+  }
+  if (guessFromDiagonal) {
+    const auto isBeta = detail::getIsBeta(input_);
+    if (guessType == "subspace") {
+      int subspaceDimension = settings_.getInt("guess_subspace_dimension");
+      if (subspaceDimension == 0) {
+        subspaceDimension = DavidsonGuessBuilder::defaultSubspaceDimension(initialSubspaceDimension, nConfigurations);
+      }
+      guess = DavidsonGuessBuilder::subspaceGuess(*sigmaVectorEvaluator, diagonal, initialSubspaceDimension,
+                                                  subspaceDimension, isBeta);
+    }
+    else {
+      guess = DavidsonGuessBuilder::diagonalGuess(diagonal, initialSubspaceDimension, isBeta);
+    }
+    // Degenerate configurations can extend the diagonal guess.
+    initialSubspaceDimension = guess->cols();
+  }
+
   Utils::NonOrthogonalDavidson diagonalizer(numberOfEnergyLevels, nConfigurations);
   diagonalizer.settings().modifyInt(Utils::initialGuessDimensionOption, initialSubspaceDimension);
   diagonalizer.settings().modifyDouble(Utils::residualNormToleranceOption, settings_.getDouble(convergence));
@@ -102,14 +159,25 @@ Utils::ElectronicTransitionResult TDDFTBEigenvalueSolver<restrictedness>::solve(
                                       settings_.getInt(Utils::SettingsNames::maxDavidsonIterations));
   }
 
-  diagonalizer.setGuess(generateGuess(nConfigurations, spinBlock));
+  diagonalizer.setGuess(guess);
 
-  diagonalizer.setPreconditionerEvaluator(std::make_unique<DiagonalPreconditionerEvaluator>(input_.energyDifferences()));
+  if (coupledPreconditioner) {
+    diagonalizer.setPreconditionerEvaluator(std::make_unique<DiagonalPreconditionerEvaluator>(diagonal));
+  }
+  else {
+    diagonalizer.setPreconditionerEvaluator(
+        std::make_unique<DiagonalPreconditionerEvaluator>(input_.energyDifferences()));
+  }
 
-  diagonalizer.setSigmaVectorEvaluator(
-      std::make_unique<TDDFTBSigmaVectorEvaluator<restrictedness>>(gammaMatrix_, spinConstants_, input_, spinBlock, type));
+  auto monitor = std::make_unique<RootConvergenceMonitor>(std::move(sigmaVectorEvaluator), numberOfEnergyLevels,
+                                                          settings_.getDouble(convergence), iterationCounts_);
+  const auto* rootConvergenceMonitor = monitor.get();
+  diagonalizer.setSigmaVectorEvaluator(std::move(monitor));
 
   auto eigenvalueProblemResult = diagonalizer.solve(log_);
+  rootConvergenceMonitor->finalize();
+  rootConvergenceMonitor->print(log_);
+  responseVectors_ = eigenvalueProblemResult.eigenVectors.colwise().normalized();
 
   auto excitedStates = formExcitedStatesResults(eigenvalueProblemResult, spinBlock);
 
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#include "TDDFTBExcitedStateGradient.h"
+#include "TDDFTBData.h"
+#include <Sparrow/Implementations/Dftb/DFTBMethodWrapper.h>
+#include <Sparrow/Implementations/Dftb/Utils/DipoleUtils/TransitionChargesCalculator.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+TDDFTBExcitedStateGradient::TDDFTBExcitedStateGradient(const DFTBMethodWrapper& method, const TDDFTBData& tddftbData,
+                                                       Utils::SpinTransition spinBlock, TDDFTBType type)
+  : method_(method), tddftbData_(tddftbData), singlet_(spinBlock == Utils::SpinTransition::Singlet), type_(type) {
+  if (tddftbData_.occupation.isUnrestricted()) {
+    throw std::runtime_error("TD-DFTB excited-state gradients are only available for restricted references.");
+  }
+  if (!singlet_ && !tddftbData_.spinConstants) {
+    throw std::runtime_error("TD-DFTB triplet gradients require the spin constants of the elements.");
+  }
+  const int nOccupied = tddftbData_.occupation.numberOccupiedRestrictedOrbitals();
+  const Eigen::MatrixXd& orbitals = tddftbData_.molecularOrbitals.restrictedMatrix();
+  const int nVirtual = orbitals.cols() - nOccupied;
+  occupiedOrbitals_ = orbitals.leftCols(nOccupied);
+  virtualOrbitals_ = orbitals.rightCols(nVirtual);
+  const auto& energies = tddftbData_.MOEnergies.getRestrictedEnergies();
+  occupiedEnergies_.resize(nOccupied);
+  virtualEnergies_.resize(nVirtual);
+  for (int occ = 0; occ < nOccupied; ++occ) {
+    occupiedEnergies_(occ) = energies[occ];
+  }
+  for (int vir = 0; vir < nVirtual; ++vir) {
+    virtualEnergies_(vir) = energies[nOccupied + vir];
+  }
+  energyDifferences_ = virtualEnergies_.replicate(1, nOccupied) - occupiedEnergies_.transpose().replicate(nVirtual, 1);
+  zVectorSolver_ = std::make_unique<ZVectorSolver>(energyDifferences_);
+
+  TransitionChargesCalculator transitionChargesCalculator(tddftbData_.molecularOrbitals, tddftbData_.overlapMatrix,
+                                                          tddftbData_.AOInfo);
+  transitionCharges_ =
+      transitionChargesCalculator.calculateAtomicTransitionChargeMatrices<Utils::Reference::Restricted>(
+          tddftbData_.occupation);
+
+  // Sparrow stores the charges of the atoms, the fluctuations of the populations have the opposite sign.
+  const auto& atomicCharges = tddftbData_.atomicCharges;
+  chargeFluctuations_ = -Eigen::Map<const Eigen::VectorXd>(atomicCharges.data(), atomicCharges.size());
+  const Eigen::MatrixXd& gamma = *tddftbData_.gammaMatrix;
+  couplingMatrix_ = singlet_ ? gamma : Eigen::MatrixXd(tddftbData_.spinConstants->asDiagonal());
+}
+
+Utils::GradientCollection TDDFTBExcitedStateGradient::calculate(const Eigen::VectorXd& responseVector,
+                                                                double excitationEnergy) const {
+  const Eigen::MatrixXd& occupied = occupiedOrbitals_;
+  const Eigen::MatrixXd& virtuals = virtualOrbitals_;
+  const int nOccupied = occupied.cols();
+  const int nVirtual = virtuals.cols();
+  assert(responseVector.size() == nVirtual * nOccupied);
+  const Eigen::MatrixXd& gamma = *tddftbData_.gammaMatrix;
+  const Eigen::MatrixXd& overlap = tddftbData_.overlapMatrix;
+
+  const Eigen::VectorXd normalized = responseVector.normalized();
+  const Eigen::Map<const Eigen::MatrixXd> F(normalized.data(), nVirtual, nOccupied);
+  Eigen::MatrixXd U, virtualBlock, occupiedBlock;
+  if (type_ == TDDFTBType::TDA) {
+    U = F;
+    virtualBlock = U * U.transpose();
+    occupiedBlock = U.transpose() * U;
+  }
+  else {
+    const Eigen::ArrayXXd sqrtEnergyDifferences = energyDifferences_.array().sqrt();
+    const double sqrtExcitationEnergy = std::sqrt(excitationEnergy);
+    U = (sqrtEnergyDifferences * F.array() / sqrtExcitationEnergy).matrix();
+    const Eigen::MatrixXd V = (sqrtExcitationEnergy * F.array() / sqrtEnergyDifferences).matrix();
+    virtualBlock = 0.5 * (U * U.transpose() + V * V.transpose());
+    occupiedBlock = 0.5 * (U.transpose() * U + V.transpose() * V);
+  }
+
+  const Eigen::MatrixXd differenceDensity =
+      virtuals * virtualBlock * virtuals.transpose() - occupied * occupiedBlock * occupied.transpose();
+  const Eigen::MatrixXd transition = virtuals * U * occupied.transpose();
+  const Eigen::MatrixXd transitionDensity = 0.5 * (transition + transition.transpose());
+  const Eigen::VectorXd transitionPopulations = populations(transitionDensity);
+  const Eigen::VectorXd transitionPotentials = couplingMatrix_ * transitionPopulations;
+
+  // Derivatives of w with respect to the occupied and virtual orbitals, in the basis of the orbitals.
+  const Eigen::MatrixXd& orbitals = tddftbData_.molecularOrbitals.restrictedMatrix();
+  const Eigen::MatrixXd differenceFock =
+      orbitals.transpose() * overlap.cwiseProduct(potentialShifts(gamma * populations(differenceDensity))) * orbitals;
+  const Eigen::MatrixXd transitionFock =
+      orbitals.transpose() * overlap.cwiseProduct(potentialShifts(transitionPotentials)) * orbitals;
+  Eigen::MatrixXd orbitalDerivatives(orbitals.cols(), orbitals.cols());
+  orbitalDerivatives.leftCols(nOccupied) =
+      4.0 * (differenceFock.leftCols(nOccupied) + transitionFock.rightCols(nVirtual) * U);
+  orbitalDerivatives.rightCols(nVirtual) = 4.0 * transitionFock.leftCols(nOccupied) * U.transpose();
+  orbitalDerivatives.topLeftCorner(nOccupied, nOccupied) -= 2.0 * occupiedEnergies_.asDiagonal() * occupiedBlock;
+  orbitalDerivatives.bottomRightCorner(nVirtual, nVirtual) += 2.0 * virtualEnergies_.asDiagonal() * virtualBlock;
+
+  const Eigen::MatrixXd lagrangian = orbitalDerivatives.bottomLeftCorner(nVirtual, nOccupied) -
+                                     orbitalDerivatives.topRightCorner(nOccupied, nVirtual).transpose();
+  const Eigen::MatrixXd z =
+      zVectorSolver_->solve(lagrangian, [this](const Eigen::MatrixXd& vector) { return hessianProduct(vector); });
+
+  const Eigen::MatrixXd zResponse = virtuals * z * occupied.transpose();
+  const Eigen::MatrixXd responseDensity = 0.5 * (zResponse + zResponse.transpose());
+  const Eigen::MatrixXd relaxedDensity = differenceDensity + responseDensity;
+  const Eigen::MatrixXd referenceDensity = 2.0 * occupied * occupied.transpose();
+  const Eigen::VectorXd relaxedPopulations = populations(relaxedDensity);
+
+  // Energy-weighted density contracted with the derivatives of the overlap: the explicit dependence of the Fock
+  // matrix on the overlap, the orthonormality of the orbitals and the overlap dependence of the response charges.
+  Eigen::MatrixXd overlapWeights = potentialShifts(gamma * chargeFluctuations_).cwiseProduct(relaxedDensity) +
+                                   potentialShifts(gamma * relaxedPopulations).cwiseProduct(referenceDensity) +
+                                   4.0 * potentialShifts(transitionPotentials).cwiseProduct(transitionDensity);
+  overlapWeights -= 0.25 * orbitals * (orbitalDerivatives + orbitalDerivatives.transpose()) * orbitals.transpose();
+  const Eigen::MatrixXd energySums =
+      virtualEnergies_.replicate(1, nOccupied) + occupiedEnergies_.transpose().replicate(nVirtual, 1);
+  const Eigen::MatrixXd weightedResponse = virtuals * z.cwiseProduct(energySums) * occupied.transpose();
+  overlapWeights -= 0.25 * (weightedResponse + weightedResponse.transpose());
+  const Eigen::MatrixXd responseFock =
+      orbitals.transpose() * overlap.cwiseProduct(potentialShifts(gamma * populations(responseDensity))) * orbitals;
+  const Eigen::MatrixXd responseFockVirtualOccupied =
+      virtuals * responseFock.bottomLeftCorner(nVirtual, nOccupied) * occupied.transpose();
+  overlapWeights -= 2.0 * occupied * responseFock.topLeftCorner(nOccupied, nOccupied) * occupied.transpose() +
+                    responseFockVirtualOccupied + responseFockVirtualOccupied.transpose();
+
+  Eigen::MatrixXd gammaWeights = relaxedPopulations * chargeFluctuations_.transpose() +
+                                 chargeFluctuations_ * relaxedPopulations.transpose();
+  if (singlet_) {
+    gammaWeights += 4.0 * transitionPopulations * transitionPopulations.transpose();
+  }
+
+  Utils::GradientCollection gradients = Utils::GradientCollection::Zero(tddftbData_.AOInfo.getNAtoms(), 3);
+  method_.addResponseDerivatives(gradients, relaxedDensity, -overlapWeights, gammaWeights);
+  return gradients;
+}
+
+int TDDFTBExcitedStateGradient::getNumberOfZVectorIterations() const {
+  return zVectorSolver_->getNumberOfIterations();
+}
+
+Eigen::VectorXd TDDFTBExcitedStateGradient::populations(const Eigen::MatrixXd& density) const {
+  const auto& aoIndex = tddftbData_.AOInfo;
+  const Eigen::VectorXd aoPopulations = density.cwiseProduct(tddftbData_.overlapMatrix).rowwise().sum();
+  Eigen::VectorXd atomicPopulations(aoIndex.getNAtoms());
+  for (int atom = 0; atom < aoIndex.getNAtoms(); ++atom) {
+    atomicPopulations(atom) =
+        aoPopulations.segment(aoIndex.getFirstOrbitalIndex(atom), aoIndex.getNOrbitals(atom)).sum();
+  }
+  return atomicPopulations;
+}
+
+Eigen::MatrixXd TDDFTBExcitedStateGradient::potentialShifts(const Eigen::VectorXd& atomicPotentials) const {
+  const auto& aoIndex = tddftbData_.AOInfo;
+  const int nAOs = aoIndex.getNAtomicOrbitals();
+  Eigen::VectorXd aoPotentials(nAOs);
+  for (int atom = 0; atom < aoIndex.getNAtoms(); ++atom) {
+    aoPotentials.segment(aoIndex.getFirstOrbitalIndex(atom), aoIndex.getNOrbitals(atom))
+        .setConstant(atomicPotentials(atom));
+  }
+  return 0.5 * (aoPotentials.replicate(1, nAOs) + aoPotentials.transpose().replicate(nAOs, 1));
+}
+
+Eigen::MatrixXd TDDFTBExcitedStateGradient::hessianProduct(const Eigen::MatrixXd& z) const {
+  // The response of the Mulliken charges couples through gamma for both spin blocks.
+  const Eigen::Map<const Eigen::VectorXd> zVector(z.data(), z.size());
+  const Eigen::VectorXd atomicPotentials = *tddftbData_.gammaMatrix * (transitionCharges_.transpose() * zVector);
+  const Eigen::VectorXd coupling = 4.0 * transitionCharges_ * atomicPotentials;
+  return energyDifferences_.cwiseProduct(z) + Eigen::Map<const Eigen::MatrixXd>(coupling.data(), z.rows(), z.cols());
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_TDDFTBEXCITEDSTATEGRADIENT_H
+#define SPARROW_TDDFTBEXCITEDSTATEGRADIENT_H
+
+#include "TDDFTBSigmaVectorEvaluator.h"
+#include <Sparrow/Implementations/TimeDependent/ZVectorSolver.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <memory>
+
+namespace Scine {
+namespace Utils {
+enum class SpinTransition;
+} // namespace Utils
+namespace Sparrow {
+
+class DFTBMethodWrapper;
+class TDDFTBData;
+
+/**
+ * @brief Analytical gradient of a TD-DFTB excitation energy of a restricted DFTB2 reference, with the Z-vector method.
+ *
+ * The excitation energy is written as w = tr(F D) + 2 Q^T Gamma Q with the unrelaxed difference density
+ * D = C_vir Xi_vir C_vir^T - C_occ Xi_occ C_occ^T and the Mulliken charges Q of the symmetrized transition density
+ * of T = C_vir U C_occ^T. Gamma is the gamma matrix for singlets and the diagonal matrix of the spin constants for
+ * triplets. In the Tamm-Dancoff approximation, U = X, Xi_vir = X X^T and Xi_occ = X^T X. Otherwise, with the
+ * eigenvector F of the Omega matrix, U = (e_a - e_i)^(1/2) F / w^(1/2), V = w^(1/2) F / (e_a - e_i)^(1/2),
+ * Xi_vir = (U U^T + V V^T) / 2 and Xi_occ = (U^T U + V^T V) / 2.
+ * The orbital response is folded into the solution z of the Z-vector equations
+ * (e_a - e_i) z_ai + 4 sum_bj q_ai^T gamma q_bj z_bj = -L_ai, with the atomic transition charges q, solved by
+ * conjugate gradients preconditioned by the orbital energy differences.
+ *
+ * The basis is not orthogonal, so the gradient consists of the derivatives of the zero-order Hamiltonian contracted
+ * with the relaxed difference density P = D + (Z + Z^T) / 2 with Z = C_vir z C_occ^T, of the overlap contracted with
+ * an energy-weighted response density and of the gamma matrix contracted with the products of the charges of P, of
+ * the reference and of T.
+ * @pre The reference calculation is converged tightly and its last calculation included the gradients, such that
+ *      the derivatives of the integrals are available.
+ */
+class TDDFTBExcitedStateGradient {
+ public:
+  /**
+   * @param method The DFTB2 method of the reference calculation.
+   * @param tddftbData The data of the reference calculation.
+   * @param spinBlock The spin block of the roots, singlet or triplet.
+   * @param type Whether the roots were calculated in the Tamm-Dancoff approximation.
+   */
+  TDDFTBExcitedStateGradient(const DFTBMethodWrapper& method, const TDDFTBData& tddftbData,
+                             Utils::SpinTransition spinBlock, TDDFTBType type);
+
+  /**
+   * @brief Gradient of the excitation energy of a root with respect to the positions of the atoms.
+   * @param responseVector The eigenvector of the root in standard order (vir fast index, occ slow index), the
+   *        amplitudes X in the Tamm-Dancoff approximation and the eigenvector F of the Omega matrix otherwise.
+   * @param excitationEnergy The excitation energy w of the root.
+   */
+  Utils::GradientCollection calculate(const Eigen::VectorXd& responseVector, double excitationEnergy) const;
+  //! @brief Number of conjugate gradient iterations of the Z-vector equations in the last call to calculate().
+  int getNumberOfZVectorIterations() const;
+
+ private:
+  // Mulliken populations of the atoms for a symmetric AO density matrix.
+  Eigen::VectorXd populations(const Eigen::MatrixXd& density) const;
+  // AO matrix (v_A + v_B) / 2 of the atomic potentials v, with A and B the atoms of the AOs.
+  Eigen::MatrixXd potentialShifts(const Eigen::VectorXd& atomicPotentials) const;
+  // Product of the orbital Hessian of the Z-vector equations with z.
+  Eigen::MatrixXd hessianProduct(const Eigen::MatrixXd& z) const;
+
+  const DFTBMethodWrapper& method_;
+  const TDDFTBData& tddftbData_;
+  bool singlet_;
+  TDDFTBType type_;
+  Eigen::MatrixXd occupiedOrbitals_, virtualOrbitals_;
+  Eigen::VectorXd occupiedEnergies_, virtualEnergies_;
+  // Orbital energy differences e_a - e_i as a (virtual x occupied) matrix.
+  Eigen::MatrixXd energyDifferences_;
+  // Atomic transition charges, rows in standard order.
+  Eigen::MatrixXd transitionCharges_;
+  // Mulliken charges of the reference as differences of the populations to the neutral atoms.
+  Eigen::VectorXd chargeFluctuations_;
+  // Gamma matrix of the coupling of the spin block.
+  Eigen::MatrixXd couplingMatrix_;
+  std::unique_ptr<ZVectorSolver> zVectorSolver_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_TDDFTBEXCITEDSTATEGRADIENT_H
@@ -8,6 +8,7 @@
 #ifndef SPARROW_TDDFTBSETTINGS_H
 #define SPARROW_TDDFTBSETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Sparrow/Implementations/TimeDependent/LinearResponseSettings.h>
 
 namespace Scine {
@@ -31,14 +32,26 @@ class TDDFTBSettings : public LinearResponseSettings {
     perturbationTheoryThresholdForPruning.setMinimum(0.);
     perturbationTheoryThresholdForPruning.setDefaultValue(1e-4);
 
+    Utils::UniversalSettings::BoolDescriptor incrementalPruning(
+        "Reuses the pruning of the previous calculation, only configurations close to the perturbative threshold "
+        "are tested again.");
+    incrementalPruning.setDefaultValue(false);
+
     Utils::UniversalSettings::BoolDescriptor TDAApproximation(
         "Switches on the TDA for the excited states calculation.");
     TDAApproximation.setDefaultValue(false);
 
+    Utils::UniversalSettings::StringDescriptor checkpointFile(
+        "Checkpoint file of the reference calculation, in which the excited states are stored as guess for a restart, "
+        "empty for none.");
+    checkpointFile.setDefaultValue("");
+
     _fields.push_back(Utils::SettingsNames::pruneBasis, std::move(prunedBasisCalculation));
     _fields.push_back(Utils::SettingsNames::energyThreshold, std::move(energyThresholdForPruning));
     _fields.push_back(Utils::SettingsNames::perturbativeThreshold, std::move(perturbationTheoryThresholdForPruning));
+    _fields.push_back("incremental_pruning", std::move(incrementalPruning));
     _fields.push_back("tda", std::move(TDAApproximation));
+    _fields.push_back(SparrowSettingsNames::checkpointFile, std::move(checkpointFile));
     resetToDefaults();
   }
 };
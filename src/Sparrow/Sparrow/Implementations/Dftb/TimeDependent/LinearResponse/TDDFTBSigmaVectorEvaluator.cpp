@@ -15,10 +15,14 @@ namespace Sparrow {
 
 namespace detail {
 
-inline void negativeBetaTransitions(Eigen::Ref<Eigen::VectorXd> toTransform,
+inline void negativeBetaTransitions(Eigen::Ref<Eigen::MatrixXd> toTransform,
                                     const Eigen::Ref<const Eigen::Matrix<bool, -1, 1>>& isBeta) {
-  assert(toTransform.size() == isBeta.size());
-  toTransform = (isBeta).select(-toTransform, toTransform);
+  assert(toTransform.rows() == isBeta.size());
+  for (int transition = 0; transition < isBeta.size(); ++transition) {
+    if (isBeta(transition)) {
+      toTransform.row(transition) *= -1.0;
+    }
+  }
 }
 } // namespace detail
 
@@ -46,37 +50,41 @@ const Eigen::MatrixXd& TDDFTBSigmaVectorEvaluator<restrictedness>::evaluate(cons
   const int alreadyComputedSigmaVectors = currentSigmaMatrix_.cols();
   const int vectorsToCompute = dimCol - alreadyComputedSigmaVectors;
 
-  Eigen::MatrixXd sigmaMatrix(dimRow, vectorsToCompute);
+  // All new sigma vectors are formed at once with matrix-matrix products, such that the cost of reading the
+  // transition charges is shared by the whole block instead of being paid once per guess vector.
   // X_{BI} = \sum_{jb} h_{jb, B} * T_{jb, I}
-  // T: guess vector
+  // T: guess vectors
   // h: atomic energy weighted transition charges
   // Y_{AI} = \sum_{B} \gamma_{AB} * X_{BI}
   // R_{ia,I} = \Delta_{ia}^2 * T_{ia, I} + 4 * \sum_{A} h_{ia, A} * Y_{AI}
-  // R: sigma vector
-
-#pragma omp parallel for schedule(dynamic) default(none) shared(sigmaMatrix, guessVectors) \
-    firstprivate(vectorsToCompute, alreadyComputedSigmaVectors)
-  for (int col = 0; col < vectorsToCompute; ++col) {
-    int const colIndex = col + alreadyComputedSigmaVectors;
-    const Eigen::VectorXd& guessVector = guessVectors.col(colIndex);
-
-    // Necessary to have a temporary here because with some
-    // setup of linear algebra libraries not having this caused race conditions.
-    Eigen::VectorXd sigmaMatrixColumn =
-        isTDA_ ? Eigen::VectorXd(input_.energyDifferences().cwiseProduct(guessVector))
-               : Eigen::VectorXd(input_.energyDifferences().cwiseAbs2().cwiseProduct(guessVector));
-
-    sigmaMatrixColumn += calculateAtomicContraction(calculateYAI(calculateXBI(guessVector)));
+  // R: sigma vectors
+  const Eigen::MatrixXd guessBlock = guessVectors.rightCols(vectorsToCompute);
+  const Eigen::VectorXd diagonal =
+      isTDA_ ? input_.energyDifferences() : Eigen::VectorXd(input_.energyDifferences().cwiseAbs2());
 
-    fillAdditionalSigmaMatrixTerms(sigmaMatrixColumn, guessVector);
-    sigmaMatrix.col(col) = sigmaMatrixColumn;
-  }
+  Eigen::MatrixXd sigmaMatrix = diagonal.asDiagonal() * guessBlock;
+  sigmaMatrix += calculateAtomicContraction(calculateYAI(calculateXBI(guessBlock)));
+  fillAdditionalSigmaMatrixTerms(sigmaMatrix, guessBlock);
 
   currentSigmaMatrix_.conservativeResize(dimRow, dimCol);
   currentSigmaMatrix_.rightCols(vectorsToCompute) = sigmaMatrix;
   return currentSigmaMatrix_;
 }
 
+template<Utils::Reference restrictedness>
+Eigen::VectorXd TDDFTBSigmaVectorEvaluator<restrictedness>::diagonal() const {
+  const Eigen::MatrixXd& h = energyWeightedAtomicTransitionCharges_;
+  Eigen::VectorXd result =
+      isTDA_ ? input_.energyDifferences() : Eigen::VectorXd(input_.energyDifferences().cwiseAbs2());
+  // Y^T = (gamma h^T)^T has the same layout as h, the diagonal of h Y is the row-wise sum of h * Y^T.
+  result += factor() * (h.array() * calculateYAI(h.transpose()).transpose().array()).rowwise().sum().matrix();
+  if (restrictedness == Utils::Reference::Unrestricted) {
+    // The signs of the magnetization term cancel on the diagonal: 2 * \sum_{A} W_A h_{ia, A}^2
+    result += 2.0 * h.cwiseAbs2() * *spinConstantsVector_;
+  }
+  return result;
+}
+
 template<Utils::Reference restrictedness>
 void TDDFTBSigmaVectorEvaluator<restrictedness>::calculateAtomicEnergyWeightedTransitionCharges(const Eigen::MatrixXd& transitionCharges) {
   assert(transitionCharges.rows() == input_.energyDifferences().rows());
@@ -90,28 +98,28 @@ void TDDFTBSigmaVectorEvaluator<restrictedness>::calculateAtomicEnergyWeightedTr
 }
 
 template<Utils::Reference restrictedness>
-Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<restrictedness>::calculateXBI(const Eigen::VectorXd& guessVector) const {
-  return energyWeightedAtomicTransitionCharges_.transpose() * guessVector;
+Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<restrictedness>::calculateXBI(const Eigen::MatrixXd& guessVectors) const {
+  return energyWeightedAtomicTransitionCharges_.transpose() * guessVectors;
 }
 
 template<>
-Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted>::calculateYAI(const Eigen::VectorXd& XBI) const {
+Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted>::calculateYAI(const Eigen::MatrixXd& XBI) const {
   assert(spinBlock_ == Utils::SpinTransition::Singlet || spinBlock_ == Utils::SpinTransition::Triplet);
   if (spinBlock_ == Utils::SpinTransition::Singlet) {
     return gammaMatrix_->selfadjointView<Eigen::Lower>() * XBI;
   }
   else { // Utils::SpinTransition::Triplet
-    return spinConstantsVector_->cwiseProduct(XBI);
+    return spinConstantsVector_->asDiagonal() * XBI;
   }
 }
 
 template<>
-Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<Utils::Reference::Unrestricted>::calculateYAI(const Eigen::VectorXd& XBI) const {
+Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<Utils::Reference::Unrestricted>::calculateYAI(const Eigen::MatrixXd& XBI) const {
   return (gammaMatrix_->selfadjointView<Eigen::Lower>()) * XBI;
 }
 
 template<Utils::Reference restrictedness>
-Eigen::VectorXd TDDFTBSigmaVectorEvaluator<restrictedness>::calculateAtomicContraction(const Eigen::MatrixXd& YAIMatrix) const {
+Eigen::MatrixXd TDDFTBSigmaVectorEvaluator<restrictedness>::calculateAtomicContraction(const Eigen::MatrixXd& YAIMatrix) const {
   return factor() * energyWeightedAtomicTransitionCharges_ * YAIMatrix;
 }
 
@@ -129,22 +137,18 @@ inline void TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted>::fillAdditi
 template<>
 template<typename Derived, typename OtherDerived>
 inline void TDDFTBSigmaVectorEvaluator<Utils::Reference::Unrestricted>::fillAdditionalSigmaMatrixTerms(
-    const Eigen::MatrixBase<Derived>& sigmaBlock, const Eigen::MatrixBase<OtherDerived>& guessVector) const {
-  assert(guessVector.size() == input_.isBeta().size());
-  Eigen::VectorXd modifiedGuessVector = guessVector;
-
-  detail::negativeBetaTransitions(modifiedGuessVector, input_.isBeta());
-
-  for (int atom = 0; atom < spinConstantsVector_->size(); ++atom) {
-    double spinDependentTransitionCont = energyWeightedAtomicTransitionCharges_.col(atom).transpose() * modifiedGuessVector;
-    spinDependentTransitionCont *= 2.0 * (*spinConstantsVector_)(atom);
-
-    Eigen::VectorXd spinDependentTransition = spinDependentTransitionCont * energyWeightedAtomicTransitionCharges_.col(atom);
-
-    detail::negativeBetaTransitions(spinDependentTransition, input_.isBeta());
-
-    const_cast<Eigen::MatrixBase<Derived>&>(sigmaBlock) += spinDependentTransition;
-  }
+    const Eigen::MatrixBase<Derived>& sigmaBlock, const Eigen::MatrixBase<OtherDerived>& guessVectors) const {
+  assert(guessVectors.rows() == input_.isBeta().size());
+  Eigen::MatrixXd modifiedGuessVectors = guessVectors;
+  detail::negativeBetaTransitions(modifiedGuessVectors, input_.isBeta());
+
+  // M_{AI} = 2 * W_A * \sum_{jb} s_{jb} h_{jb, A} * T_{jb, I}, with s = -1 for beta transitions
+  Eigen::MatrixXd spinDependentTransitionCont = energyWeightedAtomicTransitionCharges_.transpose() * modifiedGuessVectors;
+  spinDependentTransitionCont = 2.0 * spinConstantsVector_->asDiagonal() * spinDependentTransitionCont;
+  Eigen::MatrixXd spinDependentTransitions = energyWeightedAtomicTransitionCharges_ * spinDependentTransitionCont;
+  detail::negativeBetaTransitions(spinDependentTransitions, input_.isBeta());
+
+  const_cast<Eigen::MatrixBase<Derived>&>(sigmaBlock) += spinDependentTransitions;
 }
 
 template<>
@@ -25,7 +25,9 @@ enum class TDDFTBType { TDDFTB, TDA };
  * @file TDDFTBigmaVectorEvaluator
  * @brief This class evaluates the sigma vector of the TDDFTB matrix for a KS reference.
  * The sigma matrix calculated previously is cached to be reused in subsequent iterations
- * of the Davidson-Liu algorithm.
+ * of the Davidson-Liu algorithm. The sigma vectors of all new guess vectors are evaluated
+ * as one block with matrix-matrix products, transition charges times guess vectors,
+ * gamma matrix times the result and the back-transformation with the transition charges.
  *
  * Implementation details for the singlet closed-shell case:
  * R. Rüger, E. van Lenthe, Y. Lu, J. Frenzel, T. Heine, L. Visscher,
@@ -66,6 +68,11 @@ class TDDFTBSigmaVectorEvaluator final : public Utils::SigmaVectorEvaluator {
    * @pre Gamma matrix and Spin Constants dimensions match number of atoms.
    */
   auto evaluate(const Eigen::MatrixXd& guessVectors) const -> const Eigen::MatrixXd& final;
+  /**
+   * @brief Calculates the diagonal of the TDDFTB matrix, including the coupling, in increasing energy order.
+   * The diagonal is exact: the coupling term of configuration ia is factor * \sum_{AB} h_{ia, A} \gamma_{AB} h_{ia, B}.
+   */
+  auto diagonal() const -> Eigen::VectorXd;
 
  private:
   /**
@@ -73,23 +80,23 @@ class TDDFTBSigmaVectorEvaluator final : public Utils::SigmaVectorEvaluator {
    */
   void calculateAtomicEnergyWeightedTransitionCharges(const Eigen::MatrixXd& transitionCharges);
   /**
-   * @brief Contracts the guess vector with the energy-weighted transition charges to form matrix XBI.
+   * @brief Contracts the block of guess vectors with the energy-weighted transition charges to form matrix XBI.
    */
-  auto calculateXBI(const Eigen::VectorXd& guessVector) const -> Eigen::MatrixXd;
+  auto calculateXBI(const Eigen::MatrixXd& guessVectors) const -> Eigen::MatrixXd;
   /**
    * @brief Contracts matrix XBI with the gamma/spin-coupling matrix to form matrix YAI.
    */
-  auto calculateYAI(const Eigen::VectorXd& XBI) const -> Eigen::MatrixXd;
+  auto calculateYAI(const Eigen::MatrixXd& XBI) const -> Eigen::MatrixXd;
   /**
    * @brief Contracts matrix YAI with the energy-weighted transition charges.
    */
-  auto calculateAtomicContraction(const Eigen::MatrixXd& YAIMatrix) const -> Eigen::VectorXd;
+  auto calculateAtomicContraction(const Eigen::MatrixXd& YAIMatrix) const -> Eigen::MatrixXd;
   /**
-   * @brief In the unrestricted case, add the magnetization component to the final result.
+   * @brief In the unrestricted case, add the magnetization component to the block of sigma vectors.
    */
   template<typename Derived, typename OtherDerived>
   void fillAdditionalSigmaMatrixTerms(const Eigen::MatrixBase<Derived>& sigmaBlock,
-                                      const Eigen::MatrixBase<OtherDerived>& guessVector) const;
+                                      const Eigen::MatrixBase<OtherDerived>& guessVectors) const;
   /**
    * @brief Resets the sigma matrix in the event of subspace collapse
    */
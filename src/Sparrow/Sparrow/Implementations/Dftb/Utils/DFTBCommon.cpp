@@ -16,6 +16,7 @@
 #include <Utils/IO/NativeFilenames.h>
 #include <Utils/Math/AtomicSecondDerivativeCollection.h>
 #include <Utils/Scf/MethodExceptions.h>
+#include <algorithm>
 #include <cmath>
 #include <fstream>
 #include <iostream>
@@ -69,6 +70,34 @@ void DFTBCommon::setMethodDetails(const std::string& path, unsigned dftbType) {
   dftbType_ = dftbType;
 }
 
+void DFTBCommon::setParameterSet(std::shared_ptr<const ParameterSet> parameters) {
+  parameterSet_ = std::move(parameters);
+}
+
+std::shared_ptr<const ParameterSet> DFTBCommon::getFragmentParameterSet() {
+  std::lock_guard<std::mutex> lock(fragmentParameterMutex_);
+  if (!fragmentParameterSet_) {
+    std::vector<int> Zs{1};
+    for (auto e : elementTypes_) {
+      Zs.push_back(Utils::ElementInfo::Z(e));
+    }
+    std::sort(std::begin(Zs), std::end(Zs));
+    Zs.erase(std::unique(std::begin(Zs), std::end(Zs)), std::end(Zs));
+    fragmentParameterSet_ = std::make_shared<const ParameterSet>(loadParameters(path_, Zs));
+  }
+  return fragmentParameterSet_;
+}
+
+ParameterSet DFTBCommon::loadParameters(const std::string& path, const std::vector<int>& Zs) {
+  if (boost::filesystem::exists(path) && boost::filesystem::is_directory(path)) {
+    return ParameterSet::collect(path, Zs);
+  }
+  return embeddedParameters(path, Zs).value_or_eval([&path]() -> ParameterSet {
+    throw std::runtime_error("No embedded parameters named '" + path + "'");
+    return {};
+  });
+}
+
 void DFTBCommon::initialize(const std::string& path, unsigned dftbType) {
   setMethodDetails(path, dftbType);
   initialize(elementTypes_);
@@ -108,15 +137,28 @@ void DFTBCommon::initialize(const Utils::ElementTypeCollection& elementTypes) {
   std::sort(std::begin(Zs), std::end(Zs));
   Zs.erase(std::unique(std::begin(Zs), std::end(Zs)), std::end(Zs));
 
+  fragmentParameterSet_.reset();
+  auto isPresent = [&](int Z) { return std::binary_search(std::begin(Zs), std::end(Zs), Z); };
+  bool parameterSetComplete = static_cast<bool>(parameterSet_);
+  for (int Z1 : Zs) {
+    for (int Z2 : Zs) {
+      parameterSetComplete = parameterSetComplete && parameterSet_->pairData.count(std::make_pair(Z1, Z2)) > 0;
+    }
+  }
+
   ParameterSet parameters;
-  if (boost::filesystem::exists(path_) && boost::filesystem::is_directory(path_)) {
-    parameters = ParameterSet::collect(path_, Zs);
+  if (parameterSetComplete) {
+    // Only the pairs of elements present, the SKPairs need both atoms
+    for (const auto& atomPair : parameterSet_->pairData) {
+      if (isPresent(atomPair.first.first) && isPresent(atomPair.first.second)) {
+        parameters.pairData.insert(atomPair);
+      }
+    }
+    parameters.spin = parameterSet_->spin;
+    parameters.hubbard = parameterSet_->hubbard;
   }
   else {
-    parameters = embeddedParameters(path_, Zs).value_or_eval([this]() -> ParameterSet {
-      throw std::runtime_error("No embedded parameters named '" + path_ + "'");
-      return {};
-    });
+    parameters = loadParameters(path_, Zs);
   }
 
   // Create SKPairs
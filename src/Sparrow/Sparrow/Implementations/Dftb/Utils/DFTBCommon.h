@@ -17,6 +17,7 @@
 #include <array>
 #include <boost/functional/hash.hpp>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Scine {
@@ -30,6 +31,8 @@ namespace Sparrow {
 
 namespace dftb {
 
+struct ParameterSet;
+
 class DFTBCommon : public Utils::StructureDependentInitializer {
  public:
   using AtomicParameterContainer = std::vector<std::unique_ptr<SKAtom>>;
@@ -42,6 +45,16 @@ class DFTBCommon : public Utils::StructureDependentInitializer {
   void initialize(const std::string& path, unsigned dftbType); // TODO: delete.
   void setMethodDetails(const std::string& path, unsigned dftbType);
   void initialize(const Utils::ElementTypeCollection& elementTypes) override;
+  /**
+   * @brief Sets parameters loaded elsewhere, used by initialize() instead of reading them from the parameter path.
+   * They are only used if they contain all element pairs of the structure.
+   */
+  void setParameterSet(std::shared_ptr<const ParameterSet> parameters);
+  /**
+   * @brief Parameters of the elements of the structure and of hydrogen, for the link atoms of the fragment density
+   *        guess. They are read on the first call after initialize(); thread-safe.
+   */
+  std::shared_ptr<const ParameterSet> getFragmentParameterSet();
 
   void reinitializeParameters();
 
@@ -64,6 +77,12 @@ class DFTBCommon : public Utils::StructureDependentInitializer {
   unsigned getNumberElectronsForUnchargedSpecies() const override {
     return nInitialElectrons_;
   }
+  const std::string& getParameterPath() const {
+    return path_;
+  }
+  unsigned getDftbType() const {
+    return dftbType_;
+  }
 
  private:
   static constexpr int nElements_ = 110;
@@ -84,8 +103,14 @@ class DFTBCommon : public Utils::StructureDependentInitializer {
   Utils::AtomsOrbitalsIndexes aoIndexes_;
   Utils::ElementTypeCollection elementTypes_;
 
+  // Reads the parameters of the given elements from a directory or from the embedded parameter sets.
+  static ParameterSet loadParameters(const std::string& path, const std::vector<int>& Zs);
+
   std::string path_;
   unsigned dftbType_;
+  std::shared_ptr<const ParameterSet> parameterSet_;
+  std::shared_ptr<const ParameterSet> fragmentParameterSet_;
+  std::mutex fragmentParameterMutex_;
 };
 
 } // namespace dftb
@@ -9,10 +9,35 @@
 #include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
 #include <Utils/DataStructures/MolecularOrbitals.h>
 #include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+#include <algorithm>
 
 namespace Scine {
 namespace Sparrow {
 
+namespace {
+/*
+ * Atomic transition charges from the occupied orbitals firstOccupied, ..., firstOccupied + nOccupiedInTile - 1
+ * to all virtual orbitals. For every atom A, the nVirtual x nOccupiedInTile matrix
+ * 1/2 (c'_{A,vir}^T c_{A,occ} + c_{A,vir}^T c'_{A,occ}) is formed directly in the column of the tile.
+ */
+void fillTransitionChargeTile(const Eigen::MatrixXd& coefficients, const Eigen::MatrixXd& overlapProduct,
+                              const Utils::AtomsOrbitalsIndexes& aoIndex, int nOccupied, int firstOccupied,
+                              int nOccupiedInTile, Eigen::Ref<Eigen::MatrixXd> tile) {
+  const int nVirtual = coefficients.cols() - nOccupied;
+  assert(tile.rows() == nVirtual * nOccupiedInTile && tile.cols() == aoIndex.getNAtoms());
+  for (int atom = 0; atom < aoIndex.getNAtoms(); ++atom) {
+    const int firstIndex = aoIndex.getFirstOrbitalIndex(atom);
+    const int nAOsOnAtom = aoIndex.getNOrbitals(atom);
+    Eigen::Map<Eigen::MatrixXd> charges(tile.col(atom).data(), nVirtual, nOccupiedInTile);
+    charges.noalias() = overlapProduct.block(firstIndex, nOccupied, nAOsOnAtom, nVirtual).transpose() *
+                        coefficients.block(firstIndex, firstOccupied, nAOsOnAtom, nOccupiedInTile);
+    charges.noalias() += coefficients.block(firstIndex, nOccupied, nAOsOnAtom, nVirtual).transpose() *
+                         overlapProduct.block(firstIndex, firstOccupied, nAOsOnAtom, nOccupiedInTile);
+    charges *= 0.5;
+  }
+}
+} // namespace
+
 TransitionChargesCalculator::TransitionChargesCalculator(const Utils::MolecularOrbitals& molecularOrbitals,
                                                          const Eigen::MatrixXd& overlapMatrix,
                                                          const Utils::AtomsOrbitalsIndexes& aoIndex)
@@ -165,6 +190,45 @@ Eigen::MatrixXd TransitionChargesCalculator::calculateUnrestrictedTransitionChar
   return transitionChargeMatrix;
 }
 
+void TransitionChargesCalculator::fillAtomicTransitionCharges(const Eigen::MatrixXd& coefficients,
+                                                              const Eigen::MatrixXd& overlapProduct, int nOccupied,
+                                                              Eigen::Ref<Eigen::MatrixXd> transitionCharges) const {
+  const int nVirtual = coefficients.cols() - nOccupied;
+  const int nOccupiedPerTile = defaultOccupiedOrbitalsPerTile;
+  const int nTiles = (nOccupied + nOccupiedPerTile - 1) / nOccupiedPerTile;
+#pragma omp parallel for schedule(dynamic)
+  for (int tile = 0; tile < nTiles; ++tile) {
+    const int firstOccupied = tile * nOccupiedPerTile;
+    const int nOccupiedInTile = std::min(nOccupiedPerTile, nOccupied - firstOccupied);
+    fillTransitionChargeTile(coefficients, overlapProduct, aoIndex_, nOccupied, firstOccupied, nOccupiedInTile,
+                             transitionCharges.middleRows(nVirtual * firstOccupied, nVirtual * nOccupiedInTile));
+  }
+}
+
+void TransitionChargesCalculator::streamAtomicTransitionCharges(const Eigen::MatrixXd& coefficients,
+                                                                const Eigen::MatrixXd& overlapProduct, int nOccupied,
+                                                                int firstTransition, const TileConsumer& consumer,
+                                                                int nOccupiedPerTile) const {
+  if (nOccupiedPerTile < 1) {
+    throw std::runtime_error("The number of occupied orbitals per tile of transition charges must be positive.");
+  }
+  const int nVirtual = coefficients.cols() - nOccupied;
+  const int nTiles = (nOccupied + nOccupiedPerTile - 1) / nOccupiedPerTile;
+#pragma omp parallel
+  {
+    Eigen::MatrixXd tileCharges;
+#pragma omp for schedule(dynamic)
+    for (int tile = 0; tile < nTiles; ++tile) {
+      const int firstOccupied = tile * nOccupiedPerTile;
+      const int nOccupiedInTile = std::min(nOccupiedPerTile, nOccupied - firstOccupied);
+      tileCharges.resize(nVirtual * nOccupiedInTile, aoIndex_.getNAtoms());
+      fillTransitionChargeTile(coefficients, overlapProduct, aoIndex_, nOccupied, firstOccupied, nOccupiedInTile,
+                               tileCharges);
+      consumer(firstTransition + nVirtual * firstOccupied, tileCharges);
+    }
+  }
+}
+
 void TransitionChargesCalculator::fillOverlapProductMatrix() {
   if (mos_.isRestricted()) {
     overlapProductMatrix_.setRestrictedMatrix(overlapMatrix_ * mos_.restrictedMatrix());
@@ -12,6 +12,7 @@
 #include <Utils/DataStructures/SpinAdaptedMatrix.h>
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -52,6 +53,15 @@ class SpinPolarizedOrbitalsNotAvailableException : public std::exception {
 };
 class TransitionChargesCalculator {
  public:
+  /**
+   * @brief Receives a tile of atomic transition charges.
+   * The first argument is the index of the first transition of the tile, the second one the
+   * N_{transitions in tile}xN_{Atoms} matrix of its transition charges.
+   */
+  using TileConsumer = std::function<void(int, const Eigen::MatrixXd&)>;
+  //! @brief Default number of occupied orbitals per tile of transition charges.
+  static constexpr int defaultOccupiedOrbitalsPerTile = 16;
+
   TransitionChargesCalculator(const Utils::MolecularOrbitals& molecularOrbitals, const Eigen::MatrixXd& overlapMatrix,
                               const Utils::AtomsOrbitalsIndexes& aoIndex);
 
@@ -96,6 +106,23 @@ class TransitionChargesCalculator {
   Eigen::MatrixXd calculateAtomicTransitionChargeMatrices(const Utils::LcaoUtils::ElectronicOccupation& /*occupation*/) const {
     throw std::runtime_error("Wrong specialization in calculateAtomicTransitionChargeMatrices()");
   }
+  /**
+   * @brief Streams the atomic transition charges in tiles of occupied orbitals.
+   * Every tile contains the transitions from nOccupiedPerTile consecutive occupied orbitals to all virtual
+   * orbitals, i.e. a contiguous range of rows of the matrix given by calculateAtomicTransitionChargeMatrices().
+   * The tiles are formed in parallel and only one tile per thread is held in memory, so that the memory
+   * requirement is O(N_{transitions} * N_{Atoms} / N_{tiles}) instead of the one of the full matrix.
+   * @param occupation The electronic occupation, assumes Aufbau construction.
+   * @param consumer Called once per tile. It is called concurrently from several threads, with disjoint tiles.
+   * @param nOccupiedPerTile The number of occupied orbitals per tile.
+   * @tparam restrictedness Whether restricted or unrestricted charges needed.
+   */
+  template<Utils::Reference restrictedness>
+  void streamAtomicTransitionChargeMatrices(const Utils::LcaoUtils::ElectronicOccupation& /*occupation*/,
+                                            const TileConsumer& /*consumer*/,
+                                            int /*nOccupiedPerTile*/ = defaultOccupiedOrbitalsPerTile) const {
+    throw std::runtime_error("Wrong specialization in streamAtomicTransitionChargeMatrices()");
+  }
   /**
    * @brief Calculates the nAtomicOrbitals matrices with element q^\mu_{ij} with i,j all the molecular orbitals.
    * q^mu_ij is the partitioned transition charge from orbital i to j due to atomic orbital mu.
@@ -128,6 +155,19 @@ class TransitionChargesCalculator {
   Eigen::MatrixXd calculateUnrestrictedTransitionChargeMatrices(const Utils::LcaoUtils::ElectronicOccupation& occupation) const;
 
  private:
+  /*
+   * @brief Fills the atomic transition charges of one spin block tile by tile, in parallel over the tiles.
+   * The tiles are written directly into their rows of transitionCharges, no intermediate is formed.
+   */
+  void fillAtomicTransitionCharges(const Eigen::MatrixXd& coefficients, const Eigen::MatrixXd& overlapProduct,
+                                   int nOccupied, Eigen::Ref<Eigen::MatrixXd> transitionCharges) const;
+  /*
+   * @brief Streams the atomic transition charges of one spin block.
+   * firstTransition is the index of the first transition of the spin block.
+   */
+  void streamAtomicTransitionCharges(const Eigen::MatrixXd& coefficients, const Eigen::MatrixXd& overlapProduct,
+                                     int nOccupied, int firstTransition, const TileConsumer& consumer,
+                                     int nOccupiedPerTile) const;
   const Utils::MolecularOrbitals& mos_;
   const Eigen::MatrixXd& overlapMatrix_;
   const Utils::AtomsOrbitalsIndexes& aoIndex_;
@@ -143,24 +183,9 @@ inline Eigen::MatrixXd TransitionChargesCalculator::calculateAtomicTransitionCha
 
   auto nOccupied = occupation.numberOccupiedRestrictedOrbitals();
   auto nVirtual = mos_.numberOrbitals() - nOccupied;
-  Eigen::MatrixXd transitionAtomicCharges = Eigen::MatrixXd::Zero(nOccupied * nVirtual, aoIndex_.getNAtoms());
-
-  // Get correct coefficient matrix
-  const Eigen::MatrixXd& occupiedBlock = mos_.restrictedMatrix().leftCols(nOccupied);
-  const Eigen::MatrixXd& virtualBlock = mos_.restrictedMatrix().rightCols(nVirtual);
-  const Eigen::MatrixXd& SCvir = overlapProductMatrix_.restrictedMatrix().rightCols(nVirtual);
-  const Eigen::MatrixXd& SCocc = overlapProductMatrix_.restrictedMatrix().leftCols(nOccupied);
-  for (int atom = 0; atom < aoIndex_.getNAtoms(); ++atom) {
-    auto firstIndex = aoIndex_.getFirstOrbitalIndex(atom);
-    auto nAOsOnAtom = aoIndex_.getNOrbitals(atom);
-    Eigen::MatrixXd frontTransition =
-        SCvir.middleRows(firstIndex, nAOsOnAtom).transpose() * occupiedBlock.middleRows(firstIndex, nAOsOnAtom);
-    Eigen::MatrixXd backTransition =
-        virtualBlock.middleRows(firstIndex, nAOsOnAtom).transpose() * SCocc.middleRows(firstIndex, nAOsOnAtom);
-
-    transitionAtomicCharges.col(atom) = 0.5 * (Eigen::Map<Eigen::VectorXd>(frontTransition.data(), frontTransition.size()) +
-                                               Eigen::Map<Eigen::VectorXd>(backTransition.data(), backTransition.size()));
-  }
+  Eigen::MatrixXd transitionAtomicCharges(nOccupied * nVirtual, aoIndex_.getNAtoms());
+  fillAtomicTransitionCharges(mos_.restrictedMatrix(), overlapProductMatrix_.restrictedMatrix(), nOccupied,
+                              transitionAtomicCharges);
   return transitionAtomicCharges;
 }
 
@@ -180,33 +205,45 @@ inline Eigen::MatrixXd TransitionChargesCalculator::calculateAtomicTransitionCha
   auto nOccupiedBeta = occupation.numberBetaElectrons();
   auto nVirtualBeta = mos_.betaMatrix().cols() - nOccupiedBeta;
   Eigen::MatrixXd transitionChargeMatrix(nOccupiedAlpha * nVirtualAlpha + nOccupiedBeta * nVirtualBeta, aoIndex_.getNAtoms());
-  const Eigen::MatrixXd& occupiedBlockAlpha = mos_.alphaMatrix().leftCols(nOccupiedAlpha);
-  const Eigen::MatrixXd& virtualBlockAlpha = mos_.alphaMatrix().rightCols(nVirtualAlpha);
-  const Eigen::MatrixXd& occupiedBlockBeta = mos_.betaMatrix().leftCols(nOccupiedBeta);
-  const Eigen::MatrixXd& virtualBlockBeta = mos_.betaMatrix().rightCols(nVirtualBeta);
-  const Eigen::MatrixXd& SCAlphavir = overlapProductMatrix_.alphaMatrix().rightCols(nVirtualAlpha);
-  const Eigen::MatrixXd& SCAlphaocc = overlapProductMatrix_.alphaMatrix().leftCols(nOccupiedAlpha);
-  const Eigen::MatrixXd& SCBetavir = overlapProductMatrix_.betaMatrix().rightCols(nVirtualBeta);
-  const Eigen::MatrixXd& SCBetaocc = overlapProductMatrix_.betaMatrix().leftCols(nOccupiedBeta);
-
-  for (int atom = 0; atom < aoIndex_.getNAtoms(); ++atom) {
-    int firstIndex = aoIndex_.getFirstOrbitalIndex(atom);
-    int nAOsOnAtom = aoIndex_.getNOrbitals(atom);
-    Eigen::MatrixXd transitionChargesAlpha =
-        0.5 *
-        (SCAlphavir.middleRows(firstIndex, nAOsOnAtom).transpose() * occupiedBlockAlpha.middleRows(firstIndex, nAOsOnAtom) +
-         virtualBlockAlpha.middleRows(firstIndex, nAOsOnAtom).transpose() * SCAlphaocc.middleRows(firstIndex, nAOsOnAtom));
-    Eigen::MatrixXd transitionChargesBeta =
-        0.5 *
-        (SCBetavir.middleRows(firstIndex, nAOsOnAtom).transpose() * occupiedBlockBeta.middleRows(firstIndex, nAOsOnAtom) +
-         virtualBlockBeta.middleRows(firstIndex, nAOsOnAtom).transpose() * SCBetaocc.middleRows(firstIndex, nAOsOnAtom));
-    transitionChargeMatrix.col(atom)
-        << Eigen::Map<Eigen::VectorXd>(transitionChargesAlpha.data(), transitionChargesAlpha.size()),
-        Eigen::Map<Eigen::VectorXd>(transitionChargesBeta.data(), transitionChargesBeta.size());
-  }
+  fillAtomicTransitionCharges(mos_.alphaMatrix(), overlapProductMatrix_.alphaMatrix(), nOccupiedAlpha,
+                              transitionChargeMatrix.topRows(nOccupiedAlpha * nVirtualAlpha));
+  fillAtomicTransitionCharges(mos_.betaMatrix(), overlapProductMatrix_.betaMatrix(), nOccupiedBeta,
+                              transitionChargeMatrix.bottomRows(nOccupiedBeta * nVirtualBeta));
   return transitionChargeMatrix;
 }
 
+template<>
+inline void TransitionChargesCalculator::streamAtomicTransitionChargeMatrices<Utils::Reference::Restricted>(
+    const Utils::LcaoUtils::ElectronicOccupation& occupation, const TileConsumer& consumer,
+    int nOccupiedPerTile) const {
+  if (!occupation.isFilledUpFromTheBottom()) {
+    throw InvalidOccupationException();
+  }
+  streamAtomicTransitionCharges(mos_.restrictedMatrix(), overlapProductMatrix_.restrictedMatrix(),
+                                occupation.numberOccupiedRestrictedOrbitals(), 0, consumer, nOccupiedPerTile);
+}
+
+template<>
+inline void TransitionChargesCalculator::streamAtomicTransitionChargeMatrices<Utils::Reference::Unrestricted>(
+    const Utils::LcaoUtils::ElectronicOccupation& occupation, const TileConsumer& consumer,
+    int nOccupiedPerTile) const {
+  if (!occupation.isFilledUpFromTheBottom()) {
+    throw InvalidOccupationException();
+  }
+  if (mos_.alphaMatrix().cols() == 0 || overlapProductMatrix_.alphaMatrix().cols() == 0) {
+    throw SpinPolarizedOrbitalsNotAvailableException();
+  }
+
+  // Alpha transitions come first, followed by the beta ones.
+  auto nOccupiedAlpha = occupation.numberAlphaElectrons();
+  auto nVirtualAlpha = mos_.alphaMatrix().cols() - nOccupiedAlpha;
+  streamAtomicTransitionCharges(mos_.alphaMatrix(), overlapProductMatrix_.alphaMatrix(), nOccupiedAlpha, 0, consumer,
+                                nOccupiedPerTile);
+  streamAtomicTransitionCharges(mos_.betaMatrix(), overlapProductMatrix_.betaMatrix(),
+                                occupation.numberBetaElectrons(), nOccupiedAlpha * nVirtualAlpha, consumer,
+                                nOccupiedPerTile);
+}
+
 } // namespace Sparrow
 } // namespace Scine
 
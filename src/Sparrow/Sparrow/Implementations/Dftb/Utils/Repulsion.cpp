@@ -7,9 +7,13 @@
 
 #include "Repulsion.h"
 #include "PairwiseRepulsion.h"
+#include "RepulsionParameters.h"
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/Geometry/ElementInfo.h>
 #include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
 #include <Utils/Typenames.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -32,8 +36,9 @@ void Repulsion::initialize() {
   pairRepulsions_ = Container(nAtoms_);
   for (int i = 0; i < nAtoms_; ++i)
     pairRepulsions_[i] = std::vector<PairRepulsion>(nAtoms_);
+  // The diagonal is needed for the repulsion with the periodic images of an atom
   for (int i = 0; i < nAtoms_; i++) {
-    for (int j = i + 1; j < nAtoms_; j++) {
+    for (int j = i; j < nAtoms_; j++) {
       initializePair(i, j);
     }
   }
@@ -49,6 +54,10 @@ void Repulsion::initializePair(int i, int j) {
 }
 
 void Repulsion::calculateRepulsion(Utils::DerivativeOrder order) {
+  if (isPeriodic()) {
+    calculatePeriodicRepulsion(order);
+    return;
+  }
   for (int i = 0; i < nAtoms_; i++) {
     for (int j = i + 1; j < nAtoms_; j++) {
       calculatePairRepulsion(i, j, order);
@@ -64,7 +73,62 @@ void Repulsion::calculatePairRepulsion(int i, int j, Utils::DerivativeOrder orde
   pairRepulsions_[i][j]->calculate(Rab, order);
 }
 
+void Repulsion::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
+bool Repulsion::isPeriodic() const {
+  return periodicCell_ && periodicCell_->isPeriodic();
+}
+
+void Repulsion::calculatePeriodicRepulsion(Utils::DerivativeOrder order) {
+  if (order == Utils::DerivativeOrder::Two) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
+  double cutoff = 0.0;
+  for (int a = 0; a < nAtoms_; ++a) {
+    for (int b = a; b < nAtoms_; ++b) {
+      const auto key = std::make_pair(Utils::ElementInfo::Z(elements_[a]), Utils::ElementInfo::Z(elements_[b]));
+      cutoff = std::max(cutoff, diatomicParameters_.at(key).getRepulsionParameters().cutoff);
+    }
+  }
+  const auto translations = periodicCell_->getTranslations(cutoff, positions_);
+
+  periodicEnergy_ = 0.0;
+  periodicGradients_ = Utils::GradientCollection::Zero(nAtoms_, 3);
+  strainDerivatives_.setZero();
+  for (int a = 0; a < nAtoms_; ++a) {
+    for (int b = a; b < nAtoms_; ++b) {
+      // The repulsion of an atom with its own images is shared with the images
+      const double factor = (a == b) ? 0.5 : 1.0;
+      Eigen::Vector3d Rab = positions_.row(b) - positions_.row(a);
+      for (const auto& T : translations) {
+        Eigen::Vector3d R = Rab + T;
+        const double distance = R.norm();
+        if (distance > cutoff || (a == b && distance < 1e-10)) {
+          continue;
+        }
+        pairRepulsions_[a][b]->calculate(R, order);
+        periodicEnergy_ += factor * pairRepulsions_[a][b]->getRepulsionEnergy();
+        if (order == Utils::DerivativeOrder::One) {
+          Eigen::RowVector3d gradient = factor * pairRepulsions_[a][b]->getDerivative<Utils::Derivative::First>();
+          periodicGradients_.row(b) += gradient;
+          periodicGradients_.row(a) -= gradient;
+          strainDerivatives_ += gradient.transpose() * R.transpose();
+        }
+      }
+    }
+  }
+}
+
+const Eigen::Matrix3d& Repulsion::getStrainDerivatives() const {
+  return strainDerivatives_;
+}
+
 double Repulsion::getRepulsionEnergy() const {
+  if (isPeriodic()) {
+    return periodicEnergy_;
+  }
   double repulsion = 0;
 
 #pragma omp parallel for reduction(+ : repulsion)
@@ -80,6 +144,10 @@ double Repulsion::getRepulsionEnergy() const {
 
 void Repulsion::addRepulsionDerivatives(
     Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
+  if (isPeriodic()) {
+    derivatives += periodicGradients_;
+    return;
+  }
   addRepulsionDerivativesImpl<Utils::Derivative::First>(derivatives);
 }
 
@@ -95,6 +163,9 @@ void Repulsion::addRepulsionDerivatives(
 
 template<Utils::Derivative O>
 void Repulsion::addRepulsionDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const {
+  if (isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
 #pragma omp parallel for
   for (int a = 0; a < nAtoms_; ++a) {
     for (int b = a + 1; b < nAtoms_; b++) {
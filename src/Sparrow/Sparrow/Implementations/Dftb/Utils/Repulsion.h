@@ -10,11 +10,13 @@
 
 #include "DFTBCommon.h"
 #include <Utils/Scf/MethodInterfaces/RepulsionCalculator.h>
+#include <Eigen/Core>
 #include <memory>
 #include <vector>
 
 namespace Scine {
 namespace Sparrow {
+class PeriodicCell;
 
 namespace dftb {
 class PairwiseRepulsion;
@@ -36,16 +38,31 @@ class Repulsion : public Utils::RepulsionCalculator {
       Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const override;
   void addRepulsionDerivatives(
       Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const override;
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * With periodic boundaries, the repulsion of every atom with all periodic images within the cutoff of the repulsion
+   * potential is included. Only first derivatives are available in this case.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  //! @brief Derivative of the periodic repulsion energy with respect to a homogeneous strain, from the last
+  //! calculation with first derivatives.
+  const Eigen::Matrix3d& getStrainDerivatives() const;
 
  private:
   template<Utils::Derivative O>
   void addRepulsionDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
   void calculatePairRepulsion(int i, int j, Utils::DerivativeOrder order);
   void initializePair(int i, int j);
+  bool isPeriodic() const;
+  void calculatePeriodicRepulsion(Utils::DerivativeOrder order);
 
   int nAtoms_;
   Container pairRepulsions_;
   const DFTBCommon::DiatomicParameterContainer& diatomicParameters_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
+  double periodicEnergy_ = 0.0;
+  Utils::GradientCollection periodicGradients_;
+  Eigen::Matrix3d strainDerivatives_ = Eigen::Matrix3d::Zero();
 };
 
 } // namespace dftb
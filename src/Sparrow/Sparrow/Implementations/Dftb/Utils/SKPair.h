@@ -55,6 +55,10 @@ class SKPair {
   int getNIntegrals() const {
     return nIntegrals;
   }
+  //! @brief Distance beyond which the Hamiltonian and overlap integrals vanish.
+  double getCutoff() const {
+    return rMax;
+  }
   const dftb::RepulsionParameters& getRepulsionParameters() const {
     return repulsion_;
   }
@@ -7,9 +7,14 @@
 
 #include "ScfFock.h"
 #include "ZeroOrderMatricesCalculator.h"
+#include <Sparrow/Implementations/PointChargeEmbedding.h>
+#include <Sparrow/Implementations/ScfAccelerator.h>
 #include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/Geometry/ElementInfo.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
 #include <Utils/Scf/MethodInterfaces/AdditiveElectronicContribution.h>
+#include <cmath>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -48,9 +53,14 @@ void ScfFock::initialize() {
 }
 
 void ScfFock::calculateDensityDependentPart(Utils::DerivativeOrder order) {
-  populationAnalysis();
+  const bool accelerated = scfAccelerator_ && scfAccelerator_->isActive();
+  // The charges are calculated from the smeared density while the accelerator applies Fermi smearing
+  const Utils::DensityMatrix& density =
+      accelerated ? scfAccelerator_->getSmearedDensity(densityMatrix_, unrestrictedCalculationRunning_)
+                  : densityMatrix_;
+  populationAnalysis(density);
   if (unrestrictedCalculationRunning_) {
-    spinDFTB.spinPopulationAnalysis(densityMatrix_.alphaMatrix(), densityMatrix_.betaMatrix(), overlapMatrix_);
+    spinDFTB.spinPopulationAnalysis(density.alphaMatrix(), density.betaMatrix(), overlapMatrix_);
     spinDFTB.calculateSpinContribution();
   }
   completeH();
@@ -60,12 +70,23 @@ void ScfFock::calculateDensityDependentPart(Utils::DerivativeOrder order) {
   for (auto& contribution : densityIndependentContributions_) {
     contribution->calculate(densityMatrix_, order);
   }
+  hasAcceleratedFock_ = false;
+  if (accelerated) {
+    acceleratedFock_ = scfAccelerator_->accelerate(calculateMatrix(), density, overlapMatrix_,
+                                                   calculateElectronicEnergy(), unrestrictedCalculationRunning_);
+    hasAcceleratedFock_ = true;
+  }
 }
 
 void ScfFock::calculateDensityIndependentPart(Utils::DerivativeOrder order) {
   zeroOrderMatricesCalculator_.calculateFockMatrix(order);
   H0_ = zeroOrderMatricesCalculator_.getZeroOrderHamiltonian().getMatrixXd();
   constructG(order);
+  calculatePointChargePotential();
+  hasAcceleratedFock_ = false;
+  if (scfAccelerator_) {
+    scfAccelerator_->reset();
+  }
   for (auto& contribution : densityDependentContributions_) {
     contribution->calculate(densityMatrix_, order);
   }
@@ -75,6 +96,13 @@ void ScfFock::calculateDensityIndependentPart(Utils::DerivativeOrder order) {
 }
 
 Utils::SpinAdaptedMatrix ScfFock::getMatrix() const {
+  if (hasAcceleratedFock_) {
+    return acceleratedFock_;
+  }
+  return calculateMatrix();
+}
+
+Utils::SpinAdaptedMatrix ScfFock::calculateMatrix() const {
   Eigen::MatrixXd sum = zeroOrderMatricesCalculator_.getZeroOrderHamiltonian().getMatrixXd() + correctionToFock;
   for (auto& contribution : densityDependentContributions_) {
     sum += contribution->getElectronicContribution().restrictedMatrix();
@@ -93,13 +121,14 @@ Utils::SpinAdaptedMatrix ScfFock::getMatrix() const {
 void ScfFock::finalize(Utils::DerivativeOrder /*order*/) {
   // Repeat the population analysis to make sure that the correct spin energy is employed
   // populationAnalysis(); (not needed anymore; is already done in ScfMethod::finalizeCalculation.
+  hasAcceleratedFock_ = false;
   if (unrestrictedCalculationRunning_) {
     spinDFTB.spinPopulationAnalysis(densityMatrix_.alphaMatrix(), densityMatrix_.betaMatrix(), overlapMatrix_);
   }
 }
 
-void ScfFock::populationAnalysis() {
-  Utils::LcaoUtils::calculateMullikenAtomicCharges(atomicCharges_, coreCharges_, densityMatrix_, overlapMatrix_, aoIndexes_);
+void ScfFock::populationAnalysis(const Utils::DensityMatrix& densityMatrix) {
+  Utils::LcaoUtils::calculateMullikenAtomicCharges(atomicCharges_, coreCharges_, densityMatrix, overlapMatrix_, aoIndexes_);
 }
 
 void ScfFock::addDensityDependentElectronicContribution(std::shared_ptr<Utils::AdditiveElectronicContribution> contribution) {
@@ -110,7 +139,89 @@ void ScfFock::addDensityIndependentElectronicContribution(std::shared_ptr<Utils:
   densityIndependentContributions_.emplace_back(std::move(contribution));
 }
 
+void ScfFock::setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding) {
+  pointCharges_ = std::move(embedding);
+}
+
+void ScfFock::setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator) {
+  scfAccelerator_ = std::move(accelerator);
+}
+
+double ScfFock::pointChargeTau(int a) const {
+  return 3.2 * atomicPar_[Utils::ElementInfo::Z(elements_[a])]->getHubbardParameter();
+}
+
+void ScfFock::calculatePointChargePotential() {
+  pointChargePotential_ = Eigen::VectorXd::Zero(getNumberAtoms());
+  if (!pointCharges_ || pointCharges_->empty()) {
+    return;
+  }
+  pointCharges_->updateNeighbors(positions_);
+  const auto& chargePositions = pointCharges_->getPositions();
+  const auto& charges = pointCharges_->getCharges();
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < getNumberAtoms(); ++a) {
+    const double tau = pointChargeTau(a);
+    double potential = 0.0;
+    for (int m : pointCharges_->getNeighbors(a)) {
+      const double R = (chargePositions.row(m) - positions_.row(a)).norm();
+      double dSwitching;
+      const double switching = pointCharges_->getSwitching(R, dSwitching);
+      potential += switching * charges[m] * (1.0 / R - std::exp(-tau * R) * (1.0 / R + 0.5 * tau));
+    }
+    pointChargePotential_[a] = potential;
+  }
+}
+
+double ScfFock::pointChargePotential(int a) const {
+  return pointChargePotential_.size() == 0 ? 0.0 : pointChargePotential_[a];
+}
+
+double ScfFock::pointChargeEnergy() const {
+  double energy = 0.0;
+  for (int a = 0; a < pointChargePotential_.size(); ++a) {
+    energy += atomicCharges_[a] * pointChargePotential_[a];
+  }
+  return energy;
+}
+
+void ScfFock::addPointChargeDerivatives(
+    Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
+  const auto& chargePositions = pointCharges_->getPositions();
+  const auto& charges = pointCharges_->getCharges();
+  Utils::GradientCollection pointChargeGradients = Utils::GradientCollection::Zero(pointCharges_->size(), 3);
+#pragma omp parallel
+  {
+    Utils::GradientCollection threadGradients = Utils::GradientCollection::Zero(pointCharges_->size(), 3);
+#pragma omp for schedule(dynamic)
+    for (int a = 0; a < getNumberAtoms(); ++a) {
+      const double tau = pointChargeTau(a);
+      Eigen::RowVector3d atomGradient = Eigen::RowVector3d::Zero();
+      for (int m : pointCharges_->getNeighbors(a)) {
+        Eigen::RowVector3d Ram = chargePositions.row(m) - positions_.row(a);
+        const double R = Ram.norm();
+        const double expTerm = std::exp(-tau * R);
+        const double gamma = 1.0 / R - expTerm * (1.0 / R + 0.5 * tau);
+        const double dGamma = -1.0 / (R * R) + tau * expTerm * (1.0 / R + 0.5 * tau) + expTerm / (R * R);
+        double dSwitching;
+        const double switching = pointCharges_->getSwitching(R, dSwitching);
+        // Derivative of the switched interaction with respect to the position of the point charge
+        Eigen::RowVector3d d = atomicCharges_[a] * charges[m] * (switching * dGamma + dSwitching * gamma) / R * Ram;
+        atomGradient -= d;
+        threadGradients.row(m) += d;
+      }
+      derivatives.row(a) += atomGradient;
+    }
+#pragma omp critical(addPointChargeDerivativesScfFock)
+    { pointChargeGradients += threadGradients; }
+  }
+  pointCharges_->setGradients(std::move(pointChargeGradients));
+}
+
 void ScfFock::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
+  if (pointCharges_ && !pointCharges_->empty()) {
+    addPointChargeDerivatives(derivatives);
+  }
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
       contribution->addDerivatives(derivatives);
@@ -122,6 +233,9 @@ void ScfFock::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContaine
 }
 
 void ScfFock::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const {
+  if (pointCharges_ && !pointCharges_->empty()) {
+    throw std::runtime_error("Only first derivatives are available with point charges.");
+  }
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
       contribution->addDerivatives(derivatives);
@@ -133,6 +247,9 @@ void ScfFock::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContaine
 }
 
 void ScfFock::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const {
+  if (pointCharges_ && !pointCharges_->empty()) {
+    throw std::runtime_error("Only first derivatives are available with point charges.");
+  }
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
       contribution->addDerivatives(derivatives);
@@ -13,6 +13,7 @@
 #include <Utils/Scf/MethodInterfaces/ElectronicContributionCalculator.h>
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
+#include <memory>
 #include <vector>
 
 namespace Scine {
@@ -23,6 +24,8 @@ class AdditiveElectronicContribution;
 } // namespace Utils
 
 namespace Sparrow {
+class PointChargeEmbedding;
+class ScfAccelerator;
 
 namespace dftb {
 class ZeroOrderMatricesCalculator;
@@ -55,10 +58,27 @@ class ScfFock : public Utils::ElectronicContributionCalculator {
    * that will be evaluated once per single-point calculation.
    */
   void addDensityIndependentElectronicContribution(std::shared_ptr<Utils::AdditiveElectronicContribution> contribution) final;
+  /**
+   * @brief Sets the point charges embedding the molecule, nullptr for none.
+   * The Mulliken charge of an atom a interacts with a point charge q at the distance R through the gamma function of
+   * a with a point-like charge distribution, q (1/R - exp(-tau R) (1/R + tau/2)) with tau = 3.2 U_a (limit of the
+   * DFTB2 gamma function for an infinite Hubbard parameter). Only first derivatives are available with point charges.
+   */
+  void setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding);
+  /**
+   * @brief Sets the SCF convergence accelerator, nullptr for none.
+   * If it is active, the atomic charges are calculated from its smeared density, and getMatrix() returns its
+   * extrapolated Fock matrix during the SCF cycle.
+   */
+  void setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator);
 
  protected:
   int getNumberAtoms() const;
-  void populationAnalysis();
+  void populationAnalysis(const Utils::DensityMatrix& densityMatrix);
+  //! @brief Electrostatic potential of the point charges at atom a, 0 without point charges.
+  double pointChargePotential(int a) const;
+  //! @brief Interaction energy of the atomic charges with the point charges.
+  double pointChargeEnergy() const;
   //! @brief adds the derivatives for the first, second atomic and second full types.
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const override;
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const override;
@@ -86,6 +106,22 @@ class ScfFock : public Utils::ElectronicContributionCalculator {
  private:
   virtual void completeH() = 0;
   virtual void constructG(Utils::DerivativeOrder order) = 0;
+  // Calculates the potential of the point charges at the atoms.
+  void calculatePointChargePotential();
+  // Adds the derivatives of the interaction with the point charges at constant atomic charges.
+  void addPointChargeDerivatives(
+      Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const;
+  // tau of the point charge gamma function for atom a.
+  double pointChargeTau(int a) const;
+  // Fock matrix of the current charges, without convergence acceleration.
+  Utils::SpinAdaptedMatrix calculateMatrix() const;
+
+  std::shared_ptr<PointChargeEmbedding> pointCharges_;
+  Eigen::VectorXd pointChargePotential_;
+  std::shared_ptr<ScfAccelerator> scfAccelerator_;
+  // Extrapolated Fock matrix of the current SCF iteration, if any
+  Utils::SpinAdaptedMatrix acceleratedFock_;
+  bool hasAcceleratedFock_ = false;
 };
 
 inline int ScfFock::getNumberAtoms() const {
@@ -8,10 +8,15 @@
 #include "SecondOrderFock.h"
 #include "Utils/Math/AutomaticDifferentiation/AutomaticDifferentiationHelpers.h"
 #include "ZeroOrderMatricesCalculator.h"
+#include <Sparrow/Implementations/EwaldSummation.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/DataStructures/DensityMatrix.h>
 #include <Utils/Geometry/ElementInfo.h>
 #include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -21,6 +26,19 @@ using namespace Utils::AutomaticDifferentiation;
 
 namespace dftb {
 
+namespace {
+template<Utils::DerivativeOrder O>
+Value3DType<O> valueWithGradient(double value, const Eigen::Vector3d& gradient);
+template<>
+double valueWithGradient<Utils::DerivativeOrder::Zero>(double value, const Eigen::Vector3d& /*gradient*/) {
+  return value;
+}
+template<>
+First3D valueWithGradient<Utils::DerivativeOrder::One>(double value, const Eigen::Vector3d& gradient) {
+  return First3D(value, gradient.x(), gradient.y(), gradient.z());
+}
+} // namespace
+
 SecondOrderFock::SecondOrderFock(ZeroOrderMatricesCalculator& matricesCalculator,
                                  const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
                                  const DFTBCommon::AtomicParameterContainer& atomicPar,
@@ -42,6 +60,15 @@ void SecondOrderFock::initialize() {
 }
 
 void SecondOrderFock::constructG(Utils::DerivativeOrder order) {
+  if (isPeriodic()) {
+    if (order == Utils::DerivativeOrder::Zero)
+      constructPeriodicG<Utils::DerivativeOrder::Zero>();
+    else if (order == Utils::DerivativeOrder::One)
+      constructPeriodicG<Utils::DerivativeOrder::One>();
+    else
+      throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+    return;
+  }
   if (order == Utils::DerivativeOrder::Zero)
     constructG<Utils::DerivativeOrder::Zero>();
   else if (order == Utils::DerivativeOrder::One)
@@ -71,21 +98,73 @@ void SecondOrderFock::constructG() {
   G = dG.getMatrixXd();
 }
 
+template<Utils::DerivativeOrder O>
+void SecondOrderFock::constructPeriodicG() {
+  // G_ab = sum_T gamma_ab(|R_b - R_a + T|), split into the Ewald sum of 1/R and the sum of gamma - 1/R in real space.
+  // For a = b, the term T = 0 is the Hubbard parameter.
+  EwaldSummation ewald;
+  ewald.setCell(*periodicCell_, positions_);
+  const double cutoff = getShortRangeCutoff();
+  const auto translations = periodicCell_->getTranslations(cutoff, positions_);
+  dG.setOrder(O);
+
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < getNumberAtoms(); ++a) {
+    for (int b = a; b < getNumberAtoms(); ++b) {
+      Eigen::Vector3d Rab = positions_.row(b) - positions_.row(a);
+      double value = ewald.getPotential(Rab);
+      Eigen::Vector3d gradient = Eigen::Vector3d::Zero();
+      if (a == b) {
+        value += atomicPar_[Utils::ElementInfo::Z(elements_[a])]->getHubbardParameter();
+      }
+      else if (O != Utils::DerivativeOrder::Zero) {
+        gradient = ewald.getPotentialGradient(Rab);
+      }
+      for (const auto& T : translations) {
+        Eigen::Vector3d R = Rab + T;
+        const double distance = R.norm();
+        if (distance < 1e-10 || distance > cutoff) {
+          continue;
+        }
+        auto shortRange = gammaAtDistance<Utils::DerivativeOrder::One>(a, b, distance) -
+                          1.0 / variableWithUnitDerivative<Utils::DerivativeOrder::One>(distance);
+        value += shortRange.value();
+        if (a != b) {
+          gradient += shortRange.derivative() / distance * R;
+        }
+      }
+      if (a == b) {
+        dG.get<O>()(a, a) = constant3D<O>(value);
+      }
+      else {
+        auto v = valueWithGradient<O>(value, gradient);
+        dG.get<O>()(a, b) = v;
+        dG.get<O>()(b, a) = getValueWithOppositeDerivative<O>(v);
+      }
+    }
+  }
+  G = dG.getMatrixXd();
+}
+
 template<Utils::DerivativeOrder O>
 Value1DType<O> SecondOrderFock::gamma(int a, int b) const {
+  if (a == b) {
+    return constant1D<O>(atomicPar_[Utils::ElementInfo::Z(elements_[a])]->getHubbardParameter());
+  }
+  return gammaAtDistance<O>(a, b, (positions_.row(b) - positions_.row(a)).norm());
+}
+
+template<Utils::DerivativeOrder O>
+Value1DType<O> SecondOrderFock::gammaAtDistance(int a, int b, double distance) const {
   // Calculation of gamma according to elstner1998,
   // formulae are better explained in supplementary info of gaus2011
-  auto R = variableWithUnitDerivative<O>((positions_.row(b) - positions_.row(a)).norm());
+  auto R = variableWithUnitDerivative<O>(distance);
   auto R2 = R * R;
   const unsigned Za = Utils::ElementInfo::Z(elements_[a]);
   const unsigned Zb = Utils::ElementInfo::Z(elements_[b]);
   double Ua = atomicPar_[Za]->getHubbardParameter();
   double Ub = atomicPar_[Zb]->getHubbardParameter();
 
-  if (a == b) {
-    return constant1D<O>(Ua);
-  }
-
   double ta = Ua * 3.2;
   double tb = Ub * 3.2;
 
@@ -112,6 +191,66 @@ Value1DType<O> SecondOrderFock::gamma(int a, int b) const {
   return gamma;
 }
 
+void SecondOrderFock::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
+bool SecondOrderFock::isPeriodic() const {
+  return periodicCell_ && periodicCell_->isPeriodic();
+}
+
+double SecondOrderFock::getShortRangeCutoff() const {
+  // gamma - 1/R decays as exp(-tau R) (tau R)^3, negligible for tau R > 40
+  double minimalTau = std::numeric_limits<double>::max();
+  for (auto element : elements_) {
+    minimalTau = std::min(minimalTau, 3.2 * atomicPar_[Utils::ElementInfo::Z(element)]->getHubbardParameter());
+  }
+  return 40.0 / minimalTau;
+}
+
+Eigen::Matrix3d SecondOrderFock::calculateStrainDerivatives() const {
+  Eigen::Matrix3d strainDerivatives = Eigen::Matrix3d::Zero();
+  if (!isPeriodic()) {
+    return strainDerivatives;
+  }
+  if (unrestrictedCalculationRunning_) {
+    throw std::runtime_error("The stress tensor is not available for unrestricted calculations.");
+  }
+  strainDerivatives += zeroOrderMatricesCalculator_.calculateStrainDerivatives(
+      energyWeightedDensityMatrix_ - HXoverS_.cwiseProduct(densityMatrix_.restrictedMatrix()));
+
+  EwaldSummation ewald;
+  ewald.setCell(*periodicCell_, positions_);
+  const double cutoff = getShortRangeCutoff();
+  const auto translations = periodicCell_->getTranslations(cutoff, positions_);
+#pragma omp parallel
+  {
+    Eigen::Matrix3d threadStrainDerivatives = Eigen::Matrix3d::Zero();
+#pragma omp for schedule(dynamic)
+    for (int a = 0; a < getNumberAtoms(); ++a) {
+      for (int b = a; b < getNumberAtoms(); ++b) {
+        const double chargeProduct = (a == b ? 0.5 : 1.0) * atomicCharges_[a] * atomicCharges_[b];
+        Eigen::Vector3d Rab = positions_.row(b) - positions_.row(a);
+        Eigen::Matrix3d gammaStrainDerivative = ewald.getPotentialStrainDerivative(Rab);
+        for (const auto& T : translations) {
+          Eigen::Vector3d R = Rab + T;
+          const double distance = R.norm();
+          if (distance < 1e-10 || distance > cutoff) {
+            continue;
+          }
+          auto shortRange = gammaAtDistance<Utils::DerivativeOrder::One>(a, b, distance) -
+                            1.0 / variableWithUnitDerivative<Utils::DerivativeOrder::One>(distance);
+          gammaStrainDerivative += shortRange.derivative() / distance * R * R.transpose();
+        }
+        threadStrainDerivatives += chargeProduct * gammaStrainDerivative;
+      }
+    }
+#pragma omp critical(calculateStrainDerivativesSecondOrder)
+    { strainDerivatives += threadStrainDerivatives; }
+  }
+  return strainDerivatives;
+}
+
 void SecondOrderFock::completeH() {
   correctionToFock.setZero();
 
@@ -125,7 +264,7 @@ void SecondOrderFock::completeH() {
       int nAOsB = aoIndexes_.getNOrbitals(b);
       int indexB = aoIndexes_.getFirstOrbitalIndex(b);
 
-      double sumOverAtoms = 0.0;
+      double sumOverAtoms = -(pointChargePotential(a) + pointChargePotential(b));
       for (int i = 0; i < getNumberAtoms(); i++) {
         sumOverAtoms -= (G(a, i) + G(b, i)) * atomicCharges_[i];
       }
@@ -152,6 +291,9 @@ void SecondOrderFock::addDerivatives(DerivativeContainerType<Utils::Derivative::
 }
 
 void SecondOrderFock::addDerivatives(DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const {
+  if (isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
   zeroOrderMatricesCalculator_.addDerivatives(derivatives, energyWeightedDensityMatrix_ -
                                                                HXoverS_.cwiseProduct(densityMatrix_.restrictedMatrix()));
   addSecondOrderDerivatives<Utils::Derivative::SecondAtomic>(derivatives);
@@ -159,6 +301,9 @@ void SecondOrderFock::addDerivatives(DerivativeContainerType<Utils::Derivative::
 }
 
 void SecondOrderFock::addDerivatives(DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const {
+  if (isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
   zeroOrderMatricesCalculator_.addDerivatives(derivatives, energyWeightedDensityMatrix_ -
                                                                HXoverS_.cwiseProduct(densityMatrix_.restrictedMatrix()));
   addSecondOrderDerivatives<Utils::Derivative::SecondFull>(derivatives);
@@ -184,6 +329,17 @@ void SecondOrderFock::addSecondOrderDerivatives(DerivativeContainerType<O>& deri
   }
 }
 
+void SecondOrderFock::addGammaDerivatives(DerivativeContainerType<Utils::Derivative::First>& derivatives,
+                                          const Eigen::MatrixXd& pairWeights) const {
+  constexpr auto O = Utils::Derivative::First;
+  for (int a = 0; a < getNumberAtoms(); ++a) {
+    for (int b = a + 1; b < getNumberAtoms(); b++) {
+      Value3DType<UnderlyingOrder<O>> der = pairWeights(a, b) * dG.get<UnderlyingOrder<O>>()(a, b);
+      addDerivativeToContainer<O>(derivatives, a, b, getDerivativeFromValueWithDerivatives<O>(der));
+    }
+  }
+}
+
 double SecondOrderFock::calculateElectronicEnergy() const {
   auto numberAtoms = static_cast<int>(elements_.size());
   double elEnergy = (H0_.cwiseProduct(densityMatrix_.restrictedMatrix())).sum();
@@ -195,6 +351,8 @@ double SecondOrderFock::calculateElectronicEnergy() const {
     }
   }
 
+  elEnergy += pointChargeEnergy();
+
   if (unrestrictedCalculationRunning_) {
     elEnergy += spinDFTB.spinEnergyContribution();
   }
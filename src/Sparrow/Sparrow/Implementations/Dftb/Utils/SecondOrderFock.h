@@ -13,9 +13,11 @@
 #include <Utils/DataStructures/MatrixWithDerivatives.h>
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
+#include <memory>
 
 namespace Scine {
 namespace Sparrow {
+class PeriodicCell;
 
 namespace dftb {
 
@@ -44,10 +46,31 @@ class SecondOrderFock : public ScfFock {
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const override;
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const override;
 
+  /**
+   * @brief Adds the derivatives of sum_{a<b} W(a, b) gamma(a, b) for a given symmetric atom pair weight matrix W,
+   *        e.g. from the charges of the response densities of an excited state.
+   */
+  void addGammaDerivatives(
+      Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
+      const Eigen::MatrixXd& pairWeights) const;
+
   /*! Return gamma and its derivative(s). */
   template<Utils::DerivativeOrder O>
   Utils::AutomaticDifferentiation::Value1DType<O> gamma(int a, int b) const;
 
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * With periodic boundaries, the elements of the gamma matrix are summed over all periodic images: the long-range
+   * 1/R part with an Ewald summation and the short-range remainder, which decays exponentially, in real space. Only
+   * first derivatives are available in this case.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  /**
+   * @brief Derivative of the electronic energy with respect to a homogeneous strain of the cell and of the positions,
+   *        at the current density matrix. Zero without periodic boundaries.
+   */
+  Eigen::Matrix3d calculateStrainDerivatives() const;
+
  protected:
  private:
   /// completes the H matrix by adding the first order correction to H0.
@@ -55,11 +78,20 @@ class SecondOrderFock : public ScfFock {
   void constructG(Utils::DerivativeOrder order) override;
   template<Utils::DerivativeOrder O>
   void constructG();
+  template<Utils::DerivativeOrder O>
+  void constructPeriodicG();
+  // gamma of two different atoms or of an atom with one of its images at the given distance.
+  template<Utils::DerivativeOrder O>
+  Utils::AutomaticDifferentiation::Value1DType<O> gammaAtDistance(int a, int b, double distance) const;
+  // Distance beyond which gamma - 1/R is negligible for all atom pairs.
+  double getShortRangeCutoff() const;
+  bool isPeriodic() const;
   template<Utils::Derivative O>
   void addSecondOrderDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
 
   Eigen::MatrixXd G;               // Gamma matrix
   Utils::MatrixWithDerivatives dG; // Derivative of G matrix elements
+  std::shared_ptr<PeriodicCell> periodicCell_;
 };
 
 } // namespace dftb
@@ -172,7 +172,7 @@ void ThirdOrderFock::completeH() {
       const int nAOsB = aoIndexes_.getNOrbitals(b);
       const int indexB = aoIndexes_.getFirstOrbitalIndex(b);
 
-      double H1sumOverAtoms = 0.0;
+      double H1sumOverAtoms = -(pointChargePotential(a) + pointChargePotential(b));
       double H2sumOverAtoms = 0.0;
       for (int i = 0; i < getNumberAtoms(); i++) {
         H1sumOverAtoms -= (g(a, i) + g(b, i)) * atomicCharges_[i];
@@ -250,6 +250,7 @@ double ThirdOrderFock::calculateElectronicEnergy() const {
     }
   }
   elEnergy += (H0_.cwiseProduct(densityMatrix_.restrictedMatrix())).sum();
+  elEnergy += pointChargeEnergy();
 
   if (unrestrictedCalculationRunning_) {
     elEnergy += spinDFTB.spinEnergyContribution();
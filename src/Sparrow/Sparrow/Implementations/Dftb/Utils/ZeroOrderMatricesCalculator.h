@@ -12,6 +12,7 @@
 #include <Utils/DataStructures/MatrixWithDerivatives.h>
 #include <Utils/Math/AutomaticDifferentiation/MethodsTypesHelper.h>
 #include <Eigen/Core>
+#include <memory>
 
 namespace Scine {
 
@@ -22,6 +23,7 @@ class AtomsOrbitalsIndexes;
 } // namespace Utils
 
 namespace Sparrow {
+class PeriodicCell;
 
 namespace dftb {
 
@@ -54,6 +56,12 @@ class ZeroOrderMatricesCalculator {
   // For DFTB0, overlapDerivativeMultiplier is the energy-weighted density matrix.
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
                       const Eigen::MatrixXd& overlapDerivativeMultiplier) const;
+  /**
+   * @brief Adds the derivatives of tr(H0 D) - tr(W S) for a given symmetric density matrix D and a given symmetric
+   *        overlap derivative multiplier W, e.g. the relaxed difference density of an excited state.
+   */
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
+                      const Eigen::MatrixXd& densityMatrix, const Eigen::MatrixXd& overlapDerivativeMultiplier) const;
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives,
                       const Eigen::MatrixXd& overlapDerivativeMultiplier) const;
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives,
@@ -65,13 +73,40 @@ class ZeroOrderMatricesCalculator {
   const Utils::MatrixWithDerivatives& getZeroOrderHamiltonian() const;
   void resetOverlap();
 
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * With periodic boundaries, the Hamiltonian and overlap matrices are those of the Gamma point: the blocks of two
+   * atoms are summed over all images of the second atom within the range of the Slater-Koster tables, and the blocks
+   * of an atom with its own images are added to its on-site block.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  /**
+   * @brief Derivative of the energy contribution of H0 and S with respect to a homogeneous strain of the cell and of
+   *        the positions, zero without periodic boundaries.
+   * @param overlapDerivativeMultiplier The same matrix as in addDerivatives().
+   */
+  Eigen::Matrix3d calculateStrainDerivatives(const Eigen::MatrixXd& overlapDerivativeMultiplier) const;
+
  private:
   template<Utils::DerivativeOrder O>
   void constructH0S();
   template<Utils::DerivativeOrder O>
   void constructPartOfH0S();
+  template<Utils::DerivativeOrder O>
+  void constructPeriodicPartOfH0S();
+  /*
+   * Calculates the overlap (me[0]) and Hamiltonian (me[1]) blocks of atoms a and b at the distance vector R from a
+   * to b, with the element of lower atomic number first. Returns false if all elements vanish.
+   */
+  template<Utils::DerivativeOrder O>
+  bool calculatePairBlocks(int a, int b, Eigen::Vector3d R,
+                           Utils::AutomaticDifferentiation::Value3DType<O> (&me)[2][9][9]) const;
+  bool isPeriodic() const;
+  // Largest range of the Slater-Koster tables of the atom pairs in the structure
+  double getMaximalCutoff() const;
   template<Utils::Derivative O>
   void addDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives,
+                          const Eigen::MatrixXd& densityMatrix,
                           const Eigen::MatrixXd& overlapDerivativeMultiplier) const;
 
   Utils::MatrixWithDerivatives zeroOrderHamiltonian_;
@@ -82,6 +117,9 @@ class ZeroOrderMatricesCalculator {
   const DFTBCommon::AtomicParameterContainer& atomicPar_;
   const DFTBCommon::DiatomicParameterContainer& diatomicPar_;
   const Utils::DensityMatrix& densityMatrix_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
+  // Whether the one-center blocks include the blocks of the atoms with their images
+  bool hasPeriodicOnSiteBlocks_ = false;
 };
 
 } // namespace dftb
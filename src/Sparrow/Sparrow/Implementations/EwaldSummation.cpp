@@ -0,0 +1,117 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "EwaldSummation.h"
+#include "PeriodicCell.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+const double twoOverSqrtPi = 2.0 / std::sqrt(M_PI);
+// Vectors shorter than this are the self-interaction of a charge
+const double zeroDistance = 1e-10;
+} // namespace
+
+void EwaldSummation::setCell(const PeriodicCell& cell, const Utils::PositionCollection& positions, double accuracy) {
+  if (!cell.isPeriodic()) {
+    throw std::runtime_error("The Ewald summation requires a periodic cell.");
+  }
+  volume_ = cell.getVolume();
+  eta_ = std::sqrt(M_PI) / std::cbrt(volume_);
+  const double s = std::sqrt(-std::log(accuracy));
+  realSpaceCutoff_ = s / eta_;
+  const double reciprocalCutoff = 2 * eta_ * s;
+
+  translations_ = cell.getTranslations(realSpaceCutoff_, positions);
+
+  const Eigen::Matrix3d reciprocal = cell.getReciprocalLattice();
+  int n[3];
+  for (int i = 0; i < 3; ++i) {
+    n[i] = static_cast<int>(std::ceil(reciprocalCutoff * cell.getLattice().row(i).norm() / (2 * M_PI)));
+  }
+  reciprocalVectors_.clear();
+  reciprocalFactors_.clear();
+  for (int h = 0; h <= n[0]; ++h) {
+    for (int k = (h == 0 ? 0 : -n[1]); k <= n[1]; ++k) {
+      for (int l = (h == 0 && k == 0 ? 1 : -n[2]); l <= n[2]; ++l) {
+        Eigen::Vector3d G = h * reciprocal.row(0) + k * reciprocal.row(1) + l * reciprocal.row(2);
+        const double G2 = G.squaredNorm();
+        if (G2 > reciprocalCutoff * reciprocalCutoff) {
+          continue;
+        }
+        reciprocalVectors_.push_back(G);
+        reciprocalFactors_.push_back(std::exp(-G2 / (4 * eta_ * eta_)) / G2);
+      }
+    }
+  }
+}
+
+double EwaldSummation::getPotential(const Eigen::Vector3d& r) const {
+  double potential = 0.0;
+  for (const auto& T : translations_) {
+    const double d = (r + T).norm();
+    if (d > zeroDistance && d <= realSpaceCutoff_) {
+      potential += std::erfc(eta_ * d) / d;
+    }
+  }
+  // The terms of G and -G are equal
+  const double prefactor = 8 * M_PI / volume_;
+  for (unsigned i = 0; i < reciprocalVectors_.size(); ++i) {
+    potential += prefactor * reciprocalFactors_[i] * std::cos(reciprocalVectors_[i].dot(r));
+  }
+  potential -= M_PI / (eta_ * eta_ * volume_);
+  if (r.norm() <= zeroDistance) {
+    potential -= twoOverSqrtPi * eta_;
+  }
+  return potential;
+}
+
+Eigen::Vector3d EwaldSummation::getPotentialGradient(const Eigen::Vector3d& r) const {
+  Eigen::Vector3d gradient = Eigen::Vector3d::Zero();
+  for (const auto& T : translations_) {
+    const Eigen::Vector3d distance = r + T;
+    const double d = distance.norm();
+    if (d > zeroDistance && d <= realSpaceCutoff_) {
+      const double derivative = -(std::erfc(eta_ * d) / d + twoOverSqrtPi * eta_ * std::exp(-eta_ * eta_ * d * d)) / d;
+      gradient += derivative / d * distance;
+    }
+  }
+  const double prefactor = 8 * M_PI / volume_;
+  for (unsigned i = 0; i < reciprocalVectors_.size(); ++i) {
+    const auto& G = reciprocalVectors_[i];
+    gradient -= prefactor * reciprocalFactors_[i] * std::sin(G.dot(r)) * G;
+  }
+  return gradient;
+}
+
+Eigen::Matrix3d EwaldSummation::getPotentialStrainDerivative(const Eigen::Vector3d& r) const {
+  Eigen::Matrix3d strainDerivative = Eigen::Matrix3d::Zero();
+  for (const auto& T : translations_) {
+    const Eigen::Vector3d distance = r + T;
+    const double d = distance.norm();
+    if (d > zeroDistance && d <= realSpaceCutoff_) {
+      const double derivative = -(std::erfc(eta_ * d) / d + twoOverSqrtPi * eta_ * std::exp(-eta_ * eta_ * d * d)) / d;
+      strainDerivative += derivative / d * distance * distance.transpose();
+    }
+  }
+  // Under strain, G.r is invariant, G -> (1 - eps^T) G and V -> (1 + tr(eps)) V
+  const double prefactor = 8 * M_PI / volume_;
+  for (unsigned i = 0; i < reciprocalVectors_.size(); ++i) {
+    const auto& G = reciprocalVectors_[i];
+    const double term = prefactor * reciprocalFactors_[i] * std::cos(G.dot(r));
+    const double dFactorDG2 = 1.0 / (4 * eta_ * eta_) + 1.0 / G.squaredNorm();
+    strainDerivative += term * (2 * dFactorDG2 * G * G.transpose() - Eigen::Matrix3d::Identity());
+  }
+  strainDerivative += M_PI / (eta_ * eta_ * volume_) * Eigen::Matrix3d::Identity();
+  return strainDerivative;
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_EWALDSUMMATION_H
+#define SPARROW_EWALDSUMMATION_H
+
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+class PeriodicCell;
+
+/**
+ * @brief Ewald summation of the Coulomb potential 1/r over all periodic images of a unit cell.
+ *
+ * The lattice sum of 1/|r + T| is split into a real-space sum of erfc(eta |r + T|) / |r + T| and a reciprocal-space
+ * sum over the lattice vectors G of the reciprocal cell. The divergent G = 0 term is dropped, which corresponds to a
+ * uniform compensating background charge for charged cells. The splitting parameter eta balances the numbers of
+ * terms in both sums, such that the cost of the potential between two atoms does not depend on the cell size.
+ */
+class EwaldSummation {
+ public:
+  /**
+   * @brief Sets the cell and prepares the real-space translations and the reciprocal lattice vectors.
+   * @param positions The atoms whose distance vectors will be passed to the potential functions.
+   * @param accuracy  Neglected terms in the real and reciprocal sums are smaller than this value.
+   */
+  void setCell(const PeriodicCell& cell, const Utils::PositionCollection& positions, double accuracy = 1e-10);
+  /**
+   * @brief Lattice sum of the Coulomb potential at the distance vector r = R_b - R_a of two atoms.
+   * For r = 0, the potential of the periodic images of a unit charge at its own position, without the charge itself.
+   */
+  double getPotential(const Eigen::Vector3d& r) const;
+  //! @brief Derivative of getPotential() with respect to r.
+  Eigen::Vector3d getPotentialGradient(const Eigen::Vector3d& r) const;
+  /**
+   * @brief Derivative of getPotential() with respect to a homogeneous strain eps of the cell and of r,
+   *        r -> (1 + eps) r, the contribution of the potential to the stress tensor.
+   */
+  Eigen::Matrix3d getPotentialStrainDerivative(const Eigen::Vector3d& r) const;
+
+ private:
+  double eta_ = 0.0;
+  double volume_ = 0.0;
+  double realSpaceCutoff_ = 0.0;
+  std::vector<Eigen::Vector3d> translations_;
+  // Reciprocal lattice vectors of one half space, with the factor exp(-G^2 / (4 eta^2)) / G^2 of their terms
+  std::vector<Eigen::Vector3d> reciprocalVectors_;
+  std::vector<double> reciprocalFactors_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_EWALDSUMMATION_H
@@ -0,0 +1,584 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "FragmentDensityGuess.h"
+#include <Core/Log.h>
+#include <Utils/Constants.h>
+#include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
+#include <Eigen/SVD>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+// Tolerance added to the sum of the covalent radii for the bond detection, 0.4 angstrom
+constexpr double bondTolerance = 0.4 * Utils::Constants::bohr_per_angstrom;
+// Maximal root-mean-square deviation (in bohr) of aligned geometries for the reuse of a cached fragment density
+constexpr double maxAlignedRmsd = 0.3;
+
+bool isHeavyAtom(Utils::ElementType e) {
+  return Utils::ElementInfo::Z(e) > 1;
+}
+
+// Cells are identified by their three indices packed in 21 bits each.
+std::int64_t cellKey(std::int64_t ix, std::int64_t iy, std::int64_t iz) {
+  const std::int64_t offset = std::int64_t{1} << 20;
+  return ((ix + offset) << 42) | ((iy + offset) << 21) | (iz + offset);
+}
+} // namespace
+
+struct FragmentDensityGuess::FragmentStructure {
+  // Indices of the real atoms in the full structure
+  std::vector<int> atoms;
+  // Elements and positions of the real atoms followed by the link atoms
+  Utils::ElementTypeCollection elements;
+  Utils::PositionCollection positions;
+  std::vector<std::pair<int, int>> bonds;
+  std::vector<int> nAOsPerAtom;
+  int nAOs = 0;
+  // Number of atomic orbitals of the real atoms, they come first
+  int nRealAOs = 0;
+  int nNeutralElectrons = 0;
+};
+
+FragmentDensityGuess::FragmentDensityGuess(const Utils::ElementTypeCollection& elements,
+                                           const Utils::PositionCollection& positions,
+                                           const Utils::AtomsOrbitalsIndexes& aoIndexes,
+                                           const std::vector<double>& coreCharges, const int& nElectrons,
+                                           std::unique_ptr<Utils::DensityMatrixGuessCalculator> standardGuess,
+                                           FragmentCalculator fragmentCalculator)
+  : elements_(elements),
+    positions_(positions),
+    aoIndexes_(aoIndexes),
+    coreCharges_(coreCharges),
+    nElectrons_(nElectrons),
+    standardGuess_(std::move(standardGuess)),
+    fragmentCalculator_(std::move(fragmentCalculator)) {
+}
+
+FragmentDensityGuess::~FragmentDensityGuess() = default;
+
+Utils::DensityMatrix FragmentDensityGuess::calculateGuess() const {
+  // The standard guess provides the blocks of the fragments that cannot be converged
+  auto standardGuess = standardGuess_->calculateGuess();
+  const Eigen::MatrixXd& standardDensity = standardGuess.restrictedMatrix();
+  const int nAOs = aoIndexes_.getNAtomicOrbitals();
+
+  auto neighbors = detectNeighbors();
+  auto fragments = detectFragments(neighbors);
+  const int nFragments = static_cast<int>(fragments.size());
+  std::vector<FragmentStructure> structures;
+  structures.reserve(nFragments);
+  for (const auto& fragment : fragments) {
+    structures.push_back(createFragmentStructure(fragment, neighbors));
+  }
+  auto charges = assignCharges(structures);
+
+  std::vector<std::string> keys(nFragments);
+  std::vector<Eigen::MatrixXd> densities(nFragments);
+  std::vector<double> populations(nFragments, 0.0);
+  std::vector<char> found(nFragments, 0);
+  std::vector<char> closedShell(nFragments, 0);
+  std::map<std::string, int> representatives;
+  std::vector<int> toCalculate;
+  for (int i = 0; i < nFragments; ++i) {
+    closedShell[i] = (structures[i].nNeutralElectrons - charges[i]) % 2 == 0;
+    if (!closedShell[i]) {
+      continue;
+    }
+    keys[i] = createKey(structures[i], charges[i]);
+    found[i] = lookUp(keys[i], structures[i], densities[i], populations[i]);
+    // Fragments with the same topology are only calculated once
+    if (!found[i] && representatives.emplace(keys[i], i).second) {
+      toCalculate.push_back(i);
+    }
+  }
+
+  const int nCalculations = static_cast<int>(toCalculate.size());
+  std::vector<char> success(nCalculations, 0);
+#pragma omp parallel for schedule(dynamic)
+  for (int k = 0; k < nCalculations; ++k) {
+    const auto& structure = structures[toCalculate[k]];
+    Utils::AtomCollection fragment(structure.elements, structure.positions);
+    auto& density = densities[toCalculate[k]];
+    Eigen::VectorXd aoPopulations;
+    success[k] = fragmentCalculator_(fragment, charges[toCalculate[k]], density, aoPopulations) &&
+                 density.rows() == structure.nAOs && aoPopulations.size() == structure.nAOs;
+    if (success[k]) {
+      populations[toCalculate[k]] = aoPopulations.head(structure.nRealAOs).sum();
+    }
+  }
+  nFragmentCalculations_ = nCalculations;
+
+  std::set<std::string> failedKeys;
+  for (int k = 0; k < nCalculations; ++k) {
+    int i = toCalculate[k];
+    found[i] = success[k];
+    if (success[k]) {
+      insert(keys[i], structures[i], densities[i], populations[i]);
+    }
+    else {
+      failedKeys.insert(keys[i]);
+    }
+  }
+  // Fragments of the same topology as a calculated one, whose geometry is too different to reuse its density
+  for (int i = 0; i < nFragments; ++i) {
+    if (found[i] || !closedShell[i] || failedKeys.count(keys[i]) > 0) {
+      continue;
+    }
+    found[i] = lookUp(keys[i], structures[i], densities[i], populations[i]);
+    if (!found[i]) {
+      Utils::AtomCollection fragment(structures[i].elements, structures[i].positions);
+      Eigen::VectorXd aoPopulations;
+      found[i] = fragmentCalculator_(fragment, charges[i], densities[i], aoPopulations) &&
+                 densities[i].rows() == structures[i].nAOs && aoPopulations.size() == structures[i].nAOs;
+      ++nFragmentCalculations_;
+      if (found[i]) {
+        populations[i] = aoPopulations.head(structures[i].nRealAOs).sum();
+        insert(keys[i], structures[i], densities[i], populations[i]);
+      }
+    }
+  }
+
+  // Block-diagonal assembly, the link atoms come last in the fragment and are left out
+  Eigen::MatrixXd P = Eigen::MatrixXd::Zero(nAOs, nAOs);
+  // tr(PS) of the assembled density, there is no overlap between the blocks of different fragments
+  double population = 0.0;
+  for (int i = 0; i < nFragments; ++i) {
+    const auto& atoms = structures[i].atoms;
+    int localA = 0;
+    for (int a : atoms) {
+      int startA = aoIndexes_.getFirstOrbitalIndex(a);
+      int nAOsA = aoIndexes_.getNOrbitals(a);
+      int localB = 0;
+      for (int b : atoms) {
+        int startB = aoIndexes_.getFirstOrbitalIndex(b);
+        int nAOsB = aoIndexes_.getNOrbitals(b);
+        if (found[i]) {
+          P.block(startA, startB, nAOsA, nAOsB) = densities[i].block(localA, localB, nAOsA, nAOsB);
+        }
+        else {
+          P.block(startA, startB, nAOsA, nAOsB) = standardDensity.block(startA, startB, nAOsA, nAOsB);
+        }
+        localB += nAOsB;
+      }
+      localA += nAOsA;
+      // The standard guesses only have off-diagonal elements for an orthogonal basis
+      if (!found[i]) {
+        population += standardDensity.block(startA, startA, nAOsA, nAOsA).trace();
+      }
+    }
+    if (found[i]) {
+      population += populations[i];
+    }
+  }
+  if (population > 0.0) {
+    P *= nElectrons_ / population;
+  }
+
+  Utils::DensityMatrix d;
+  d.setDensity(std::move(P), nElectrons_);
+  return d;
+}
+
+bool FragmentDensityGuess::convergeFragment(Utils::ScfMethod& method, const Utils::AtomCollection& fragment, int charge,
+                                            bool orthogonalBasis, Eigen::MatrixXd& density,
+                                            Eigen::VectorXd& populations) {
+  try {
+    Core::Log log = Core::Log::silent();
+    method.setMolecularCharge(charge);
+    method.setAtomCollection(fragment);
+    method.initialize();
+    method.setConvergenceCriteria({1e-5, 1e-5});
+    method.setMaxIterations(100);
+    method.convergedCalculation(log, Utils::Derivative::None);
+    if (!method.hasConverged()) {
+      return false;
+    }
+    density = method.getDensityMatrix().restrictedMatrix();
+    if (orthogonalBasis) {
+      populations = density.diagonal();
+    }
+    else {
+      Eigen::MatrixXd overlap = method.getOverlapMatrix().selfadjointView<Eigen::Lower>();
+      populations = density.cwiseProduct(overlap).rowwise().sum();
+    }
+    return true;
+  }
+  catch (...) {
+    return false;
+  }
+}
+
+std::unique_ptr<Utils::DensityMatrixGuessCalculator>
+FragmentDensityGuess::switchGuess(Utils::DensityMatrixGuessCalculator* currentGuess, bool enabled, int maxFragmentSize,
+                                  const Utils::ElementTypeCollection& elements,
+                                  const Utils::PositionCollection& positions,
+                                  const Utils::AtomsOrbitalsIndexes& aoIndexes,
+                                  const std::vector<double>& coreCharges, const int& nElectrons,
+                                  const GuessFactory& standardGuess, MethodFactory methodFactory, bool orthogonalBasis) {
+  auto* fragmentGuess = dynamic_cast<FragmentDensityGuess*>(currentGuess);
+  if (fragmentGuess && enabled) {
+    fragmentGuess->setMaxFragmentSize(maxFragmentSize);
+    return nullptr;
+  }
+  if (!fragmentGuess && !enabled) {
+    return nullptr;
+  }
+  if (!enabled) {
+    return standardGuess();
+  }
+  auto guess = std::make_unique<FragmentDensityGuess>(
+      elements, positions, aoIndexes, coreCharges, nElectrons, standardGuess(),
+      [methodFactory = std::move(methodFactory), orthogonalBasis](const Utils::AtomCollection& fragment, int charge,
+                                                                  Eigen::MatrixXd& density,
+                                                                  Eigen::VectorXd& populations) {
+        std::unique_ptr<Utils::ScfMethod> method;
+        try {
+          method = methodFactory();
+        }
+        catch (...) {
+          return false;
+        }
+        return convergeFragment(*method, fragment, charge, orthogonalBasis, density, populations);
+      });
+  guess->setMaxFragmentSize(maxFragmentSize);
+  return std::move(guess);
+}
+
+std::vector<std::vector<int>> FragmentDensityGuess::detectNeighbors() const {
+  const int nAtoms = static_cast<int>(elements_.size());
+  std::vector<std::vector<int>> neighbors(nAtoms);
+  if (nAtoms == 0) {
+    return neighbors;
+  }
+  std::vector<double> radii(nAtoms);
+  for (int i = 0; i < nAtoms; ++i) {
+    radii[i] = Utils::ElementInfo::covalentRadius(elements_[i]);
+  }
+
+  // Cell list with the longest possible bond as edge length, bonded atoms are in neighboring cells
+  const double cellSize = 2.0 * *std::max_element(radii.begin(), radii.end()) + bondTolerance;
+  const Eigen::RowVector3d origin = positions_.colwise().minCoeff();
+  auto cellIndices = [&](const Eigen::RowVector3d& r) {
+    Eigen::RowVector3d scaled = (r - origin) / cellSize;
+    return Eigen::Matrix<std::int64_t, 1, 3>(static_cast<std::int64_t>(std::floor(scaled.x())),
+                                             static_cast<std::int64_t>(std::floor(scaled.y())),
+                                             static_cast<std::int64_t>(std::floor(scaled.z())));
+  };
+  std::unordered_map<std::int64_t, std::vector<int>> cells;
+  for (int i = 0; i < nAtoms; ++i) {
+    auto c = cellIndices(positions_.row(i));
+    cells[cellKey(c.x(), c.y(), c.z())].push_back(i);
+  }
+
+  for (int i = 0; i < nAtoms; ++i) {
+    auto c = cellIndices(positions_.row(i));
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+          auto cell = cells.find(cellKey(c.x() + dx, c.y() + dy, c.z() + dz));
+          if (cell == cells.end()) {
+            continue;
+          }
+          for (int j : cell->second) {
+            double maxDistance = radii[i] + radii[j] + bondTolerance;
+            if (j > i && (positions_.row(i) - positions_.row(j)).squaredNorm() < maxDistance * maxDistance) {
+              neighbors[i].push_back(j);
+              neighbors[j].push_back(i);
+            }
+          }
+        }
+      }
+    }
+  }
+  // The fragment keys depend on the order of the bonds
+  for (auto& atomNeighbors : neighbors) {
+    std::sort(atomNeighbors.begin(), atomNeighbors.end());
+  }
+  return neighbors;
+}
+
+std::vector<FragmentDensityGuess::Fragment> FragmentDensityGuess::detectFragments() const {
+  return detectFragments(detectNeighbors());
+}
+
+std::vector<FragmentDensityGuess::Fragment>
+FragmentDensityGuess::detectFragments(const std::vector<std::vector<int>>& neighbors) const {
+  const int nAtoms = static_cast<int>(elements_.size());
+  // Connected components, numbered by their lowest atom index
+  std::vector<int> component(nAtoms, -1);
+  std::vector<std::vector<int>> components;
+  for (int seed = 0; seed < nAtoms; ++seed) {
+    if (component[seed] != -1) {
+      continue;
+    }
+    std::vector<int> atoms;
+    std::queue<int> queue;
+    queue.push(seed);
+    component[seed] = static_cast<int>(components.size());
+    while (!queue.empty()) {
+      int atom = queue.front();
+      queue.pop();
+      atoms.push_back(atom);
+      for (int neighbor : neighbors[atom]) {
+        if (component[neighbor] == -1) {
+          component[neighbor] = component[seed];
+          queue.push(neighbor);
+        }
+      }
+    }
+    std::sort(atoms.begin(), atoms.end());
+    components.push_back(std::move(atoms));
+  }
+
+  std::vector<Fragment> fragments;
+  for (auto& atoms : components) {
+    int nHeavyAtoms = std::count_if(atoms.begin(), atoms.end(), [&](int atom) { return isHeavyAtom(elements_[atom]); });
+    if (nHeavyAtoms <= maxFragmentSize_) {
+      fragments.push_back({std::move(atoms), {}});
+    }
+    else {
+      auto pieces = splitFragment(atoms, neighbors);
+      fragments.insert(fragments.end(), pieces.begin(), pieces.end());
+    }
+  }
+  return fragments;
+}
+
+std::vector<FragmentDensityGuess::Fragment>
+FragmentDensityGuess::splitFragment(const std::vector<int>& atoms, const std::vector<std::vector<int>>& neighbors) const {
+  std::map<int, int> piece;
+  int nPieces = 0;
+  // Grow pieces of at most maxFragmentSize_ heavy atoms along the bonds between heavy atoms
+  for (int seed : atoms) {
+    if (!isHeavyAtom(elements_[seed]) || piece.count(seed) > 0) {
+      continue;
+    }
+    int nHeavyAtoms = 0;
+    std::queue<int> queue;
+    queue.push(seed);
+    while (!queue.empty() && nHeavyAtoms < maxFragmentSize_) {
+      int atom = queue.front();
+      queue.pop();
+      if (piece.count(atom) > 0) {
+        continue;
+      }
+      piece[atom] = nPieces;
+      ++nHeavyAtoms;
+      for (int neighbor : neighbors[atom]) {
+        if (isHeavyAtom(elements_[neighbor]) && piece.count(neighbor) == 0) {
+          queue.push(neighbor);
+        }
+      }
+    }
+    ++nPieces;
+  }
+  // Hydrogen atoms go with the first heavy atom they are bonded to
+  for (int atom : atoms) {
+    if (isHeavyAtom(elements_[atom])) {
+      continue;
+    }
+    auto owner = std::find_if(neighbors[atom].begin(), neighbors[atom].end(),
+                              [&](int neighbor) { return piece.count(neighbor) > 0; });
+    piece[atom] = owner != neighbors[atom].end() ? piece[*owner] : nPieces++;
+  }
+
+  std::vector<Fragment> fragments(nPieces);
+  for (int atom : atoms) {
+    auto& fragment = fragments[piece[atom]];
+    fragment.atoms.push_back(atom);
+    if (!isHeavyAtom(elements_[atom])) {
+      continue;
+    }
+    for (int neighbor : neighbors[atom]) {
+      if (isHeavyAtom(elements_[neighbor]) && piece[neighbor] != piece[atom]) {
+        fragment.cutBonds.emplace_back(atom, neighbor);
+      }
+    }
+  }
+  return fragments;
+}
+
+FragmentDensityGuess::FragmentStructure
+FragmentDensityGuess::createFragmentStructure(const Fragment& fragment, const std::vector<std::vector<int>>& neighbors) const {
+  FragmentStructure structure;
+  structure.atoms = fragment.atoms;
+  const int nRealAtoms = static_cast<int>(fragment.atoms.size());
+  const int nAtoms = nRealAtoms + static_cast<int>(fragment.cutBonds.size());
+  structure.positions.resize(nAtoms, 3);
+
+  std::map<int, int> localIndex;
+  double neutralElectrons = 0;
+  for (int i = 0; i < nRealAtoms; ++i) {
+    int atom = fragment.atoms[i];
+    localIndex[atom] = i;
+    structure.elements.push_back(elements_[atom]);
+    structure.positions.row(i) = positions_.row(atom);
+    structure.nAOsPerAtom.push_back(aoIndexes_.getNOrbitals(atom));
+    neutralElectrons += coreCharges_[atom];
+  }
+  for (int i = 0; i < nRealAtoms; ++i) {
+    for (int neighbor : neighbors[fragment.atoms[i]]) {
+      auto it = localIndex.find(neighbor);
+      if (it != localIndex.end() && it->second > i) {
+        structure.bonds.emplace_back(i, it->second);
+      }
+    }
+  }
+  // Hydrogen link atoms along the cut bonds
+  const double hydrogenRadius = Utils::ElementInfo::covalentRadius(Utils::ElementType::H);
+  for (int i = nRealAtoms; i < nAtoms; ++i) {
+    const auto& cutBond = fragment.cutBonds[i - nRealAtoms];
+    Eigen::RowVector3d direction = (positions_.row(cutBond.second) - positions_.row(cutBond.first)).normalized();
+    double distance = Utils::ElementInfo::covalentRadius(elements_[cutBond.first]) + hydrogenRadius;
+    structure.elements.push_back(Utils::ElementType::H);
+    structure.positions.row(i) = positions_.row(cutBond.first) + distance * direction;
+    structure.nAOsPerAtom.push_back(1);
+    structure.bonds.emplace_back(localIndex[cutBond.first], i);
+    neutralElectrons += 1;
+  }
+  structure.nAOs = std::accumulate(structure.nAOsPerAtom.begin(), structure.nAOsPerAtom.end(), 0);
+  structure.nRealAOs = std::accumulate(structure.nAOsPerAtom.begin(), structure.nAOsPerAtom.begin() + nRealAtoms, 0);
+  structure.nNeutralElectrons = static_cast<int>(std::lround(neutralElectrons));
+  return structure;
+}
+
+std::vector<int> FragmentDensityGuess::assignCharges(const std::vector<FragmentStructure>& fragments) const {
+  const int nFragments = static_cast<int>(fragments.size());
+  std::vector<int> charges(nFragments, 0);
+  if (nFragments == 0) {
+    return charges;
+  }
+  double neutralElectrons = std::accumulate(coreCharges_.begin(), coreCharges_.end(), 0.0);
+  int remainingCharge = static_cast<int>(std::lround(neutralElectrons)) - nElectrons_;
+  const int step = remainingCharge > 0 ? 1 : -1;
+  // Fragments with an odd number of electrons are charged first, they become closed-shell
+  for (int i = 0; i < nFragments && remainingCharge != 0; ++i) {
+    if (fragments[i].nNeutralElectrons % 2 != 0) {
+      charges[i] += step;
+      remainingCharge -= step;
+    }
+  }
+  // The rest goes to the largest fragment
+  if (remainingCharge != 0) {
+    auto largest = std::max_element(fragments.begin(), fragments.end(), [](const FragmentStructure& a, const FragmentStructure& b) {
+      return a.atoms.size() < b.atoms.size();
+    });
+    charges[std::distance(fragments.begin(), largest)] += remainingCharge;
+  }
+  return charges;
+}
+
+std::string FragmentDensityGuess::createKey(const FragmentStructure& fragment, int charge) const {
+  std::ostringstream key;
+  key << charge << ':';
+  for (auto e : fragment.elements) {
+    key << Utils::ElementInfo::Z(e) << ',';
+  }
+  key << ':';
+  for (const auto& bond : fragment.bonds) {
+    key << bond.first << '-' << bond.second << ',';
+  }
+  return key.str();
+}
+
+void FragmentDensityGuess::insert(const std::string& key, const FragmentStructure& fragment,
+                                  const Eigen::MatrixXd& density, double population) const {
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  if (static_cast<int>(cache_.count(key)) < maxEntriesPerKey_) {
+    cache_.emplace(key, CacheEntry{fragment.positions, density, population});
+  }
+}
+
+bool FragmentDensityGuess::lookUp(const std::string& key, const FragmentStructure& fragment, Eigen::MatrixXd& density,
+                                  double& population) const {
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  auto range = cache_.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (hasMatchingGeometry(fragment, it->second, density)) {
+      population = it->second.population;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FragmentDensityGuess::hasMatchingGeometry(const FragmentStructure& fragment, const CacheEntry& entry,
+                                               Eigen::MatrixXd& density) {
+  const int nAtoms = static_cast<int>(fragment.positions.rows());
+  if (entry.positions.rows() != nAtoms) {
+    return false;
+  }
+  // Kabsch alignment of the cached geometry X onto the current geometry Y
+  Eigen::MatrixXd X = entry.positions.rowwise() - entry.positions.colwise().mean();
+  Eigen::MatrixXd Y = fragment.positions.rowwise() - fragment.positions.colwise().mean();
+  Eigen::Matrix3d covariance = X.transpose() * Y;
+  Eigen::JacobiSVD<Eigen::Matrix3d> svd(covariance, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Eigen::Matrix3d reflection = Eigen::Matrix3d::Identity();
+  reflection(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant() > 0 ? 1.0 : -1.0;
+  Eigen::Matrix3d rotation = svd.matrixV() * reflection * svd.matrixU().transpose();
+  double rmsd = std::sqrt((X * rotation.transpose() - Y).squaredNorm() / nAtoms);
+  if (rmsd > maxAlignedRmsd) {
+    return false;
+  }
+
+  // The p orbitals (x, y, z) transform like the coordinates. The d orbitals are not rotated, a cached density with d
+  // orbitals is only reused without rotation.
+  const bool isIdentity = (rotation - Eigen::Matrix3d::Identity()).norm() < 1e-3;
+  Eigen::MatrixXd transformation = Eigen::MatrixXd::Identity(fragment.nAOs, fragment.nAOs);
+  int index = 0;
+  for (int nAOs : fragment.nAOsPerAtom) {
+    if (nAOs > 4 && !isIdentity) {
+      return false;
+    }
+    if (nAOs >= 4) {
+      transformation.block<3, 3>(index + 1, index + 1) = rotation;
+    }
+    index += nAOs;
+  }
+  density = transformation * entry.density * transformation.transpose();
+  return true;
+}
+
+void FragmentDensityGuess::setMaxFragmentSize(int nHeavyAtoms) {
+  maxFragmentSize_ = nHeavyAtoms;
+}
+
+int FragmentDensityGuess::getMaxFragmentSize() const {
+  return maxFragmentSize_;
+}
+
+int FragmentDensityGuess::getNumberOfFragmentCalculations() const {
+  return nFragmentCalculations_;
+}
+
+int FragmentDensityGuess::getNumberOfCachedFragments() const {
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  return static_cast<int>(cache_.size());
+}
+
+void FragmentDensityGuess::clearCache() {
+  std::lock_guard<std::mutex> lock(cacheMutex_);
+  cache_.clear();
+}
+
+} // namespace Sparrow
+} // namespace Scine
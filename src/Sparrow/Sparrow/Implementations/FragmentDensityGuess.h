@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_FRAGMENTDENSITYGUESS_H
+#define SPARROW_FRAGMENTDENSITYGUESS_H
+
+#include <Utils/Scf/MethodInterfaces/DensityMatrixGuessCalculator.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Utils {
+class AtomCollection;
+class AtomsOrbitalsIndexes;
+class ScfMethod;
+} // namespace Utils
+
+namespace Sparrow {
+
+/**
+ * @brief Initial density matrix built as a superposition of converged fragment densities.
+ *
+ * The structure is split into covalently bonded fragments. Fragments with more heavy atoms than the maximal fragment
+ * size are further cut at bonds between heavy atoms; the dangling bonds are capped with hydrogen link atoms. The
+ * fragments are converged independently and in parallel, and the initial guess is the block-diagonal density matrix
+ * of the fragment densities, without the link atoms.
+ * Converged fragment densities are cached with their topology (element sequence, bonds and charge) as key. A cached
+ * density is reused for a fragment with the same topology if the two geometries match after alignment; the p blocks
+ * are then rotated accordingly.
+ * Fragments whose SCF does not converge, or which have an odd number of electrons that cannot be compensated with
+ * the molecular charge, take their block from the standard guess.
+ * Leaving out the link atoms and charging fragments changes the number of electrons, so the assembled density is
+ * scaled to the number of electrons of the structure.
+ */
+class FragmentDensityGuess : public Utils::DensityMatrixGuessCalculator {
+ public:
+  /**
+   * @brief Function converging the ground state of a fragment with the given charge.
+   * It returns false if the calculation failed; otherwise the density matrix of the fragment is written to density,
+   * and the gross populations of its atomic orbitals, the diagonal of the density matrix times the overlap matrix, to
+   * populations.
+   */
+  using FragmentCalculator = std::function<bool(const Utils::AtomCollection& fragment, int charge,
+                                                Eigen::MatrixXd& density, Eigen::VectorXd& populations)>;
+
+  //! @brief Creates a method with its parameters set, ready to be initialized for a fragment.
+  using MethodFactory = std::function<std::unique_ptr<Utils::ScfMethod>()>;
+  //! @brief Creates the standard guess of a method.
+  using GuessFactory = std::function<std::unique_ptr<Utils::DensityMatrixGuessCalculator>()>;
+
+  //! @brief A fragment as atom indices of the full structure, and the bonds to the rest of the structure it was cut at.
+  struct Fragment {
+    std::vector<int> atoms;
+    // Pairs (atom inside the fragment, atom outside the fragment)
+    std::vector<std::pair<int, int>> cutBonds;
+  };
+
+  FragmentDensityGuess(const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
+                       const Utils::AtomsOrbitalsIndexes& aoIndexes, const std::vector<double>& coreCharges,
+                       const int& nElectrons, std::unique_ptr<Utils::DensityMatrixGuessCalculator> standardGuess,
+                       FragmentCalculator fragmentCalculator);
+  ~FragmentDensityGuess() override;
+
+  Utils::DensityMatrix calculateGuess() const override;
+
+  /**
+   * @brief Initializes a method with parameters already set for the fragment, converges its SCF and extracts the
+   *        density matrix.
+   * Helper for the implementations of FragmentCalculator; the convergence criteria are looser than the default ones,
+   * as the result is only used as a guess. For an orthogonal basis, as in NDDO, the populations are the diagonal of
+   * the density matrix.
+   */
+  static bool convergeFragment(Utils::ScfMethod& method, const Utils::AtomCollection& fragment, int charge,
+                               bool orthogonalBasis, Eigen::MatrixXd& density, Eigen::VectorXd& populations);
+
+  /**
+   * @brief Switches the density matrix guess of a method between the fragment guess and its standard guess.
+   * Returns the guess to be set in the method, or nullptr if the current guess is kept; an existing fragment guess
+   * only gets the new maximal fragment size, so that its cache survives.
+   * The fragments are converged with the methods created by methodFactory. It is called once per fragment
+   * calculation, possibly in parallel, and must not read the parameters again.
+   */
+  static std::unique_ptr<Utils::DensityMatrixGuessCalculator>
+  switchGuess(Utils::DensityMatrixGuessCalculator* currentGuess, bool enabled, int maxFragmentSize,
+              const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
+              const Utils::AtomsOrbitalsIndexes& aoIndexes, const std::vector<double>& coreCharges,
+              const int& nElectrons, const GuessFactory& standardGuess, MethodFactory methodFactory,
+              bool orthogonalBasis);
+
+  //! @brief Splits the structure into fragments.
+  std::vector<Fragment> detectFragments() const;
+  //! @brief Sets the maximal number of heavy atoms in a fragment. Larger bonded fragments are cut.
+  void setMaxFragmentSize(int nHeavyAtoms);
+  int getMaxFragmentSize() const;
+  //! @brief Number of fragment SCF calculations performed in the last call to calculateGuess().
+  int getNumberOfFragmentCalculations() const;
+  //! @brief Number of fragment densities in the cache.
+  int getNumberOfCachedFragments() const;
+  void clearCache();
+
+ private:
+  // Fragment with link atoms, ready for the fragment calculation.
+  struct FragmentStructure;
+  struct CacheEntry {
+    Utils::PositionCollection positions;
+    Eigen::MatrixXd density;
+    // Number of electrons on the real atoms, invariant under the rotation of the density
+    double population;
+  };
+
+  // Lists of bonded atoms for every atom, from the covalent radii, found with a cell list.
+  std::vector<std::vector<int>> detectNeighbors() const;
+  std::vector<Fragment> detectFragments(const std::vector<std::vector<int>>& neighbors) const;
+  std::vector<Fragment> splitFragment(const std::vector<int>& atoms, const std::vector<std::vector<int>>& neighbors) const;
+  std::vector<int> assignCharges(const std::vector<FragmentStructure>& fragments) const;
+  FragmentStructure createFragmentStructure(const Fragment& fragment, const std::vector<std::vector<int>>& neighbors) const;
+  void insert(const std::string& key, const FragmentStructure& fragment, const Eigen::MatrixXd& density,
+              double population) const;
+  std::string createKey(const FragmentStructure& fragment, int charge) const;
+  bool lookUp(const std::string& key, const FragmentStructure& fragment, Eigen::MatrixXd& density,
+              double& population) const;
+  static bool hasMatchingGeometry(const FragmentStructure& fragment, const CacheEntry& entry, Eigen::MatrixXd& density);
+
+  const Utils::ElementTypeCollection& elements_;
+  const Utils::PositionCollection& positions_;
+  const Utils::AtomsOrbitalsIndexes& aoIndexes_;
+  const std::vector<double>& coreCharges_;
+  const int& nElectrons_;
+  std::unique_ptr<Utils::DensityMatrixGuessCalculator> standardGuess_;
+  FragmentCalculator fragmentCalculator_;
+  int maxFragmentSize_ = 16;
+  static constexpr int maxEntriesPerKey_ = 8;
+
+  mutable std::multimap<std::string, CacheEntry> cache_;
+  mutable std::mutex cacheMutex_;
+  mutable int nFragmentCalculations_ = 0;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+#endif // SPARROW_FRAGMENTDENSITYGUESS_H
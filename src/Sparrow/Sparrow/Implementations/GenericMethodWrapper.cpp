@@ -10,11 +10,14 @@
 #include "DipoleMatrixCalculator.h"
 #include "DipoleMomentCalculator.h"
 #include "MoldenFileGenerator.h"
+#include "SparrowSettingPopulator.h"
 #include "Sto6gParameters.h"
 #include "Utils/Scf/LcaoUtils/SpinMode.h"
 #include <Utils/CalculatorBasics/PropertyList.h>
 /* External Includes */
 #include <Core/Exceptions.h>
+#include <Core/Log.h>
+#include <Sparrow/StatesHandling/SparrowCheckpoint.h>
 #include <Sparrow/StatesHandling/SparrowState.h>
 #include <Utils/CalculatorBasics.h>
 #include <Utils/GeometricDerivatives/NumericalHessianCalculator.h>
@@ -26,12 +29,43 @@
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingsNames.h>
 #include <boost/filesystem.hpp>
+#include <Eigen/Eigenvalues>
 #include <fstream>
+#include <iomanip>
 #include <memory>
+#include <sstream>
 
 namespace Scine {
 namespace Sparrow {
 
+namespace {
+// Largest atomic displacement, in bohr, up to which a stored Fock matrix is used as guess at a new geometry.
+constexpr double maxFockRestartDisplacement = 1.0;
+
+double maxDisplacement(const Utils::PositionCollection& a, const Utils::PositionCollection& b) {
+  return (a - b).rowwise().norm().maxCoeff();
+}
+
+// F = S C e C^T S, exact for a full set of molecular orbitals.
+template<class Energies>
+Eigen::MatrixXd reconstructFockMatrix(const Eigen::MatrixXd& overlap, const Eigen::MatrixXd& coefficients,
+                                      const Energies& energies) {
+  Eigen::MatrixXd sc = overlap * coefficients;
+  Eigen::MatrixXd sce = sc;
+  for (int i = 0; i < sce.cols(); ++i) {
+    sce.col(i) *= energies[i];
+  }
+  return sce * sc.transpose();
+}
+
+// Density matrix of the nOccupied lowest orbitals of the generalized eigenvalue problem F C = S C e.
+Eigen::MatrixXd occupiedDensity(const Eigen::MatrixXd& fock, const Eigen::MatrixXd& overlap, int nOccupied) {
+  Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> solver(fock, overlap);
+  Eigen::MatrixXd occupied = solver.eigenvectors().leftCols(nOccupied);
+  return occupied * occupied.transpose();
+}
+} // namespace
+
 GenericMethodWrapper::GenericMethodWrapper() = default;
 
 GenericMethodWrapper::~GenericMethodWrapper() = default;
@@ -66,18 +100,54 @@ const Utils::Results& GenericMethodWrapper::calculate(std::string description) {
   if (dipoleMatrixCalculator_)
     dipoleMatrixCalculator_->invalidate();
   applySettings();
+  updatePointChargeEmbedding();
+  updatePeriodicCell();
   // Check method and basis set fields
   checkBasicSettings();
+  resultsStateFingerprint_ = getStateFingerprint();
+  resultsConvergenceCriterion_ = settings_->getDouble(Utils::SettingsNames::selfConsistenceCriterion);
+  loadCheckpoint();
+  activeSnapshot_.reset();
+  auto snapshot = std::move(loadedSnapshot_);
+  if (snapshot) {
+    if (restoreSnapshot(snapshot, description)) {
+      return results_;
+    }
+    setFockRestartGuess(*snapshot);
+  }
+  else {
+    setExtrapolatedGuess();
+  }
   calculateImpl(requiredDerivative);
+  if (successfulCalculation()) {
+    addExtrapolationStep();
+  }
 
   // If you want the Hessian, but cannot calculate it analytically,
   // calculate it semi-numerically. Same with Dipole Gradient.
   if (requiredSemiNumericalHessian || requiredDipoleGradient) {
+    // The displaced calculations must neither read nor overwrite the checkpoint of this structure
+    const std::string checkpointFile = getCheckpointFile();
+    if (!checkpointFile.empty()) {
+      settings_->modifyString(SparrowSettingsNames::checkpointFile, "");
+    }
     Utils::NumericalHessianCalculator hessianCalculator(*this);
     if (requiredDipoleGradient) {
       hessianCalculator.requiredDipoleGradient(true);
     }
-    auto numericalResult = hessianCalculator.calculate();
+    Utils::Results numericalResult;
+    try {
+      numericalResult = hessianCalculator.calculate();
+    }
+    catch (...) {
+      if (!checkpointFile.empty()) {
+        settings_->modifyString(SparrowSettingsNames::checkpointFile, checkpointFile);
+      }
+      throw;
+    }
+    if (!checkpointFile.empty()) {
+      settings_->modifyString(SparrowSettingsNames::checkpointFile, checkpointFile);
+    }
     results_.set<Utils::Property::Hessian>(numericalResult.take<Utils::Property::Hessian>());
     if (requiredDipoleGradient) {
       results_.set<Utils::Property::DipoleGradient>(numericalResult.take<Utils::Property::DipoleGradient>());
@@ -91,12 +161,17 @@ const Utils::Results& GenericMethodWrapper::calculate(std::string description) {
   results_.set<Utils::Property::SuccessfulCalculation>(successfulCalculation());
 
   assembleResults(description);
+  writeCheckpoint();
 
   return results_;
 }
 
 void GenericMethodWrapper::setStructure(const Utils::AtomCollection& structure) {
   results_ = {};
+  loadedSnapshot_.reset();
+  loadedCheckpointFile_.clear();
+  activeSnapshot_.reset();
+  densityExtrapolator_.clear();
   getLcaoMethod().setAtomCollection(structure);
   // Apply the settings used in intialization, as molecular charge
   applySettings();
@@ -112,6 +187,7 @@ void GenericMethodWrapper::modifyPositions(Utils::PositionCollection newPosition
   if (int(getLcaoMethod().getElementTypes().size()) != int(newPositions.rows())) {
     throw std::runtime_error("Position/ElementTypeCollection dimensionality mismatch.");
   }
+  activeSnapshot_.reset();
   getLcaoMethod().setPositions(std::move(newPositions));
 }
 
@@ -128,16 +204,23 @@ Utils::PropertyList GenericMethodWrapper::getRequiredProperties() const {
 }
 
 Utils::PropertyList GenericMethodWrapper::possibleProperties() const {
-  return Utils::Property::Energy | Utils::Property::Gradients | Utils::Property::Hessian |
-         Utils::Property::AtomicHessians | Utils::Property::BondOrderMatrix | Utils::Property::DensityMatrix |
-         Utils::Property::AtomicCharges | Utils::Property::OverlapMatrix | Utils::Property::OrbitalEnergies |
-         Utils::Property::CoefficientMatrix | Utils::Property::ElectronicOccupation | Utils::Property::Thermochemistry |
-         Utils::Property::Description | Utils::Property::Dipole | Utils::Property::SuccessfulCalculation;
+  Utils::PropertyList properties =
+      Utils::Property::Energy | Utils::Property::Gradients | Utils::Property::Hessian |
+      Utils::Property::AtomicHessians | Utils::Property::BondOrderMatrix | Utils::Property::DensityMatrix |
+      Utils::Property::AtomicCharges | Utils::Property::OverlapMatrix | Utils::Property::OrbitalEnergies |
+      Utils::Property::CoefficientMatrix | Utils::Property::ElectronicOccupation | Utils::Property::Thermochemistry |
+      Utils::Property::Description | Utils::Property::Dipole | Utils::Property::SuccessfulCalculation;
+  if (supportsPointChargeEmbedding()) {
+    properties.addProperty(Utils::Property::PointChargesGradients);
+  }
+  return properties;
 }
 
 Utils::Derivative GenericMethodWrapper::highestDerivativeRequired() const {
   // If gradient or hessian is contained in the requiredProperties_, then calculate the corresponding derivative.
-  bool gradientsRequired = requiredProperties_.containsSubSet(Utils::Property::Gradients);
+  // The gradients on the point charges are calculated together with the ones on the atoms.
+  bool gradientsRequired = requiredProperties_.containsSubSet(Utils::Property::Gradients) ||
+                           requiredProperties_.containsSubSet(Utils::Property::PointChargesGradients);
   bool hessianRequired = requiredProperties_.containsSubSet(Utils::Property::Hessian) ||
                          requiredProperties_.containsSubSet(Utils::Property::Thermochemistry);
   bool atomicHessiansRequired = requiredProperties_.containsSubSet(Utils::Property::AtomicHessians);
@@ -190,6 +273,11 @@ void GenericMethodWrapper::assembleResults(const std::string& description) {
     results_.set<Utils::Property::Gradients>(std::move(grad));
   }
 
+  if (requiredProperties_.containsSubSet(Utils::Property::PointChargesGradients) &&
+      possibleProperties().containsSubSet(Utils::Property::PointChargesGradients)) {
+    results_.set<Utils::Property::PointChargesGradients>(pointChargeEmbedding_->getGradients());
+  }
+
   if (highestDerivativeRequired() >= Utils::Derivative::SecondFull) {
     results_.set<Utils::Property::Hessian>(getLcaoMethod().getFullSecondDerivatives().getHessianMatrix());
   }
@@ -199,7 +287,11 @@ void GenericMethodWrapper::assembleResults(const std::string& description) {
   }
 
   if (requiredProperties_.containsSubSet(Utils::Property::BondOrderMatrix)) {
-    results_.set<Utils::Property::BondOrderMatrix>(getLcaoMethod().getBondOrderCollection());
+    const bool screened = !settings_->valueExists(SparrowSettingsNames::screenedBondOrders) ||
+                          settings_->getBool(SparrowSettingsNames::screenedBondOrders);
+    const BlockPopulationAnalysis populationAnalysis = getPopulationAnalysis();
+    results_.set<Utils::Property::BondOrderMatrix>(screened ? populationAnalysis.getBondOrders()
+                                                            : populationAnalysis.getAllBondOrders());
   }
 
   if (requiredProperties_.containsSubSet(Utils::Property::DensityMatrix)) {
@@ -271,10 +363,285 @@ void GenericMethodWrapper::loadState(std::shared_ptr<Core::State> state) {
     }
     getLcaoMethod().setDensityMatrix(sparrowState->getDensityMatrix());
   }
+  loadedSnapshot_.reset();
+  activeSnapshot_.reset();
+  // The loaded density does not belong to the current sequence of geometries
+  densityExtrapolator_.clear();
+  const auto& snapshot = sparrowState->getSnapshot();
+  if (snapshot && snapshot->fingerprint == getStateFingerprint()) {
+    loadedSnapshot_ = snapshot;
+  }
 }
 
 std::shared_ptr<Core::State> GenericMethodWrapper::getState() const {
-  return std::make_shared<SparrowState>(getLcaoMethod().getDensityMatrix());
+  bool snapshotsEnabled = settings_->valueExists(SparrowSettingsNames::stateSnapshots) &&
+                          settings_->getBool(SparrowSettingsNames::stateSnapshots);
+  if (!snapshotsEnabled) {
+    return std::make_shared<SparrowState>(getLcaoMethod().getDensityMatrix());
+  }
+  auto snapshot = activeSnapshot_ ? activeSnapshot_ : createSnapshot();
+  return std::make_shared<SparrowState>(getLcaoMethod().getDensityMatrix(), std::move(snapshot));
+}
+
+std::string GenericMethodWrapper::getCheckpointFile() const {
+  return settings_->valueExists(SparrowSettingsNames::checkpointFile)
+             ? settings_->getString(SparrowSettingsNames::checkpointFile)
+             : "";
+}
+
+void GenericMethodWrapper::loadCheckpoint() {
+  const std::string filename = getCheckpointFile();
+  // The checkpoint is read once, the following calculations continue from their own state
+  if (filename.empty() || filename == loadedCheckpointFile_) {
+    return;
+  }
+  loadedCheckpointFile_ = filename;
+  if (!std::ifstream(filename).good()) {
+    // First run, the checkpoint is written after the calculation
+    return;
+  }
+  std::shared_ptr<SparrowState> state;
+  try {
+    state = SparrowCheckpoint::read(filename).getState();
+  }
+  catch (const CheckpointException& e) {
+    getLog().warning << e.what() << " It is overwritten." << Core::Log::endl;
+    return;
+  }
+  if (!state || !state->hasSnapshot() || state->getSnapshot()->elements != getLcaoMethod().getElementTypes()) {
+    getLog().warning << "Checkpoint " << filename << " belongs to another structure and is overwritten."
+                     << Core::Log::endl;
+    return;
+  }
+  try {
+    loadState(state);
+  }
+  catch (const IncompatibleStateException&) {
+    getLog().warning << "Checkpoint " << filename << " has another number of electrons and is overwritten."
+                     << Core::Log::endl;
+  }
+}
+
+void GenericMethodWrapper::writeCheckpoint() const {
+  const std::string filename = getCheckpointFile();
+  if (filename.empty()) {
+    return;
+  }
+  auto snapshot = createSnapshot();
+  // A failed calculation does not replace the checkpoint of a previous one
+  if (!snapshot) {
+    return;
+  }
+  SparrowCheckpoint::updateState(filename, SparrowState(getLcaoMethod().getDensityMatrix(), std::move(snapshot)));
+}
+
+bool GenericMethodWrapper::resultsRestoredFromSnapshot() const {
+  return static_cast<bool>(activeSnapshot_);
+}
+
+double GenericMethodWrapper::getResultsConvergenceCriterion() const {
+  return resultsConvergenceCriterion_;
+}
+
+bool GenericMethodWrapper::resultsMatchSettings() const {
+  return resultsStateFingerprint_ == getStateFingerprint();
+}
+
+void GenericMethodWrapper::restoreMethodState() {
+  if (!activeSnapshot_ || !methodStateOutdated_) {
+    return;
+  }
+  // The density matrix of the loaded state is converged, the SCF only rebuilds the orbitals and the matrices from it
+  calculateImpl(restoredDerivative_);
+  methodStateOutdated_ = false;
+}
+
+std::string GenericMethodWrapper::getStateFingerprint(bool withPointCharges) const {
+  std::stringstream fingerprint;
+  fingerprint << name();
+  for (const std::string& key : {Utils::SettingsNames::methodParameters, Utils::SettingsNames::spinMode}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << ";" << settings_->getString(key);
+    }
+  }
+  for (const std::string& key : {Utils::SettingsNames::molecularCharge, Utils::SettingsNames::spinMultiplicity}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << ";" << settings_->getInt(key);
+    }
+  }
+  fingerprint << ";";
+  for (auto element : getLcaoMethod().getElementTypes()) {
+    fingerprint << Utils::ElementInfo::Z(element) << ",";
+  }
+  fingerprint << ";" << periodicCell_->getFingerprint();
+  if (withPointCharges) {
+    fingerprint << ";" << pointChargeEmbedding_->getFingerprint();
+  }
+  return fingerprint.str();
+}
+
+std::string GenericMethodWrapper::getResultsFingerprint() const {
+  std::stringstream fingerprint;
+  fingerprint << std::setprecision(17);
+  for (const std::string& key : {Utils::SettingsNames::selfConsistenceCriterion, Utils::SettingsNames::densityRmsdCriterion,
+                                 SparrowSettingsNames::levelShiftGap, SparrowSettingsNames::fermiTemperature,
+                                 SparrowSettingsNames::mixedPrecisionHandOff, Utils::SettingsNames::temperature}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << key << "=" << settings_->getDouble(key) << ";";
+    }
+  }
+  for (const std::string& key : {Utils::SettingsNames::maxScfIterations, Utils::SettingsNames::symmetryNumber}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << key << "=" << settings_->getInt(key) << ";";
+    }
+  }
+  for (const std::string& key : {Utils::SettingsNames::mixer, SparrowSettingsNames::scfAccelerator}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << key << "=" << settings_->getString(key) << ";";
+    }
+  }
+  for (const std::string& key : {Utils::SettingsNames::NDDODipoleApproximation, SparrowSettingsNames::mixedPrecisionScf,
+                                 SparrowSettingsNames::screenedBondOrders}) {
+    if (settings_->valueExists(key)) {
+      fingerprint << key << "=" << settings_->getBool(key) << ";";
+    }
+  }
+  return fingerprint.str();
+}
+
+std::shared_ptr<const SparrowStateSnapshot> GenericMethodWrapper::createSnapshot() const {
+  // The orbitals are only meaningful after a successful calculation at the current geometry
+  if (!results_.has<Utils::Property::SuccessfulCalculation>() || !results_.get<Utils::Property::SuccessfulCalculation>()) {
+    return nullptr;
+  }
+  const auto& method = getLcaoMethod();
+  auto snapshot = std::make_shared<SparrowStateSnapshot>();
+  snapshot->fingerprint = getStateFingerprint();
+  snapshot->resultsFingerprint = getResultsFingerprint();
+  snapshot->elements = method.getElementTypes();
+  snapshot->positions = method.getPositions();
+  snapshot->molecularOrbitals = method.getMolecularOrbitals();
+  snapshot->singleParticleEnergies = method.getSingleParticleEnergies();
+  snapshot->densityIndependentMatrix = getDensityIndependentFockMatrix();
+  snapshot->unrestricted = method.unrestrictedCalculationRunning();
+  snapshot->results = results_;
+  snapshot->properties = requiredProperties_;
+
+  const int nAOs = method.getNumberAtomicOrbitals();
+  Eigen::MatrixXd overlap = hasOrthogonalBasis() ? Eigen::MatrixXd::Identity(nAOs, nAOs)
+                                                 : Eigen::MatrixXd(method.getOverlapMatrix().selfadjointView<Eigen::Lower>());
+  const auto& occupation = method.getElectronicOccupation();
+  if (snapshot->unrestricted) {
+    snapshot->nAlphaElectrons = static_cast<int>(occupation.getFilledAlphaOrbitals().size());
+    snapshot->nBetaElectrons = static_cast<int>(occupation.getFilledBetaOrbitals().size());
+    snapshot->fockMatrix = Utils::SpinAdaptedMatrix::createUnrestricted(
+        reconstructFockMatrix(overlap, snapshot->molecularOrbitals.alphaMatrix(),
+                              snapshot->singleParticleEnergies.getAlphaEnergies()),
+        reconstructFockMatrix(overlap, snapshot->molecularOrbitals.betaMatrix(),
+                              snapshot->singleParticleEnergies.getBetaEnergies()));
+  }
+  else {
+    snapshot->nAlphaElectrons = static_cast<int>(occupation.getFilledRestrictedOrbitals().size());
+    snapshot->nBetaElectrons = snapshot->nAlphaElectrons;
+    snapshot->fockMatrix = Utils::SpinAdaptedMatrix::createRestricted(reconstructFockMatrix(
+        overlap, snapshot->molecularOrbitals.restrictedMatrix(), snapshot->singleParticleEnergies.getRestrictedEnergies()));
+  }
+  return snapshot;
+}
+
+bool GenericMethodWrapper::restoreSnapshot(std::shared_ptr<const SparrowStateSnapshot> snapshot,
+                                           const std::string& description) {
+  const auto& positions = getPositions();
+  bool sameGeometry =
+      positions.rows() == snapshot->positions.rows() && maxDisplacement(positions, snapshot->positions) < 1e-10;
+  // The settings may have changed since the snapshot was loaded, and the results also depend on the convergence
+  if (!sameGeometry || !snapshot->properties.containsSubSet(requiredProperties_) ||
+      snapshot->fingerprint != getStateFingerprint() || snapshot->resultsFingerprint != getResultsFingerprint()) {
+    return false;
+  }
+  results_ = snapshot->results;
+  results_.set<Utils::Property::Description>(description);
+  activeSnapshot_ = std::move(snapshot);
+  // The underlying method is only brought to the restored state if a consumer needs it, see restoreMethodState()
+  methodStateOutdated_ = true;
+  restoredDerivative_ = highestDerivativeRequired();
+  return true;
+}
+
+void GenericMethodWrapper::setFockRestartGuess(const SparrowStateSnapshot& snapshot) {
+  auto& method = getLcaoMethod();
+  const auto& positions = getPositions();
+  if (positions.rows() != snapshot.positions.rows() || snapshot.fingerprint != getStateFingerprint() ||
+      maxDisplacement(positions, snapshot.positions) > maxFockRestartDisplacement) {
+    // The density matrix of the state remains the guess
+    return;
+  }
+  if (!snapshot.unrestricted && snapshot.nAlphaElectrons * 2 != method.getNumberElectrons()) {
+    return;
+  }
+
+  // F(R) = F(R0) + H(R) - H(R0), with H the density-independent part of the Fock matrix
+  method.calculateDensityIndependentQuantities();
+  const int nAOs = method.getNumberAtomicOrbitals();
+  Eigen::MatrixXd overlap = hasOrthogonalBasis() ? Eigen::MatrixXd::Identity(nAOs, nAOs)
+                                                 : Eigen::MatrixXd(method.getOverlapMatrix().selfadjointView<Eigen::Lower>());
+  Eigen::MatrixXd fockShift = Eigen::MatrixXd::Zero(nAOs, nAOs);
+  Eigen::MatrixXd densityIndependentMatrix = getDensityIndependentFockMatrix();
+  if (densityIndependentMatrix.size() != 0 && snapshot.densityIndependentMatrix.size() != 0) {
+    fockShift = densityIndependentMatrix - snapshot.densityIndependentMatrix;
+  }
+
+  Utils::DensityMatrix guess;
+  if (snapshot.unrestricted) {
+    guess.setDensity(occupiedDensity(snapshot.fockMatrix.alphaMatrix() + fockShift, overlap, snapshot.nAlphaElectrons),
+                     occupiedDensity(snapshot.fockMatrix.betaMatrix() + fockShift, overlap, snapshot.nBetaElectrons),
+                     snapshot.nAlphaElectrons, snapshot.nBetaElectrons);
+  }
+  else {
+    guess.setDensity(2 * occupiedDensity(snapshot.fockMatrix.restrictedMatrix() + fockShift, overlap,
+                                         snapshot.nAlphaElectrons),
+                     2 * snapshot.nAlphaElectrons);
+  }
+  method.setDensityMatrix(std::move(guess));
+}
+
+void GenericMethodWrapper::setExtrapolatedGuess() {
+  if (!settings_->valueExists(SparrowSettingsNames::densityExtrapolation)) {
+    return;
+  }
+  auto mode = DensityExtrapolator::modeFromString(settings_->getString(SparrowSettingsNames::densityExtrapolation));
+  densityExtrapolator_.setMode(mode, settings_->getInt(SparrowSettingsNames::extrapolationOrder));
+  // The point charges of a QM/MM trajectory move along with the molecule
+  auto fingerprint = getStateFingerprint(false);
+  if (fingerprint != extrapolationFingerprint_) {
+    densityExtrapolator_.clear();
+    extrapolationFingerprint_ = std::move(fingerprint);
+  }
+  if (mode == DensityExtrapolator::Mode::None || densityExtrapolator_.historySize() < 2) {
+    return;
+  }
+  Utils::DensityMatrix guess;
+  if (mode == DensityExtrapolator::Mode::Lowdin && !hasOrthogonalBasis()) {
+    // Overlap matrix at the new geometry
+    getLcaoMethod().calculateDensityIndependentQuantities();
+  }
+  if (densityExtrapolator_.extrapolate(getPositions(), getExtrapolationOverlap(), guess)) {
+    getLcaoMethod().setDensityMatrix(std::move(guess));
+  }
+}
+
+void GenericMethodWrapper::addExtrapolationStep() {
+  if (densityExtrapolator_.getMode() == DensityExtrapolator::Mode::None) {
+    return;
+  }
+  densityExtrapolator_.addStep(getPositions(), getExtrapolationOverlap(), getLcaoMethod().getDensityMatrix());
+}
+
+Eigen::MatrixXd GenericMethodWrapper::getExtrapolationOverlap() const {
+  if (densityExtrapolator_.getMode() != DensityExtrapolator::Mode::Lowdin || hasOrthogonalBasis()) {
+    return {};
+  }
+  return getLcaoMethod().getOverlapMatrix().selfadjointView<Eigen::Lower>();
 }
 
 std::string GenericMethodWrapper::getStoNGExpansionPath() const {
@@ -336,6 +703,108 @@ bool GenericMethodWrapper::canCalculateAnalyticalHessian() const {
   return false;
 }
 
+bool GenericMethodWrapper::hasAnalyticalHessian() const {
+  return canCalculateAnalyticalHessian();
+}
+
+void GenericMethodWrapper::setPointCharges(Utils::PositionCollection positions, Eigen::VectorXd charges) {
+  results_ = {};
+  activeSnapshot_.reset();
+  pointChargeEmbedding_->setPointCharges(std::move(positions), std::move(charges));
+  // Not overwritten by the file of the settings unless the file changes
+  if (settings_->valueExists(SparrowSettingsNames::pointChargesFile)) {
+    loadedPointChargesFile_ = settings_->getString(SparrowSettingsNames::pointChargesFile);
+  }
+}
+
+const PointChargeEmbedding& GenericMethodWrapper::getPointChargeEmbedding() const {
+  return *pointChargeEmbedding_;
+}
+
+bool GenericMethodWrapper::supportsPointChargeEmbedding() const {
+  return false;
+}
+
+void GenericMethodWrapper::copyPointChargeEmbedding(const GenericMethodWrapper& rhs) {
+  *pointChargeEmbedding_ = *rhs.pointChargeEmbedding_;
+  loadedPointChargesFile_ = rhs.loadedPointChargesFile_;
+}
+
+void GenericMethodWrapper::updatePointChargeEmbedding() {
+  if (settings_->valueExists(SparrowSettingsNames::pointChargesFile)) {
+    auto filename = settings_->getString(SparrowSettingsNames::pointChargesFile);
+    if (filename != loadedPointChargesFile_) {
+      if (filename.empty()) {
+        pointChargeEmbedding_->clear();
+      }
+      else {
+        pointChargeEmbedding_->readPointCharges(filename);
+      }
+      loadedPointChargesFile_ = std::move(filename);
+    }
+    pointChargeEmbedding_->setCutoff(settings_->getDouble(SparrowSettingsNames::pointChargesCutoff));
+  }
+  if (!pointChargeEmbedding_->empty() && !supportsPointChargeEmbedding()) {
+    throw std::runtime_error("Point charges are not available with " + name() + ".");
+  }
+}
+
+bool GenericMethodWrapper::supportsPeriodicBoundaries() const {
+  return false;
+}
+
+Eigen::Matrix3d GenericMethodWrapper::getStrainDerivatives() const {
+  throw std::runtime_error("The stress tensor is not available with " + name() + ".");
+}
+
+void GenericMethodWrapper::updatePeriodicCell() {
+  if (settings_->valueExists(SparrowSettingsNames::periodicBoundaries)) {
+    periodicCell_->setFromString(settings_->getString(SparrowSettingsNames::periodicBoundaries));
+  }
+  if (!periodicCell_->isPeriodic()) {
+    return;
+  }
+  if (!supportsPeriodicBoundaries()) {
+    throw std::runtime_error("Periodic boundaries are not available with " + name() + ".");
+  }
+  if (!pointChargeEmbedding_->empty()) {
+    throw std::runtime_error("Point charges are not available with periodic boundaries.");
+  }
+}
+
+Eigen::Matrix3d GenericMethodWrapper::getStressTensor() const {
+  if (!periodicCell_->isPeriodic() || !results_.has<Utils::Property::Gradients>() || activeSnapshot_) {
+    throw std::runtime_error("The stress tensor requires a calculation of the gradients with periodic boundaries.");
+  }
+  return getStrainDerivatives() / periodicCell_->getVolume();
+}
+
+const PeriodicCell& GenericMethodWrapper::getPeriodicCell() const {
+  return *periodicCell_;
+}
+
+BlockPopulationAnalysis GenericMethodWrapper::getPopulationAnalysis() const {
+  if (activeSnapshot_ && methodStateOutdated_) {
+    throw std::runtime_error("The population analysis of results restored from a snapshot requires "
+                             "restoreMethodState().");
+  }
+  const auto& method = getLcaoMethod();
+  return {method.getDensityMatrix(), method.getOverlapMatrix(), method.getAtomsOrbitalsIndexesHolder(),
+          getCoreCharges(), hasOrthogonalBasis()};
+}
+
+const ScfAccelerator& GenericMethodWrapper::getScfAccelerator() const {
+  return *scfAccelerator_;
+}
+
+Eigen::MatrixXd GenericMethodWrapper::getDensityIndependentFockMatrix() const {
+  return {};
+}
+
+bool GenericMethodWrapper::hasOrthogonalBasis() const {
+  return false;
+}
+
 void GenericMethodWrapper::generateWavefunctionInformation(const std::string& filename) {
   std::ofstream fileOut(filename);
   if (!fileOut.is_open())
@@ -344,6 +813,7 @@ void GenericMethodWrapper::generateWavefunctionInformation(const std::string& fi
 }
 
 void GenericMethodWrapper::generateWavefunctionInformation(std::ostream& out) {
+  restoreMethodState();
   if (!results().has<Utils::Property::SuccessfulCalculation>() || !results().get<Utils::Property::SuccessfulCalculation>()) {
     getLcaoMethod().calculate(Utils::Derivative::None, getLog());
   }
@@ -352,6 +822,17 @@ void GenericMethodWrapper::generateWavefunctionInformation(std::ostream& out) {
 }
 
 void GenericMethodWrapper::applySettings() {
+  if (settings_->valueExists(SparrowSettingsNames::scfAccelerator)) {
+    auto mode = ScfAccelerator::modeFromString(settings_->getString(SparrowSettingsNames::scfAccelerator));
+    scfAccelerator_->setMode(mode);
+  }
+  if (settings_->valueExists(SparrowSettingsNames::levelShiftGap)) {
+    scfAccelerator_->setLevelShiftGap(settings_->getDouble(SparrowSettingsNames::levelShiftGap));
+  }
+  if (settings_->valueExists(SparrowSettingsNames::fermiTemperature)) {
+    scfAccelerator_->setFermiTemperature(settings_->getDouble(SparrowSettingsNames::fermiTemperature));
+  }
+  scfAccelerator_->setMethod(&getLcaoMethod());
 }
 
 } /* namespace Sparrow */
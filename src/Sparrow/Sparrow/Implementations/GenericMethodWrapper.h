@@ -9,12 +9,18 @@
 
 /* External Includes */
 
+#include "BlockPopulationAnalysis.h"
+#include "DensityExtrapolator.h"
+#include "PeriodicCell.h"
+#include "PointChargeEmbedding.h"
+#include "ScfAccelerator.h"
 #include <Core/Interfaces/Calculator.h>
 #include <Core/Interfaces/WavefunctionOutputGenerator.h>
 #include <Utils/CalculatorBasics.h>
 #include <Utils/DataStructures/AtomicGtos.h>
 #include <Utils/Settings.h>
 #include <Utils/Technical/CloneInterface.h>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -30,6 +36,7 @@ namespace Sparrow {
 
 class DipoleMatrixCalculator;
 class DipoleMomentCalculator;
+struct SparrowStateSnapshot;
 
 /**
  * @class GenericMethodWrapper GenericMethodWrapper.h
@@ -128,8 +135,67 @@ class GenericMethodWrapper : public Utils::CloneInterface<Utils::Abstract<Generi
   void generateWavefunctionInformation(const std::string& filename) final;
   void generateWavefunctionInformation(std::ostream& out) final;
 
+  /**
+   * @brief Loads the density matrix of a state.
+   * If the state holds a snapshot compatible with the current method and settings, the next calculation returns the
+   * stored results without SCF at the same geometry, or starts from the stored Fock matrix at a nearby geometry.
+   */
   void loadState(std::shared_ptr<Core::State> state) override;
+  /**
+   * @brief Gets the current state.
+   * If the setting "state_snapshots" is enabled and the last calculation was successful, the state holds a snapshot
+   * of the converged calculation in addition to the density matrix.
+   */
   std::shared_ptr<Core::State> getState() const final;
+  //! @brief Whether the Hessian is calculated analytically, otherwise it is calculated semi-numerically.
+  bool hasAnalyticalHessian() const;
+  //! @brief Whether the results of the last calculation were taken from a loaded snapshot, without SCF.
+  bool resultsRestoredFromSnapshot() const;
+  //! @brief SCF convergence criterion the results of the last calculation were obtained with.
+  double getResultsConvergenceCriterion() const;
+  //! @brief Whether the method, parameters, electronic state and embedding of the last calculation are still set.
+  bool resultsMatchSettings() const;
+  /**
+   * @brief Brings the underlying method to the state of results restored from a snapshot.
+   * A restore only copies the results, the orbitals, orbital energies and matrices of the underlying method are
+   * rebuilt here by an SCF starting from the converged density of the loaded state. The consumers of the method
+   * state, as the excited-state calculators, call this before reading it; it does nothing if the results were not
+   * restored or the method state is already up to date.
+   */
+  void restoreMethodState();
+
+  /**
+   * @brief Sets point charges for the electrostatic embedding of the molecule, e.g. in a QM/MM calculation.
+   * The point charges replace those read from the setting "point_charges_file". Their interaction with the
+   * molecule is included in the energy and in the gradients, the interaction among themselves is not. The gradients
+   * on the point charges, in hartree/bohr, are the results property Utils::Property::PointChargesGradients.
+   * @param positions Positions in bohr.
+   * @param charges   Charges in units of the elementary charge.
+   */
+  void setPointCharges(Utils::PositionCollection positions, Eigen::VectorXd charges);
+  const PointChargeEmbedding& getPointChargeEmbedding() const;
+
+  /**
+   * @brief Stress tensor of the last calculation, in hartree/bohr^3.
+   * The stress is the derivative of the energy with respect to a homogeneous strain of the cell and of the atomic
+   * positions, divided by the cell volume; the pressure is minus a third of its trace. It requires a calculation of
+   * the gradients with the periodic boundaries of the setting "periodic_boundaries".
+   */
+  Eigen::Matrix3d getStressTensor() const;
+  //! @brief The periodic cell of the last calculation, not periodic without periodic boundaries.
+  const PeriodicCell& getPeriodicCell() const;
+
+  /**
+   * @brief Population analysis of the last calculation, from the atom blocks of the density and overlap matrices.
+   * The analysis references the matrices of the underlying method and is only valid until the next calculation.
+   * After a restore from a snapshot, it requires restoreMethodState().
+   */
+  BlockPopulationAnalysis getPopulationAnalysis() const;
+  /**
+   * @brief The SCF convergence accelerator of the settings "scf_accelerator", "level_shift_gap" and
+   *        "fermi_temperature", with the statistics of the last SCF cycle.
+   */
+  const ScfAccelerator& getScfAccelerator() const;
 
  protected:
   std::unique_ptr<Utils::Settings> settings_;
@@ -159,10 +225,76 @@ class GenericMethodWrapper : public Utils::CloneInterface<Utils::Abstract<Generi
 
   //! Method-dependent implementation of the calculate member function
   virtual void calculateImpl(Utils::Derivative requiredDerivative) = 0;
+  //! Density-independent part of the Fock matrix, used to carry a stored Fock matrix to another geometry.
+  virtual Eigen::MatrixXd getDensityIndependentFockMatrix() const;
+  //! Whether the molecular orbitals are orthonormal without overlap metric, as in the NDDO methods.
+  virtual bool hasOrthogonalBasis() const;
+  //! Whether the method includes the point charges of pointChargeEmbedding_ in the calculation.
+  virtual bool supportsPointChargeEmbedding() const;
+  //! Copies the point charges of another calculator, used in the copy constructors.
+  void copyPointChargeEmbedding(const GenericMethodWrapper& rhs);
+  //! Whether the method includes the periodic boundaries of periodicCell_ in the calculation.
+  virtual bool supportsPeriodicBoundaries() const;
+  //! Derivative of the energy of the last gradient calculation with respect to a homogeneous strain.
+  virtual Eigen::Matrix3d getStrainDerivatives() const;
+  //! Charges of the atomic cores, i.e. the valence electrons of the neutral atoms.
+  virtual std::vector<double> getCoreCharges() const = 0;
 
   std::unique_ptr<DipoleMomentCalculator> dipoleCalculator_;
   std::unique_ptr<DipoleMatrixCalculator> dipoleMatrixCalculator_;
   Utils::PropertyList requiredProperties_;
+  //! Point charges embedding the molecule, passed to the underlying method in applySettings().
+  std::shared_ptr<PointChargeEmbedding> pointChargeEmbedding_ = std::make_shared<PointChargeEmbedding>();
+  //! Periodic cell of the structure, passed to the underlying method in applySettings().
+  std::shared_ptr<PeriodicCell> periodicCell_ = std::make_shared<PeriodicCell>();
+  //! SCF convergence accelerator, passed to the Fock matrix of the underlying method in applySettings().
+  std::shared_ptr<ScfAccelerator> scfAccelerator_ = std::make_shared<ScfAccelerator>();
+
+ private:
+  // Reads the point charges file and the cutoff from the settings.
+  void updatePointChargeEmbedding();
+  // Reads the periodic cell from the settings.
+  void updatePeriodicCell();
+  // Identifies method, parameters, elements, periodic cell and electronic state settings to check the compatibility
+  // of snapshots, and the point charges unless withPointCharges is false.
+  std::string getStateFingerprint(bool withPointCharges = true) const;
+  // Identifies the settings the results depend on beyond the state fingerprint: the SCF convergence criteria,
+  // iterations, mixer and accelerator, the electronic temperature and the dipole and thermochemistry settings.
+  std::string getResultsFingerprint() const;
+  std::shared_ptr<const SparrowStateSnapshot> createSnapshot() const;
+  // The setting "checkpoint_file", empty if the calculator is not checkpointed.
+  std::string getCheckpointFile() const;
+  // Loads the state stored in the checkpoint file once per file and structure.
+  void loadCheckpoint();
+  // Stores the state of a successful calculation in the checkpoint file.
+  void writeCheckpoint() const;
+  bool restoreSnapshot(std::shared_ptr<const SparrowStateSnapshot> snapshot, const std::string& description);
+  void setFockRestartGuess(const SparrowStateSnapshot& snapshot);
+  // Applies the settings of the density extrapolation and sets the extrapolated guess, if any.
+  void setExtrapolatedGuess();
+  void addExtrapolationStep();
+  // Overlap matrix for the density extrapolation, empty if it is not needed.
+  Eigen::MatrixXd getExtrapolationOverlap() const;
+
+  // Snapshot loaded and not yet used by a calculation
+  std::shared_ptr<const SparrowStateSnapshot> loadedSnapshot_;
+  // Snapshot the current results were restored from
+  std::shared_ptr<const SparrowStateSnapshot> activeSnapshot_;
+  // Whether the underlying method still holds the state of the calculation before the restore of activeSnapshot_
+  bool methodStateOutdated_ = false;
+  // Derivative of the calculation the results of activeSnapshot_ were restored for
+  Utils::Derivative restoredDerivative_;
+  // History of converged densities along a sequence of geometries
+  DensityExtrapolator densityExtrapolator_;
+  // State fingerprint the history of the density extrapolation was built with
+  std::string extrapolationFingerprint_;
+  // Point charges file the current point charges were read from
+  std::string loadedPointChargesFile_;
+  // Checkpoint file the state was loaded from
+  std::string loadedCheckpointFile_;
+  // State fingerprint and SCF convergence criterion of the last calculation
+  std::string resultsStateFingerprint_;
+  double resultsConvergenceCriterion_ = 0.0;
 };
 
 } /* namespace Sparrow */
@@ -7,12 +7,14 @@
 
 #include "AM1Method.h"
 #include "AM1RepulsionEnergy.h"
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Parameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/OverlapMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDODensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOElectronicEnergyCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
+#include <Utils/Geometry/AtomCollection.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
 #include <Utils/Scf/MethodExceptions.h>
 #include <utility>
@@ -76,6 +78,44 @@ const TwoElectronMatrix& AM1Method::getTwoElectronMatrix() const {
   return am1Fock_->getTwoElectronMatrix();
 }
 
+FockMatrix& AM1Method::getFockMatrix() {
+  return *am1Fock_;
+}
+
+const FockMatrix& AM1Method::getFockMatrix() const {
+  return *am1Fock_;
+}
+
+void AM1Method::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  dynamic_cast<OverlapMatrix&>(*overlapCalculator_).setPeriodicCell(cell);
+  dynamic_cast<AM1RepulsionEnergy&>(*rep_).getEngine().setPeriodicCell(cell);
+  am1Fock_->setPeriodicCell(std::move(cell));
+}
+
+Eigen::Matrix3d AM1Method::calculateStrainDerivatives() const {
+  const auto& repulsion = dynamic_cast<const AM1RepulsionEnergy&>(*rep_);
+  return am1Fock_->getStrainDerivatives() + repulsion.getEngine().getStrainDerivatives();
+}
+
+void AM1Method::setFragmentDensityGuess(bool enabled, int maxFragmentSize) {
+  auto guess = FragmentDensityGuess::switchGuess(
+      densityMatrixGuess_.get(), enabled, maxFragmentSize, elementTypes_, positions_, aoIndexes_, coreCharges_,
+      nElectrons_,
+      [this]() {
+        return std::make_unique<NDDODensityGuess>(elementTypes_, am1Settings_->getElementParameters(),
+                                                  *overlapCalculator_, nElectrons_, nAOs_);
+      },
+      [this]() {
+        auto method = std::make_unique<AM1Method>();
+        method->getRawParameters() = getRawParameters();
+        return method;
+      },
+      true);
+  if (guess) {
+    densityMatrixGuess_ = std::move(guess);
+  }
+}
+
 } // namespace nddo
 } // namespace Sparrow
 } // namespace Scine
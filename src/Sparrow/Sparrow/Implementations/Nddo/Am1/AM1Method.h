@@ -16,6 +16,8 @@ enum class DerivativeOrder;
 }
 namespace Sparrow {
 
+class PeriodicCell;
+
 namespace nddo {
 class FockMatrix;
 class NDDOInitializer;
@@ -49,6 +51,22 @@ class AM1Method : public Utils::ScfMethod {
 
   const nddo::OneElectronMatrix& getOneElectronMatrix() const;
   const nddo::TwoElectronMatrix& getTwoElectronMatrix() const;
+  //! Get the Fock matrix, e.g. to configure the mixed-precision SCF mode.
+  FockMatrix& getFockMatrix();
+  const FockMatrix& getFockMatrix() const;
+  /**
+   * @brief Switches between the standard and the fragment-based initial density guess.
+   * An active fragment guess is kept with its cache of fragment densities, only its size limit is updated.
+   * @param maxFragmentSize Maximal number of heavy atoms per fragment, see FragmentDensityGuess.
+   */
+  void setFragmentDensityGuess(bool enabled, int maxFragmentSize);
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none, see FockMatrix::setPeriodicCell().
+   * The atom pairs are evaluated at the closest periodic image in the overlap, the Fock matrix and the core repulsion.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  //! @brief Derivative of the energy of the last calculation with gradients with respect to a homogeneous strain.
+  Eigen::Matrix3d calculateStrainDerivatives() const;
 
  private:
   std::shared_ptr<NDDOInitializer> am1Settings_;
@@ -8,7 +8,7 @@
 #ifndef SPARROW_AM1REPULSIONENERGY_H
 #define SPARROW_AM1REPULSIONENERGY_H
 
-#include "AM1PairwiseRepulsion.h"
+#include <Sparrow/Implementations/Nddo/Utils/CoreRepulsionEngine.h>
 #include <Utils/Scf/MethodInterfaces/RepulsionCalculator.h>
 #include <memory>
 #include <vector>
@@ -28,9 +28,6 @@ class ElementParameters;
  */
 class AM1RepulsionEnergy : public Utils::RepulsionCalculator {
  public:
-  using PairRepulsionType = std::unique_ptr<AM1PairwiseRepulsion>;
-  using Container = std::vector<std::vector<PairRepulsionType>>;
-
   //! @brief Constructor.
   AM1RepulsionEnergy(const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
                      const ElementParameters& elementParameters);
@@ -51,16 +48,12 @@ class AM1RepulsionEnergy : public Utils::RepulsionCalculator {
   void addRepulsionDerivatives(
       Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const override;
 
- private:
-  template<Utils::Derivative O>
-  void addRepulsionDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
-
-  void calculatePairRepulsion(int i, int j, Utils::DerivativeOrder order);
-  void initializePair(int i, int j);
+  //! @brief Access to the engine evaluating the pair repulsions.
+  CoreRepulsionEngine& getEngine();
+  const CoreRepulsionEngine& getEngine() const;
 
-  const ElementParameters& elementParameters_;
-  Container rep_;
-  int nAtoms_;
+ private:
+  CoreRepulsionEngine engine_;
 };
 
 } // namespace nddo
@@ -8,6 +8,7 @@
 #ifndef SPARROW_AM1SETTINGS_H
 #define SPARROW_AM1SETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 #include <utility>
@@ -32,6 +33,11 @@ class AM1TypeSettings : public Scine::Utils::Settings {
     useNDDODipoleApprox.setDefaultValue(true);
     _fields.push_back(Utils::SettingsNames::NDDODipoleApproximation, std::move(useNDDODipoleApprox));
 
+    SparrowSettingPopulator::populateMixedPrecisionSettings(_fields);
+    SparrowSettingPopulator::populateScfMethodSettings(_fields, false);
+    SparrowSettingPopulator::populatePeriodicBoundarySettings(
+        _fields, "The atom pairs interact at their closest periodic image.");
+
     resetToDefaults();
   }
 };
@@ -12,6 +12,7 @@
 #include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISData.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMatrixCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMomentCalculator.h>
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
 #include <Sparrow/Implementations/Nddo/Utils/OneElectronMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/TwoElectronMatrix.h>
@@ -42,6 +43,16 @@ void AM1TypeMethodWrapper<AM1Type>::applySettings() {
 
   auto& derived = static_cast<AM1Type&>(*this);
   NDDOMethodWrapper::applySettings(derived.settings_, derived.method_);
+  // Set the mixed-precision SCF mode.
+  derived.method_.getFockMatrix().setMixedPrecision(
+      derived.settings_->getBool(SparrowSettingsNames::mixedPrecisionScf),
+      derived.settings_->getDouble(SparrowSettingsNames::mixedPrecisionHandOff));
+  // Set the initial density guess.
+  derived.method_.setFragmentDensityGuess(derived.settings_->getBool(SparrowSettingsNames::fragmentDensityGuess),
+                                          derived.settings_->getInt(SparrowSettingsNames::maxFragmentSize));
+  derived.method_.getFockMatrix().setPointChargeEmbedding(this->pointChargeEmbedding_);
+  derived.method_.getFockMatrix().setScfAccelerator(this->scfAccelerator_);
+  derived.method_.setPeriodicCell(this->periodicCell_);
 }
 
 template<class AM1Type>
@@ -88,7 +99,7 @@ const Utils::LcaoMethod& AM1TypeMethodWrapper<AM1Type>::getLcaoMethod() const {
 
 template<class AM1Type>
 void AM1TypeMethodWrapper<AM1Type>::calculateImpl(Utils::Derivative requiredDerivative) {
-  method_.calculate(requiredDerivative, this->getLog());
+  this->calculateScf(method_, method_.getFockMatrix(), requiredDerivative);
 }
 
 template<class AM1Type>
@@ -124,11 +135,21 @@ void AM1TypeMethodWrapper<AM1Type>::addElectronicContribution(std::shared_ptr<Ut
   method_.addElectronicContribution(std::move(contribution));
 }
 
+template<class AM1Type>
+Eigen::Matrix3d AM1TypeMethodWrapper<AM1Type>::getStrainDerivatives() const {
+  return method_.calculateStrainDerivatives();
+}
+
 template<class AM1Type>
 bool AM1TypeMethodWrapper<AM1Type>::successfulCalculation() const {
   return method_.hasConverged();
 }
 
+template<class AM1Type>
+std::vector<double> AM1TypeMethodWrapper<AM1Type>::getCoreCharges() const {
+  return method_.getInitializer().getCoreCharges();
+}
+
 AM1MethodWrapper::AM1MethodWrapper() {
   requiredProperties_ = Utils::Property::Energy;
   this->settings_ = std::make_unique<AM1Settings>();
@@ -50,6 +50,8 @@ class AM1TypeMethodWrapper
 
  protected:
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  Eigen::Matrix3d getStrainDerivatives() const final;
   Eigen::MatrixXd getOneElectronMatrix() const final;
   Utils::SpinAdaptedMatrix getTwoElectronMatrix() const final;
 
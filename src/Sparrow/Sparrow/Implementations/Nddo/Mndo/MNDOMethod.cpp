@@ -7,12 +7,14 @@
 
 #include "MNDOMethod.h"
 #include "MNDORepulsionEnergy.h"
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Parameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/OverlapMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDODensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOElectronicEnergyCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
+#include <Utils/Geometry/AtomCollection.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
 #include <Utils/Scf/MethodExceptions.h>
 #include <utility>
@@ -76,6 +78,44 @@ const nddo::OneElectronMatrix& MNDOMethod::getOneElectronMatrix() const {
 const nddo::TwoElectronMatrix& MNDOMethod::getTwoElectronMatrix() const {
   return mndoFock_->getTwoElectronMatrix();
 }
+
+FockMatrix& MNDOMethod::getFockMatrix() {
+  return *mndoFock_;
+}
+
+const FockMatrix& MNDOMethod::getFockMatrix() const {
+  return *mndoFock_;
+}
+
+void MNDOMethod::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  dynamic_cast<OverlapMatrix&>(*overlapCalculator_).setPeriodicCell(cell);
+  dynamic_cast<MNDORepulsionEnergy&>(*rep_).getEngine().setPeriodicCell(cell);
+  mndoFock_->setPeriodicCell(std::move(cell));
+}
+
+Eigen::Matrix3d MNDOMethod::calculateStrainDerivatives() const {
+  const auto& repulsion = dynamic_cast<const MNDORepulsionEnergy&>(*rep_);
+  return mndoFock_->getStrainDerivatives() + repulsion.getEngine().getStrainDerivatives();
+}
+
+void MNDOMethod::setFragmentDensityGuess(bool enabled, int maxFragmentSize) {
+  auto guess = FragmentDensityGuess::switchGuess(
+      densityMatrixGuess_.get(), enabled, maxFragmentSize, elementTypes_, positions_, aoIndexes_, coreCharges_,
+      nElectrons_,
+      [this]() {
+        return std::make_unique<NDDODensityGuess>(elementTypes_, mndoSettings_->getElementParameters(),
+                                                  *overlapCalculator_, nElectrons_, nAOs_);
+      },
+      [this]() {
+        auto method = std::make_unique<MNDOMethod>();
+        method->getRawParameters() = getRawParameters();
+        return method;
+      },
+      true);
+  if (guess) {
+    densityMatrixGuess_ = std::move(guess);
+  }
+}
 } // namespace nddo
 } // namespace Sparrow
 } // namespace Scine
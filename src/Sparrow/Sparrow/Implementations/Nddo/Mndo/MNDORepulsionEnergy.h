@@ -8,7 +8,7 @@
 #ifndef SPARROW_MNDOREPULSIONENERGY_H
 #define SPARROW_MNDOREPULSIONENERGY_H
 
-#include "MNDOPairwiseRepulsion.h"
+#include <Sparrow/Implementations/Nddo/Utils/CoreRepulsionEngine.h>
 #include <Utils/Scf/MethodInterfaces/RepulsionCalculator.h>
 #include <memory>
 #include <vector>
@@ -29,9 +29,6 @@ class ElementParameters;
  */
 class MNDORepulsionEnergy : public Utils::RepulsionCalculator {
  public:
-  using pairRepulsion_t = std::unique_ptr<MNDOPairwiseRepulsion>;
-  using Container = std::vector<std::vector<pairRepulsion_t>>;
-
   //! @brief Constructor.
   MNDORepulsionEnergy(const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
                       const ElementParameters& elementParameters);
@@ -51,16 +48,12 @@ class MNDORepulsionEnergy : public Utils::RepulsionCalculator {
   void addRepulsionDerivatives(
       Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const override;
 
- private:
-  template<Utils::Derivative O>
-  void addRepulsionDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
-
-  void calculatePairRepulsion(int i, int j, Utils::DerivativeOrder order);
-  void initializePair(int i, int j);
+  //! @brief Access to the engine evaluating the pair repulsions.
+  CoreRepulsionEngine& getEngine();
+  const CoreRepulsionEngine& getEngine() const;
 
-  const ElementParameters& elementParameters_;
-  Container rep_;
-  int nAtoms_;
+ private:
+  CoreRepulsionEngine engine_;
 };
 
 } // namespace nddo
@@ -12,6 +12,7 @@
 #include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISData.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMatrixCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMomentCalculator.h>
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
 #include <Sparrow/Implementations/Nddo/Utils/OneElectronMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/TwoElectronMatrix.h>
@@ -53,6 +54,15 @@ void MNDOMethodWrapper::applySettings() {
   NDDODipoleCalculator.useNDDOApproximation(useNDDOApprox);
 
   NDDOMethodWrapper::applySettings(settings_, method_);
+  // Set the mixed-precision SCF mode.
+  method_.getFockMatrix().setMixedPrecision(settings_->getBool(SparrowSettingsNames::mixedPrecisionScf),
+                                            settings_->getDouble(SparrowSettingsNames::mixedPrecisionHandOff));
+  // Set the initial density guess.
+  method_.setFragmentDensityGuess(settings_->getBool(SparrowSettingsNames::fragmentDensityGuess),
+                                  settings_->getInt(SparrowSettingsNames::maxFragmentSize));
+  method_.getFockMatrix().setPointChargeEmbedding(pointChargeEmbedding_);
+  method_.getFockMatrix().setScfAccelerator(scfAccelerator_);
+  method_.setPeriodicCell(periodicCell_);
 }
 
 std::string MNDOMethodWrapper::name() const {
@@ -85,7 +95,7 @@ const Utils::LcaoMethod& MNDOMethodWrapper::getLcaoMethod() const {
 }
 
 void MNDOMethodWrapper::calculateImpl(Utils::Derivative requiredDerivative) {
-  method_.calculate(requiredDerivative, getLog());
+  calculateScf(method_, method_.getFockMatrix(), requiredDerivative);
 }
 
 Eigen::MatrixXd MNDOMethodWrapper::getOneElectronMatrix() const {
@@ -116,9 +126,17 @@ void MNDOMethodWrapper::addElectronicContribution(std::shared_ptr<Utils::Additiv
   method_.addElectronicContribution(std::move(contribution));
 }
 
+Eigen::Matrix3d MNDOMethodWrapper::getStrainDerivatives() const {
+  return method_.calculateStrainDerivatives();
+}
+
 bool MNDOMethodWrapper::successfulCalculation() const {
   return method_.hasConverged();
 }
 
+std::vector<double> MNDOMethodWrapper::getCoreCharges() const {
+  return method_.getInitializer().getCoreCharges();
+}
+
 } /* namespace Sparrow */
 } /* namespace Scine */
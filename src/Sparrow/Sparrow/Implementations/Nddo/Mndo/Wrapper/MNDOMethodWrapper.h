@@ -52,6 +52,8 @@ class MNDOMethodWrapper final : public Utils::CloneInterface<MNDOMethodWrapper,
 
  private:
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  Eigen::Matrix3d getStrainDerivatives() const final;
   Eigen::MatrixXd getOneElectronMatrix() const final;
   Utils::SpinAdaptedMatrix getTwoElectronMatrix() const final;
 
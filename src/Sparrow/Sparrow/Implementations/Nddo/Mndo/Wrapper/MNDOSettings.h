@@ -8,6 +8,7 @@
 #ifndef SPARROW_MNDOCALCULATORSETTINGS_H
 #define SPARROW_MNDOCALCULATORSETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 
@@ -29,6 +30,11 @@ class MNDOSettings : public Scine::Utils::Settings {
     useNDDODipoleApprox.setDefaultValue(true);
     _fields.push_back(Utils::SettingsNames::NDDODipoleApproximation, std::move(useNDDODipoleApprox));
 
+    SparrowSettingPopulator::populateMixedPrecisionSettings(_fields);
+    SparrowSettingPopulator::populateScfMethodSettings(_fields, false);
+    SparrowSettingPopulator::populatePeriodicBoundarySettings(
+        _fields, "The atom pairs interact at their closest periodic image.");
+
     // Method
     Utils::UniversalSettings::StringDescriptor method("The method to be used.");
     method.setDefaultValue("mndo");
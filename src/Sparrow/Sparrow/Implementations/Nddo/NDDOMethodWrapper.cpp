@@ -9,6 +9,8 @@
 #include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISData.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMatrixCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMomentCalculator.h>
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/CalculatorBasics/PropertyList.h>
 #include <Utils/CalculatorBasics/Results.h>
 #include <Utils/DataStructures/SpinAdaptedMatrix.h>
@@ -95,6 +97,10 @@ void NDDOMethodWrapper::applySettings(std::unique_ptr<Utils::Settings>& settings
     method.setSpinMultiplicity(spinMultiplicity);
     method.setConvergenceCriteria({selfConsistenceCriterion, densityRmsdThreshold});
     method.setMaxIterations(maxScfIterations);
+    // The SCF accelerator replaces the mixer of the SCF method
+    if (scfAccelerator_->getMode() != ScfAccelerator::Mode::None) {
+      scfMixerType = Utils::scf_mixer_t::none;
+    }
     method.setScfMixer(scfMixerType);
   }
   else {
@@ -102,13 +108,43 @@ void NDDOMethodWrapper::applySettings(std::unique_ptr<Utils::Settings>& settings
   }
 }
 
-CISData NDDOMethodWrapper::getCISData() const {
+CISData NDDOMethodWrapper::getCISData() {
+  if (periodicCell_->isPeriodic()) {
+    throw std::runtime_error("Excited states are not available with periodic boundaries.");
+  }
+  restoreMethodState();
   return getCISDataImpl();
 }
 
+void NDDOMethodWrapper::calculateScf(Utils::ScfMethod& method, nddo::FockMatrix& fockMatrix,
+                                     Utils::Derivative requiredDerivative) {
+  method.calculate(requiredDerivative, getLog());
+  if (fockMatrix.endedInSinglePrecision()) {
+    // The converged density is the guess of the continued SCF cycle
+    fockMatrix.continueInDoublePrecision();
+    method.calculate(requiredDerivative, getLog());
+  }
+}
+
 bool NDDOMethodWrapper::getZPVEInclusion() const {
   return true;
 }
 
+Eigen::MatrixXd NDDOMethodWrapper::getDensityIndependentFockMatrix() const {
+  return getOneElectronMatrix().selfadjointView<Eigen::Lower>();
+}
+
+bool NDDOMethodWrapper::hasOrthogonalBasis() const {
+  return true;
+}
+
+bool NDDOMethodWrapper::supportsPointChargeEmbedding() const {
+  return true;
+}
+
+bool NDDOMethodWrapper::supportsPeriodicBoundaries() const {
+  return true;
+}
+
 } // namespace Sparrow
 } // namespace Scine
@@ -22,6 +22,9 @@ class SpinAdaptedMatrix;
 namespace Sparrow {
 class CISData;
 class DipoleMatrixCalculator;
+namespace nddo {
+class FockMatrix;
+} // namespace nddo
 
 /**
  * @class NDDOMethodWrapper
@@ -47,8 +50,9 @@ class NDDOMethodWrapper : public Utils::CloneInterface<Utils::Abstract<NDDOMetho
   /**
    * @brief This function is needed in the calcualtion of the CIS matrix in
    *        linear response method.
+   * Results restored from a snapshot first get their method state, see restoreMethodState().
    */
-  CISData getCISData() const;
+  CISData getCISData();
 
  protected:
   // Extracted method from all copy constructors and copy assignment operators.
@@ -59,6 +63,7 @@ class NDDOMethodWrapper : public Utils::CloneInterface<Utils::Abstract<NDDOMetho
     // Concurrent calling of the logger introduces race conditions
     // that eventually trigger a segfault
     instance.setStructure(*classToCopy.getStructure());
+    instance.copyPointChargeEmbedding(classToCopy);
     instance.results() = std::move(results);
     instance.loadState(classToCopy.getState());
     instance.setLog(classToCopy.getLog());
@@ -67,8 +72,18 @@ class NDDOMethodWrapper : public Utils::CloneInterface<Utils::Abstract<NDDOMetho
   virtual Utils::SpinAdaptedMatrix getTwoElectronMatrix() const = 0;
   virtual CISData getCISDataImpl() const = 0;
   void assembleResults(const std::string& description) final;
+  Eigen::MatrixXd getDensityIndependentFockMatrix() const final;
+  bool hasOrthogonalBasis() const final;
+  bool supportsPointChargeEmbedding() const final;
+  bool supportsPeriodicBoundaries() const final;
 
   void applySettings(std::unique_ptr<Utils::Settings>& settings, Utils::ScfMethod& method);
+  /**
+   * @brief Runs the SCF calculation of the method.
+   * A density obtained from a two-electron matrix in single precision is refined by a SCF cycle in double precision,
+   * so that a mixed-precision SCF always ends with at least one iteration in double precision.
+   */
+  void calculateScf(Utils::ScfMethod& method, nddo::FockMatrix& fockMatrix, Utils::Derivative requiredDerivative);
   bool getZPVEInclusion() const final;
 };
 
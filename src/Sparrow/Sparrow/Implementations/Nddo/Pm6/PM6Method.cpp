@@ -7,12 +7,14 @@
 
 #include "PM6Method.h"
 #include "PM6RepulsionEnergy.h"
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Parameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/OverlapMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDODensityGuess.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOElectronicEnergyCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
+#include <Utils/Geometry/AtomCollection.h>
 #include <Utils/Scf/LcaoUtils/LcaoUtils.h>
 #include <Utils/Scf/MethodExceptions.h>
 #include <utility>
@@ -78,6 +80,44 @@ const nddo::TwoElectronMatrix& PM6Method::getTwoElectronMatrix() const {
   return pm6Fock_->getTwoElectronMatrix();
 }
 
+FockMatrix& PM6Method::getFockMatrix() {
+  return *pm6Fock_;
+}
+
+const FockMatrix& PM6Method::getFockMatrix() const {
+  return *pm6Fock_;
+}
+
+void PM6Method::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  dynamic_cast<OverlapMatrix&>(*overlapCalculator_).setPeriodicCell(cell);
+  dynamic_cast<PM6RepulsionEnergy&>(*rep_).getEngine().setPeriodicCell(cell);
+  pm6Fock_->setPeriodicCell(std::move(cell));
+}
+
+Eigen::Matrix3d PM6Method::calculateStrainDerivatives() const {
+  const auto& repulsion = dynamic_cast<const PM6RepulsionEnergy&>(*rep_);
+  return pm6Fock_->getStrainDerivatives() + repulsion.getEngine().getStrainDerivatives();
+}
+
+void PM6Method::setFragmentDensityGuess(bool enabled, int maxFragmentSize) {
+  auto guess = FragmentDensityGuess::switchGuess(
+      densityMatrixGuess_.get(), enabled, maxFragmentSize, elementTypes_, positions_, aoIndexes_, coreCharges_,
+      nElectrons_,
+      [this]() {
+        return std::make_unique<NDDODensityGuess>(elementTypes_, pm6Settings_->getElementParameters(),
+                                                  *overlapCalculator_, nElectrons_, nAOs_);
+      },
+      [this]() {
+        auto method = std::make_unique<PM6Method>();
+        method->getRawParameters() = getRawParameters();
+        return method;
+      },
+      true);
+  if (guess) {
+    densityMatrixGuess_ = std::move(guess);
+  }
+}
+
 } // namespace nddo
 } // namespace Sparrow
 } // namespace Scine
@@ -8,7 +8,7 @@
 #ifndef SPARROW_PM6REPULSIONENERGY_H
 #define SPARROW_PM6REPULSIONENERGY_H
 
-#include <Sparrow/Implementations/Nddo/Pm6/PM6PairwiseRepulsion.h>
+#include <Sparrow/Implementations/Nddo/Utils/CoreRepulsionEngine.h>
 #include <Utils/Scf/MethodInterfaces/RepulsionCalculator.h>
 #include <Utils/Typenames.h>
 #include <memory>
@@ -32,9 +32,6 @@ class ElementPairParameters;
  */
 class PM6RepulsionEnergy : public Utils::RepulsionCalculator {
  public:
-  using pairRepulsion_t = std::unique_ptr<PM6PairwiseRepulsion>;
-  using Container = std::vector<std::vector<pairRepulsion_t>>;
-
   //! @brief Constructor.
   PM6RepulsionEnergy(const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
                      const ElementParameters& elementParameters, const ElementPairParameters& pairParameters);
@@ -55,17 +52,12 @@ class PM6RepulsionEnergy : public Utils::RepulsionCalculator {
   void addRepulsionDerivatives(
       Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const override;
 
- private:
-  template<Utils::Derivative O>
-  void addRepulsionDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
-
-  void calculatePairRepulsion(int i, int j, Utils::DerivativeOrder order);
-  void initializePair(int i, int j);
+  //! @brief Access to the engine evaluating the pair repulsions.
+  CoreRepulsionEngine& getEngine();
+  const CoreRepulsionEngine& getEngine() const;
 
-  const ElementParameters& elementParameters_;
-  const ElementPairParameters& pairParameters_;
-  Container rep_;
-  int nAtoms_;
+ private:
+  CoreRepulsionEngine engine_;
 };
 
 } // namespace nddo
@@ -12,6 +12,7 @@
 #include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISData.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMatrixCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMomentCalculator.h>
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
 #include <Sparrow/Implementations/Nddo/Utils/OneElectronMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/TwoElectronMatrix.h>
@@ -53,6 +54,15 @@ void PM6MethodWrapper::applySettings() {
   NDDODipoleCalculator.useNDDOApproximation(useNDDOApprox);
 
   NDDOMethodWrapper::applySettings(settings_, method_);
+  // Set the mixed-precision SCF mode.
+  method_.getFockMatrix().setMixedPrecision(settings_->getBool(SparrowSettingsNames::mixedPrecisionScf),
+                                            settings_->getDouble(SparrowSettingsNames::mixedPrecisionHandOff));
+  // Set the initial density guess.
+  method_.setFragmentDensityGuess(settings_->getBool(SparrowSettingsNames::fragmentDensityGuess),
+                                  settings_->getInt(SparrowSettingsNames::maxFragmentSize));
+  method_.getFockMatrix().setPointChargeEmbedding(pointChargeEmbedding_);
+  method_.getFockMatrix().setScfAccelerator(scfAccelerator_);
+  method_.setPeriodicCell(periodicCell_);
 }
 
 std::string PM6MethodWrapper::name() const {
@@ -85,7 +95,7 @@ Utils::LcaoMethod& PM6MethodWrapper::getLcaoMethod() {
 }
 
 void PM6MethodWrapper::calculateImpl(Utils::Derivative requiredDerivative) {
-  method_.calculate(requiredDerivative, getLog());
+  calculateScf(method_, method_.getFockMatrix(), requiredDerivative);
 }
 
 Eigen::MatrixXd PM6MethodWrapper::getOneElectronMatrix() const {
@@ -116,9 +126,17 @@ void PM6MethodWrapper::addElectronicContribution(std::shared_ptr<Utils::Additive
   method_.addElectronicContribution(std::move(contribution));
 }
 
+Eigen::Matrix3d PM6MethodWrapper::getStrainDerivatives() const {
+  return method_.calculateStrainDerivatives();
+}
+
 bool PM6MethodWrapper::successfulCalculation() const {
   return method_.hasConverged();
 }
 
+std::vector<double> PM6MethodWrapper::getCoreCharges() const {
+  return method_.getInitializer().getCoreCharges();
+}
+
 } /* namespace Sparrow */
 } /* namespace Scine */
@@ -52,6 +52,8 @@ class PM6MethodWrapper final : public Utils::CloneInterface<PM6MethodWrapper, ND
 
  private:
   bool successfulCalculation() const final;
+  std::vector<double> getCoreCharges() const final;
+  Eigen::Matrix3d getStrainDerivatives() const final;
   Eigen::MatrixXd getOneElectronMatrix() const final;
   Utils::SpinAdaptedMatrix getTwoElectronMatrix() const final;
 
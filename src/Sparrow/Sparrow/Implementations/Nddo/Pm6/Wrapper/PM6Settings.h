@@ -8,6 +8,7 @@
 #ifndef SPARROW_PM6SETTINGS_H
 #define SPARROW_PM6SETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingPopulator.h>
 
@@ -29,6 +30,11 @@ class PM6Settings : public Scine::Utils::Settings {
     useNDDODipoleApprox.setDefaultValue(true);
     _fields.push_back(Utils::SettingsNames::NDDODipoleApproximation, std::move(useNDDODipoleApprox));
 
+    SparrowSettingPopulator::populateMixedPrecisionSettings(_fields);
+    SparrowSettingPopulator::populateScfMethodSettings(_fields, false);
+    SparrowSettingPopulator::populatePeriodicBoundarySettings(
+        _fields, "The atom pairs interact at their closest periodic image.");
+
     // Method
     Utils::UniversalSettings::StringDescriptor method("The method to be used.");
     method.setDefaultValue("pm6");
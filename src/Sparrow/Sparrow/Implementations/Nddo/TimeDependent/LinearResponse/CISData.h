@@ -15,6 +15,9 @@
 #include <Utils/DataStructures/SingleParticleEnergies.h>
 namespace Scine {
 namespace Sparrow {
+namespace nddo {
+class FockMatrix;
+} // namespace nddo
 
 /**
  * @brief This class contains the infos needed to perform a CIS calculation.
@@ -24,6 +27,8 @@ namespace Sparrow {
 struct CISData : public LinearResponseData {
   const nddo::OneCenterIntegralContainer& oneCenterIntegrals;
   const nddo::TwoCenterIntegralContainer& twoCenterIntegrals;
+  //! The Fock matrix of the reference calculation, for the derivatives of the excited states.
+  const nddo::FockMatrix& fockMatrix;
 
   /**
    * @brief Constructor for an instance of the CISData struct.
@@ -35,15 +40,17 @@ struct CISData : public LinearResponseData {
    * @param elements
    * @param occupation
    * @param overlapMatrix
+   * @param referenceFockMatrix
    */
   CISData(const nddo::OneCenterIntegralContainer& oneCenterIntegralContainer,
           const nddo::TwoCenterIntegralContainer& twoCenterIntegralContainer, const Utils::MolecularOrbitals& MOs,
           const Utils::SingleParticleEnergies& orbitalEnergies, Utils::AtomsOrbitalsIndexes aoIndex,
           const Utils::ElementTypeCollection& elements, const Utils::LcaoUtils::ElectronicOccupation& occupation,
-          const Eigen::MatrixXd& overlapMatrix)
+          const Eigen::MatrixXd& overlapMatrix, const nddo::FockMatrix& referenceFockMatrix)
     : LinearResponseData(MOs, orbitalEnergies, std::move(aoIndex), elements, occupation, overlapMatrix),
       oneCenterIntegrals(oneCenterIntegralContainer),
-      twoCenterIntegrals(twoCenterIntegralContainer) {
+      twoCenterIntegrals(twoCenterIntegralContainer),
+      fockMatrix(referenceFockMatrix) {
   }
 
   template<class NDDOMethod>
@@ -51,7 +58,8 @@ struct CISData : public LinearResponseData {
     return CISData(method.getTwoElectronMatrix().getOneCenterIntegrals(),
                    method.getTwoElectronMatrix().getTwoCenterIntegrals(), method.getMolecularOrbitals(),
                    method.getSingleParticleEnergies(), method.getInitializer().getAtomsOrbitalsIndexes(),
-                   method.getElementTypes(), method.getElectronicOccupation(), method.getOverlapMatrix());
+                   method.getElementTypes(), method.getElectronicOccupation(), method.getOverlapMatrix(),
+                   method.getFockMatrix());
   }
 };
 
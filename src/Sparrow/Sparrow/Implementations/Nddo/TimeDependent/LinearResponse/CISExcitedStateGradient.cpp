@@ -0,0 +1,116 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#include "CISExcitedStateGradient.h"
+#include "CISMatrixAOFockBuilderFactory.h"
+#include "CISPseudoDensityBuilder.h"
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+CISExcitedStateGradient::CISExcitedStateGradient(const CISData& cisData, const ExcitedStatesParam& excitedStatesParam,
+                                                 Utils::SpinTransition spinBlock,
+                                                 const CISIntegralStorage& integralStorage)
+  : cisData_(cisData) {
+  if (cisData_.occupation.isUnrestricted()) {
+    throw std::runtime_error("CIS excited-state gradients are only available for restricted references.");
+  }
+  const bool singlet = spinBlock == Utils::SpinTransition::Singlet;
+  coulombFactor_ = singlet ? 2.0 * excitedStatesParam.c1 : 0.0;
+  exchangeFactor_ = excitedStatesParam.c2;
+  // The orbital Hessian always holds the unscaled singlet pseudo-Fock matrix of the reference.
+  singletFockBuilder_ = CISMatrixAOFockBuilderFactory<Utils::Reference::Restricted>::createAOFockBuilder(
+      Utils::SpinTransition::Singlet, cisData_, ExcitedStatesParam{}, integralStorage);
+  if (singlet && excitedStatesParam.c1 == 1.0 && excitedStatesParam.c2 == 1.0) {
+    scaledFockBuilder_ = singletFockBuilder_;
+  }
+  else {
+    scaledFockBuilder_ = CISMatrixAOFockBuilderFactory<Utils::Reference::Restricted>::createAOFockBuilder(
+        spinBlock, cisData_, excitedStatesParam, integralStorage);
+  }
+
+  CISPseudoDensityBuilder<Utils::Reference::Restricted> orbitals(cisData_.molecularOrbitals, cisData_.occupation);
+  occupiedOrbitals_ = orbitals.getOccupiedOrbitals().restricted;
+  virtualOrbitals_ = orbitals.getVirtualOrbitals().restricted;
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::VectorXd> energyDifferenceVector;
+  TimeDependentUtils::generateEnergyDifferenceVector(cisData_.MOEnergies, cisData_.occupation, energyDifferenceVector);
+  energyDifferences_ = Eigen::Map<const Eigen::MatrixXd>(energyDifferenceVector.restricted.data(),
+                                                         virtualOrbitals_.cols(), occupiedOrbitals_.cols());
+  zVectorSolver_ = std::make_unique<ZVectorSolver>(energyDifferences_);
+
+  // The response densities are not sparse, all atom pairs are contracted.
+  const int nAtoms = cisData_.AOInfo.getNAtoms();
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    std::vector<int> connectedAtoms;
+    for (int atomJ = atomI + 1; atomJ < nAtoms; ++atomJ) {
+      connectedAtoms.push_back(atomJ);
+    }
+    atomPairList_.insert({atomI, std::move(connectedAtoms)});
+  }
+}
+
+CISExcitedStateGradient::~CISExcitedStateGradient() = default;
+
+Utils::GradientCollection CISExcitedStateGradient::calculate(const Eigen::VectorXd& eigenvector) const {
+  const Eigen::MatrixXd& occupied = occupiedOrbitals_;
+  const Eigen::MatrixXd& virtuals = virtualOrbitals_;
+  assert(eigenvector.size() == virtuals.cols() * occupied.cols());
+  const Eigen::VectorXd normalized = eigenvector.normalized();
+  const Eigen::Map<const Eigen::MatrixXd> X(normalized.data(), virtuals.cols(), occupied.cols());
+
+  const Eigen::MatrixXd transitionDensity = virtuals * X * occupied.transpose();
+  const Eigen::MatrixXd differenceDensity = virtuals * (X * X.transpose()) * virtuals.transpose() -
+                                            occupied * (X.transpose() * X) * occupied.transpose();
+
+  // The pseudo-density of the builders is the transpose of T, the scaled pseudo-Fock matrix is M = c J(T) - x K(T).
+  const Eigen::MatrixXd M = pseudoFock(*scaledFockBuilder_, transitionDensity.transpose());
+  const Eigen::MatrixXd differenceFock = pseudoFock(*singletFockBuilder_, differenceDensity);
+  const Eigen::MatrixXd lagrangian =
+      2.0 * virtuals.transpose() * differenceFock * occupied +
+      2.0 * (virtuals.transpose() * M.transpose() * virtuals * X - X * occupied.transpose() * M.transpose() * occupied);
+  const Eigen::MatrixXd z =
+      zVectorSolver_->solve(lagrangian, [this](const Eigen::MatrixXd& vector) { return hessianProduct(vector); });
+
+  const Eigen::MatrixXd zResponse = virtuals * z * occupied.transpose();
+  const Eigen::MatrixXd relaxedDensity = differenceDensity + 0.5 * (zResponse + zResponse.transpose());
+  const Eigen::MatrixXd referenceDensity = 2.0 * occupied * occupied.transpose();
+
+  Utils::GradientCollection gradients = Utils::GradientCollection::Zero(cisData_.AOInfo.getNAtoms(), 3);
+  cisData_.fockMatrix.addOneElectronDerivatives(gradients, relaxedDensity);
+  const auto& twoElectronMatrix = cisData_.fockMatrix.getTwoElectronMatrix();
+  twoElectronMatrix.addDerivatives<Utils::Derivative::First>(gradients, relaxedDensity, referenceDensity, 1.0, 0.5);
+  twoElectronMatrix.addDerivatives<Utils::Derivative::First>(gradients, transitionDensity, transitionDensity,
+                                                             coulombFactor_, exchangeFactor_);
+  return gradients;
+}
+
+int CISExcitedStateGradient::getNumberOfZVectorIterations() const {
+  return zVectorSolver_->getNumberOfIterations();
+}
+
+Eigen::MatrixXd
+CISExcitedStateGradient::pseudoFock(const CISMatrixAOFockBuilderBase<Utils::Reference::Restricted>& builder,
+                                    const Eigen::MatrixXd& pseudoDensity) const {
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> density;
+  density.restricted = pseudoDensity;
+  return builder.getAOFock(density, atomPairList_).restricted;
+}
+
+Eigen::MatrixXd CISExcitedStateGradient::hessianProduct(const Eigen::MatrixXd& z) const {
+  // F(Z) + F(Z)^T is independent of the transposition convention of the pseudo-density of the builder.
+  const Eigen::MatrixXd fock =
+      pseudoFock(*singletFockBuilder_, occupiedOrbitals_ * z.transpose() * virtualOrbitals_.transpose());
+  return energyDifferences_.cwiseProduct(z) +
+         virtualOrbitals_.transpose() * (fock + fock.transpose()) * occupiedOrbitals_;
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_CISEXCITEDSTATEGRADIENT_H
+#define SPARROW_CISEXCITEDSTATEGRADIENT_H
+
+#include "CISData.h"
+#include "CISIntegralArena.h"
+#include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
+#include <Sparrow/Implementations/TimeDependent/ZVectorSolver.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+template<Utils::Reference restrictedness>
+class CISMatrixAOFockBuilderBase;
+
+/**
+ * @brief Analytical gradient of a CIS-NDDO excitation energy of a restricted reference, with the Z-vector method.
+ *
+ * With the amplitudes X(a, i) of a root, T = C_vir X C_occ^T and the unrelaxed difference density
+ * D = C_vir X X^T C_vir^T - C_occ X^T X C_occ^T, the orbital response is folded into the solution z of the Z-vector
+ * equations (e_a - e_i) z_ai + [C_vir^T (F(Z) + F(Z)^T) C_occ]_ai = -L_ai, with Z = C_vir z C_occ^T and F the singlet
+ * pseudo-Fock matrix 2 J - K. The Lagrangian L collects the orbital derivatives of the excitation energy,
+ * L = 2 C_vir^T F(D) C_occ + 2 (C_vir^T M^T C_vir X - X C_occ^T M^T C_occ), with M the scaled pseudo-Fock matrix of T.
+ * The equations are solved by conjugate gradients, preconditioned by the orbital energy differences.
+ *
+ * The basis is orthogonal, so the excitation energy depends on the positions through the one-electron matrix and
+ * the two-center integrals only. Its gradient is the derivative of tr(H P) with the relaxed difference density
+ * P = D + (Z + Z^T) / 2, of the Coulomb and exchange interaction of P with the density of the reference, and of the
+ * Coulomb and exchange terms of T scaled as in the CIS matrix.
+ * @pre The reference calculation is converged tightly and its last calculation included the gradients, such that
+ *      the derivatives of the integrals are available.
+ */
+class CISExcitedStateGradient {
+ public:
+  /**
+   * @param cisData The data of the reference calculation.
+   * @param excitedStatesParam The scaling of the Coulomb and exchange terms of the CIS matrix.
+   * @param spinBlock The spin block of the roots, singlet or triplet.
+   * @param integralStorage The storage of the integrals of the pseudo-Fock builders.
+   */
+  CISExcitedStateGradient(const CISData& cisData, const ExcitedStatesParam& excitedStatesParam,
+                          Utils::SpinTransition spinBlock, const CISIntegralStorage& integralStorage = {});
+  ~CISExcitedStateGradient();
+
+  /**
+   * @brief Gradient of the excitation energy of a root with respect to the positions of the atoms.
+   * @param eigenvector The CIS eigenvector of the root in standard order (vir fast index, occ slow index).
+   */
+  Utils::GradientCollection calculate(const Eigen::VectorXd& eigenvector) const;
+  //! @brief Number of conjugate gradient iterations of the Z-vector equations in the last call to calculate().
+  int getNumberOfZVectorIterations() const;
+
+ private:
+  // Pseudo-Fock matrix of the AO pseudo-density with the given builder.
+  Eigen::MatrixXd pseudoFock(const CISMatrixAOFockBuilderBase<Utils::Reference::Restricted>& builder,
+                             const Eigen::MatrixXd& pseudoDensity) const;
+  // Product of the orbital Hessian of the Z-vector equations with z.
+  Eigen::MatrixXd hessianProduct(const Eigen::MatrixXd& z) const;
+
+  CISData cisData_;
+  std::shared_ptr<CISMatrixAOFockBuilderBase<Utils::Reference::Restricted>> singletFockBuilder_, scaledFockBuilder_;
+  Eigen::MatrixXd occupiedOrbitals_, virtualOrbitals_;
+  // Orbital energy differences e_a - e_i as a (virtual x occupied) matrix.
+  Eigen::MatrixXd energyDifferences_;
+  std::map<int, std::vector<int>> atomPairList_;
+  double coulombFactor_;
+  double exchangeFactor_;
+  std::unique_ptr<ZVectorSolver> zVectorSolver_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_CISEXCITEDSTATEGRADIENT_H
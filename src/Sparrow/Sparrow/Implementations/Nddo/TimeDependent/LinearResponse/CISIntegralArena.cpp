@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "CISIntegralArena.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#  define SPARROW_CIS_MMAP
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+std::vector<std::size_t> blockOffsets(const std::vector<int>& rows, const std::vector<int>& cols) {
+  assert(rows.size() == cols.size());
+  std::vector<std::size_t> offsets(rows.size() + 1);
+  offsets[0] = 0;
+  for (std::size_t b = 0; b < rows.size(); ++b) {
+    offsets[b + 1] = offsets[b] + static_cast<std::size_t>(rows[b]) * static_cast<std::size_t>(cols[b]);
+  }
+  return offsets;
+}
+} // namespace
+
+CISIntegralArena::~CISIntegralArena() {
+  clear();
+}
+
+int CISIntegralArena::numberOfPairs(int nAtoms) {
+  return nAtoms * (nAtoms - 1) / 2;
+}
+
+std::size_t CISIntegralArena::numberOfElements(const std::vector<int>& rows, const std::vector<int>& cols) {
+  return blockOffsets(rows, cols).back();
+}
+
+void CISIntegralArena::allocate(const std::vector<int>& rows, const std::vector<int>& cols) {
+  clear();
+  rows_ = rows;
+  cols_ = cols;
+  offsets_ = blockOffsets(rows, cols);
+  buffer_.assign(offsets_.back(), 0.0);
+  buffer_.shrink_to_fit();
+  data_ = buffer_.data();
+}
+
+void CISIntegralArena::allocateOutOfCore(const std::vector<int>& rows, const std::vector<int>& cols,
+                                         const std::string& scratchDirectory) {
+#ifdef SPARROW_CIS_MMAP
+  clear();
+  rows_ = rows;
+  cols_ = cols;
+  offsets_ = blockOffsets(rows, cols);
+  const std::size_t size = offsets_.back() * sizeof(double);
+  if (size == 0) {
+    return;
+  }
+  std::string directory = scratchDirectory;
+  if (directory.empty()) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    directory = tmpdir ? tmpdir : "/tmp";
+  }
+  std::string filename = directory + "/sparrow-cis-XXXXXX";
+  int fd = ::mkstemp(&filename[0]);
+  if (fd < 0) {
+    throw std::runtime_error("CISIntegralArena: cannot create a scratch file in " + directory + ".");
+  }
+  // The file is removed from the directory right away and freed by the system once it is unmapped.
+  ::unlink(filename.c_str());
+  // The extended file reads as zeros and only takes disk space when written.
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    ::close(fd);
+    throw std::runtime_error("CISIntegralArena: cannot extend the scratch file in " + directory + ".");
+  }
+  void* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (address == MAP_FAILED) {
+    throw std::runtime_error("CISIntegralArena: cannot map the scratch file in " + directory + ".");
+  }
+  data_ = static_cast<double*>(address);
+  mappedBytes_ = size;
+#else
+  (void)rows;
+  (void)cols;
+  (void)scratchDirectory;
+  throw std::runtime_error("CISIntegralArena: out-of-core integral storage is not available on this platform.");
+#endif
+}
+
+void CISIntegralArena::clear() {
+#ifdef SPARROW_CIS_MMAP
+  if (mappedBytes_ > 0) {
+    ::munmap(data_, mappedBytes_);
+  }
+#endif
+  mappedBytes_ = 0;
+  data_ = nullptr;
+  std::vector<double>().swap(buffer_);
+  offsets_.clear();
+  rows_.clear();
+  cols_.clear();
+}
+
+int CISIntegralArena::getNumberOfBlocks() const {
+  return static_cast<int>(rows_.size());
+}
+
+bool CISIntegralArena::isOutOfCore() const {
+  return mappedBytes_ > 0;
+}
+
+bool CISIntegralArena::pageRange(int first, int last, bool outwards, char*& begin, std::size_t& length) const {
+#ifdef SPARROW_CIS_MMAP
+  if (!isOutOfCore() || first >= last) {
+    return false;
+  }
+  static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  std::size_t start = offsets_[first] * sizeof(double);
+  std::size_t end = offsets_[last] * sizeof(double);
+  if (outwards) {
+    start = start / pageSize * pageSize;
+    end = std::min((end + pageSize - 1) / pageSize * pageSize, mappedBytes_);
+  }
+  else {
+    // Pages shared with the neighbouring blocks may still be in use.
+    start = (start + pageSize - 1) / pageSize * pageSize;
+    end = end / pageSize * pageSize;
+  }
+  if (start >= end) {
+    return false;
+  }
+  begin = reinterpret_cast<char*>(data_) + start;
+  length = end - start;
+  return true;
+#else
+  (void)first;
+  (void)last;
+  (void)outwards;
+  (void)begin;
+  (void)length;
+  return false;
+#endif
+}
+
+void CISIntegralArena::prefetch(int first, int last) const {
+#ifdef SPARROW_CIS_MMAP
+  char* begin;
+  std::size_t length;
+  if (pageRange(first, last, true, begin, length)) {
+    ::madvise(begin, length, MADV_WILLNEED);
+  }
+#else
+  (void)first;
+  (void)last;
+#endif
+}
+
+void CISIntegralArena::release(int first, int last) const {
+#ifdef SPARROW_CIS_MMAP
+  char* begin;
+  std::size_t length;
+  // Pages of a shared file mapping are written back to the file, not discarded.
+  if (pageRange(first, last, false, begin, length)) {
+    ::madvise(begin, length, MADV_DONTNEED);
+  }
+#else
+  (void)first;
+  (void)last;
+#endif
+}
+
+std::size_t CISIntegralArena::getMemory() const {
+  return buffer_.capacity() * sizeof(double) + offsets_.capacity() * sizeof(std::size_t) +
+         (rows_.capacity() + cols_.capacity()) * sizeof(int);
+}
+
+std::size_t CISIntegralArena::getScratchSize() const {
+  return mappedBytes_;
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_CISINTEGRALARENA_H
+#define SPARROW_CISINTEGRALARENA_H
+
+#include <Eigen/Core>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Storage mode of the two-center integral blocks of the CIS AO Fock builder.
+ */
+struct CISIntegralStorage {
+  enum class Mode {
+    //! The blocks are stored on the heap.
+    InMemory,
+    //! The blocks are stored in a memory-mapped scratch file.
+    OutOfCore,
+    //! No block is stored, the integrals are contracted from the two-center integral container.
+    Direct
+  };
+  Mode mode = Mode::InMemory;
+  //! Directory of the scratch file, the system temporary directory if empty.
+  std::string scratchDirectory;
+  //! Integral-direct, atom pairs whose largest contribution to the pseudo-Fock matrix is below are skipped.
+  double screeningThreshold = 1e-10;
+};
+
+/**
+ * @brief Contiguous storage of the integral blocks of the CIS AO Fock builder.
+ *
+ * All blocks live in a single buffer. The offset of every block is computed once from the block shapes, so a block is
+ * accessed by its index without any lookup or per-block heap allocation. Blocks are indexed either by atom for the
+ * one-center integrals or by pairIndex() for the two-center integrals of the atom pairs I < J. Blocks of different
+ * indices do not overlap and can be filled concurrently.
+ *
+ * Out of core, the buffer is a shared mapping of a scratch file, which is unlinked as soon as it is mapped. The
+ * blocks of the pairs (I, J > I) form a contiguous tile of the file, so that the pages of an atom can be read ahead
+ * with prefetch() before they are contracted and dropped from the resident memory with release() afterwards.
+ */
+class CISIntegralArena {
+ public:
+  CISIntegralArena() = default;
+  ~CISIntegralArena();
+  CISIntegralArena(const CISIntegralArena&) = delete;
+  CISIntegralArena& operator=(const CISIntegralArena&) = delete;
+
+  //! @brief Index of the atom pair I < J in the row-wise upper triangle of the atom pairs.
+  static int pairIndex(int atomI, int atomJ, int nAtoms);
+  //! @brief Index of the first pair (I, J > I), the pairs of atom I are the next nAtoms - I - 1 indices.
+  static int firstPairIndex(int atomI, int nAtoms);
+  //! @brief Number of atom pairs I < J.
+  static int numberOfPairs(int nAtoms);
+  //! @brief Number of doubles of the blocks with the given shapes.
+  static std::size_t numberOfElements(const std::vector<int>& rows, const std::vector<int>& cols);
+
+  /**
+   * @brief Allocates zero-initialized blocks of shape rows[b] x cols[b], replacing the current blocks.
+   */
+  void allocate(const std::vector<int>& rows, const std::vector<int>& cols);
+  /**
+   * @brief Allocates zero-initialized blocks in a memory-mapped scratch file, replacing the current blocks.
+   * @throws std::runtime_error if the scratch file cannot be created or mapped, or if memory mapping is not
+   *         available on the platform.
+   */
+  void allocateOutOfCore(const std::vector<int>& rows, const std::vector<int>& cols,
+                         const std::string& scratchDirectory);
+  //! @brief Frees the blocks and unmaps the scratch file.
+  void clear();
+  Eigen::Map<Eigen::MatrixXd> block(int index);
+  Eigen::Map<const Eigen::MatrixXd> block(int index) const;
+  int getNumberOfBlocks() const;
+  bool isOutOfCore() const;
+  /**
+   * @brief Starts reading the blocks [first, last) from the scratch file. Does nothing for blocks in memory.
+   */
+  void prefetch(int first, int last) const;
+  /**
+   * @brief Drops the pages of the blocks [first, last) from the resident memory, written blocks are kept in the
+   * scratch file. Does nothing for blocks in memory.
+   */
+  void release(int first, int last) const;
+  //! @brief Heap memory of the stored integrals in bytes, the mapped scratch file is not included.
+  std::size_t getMemory() const;
+  //! @brief Size of the scratch file in bytes, 0 for blocks in memory.
+  std::size_t getScratchSize() const;
+
+ private:
+  // Page-aligned address range of the blocks [first, last), widened to whole pages if outwards is true
+  bool pageRange(int first, int last, bool outwards, char*& begin, std::size_t& length) const;
+  std::vector<double> buffer_;
+  double* data_ = nullptr;
+  std::size_t mappedBytes_ = 0;
+  // Offset of block b in data_, with offsets_[nBlocks] the total size
+  std::vector<std::size_t> offsets_;
+  std::vector<int> rows_;
+  std::vector<int> cols_;
+};
+
+inline int CISIntegralArena::firstPairIndex(int atomI, int nAtoms) {
+  return atomI * (2 * nAtoms - atomI - 1) / 2;
+}
+
+inline int CISIntegralArena::pairIndex(int atomI, int atomJ, int nAtoms) {
+  assert(atomI < atomJ && atomJ < nAtoms);
+  return firstPairIndex(atomI, nAtoms) + atomJ - atomI - 1;
+}
+
+inline Eigen::Map<Eigen::MatrixXd> CISIntegralArena::block(int index) {
+  return Eigen::Map<Eigen::MatrixXd>(data_ + offsets_[index], rows_[index], cols_[index]);
+}
+
+inline Eigen::Map<const Eigen::MatrixXd> CISIntegralArena::block(int index) const {
+  return Eigen::Map<const Eigen::MatrixXd>(data_ + offsets_[index], rows_[index], cols_[index]);
+}
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_CISINTEGRALARENA_H
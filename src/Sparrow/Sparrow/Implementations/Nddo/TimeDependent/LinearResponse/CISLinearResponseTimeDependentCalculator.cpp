@@ -6,19 +6,26 @@
  */
 /* Internal dependencies */
 #include "CISLinearResponseTimeDependentCalculator.h"
+#include "CISExcitedStateGradient.h"
+#include "CISMatrixAOFockBuilderFactory.h"
 #include "CISSettings.h"
 #include "CISSpinContaminator.h"
 #include <Sparrow/Implementations/Exceptions.h>
 #include <Sparrow/Implementations/Nddo/NDDOMethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/DipoleMatrixMOTransformer.h>
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/Global2c2eMatrix.h>
+#include <Sparrow/Implementations/TimeDependent/DavidsonGuessBuilder.h>
 #include <Sparrow/Implementations/TimeDependent/DiagonalPreconditionerEvaluator.h>
+#include <Sparrow/Implementations/TimeDependent/RootConvergenceMonitor.h>
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
+#include <Sparrow/StatesHandling/SparrowCheckpoint.h>
 #include <Utils/IO/NativeFilenames.h>
 /* External dependencies */
 #include <Core/Interfaces/Calculator.h>
 #include <Core/Log.h>
 #include <Utils/CalculatorBasics.h>
 #include <Utils/CalculatorBasics/PropertyList.h>
+#include <Utils/DataStructures/DipoleMatrix.h>
 #include <Utils/Constants.h>
 #include <Utils/Math/IterativeDiagonalizer/DavidsonDiagonalizer.h>
 #include <Utils/Math/IterativeDiagonalizer/DiagonalizerSettings.h>
@@ -58,14 +65,43 @@ const Utils::Results& CISLinearResponseTimeDependentCalculator::results() const
 void CISLinearResponseTimeDependentCalculator::referenceCalculation() {
   if (!nddoMethod_)
     throw MissingReferenceCalculatorException();
-  if (nddoMethod_->settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion) > 1e-8) {
-    nddoMethod_->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-8);
+  // Only the occupied-virtual block of the MO dipole matrix is needed, it is transformed from the AO one.
+  // The gradients are kept if they were required, they are needed for the gradients of the excited states.
+  const bool gradientsRequired = nddoMethod_->getRequiredProperties().containsSubSet(Utils::Property::Gradients);
+  // The integrals and orbitals of a reference that is converged tightly already are used as they are.
+  if (hasConvergedReference(gradientsRequired)) {
+    cisData_ = std::make_unique<CISData>(nddoMethod_->getCISData());
+    return;
   }
-  nddoMethod_->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixMO);
+  if (nddoMethod_->settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion) > referenceConvergence_) {
+    nddoMethod_->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, referenceConvergence_);
+  }
+  Utils::PropertyList requiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixAO);
+  if (gradientsRequired) {
+    requiredProperties.addProperty(Utils::Property::Gradients);
+  }
+  nddoMethod_->setRequiredProperties(requiredProperties);
   nddoMethod_->calculate("CIS reference calculation.");
   cisData_ = std::make_unique<CISData>(nddoMethod_->getCISData());
 }
 
+bool CISLinearResponseTimeDependentCalculator::hasConvergedReference(bool gradientsRequired) const {
+  // The results of the reference are reset whenever its structure changes, so they belong to the current structure.
+  const auto& referenceResults = nddoMethod_->results();
+  if (!referenceResults.has<Utils::Property::SuccessfulCalculation>() ||
+      !referenceResults.get<Utils::Property::SuccessfulCalculation>()) {
+    return false;
+  }
+  // The settings may have changed since the calculation, the criterion and state it was done with count
+  if (!nddoMethod_->resultsMatchSettings() || nddoMethod_->getResultsConvergenceCriterion() > referenceConvergence_) {
+    return false;
+  }
+  bool dipoleMatrixAvailable = referenceResults.has<Utils::Property::DipoleMatrixAO>() ||
+                               referenceResults.has<Utils::Property::DipoleMatrixMO>();
+  return referenceResults.has<Utils::Property::Energy>() && dipoleMatrixAvailable &&
+         (!gradientsRequired || referenceResults.has<Utils::Property::Gradients>());
+}
+
 Core::Calculator& CISLinearResponseTimeDependentCalculator::getReferenceCalculator() {
   return *nddoMethod_;
 }
@@ -122,6 +158,23 @@ inline int getNConfigurations(Utils::SpinAdaptedContainer<Utils::Reference::Unre
   return energyDiffVector.alpha.size() + energyDiffVector.beta.size();
 }
 
+// Whether the configurations in energy order are beta excitations, empty in the restricted case.
+inline Eigen::Matrix<bool, -1, 1>
+getIsBeta(const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::VectorXd>& /*energyDiffVector*/,
+          const std::vector<int>& /*orderMap*/) {
+  return {};
+}
+inline Eigen::Matrix<bool, -1, 1>
+getIsBeta(const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::VectorXd>& energyDiffVector,
+          const std::vector<int>& orderMap) {
+  Eigen::Matrix<bool, -1, 1> isBetaInStandardOrder(energyDiffVector.alpha.size() + energyDiffVector.beta.size());
+  isBetaInStandardOrder.head(energyDiffVector.alpha.size()).setConstant(false);
+  isBetaInStandardOrder.tail(energyDiffVector.beta.size()).setConstant(true);
+  Eigen::Matrix<bool, -1, 1> isBeta;
+  TimeDependentUtils::transformOrder(isBetaInStandardOrder, isBeta, orderMap, TimeDependentUtils::Direction::To);
+  return isBeta;
+}
+
 template<Utils::Reference restrictedness>
 Utils::ElectronicTransitionResult
 CISLinearResponseTimeDependentCalculator::solve(Utils::SpinAdaptedContainer<restrictedness, Eigen::VectorXd> energyDifferenceVector,
@@ -138,7 +191,40 @@ CISLinearResponseTimeDependentCalculator::solve(Utils::SpinAdaptedContainer<rest
     initialSubspaceDimension = numberOfEnergyLevels;
   }
 
-  checkMemoryRequirement(nConfigurations, numberOfEnergyLevels);
+  const auto integralStorage = checkMemoryRequirement<restrictedness>(nConfigurations, numberOfEnergyLevels, spinBlock);
+
+  auto sigmaVectorEvaluator = std::make_unique<CISSigmaVectorEvaluator<restrictedness>>(
+      *cisData_, excitedStatesParam_, energyDifferenceVector, integralsThresholds_, orderMap_, spinBlock,
+      integralStorage);
+
+  // The guess and the preconditioner from the diagonal including the coupling, unless given or asked otherwise
+  const std::string guessType = settings_->getString("davidson_guess");
+  const bool coupledPreconditioner = settings_->getString("preconditioner") == "coupled_diagonal";
+  const bool guessFromDiagonal = !guess_ && guessType != "energy_differences";
+  Eigen::VectorXd diagonal;
+  if (coupledPreconditioner || guessFromDiagonal) {
+    diagonal = sigmaVectorEvaluator->diagonal();
+  }
+  Eigen::MatrixXd guessVectors;
+  if (guessFromDiagonal) {
+    const auto isBeta = getIsBeta(energyDifferenceVector, orderMap_);
+    if (guessType == "subspace") {
+      int subspaceDimension = settings_->getInt("guess_subspace_dimension");
+      if (subspaceDimension == 0) {
+        subspaceDimension = DavidsonGuessBuilder::defaultSubspaceDimension(initialSubspaceDimension, nConfigurations);
+      }
+      guessVectors = DavidsonGuessBuilder::subspaceGuess(*sigmaVectorEvaluator, diagonal, initialSubspaceDimension,
+                                                         subspaceDimension, isBeta);
+    }
+    else {
+      guessVectors = DavidsonGuessBuilder::diagonalGuess(diagonal, initialSubspaceDimension, isBeta);
+    }
+    // Degenerate configurations can extend the diagonal guess.
+    initialSubspaceDimension = guessVectors.cols();
+  }
+  else {
+    guessVectors = generateGuess(nConfigurations, initialSubspaceDimension, guess_, spinBlock, restrictedness);
+  }
 
   Utils::NonOrthogonalDavidson diagonalizer(numberOfEnergyLevels, nConfigurations);
   diagonalizer.settings().modifyInt(Utils::initialGuessDimensionOption, initialSubspaceDimension);
@@ -148,15 +234,27 @@ CISLinearResponseTimeDependentCalculator::solve(Utils::SpinAdaptedContainer<rest
     diagonalizer.settings().modifyInt(Utils::SettingsNames::maxDavidsonIterations,
                                       settings_->getInt(Utils::SettingsNames::maxDavidsonIterations));
   }
-  diagonalizer.setGuess(generateGuess(nConfigurations, initialSubspaceDimension, guess_, spinBlock, restrictedness));
+  diagonalizer.setGuess(std::move(guessVectors));
 
-  diagonalizer.setPreconditionerEvaluator(
-      std::make_unique<DiagonalPreconditionerEvaluator>(energyDifferenceVector, OrderTag{}));
-  diagonalizer.setSigmaVectorEvaluator(std::make_unique<CISSigmaVectorEvaluator<restrictedness>>(
-      *cisData_, excitedStatesParam_, energyDifferenceVector, integralsThresholds_, orderMap_, spinBlock));
+  if (coupledPreconditioner) {
+    diagonalizer.setPreconditionerEvaluator(std::make_unique<DiagonalPreconditionerEvaluator>(diagonal));
+  }
+  else {
+    diagonalizer.setPreconditionerEvaluator(
+        std::make_unique<DiagonalPreconditionerEvaluator>(energyDifferenceVector, OrderTag{}));
+  }
+  auto& convergenceIterations = restrictedness == Utils::Reference::Unrestricted ? iterationCounts_.unrestricted
+                                : spinBlock == Utils::SpinTransition::Singlet   ? iterationCounts_.singlet
+                                                                                : iterationCounts_.triplet;
+  auto monitor = std::make_unique<RootConvergenceMonitor>(std::move(sigmaVectorEvaluator), numberOfEnergyLevels,
+                                                          settings_->getDouble(convergence), convergenceIterations);
+  const auto* rootConvergenceMonitor = monitor.get();
+  diagonalizer.setSigmaVectorEvaluator(std::move(monitor));
 
   Utils::ElectronicTransitionResult excitedStates;
   excitedStates.eigenStates = diagonalizer.solve(getLog());
+  rootConvergenceMonitor->finalize();
+  rootConvergenceMonitor->print(getLog());
 
   generateTransitionDipoleMoments<restrictedness>(excitedStates, *cisData_, spinBlock);
 
@@ -168,10 +266,12 @@ CISLinearResponseTimeDependentCalculator::solve(Utils::SpinAdaptedContainer<rest
   return excitedStates;
 }
 
-void CISLinearResponseTimeDependentCalculator::checkMemoryRequirement(int excitationsDim, int numberOfEnergyLevels) {
+template<Utils::Reference restrictedness>
+CISIntegralStorage CISLinearResponseTimeDependentCalculator::checkMemoryRequirement(int excitationsDim,
+                                                                                    int numberOfEnergyLevels,
+                                                                                    Utils::SpinTransition spinBlock) {
   double memRequ = 0.;
   double maxMem = settings_->getDouble(Utils::SettingsNames::maxMemory);
-  int nAtoms = cisData_->AOInfo.getNAtoms();
   int maxSubspaceDim = 0;
   if (numberOfEnergyLevels < 1000) { // Formula for good number of iterations before subspace collapse.
     maxSubspaceDim = static_cast<int>((6 * numberOfEnergyLevels + 50) - pow(numberOfEnergyLevels, 1.2));
@@ -181,23 +281,36 @@ void CISLinearResponseTimeDependentCalculator::checkMemoryRequirement(int excita
     maxSubspaceDim = 2 * numberOfEnergyLevels;
   }
 
-  memRequ += static_cast<double>(maxSubspaceDim * excitationsDim * 2);
-
-  for (int i = 0; i < nAtoms; ++i) {
-    int nAOsI = cisData_->AOInfo.getNOrbitals(i);
-    memRequ += static_cast<double>(std::pow(nAOsI, 4));
-    for (int j = i + 1; j < nAtoms; ++j) {
-      int nAOsJ = cisData_->AOInfo.getNOrbitals(j);
-      memRequ += static_cast<double>(nAOsI * nAOsI * nAOsJ * nAOsJ);
-    }
+  memRequ += static_cast<double>(maxSubspaceDim) * excitationsDim * 2 * sizeof(double) * 1.e-9;
+  // Footprint of the integral storage of the AO Fock builder, out of core only if needed in the automatic mode
+  CISIntegralStorage integralStorage;
+  integralStorage.scratchDirectory = settings_->getString("scratch_directory");
+  integralStorage.screeningThreshold = settings_->getDouble("direct_screening_threshold");
+  const std::string storageMode = settings_->getString("integral_storage");
+  double integralMemory =
+      CISMatrixAOFockBuilderFactory<restrictedness>::getIntegralMemory(spinBlock, cisData_->AOInfo) * 1.e-9;
+  std::string storageDescription;
+  if (storageMode == "direct") {
+    integralStorage.mode = CISIntegralStorage::Mode::Direct;
+    storageDescription = " contracted directly";
+  }
+  else if (storageMode == "out_of_core" || (storageMode == "auto" && memRequ + integralMemory > maxMem)) {
+    integralStorage.mode = CISIntegralStorage::Mode::OutOfCore;
+    storageDescription = " stored out of core";
+  }
+  if (integralStorage.mode != CISIntegralStorage::Mode::InMemory) {
+    integralMemory =
+        CISMatrixAOFockBuilderFactory<restrictedness>::getIntegralMemory(spinBlock, cisData_->AOInfo, integralStorage) *
+        1.e-9;
   }
-  memRequ = memRequ * sizeof(double) * 1.e-9;
-  getLog().output << "Memory Required: " << memRequ << " GB"
-                  << " (specified maximum: " << maxMem << " GB).";
+  memRequ += integralMemory;
+  getLog().output << "Memory Required: " << memRequ << " GB, of which " << integralMemory << " GB for integrals"
+                  << storageDescription << " (specified maximum: " << maxMem << " GB).";
   if (memRequ > maxMem) {
     throw std::runtime_error("This calculation setup would require more memory than specified!"); // TODO setting for
                                                                                                   // allowed memory
   }
+  return integralStorage;
 }
 
 const Utils::Results& CISLinearResponseTimeDependentCalculator::calculate() {
@@ -212,7 +325,11 @@ const Utils::Results& CISLinearResponseTimeDependentCalculator::calculate() {
     throw InvalidReferenceCalculationException();
   }
 
+  if (!guess_) {
+    SparrowCheckpoint::loadExcitedStatesGuess(*this);
+  }
   Utils::SpinAdaptedElectronicTransitionResult transitionResult{};
+  iterationCounts_ = IterationCounts{};
 
   bool is_unrestricted = cisData_->occupation.isUnrestricted();
   int numberOfRoots = settings().getInt(Utils::SettingsNames::numberOfEigenstates);
@@ -256,6 +373,7 @@ const Utils::Results& CISLinearResponseTimeDependentCalculator::calculate() {
 
   results_.set<Utils::Property::ExcitedStates>(std::move(transitionResult));
   guess_.reset();
+  SparrowCheckpoint::saveExcitedStatesGuess(*this);
   return results_;
 }
 
@@ -266,15 +384,24 @@ void CISLinearResponseTimeDependentCalculator::generateTransitionDipoleMoments(U
   assert(!orderMap_.empty());
   // Triplets have a transition dipole moment of 0, the function transitionDipoleMoment just multiplies by 2 in the
   // restricted case so care must be taken.
-  if (getReferenceCalculator().results().has<Utils::Property::DipoleMatrixMO>() && spinBlock == Utils::SpinTransition::Singlet) {
+  const auto& referenceResults = getReferenceCalculator().results();
+  bool dipoleMatrixAvailable = referenceResults.has<Utils::Property::DipoleMatrixAO>() ||
+                               referenceResults.has<Utils::Property::DipoleMatrixMO>();
+  if (dipoleMatrixAvailable && spinBlock == Utils::SpinTransition::Singlet) {
     std::vector<Utils::Excitation> orderedExcitation;
     TimeDependentUtils::transformOrder(TimeDependentUtils::flatten(TimeDependentUtils::generateExcitations<restrictedness>(
                                            cisData.molecularOrbitals, cisData.occupation)),
                                        orderedExcitation, orderMap_, TimeDependentUtils::Direction::To);
 
+    // Transition dipoles only need the occupied-virtual elements of the MO dipole matrix, which are transformed from
+    // the AO one. A reference calculated with the full MO dipole matrix only is used as it is.
+    Utils::DipoleMatrix moDipoleMatrix =
+        referenceResults.has<Utils::Property::DipoleMatrixAO>()
+            ? DipoleMatrixMOTransformer::transformOccupiedVirtual(referenceResults.get<Utils::Property::DipoleMatrixAO>(),
+                                                                  cisData.molecularOrbitals, cisData.occupation)
+            : referenceResults.get<Utils::Property::DipoleMatrixMO>();
     excitedStatesResults.transitionDipoles = Utils::TransitionDipoleCalculator::calculate<restrictedness>(
-        getReferenceCalculator().results().get<Utils::Property::DipoleMatrixMO>(),
-        excitedStatesResults.eigenStates.eigenVectors, orderedExcitation);
+        moDipoleMatrix, excitedStatesResults.eigenStates.eigenVectors, orderedExcitation);
   }
   else {
     excitedStatesResults.transitionDipoles = Eigen::Matrix3Xd::Zero(3, excitedStatesResults.eigenStates.eigenValues.size());
@@ -328,6 +455,44 @@ void CISLinearResponseTimeDependentCalculator::setGuess(std::shared_ptr<GuessSpe
   guess_ = std::move(guessVectorMatrix);
 }
 
+auto CISLinearResponseTimeDependentCalculator::getIterationCounts() const -> const IterationCounts& {
+  return iterationCounts_;
+}
+
+Utils::GradientCollection
+CISLinearResponseTimeDependentCalculator::getExcitedStateGradients(int root, Utils::SpinTransition spinBlock) {
+  if (!results_.has<Utils::Property::ExcitedStates>()) {
+    throw std::runtime_error("No excited states were calculated.");
+  }
+  if (!nddoMethod_->results().has<Utils::Property::Gradients>()) {
+    throw std::runtime_error("The gradients of the excited states need the ones of the reference calculation.");
+  }
+  const auto& excitedStates = results_.get<Utils::Property::ExcitedStates>();
+  const auto& transitionResult =
+      spinBlock == Utils::SpinTransition::Singlet ? excitedStates.singlet : excitedStates.triplet;
+  if (cisData_->occupation.isUnrestricted() || !transitionResult) {
+    throw std::runtime_error("No excited states of a restricted reference were calculated for this spin block.");
+  }
+  const Eigen::MatrixXd& eigenVectors = transitionResult->eigenStates.eigenVectors;
+  if (root < 0 || root >= eigenVectors.cols()) {
+    throw std::runtime_error("The excited state " + std::to_string(root) + " was not calculated.");
+  }
+  Eigen::VectorXd eigenVector;
+  TimeDependentUtils::transformOrder(eigenVectors.col(root), eigenVector, orderMap_,
+                                     TimeDependentUtils::Direction::From);
+
+  CISIntegralStorage integralStorage;
+  integralStorage.mode = CISIntegralStorage::Mode::Direct;
+  integralStorage.screeningThreshold = settings_->getDouble("direct_screening_threshold");
+  setExcitedStatesParam(Utils::Reference::Restricted, spinBlock);
+  CISExcitedStateGradient gradient(*cisData_, excitedStatesParam_, spinBlock, integralStorage);
+  Utils::GradientCollection gradients = nddoMethod_->results().get<Utils::Property::Gradients>();
+  gradients += gradient.calculate(eigenVector);
+  getLog().output << "Z-vector iterations of the excited-state gradient: " << gradient.getNumberOfZVectorIterations()
+                  << Core::Log::endl;
+  return gradients;
+}
+
 auto CISLinearResponseTimeDependentCalculator::getGuess() const -> std::shared_ptr<GuessSpecifier> {
   if (results_.has<Utils::Property::ExcitedStates>()) {
     auto guess = std::make_shared<GuessSpecifier>();
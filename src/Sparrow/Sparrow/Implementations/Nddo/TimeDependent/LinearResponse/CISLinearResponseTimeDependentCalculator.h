@@ -70,7 +70,9 @@ class CISLinearResponseTimeDependentCalculator final : public LinearResponseCalc
   void setReferenceCalculator(std::shared_ptr<Core::Calculator> method) final;
   /**
    * @brief This function gives the chance to perform a reference calculation.
-   * This is not needed if the calculator has already performed a RHF calculation.
+   * The reference is converged to an energy change of 1e-8 at least. If its last calculation was successful with
+   * this convergence criterion already and includes the energy, a dipole matrix and, if required, the gradients, it
+   * is not calculated again and its integrals are used as they are.
    * @pre nddoMethod_ must already be initialized and equipped with a structure to calculate, i.e.
    *      the function setStructure(Utils::AtomCollection) must already be called.
    */
@@ -136,11 +138,25 @@ class CISLinearResponseTimeDependentCalculator final : public LinearResponseCalc
    * @brief Returns the guess in the full singles space (no pruning)
    */
   auto getGuess() const -> std::shared_ptr<GuessSpecifier> final;
+  /**
+   * @brief Returns the Davidson iteration at which every root of the last calculation converged.
+   */
+  auto getIterationCounts() const -> const IterationCounts& final;
+  /**
+   * @brief Returns the analytical gradients of the energy of an excited state of a restricted reference.
+   * @see CISExcitedStateGradient
+   */
+  Utils::GradientCollection getExcitedStateGradients(int root, Utils::SpinTransition spinBlock) final;
 
  private:
   void setExcitedStatesParam(Utils::Reference restrictedness, Utils::SpinTransition spinBlock);
+  // Whether the results of the reference are converged tightly and complete for the CIS calculation.
+  bool hasConvergedReference(bool gradientsRequired) const;
   void prepareIntegralScreening();
-  void checkMemoryRequirement(int excitationsDim, int numberOfEnergyLevels);
+  // Chooses the integral storage and throws if the calculation does not fit into the maximum memory with it.
+  template<Utils::Reference restrictedness>
+  CISIntegralStorage checkMemoryRequirement(int excitationsDim, int numberOfEnergyLevels,
+                                            Utils::SpinTransition spinBlock);
   template<Utils::Reference restrictedness>
   void generateTransitionDipoleMoments(Utils::ElectronicTransitionResult& excitedStatesResults, const CISData& cisData,
                                        Utils::SpinTransition spinBlock) const;
@@ -149,10 +165,12 @@ class CISLinearResponseTimeDependentCalculator final : public LinearResponseCalc
   std::unique_ptr<Utils::Settings> settings_;
   std::unique_ptr<CISData> cisData_;
   std::shared_ptr<GuessSpecifier> guess_;
+  IterationCounts iterationCounts_;
   std::vector<std::multimap<double, int, std::greater<double>>> integralsThresholds_;
   std::vector<int> orderMap_;
   ExcitedStatesParam excitedStatesParam_{1., 1., 1.};
   Utils::Results results_;
+  static constexpr const double referenceConvergence_ = 1e-8;
 };
 } // namespace Sparrow
 } // namespace Scine
@@ -7,99 +7,366 @@
 
 #include "CISMatrixAOFockBuilder.h"
 #include "Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/Global2c2eMatrix.h"
+#include "Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/TwoElectronIntegralIndexes.h"
 #include "Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h"
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
 namespace Scine {
 namespace Sparrow {
 
+namespace {
+using PairIndexes = nddo::TwoElectronIntegralIndexes;
+
+// Number of charge distributions of an atom, the dimension of its side of the Global2c2eMatrix.
+inline int packedSize(int nAOs) {
+  return nAOs == 1 ? 1 : nAOs == 4 ? 10 : 40;
+}
+
+// Packs a diagonal block of the (non-symmetric) pseudo-density by charge distribution as P_mu,nu + P_nu,mu for
+// mu < nu and P_mu,mu. The orbital pairs without charge distribution have vanishing integrals and are left out.
+Eigen::VectorXd packSymmetrized(const Eigen::Ref<const Eigen::MatrixXd>& block) {
+  const int nAOs = block.rows();
+  Eigen::VectorXd packed = Eigen::VectorXd::Zero(packedSize(nAOs));
+  for (int mu = 0; mu < nAOs; ++mu) {
+    packed(PairIndexes::getPairIndex(mu, mu)) = block(mu, mu);
+    for (int nu = mu + 1; nu < nAOs; ++nu) {
+      if (!PairIndexes::pairIsInvalid(mu, nu)) {
+        packed(PairIndexes::getPairIndex(mu, nu)) = block(mu, nu) + block(nu, mu);
+      }
+    }
+  }
+  return packed;
+}
+
+// Adds the symmetric matrix stored by charge distribution to a diagonal block.
+void addUnpacked(const Eigen::Ref<const Eigen::VectorXd>& packed, Eigen::Ref<Eigen::MatrixXd> block) {
+  const int nAOs = block.rows();
+  for (int mu = 0; mu < nAOs; ++mu) {
+    block(mu, mu) += packed(PairIndexes::getPairIndex(mu, mu));
+    for (int nu = mu + 1; nu < nAOs; ++nu) {
+      if (!PairIndexes::pairIsInvalid(mu, nu)) {
+        block(mu, nu) += packed(PairIndexes::getPairIndex(mu, nu));
+        block(nu, mu) += packed(PairIndexes::getPairIndex(mu, nu));
+      }
+    }
+  }
+}
+
+// Largest sum of the absolute values of the two off-diagonal pseudo-density blocks of atoms I and J over the vectors
+// firstVector to firstVector + nVectors - 1 of the stacked pseudo-densities.
+double offDiagonalNorm(const Eigen::MatrixXd& pseudoDensities, const Utils::AtomsOrbitalsIndexes& aoInfo, int atomI,
+                       int atomJ, int firstVector, int nVectors) {
+  const int nAOs = aoInfo.getNAtomicOrbitals();
+  const int nAOsI = aoInfo.getNOrbitals(atomI);
+  const int nAOsJ = aoInfo.getNOrbitals(atomJ);
+  const int startAOI = aoInfo.getFirstOrbitalIndex(atomI);
+  const int startAOJ = aoInfo.getFirstOrbitalIndex(atomJ);
+  double norm = 0.0;
+  for (int vector = firstVector; vector < firstVector + nVectors; ++vector) {
+    const int row = vector * nAOs;
+    norm = std::max(norm, pseudoDensities.block(row + startAOI, startAOJ, nAOsI, nAOsJ).cwiseAbs().sum() +
+                              pseudoDensities.block(row + startAOJ, startAOI, nAOsJ, nAOsI).cwiseAbs().sum());
+  }
+  return norm;
+}
+
+// Copies the block (row, col) of every vector of the stacked matrices, optionally transposed, to a column of blocks.
+void gatherBlocks(const Eigen::MatrixXd& stacked, int nAOs, int firstVector, int row, int col, int nRows, int nCols,
+                  bool transposed, Eigen::Ref<Eigen::MatrixXd> blocks) {
+  for (int k = 0; k < blocks.cols(); ++k) {
+    const auto block = stacked.block((firstVector + k) * nAOs + row, col, nRows, nCols);
+    if (transposed) {
+      Eigen::Map<Eigen::MatrixXd>(blocks.col(k).data(), nCols, nRows) = block.transpose();
+    }
+    else {
+      Eigen::Map<Eigen::MatrixXd>(blocks.col(k).data(), nRows, nCols) = block;
+    }
+  }
+}
+
+// Adds factor times the columns of blocks to the block (row, col) of every vector of the stacked matrices.
+void addBlocks(const Eigen::Ref<const Eigen::MatrixXd>& blocks, double factor, int nAOs, int firstVector, int row,
+               int col, int nRows, int nCols, Eigen::MatrixXd& stacked) {
+  for (int k = 0; k < blocks.cols(); ++k) {
+    stacked.block((firstVector + k) * nAOs + row, col, nRows, nCols) +=
+        factor * Eigen::Map<const Eigen::MatrixXd>(blocks.col(k).data(), nRows, nCols);
+  }
+}
+
+// Number of vectors of the stacked matrices, and zeroed stacked matrices of the same size.
+int numberOfVectors(const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& stacked) {
+  return stacked.restricted.cols() == 0 ? 0 : static_cast<int>(stacked.restricted.rows() / stacked.restricted.cols());
+}
+int numberOfVectors(const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& stacked) {
+  return stacked.alpha.cols() == 0 ? 0 : static_cast<int>(stacked.alpha.rows() / stacked.alpha.cols());
+}
+void setZeroLike(const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& stacked,
+                 Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& zeroed) {
+  zeroed.restricted.setZero(stacked.restricted.rows(), stacked.restricted.cols());
+}
+void setZeroLike(const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& stacked,
+                 Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& zeroed) {
+  zeroed.alpha.setZero(stacked.alpha.rows(), stacked.alpha.cols());
+  zeroed.beta.setZero(stacked.beta.rows(), stacked.beta.cols());
+}
+
+// Doubles of the two-center blocks held in memory. Out of core, a thread holds at most the blocks of the atom it
+// fills or, while building the pseudo-Fock matrix, of the atom it contracts and of the next, prefetched atom.
+// Integral-direct, no two-center block is stored.
+std::size_t residentElements(const std::vector<int>& rows, const std::vector<int>& cols, int nAtoms,
+                             const CISIntegralStorage& integralStorage) {
+  if (integralStorage.mode == CISIntegralStorage::Mode::InMemory) {
+    return CISIntegralArena::numberOfElements(rows, cols);
+  }
+  if (integralStorage.mode == CISIntegralStorage::Mode::Direct) {
+    return 0;
+  }
+  std::size_t maxAtomElements = 0;
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    std::size_t atomElements = 0;
+    for (int pair = CISIntegralArena::firstPairIndex(atomI, nAtoms);
+         pair < CISIntegralArena::firstPairIndex(atomI, nAtoms) + nAtoms - atomI - 1; ++pair) {
+      atomElements += static_cast<std::size_t>(rows[pair]) * static_cast<std::size_t>(cols[pair]);
+    }
+    maxAtomElements = std::max(maxAtomElements, atomElements);
+  }
+  return 2 * static_cast<std::size_t>(omp_get_max_threads()) * maxAtomElements;
+}
+
+// Doubles of the integral bounds of the atom pairs, only kept for the integral-direct screening.
+std::size_t boundElements(int nAtoms, const CISIntegralStorage& integralStorage) {
+  return integralStorage.mode == CISIntegralStorage::Mode::Direct ? CISIntegralArena::numberOfPairs(nAtoms) : 0;
+}
+
+// Range of the pair indices of atom I and the atoms it is listed with.
+std::pair<int, int> listedPairs(int atomI, int nAtoms, const std::map<int, std::vector<int>>& atomPairList) {
+  auto atom = atomPairList.find(atomI);
+  if (atom == atomPairList.end() || atom->second.empty()) {
+    return {0, 0};
+  }
+  auto minMax = std::minmax_element(atom->second.begin(), atom->second.end());
+  return {CISIntegralArena::pairIndex(atomI, *minMax.first, nAtoms),
+          CISIntegralArena::pairIndex(atomI, *minMax.second, nAtoms) + 1};
+}
+
+inline void throwInvalidCombination() {
+  throw std::runtime_error(" CISMatrixAOFockBuilder: Invalid combination: Calculation for an unrestricted reference "
+                           "with a triplet spin-transition not possible!.");
+}
+} // namespace
+
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
 CISMatrixAOFockBuilder<restrictedness, spinBlock>::CISMatrixAOFockBuilder(CISData cisData,
-                                                                          const ExcitedStatesParam& excitedStatesParam)
-  : cisData_(std::move(cisData)) {
+                                                                          const ExcitedStatesParam& excitedStatesParam,
+                                                                          const CISIntegralStorage& integralStorage)
+  : cisData_(std::move(cisData)), integralStorage_(integralStorage) {
   c1_ = excitedStatesParam.c1;
   c2_ = excitedStatesParam.c2;
-  coulombContainer_ = std::make_shared<std::vector<std::map<int, std::unique_ptr<Eigen::MatrixXd>>>>();
-  exchangeContainer_ = std::make_shared<std::vector<std::map<int, std::unique_ptr<Eigen::MatrixXd>>>>();
   initialize();
   calculateMatrices();
 }
 
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::oneCenterShapes(const Utils::AtomsOrbitalsIndexes& aoInfo,
+                                                                        std::vector<int>& rows,
+                                                                        std::vector<int>& cols) {
+  rows.resize(aoInfo.getNAtoms());
+  for (int atomI = 0; atomI < aoInfo.getNAtoms(); ++atomI) {
+    rows[atomI] = aoInfo.getNOrbitals(atomI) * aoInfo.getNOrbitals(atomI);
+  }
+  cols = rows;
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::exchangeShapes(const Utils::AtomsOrbitalsIndexes& aoInfo,
+                                                                       std::vector<int>& rows, std::vector<int>& cols) {
+  const int nAtoms = aoInfo.getNAtoms();
+  rows.resize(CISIntegralArena::numberOfPairs(nAtoms));
+  cols.resize(rows.size());
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    for (int atomJ = atomI + 1; atomJ < nAtoms; ++atomJ) {
+      const int pair = CISIntegralArena::pairIndex(atomI, atomJ, nAtoms);
+      rows[pair] = aoInfo.getNOrbitals(atomI) * aoInfo.getNOrbitals(atomJ);
+      cols[pair] = rows[pair];
+    }
+  }
+}
+
 template<>
 void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::initialize() {
-  coulombContainer_->resize(nAtoms_);
-  exchangeContainer_->resize(nAtoms_);
+  std::vector<int> rows, cols;
+  oneCenterShapes(cisData_.AOInfo, rows, cols);
+  oneCenterCoulomb_.allocate(rows, cols);
+  exchangeShapes(cisData_.AOInfo, rows, cols);
+  allocateTwoCenter(exchange_, rows, cols);
+  coulombFactor_ = 2.0 * c1_;
 }
 template<>
 void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::initialize() {
-  exchangeContainer_->resize(nAtoms_);
+  std::vector<int> rows, cols;
+  oneCenterShapes(cisData_.AOInfo, rows, cols);
+  oneCenterExchange_.allocate(rows, cols);
+  exchangeShapes(cisData_.AOInfo, rows, cols);
+  allocateTwoCenter(exchange_, rows, cols);
+  coulombFactor_ = 0.0;
 }
 
 template<>
 void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::initialize() {
-  coulombContainer_->resize(nAtoms_);
-  exchangeContainer_->resize(nAtoms_);
+  std::vector<int> rows, cols;
+  oneCenterShapes(cisData_.AOInfo, rows, cols);
+  oneCenterCoulomb_.allocate(rows, cols);
+  oneCenterExchange_.allocate(rows, cols);
+  exchangeShapes(cisData_.AOInfo, rows, cols);
+  allocateTwoCenter(exchange_, rows, cols);
+  coulombFactor_ = c1_;
 }
 template<>
 void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::initialize() {
-  throw std::runtime_error(" CISMatrixAOFockBuilder: Invalid combination: Calculation for an unrestricted reference "
-                           "with a triplet spin-transition not possible!.");
+  throwInvalidCombination();
+}
+
+template<>
+std::size_t CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::getIntegralMemory(
+    const Utils::AtomsOrbitalsIndexes& aoInfo, const CISIntegralStorage& integralStorage) {
+  std::vector<int> rows, cols;
+  oneCenterShapes(aoInfo, rows, cols);
+  std::size_t nElements = CISIntegralArena::numberOfElements(rows, cols);
+  exchangeShapes(aoInfo, rows, cols);
+  nElements += residentElements(rows, cols, aoInfo.getNAtoms(), integralStorage);
+  nElements += boundElements(aoInfo.getNAtoms(), integralStorage);
+  return nElements * sizeof(double);
+}
+template<>
+std::size_t CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::getIntegralMemory(
+    const Utils::AtomsOrbitalsIndexes& aoInfo, const CISIntegralStorage& integralStorage) {
+  std::vector<int> rows, cols;
+  oneCenterShapes(aoInfo, rows, cols);
+  std::size_t nElements = CISIntegralArena::numberOfElements(rows, cols);
+  exchangeShapes(aoInfo, rows, cols);
+  nElements += residentElements(rows, cols, aoInfo.getNAtoms(), integralStorage);
+  nElements += boundElements(aoInfo.getNAtoms(), integralStorage);
+  return nElements * sizeof(double);
+}
+template<>
+std::size_t CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::getIntegralMemory(
+    const Utils::AtomsOrbitalsIndexes& aoInfo, const CISIntegralStorage& integralStorage) {
+  std::vector<int> rows, cols;
+  oneCenterShapes(aoInfo, rows, cols);
+  std::size_t nElements = 2 * CISIntegralArena::numberOfElements(rows, cols);
+  exchangeShapes(aoInfo, rows, cols);
+  nElements += residentElements(rows, cols, aoInfo.getNAtoms(), integralStorage);
+  nElements += boundElements(aoInfo.getNAtoms(), integralStorage);
+  return nElements * sizeof(double);
+}
+template<>
+std::size_t CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::getIntegralMemory(
+    const Utils::AtomsOrbitalsIndexes& /*aoInfo*/, const CISIntegralStorage& /*integralStorage*/) {
+  throwInvalidCombination();
+  return 0;
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+std::size_t CISMatrixAOFockBuilder<restrictedness, spinBlock>::getIntegralMemory() const {
+  return oneCenterCoulomb_.getMemory() + oneCenterExchange_.getMemory() + exchange_.getMemory() +
+         pairBounds_.capacity() * sizeof(double);
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+std::size_t CISMatrixAOFockBuilder<restrictedness, spinBlock>::getScratchSize() const {
+  return exchange_.getScratchSize();
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::allocateTwoCenter(CISIntegralArena& arena,
+                                                                          const std::vector<int>& rows,
+                                                                          const std::vector<int>& cols) {
+  if (integralStorage_.mode == CISIntegralStorage::Mode::OutOfCore) {
+    arena.allocateOutOfCore(rows, cols, integralStorage_.scratchDirectory);
+  }
+  else if (integralStorage_.mode == CISIntegralStorage::Mode::InMemory) {
+    arena.allocate(rows, cols);
+  }
+  else {
+    // Integral-direct, the blocks are contracted straight from the two-center integral container.
+    arena.clear();
+  }
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::prefetch(
+    int atomI, const std::map<int, std::vector<int>>& atomPairList) const {
+  if (integralStorage_.mode == CISIntegralStorage::Mode::OutOfCore) {
+    const auto pairs = listedPairs(atomI, nAtoms_, atomPairList);
+    exchange_.prefetch(pairs.first, pairs.second);
+  }
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::release(
+    int atomI, const std::map<int, std::vector<int>>& atomPairList) const {
+  if (integralStorage_.mode == CISIntegralStorage::Mode::OutOfCore) {
+    const auto pairs = listedPairs(atomI, nAtoms_, atomPairList);
+    exchange_.release(pairs.first, pairs.second);
+  }
 }
 
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
 void CISMatrixAOFockBuilder<restrictedness, spinBlock>::calculateMatrices() {
+  if (integralStorage_.mode == CISIntegralStorage::Mode::Direct) {
+    pairBounds_.assign(CISIntegralArena::numberOfPairs(nAtoms_), 0.0);
+  }
+  // The blocks are preallocated and disjoint: every atom pair is filled independently.
+#pragma omp parallel for schedule(dynamic)
   for (int atomI = 0; atomI < nAtoms_; ++atomI) {
     calculate(atomI);
     for (int atomJ = atomI + 1; atomJ < nAtoms_; ++atomJ) {
-      calculate(atomI, atomJ);
+      if (integralStorage_.mode == CISIntegralStorage::Mode::Direct) {
+        const auto integrals = cisData_.twoCenterIntegrals.get(atomI, atomJ);
+        pairBounds_[CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_)] =
+            integrals->getGlobalMatrix().cwiseAbs().maxCoeff();
+      }
+      else {
+        calculate(atomI, atomJ);
+      }
     }
+    // Out of core, the blocks of the atom are written to the scratch file and leave the resident memory.
+    const int firstPair = CISIntegralArena::firstPairIndex(atomI, nAtoms_);
+    exchange_.release(firstPair, firstPair + nAtoms_ - atomI - 1);
   }
 }
 
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
-inline Eigen::MatrixXd CISMatrixAOFockBuilder<restrictedness, spinBlock>::getCoulombIntegrals(int atomI, int atomJ) {
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::addCoulombIntegrals(int atomI,
+                                                                            Eigen::Ref<Eigen::MatrixXd> block,
+                                                                            double factor) const {
   int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
-  int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
-  Eigen::MatrixXd integralMatrix = Eigen::MatrixXd::Zero(nAOsI * nAOsI, nAOsJ * nAOsJ);
-  if (atomI == atomJ) {
-    const auto& integrals = cisData_.oneCenterIntegrals.get(cisData_.elements[atomI]);
-    for (int mu = 0; mu < nAOsI; ++mu) {
-      for (int nu = 0; nu < nAOsI; ++nu) {
-        for (int lambda = 0; lambda < nAOsI; ++lambda) {
-          for (int sigma = 0; sigma < nAOsI; ++sigma) {
-            integralMatrix(mu * nAOsI + nu, lambda * nAOsJ + sigma) = integrals.get(mu, nu, lambda, sigma);
-          }
-        }
-      }
-    }
-  }
-  else {
-    const auto& integrals = cisData_.twoCenterIntegrals.get(atomI, atomJ);
-    for (int mu = 0; mu < nAOsI; ++mu) {
-      for (int nu = 0; nu < nAOsI; ++nu) {
-        for (int lambda = 0; lambda < nAOsJ; ++lambda) {
-          for (int sigma = 0; sigma < nAOsJ; ++sigma) {
-            integralMatrix(mu * nAOsI + nu, lambda * nAOsJ + sigma) = integrals->get(mu, nu, lambda, sigma);
-          }
+  const auto& integrals = cisData_.oneCenterIntegrals.get(cisData_.elements[atomI]);
+  for (int mu = 0; mu < nAOsI; ++mu) {
+    for (int nu = 0; nu < nAOsI; ++nu) {
+      for (int lambda = 0; lambda < nAOsI; ++lambda) {
+        for (int sigma = 0; sigma < nAOsI; ++sigma) {
+          block(mu * nAOsI + nu, lambda * nAOsI + sigma) += factor * c1_ * integrals.get(mu, nu, lambda, sigma);
         }
       }
     }
   }
-
-  return integralMatrix * c1_;
 }
 
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
-inline Eigen::MatrixXd CISMatrixAOFockBuilder<restrictedness, spinBlock>::getExchangeIntegrals(int atomI, int atomJ) {
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::addExchangeIntegrals(int atomI, int atomJ,
+                                                                             Eigen::Ref<Eigen::MatrixXd> block,
+                                                                             double factor) const {
   int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
-
   int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
-  Eigen::MatrixXd integralMatrix = Eigen::MatrixXd::Zero(nAOsI * nAOsJ, nAOsJ * nAOsI);
   if (atomI == atomJ) {
     const auto& integrals = cisData_.oneCenterIntegrals.get(cisData_.elements[atomI]);
     for (int mu = 0; mu < nAOsI; ++mu) {
       for (int nu = 0; nu < nAOsI; ++nu) {
         for (int lambda = 0; lambda < nAOsI; ++lambda) {
           for (int sigma = 0; sigma < nAOsI; ++sigma) {
-            integralMatrix(mu * nAOsI + nu, lambda * nAOsI + sigma) = integrals.get(mu, sigma, lambda, nu);
+            block(mu * nAOsI + nu, lambda * nAOsI + sigma) += factor * c2_ * integrals.get(mu, sigma, lambda, nu);
           }
         }
       }
@@ -111,233 +378,339 @@ inline Eigen::MatrixXd CISMatrixAOFockBuilder<restrictedness, spinBlock>::getExc
       for (int nu = 0; nu < nAOsJ; ++nu) {
         for (int lambda = 0; lambda < nAOsJ; ++lambda) {
           for (int sigma = 0; sigma < nAOsI; ++sigma) {
-            integralMatrix(mu * nAOsJ + nu, lambda * nAOsI + sigma) = integrals->get(mu, sigma, lambda, nu);
+            block(mu * nAOsJ + nu, lambda * nAOsI + sigma) += factor * c2_ * integrals->get(mu, sigma, lambda, nu);
           }
         }
       }
     }
   }
-  return integralMatrix * c2_;
 }
 
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::calculate(int atomI,
                                                                                                             int atomJ) {
-  coulombContainer_->at(atomI).insert({atomJ, std::make_unique<Eigen::MatrixXd>(2 * getCoulombIntegrals(atomI, atomJ))});
-  exchangeContainer_->at(atomI).insert({atomJ, std::make_unique<Eigen::MatrixXd>(getExchangeIntegrals(atomI, atomJ))});
+  addExchangeIntegrals(atomI, atomJ, exchange_.block(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_)), 1.0);
 }
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::calculate(int atomI,
                                                                                                             int atomJ) {
-  exchangeContainer_->at(atomI).insert({atomJ, std::make_unique<Eigen::MatrixXd>(getExchangeIntegrals(atomI, atomJ))});
+  addExchangeIntegrals(atomI, atomJ, exchange_.block(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_)), 1.0);
 }
 
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::calculate(int atomI,
                                                                                                               int atomJ) {
-  coulombContainer_->at(atomI).insert({atomJ, std::make_unique<Eigen::MatrixXd>(getCoulombIntegrals(atomI, atomJ))});
-  exchangeContainer_->at(atomI).insert({atomJ, std::make_unique<Eigen::MatrixXd>(getExchangeIntegrals(atomI, atomJ))});
+  addExchangeIntegrals(atomI, atomJ, exchange_.block(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_)), 1.0);
 }
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::calculate(int /*atomI*/,
                                                                                                               int /*atomJ*/) {
-  throw std::runtime_error(" CISMatrixAOFockBuilder: Invalid combination: Calculation for an unrestricted reference "
-                           "with a triplet spin-transition not possible!.");
+  throwInvalidCombination();
 }
 
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::calculate(int atomI) {
-  coulombContainer_->at(atomI).insert({atomI, std::make_unique<Eigen::MatrixXd>(2 * getCoulombIntegrals(atomI, atomI) -
-                                                                                getExchangeIntegrals(atomI, atomI))});
+  addCoulombIntegrals(atomI, oneCenterCoulomb_.block(atomI), 2.0);
+  addExchangeIntegrals(atomI, atomI, oneCenterCoulomb_.block(atomI), -1.0);
 }
 
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::calculate(int atomI) {
-  exchangeContainer_->at(atomI).insert({atomI, std::make_unique<Eigen::MatrixXd>(getExchangeIntegrals(atomI, atomI))});
+  addExchangeIntegrals(atomI, atomI, oneCenterExchange_.block(atomI), 1.0);
 }
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::calculate(int atomI) {
-  coulombContainer_->at(atomI).insert({atomI, std::make_unique<Eigen::MatrixXd>(getCoulombIntegrals(atomI, atomI))});
-  exchangeContainer_->at(atomI).insert({atomI, std::make_unique<Eigen::MatrixXd>(getExchangeIntegrals(atomI, atomI))});
+  addCoulombIntegrals(atomI, oneCenterCoulomb_.block(atomI), 1.0);
+  addExchangeIntegrals(atomI, atomI, oneCenterExchange_.block(atomI), 1.0);
 }
 
 template<>
 inline void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::calculate(int /*atomI*/) {
-  throw std::runtime_error(" CISMatrixAOFockBuilder: Invalid combination: Calculation for an unrestricted reference "
-                           "with a triplet spin-transition not possible!.");
+  throwInvalidCombination();
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::addTwoCenterCoulomb(
+    int atomI, int atomJ, const std::vector<Eigen::MatrixXd>& packedDensities,
+    std::vector<Eigen::MatrixXd>& packedCoulomb) const {
+  // The Global2c2eMatrix of the ground state is laid out by charge distribution, it is used in place.
+  const auto integrals = cisData_.twoCenterIntegrals.get(atomI, atomJ);
+  const Eigen::MatrixXd& coulombMatrixIJ = integrals->getGlobalMatrix();
+  packedCoulomb[atomI].noalias() += coulombFactor_ * coulombMatrixIJ * packedDensities[atomJ];
+  packedCoulomb[atomJ].noalias() += coulombFactor_ * coulombMatrixIJ.transpose() * packedDensities[atomI];
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::addTwoCenterExchange(int atomI, int atomJ,
+                                                                             const Eigen::MatrixXd& pseudoDensities,
+                                                                             int firstVector, int nVectors,
+                                                                             Eigen::MatrixXd& fock,
+                                                                             Eigen::MatrixXd& densityBlocks,
+                                                                             Eigen::MatrixXd& fockBlocks) const {
+  const int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
+  const int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
+  const int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+  const int startAOJ = cisData_.AOInfo.getFirstOrbitalIndex(atomJ);
+  if (integralStorage_.mode == CISIntegralStorage::Mode::Direct) {
+    // F_nu,mu -= c2 (mu sigma|lambda nu) P_sigma,lambda and F_sigma,lambda -= c2 (mu sigma|lambda nu) P_nu,mu
+    const auto integrals = cisData_.twoCenterIntegrals.get(atomI, atomJ);
+    const Eigen::MatrixXd& exchangeMatrixIJ = integrals->getGlobalMatrix();
+    for (int mu = 0; mu < nAOsI; ++mu) {
+      for (int sigma = 0; sigma < nAOsI; ++sigma) {
+        if (PairIndexes::pairIsInvalid(mu, sigma)) {
+          continue;
+        }
+        const int pairI = PairIndexes::getPairIndex(mu, sigma);
+        for (int lambda = 0; lambda < nAOsJ; ++lambda) {
+          for (int nu = 0; nu < nAOsJ; ++nu) {
+            if (PairIndexes::pairIsInvalid(lambda, nu)) {
+              continue;
+            }
+            const double integral = c2_ * exchangeMatrixIJ(pairI, PairIndexes::getPairIndex(lambda, nu));
+            for (int vector = firstVector; vector < firstVector + nVectors; ++vector) {
+              const int row = vector * nAOs_;
+              fock(row + startAOJ + nu, startAOI + mu) -=
+                  integral * pseudoDensities(row + startAOI + sigma, startAOJ + lambda);
+              fock(row + startAOI + sigma, startAOJ + lambda) -=
+                  integral * pseudoDensities(row + startAOJ + nu, startAOI + mu);
+            }
+          }
+        }
+      }
+    }
+  }
+  else {
+    // The integral block is applied to the density blocks of all vectors at once.
+    const auto exchangeMatrixIJ = exchange_.block(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_));
+    const int blockSize = nAOsI * nAOsJ;
+    gatherBlocks(pseudoDensities, nAOs_, firstVector, startAOI, startAOJ, nAOsI, nAOsJ, false,
+                 densityBlocks.topRows(blockSize));
+    fockBlocks.topRows(blockSize).noalias() = exchangeMatrixIJ * densityBlocks.topRows(blockSize);
+    addBlocks(fockBlocks.topRows(blockSize), -1.0, nAOs_, firstVector, startAOJ, startAOI, nAOsJ, nAOsI, fock);
+    gatherBlocks(pseudoDensities, nAOs_, firstVector, startAOJ, startAOI, nAOsJ, nAOsI, false,
+                 densityBlocks.topRows(blockSize));
+    fockBlocks.topRows(blockSize).noalias() = exchangeMatrixIJ.transpose() * densityBlocks.topRows(blockSize);
+    addBlocks(fockBlocks.topRows(blockSize), -1.0, nAOs_, firstVector, startAOI, startAOJ, nAOsI, nAOsJ, fock);
+  }
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+bool CISMatrixAOFockBuilder<restrictedness, spinBlock>::isNegligible(int atomI, int atomJ, double coulombNorm,
+                                                                     double exchangeNorm) const {
+  // Every Fock element added by the pair is bounded by the largest integral times the norm of the contracted block.
+  const double bound = pairBounds_[CISIntegralArena::pairIndex(atomI, atomJ, nAtoms_)];
+  return bound * std::max(std::abs(coulombFactor_) * coulombNorm, std::abs(c2_) * exchangeNorm) <
+         integralStorage_.screeningThreshold;
 }
 
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
 Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd> CISMatrixAOFockBuilder<restrictedness, spinBlock>::getAOFock(
     const Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& pseudoDensity,
     std::map<int, std::vector<int>> atomPairList) const {
-  return buildFock(pseudoDensity, std::move(atomPairList));
+  Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd> fockMatrix;
+  getAOFocks(pseudoDensity, atomPairList, fockMatrix);
+  return fockMatrix;
+}
+
+template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
+void CISMatrixAOFockBuilder<restrictedness, spinBlock>::getAOFocks(
+    const Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& pseudoDensities,
+    const std::map<int, std::vector<int>>& atomPairList,
+    Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& aoFocks) const {
+  setZeroLike(pseudoDensities, aoFocks);
+  const int nVectors = numberOfVectors(pseudoDensities);
+  // Every thread builds the pseudo-Fock matrices of a contiguous chunk of vectors, in disjoint rows of aoFocks.
+  const int nChunks = std::min(omp_get_max_threads(), nVectors);
+#pragma omp parallel for schedule(static)
+  for (int chunk = 0; chunk < nChunks; ++chunk) {
+    const int firstVector = chunk * nVectors / nChunks;
+    const int lastVector = (chunk + 1) * nVectors / nChunks;
+    buildFock(pseudoDensities, firstVector, lastVector - firstVector, atomPairList, aoFocks);
+  }
 }
 
 template<>
-inline Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>
-CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::buildFock(
-    const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& pseudoDensity,
-    std::map<int, std::vector<int>> atomPairList) const {
-  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> fockMatrix;
-  fockMatrix.restricted = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
-  Eigen::MatrixXd tmpBlock(81, 81);
-  Eigen::VectorXd tmpV(81 * 81);
+inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>::buildFock(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& pseudoDensities,
+    int firstVector, int nVectors, const std::map<int, std::vector<int>>& atomPairList,
+    Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& aoFocks) const {
+  // The blocks of all vectors are gathered in the columns of the workspaces, of at most 9 x 9 elements.
+  Eigen::MatrixXd densityBlocks(81, nVectors);
+  Eigen::MatrixXd fockBlocks(81, nVectors);
+
+  // The two-center Coulomb contributions are accumulated on the packed diagonal blocks.
+  std::vector<Eigen::MatrixXd> packedDensities(nAtoms_);
+  std::vector<Eigen::MatrixXd> packedCoulomb(nAtoms_);
+  std::vector<double> densityNorms(nAtoms_);
+  for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
+    int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+    packedDensities[atomI].resize(packedSize(nAOsI), nVectors);
+    for (int k = 0; k < nVectors; ++k) {
+      const int row = (firstVector + k) * nAOs_;
+      packedDensities[atomI].col(k) =
+          packSymmetrized(pseudoDensities.restricted.block(row + startAOI, startAOI, nAOsI, nAOsI));
+    }
+    packedCoulomb[atomI] = Eigen::MatrixXd::Zero(packedSize(nAOsI), nVectors);
+    densityNorms[atomI] = packedDensities[atomI].cwiseAbs().colwise().sum().maxCoeff();
+  }
+  const bool direct = integralStorage_.mode == CISIntegralStorage::Mode::Direct;
 
+  // Out of core, the blocks of the next atom are read while the current atom is contracted.
+  prefetch(0, atomPairList);
   for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    prefetch(atomI + 1, atomPairList);
     int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
     int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
-    tmpBlock = pseudoDensity.restricted.block(startAOI, startAOI, nAOsI, nAOsI);
-    tmpV = *coulombContainer_->at(atomI)[atomI] * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsI * nAOsI);
-    fockMatrix.restricted.block(startAOI, startAOI, nAOsI, nAOsI) +=
-        Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
+    const int blockSize = nAOsI * nAOsI;
+    gatherBlocks(pseudoDensities.restricted, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, false,
+                 densityBlocks.topRows(blockSize));
+    fockBlocks.topRows(blockSize).noalias() = oneCenterCoulomb_.block(atomI) * densityBlocks.topRows(blockSize);
+    addBlocks(fockBlocks.topRows(blockSize), 1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI,
+              aoFocks.restricted);
 
     for (int atomJ : atomPairList.at(atomI)) {
-      const Eigen::MatrixXd& coulombMatrixIJ = *coulombContainer_->at(atomI).at(atomJ);
-      const Eigen::MatrixXd& exchangeMatrixIJ = *exchangeContainer_->at(atomI).at(atomJ);
-      int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
-      int startAOJ = cisData_.AOInfo.getFirstOrbitalIndex(atomJ);
-      // coulomb
-      tmpBlock = pseudoDensity.restricted.block(startAOJ, startAOJ, nAOsJ, nAOsJ);
-      tmpV = coulombMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsJ * nAOsJ);
-      fockMatrix.restricted.block(startAOI, startAOI, nAOsI, nAOsI) +=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
-
-      // exchange
-      tmpBlock = pseudoDensity.restricted.block(startAOI, startAOJ, nAOsI, nAOsJ);
-      tmpV = exchangeMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsI * nAOsJ);
-      fockMatrix.restricted.block(startAOJ, startAOI, nAOsJ, nAOsI) -=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsI);
-
-      Eigen::MatrixXd transposedMatrix = coulombMatrixIJ.transpose();
-      Eigen::MatrixXd transposedMatrixX = exchangeMatrixIJ.transpose();
-      // coulomb
-      tmpBlock = pseudoDensity.restricted.block(startAOI, startAOI, nAOsI, nAOsI);
-      tmpV = transposedMatrix * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsI * nAOsI);
-      fockMatrix.restricted.block(startAOJ, startAOJ, nAOsJ, nAOsJ) +=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsJ);
-      // exchange
-      tmpBlock = pseudoDensity.restricted.block(startAOJ, startAOI, nAOsJ, nAOsI);
-      tmpV = transposedMatrixX * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsJ * nAOsI);
-      fockMatrix.restricted.block(startAOI, startAOJ, nAOsI, nAOsJ) -=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsJ);
+      if (direct && isNegligible(atomI, atomJ, std::max(densityNorms[atomI], densityNorms[atomJ]),
+                                 offDiagonalNorm(pseudoDensities.restricted, cisData_.AOInfo, atomI, atomJ,
+                                                 firstVector, nVectors))) {
+        continue;
+      }
+      addTwoCenterCoulomb(atomI, atomJ, packedDensities, packedCoulomb);
+      addTwoCenterExchange(atomI, atomJ, pseudoDensities.restricted, firstVector, nVectors, aoFocks.restricted,
+                           densityBlocks, fockBlocks);
+    }
+    release(atomI, atomPairList);
+  }
+
+  for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
+    int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+    for (int k = 0; k < nVectors; ++k) {
+      const int row = (firstVector + k) * nAOs_;
+      addUnpacked(packedCoulomb[atomI].col(k), aoFocks.restricted.block(row + startAOI, startAOI, nAOsI, nAOsI));
     }
   }
-  return fockMatrix;
 }
 template<>
-inline Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>
-CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::buildFock(
-    const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& pseudoDensity,
-    std::map<int, std::vector<int>> atomPairList) const {
-  Eigen::MatrixXd tmpBlock(81, 81);
-  Eigen::VectorXd tmpV(81 * 81);
-  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> fockMatrix;
-  fockMatrix.restricted = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
+inline void CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>::buildFock(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& pseudoDensities,
+    int firstVector, int nVectors, const std::map<int, std::vector<int>>& atomPairList,
+    Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& aoFocks) const {
+  Eigen::MatrixXd densityBlocks(81, nVectors);
+  Eigen::MatrixXd fockBlocks(81, nVectors);
+  const bool direct = integralStorage_.mode == CISIntegralStorage::Mode::Direct;
+  // Out of core, the blocks of the next atom are read while the current atom is contracted.
+  prefetch(0, atomPairList);
   for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    prefetch(atomI + 1, atomPairList);
     int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
     int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
-    tmpBlock = pseudoDensity.restricted.block(startAOI, startAOI, nAOsI, nAOsI);
-    tmpV = *exchangeContainer_->at(atomI).at(atomI) *
-           Eigen::Map<const Eigen::VectorXd>(tmpBlock.transpose().data(), nAOsI * nAOsI);
-    fockMatrix.restricted.block(startAOI, startAOI, nAOsI, nAOsI) -=
-        Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
+    const int blockSize = nAOsI * nAOsI;
+    gatherBlocks(pseudoDensities.restricted, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, true,
+                 densityBlocks.topRows(blockSize));
+    fockBlocks.topRows(blockSize).noalias() = oneCenterExchange_.block(atomI) * densityBlocks.topRows(blockSize);
+    addBlocks(fockBlocks.topRows(blockSize), -1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI,
+              aoFocks.restricted);
 
     for (int atomJ : atomPairList.at(atomI)) {
-      const Eigen::MatrixXd& exchangeMatrixIJ = *exchangeContainer_->at(atomI).at(atomJ);
-      int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
-      int startAOJ = cisData_.AOInfo.getFirstOrbitalIndex(atomJ);
-      tmpBlock = pseudoDensity.restricted.block(startAOI, startAOJ, nAOsI, nAOsJ);
-      tmpV = exchangeMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsI * nAOsJ);
-      fockMatrix.restricted.block(startAOJ, startAOI, nAOsJ, nAOsI) -=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsI);
-      tmpBlock = pseudoDensity.restricted.block(startAOJ, startAOI, nAOsJ, nAOsI);
-      tmpV = exchangeMatrixIJ.transpose() * Eigen::Map<const Eigen::VectorXd>(tmpBlock.data(), nAOsJ * nAOsI);
-      fockMatrix.restricted.block(startAOI, startAOJ, nAOsI, nAOsJ) -=
-          Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsJ);
+      if (direct && isNegligible(atomI, atomJ, 0.0,
+                                 offDiagonalNorm(pseudoDensities.restricted, cisData_.AOInfo, atomI, atomJ,
+                                                 firstVector, nVectors))) {
+        continue;
+      }
+      addTwoCenterExchange(atomI, atomJ, pseudoDensities.restricted, firstVector, nVectors, aoFocks.restricted,
+                           densityBlocks, fockBlocks);
     }
+    release(atomI, atomPairList);
   }
-  return fockMatrix;
 }
 template<>
-inline Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>
-CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::buildFock(
-    const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& pseudoDensity,
-    std::map<int, std::vector<int>> atomPairList) const {
-  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> fockMatrix;
-  fockMatrix.alpha = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
-  fockMatrix.beta = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
-  Eigen::MatrixXd tmpBlockAlpha;
-  Eigen::MatrixXd tmpBlockBeta;
-  Eigen::VectorXd tmpV;
+inline void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet>::buildFock(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& pseudoDensities,
+    int firstVector, int nVectors, const std::map<int, std::vector<int>>& atomPairList,
+    Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& aoFocks) const {
+  Eigen::MatrixXd alphaBlocks(81, nVectors);
+  Eigen::MatrixXd betaBlocks(81, nVectors);
+  Eigen::MatrixXd fockBlocks(81, nVectors);
+
+  // The two-center Coulomb contributions of the total pseudo-density are accumulated on the packed diagonal blocks.
+  std::vector<Eigen::MatrixXd> packedDensities(nAtoms_);
+  std::vector<Eigen::MatrixXd> packedCoulomb(nAtoms_);
+  std::vector<double> densityNorms(nAtoms_);
   for (int atomI = 0; atomI < nAtoms_; atomI++) {
     int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
     int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+    packedDensities[atomI].resize(packedSize(nAOsI), nVectors);
+    for (int k = 0; k < nVectors; ++k) {
+      const int row = (firstVector + k) * nAOs_;
+      packedDensities[atomI].col(k) =
+          packSymmetrized(pseudoDensities.alpha.block(row + startAOI, startAOI, nAOsI, nAOsI) +
+                          pseudoDensities.beta.block(row + startAOI, startAOI, nAOsI, nAOsI));
+    }
+    packedCoulomb[atomI] = Eigen::MatrixXd::Zero(packedSize(nAOsI), nVectors);
+    densityNorms[atomI] = packedDensities[atomI].cwiseAbs().colwise().sum().maxCoeff();
+  }
+  const bool direct = integralStorage_.mode == CISIntegralStorage::Mode::Direct;
 
-    tmpBlockAlpha = pseudoDensity.alpha.block(startAOI, startAOI, nAOsI, nAOsI);
-    tmpV = *coulombContainer_->at(atomI).at(atomI) * Eigen::Map<const Eigen::VectorXd>(tmpBlockAlpha.data(), nAOsI * nAOsI);
+  // Out of core, the blocks of the next atom are read while the current atom is contracted.
+  prefetch(0, atomPairList);
+  for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    prefetch(atomI + 1, atomPairList);
+    int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
+    int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+    const int blockSize = nAOsI * nAOsI;
+    auto alpha = alphaBlocks.topRows(blockSize);
+    auto beta = betaBlocks.topRows(blockSize);
+    auto fock = fockBlocks.topRows(blockSize);
+    gatherBlocks(pseudoDensities.alpha, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, false, alpha);
+    gatherBlocks(pseudoDensities.beta, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, false, beta);
 
-    tmpBlockBeta = pseudoDensity.beta.block(startAOI, startAOI, nAOsI, nAOsI);
-    tmpV.noalias() +=
-        *coulombContainer_->at(atomI).at(atomI) * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsI * nAOsI);
-    fockMatrix.alpha.block(startAOI, startAOI, nAOsI, nAOsI) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
-    fockMatrix.beta.block(startAOI, startAOI, nAOsI, nAOsI) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
+    fock.noalias() = oneCenterCoulomb_.block(atomI) * (alpha + beta);
+    addBlocks(fock, 1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, aoFocks.alpha);
+    addBlocks(fock, 1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, aoFocks.beta);
 
-    tmpV = *exchangeContainer_->at(atomI).at(atomI) * Eigen::Map<const Eigen::VectorXd>(tmpBlockAlpha.data(), nAOsI * nAOsI);
-    fockMatrix.alpha.block(startAOI, startAOI, nAOsI, nAOsI) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
+    fock.noalias() = oneCenterExchange_.block(atomI) * alpha;
+    addBlocks(fock, -1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, aoFocks.alpha);
 
-    tmpV = *exchangeContainer_->at(atomI).at(atomI) * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsI * nAOsI);
-    fockMatrix.beta.block(startAOI, startAOI, nAOsI, nAOsI) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
+    fock.noalias() = oneCenterExchange_.block(atomI) * beta;
+    addBlocks(fock, -1.0, nAOs_, firstVector, startAOI, startAOI, nAOsI, nAOsI, aoFocks.beta);
 
     for (int atomJ : atomPairList.at(atomI)) {
-      const Eigen::MatrixXd& coulombMatrixIJ = *coulombContainer_->at(atomI).at(atomJ);
-      const Eigen::MatrixXd& exchangeMatrixIJ = *exchangeContainer_->at(atomI).at(atomJ);
-      int nAOsJ = cisData_.AOInfo.getNOrbitals(atomJ);
-      int startAOJ = cisData_.AOInfo.getFirstOrbitalIndex(atomJ);
+      if (direct &&
+          isNegligible(
+              atomI, atomJ, std::max(densityNorms[atomI], densityNorms[atomJ]),
+              std::max(offDiagonalNorm(pseudoDensities.alpha, cisData_.AOInfo, atomI, atomJ, firstVector, nVectors),
+                       offDiagonalNorm(pseudoDensities.beta, cisData_.AOInfo, atomI, atomJ, firstVector, nVectors)))) {
+        continue;
+      }
       // coulomb alpha + beta
-      tmpBlockAlpha = pseudoDensity.alpha.block(startAOI, startAOI, nAOsI, nAOsI);
-      tmpV = coulombMatrixIJ.transpose() * Eigen::Map<const Eigen::VectorXd>(tmpBlockAlpha.data(), nAOsI * nAOsI);
-
-      tmpBlockBeta = pseudoDensity.beta.block(startAOI, startAOI, nAOsI, nAOsI);
-      tmpV.noalias() += coulombMatrixIJ.transpose() * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsI * nAOsI);
-      fockMatrix.alpha.block(startAOJ, startAOJ, nAOsJ, nAOsJ) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsJ);
-      fockMatrix.beta.block(startAOJ, startAOJ, nAOsJ, nAOsJ) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsJ);
-
-      tmpBlockAlpha = pseudoDensity.alpha.block(startAOJ, startAOJ, nAOsJ, nAOsJ);
-      tmpV = coulombMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlockAlpha.data(), nAOsJ * nAOsJ);
-
-      tmpBlockBeta = pseudoDensity.beta.block(startAOJ, startAOJ, nAOsJ, nAOsJ);
-      tmpV.noalias() += coulombMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsJ * nAOsJ);
-      fockMatrix.alpha.block(startAOI, startAOI, nAOsI, nAOsI) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
-      fockMatrix.beta.block(startAOI, startAOI, nAOsI, nAOsI) += Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsI);
-
-      // exchange alpha
-      tmpBlockAlpha = pseudoDensity.alpha.block(startAOI, startAOJ, nAOsI, nAOsJ);
-      tmpV = exchangeMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlockAlpha.data(), nAOsI * nAOsJ);
-      fockMatrix.alpha.block(startAOJ, startAOI, nAOsJ, nAOsI) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsI);
-      tmpBlockBeta = pseudoDensity.alpha.block(startAOJ, startAOI, nAOsJ, nAOsI);
-      tmpV = exchangeMatrixIJ.transpose() * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsJ * nAOsI);
-      fockMatrix.alpha.block(startAOI, startAOJ, nAOsI, nAOsJ) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsJ);
-      // exchange beta
-
-      tmpBlockBeta = pseudoDensity.beta.block(startAOI, startAOJ, nAOsI, nAOsJ);
-      tmpV = exchangeMatrixIJ * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsI * nAOsJ);
-      fockMatrix.beta.block(startAOJ, startAOI, nAOsJ, nAOsI) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsJ, nAOsI);
-      tmpBlockBeta = pseudoDensity.beta.block(startAOJ, startAOI, nAOsJ, nAOsI);
-      tmpV = exchangeMatrixIJ.transpose() * Eigen::Map<const Eigen::VectorXd>(tmpBlockBeta.data(), nAOsJ * nAOsI);
-      fockMatrix.beta.block(startAOI, startAOJ, nAOsI, nAOsJ) -= Eigen::Map<const Eigen::MatrixXd>(tmpV.data(), nAOsI, nAOsJ);
+      addTwoCenterCoulomb(atomI, atomJ, packedDensities, packedCoulomb);
+      // exchange alpha and beta
+      addTwoCenterExchange(atomI, atomJ, pseudoDensities.alpha, firstVector, nVectors, aoFocks.alpha, alphaBlocks,
+                           fockBlocks);
+      addTwoCenterExchange(atomI, atomJ, pseudoDensities.beta, firstVector, nVectors, aoFocks.beta, alphaBlocks,
+                           fockBlocks);
+    }
+    release(atomI, atomPairList);
+  }
+
+  for (int atomI = 0; atomI < nAtoms_; atomI++) {
+    int nAOsI = cisData_.AOInfo.getNOrbitals(atomI);
+    int startAOI = cisData_.AOInfo.getFirstOrbitalIndex(atomI);
+    for (int k = 0; k < nVectors; ++k) {
+      const int row = (firstVector + k) * nAOs_;
+      addUnpacked(packedCoulomb[atomI].col(k), aoFocks.alpha.block(row + startAOI, startAOI, nAOsI, nAOsI));
+      addUnpacked(packedCoulomb[atomI].col(k), aoFocks.beta.block(row + startAOI, startAOI, nAOsI, nAOsI));
     }
   }
-  return fockMatrix;
 }
 
 template<>
-Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>
-CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::buildFock(
-    const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& /*pseudoDensity*/,
-    std::map<int, std::vector<int>> /*atomPairList*/) const {
-  throw std::runtime_error(" CISMatrixAOFockBuilder: Invalid combination: Calculation for an unrestricted reference "
-                           "with a triplet spin-transition not possible!.");
+void CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Triplet>::buildFock(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& /*pseudoDensities*/,
+    int /*firstVector*/, int /*nVectors*/, const std::map<int, std::vector<int>>& /*atomPairList*/,
+    Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& /*aoFocks*/) const {
+  throwInvalidCombination();
 }
 
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock>
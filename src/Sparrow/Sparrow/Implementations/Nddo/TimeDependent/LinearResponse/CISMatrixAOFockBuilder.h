@@ -8,6 +8,7 @@
 #ifndef SPARROW_CISMATRIXAOFOCKBUILDER_H
 #define SPARROW_CISMATRIXAOFOCKBUILDER_H
 
+#include "CISIntegralArena.h"
 #include "CISPseudoDensityBuilder.h"
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
 #include <Utils/Math/IterativeDiagonalizer/SigmaVectorEvaluator.h>
@@ -21,29 +22,106 @@ class CISMatrixAOFockBuilderBase {
   virtual Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>
   getAOFock(const Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& pseudoDensity,
             std::map<int, std::vector<int>> atomPairList) const = 0;
+  /**
+   * @brief Builds the pseudo-Fock matrices of several pseudo-densities in one pass over the atom pair list.
+   * The matrices of the vectors are stacked by rows: the one of vector k occupies the rows k * nAOs to (k + 1) * nAOs.
+   * @param pseudoDensities The stacked pseudo-density matrices.
+   * @param atomPairList The atom pairs contracted for all of the vectors.
+   * @param aoFocks The stacked pseudo-Fock matrices, its storage is reused if it has the right size already.
+   */
+  virtual void getAOFocks(const Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& pseudoDensities,
+                          const std::map<int, std::vector<int>>& atomPairList,
+                          Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>& aoFocks) const = 0;
   virtual ~CISMatrixAOFockBuilderBase() = default;
 };
 
+/**
+ * @brief Builds the pseudo-Fock matrix of the CIS sigma vectors from precalculated AO integral blocks.
+ *
+ * The one-center blocks of every atom and the two-center exchange blocks of every atom pair I < J are calculated in
+ * parallel once, at construction, and stored in CISIntegralArena instances. The two-center Coulomb integrals (mu
+ * nu|lambda sigma) are symmetric in mu, nu and in lambda, sigma; they are contracted by charge distribution with the
+ * symmetrized diagonal blocks of the pseudo-density, which is not symmetric. This is the layout of the Global2c2eMatrix
+ * of the ground state, so the Coulomb blocks are read from the two-center integral container of the CISData in
+ * every storage mode and never copied.
+ *
+ * With an out-of-core CISIntegralStorage, the two-center exchange blocks are written once to a memory-mapped scratch
+ * file and streamed atom by atom while building the pseudo-Fock matrix: the blocks of the next atom are read ahead and
+ * the blocks of every atom are released from the resident memory after their contraction.
+ *
+ * With an integral-direct CISIntegralStorage, no two-center block is stored: the exchange integrals are contracted
+ * straight from the two-center integral container as well, and only the largest integral of every atom pair is kept.
+ * A pair is skipped when this bound times the norm of the pseudo-density blocks it is contracted with falls below the
+ * screening threshold.
+ *
+ * Several pseudo-densities are contracted in a single pass over the atom pair list: the blocks of all vectors are
+ * gathered into the columns of a matrix, such that every integral block is applied to all of them in one matrix
+ * product. The vectors are split in one contiguous chunk per thread.
+ */
 template<Utils::Reference restrictedness, Utils::SpinTransition spinBlock = Utils::SpinTransition::Singlet>
 class CISMatrixAOFockBuilder : public CISMatrixAOFockBuilderBase<restrictedness> {
  public:
   using SAMType = Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>;
-  CISMatrixAOFockBuilder(CISData cisData, const ExcitedStatesParam& excitedStatesParam);
+  CISMatrixAOFockBuilder(CISData cisData, const ExcitedStatesParam& excitedStatesParam,
+                         const CISIntegralStorage& integralStorage = {});
   ~CISMatrixAOFockBuilder();
   SAMType getAOFock(const SAMType& pseudoDensity, std::map<int, std::vector<int>> atomPairList) const final;
+  void getAOFocks(const SAMType& pseudoDensities, const std::map<int, std::vector<int>>& atomPairList,
+                  SAMType& aoFocks) const final;
+  /**
+   * @brief Memory in bytes of the integrals the builder stores for the given atomic orbitals.
+   * Evaluated from the block shapes of the storage, without calculating any integral. Out of core, this is the bound
+   * of the resident memory: the one-center blocks and two atoms of two-center blocks per thread. Integral-direct, this
+   * is the one-center blocks and the integral bounds of the atom pairs.
+   */
+  static std::size_t getIntegralMemory(const Utils::AtomsOrbitalsIndexes& aoInfo,
+                                       const CISIntegralStorage& integralStorage = {});
+  //! @brief Heap memory in bytes of the integrals stored by this builder.
+  std::size_t getIntegralMemory() const;
+  //! @brief Size in bytes of the scratch files of the out-of-core integral storage.
+  std::size_t getScratchSize() const;
 
  private:
-  SAMType buildFock(const SAMType& pseudoDensity, std::map<int, std::vector<int>> atomPairList) const;
+  // Adds the pseudo-Fock matrices of the vectors firstVector to firstVector + nVectors - 1 to the stacked matrices.
+  void buildFock(const SAMType& pseudoDensities, int firstVector, int nVectors,
+                 const std::map<int, std::vector<int>>& atomPairList, SAMType& aoFocks) const;
   void initialize();
   void calculateMatrices();
   void calculate(int atomI, int atomJ);
   void calculate(int atomI);
-  Eigen::MatrixXd getCoulombIntegrals(int atomI, int atomJ);
-  Eigen::MatrixXd getExchangeIntegrals(int atomI, int atomJ);
+  void allocateTwoCenter(CISIntegralArena& arena, const std::vector<int>& rows, const std::vector<int>& cols);
+  // Reads ahead or releases the two-center blocks of the pairs of atom I within the atom pair list
+  void prefetch(int atomI, const std::map<int, std::vector<int>>& atomPairList) const;
+  void release(int atomI, const std::map<int, std::vector<int>>& atomPairList) const;
+  // Adds factor * c1 (mu nu|lambda sigma) of one atom in the full layout.
+  void addCoulombIntegrals(int atomI, Eigen::Ref<Eigen::MatrixXd> block, double factor) const;
+  // Adds factor * c2 (mu sigma|lambda nu), with mu, sigma on atom I and nu, lambda on atom J.
+  void addExchangeIntegrals(int atomI, int atomJ, Eigen::Ref<Eigen::MatrixXd> block, double factor) const;
+  // Adds the Coulomb contributions of the pair I < J to the packed diagonal blocks, one column per vector.
+  void addTwoCenterCoulomb(int atomI, int atomJ, const std::vector<Eigen::MatrixXd>& packedDensities,
+                           std::vector<Eigen::MatrixXd>& packedCoulomb) const;
+  // Adds the exchange contributions of the pair I < J to the off-diagonal blocks of the stacked pseudo-Fock matrices
+  // of the vectors firstVector to firstVector + nVectors - 1. The blocks of the vectors are gathered in the workspace.
+  void addTwoCenterExchange(int atomI, int atomJ, const Eigen::MatrixXd& pseudoDensities, int firstVector,
+                            int nVectors, Eigen::MatrixXd& fock, Eigen::MatrixXd& densityBlocks,
+                            Eigen::MatrixXd& fockBlocks) const;
+  // Whether the contributions of the pair I < J fall below the screening threshold of the integral-direct storage,
+  // given the norms of the pseudo-density blocks contracted with its Coulomb and exchange integrals.
+  bool isNegligible(int atomI, int atomJ, double coulombNorm, double exchangeNorm) const;
+  // Shapes of the one-center blocks by atom, and of the two-center blocks by atom pair
+  static void oneCenterShapes(const Utils::AtomsOrbitalsIndexes& aoInfo, std::vector<int>& rows,
+                              std::vector<int>& cols);
+  static void exchangeShapes(const Utils::AtomsOrbitalsIndexes& aoInfo, std::vector<int>& rows, std::vector<int>& cols);
   CISData cisData_;
   int nAtoms_{cisData_.AOInfo.getNAtoms()};
   int nAOs_{cisData_.AOInfo.getNAtomicOrbitals()};
-  std::shared_ptr<std::vector<std::map<int, std::unique_ptr<Eigen::MatrixXd>>>> coulombContainer_, exchangeContainer_;
+  // One-center blocks by atom, two-center exchange blocks by CISIntegralArena::pairIndex
+  CISIntegralArena oneCenterCoulomb_, oneCenterExchange_, exchange_;
+  CISIntegralStorage integralStorage_;
+  // Integral-direct, largest absolute two-center integral by CISIntegralArena::pairIndex
+  std::vector<double> pairBounds_;
+  // Factor of the Coulomb integrals in the pseudo-Fock matrix of the spin block
+  double coulombFactor_ = 0.0;
   static constexpr const double sparseThreshold_ = 1e-8;
   double c1_;
   double c2_;
@@ -16,14 +16,29 @@ template<Utils::Reference restrictedness>
 class CISMatrixAOFockBuilderFactory {
  public:
   static std::shared_ptr<CISMatrixAOFockBuilderBase<restrictedness>>
-  createAOFockBuilder(const Utils::SpinTransition spinBlock, CISData cisData, const ExcitedStatesParam& excitedStatesParam) {
+  createAOFockBuilder(const Utils::SpinTransition spinBlock, CISData cisData,
+                      const ExcitedStatesParam& excitedStatesParam, const CISIntegralStorage& integralStorage = {}) {
     switch (spinBlock) {
       case Utils::SpinTransition::Singlet:
         return std::make_shared<CISMatrixAOFockBuilder<restrictedness, Utils::SpinTransition::Singlet>>(
-            std::move(cisData), excitedStatesParam);
+            std::move(cisData), excitedStatesParam, integralStorage);
       case Utils::SpinTransition::Triplet:
         return std::make_shared<CISMatrixAOFockBuilder<restrictedness, Utils::SpinTransition::Triplet>>(
-            std::move(cisData), excitedStatesParam);
+            std::move(cisData), excitedStatesParam, integralStorage);
+      default:
+        throw std::runtime_error("Invalid spin-block argument in CISMatrixAOFockBuilderFactory.");
+    }
+  }
+  //! @brief Resident memory in bytes of the integrals stored by the AO Fock builder for the spin block.
+  static std::size_t getIntegralMemory(const Utils::SpinTransition spinBlock, const Utils::AtomsOrbitalsIndexes& aoInfo,
+                                       const CISIntegralStorage& integralStorage = {}) {
+    switch (spinBlock) {
+      case Utils::SpinTransition::Singlet:
+        return CISMatrixAOFockBuilder<restrictedness, Utils::SpinTransition::Singlet>::getIntegralMemory(
+            aoInfo, integralStorage);
+      case Utils::SpinTransition::Triplet:
+        return CISMatrixAOFockBuilder<restrictedness, Utils::SpinTransition::Triplet>::getIntegralMemory(
+            aoInfo, integralStorage);
       default:
         throw std::runtime_error("Invalid spin-block argument in CISMatrixAOFockBuilderFactory.");
     }
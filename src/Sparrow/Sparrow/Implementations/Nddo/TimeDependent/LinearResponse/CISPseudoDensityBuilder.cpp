@@ -6,6 +6,7 @@
  */
 
 #include "CISPseudoDensityBuilder.h"
+#include <cassert>
 
 namespace Scine {
 namespace Sparrow {
@@ -95,6 +96,42 @@ CISPseudoDensityBuilder<Utils::Reference::Restricted>::getPseudoDensityMatrix(
   return pseudoDensity;
 }
 
+template<>
+void CISPseudoDensityBuilder<Utils::Reference::Unrestricted>::getPseudoDensityMatrices(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& guessVectors,
+    Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd>& pseudoDensities) const {
+  mapAndMultiply(guessVectors.alpha, virtualMolecularOrbitals_.alpha, occupiedMolecularOrbitals_.alpha,
+                 halfTransformedVectors_.alpha, pseudoDensities.alpha);
+  mapAndMultiply(guessVectors.beta, virtualMolecularOrbitals_.beta, occupiedMolecularOrbitals_.beta,
+                 halfTransformedVectors_.beta, pseudoDensities.beta);
+}
+
+template<>
+void CISPseudoDensityBuilder<Utils::Reference::Restricted>::getPseudoDensityMatrices(
+    const Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& guessVectors,
+    Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd>& pseudoDensities) const {
+  mapAndMultiply(guessVectors.restricted, virtualMolecularOrbitals_.restricted, occupiedMolecularOrbitals_.restricted,
+                 halfTransformedVectors_.restricted, pseudoDensities.restricted);
+}
+
+template<Utils::Reference restrictedness>
+void CISPseudoDensityBuilder<restrictedness>::mapAndMultiply(const Eigen::MatrixXd& guessVectors,
+                                                             const Eigen::MatrixXd& virtualMOs,
+                                                             const Eigen::MatrixXd& occupiedMOs,
+                                                             Eigen::MatrixXd& halfTransformed,
+                                                             Eigen::MatrixXd& pseudoDensities) const {
+  const auto nAOs = virtualMOs.rows();
+  const auto nOccupied = occupiedMOs.cols();
+  const auto nVectors = guessVectors.cols();
+  assert(guessVectors.rows() == virtualMOs.cols() * nOccupied);
+  Eigen::Map<const Eigen::MatrixXd> mappedVectors(guessVectors.data(), virtualMOs.cols(), nOccupied * nVectors);
+  // Row i + nOccupied * k of the half-transformed vectors is column i of C_vir X_k.
+  halfTransformed.noalias() = mappedVectors.transpose() * virtualMOs.transpose();
+  pseudoDensities.resize(nVectors * nAOs, nAOs);
+  Eigen::Map<Eigen::MatrixXd>(pseudoDensities.data(), nAOs, nVectors * nAOs).noalias() =
+      occupiedMOs * Eigen::Map<const Eigen::MatrixXd>(halfTransformed.data(), nOccupied, nVectors * nAOs);
+}
+
 template<Utils::Reference restrictedness>
 Eigen::MatrixXd CISPseudoDensityBuilder<restrictedness>::mapAndMultiply(const Eigen::VectorXd& Vector,
                                                                         const Eigen::MatrixXd& virtualMOs,
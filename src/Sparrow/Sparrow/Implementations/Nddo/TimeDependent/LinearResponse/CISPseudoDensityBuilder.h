@@ -77,6 +77,18 @@ class CISPseudoDensityBuilder {
    * @return pseudoDensityMatrix
    */
   const SAMType getPseudoDensityMatrix(const Utils::SpinAdaptedContainer<restrictedness, Eigen::VectorXd>& guessVector) const;
+  /**
+   * @brief Evaluates the pseudo-density matrices of several guess vectors at once.
+   * The pseudo-densities are stacked by rows, the one of guess vector k occupies the rows k * nAOs to (k + 1) * nAOs.
+   * With this layout, the guess vectors are transformed by two matrix products over all of them, see
+   * \ref mapAndMultiply(const Eigen::MatrixXd &, const Eigen::MatrixXd &, const Eigen::MatrixXd &, Eigen::MatrixXd &,
+   * Eigen::MatrixXd &) const
+   * mapAndMultiply.
+   *
+   * @param guessVectors The guess vectors in standard order as columns, by spin block in the unrestricted case.
+   * @param pseudoDensities The stacked pseudo-density matrices, the storage is reused if it has the right size already.
+   */
+  void getPseudoDensityMatrices(const SAMType& guessVectors, SAMType& pseudoDensities) const;
   /**
    * @brief Getter for occupied block of coefficient matrix
    * @return occupiedOrbitals
@@ -96,10 +108,26 @@ class CISPseudoDensityBuilder {
    */
   Eigen::MatrixXd mapAndMultiply(const Eigen::VectorXd& Vector, const Eigen::MatrixXd& virtualMOs,
                                  const Eigen::MatrixXd& occupiedMOs) const;
+  /**
+   * @brief Stacked pseudo-densities of all columns of guessVectors.
+   * The guess vectors map to a virtual x (occupied x vectors) matrix X, such that T = X^T C_vir^T is a single product.
+   * The rows of T are ordered by vector within every occupied orbital, so that C_occ T, read as an nAOs x
+   * (vectors x nAOs) matrix, is the pseudo-density of vector k in the rows k * nAOs to (k + 1) * nAOs.
+   * @param guessVectors
+   * @param virtualMOs
+   * @param occupiedMOs
+   * @param halfTransformed Buffer for T.
+   * @param pseudoDensities
+   */
+  void mapAndMultiply(const Eigen::MatrixXd& guessVectors, const Eigen::MatrixXd& virtualMOs,
+                      const Eigen::MatrixXd& occupiedMOs, Eigen::MatrixXd& halfTransformed,
+                      Eigen::MatrixXd& pseudoDensities) const;
 
  private:
   SAMType occupiedMolecularOrbitals_;
   SAMType virtualMolecularOrbitals_;
+  // Half-transformed guess vectors of getPseudoDensityMatrices, kept to reuse the storage between calls.
+  mutable SAMType halfTransformedVectors_;
 };
 
 template<Utils::Reference restrictedness>
@@ -8,6 +8,7 @@
 #ifndef SPARROW_CISSETTINGS_H
 #define SPARROW_CISSETTINGS_H
 
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
 #include <Sparrow/Implementations/TimeDependent/LinearResponseSettings.h>
 
 namespace Scine {
@@ -24,8 +25,37 @@ class CISSettings : public LinearResponseSettings {
     distanceThreshold.setMinimum(0.0);
     distanceThreshold.setDefaultValue(std::numeric_limits<double>::max());
 
+    Utils::UniversalSettings::OptionListDescriptor integralStorage(
+        "Storage of the two-center integrals: in memory, in a memory-mapped scratch file, in the scratch file only "
+        "if the integrals in memory would exceed the maximum memory, or not at all with the integrals contracted "
+        "directly from the ones of the reference calculation.");
+    integralStorage.addOption("auto");
+    integralStorage.addOption("in_memory");
+    integralStorage.addOption("out_of_core");
+    integralStorage.addOption("direct");
+    integralStorage.setDefaultOption("auto");
+
+    Utils::UniversalSettings::StringDescriptor scratchDirectory(
+        "Directory of the scratch files of the out-of-core integral storage, the system temporary directory if empty.");
+    scratchDirectory.setDefaultValue("");
+
+    Utils::UniversalSettings::DoubleDescriptor directScreeningThreshold(
+        "Atom pairs are skipped in the direct integral storage if their largest integral times the norm of the "
+        "contracted pseudo-density blocks is below this threshold.");
+    directScreeningThreshold.setMinimum(0.0);
+    directScreeningThreshold.setDefaultValue(1e-10);
+
+    Utils::UniversalSettings::StringDescriptor checkpointFile(
+        "Checkpoint file of the reference calculation, in which the excited states are stored as guess for a restart, "
+        "empty for none.");
+    checkpointFile.setDefaultValue("");
+
     _fields.push_back(Utils::SettingsNames::excitedStatesParamFile, std::move(excitedStatesParamFile));
     _fields.push_back("distance_threshold", std::move(distanceThreshold));
+    _fields.push_back("integral_storage", std::move(integralStorage));
+    _fields.push_back("scratch_directory", std::move(scratchDirectory));
+    _fields.push_back("direct_screening_threshold", std::move(directScreeningThreshold));
+    _fields.push_back(SparrowSettingsNames::checkpointFile, std::move(checkpointFile));
     resetToDefaults();
   }
 };
@@ -17,14 +17,16 @@ CISSigmaVectorEvaluator<restrictedness>::CISSigmaVectorEvaluator(
     CISData cisData, const ExcitedStatesParam& excitedStatesParam,
     const Utils::SpinAdaptedContainer<restrictedness, Eigen::VectorXd>& energyDifferenceVector,
     const std::vector<std::multimap<double, int, std::greater<double>>>& integralsThresholds, std::vector<int> orderMap,
-    Utils::SpinTransition spinBlock)
+    Utils::SpinTransition spinBlock, const CISIntegralStorage& integralStorage)
   : cisData_(std::move(cisData)),
     energyDifferenceVector_(energyDifferenceVector),
     spinBlock_(spinBlock),
+    excitedStatesParam_(excitedStatesParam),
     integralsThresholds_(integralsThresholds),
     orderMap_(std::move(orderMap)) {
   currentSigmaMatrix_ = Eigen::MatrixXd(0, 0);
-  aoFockBuilder_ = CISMatrixAOFockBuilderFactory<restrictedness>::createAOFockBuilder(spinBlock, cisData, excitedStatesParam);
+  aoFockBuilder_ = CISMatrixAOFockBuilderFactory<restrictedness>::createAOFockBuilder(
+      spinBlock, cisData, excitedStatesParam, integralStorage);
   pseudoDensityBuilder_ =
       std::make_shared<CISPseudoDensityBuilder<restrictedness>>(cisData_.molecularOrbitals, cisData_.occupation);
   occupiedOrbitals_ = std::make_shared<Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>>(
@@ -51,6 +53,29 @@ double getMaxElement<Utils::Reference::Unrestricted>(
   return std::max(std::max(std::fabs(pseudoDensityMatrix.alpha.maxCoeff()), std::fabs(pseudoDensityMatrix.alpha.minCoeff())),
                   std::max(std::fabs(pseudoDensityMatrix.beta.maxCoeff()), std::fabs(pseudoDensityMatrix.beta.minCoeff())));
 }
+
+// Transforms the stacked AO pseudo-Fock matrices of all vectors to the MO blocks C_vir^T F_k C_occ, which are written
+// to the rows firstRow to firstRow + nVirtual * nOccupied of the columns of moFocks. The rows of F C_occ are ordered by
+// vector within every AO, read as an nAOs x (vectors x occupied) matrix the product with C_vir^T covers all vectors.
+void transformToMO(const Eigen::MatrixXd& aoFocks, const Eigen::MatrixXd& virtualMOs,
+                   const Eigen::MatrixXd& occupiedMOs, Eigen::MatrixXd& halfTransformed, Eigen::MatrixXd& transformed,
+                   int firstRow, Eigen::MatrixXd& moFocks) {
+  const int nAOs = occupiedMOs.rows();
+  const int nOccupied = occupiedMOs.cols();
+  const int nVirtual = virtualMOs.cols();
+  const int nVectors = moFocks.cols();
+  assert(aoFocks.rows() == nVectors * nAOs);
+  halfTransformed.noalias() = aoFocks * occupiedMOs;
+  transformed.noalias() =
+      virtualMOs.transpose() * Eigen::Map<const Eigen::MatrixXd>(halfTransformed.data(), nAOs, nVectors * nOccupied);
+  // Column k + nVectors * i of the transformed matrices is column i of the MO block of vector k.
+  const Eigen::OuterStride<> vectorStride(nVectors * nVirtual);
+  for (int k = 0; k < nVectors; ++k) {
+    Eigen::Map<Eigen::MatrixXd>(moFocks.col(k).data() + firstRow, nVirtual, nOccupied) =
+        Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>(transformed.data() + k * nVirtual, nVirtual,
+                                                                   nOccupied, vectorStride);
+  }
+}
 } // namespace
 
 template<Utils::Reference restrictedness>
@@ -89,35 +114,23 @@ CISSigmaVectorEvaluator<Utils::Reference::Restricted>::evaluate(const Eigen::Mat
   const int dimCols = guessVectors.cols();
   const int dimRows = guessVectors.rows();
   const int colsNewSigmas = dimCols - colsOldGuess;
-  const int nExcitations = energyDifferenceVector_.restricted.size();
-
-  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::VectorXd> newGuessVector;
-
-  Eigen::MatrixXd sigmaMatrix;
-  sigmaMatrix.conservativeResize(dimRows, colsNewSigmas);
-
   assert(dimRows == energyDifferenceVector_.restricted.rows());
-
-#pragma omp parallel for schedule(dynamic) default(none) shared(sigmaMatrix, guessVectors) \
-    firstprivate(colsOldGuess, dimCols, nExcitations) private(newGuessVector)
-  for (int col = colsOldGuess; col < dimCols; col++) {
-    TimeDependentUtils::transformOrder(guessVectors.col(col), newGuessVector.restricted, orderMap_,
-                                       TimeDependentUtils::Direction::From);
-    const auto pseudoDensityMatrix = pseudoDensityBuilder_->getPseudoDensityMatrix(newGuessVector);
-    Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> aoFockMatrix =
-        aoFockBuilder_->getAOFock(pseudoDensityMatrix, generateAtomPairList(pseudoDensityMatrix));
-    const Eigen::MatrixXd moFock =
-        virtualOrbitals_->restricted.transpose() * aoFockMatrix.restricted * occupiedOrbitals_->restricted;
-    Eigen::VectorXd sigmaVector(nExcitations);
-    sigmaVector = Eigen::Map<const Eigen::VectorXd>(moFock.data(), moFock.size()) +
-                  newGuessVector.restricted.cwiseProduct(energyDifferenceVector_.restricted);
-    sigmaMatrix.col(col - colsOldGuess) = sigmaVector;
+  if (colsNewSigmas == 0) {
+    return currentSigmaMatrix_;
   }
-  Eigen::MatrixXd reorderedSigmaMatrix;
-  TimeDependentUtils::transformOrder(sigmaMatrix, reorderedSigmaMatrix, orderMap_, TimeDependentUtils::Direction::To);
+
+  TimeDependentUtils::transformOrder(guessVectors.rightCols(colsNewSigmas), newGuessVectors_.restricted, orderMap_,
+                                     TimeDependentUtils::Direction::From);
+  pseudoDensityBuilder_->getPseudoDensityMatrices(newGuessVectors_, pseudoDensities_);
+  aoFockBuilder_->getAOFocks(pseudoDensities_, generateAtomPairList(pseudoDensities_), aoFocks_);
+  newSigmaVectors_.resize(dimRows, colsNewSigmas);
+  transformToMO(aoFocks_.restricted, virtualOrbitals_->restricted, occupiedOrbitals_->restricted,
+                halfTransformedFocks_, transformedFocks_, 0, newSigmaVectors_);
+  newSigmaVectors_ += energyDifferenceVector_.restricted.asDiagonal() * newGuessVectors_.restricted;
+
   currentSigmaMatrix_.conservativeResize(dimRows, dimCols);
-  assert(reorderedSigmaMatrix.cols() == colsNewSigmas && reorderedSigmaMatrix.rows() == dimRows);
-  currentSigmaMatrix_.block(0, colsOldGuess, dimRows, colsNewSigmas) = reorderedSigmaMatrix;
+  TimeDependentUtils::transformOrder(newSigmaVectors_, currentSigmaMatrix_.rightCols(colsNewSigmas), orderMap_,
+                                     TimeDependentUtils::Direction::To);
   return currentSigmaMatrix_;
 }
 
@@ -132,42 +145,104 @@ CISSigmaVectorEvaluator<Utils::Reference::Unrestricted>::evaluate(const Eigen::M
   const int nExcitationsAlpha = energyDifferenceVector_.alpha.size();
   const int nExcitationsBeta = energyDifferenceVector_.beta.size();
   assert(nExcitationsAlpha + nExcitationsBeta == dimRows);
+  if (colsNewSigmas == 0) {
+    return currentSigmaMatrix_;
+  }
 
-  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::VectorXd> newGuessVector;
-  Eigen::MatrixXd sigmaMatrix(dimRows, colsNewSigmas);
-
-#pragma omp parallel for schedule(dynamic) default(none) shared(sigmaMatrix, guessVectors) \
-    firstprivate(colsOldGuess, dimCols, nExcitationsAlpha, nExcitationsBeta) private(newGuessVector)
-  for (int col = colsOldGuess; col < dimCols; col++) {
-    Eigen::VectorXd reorderedVector;
-    TimeDependentUtils::transformOrder(guessVectors.col(col), reorderedVector, orderMap_, TimeDependentUtils::Direction::From);
-
-    newGuessVector.alpha = reorderedVector.head(nExcitationsAlpha);
-    newGuessVector.beta = reorderedVector.tail(nExcitationsBeta);
-    auto const pseudoDensityMatrix = pseudoDensityBuilder_->getPseudoDensityMatrix(newGuessVector);
-
-    Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> aoFockMatrix =
-        aoFockBuilder_->getAOFock(pseudoDensityMatrix, generateAtomPairList(pseudoDensityMatrix));
+  TimeDependentUtils::transformOrder(guessVectors.rightCols(colsNewSigmas), reorderedGuessVectors_, orderMap_,
+                                     TimeDependentUtils::Direction::From);
+  newGuessVectors_.alpha = reorderedGuessVectors_.topRows(nExcitationsAlpha);
+  newGuessVectors_.beta = reorderedGuessVectors_.bottomRows(nExcitationsBeta);
+  pseudoDensityBuilder_->getPseudoDensityMatrices(newGuessVectors_, pseudoDensities_);
+  aoFockBuilder_->getAOFocks(pseudoDensities_, generateAtomPairList(pseudoDensities_), aoFocks_);
 
-    const Eigen::MatrixXd moAlphaFock = virtualOrbitals_->alpha.transpose() * aoFockMatrix.alpha * occupiedOrbitals_->alpha;
-    const Eigen::MatrixXd moBetaFock = virtualOrbitals_->beta.transpose() * aoFockMatrix.beta * occupiedOrbitals_->beta;
+  newSigmaVectors_.resize(dimRows, colsNewSigmas);
+  transformToMO(aoFocks_.alpha, virtualOrbitals_->alpha, occupiedOrbitals_->alpha, halfTransformedFocks_,
+                transformedFocks_, 0, newSigmaVectors_);
+  transformToMO(aoFocks_.beta, virtualOrbitals_->beta, occupiedOrbitals_->beta, halfTransformedFocks_,
+                transformedFocks_, nExcitationsAlpha, newSigmaVectors_);
+  newSigmaVectors_.topRows(nExcitationsAlpha) += energyDifferenceVector_.alpha.asDiagonal() * newGuessVectors_.alpha;
+  newSigmaVectors_.bottomRows(nExcitationsBeta) += energyDifferenceVector_.beta.asDiagonal() * newGuessVectors_.beta;
 
-    Eigen::VectorXd sigmaVectorAlpha(nExcitationsAlpha);
-    Eigen::VectorXd sigmaVectorBeta(nExcitationsBeta);
+  currentSigmaMatrix_.conservativeResize(dimRows, dimCols);
+  TimeDependentUtils::transformOrder(newSigmaVectors_, currentSigmaMatrix_.rightCols(colsNewSigmas), orderMap_,
+                                     TimeDependentUtils::Direction::To);
+  return currentSigmaMatrix_;
+}
 
-    sigmaVectorAlpha = Eigen::Map<const Eigen::VectorXd>(moAlphaFock.data(), moAlphaFock.size());
-    sigmaVectorBeta = Eigen::Map<const Eigen::VectorXd>(moBetaFock.data(), moBetaFock.size());
+namespace {
+// (ss|ss) integrals of all atom pairs, the interaction of the atomic monopoles.
+Eigen::MatrixXd monopoleIntegrals(const CISData& cisData) {
+  const int nAtoms = cisData.AOInfo.getNAtoms();
+  Eigen::MatrixXd gamma(nAtoms, nAtoms);
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    gamma(atomI, atomI) = cisData.oneCenterIntegrals.get(cisData.elements[atomI]).get(0, 0, 0, 0);
+    for (int atomJ = atomI + 1; atomJ < nAtoms; ++atomJ) {
+      gamma(atomI, atomJ) = gamma(atomJ, atomI) = cisData.twoCenterIntegrals.get(atomI, atomJ)->get(0, 0, 0, 0);
+    }
+  }
+  return gamma;
+}
 
-    sigmaMatrix.col(col - colsOldGuess)
-        << reorderedVector.head(nExcitationsAlpha).cwiseProduct(energyDifferenceVector_.alpha) + sigmaVectorAlpha,
-        reorderedVector.tail(nExcitationsBeta).cwiseProduct(energyDifferenceVector_.beta) + sigmaVectorBeta;
+// coulombFactor * (ia|ia) - exchangeFactor * (ii|aa) of one spin block in standard order, with the integrals
+// approximated by the interaction of the atomic monopoles of the orbital products.
+Eigen::VectorXd monopoleCouplingDiagonal(const Eigen::MatrixXd& occupied, const Eigen::MatrixXd& virtuals,
+                                         const Eigen::MatrixXd& gamma, const Utils::AtomsOrbitalsIndexes& aoInfo,
+                                         double coulombFactor, double exchangeFactor) {
+  const int nOccupied = occupied.cols();
+  const int nVirtual = virtuals.cols();
+  const int nAtoms = aoInfo.getNAtoms();
+  Eigen::MatrixXd transitionCharges(nOccupied * nVirtual, nAtoms);
+  Eigen::MatrixXd occupiedCharges(nOccupied, nAtoms);
+  Eigen::MatrixXd virtualCharges(nVirtual, nAtoms);
+  for (int atom = 0; atom < nAtoms; ++atom) {
+    const int firstAO = aoInfo.getFirstOrbitalIndex(atom);
+    const int nAOs = aoInfo.getNOrbitals(atom);
+    // The virtual index runs fastest, as in the standard order of the excitations.
+    const Eigen::MatrixXd charges = virtuals.middleRows(firstAO, nAOs).transpose() * occupied.middleRows(firstAO, nAOs);
+    transitionCharges.col(atom) = Eigen::Map<const Eigen::VectorXd>(charges.data(), charges.size());
+    occupiedCharges.col(atom) = occupied.middleRows(firstAO, nAOs).cwiseAbs2().colwise().sum().transpose();
+    virtualCharges.col(atom) = virtuals.middleRows(firstAO, nAOs).cwiseAbs2().colwise().sum().transpose();
   }
+  Eigen::VectorXd coupling =
+      coulombFactor * (transitionCharges.array() * (transitionCharges * gamma).array()).rowwise().sum().matrix();
+  const Eigen::MatrixXd exchange = virtualCharges * gamma * occupiedCharges.transpose();
+  coupling -= exchangeFactor * Eigen::Map<const Eigen::VectorXd>(exchange.data(), exchange.size());
+  return coupling;
+}
+} // namespace
 
-  Eigen::MatrixXd reorderedSigmaMatrix;
-  TimeDependentUtils::transformOrder(sigmaMatrix, reorderedSigmaMatrix, orderMap_, TimeDependentUtils::Direction::To);
-  currentSigmaMatrix_.conservativeResize(dimRows, dimCols);
-  currentSigmaMatrix_.block(0, colsOldGuess, dimRows, colsNewSigmas) = reorderedSigmaMatrix;
-  return currentSigmaMatrix_;
+template<>
+Eigen::VectorXd CISSigmaVectorEvaluator<Utils::Reference::Restricted>::diagonal() const {
+  // Singlet: 2 c1 (ia|ia) - c2 (ii|aa), triplet: - c2 (ii|aa)
+  const double coulombFactor = spinBlock_ == Utils::SpinTransition::Singlet ? 2.0 * excitedStatesParam_.c1 : 0.0;
+  const Eigen::VectorXd standardDiagonal =
+      energyDifferenceVector_.restricted +
+      monopoleCouplingDiagonal(occupiedOrbitals_->restricted, virtualOrbitals_->restricted, monopoleIntegrals(cisData_),
+                               cisData_.AOInfo, coulombFactor, excitedStatesParam_.c2);
+  Eigen::VectorXd orderedDiagonal;
+  TimeDependentUtils::transformOrder(standardDiagonal, orderedDiagonal, orderMap_, TimeDependentUtils::Direction::To);
+  return orderedDiagonal;
+}
+
+template<>
+Eigen::VectorXd CISSigmaVectorEvaluator<Utils::Reference::Unrestricted>::diagonal() const {
+  // c1 (ia|ia) - c2 (ii|aa) within each spin block
+  const Eigen::MatrixXd gamma = monopoleIntegrals(cisData_);
+  const int nExcitationsAlpha = energyDifferenceVector_.alpha.size();
+  const int nExcitationsBeta = energyDifferenceVector_.beta.size();
+  Eigen::VectorXd standardDiagonal(nExcitationsAlpha + nExcitationsBeta);
+  const double c1 = excitedStatesParam_.c1;
+  const double c2 = excitedStatesParam_.c2;
+  standardDiagonal.head(nExcitationsAlpha) =
+      energyDifferenceVector_.alpha +
+      monopoleCouplingDiagonal(occupiedOrbitals_->alpha, virtualOrbitals_->alpha, gamma, cisData_.AOInfo, c1, c2);
+  standardDiagonal.tail(nExcitationsBeta) =
+      energyDifferenceVector_.beta +
+      monopoleCouplingDiagonal(occupiedOrbitals_->beta, virtualOrbitals_->beta, gamma, cisData_.AOInfo, c1, c2);
+  Eigen::VectorXd orderedDiagonal;
+  TimeDependentUtils::transformOrder(standardDiagonal, orderedDiagonal, orderMap_, TimeDependentUtils::Direction::To);
+  return orderedDiagonal;
 }
 
 template<Utils::Reference restrictedness>
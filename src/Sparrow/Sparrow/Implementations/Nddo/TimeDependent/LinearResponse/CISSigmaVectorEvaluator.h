@@ -8,6 +8,7 @@
 #define SPARROW_CISSIGMAVECTOREVALUATOR_H
 
 #include "CISData.h"
+#include "CISIntegralArena.h"
 #include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISPseudoDensityBuilder.h>
 #include <Sparrow/Implementations/TimeDependent/TimeDependentUtils.h>
 #include <Utils/DataStructures/OccupiedMolecularOrbitals.h>
@@ -61,19 +62,30 @@ class CISSigmaVectorEvaluator final : public Utils::SigmaVectorEvaluator {
                                    const Utils::SpinAdaptedContainer<restrictedness, Eigen::VectorXd>& energyDifferenceVector,
                                    const std::vector<std::multimap<double, int, std::greater<double>>>& integralsThresholds,
                                    std::vector<int> orderMap,
-                                   Utils::SpinTransition spinBlock = Utils::SpinTransition::Singlet);
+                                   Utils::SpinTransition spinBlock = Utils::SpinTransition::Singlet,
+                                   const CISIntegralStorage& integralStorage = {});
   /**
    * @brief Destructor
    */
   ~CISSigmaVectorEvaluator() final;
 
   /**
-   * @brief Evaluates the sigma vectors in a loop over all new guess vectors and inserts them in the currentSigmaMatrix_
+   * @brief Evaluates the sigma vectors of all new guess vectors at once and inserts them in the currentSigmaMatrix_
    * variable (specified for both references).
+   * The pseudo-densities of the new guess vectors are stacked by rows, their pseudo-Fock matrices are built in one pass
+   * over the atom pair list and transformed to the MO basis by two matrix products over all vectors. The buffers of
+   * the stacked matrices are kept between the Davidson iterations.
    * @param guessVectors
    * @return
    */
   const Eigen::MatrixXd& evaluate(const Eigen::MatrixXd& guessVectors) const final;
+  /**
+   * @brief Approximate diagonal of the CIS matrix, in increasing energy order.
+   * The integrals (ia|ia) and (ii|aa) are approximated by the interaction of the atomic monopoles of the orbital
+   * products, q^A_{pq} = \sum_{\mu \in A} C_{\mu p} C_{\mu q}, through the (ss|ss) integrals of the atom pairs.
+   * Cheaper than a single sigma vector, it is used for the preconditioner and the guess of the Davidson diagonalizer.
+   */
+  Eigen::VectorXd diagonal() const;
 
  private:
   std::map<int, std::vector<int>>
@@ -87,11 +99,20 @@ class CISSigmaVectorEvaluator final : public Utils::SigmaVectorEvaluator {
   std::shared_ptr<CISMatrixAOFockBuilderBase<restrictedness>> aoFockBuilder_;
   Utils::SpinAdaptedContainer<restrictedness, Eigen::VectorXd> energyDifferenceVector_;
   Utils::SpinTransition spinBlock_{Utils::SpinTransition::Singlet};
+  ExcitedStatesParam excitedStatesParam_;
   std::shared_ptr<CISPseudoDensityBuilder<restrictedness>> pseudoDensityBuilder_;
   std::shared_ptr<Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>> occupiedOrbitals_;
   std::shared_ptr<Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd>> virtualOrbitals_;
   const std::vector<std::multimap<double, int, std::greater<double>>>& integralsThresholds_;
   std::vector<int> orderMap_;
+  // Buffers of the batched evaluation of the new sigma vectors, reused between Davidson iterations.
+  mutable Eigen::MatrixXd reorderedGuessVectors_;
+  mutable Eigen::MatrixXd halfTransformedFocks_;
+  mutable Eigen::MatrixXd transformedFocks_;
+  mutable Eigen::MatrixXd newSigmaVectors_;
+  mutable Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd> newGuessVectors_;
+  mutable Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd> pseudoDensities_;
+  mutable Utils::SpinAdaptedContainer<restrictedness, Eigen::MatrixXd> aoFocks_;
 };
 } // namespace Sparrow
 } // namespace Scine
@@ -8,6 +8,21 @@
 #include "CISSpinContaminator.h"
 namespace Scine {
 namespace Sparrow {
+
+namespace {
+// Block of the alpha-beta MO overlap between the given alpha and beta orbitals.
+Eigen::MatrixXd overlapBlock(const Eigen::MatrixXd& spatialOverlap, const std::vector<int>& alphaOrbitals,
+                             const std::vector<int>& betaOrbitals) {
+  Eigen::MatrixXd block(alphaOrbitals.size(), betaOrbitals.size());
+  for (int q = 0; q < static_cast<int>(betaOrbitals.size()); ++q) {
+    for (int p = 0; p < static_cast<int>(alphaOrbitals.size()); ++p) {
+      block(p, q) = spatialOverlap(alphaOrbitals[p], betaOrbitals[q]);
+    }
+  }
+  return block;
+}
+} // namespace
+
 Eigen::VectorXd CISSpinContaminator::calculateSpinContaminationOpenShell(
     const Utils::MolecularOrbitals& mos, const Eigen::MatrixXd& eigenVectors, const std::vector<int>& filledAlpha,
     const std::vector<int>& filledBeta,
@@ -26,16 +41,23 @@ Eigen::VectorXd CISSpinContaminator::calculateSpinContaminationOpenShell(
 
   TimeDependentUtils::generateVirtualOrbitalIndices(filledAlpha, virtualAlpha);
   TimeDependentUtils::generateVirtualOrbitalIndices(filledBeta, virtualBeta);
+  const int nAlphaVirtual = virtualAlpha.size();
+  const int nBetaVirtual = virtualBeta.size();
+
+  const Eigen::MatrixXd occupiedOverlap = overlapBlock(spatialOverlap, filledAlpha, filledBeta);
+  const Eigen::MatrixXd virtualOverlap = overlapBlock(spatialOverlap, virtualAlpha, virtualBeta);
+  const Eigen::MatrixXd virtualAlphaOccupiedBeta = overlapBlock(spatialOverlap, virtualAlpha, filledBeta);
+  const Eigen::MatrixXd occupiedAlphaVirtualBeta = overlapBlock(spatialOverlap, filledAlpha, virtualBeta);
 
   auto nAlphaExc = nAlphaElectrons * virtualAlpha.size();
   auto nBetaExc = nBetaElectrons * virtualBeta.size();
-  Eigen::MatrixXd sparseEigenVectorsAlpha = Eigen::MatrixXd::Zero(nAlphaExc, eigenvalues);
-  Eigen::MatrixXd sparseEigenVectorsBeta = Eigen::MatrixXd::Zero(nBetaExc, eigenvalues);
-  if (excitationIndices.alpha.size() == nAlphaExc && excitationIndices.beta.size() == nBetaExc) {
-    sparseEigenVectorsAlpha = eigenVectors.block(0, 0, nAlphaExc, eigenvalues);
-    sparseEigenVectorsBeta = eigenVectors.block(nAlphaExc, 0, nBetaExc, eigenvalues);
-  }
-  else {
+  // Complete excitation spaces are read in place, pruned ones are scattered into the complete space.
+  const bool completeSpace = excitationIndices.alpha.size() == nAlphaExc && excitationIndices.beta.size() == nBetaExc;
+  Eigen::MatrixXd sparseEigenVectorsAlpha;
+  Eigen::MatrixXd sparseEigenVectorsBeta;
+  if (!completeSpace) {
+    sparseEigenVectorsAlpha = Eigen::MatrixXd::Zero(nAlphaExc, eigenvalues);
+    sparseEigenVectorsBeta = Eigen::MatrixXd::Zero(nBetaExc, eigenvalues);
     int iter = 0;
     for (int exc : excitationIndices.alpha) {
       sparseEigenVectorsAlpha.row(exc) = eigenVectors.row(iter);
@@ -46,150 +68,55 @@ Eigen::VectorXd CISSpinContaminator::calculateSpinContaminationOpenShell(
       iter++;
     }
   }
+  const double* alphaCoefficients = completeSpace ? eigenVectors.data() : sparseEigenVectorsAlpha.data();
+  const double* betaCoefficients = completeSpace ? eigenVectors.data() + nAlphaExc : sparseEigenVectorsBeta.data();
+  const Eigen::Index alphaStride = completeSpace ? eigenVectors.rows() : static_cast<Eigen::Index>(nAlphaExc);
+  const Eigen::Index betaStride = completeSpace ? eigenVectors.rows() : static_cast<Eigen::Index>(nBetaExc);
+
   double nDiff = static_cast<double>(nAlphaElectrons - nBetaElectrons) / 2.;
   double sUHF = (nDiff * (nDiff + 1.)) + static_cast<double>(nBetaElectrons);
+  sUHF -= occupiedOverlap.squaredNorm();
 
-  for (int occI : filledAlpha) {
-    for (int occJ : filledBeta) {
-      sUHF -= std::pow(spatialOverlap(occI, occJ), 2);
-    }
-  }
+#pragma omp parallel for schedule(dynamic)
   for (int eV = 0; eV < eigenvalues; ++eV) {
-    const Eigen::VectorXd& alphaCoeffs = sparseEigenVectorsAlpha.col(eV);
-    const Eigen::VectorXd& betaCoeffs = sparseEigenVectorsBeta.col(eV);
+    // The coefficient of the excitation i -> a is at i * nVirtual + a, i.e. at (a, i) of a column-major matrix.
+    Eigen::Map<const Eigen::MatrixXd> alphaAmplitudes(alphaCoefficients + eV * alphaStride, nAlphaVirtual,
+                                                      nAlphaElectrons);
+    Eigen::Map<const Eigen::MatrixXd> betaAmplitudes(betaCoefficients + eV * betaStride, nBetaVirtual, nBetaElectrons);
     double sCeV = sUHF;
-    sCeV -= ab_j_iAlpha(spatialOverlap, alphaCoeffs, virtualAlpha, filledBeta, filledAlpha);
-    sCeV -= ab_j_iBeta(spatialOverlap, betaCoeffs, virtualBeta, filledAlpha, filledBeta);
-    sCeV -= ij_k_aAlpha(spatialOverlap, alphaCoeffs, filledAlpha, virtualAlpha, filledBeta);
-    sCeV -= ij_k_aBeta(spatialOverlap, betaCoeffs, filledBeta, virtualBeta, filledAlpha);
-    sCeV -= ijab(spatialOverlap, alphaCoeffs, betaCoeffs, filledAlpha, virtualAlpha, filledBeta, virtualBeta);
+    sCeV -= ab_j_iAlpha(alphaAmplitudes, virtualAlphaOccupiedBeta);
+    sCeV -= ab_j_iBeta(betaAmplitudes, occupiedAlphaVirtualBeta);
+    sCeV -= ij_k_aAlpha(alphaAmplitudes, occupiedOverlap);
+    sCeV -= ij_k_aBeta(betaAmplitudes, occupiedOverlap);
+    sCeV -= ijab(alphaAmplitudes, betaAmplitudes, occupiedOverlap, virtualOverlap);
     spinContamination[eV] = sCeV;
   }
 
   return spinContamination;
 }
 
-double CISSpinContaminator::ab_j_iAlpha(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs,
-                                        const std::vector<int>& virtualAlpha, const std::vector<int>& occupiedBeta,
-                                        const std::vector<int>& occupiedAlpha) {
-  double contribution = 0.;
-  int alphaVir = virtualAlpha.size();
-  int alphaOcc = occupiedAlpha.size();
-  for (int a = 0; a < alphaVir; a++) {
-    int virA = virtualAlpha[a];
-    for (int b = 0; b < alphaVir; b++) {
-      int virB = virtualAlpha[b];
-      double spatial = 0.;
-      for (int occJ : occupiedBeta) {
-        spatial += spatialOverlap(virA, occJ) * spatialOverlap(virB, occJ);
-      }
-      double coeffs = 0.;
-      for (int i = 0; i < alphaOcc; i++) {
-        coeffs += alphaCoeffs(i * alphaVir + a) * alphaCoeffs(i * alphaVir + b);
-      }
-      contribution += coeffs * spatial;
-    }
-  }
-  return contribution;
+double CISSpinContaminator::ab_j_iAlpha(const Amplitudes& alphaAmplitudes,
+                                        const Eigen::MatrixXd& virtualAlphaOccupiedBeta) {
+  return (alphaAmplitudes.transpose() * virtualAlphaOccupiedBeta).squaredNorm();
 }
 
-double CISSpinContaminator::ab_j_iBeta(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& betaCoeffs,
-                                       const std::vector<int>& virtualBeta, const std::vector<int>& occupiedAlpha,
-                                       const std::vector<int>& occupiedBeta) {
-  double contribution = 0.;
-  int betaVir = virtualBeta.size();
-  int betOcc = occupiedBeta.size();
-  for (int a = 0; a < betaVir; a++) {
-    int virA = virtualBeta[a];
-    for (int b = 0; b < betaVir; b++) {
-      int virB = virtualBeta[b];
-      double spatial = 0.;
-      for (int occJ : occupiedAlpha) {
-        spatial += spatialOverlap(occJ, virA) * spatialOverlap(occJ, virB);
-      }
-      double coeffs = 0.;
-      for (int i = 0; i < betOcc; i++) {
-        coeffs += betaCoeffs(i * betaVir + a) * betaCoeffs(i * betaVir + a);
-      }
-      contribution += coeffs * spatial;
-    }
-  }
-  return contribution;
+double CISSpinContaminator::ab_j_iBeta(const Amplitudes& betaAmplitudes,
+                                       const Eigen::MatrixXd& occupiedAlphaVirtualBeta) {
+  return (occupiedAlphaVirtualBeta * betaAmplitudes).squaredNorm();
 }
 
-double CISSpinContaminator::ij_k_aAlpha(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs,
-                                        const std::vector<int>& occupiedAlpha, const std::vector<int>& virtualAlpha,
-                                        const std::vector<int>& occupiedBeta) {
-  double contribution = 0.;
-  int alphaVir = virtualAlpha.size();
-  int alphaOcc = occupiedAlpha.size();
-  for (int i = 0; i < alphaOcc; i++) {
-    int occI = occupiedAlpha[i];
-    for (int j = 0; j < alphaOcc; j++) {
-      int occJ = occupiedAlpha[j];
-      double spatial = 0.;
-      for (int occK : occupiedBeta) {
-        spatial += spatialOverlap(occI, occK) * spatialOverlap(occJ, occK);
-      }
-      double coeffs = 0.;
-      for (int a = 0; a < alphaVir; a++) {
-        coeffs -= alphaCoeffs(i * alphaVir + a) * alphaCoeffs(j * alphaVir + a);
-      }
-      contribution += coeffs * spatial;
-    }
-  }
-  return contribution;
+double CISSpinContaminator::ij_k_aAlpha(const Amplitudes& alphaAmplitudes, const Eigen::MatrixXd& occupiedOverlap) {
+  return -(alphaAmplitudes * occupiedOverlap).squaredNorm();
 }
 
-double CISSpinContaminator::ij_k_aBeta(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& betaCoeffs,
-                                       const std::vector<int>& occupiedBeta, const std::vector<int>& virtualBeta,
-                                       const std::vector<int>& occupiedAlpha) {
-  double contribution = 0.;
-  int betaVir = virtualBeta.size();
-  int betaOcc = occupiedBeta.size();
-  for (int i = 0; i < betaOcc; i++) {
-    int occI = occupiedBeta[i];
-    for (int j = 0; j < betaOcc; j++) {
-      int occJ = occupiedBeta[j];
-      double spatial = 0.;
-      for (int occK : occupiedAlpha) {
-        spatial += spatialOverlap(occI, occK) * spatialOverlap(occJ, occK);
-      }
-      double coeffs = 0.;
-      for (int a = 0; a < betaVir; a++) {
-        coeffs -= betaCoeffs(i * betaVir + a) * betaCoeffs(j * betaVir + a);
-      }
-      contribution += coeffs * spatial;
-    }
-  }
-  return contribution;
+double CISSpinContaminator::ij_k_aBeta(const Amplitudes& betaAmplitudes, const Eigen::MatrixXd& occupiedOverlap) {
+  return -(betaAmplitudes * occupiedOverlap.transpose()).squaredNorm();
 }
 
-double CISSpinContaminator::ijab(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs,
-                                 const Eigen::VectorXd& betaCoeffs, const std::vector<int>& occupiedAlpha,
-                                 const std::vector<int>& virtualAlpha, const std::vector<int>& occupiedBeta,
-                                 const std::vector<int>& virtualBeta) {
-  double contribution = 0.;
-  int alphaVir = virtualAlpha.size();
-  int alphaOcc = occupiedAlpha.size();
-  int betaOcc = occupiedBeta.size();
-  int betaVir = virtualBeta.size();
-
-  for (int i = 0; i < alphaOcc; i++) {
-    int occI = occupiedAlpha[i];
-    for (int j = 0; j < betaOcc; j++) {
-      int occJ = occupiedBeta[j];
-      for (int a = 0; a < alphaVir; a++) {
-        int virA = occupiedAlpha[a];
-        for (int b = 0; b < betaVir; b++) {
-          int virB = virtualBeta[b];
-          contribution += spatialOverlap(occI, occJ) * spatialOverlap(virA, virB) * alphaCoeffs(i * alphaVir + a) *
-                          betaCoeffs(j * betaVir + b);
-        }
-      }
-    }
-  }
-  return 2 * contribution;
+double CISSpinContaminator::ijab(const Amplitudes& alphaAmplitudes, const Amplitudes& betaAmplitudes,
+                                 const Eigen::MatrixXd& occupiedOverlap, const Eigen::MatrixXd& virtualOverlap) {
+  const Eigen::MatrixXd transformedVirtualOverlap = alphaAmplitudes.transpose() * virtualOverlap * betaAmplitudes;
+  return 2 * occupiedOverlap.cwiseProduct(transformedVirtualOverlap).sum();
 }
 } // namespace Sparrow
 } // namespace Scine
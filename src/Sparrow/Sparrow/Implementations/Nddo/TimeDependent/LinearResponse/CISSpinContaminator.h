@@ -11,27 +11,34 @@ namespace Sparrow {
 #ifndef SPARROW_CISSPINCONTAMINATOR_H
 #  define SPARROW_CISSPINCONTAMINATOR_H
 
+/**
+ * @brief Calculates <S^2> of the excited states of an unrestricted CIS calculation.
+ *
+ * The contributions are contractions of the amplitudes of a root with blocks of the alpha-beta MO overlap matrix
+ * S_pq = <alpha_p|beta_q>. The amplitudes of a root are viewed as (virtual x occupied) matrices without copy, with
+ * X(a, i) the coefficient of the excitation i -> a, such that every contribution is a dense matrix product.
+ * The roots are evaluated in parallel.
+ */
 class CISSpinContaminator {
  public:
+  //! Amplitudes X(a, i) of the excitations i -> a of one root and one spin.
+  using Amplitudes = Eigen::Ref<const Eigen::MatrixXd>;
+
   static Eigen::VectorXd calculateSpinContaminationOpenShell(
       const Utils::MolecularOrbitals& mos, const Eigen::MatrixXd& eigenVectors, const std::vector<int>& filledAlpha,
       const std::vector<int>& filledBeta,
       const Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, std::vector<int>>& excitationIndices);
-  static double ab_j_iAlpha(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs,
-                            const std::vector<int>& virtualAlpha, const std::vector<int>& occupiedBeta,
-                            const std::vector<int>& occupiedAlpha);
-  static double ab_j_iBeta(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& betaCoeffs,
-                           const std::vector<int>& virtualBeta, const std::vector<int>& occupiedAlpha,
-                           const std::vector<int>& occupiedBeta);
-  static double ij_k_aAlpha(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs,
-                            const std::vector<int>& occupiedAlpha, const std::vector<int>& virtualAlpha,
-                            const std::vector<int>& occupiedBeta);
-  static double ij_k_aBeta(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& betaCoeffs,
-                           const std::vector<int>& occupiedBeta, const std::vector<int>& virtualBeta,
-                           const std::vector<int>& occupiedAlpha);
-  static double ijab(const Eigen::MatrixXd& spatialOverlap, const Eigen::VectorXd& alphaCoeffs, const Eigen::VectorXd& betaCoeffs,
-                     const std::vector<int>& occupiedAlpha, const std::vector<int>& virtualAlpha,
-                     const std::vector<int>& occupiedBeta, const std::vector<int>& virtualBeta);
+  //! @brief sum_ab sum_i X_ia X_ib sum_j S_aj S_bj, with S_aj = S(virtual alpha, occupied beta).
+  static double ab_j_iAlpha(const Amplitudes& alphaAmplitudes, const Eigen::MatrixXd& virtualAlphaOccupiedBeta);
+  //! @brief sum_ab sum_i Y_ia Y_ib sum_j S_ja S_jb, with S_ja = S(occupied alpha, virtual beta).
+  static double ab_j_iBeta(const Amplitudes& betaAmplitudes, const Eigen::MatrixXd& occupiedAlphaVirtualBeta);
+  //! @brief -sum_ij sum_a X_ia X_ja sum_k S_ik S_jk, with S_ik = S(occupied alpha, occupied beta).
+  static double ij_k_aAlpha(const Amplitudes& alphaAmplitudes, const Eigen::MatrixXd& occupiedOverlap);
+  //! @brief -sum_ij sum_a Y_ia Y_ja sum_k S_ki S_kj, with S_ki = S(occupied alpha, occupied beta).
+  static double ij_k_aBeta(const Amplitudes& betaAmplitudes, const Eigen::MatrixXd& occupiedOverlap);
+  //! @brief 2 sum_ijab S_ij S_ab X_ia Y_jb, with S_ij between occupied and S_ab between virtual orbitals.
+  static double ijab(const Amplitudes& alphaAmplitudes, const Amplitudes& betaAmplitudes,
+                     const Eigen::MatrixXd& occupiedOverlap, const Eigen::MatrixXd& virtualOverlap);
 };
 }
 }
@@ -0,0 +1,505 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "CoreRepulsionEngine.h"
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementPairParameters.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/Math/AtomicSecondDerivativeCollection.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace Utils::AutomaticDifferentiation;
+
+namespace nddo {
+
+namespace {
+// PM6 constants, see PM6PairwiseRepulsion
+constexpr double pm6AdditiveCoefficient = 0.0000207389327971913490822259;
+constexpr double pm6ExponentCoefficient = 0.00001244878365801758178693335;
+constexpr double pm6FurtherExponentCC = 3.1644797213016;
+constexpr double pm6DistanceSiO = 5.480205761238679760340424;
+constexpr double pm6FactorCC = 9.28;
+constexpr double pm6FactorSiO = -0.0007;
+
+// Grid on which the short-range cutoffs are determined, in bohr
+constexpr double cutoffGridSpacing = 0.25;
+constexpr int cutoffGridPoints = 800;
+
+bool isNorO(Utils::ElementType e) {
+  return e == Utils::ElementType::N || e == Utils::ElementType::O;
+}
+} // namespace
+
+CoreRepulsionEngine::CoreRepulsionEngine(Model model, const Utils::ElementTypeCollection& elements,
+                                         const Utils::PositionCollection& positions,
+                                         const ElementParameters& elementParameters,
+                                         const ElementPairParameters* pairParameters)
+  : model_(model),
+    elements_(elements),
+    positions_(positions),
+    elementParameters_(elementParameters),
+    pairParameters_(pairParameters) {
+}
+
+void CoreRepulsionEngine::initialize() {
+  const int nAtoms = elements_.size();
+  pairTypes_.clear();
+  chunks_.clear();
+
+  // Assign a pair type to every element pair present and count the atom pairs for each of them.
+  std::map<std::pair<int, int>, int> typeIndices;
+  std::vector<int> pairsPerType;
+  auto typeOf = [&](int i, int j) {
+    int Zi = Utils::ElementInfo::Z(elements_[i]);
+    int Zj = Utils::ElementInfo::Z(elements_[j]);
+    auto key = std::make_pair(std::min(Zi, Zj), std::max(Zi, Zj));
+    auto it = typeIndices.find(key);
+    if (it != typeIndices.end()) {
+      return it->second;
+    }
+    int index = static_cast<int>(pairTypes_.size());
+    typeIndices.emplace(key, index);
+    pairTypes_.push_back(createPairType(elements_[i], elements_[j]));
+    pairsPerType.push_back(0);
+    return index;
+  };
+  for (int i = 0; i < nAtoms; ++i) {
+    for (int j = i + 1; j < nAtoms; ++j) {
+      int type = typeOf(i, j);
+      ++pairsPerType[type];
+    }
+  }
+
+  // Fill the flat arrays, sorted by pair type.
+  const int nPairs = nAtoms * (nAtoms - 1) / 2;
+  std::vector<int> typeOffsets(pairTypes_.size() + 1, 0);
+  for (unsigned t = 0; t < pairTypes_.size(); ++t) {
+    typeOffsets[t + 1] = typeOffsets[t] + pairsPerType[t];
+  }
+  firstAtoms_.resize(nPairs);
+  secondAtoms_.resize(nPairs);
+  std::vector<int> nextPair(typeOffsets.begin(), typeOffsets.end() - 1);
+  for (int i = 0; i < nAtoms; ++i) {
+    for (int j = i + 1; j < nAtoms; ++j) {
+      int& pair = nextPair[typeOf(i, j)];
+      firstAtoms_[pair] = i;
+      secondAtoms_[pair] = j;
+      ++pair;
+    }
+  }
+  firstDerivatives_.assign(nPairs, 0.0);
+  secondDerivatives_.assign(nPairs, 0.0);
+
+  for (int t = 0; t < static_cast<int>(pairTypes_.size()); ++t) {
+    pairTypes_[t].cutoff = calculateCutoff(pairTypes_[t]);
+    for (int begin = typeOffsets[t]; begin < typeOffsets[t + 1]; begin += chunkSize) {
+      chunks_.push_back({t, begin, std::min(begin + chunkSize, typeOffsets[t + 1])});
+    }
+  }
+  repulsionEnergy_ = 0;
+  nShortRangePairs_ = 0;
+}
+
+CoreRepulsionEngine::PairType CoreRepulsionEngine::createPairType(Utils::ElementType e1, Utils::ElementType e2) const {
+  const auto& pA = elementParameters_.get(e1);
+  const auto& pB = elementParameters_.get(e2);
+  PairType type;
+  type.chargeProduct = pA.coreCharge() * pB.coreCharge();
+  double pSum = pA.pCore() + pB.pCore();
+  type.pSumSquared = pSum * pSum;
+  type.additiveCoefficient = 0;
+  type.cutoff = std::numeric_limits<double>::infinity();
+
+  if (model_ == Model::PM6) {
+    addPm6Terms(type, pA, pB, e1, e2);
+  }
+  else {
+    addMndoTerms(type, pA, pB);
+    if (model_ == Model::AM1) {
+      addGaussianTerms(type, pA, false);
+      addGaussianTerms(type, pB, false);
+    }
+  }
+  return type;
+}
+
+void CoreRepulsionEngine::addMndoTerms(PairType& type, const AtomicParameters& pA, const AtomicParameters& pB) const {
+  // For N-H and O-H pairs, the exponential of the heavy atom is multiplied by R (in angstrom).
+  const bool linearA = pB.element() == Utils::ElementType::H && isNorO(pA.element());
+  const bool linearB = pA.element() == Utils::ElementType::H && isNorO(pB.element());
+  type.parenthesisTerms.push_back(
+      {linearA ? Utils::Constants::angstrom_per_bohr : 1.0, linearA ? 1 : 0, 0.0, pA.alpha(), 0.0, 0.0});
+  type.parenthesisTerms.push_back(
+      {linearB ? Utils::Constants::angstrom_per_bohr : 1.0, linearB ? 1 : 0, 0.0, pB.alpha(), 0.0, 0.0});
+}
+
+void CoreRepulsionEngine::addPm6Terms(PairType& type, const AtomicParameters& pA, const AtomicParameters& pB,
+                                      Utils::ElementType e1, Utils::ElementType e2) const {
+  const auto& pAB = pairParameters_->get(e1, e2);
+  const double x2 = 2 * pAB.x();
+  const double alpha = pAB.alpha();
+  auto isPair = [&](Utils::ElementType a, Utils::ElementType b) {
+    return (e1 == a && e2 == b) || (e1 == b && e2 == a);
+  };
+  const bool nhoh = isPair(Utils::ElementType::H, Utils::ElementType::C) ||
+                    isPair(Utils::ElementType::H, Utils::ElementType::N) || isPair(Utils::ElementType::H, Utils::ElementType::O);
+
+  if (nhoh) {
+    type.parenthesisTerms.push_back({x2, 0, 0.0, 0.0, alpha, 0.0});
+  }
+  else {
+    type.parenthesisTerms.push_back({x2, 0, 0.0, alpha, 0.0, alpha * pm6ExponentCoefficient});
+    if (isPair(Utils::ElementType::C, Utils::ElementType::C)) {
+      type.parenthesisTerms.push_back({pm6FactorCC, 0, 0.0, pm6FurtherExponentCC, 0.0, 0.0});
+    }
+    if (isPair(Utils::ElementType::Si, Utils::ElementType::O)) {
+      type.parenthesisTerms.push_back(
+          {pm6FactorSiO, 0, pm6DistanceSiO * pm6DistanceSiO, -2 * pm6DistanceSiO, 1.0, 0.0});
+    }
+  }
+
+  // As in PM6PairwiseRepulsion, only the first Gaussian of each atom enters the repulsion.
+  addGaussianTerms(type, pA, true);
+  addGaussianTerms(type, pB, true);
+
+  double zSum = std::pow(Utils::ElementInfo::Z(e1), 1.0 / 3.0) + std::pow(Utils::ElementInfo::Z(e2), 1.0 / 3.0);
+  double zSum2 = zSum * zSum;
+  double zSum6 = zSum2 * zSum2 * zSum2;
+  type.additiveCoefficient = pm6AdditiveCoefficient * zSum6 * zSum6 / Utils::Constants::ev_per_hartree;
+}
+
+void CoreRepulsionEngine::addGaussianTerms(PairType& type, const AtomicParameters& p, bool onlyFirst) const {
+  if (!p.hasGaussianRepulsionParameters()) {
+    return;
+  }
+  const double prefactor = type.chargeProduct / Utils::Constants::ev_per_hartree;
+  for (const auto& gaussian : p.getGaussianRepulsionParameters()) {
+    // a * exp(-b (R - c)^2)
+    double a = std::get<0>(gaussian);
+    double b = std::get<1>(gaussian);
+    double c = std::get<2>(gaussian);
+    type.gaussianTerms.push_back({a * prefactor, 0, b * c * c, -2 * b * c, b, 0.0});
+    if (onlyFirst) {
+      return;
+    }
+  }
+}
+
+double CoreRepulsionEngine::calculateCutoff(const PairType& type) const {
+  // Last grid point at which the short-range part or one of its derivatives exceeds the threshold.
+  int lastAbove = -1;
+  for (int start = 0; start < cutoffGridPoints; start += chunkSize) {
+    const int n = std::min(chunkSize, cutoffGridPoints - start);
+    ChunkArray R = ChunkArray::LinSpaced(n, (start + 1) * cutoffGridSpacing, (start + n) * cutoffGridSpacing);
+    ChunkArray integral = (R.square() + type.pSumSquared).rsqrt();
+    ChunkArray value(n), first(n), second(n);
+    evaluateShortRange<Utils::DerivativeOrder::Two>(type, R, integral, value, first, second);
+    for (int k = 0; k < n; ++k) {
+      if (std::abs(value(k)) > shortRangeThreshold_ || std::abs(first(k)) > shortRangeThreshold_ ||
+          std::abs(second(k)) > shortRangeThreshold_) {
+        lastAbove = start + k;
+      }
+    }
+  }
+  if (lastAbove == cutoffGridPoints - 1) {
+    return std::numeric_limits<double>::infinity();
+  }
+  return (lastAbove + 2) * cutoffGridSpacing;
+}
+
+void CoreRepulsionEngine::calculate(Utils::DerivativeOrder order) {
+  if (order == Utils::DerivativeOrder::Zero) {
+    calculateImpl<Utils::DerivativeOrder::Zero>();
+  }
+  else if (order == Utils::DerivativeOrder::One) {
+    calculateImpl<Utils::DerivativeOrder::One>();
+  }
+  else {
+    calculateImpl<Utils::DerivativeOrder::Two>();
+  }
+}
+
+template<Utils::DerivativeOrder O>
+void CoreRepulsionEngine::calculateImpl() {
+  double energy = 0;
+  int nShortRange = 0;
+  const int nChunks = chunks_.size();
+#pragma omp parallel for schedule(dynamic) reduction(+ : energy, nShortRange)
+  for (int c = 0; c < nChunks; ++c) {
+    energy += calculateChunk<O>(chunks_[c], nShortRange);
+  }
+  repulsionEnergy_ = energy;
+  nShortRangePairs_ = nShortRange;
+}
+
+template<Utils::DerivativeOrder O>
+double CoreRepulsionEngine::calculateChunk(const Chunk& chunk, int& nShortRange) {
+  const auto& type = pairTypes_[chunk.type];
+  const int n = chunk.end - chunk.begin;
+
+  ChunkArray R(n);
+  for (int k = 0; k < n; ++k) {
+    R(k) = pairVector(chunk.begin + k).norm();
+  }
+
+  // Long-range part Z_A Z_B (ss|ss)
+  ChunkArray integral = (R.square() + type.pSumSquared).rsqrt();
+  ChunkArray value = type.chargeProduct * integral;
+  ChunkArray first, second;
+  if (O != Utils::DerivativeOrder::Zero) {
+    ChunkArray integral3 = integral.cube();
+    first = -type.chargeProduct * R * integral3;
+    if (O == Utils::DerivativeOrder::Two) {
+      second = type.chargeProduct * integral3 * integral.square() * (2 * R.square() - type.pSumSquared);
+    }
+  }
+
+  // Short-range part, only for the pairs within the cutoff
+  std::array<int, chunkSize> shortRange;
+  int m = 0;
+  for (int k = 0; k < n; ++k) {
+    if (R(k) < type.cutoff) {
+      shortRange[m++] = k;
+    }
+  }
+  if (m > 0) {
+    ChunkArray Rs(m), integrals(m), srValue(m), srFirst(m), srSecond(m);
+    for (int k = 0; k < m; ++k) {
+      Rs(k) = R(shortRange[k]);
+      integrals(k) = integral(shortRange[k]);
+    }
+    evaluateShortRange<O>(type, Rs, integrals, srValue, srFirst, srSecond);
+    for (int k = 0; k < m; ++k) {
+      value(shortRange[k]) += srValue(k);
+      if (O != Utils::DerivativeOrder::Zero) {
+        first(shortRange[k]) += srFirst(k);
+      }
+      if (O == Utils::DerivativeOrder::Two) {
+        second(shortRange[k]) += srSecond(k);
+      }
+    }
+    nShortRange += m;
+  }
+
+  if (O != Utils::DerivativeOrder::Zero) {
+    Eigen::Map<Eigen::ArrayXd>(firstDerivatives_.data() + chunk.begin, n) = first;
+  }
+  if (O == Utils::DerivativeOrder::Two) {
+    Eigen::Map<Eigen::ArrayXd>(secondDerivatives_.data() + chunk.begin, n) = second;
+  }
+  return value.sum();
+}
+
+template<Utils::DerivativeOrder O>
+void CoreRepulsionEngine::evaluateShortRange(const PairType& type, const ChunkArray& R, const ChunkArray& integral,
+                                             ChunkArray& value, ChunkArray& first, ChunkArray& second) {
+  const int n = R.size();
+  // Parenthesis terms, multiplied by Z_A Z_B (ss|ss)
+  ChunkArray p = ChunkArray::Zero(n), dp = ChunkArray::Zero(n), ddp = ChunkArray::Zero(n);
+  for (const auto& term : type.parenthesisTerms) {
+    addExponentialTerm<O>(term, R, p, dp, ddp);
+  }
+  value = type.chargeProduct * integral * p;
+  if (O != Utils::DerivativeOrder::Zero) {
+    ChunkArray integral3 = integral.cube();
+    ChunkArray dIntegral = -R * integral3;
+    first = type.chargeProduct * (dIntegral * p + integral * dp);
+    if (O == Utils::DerivativeOrder::Two) {
+      ChunkArray ddIntegral = integral3 * integral.square() * (2 * R.square() - type.pSumSquared);
+      second = type.chargeProduct * (ddIntegral * p + 2 * dIntegral * dp + integral * ddp);
+    }
+  }
+
+  if (type.gaussianTerms.empty() && type.additiveCoefficient == 0) {
+    return;
+  }
+  ChunkArray inverseR = R.inverse();
+
+  // Gaussian terms, divided by R
+  if (!type.gaussianTerms.empty()) {
+    ChunkArray g = ChunkArray::Zero(n), dg = ChunkArray::Zero(n), ddg = ChunkArray::Zero(n);
+    for (const auto& term : type.gaussianTerms) {
+      addExponentialTerm<O>(term, R, g, dg, ddg);
+    }
+    value += g * inverseR;
+    if (O != Utils::DerivativeOrder::Zero) {
+      first += (dg - g * inverseR) * inverseR;
+      if (O == Utils::DerivativeOrder::Two) {
+        second += (ddg - 2 * dg * inverseR + 2 * g * inverseR.square()) * inverseR;
+      }
+    }
+  }
+
+  // PM6 term proportional to R^-12
+  if (type.additiveCoefficient != 0) {
+    ChunkArray inverseR6 = inverseR.square().cube();
+    ChunkArray a = type.additiveCoefficient * inverseR6.square();
+    value += a;
+    if (O != Utils::DerivativeOrder::Zero) {
+      first -= 12 * a * inverseR;
+      if (O == Utils::DerivativeOrder::Two) {
+        second += 156 * a * inverseR.square();
+      }
+    }
+  }
+}
+
+template<Utils::DerivativeOrder O>
+void CoreRepulsionEngine::addExponentialTerm(const ExponentialTerm& term, const ChunkArray& R, ChunkArray& value,
+                                             ChunkArray& first, ChunkArray& second) {
+  ChunkArray q = term.q0 + R * (term.q1 + R * term.q2);
+  ChunkArray R5;
+  if (term.q6 != 0) {
+    R5 = R.square().square() * R;
+    q += term.q6 * R5 * R;
+  }
+  ChunkArray e = term.coefficient * (-q).exp();
+  if (term.rPower == 1) {
+    value += R * e;
+  }
+  else {
+    value += e;
+  }
+  if (O == Utils::DerivativeOrder::Zero) {
+    return;
+  }
+
+  // Derivatives of q
+  ChunkArray dq = term.q1 + 2 * term.q2 * R;
+  if (term.q6 != 0) {
+    dq += 6 * term.q6 * R5;
+  }
+  if (term.rPower == 1) {
+    first += e * (1 - R * dq);
+  }
+  else {
+    first -= dq * e;
+  }
+  if (O == Utils::DerivativeOrder::Two) {
+    ChunkArray ddq = ChunkArray::Constant(R.size(), 2 * term.q2);
+    if (term.q6 != 0) {
+      ddq += 30 * term.q6 * R5 / R;
+    }
+    if (term.rPower == 1) {
+      second += e * (R * dq.square() - 2 * dq - R * ddq);
+    }
+    else {
+      second += (dq.square() - ddq) * e;
+    }
+  }
+}
+
+bool CoreRepulsionEngine::isPeriodic() const {
+  return periodicCell_ && periodicCell_->isPeriodic();
+}
+
+Eigen::Vector3d CoreRepulsionEngine::pairVector(int pair) const {
+  Eigen::Vector3d Rab = positions_.row(secondAtoms_[pair]) - positions_.row(firstAtoms_[pair]);
+  if (isPeriodic()) {
+    return periodicCell_->getMinimumImage(Rab);
+  }
+  return Rab;
+}
+
+double CoreRepulsionEngine::getRepulsionEnergy() const {
+  return repulsionEnergy_;
+}
+
+void CoreRepulsionEngine::addDerivatives(DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
+  const int nPairs = firstAtoms_.size();
+  const bool periodic = isPeriodic();
+  strainDerivatives_.setZero();
+#pragma omp parallel
+  {
+    // Each thread accumulates its own gradient, they are summed at the end.
+    Utils::GradientCollection threadDerivatives = Utils::GradientCollection::Zero(derivatives.rows(), 3);
+    Eigen::Matrix3d threadStrainDerivatives = Eigen::Matrix3d::Zero();
+#pragma omp for schedule(static) nowait
+    for (int pair = 0; pair < nPairs; ++pair) {
+      Eigen::Vector3d Rab = pairVector(pair);
+      First1D radial(0, firstDerivatives_[pair]);
+      Eigen::Vector3d gradient = get3Dfrom1D<Utils::DerivativeOrder::One>(radial, Rab).derivatives();
+      addDerivativeToContainer<Utils::Derivative::First>(threadDerivatives, firstAtoms_[pair], secondAtoms_[pair],
+                                                         gradient);
+      if (periodic) {
+        PeriodicCell::addStrainDerivative(threadStrainDerivatives, Rab, gradient);
+      }
+    }
+#pragma omp critical
+    {
+      derivatives += threadDerivatives;
+      strainDerivatives_ += threadStrainDerivatives;
+    }
+  }
+}
+
+void CoreRepulsionEngine::addDerivatives(DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const {
+  addSecondDerivatives<Utils::Derivative::SecondAtomic>(derivatives);
+}
+
+void CoreRepulsionEngine::addDerivatives(DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const {
+  addSecondDerivatives<Utils::Derivative::SecondFull>(derivatives);
+}
+
+template<Utils::Derivative O>
+void CoreRepulsionEngine::addSecondDerivatives(DerivativeContainerType<O>& derivatives) const {
+  /*
+   * The Cartesian second derivatives of the pairs are generated in parallel, and added to the container
+   * sequentially as the full Hessian couples the two atoms of a pair.
+   */
+  if (isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
+  const int nPairs = firstAtoms_.size();
+  std::vector<Second3D> pairDerivatives(nPairs);
+#pragma omp parallel for schedule(static)
+  for (int pair = 0; pair < nPairs; ++pair) {
+    Second1D radial(0, firstDerivatives_[pair], secondDerivatives_[pair]);
+    pairDerivatives[pair] = get3Dfrom1D<Utils::DerivativeOrder::Two>(radial, pairVector(pair));
+  }
+  for (int pair = 0; pair < nPairs; ++pair) {
+    addDerivativeToContainer<O>(derivatives, firstAtoms_[pair], secondAtoms_[pair], pairDerivatives[pair]);
+  }
+}
+
+void CoreRepulsionEngine::setShortRangeThreshold(double threshold) {
+  shortRangeThreshold_ = threshold;
+}
+
+double CoreRepulsionEngine::getShortRangeThreshold() const {
+  return shortRangeThreshold_;
+}
+
+int CoreRepulsionEngine::getNumberOfShortRangePairs() const {
+  return nShortRangePairs_;
+}
+
+int CoreRepulsionEngine::getNumberOfPairs() const {
+  return static_cast<int>(firstAtoms_.size());
+}
+
+void CoreRepulsionEngine::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
+const Eigen::Matrix3d& CoreRepulsionEngine::getStrainDerivatives() const {
+  return strainDerivatives_;
+}
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_COREREPULSIONENGINE_H
+#define SPARROW_COREREPULSIONENGINE_H
+
+#include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <memory>
+#include <vector>
+
+namespace Scine {
+
+namespace Utils {
+enum class DerivativeOrder;
+}
+
+namespace Sparrow {
+class PeriodicCell;
+
+namespace nddo {
+class AtomicParameters;
+class ElementParameters;
+class ElementPairParameters;
+
+/**
+ * @brief Evaluates the NDDO core-core repulsion for all atom pairs of a structure.
+ *
+ * The repulsion between two cores is split into the long-range term Z_A Z_B (ss|ss), which is evaluated for all
+ * pairs, and the short-range exponential, Gaussian and (for PM6) R^-12 corrections. The atom pairs are stored in flat
+ * arrays grouped by element pair, so that the element-pair constants are set up once at initialization and the
+ * exponentials are evaluated in chunks on Eigen arrays. For every element pair a cutoff radius is determined beyond
+ * which the short-range corrections and their first two derivatives are smaller than a threshold; these corrections
+ * are then skipped.
+ * Only the radial derivatives are stored during the calculation, the Cartesian derivatives are generated when added
+ * to the derivative container. This class allocates nothing per atom pair apart from the flat arrays.
+ * The functional forms are the ones of MNDOPairwiseRepulsion, AM1PairwiseRepulsion and PM6PairwiseRepulsion.
+ * With periodic boundaries, every pair is evaluated at the distance to the closest periodic image of the second atom,
+ * the long-range Coulomb repulsion of the cores with the other images is part of LongRangeElectrostatics.
+ */
+class CoreRepulsionEngine {
+ public:
+  enum class Model { MNDO, AM1, PM6 };
+
+  /**
+   * @brief Constructor.
+   * @param pairParameters Diatomic parameters, only needed for PM6 and may be nullptr for the other models.
+   */
+  CoreRepulsionEngine(Model model, const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
+                      const ElementParameters& elementParameters, const ElementPairParameters* pairParameters = nullptr);
+
+  //! @brief Sets up the element-pair constants, their cutoffs and the flat list of atom pairs.
+  void initialize();
+  //! @brief Calculates the repulsion energy and the radial derivatives up to the given order.
+  void calculate(Utils::DerivativeOrder order);
+  //! @brief Total repulsion energy of the last calculation.
+  double getRepulsionEnergy() const;
+  //! Functions adding the repulsion derivatives of the last calculation to the container.
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const;
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const;
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const;
+
+  /**
+   * @brief Sets the threshold (in hartree, hartree/bohr and hartree/bohr^2) below which the short-range corrections
+   *        are neglected. Takes effect at the next call to initialize().
+   */
+  void setShortRangeThreshold(double threshold);
+  double getShortRangeThreshold() const;
+  //! @brief Number of atom pairs for which the short-range corrections were evaluated in the last calculation.
+  int getNumberOfShortRangePairs() const;
+  //! @brief Total number of atom pairs.
+  int getNumberOfPairs() const;
+
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * Only first derivatives are available with periodic boundaries.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  /**
+   * @brief Derivative of the repulsion energy with respect to a homogeneous strain of the periodic cell and of the
+   *        positions, from the last call to addDerivatives() for first derivatives. Zero without periodic boundaries.
+   */
+  const Eigen::Matrix3d& getStrainDerivatives() const;
+
+ private:
+  static constexpr int chunkSize = 32;
+  // Stack-allocated array holding the values for the pairs of one chunk.
+  using ChunkArray = Eigen::Array<double, Eigen::Dynamic, 1, Eigen::ColMajor, chunkSize, 1>;
+
+  /*
+   * Term of the form coefficient * R^rPower * exp(-(q0 + q1 R + q2 R^2 + q6 R^6)), with rPower 0 or 1.
+   * All exponential and Gaussian terms of MNDO, AM1 and PM6 can be written in this form.
+   */
+  struct ExponentialTerm {
+    double coefficient;
+    int rPower;
+    double q0, q1, q2, q6;
+  };
+  // Constants for one element pair.
+  struct PairType {
+    double chargeProduct;
+    double pSumSquared;
+    // Terms inside the parenthesis multiplying Z_A Z_B (ss|ss)
+    std::vector<ExponentialTerm> parenthesisTerms;
+    // Gaussian terms divided by R, their coefficients include the factor Z_A Z_B / (eV per hartree)
+    std::vector<ExponentialTerm> gaussianTerms;
+    // Coefficient of the PM6 R^-12 term
+    double additiveCoefficient;
+    double cutoff;
+  };
+  // Contiguous range of atom pairs with the same pair type.
+  struct Chunk {
+    int type;
+    int begin;
+    int end;
+  };
+
+  PairType createPairType(Utils::ElementType e1, Utils::ElementType e2) const;
+  void addMndoTerms(PairType& type, const AtomicParameters& pA, const AtomicParameters& pB) const;
+  void addPm6Terms(PairType& type, const AtomicParameters& pA, const AtomicParameters& pB, Utils::ElementType e1,
+                   Utils::ElementType e2) const;
+  void addGaussianTerms(PairType& type, const AtomicParameters& p, bool onlyFirst) const;
+  double calculateCutoff(const PairType& type) const;
+
+  template<Utils::DerivativeOrder O>
+  void calculateImpl();
+  // Returns the repulsion energy of the chunk and adds the number of short-range pairs to nShortRange.
+  template<Utils::DerivativeOrder O>
+  double calculateChunk(const Chunk& chunk, int& nShortRange);
+  template<Utils::DerivativeOrder O>
+  static void evaluateShortRange(const PairType& type, const ChunkArray& R, const ChunkArray& integral, ChunkArray& value,
+                                 ChunkArray& first, ChunkArray& second);
+  template<Utils::DerivativeOrder O>
+  static void addExponentialTerm(const ExponentialTerm& term, const ChunkArray& R, ChunkArray& value, ChunkArray& first,
+                                 ChunkArray& second);
+
+  template<Utils::Derivative O>
+  void addSecondDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
+
+  bool isPeriodic() const;
+  Eigen::Vector3d pairVector(int pair) const;
+
+  Model model_;
+  const Utils::ElementTypeCollection& elements_;
+  const Utils::PositionCollection& positions_;
+  const ElementParameters& elementParameters_;
+  const ElementPairParameters* pairParameters_;
+  double shortRangeThreshold_ = 1e-12;
+  std::shared_ptr<PeriodicCell> periodicCell_;
+
+  std::vector<PairType> pairTypes_;
+  std::vector<Chunk> chunks_;
+  // Structure of arrays over the atom pairs, sorted by pair type.
+  std::vector<int> firstAtoms_;
+  std::vector<int> secondAtoms_;
+  std::vector<double> firstDerivatives_;
+  std::vector<double> secondDerivatives_;
+  double repulsionEnergy_ = 0;
+  int nShortRangePairs_ = 0;
+  // Filled together with the first derivatives
+  mutable Eigen::Matrix3d strainDerivatives_ = Eigen::Matrix3d::Zero();
+};
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
+#endif // SPARROW_COREREPULSIONENGINE_H
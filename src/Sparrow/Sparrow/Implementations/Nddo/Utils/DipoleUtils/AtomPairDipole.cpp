@@ -6,6 +6,7 @@
  */
 
 #include "AtomPairDipole.h"
+#include "BatchedGTODipoleMatrixBlock.h"
 #include "GTODipoleMatrixBlock.h"
 #include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/NDDODipoleMatrixCalculator.h>
 #include <Utils/DataStructures/AtomicGtos.h>
@@ -14,74 +15,69 @@
 namespace Scine {
 namespace Sparrow {
 
+namespace {
+// First AO of the shells s, p and d of an atom, relative to its first AO.
+int shellOffset(int angularMomentum) {
+  return angularMomentum == 0 ? 0 : (angularMomentum == 1 ? 1 : 4);
+}
+} // namespace
+
 void AtomPairDipole::fillAtomPairDipoleBlock(Utils::DipoleMatrix& dipoleMatrix, int startOfAtomA, int startOfAtomB,
                                              const IntegralMethod& method, const Utils::AtomicGtos& gtosA,
                                              const Utils::AtomicGtos& gtosB, const Eigen::RowVector3d& Ra,
-                                             const Eigen::RowVector3d& Rb, const Eigen::RowVector3d& Rab,
+                                             const Eigen::RowVector3d& Rb, const Eigen::RowVector3d& /*Rab*/,
                                              const Eigen::RowVector3d& dipoleEvaluationCoordinate) {
+  fillAtomPairDipoleBlocks(dipoleMatrix, {{startOfAtomA, startOfAtomB}}, method, gtosA, gtosB, {Ra}, {Rb},
+                           dipoleEvaluationCoordinate);
+}
+
+void AtomPairDipole::fillAtomPairDipoleBlocks(Utils::DipoleMatrix& dipoleMatrix,
+                                              const std::vector<std::pair<int, int>>& startIndices,
+                                              const IntegralMethod& method, const Utils::AtomicGtos& gtosA,
+                                              const Utils::AtomicGtos& gtosB,
+                                              const std::vector<Eigen::RowVector3d>& Ras,
+                                              const std::vector<Eigen::RowVector3d>& Rbs,
+                                              const Eigen::RowVector3d& dipoleEvaluationCoordinate) {
   GTODipoleMatrixBlock block;
   block.setIntegralMethod(method);
+  BatchedGTODipoleMatrixBlock batchedBlock;
 
-  using Utils::DerivativeOrder;
-
-  if (gtosA.s) {
-    if (gtosB.s) {
-      const auto ssBlock = block.createSTOBlock(gtosA.s.value(), gtosB.s.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB, 1, 1) = ssBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB, 1, 1) = ssBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB, 1, 1) = ssBlock[2];
-    }
-    if (gtosB.p) {
-      const auto spBlock = block.createSTOBlock(gtosA.s.value(), gtosB.p.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 1, 1, 3) = spBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 1, 1, 3) = spBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 1, 1, 3) = spBlock[2];
-    }
-    if (gtosB.d) {
-      const auto sdBlock = block.createSTOBlock(gtosA.s.value(), gtosB.d.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 4, 1, 5) = sdBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 4, 1, 5) = sdBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA, startOfAtomB + 4, 1, 5) = sdBlock[2];
+  // The Obara-Saika scheme is evaluated for all primitive pairs of a shell pair and all atom pairs at once.
+  auto createSTOBlocks = [&](const Utils::GtoExpansion& gtoA, const Utils::GtoExpansion& gtoB) {
+    if (method == IntegralMethod::ObaraSaika) {
+      return batchedBlock.createSTOBlocks(gtoA, gtoB, Ras, Rbs, dipoleEvaluationCoordinate);
     }
-  }
-  if (gtosA.p) {
-    if (gtosB.s) {
-      const auto psBlock = block.createSTOBlock(gtosA.p.value(), gtosB.s.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB, 3, 1) = psBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB, 3, 1) = psBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB, 3, 1) = psBlock[2];
-    }
-    if (gtosB.p) {
-      const auto ppBlock = block.createSTOBlock(gtosA.p.value(), gtosB.p.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 1, 3, 3) = ppBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 1, 3, 3) = ppBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 1, 3, 3) = ppBlock[2];
-    }
-    if (gtosB.d) {
-      const auto pdBlock = block.createSTOBlock(gtosA.p.value(), gtosB.d.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 4, 3, 5) = pdBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 4, 3, 5) = pdBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 1, startOfAtomB + 4, 3, 5) = pdBlock[2];
-    }
-  }
-  if (gtosA.d) {
-    if (gtosB.s) {
-      const auto dsBlock = block.createSTOBlock(gtosA.d.value(), gtosB.s.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB, 5, 1) = dsBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB, 5, 1) = dsBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB, 5, 1) = dsBlock[2];
-    }
-    if (gtosB.p) {
-      const auto dpBlock = block.createSTOBlock(gtosA.d.value(), gtosB.p.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 1, 5, 3) = dpBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 1, 5, 3) = dpBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 1, 5, 3) = dpBlock[2];
+    std::vector<std::array<Eigen::MatrixXd, 3>> blocks;
+    blocks.reserve(Ras.size());
+    for (std::size_t pair = 0; pair < Ras.size(); ++pair) {
+      blocks.push_back(block.createSTOBlock(gtoA, gtoB, Ras[pair], Rbs[pair], Rbs[pair] - Ras[pair],
+                                            dipoleEvaluationCoordinate));
     }
-    if (gtosB.d) {
-      const auto ddBlock = block.createSTOBlock(gtosA.d.value(), gtosB.d.value(), Ra, Rb, Rab, dipoleEvaluationCoordinate);
-      dipoleMatrix.x().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 4, 5, 5) = ddBlock[0];
-      dipoleMatrix.y().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 4, 5, 5) = ddBlock[1];
-      dipoleMatrix.z().get<DerivativeOrder::Zero>().block(startOfAtomA + 4, startOfAtomB + 4, 5, 5) = ddBlock[2];
+    return blocks;
+  };
+
+  using Utils::DerivativeOrder;
+  std::array<const Utils::GtoExpansion*, 3> shellsA{{gtosA.s ? &gtosA.s.value() : nullptr,
+                                                      gtosA.p ? &gtosA.p.value() : nullptr,
+                                                      gtosA.d ? &gtosA.d.value() : nullptr}};
+  std::array<const Utils::GtoExpansion*, 3> shellsB{{gtosB.s ? &gtosB.s.value() : nullptr,
+                                                      gtosB.p ? &gtosB.p.value() : nullptr,
+                                                      gtosB.d ? &gtosB.d.value() : nullptr}};
+  for (int lA = 0; lA < 3; ++lA) {
+    for (int lB = 0; lB < 3; ++lB) {
+      if (!shellsA[lA] || !shellsB[lB]) {
+        continue;
+      }
+      const auto blocks = createSTOBlocks(*shellsA[lA], *shellsB[lB]);
+      const int rows = 2 * lA + 1;
+      const int cols = 2 * lB + 1;
+      for (std::size_t pair = 0; pair < blocks.size(); ++pair) {
+        const int row = startIndices[pair].first + shellOffset(lA);
+        const int col = startIndices[pair].second + shellOffset(lB);
+        dipoleMatrix.x().get<DerivativeOrder::Zero>().block(row, col, rows, cols) = blocks[pair][0];
+        dipoleMatrix.y().get<DerivativeOrder::Zero>().block(row, col, rows, cols) = blocks[pair][1];
+        dipoleMatrix.z().get<DerivativeOrder::Zero>().block(row, col, rows, cols) = blocks[pair][2];
+      }
     }
   }
 }
@@ -11,6 +11,8 @@
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
 #include <array>
+#include <utility>
+#include <vector>
 
 namespace Scine {
 
@@ -45,6 +47,25 @@ class AtomPairDipole {
                                       const Utils::AtomicGtos& gtosB, const Eigen::RowVector3d& Ra,
                                       const Eigen::RowVector3d& Rb, const Eigen::RowVector3d& Rab,
                                       const Eigen::RowVector3d& dipoleEvaluationCoordinate);
+  /**
+   * @brief Calculates the blocks of the dipole matrix of several atom pairs sharing the same elements.
+   * With the Obara-Saika scheme, every shell pair is evaluated for all atom pairs at once, see
+   * BatchedGTODipoleMatrixBlock.
+   * @param dipoleMatrix The dipole matrix given as reference.
+   * @param startIndices The indices of the first atomic orbitals of the atoms A and B of every atom pair.
+   * @param method Decides which method to use for the calculation of the integrals.
+   * @param gtosA The GTO expansion on the atoms A.
+   * @param gtosB The GTO expansion on the atoms B.
+   * @param Ras Positions of the nuclei A.
+   * @param Rbs Positions of the nuclei B.
+   * @param dipoleEvaluationCoordinate Decides where the dipole has to be calculated from.
+   */
+  static void fillAtomPairDipoleBlocks(Utils::DipoleMatrix& dipoleMatrix,
+                                       const std::vector<std::pair<int, int>>& startIndices,
+                                       const IntegralMethod& method, const Utils::AtomicGtos& gtosA,
+                                       const Utils::AtomicGtos& gtosB, const std::vector<Eigen::RowVector3d>& Ras,
+                                       const std::vector<Eigen::RowVector3d>& Rbs,
+                                       const Eigen::RowVector3d& dipoleEvaluationCoordinate);
 };
 
 } // namespace Sparrow
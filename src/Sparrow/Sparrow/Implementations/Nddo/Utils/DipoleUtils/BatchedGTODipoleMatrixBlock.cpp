@@ -0,0 +1,185 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#define _USE_MATH_DEFINES
+#include "BatchedGTODipoleMatrixBlock.h"
+#include <Utils/DataStructures/GtoExpansion.h>
+#include <cassert>
+#include <cmath>
+
+namespace Scine {
+namespace Sparrow {
+
+BatchedGTODipoleMatrixBlock::BatchedGTODipoleMatrixBlock() {
+  AOMomenta_[0] = nddo::AngularMomentum(0, 0, 0);
+  AOMomenta_[1] = nddo::AngularMomentum(1, 0, 0);
+  AOMomenta_[2] = nddo::AngularMomentum(0, 1, 0);
+  AOMomenta_[3] = nddo::AngularMomentum(0, 0, 1);
+  AOMomenta_[4] = nddo::AngularMomentum(1, 0, 1);
+  AOMomenta_[5] = nddo::AngularMomentum(0, 1, 1);
+  AOMomenta_[6] = nddo::AngularMomentum(1, 1, 0);
+  AOMomenta_[7] = nddo::AngularMomentum(0, 0, 2); // z2
+  AOMomenta_[8] = nddo::AngularMomentum(0, 2, 0); // y2
+  AOMomenta_[9] = nddo::AngularMomentum(2, 0, 0); // x2
+}
+
+std::vector<std::array<Eigen::MatrixXd, 3>>
+BatchedGTODipoleMatrixBlock::createSTOBlocks(const Utils::GtoExpansion& gtoA, const Utils::GtoExpansion& gtoB,
+                                             const std::vector<Eigen::RowVector3d>& Ras,
+                                             const std::vector<Eigen::RowVector3d>& Rbs,
+                                             const Eigen::RowVector3d& dipoleEvaluationCoordinate) {
+  assert(Ras.size() == Rbs.size());
+  const auto nPairs = static_cast<int>(Ras.size());
+  startAOonA_ = (gtoA.nAOs() == 1) ? 0 : (gtoA.nAOs() == 3) ? 1 : 4;
+  startAOonB_ = (gtoB.nAOs() == 1) ? 0 : (gtoB.nAOs() == 3) ? 1 : 4;
+  orbitalShellSizeA_ = (gtoA.nAOs() == 5) ? 6 : gtoA.nAOs();
+  orbitalShellSizeB_ = (gtoB.nAOs() == 5) ? 6 : gtoB.nAOs();
+
+  setLanes(gtoA, gtoB, Ras, Rbs, dipoleEvaluationCoordinate);
+  calculateOneDimensionalIntegrals(gtoA.angularMomentum, gtoB.angularMomentum);
+
+  std::vector<std::array<Eigen::Matrix<double, 6, 6>, 3>> cartesianBlocks(nPairs);
+  for (int dipoleComponent = 0; dipoleComponent < 3; ++dipoleComponent) {
+    for (int orbitalOnA = 0; orbitalOnA < orbitalShellSizeA_; ++orbitalOnA) {
+      auto const AOMomentumOnA = AOMomenta_[startAOonA_ + orbitalOnA];
+      for (int orbitalOnB = 0; orbitalOnB < orbitalShellSizeB_; ++orbitalOnB) {
+        auto const AOMomentumOnB = AOMomenta_[startAOonB_ + orbitalOnB];
+        const auto& X = (dipoleComponent == 0 ? dipoleIntegral_ : overlapIntegral_)[0][AOMomentumOnA.x][AOMomentumOnB.x];
+        const auto& Y = (dipoleComponent == 1 ? dipoleIntegral_ : overlapIntegral_)[1][AOMomentumOnA.y][AOMomentumOnB.y];
+        const auto& Z = (dipoleComponent == 2 ? dipoleIntegral_ : overlapIntegral_)[2][AOMomentumOnA.z][AOMomentumOnB.z];
+        laneContribution_ = prefactor_ * X * Y * Z;
+        // Sum up the primitive pairs belonging to the same atom pair
+        for (int pair = 0; pair < nPairs; ++pair) {
+          cartesianBlocks[pair][dipoleComponent](orbitalOnA, orbitalOnB) =
+              laneContribution_.segment(pair * nPrimitivePairs_, nPrimitivePairs_).sum();
+        }
+      }
+    }
+  }
+
+  auto const blockRowSize = static_cast<int>(gtoA.nAOs());
+  auto const blockColSize = static_cast<int>(gtoB.nAOs());
+  std::vector<std::array<Eigen::MatrixXd, 3>> dipoleBlocks(nPairs);
+  for (int pair = 0; pair < nPairs; ++pair) {
+    dOrbitalsFromSixCartesianToFiveRealSolidHarmonics(cartesianBlocks[pair]);
+    for (int dimension = 0; dimension < 3; ++dimension) {
+      dipoleBlocks[pair][dimension] = cartesianBlocks[pair][dimension].topLeftCorner(blockRowSize, blockColSize);
+    }
+  }
+  return dipoleBlocks;
+}
+
+void BatchedGTODipoleMatrixBlock::setLanes(const Utils::GtoExpansion& gtoA, const Utils::GtoExpansion& gtoB,
+                                           const std::vector<Eigen::RowVector3d>& Ras,
+                                           const std::vector<Eigen::RowVector3d>& Rbs,
+                                           const Eigen::RowVector3d& dipoleEvaluationCoordinate) {
+  const auto nGtfA = static_cast<int>(gtoA.gtfs.size());
+  const auto nGtfB = static_cast<int>(gtoB.gtfs.size());
+  const auto nPairs = static_cast<int>(Ras.size());
+  nPrimitivePairs_ = nGtfA * nGtfB;
+  nLanes_ = nPrimitivePairs_ * nPairs;
+
+  Eigen::ArrayXd expSum(nPrimitivePairs_), factorA(nPrimitivePairs_), factorB(nPrimitivePairs_),
+      coefficients(nPrimitivePairs_);
+  for (int a = 0; a < nGtfA; ++a) {
+    for (int b = 0; b < nGtfB; ++b) {
+      const int index = a * nGtfB + b;
+      const double expA = gtoA.gtfs[a].exponent;
+      const double expB = gtoB.gtfs[b].exponent;
+      expSum[index] = expA + expB;
+      factorA[index] = expA / expSum[index];
+      factorB[index] = expB / expSum[index];
+      coefficients[index] = gtoA.gtfs[a].normalizedCoefficient * gtoB.gtfs[b].normalizedCoefficient;
+    }
+  }
+
+  const Eigen::ArrayXd laneFactorA = factorA.replicate(nPairs, 1);
+  const Eigen::ArrayXd laneFactorB = factorB.replicate(nPairs, 1);
+  const Eigen::ArrayXd exponentialCoefficientS_00 = -laneFactorA * laneFactorB * expSum.replicate(nPairs, 1);
+  halfInverseExpSum_ = (0.5 / expSum).replicate(nPairs, 1);
+
+  Eigen::ArrayXd squaredDistance = Eigen::ArrayXd::Zero(nLanes_);
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    Eigen::ArrayXd Ra(nLanes_), Rb(nLanes_);
+    for (int pair = 0; pair < nPairs; ++pair) {
+      Ra.segment(pair * nPrimitivePairs_, nPrimitivePairs_).setConstant(Ras[pair][dimension]);
+      Rb.segment(pair * nPrimitivePairs_, nPrimitivePairs_).setConstant(Rbs[pair][dimension]);
+    }
+    const Eigen::ArrayXd P = Ra * laneFactorA + Rb * laneFactorB;
+    PminusA_[dimension] = P - Ra;
+    PminusB_[dimension] = P - Rb;
+    PminusC_[dimension] = P - dipoleEvaluationCoordinate(dimension);
+    squaredDistance += (Rb - Ra).square();
+  }
+  prefactor_ = (exponentialCoefficientS_00 * squaredDistance).exp() * coefficients.replicate(nPairs, 1);
+
+  const Eigen::ArrayXd recursionInitialOverlap = (M_PI / expSum).sqrt().replicate(nPairs, 1);
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    overlapIntegral_[dimension][0][0] = recursionInitialOverlap;
+    dipoleIntegral_[dimension][0][0] = PminusC_[dimension] * recursionInitialOverlap;
+  }
+}
+
+void BatchedGTODipoleMatrixBlock::calculateOneDimensionalIntegrals(int angularMomentumA, int angularMomentumB) {
+  // Same Obara-Saika relations as in GTODipoleMatrixBlock:
+  // S_i,j = X_PA * S_i-1,j + 1/(2expSum) * ((i-1)*S_i-2,j + j*S_i-1,j-1)
+  // S_i,j = X_PB * S_i,j-1 + 1/(2expSum) * (i*S_i-1,j-1 + (j-1)*S_i,j-2)
+  // D_i,j = X_PA * D_i-1,j + 1/(2expSum) * ((i-1)*D_i-2,j + j*D_i-1,j-1 + S_i-1,j)
+  // D_i,j = X_PB * D_i,j-1 + 1/(2expSum) * (i*D_i-1,j-1 + (j-1)*D_i,j-2 + S_i,j-1)
+  const auto& p = halfInverseExpSum_;
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    auto& S = overlapIntegral_[dimension];
+    auto& D = dipoleIntegral_[dimension];
+    for (int i = 0; i <= angularMomentumA; ++i) {
+      for (int j = 0; j <= angularMomentumB; ++j) {
+        if (i == 0 && j == 0)
+          continue;
+        if (j == 0) { // first formulae
+          S[i][j] = PminusA_[dimension] * S[i - 1][j];
+          D[i][j] = PminusA_[dimension] * D[i - 1][j] + p * S[i - 1][j];
+          if (i > 1) {
+            S[i][j] += (i - 1.0) * p * S[i - 2][j];
+            D[i][j] += (i - 1.0) * p * D[i - 2][j];
+          }
+        }
+        else { // second formulae
+          S[i][j] = PminusB_[dimension] * S[i][j - 1];
+          D[i][j] = PminusB_[dimension] * D[i][j - 1] + p * S[i][j - 1];
+          if (i > 0) {
+            S[i][j] += i * p * S[i - 1][j - 1];
+            D[i][j] += i * p * D[i - 1][j - 1];
+          }
+          if (j > 1) {
+            S[i][j] += (j - 1.0) * p * S[i][j - 2];
+            D[i][j] += (j - 1.0) * p * D[i][j - 2];
+          }
+        }
+      } // end j loop
+    }   // end i loop
+  }     // end dimension loop
+}
+
+void BatchedGTODipoleMatrixBlock::dOrbitalsFromSixCartesianToFiveRealSolidHarmonics(
+    std::array<Eigen::Matrix<double, 6, 6>, 3>& blocks) const {
+  for (auto& dipoleBlock : blocks) {
+    if (orbitalShellSizeA_ == 6) {
+      for (int j = 0; j < orbitalShellSizeB_; ++j) {
+        dipoleBlock(3, j) = (dipoleBlock(3, j) - 0.5 * dipoleBlock(4, j) - 0.5 * dipoleBlock(5, j)) / std::sqrt(3);
+        dipoleBlock(4, j) = 0.5 * (dipoleBlock(5, j) - dipoleBlock(4, j));
+      }
+    }
+    if (orbitalShellSizeB_ == 6) {
+      for (int i = 0; i < orbitalShellSizeA_; ++i) {
+        dipoleBlock(i, 3) = (dipoleBlock(i, 3) - 0.5 * dipoleBlock(i, 4) - 0.5 * dipoleBlock(i, 5)) / std::sqrt(3);
+        dipoleBlock(i, 4) = 0.5 * (dipoleBlock(i, 5) - dipoleBlock(i, 4));
+      }
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,73 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_BATCHEDGTODIPOLEMATRIXBLOCK_H
+#define SPARROW_BATCHEDGTODIPOLEMATRIXBLOCK_H
+
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/GTOOverlapMatrixBlock.h>
+#include <Eigen/Core>
+#include <array>
+#include <vector>
+
+namespace Scine {
+
+namespace Utils {
+class GtoExpansion;
+} // namespace Utils
+
+namespace Sparrow {
+
+/**
+ * @brief Batched version of GTODipoleMatrixBlock for the Obara-Saika scheme.
+ *
+ * All primitive pairs of a shell pair, for one or several atom pairs sharing the same shells, are laid out as lanes
+ * of Eigen arrays so that the recursion is evaluated in vectorized form for all of them at once.
+ * The resulting blocks are identical to the ones of GTODipoleMatrixBlock::createSTOBlock.
+ * An instance keeps its work arrays between calls and must therefore not be shared between threads.
+ */
+class BatchedGTODipoleMatrixBlock {
+ public:
+  BatchedGTODipoleMatrixBlock();
+
+  /**
+   * @brief Calculates the dipole blocks of the shells gtoA and gtoB for several atom pairs at once.
+   * @param Ras The positions of the atoms A, one for each atom pair.
+   * @param Rbs The positions of the atoms B, one for each atom pair.
+   * @param dipoleEvaluationCoordinate The origin of the dipole operator.
+   * @return The x, y and z dipole blocks for each atom pair, in the same order as Ras and Rbs.
+   */
+  std::vector<std::array<Eigen::MatrixXd, 3>>
+  createSTOBlocks(const Utils::GtoExpansion& gtoA, const Utils::GtoExpansion& gtoB,
+                  const std::vector<Eigen::RowVector3d>& Ras, const std::vector<Eigen::RowVector3d>& Rbs,
+                  const Eigen::RowVector3d& dipoleEvaluationCoordinate);
+
+ private:
+  void setLanes(const Utils::GtoExpansion& gtoA, const Utils::GtoExpansion& gtoB,
+                const std::vector<Eigen::RowVector3d>& Ras, const std::vector<Eigen::RowVector3d>& Rbs,
+                const Eigen::RowVector3d& dipoleEvaluationCoordinate);
+  void calculateOneDimensionalIntegrals(int angularMomentumA, int angularMomentumB);
+  void dOrbitalsFromSixCartesianToFiveRealSolidHarmonics(std::array<Eigen::Matrix<double, 6, 6>, 3>& blocks) const;
+
+  int nLanes_ = 0;
+  int nPrimitivePairs_ = 0;
+  int startAOonA_;
+  int startAOonB_;
+  int orbitalShellSizeA_;
+  int orbitalShellSizeB_;
+  std::array<nddo::AngularMomentum, 10> AOMomenta_;
+  // Per lane quantities
+  Eigen::ArrayXd halfInverseExpSum_, prefactor_;
+  std::array<Eigen::ArrayXd, 3> PminusA_, PminusB_, PminusC_;
+  // One-dimensional overlap and dipole integrals, [direction][lA][lB]
+  std::array<std::array<std::array<Eigen::ArrayXd, 3>, 3>, 3> overlapIntegral_, dipoleIntegral_;
+  Eigen::ArrayXd laneContribution_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_BATCHEDGTODIPOLEMATRIXBLOCK_H
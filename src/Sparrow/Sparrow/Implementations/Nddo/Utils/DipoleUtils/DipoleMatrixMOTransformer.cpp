@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "DipoleMatrixMOTransformer.h"
+#include <Utils/DataStructures/DipoleMatrix.h>
+#include <Utils/DataStructures/MolecularOrbitals.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+
+namespace Scine {
+namespace Sparrow {
+
+Eigen::MatrixXd DipoleMatrixMOTransformer::halfTransform(const Utils::DipoleMatrix& aoDipoleMatrix,
+                                                         const Eigen::MatrixXd& right) {
+  const auto nCols = right.cols();
+  Eigen::MatrixXd stacked(right.rows(), 3 * nCols);
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    stacked.middleCols(dimension * nCols, nCols).noalias() =
+        aoDipoleMatrix[dimension].selfadjointView<Eigen::Upper>() * right;
+  }
+  return stacked;
+}
+
+Utils::DipoleMatrix DipoleMatrixMOTransformer::transform(const Utils::DipoleMatrix& aoDipoleMatrix,
+                                                         const Utils::MolecularOrbitals& mos) {
+  Utils::DipoleMatrix moDipoleMatrix;
+  auto transformBlock = [&](const Eigen::MatrixXd& coefficients, int offset) {
+    const auto nMOs = coefficients.cols();
+    Eigen::MatrixXd transformed(nMOs, 3 * nMOs);
+    transformed.noalias() = coefficients.transpose() * halfTransform(aoDipoleMatrix, coefficients);
+    for (int dimension = 0; dimension < 3; ++dimension) {
+      moDipoleMatrix[dimension].block(offset, offset, nMOs, nMOs) = transformed.middleCols(dimension * nMOs, nMOs);
+    }
+  };
+
+  if (mos.isRestricted()) {
+    moDipoleMatrix.reset(mos.restrictedMatrix().cols());
+    transformBlock(mos.restrictedMatrix(), 0);
+  }
+  else {
+    const auto nMOs = static_cast<int>(mos.alphaMatrix().cols());
+    moDipoleMatrix.reset(2 * nMOs);
+    transformBlock(mos.alphaMatrix(), 0);
+    transformBlock(mos.betaMatrix(), nMOs);
+  }
+  return moDipoleMatrix;
+}
+
+Utils::DipoleMatrix DipoleMatrixMOTransformer::transformOccupiedVirtual(const Utils::DipoleMatrix& aoDipoleMatrix,
+                                                                        const Utils::MolecularOrbitals& mos,
+                                                                        const Utils::LcaoUtils::ElectronicOccupation& occupation) {
+  Utils::DipoleMatrix moDipoleMatrix;
+  if (mos.isRestricted()) {
+    moDipoleMatrix.reset(mos.restrictedMatrix().cols());
+    transformOccupiedVirtualBlock(aoDipoleMatrix, mos.restrictedMatrix(), occupation.getFilledRestrictedOrbitals(), 0,
+                                  moDipoleMatrix);
+  }
+  else {
+    const auto nMOs = static_cast<int>(mos.alphaMatrix().cols());
+    moDipoleMatrix.reset(2 * nMOs);
+    transformOccupiedVirtualBlock(aoDipoleMatrix, mos.alphaMatrix(), occupation.getFilledAlphaOrbitals(), 0, moDipoleMatrix);
+    transformOccupiedVirtualBlock(aoDipoleMatrix, mos.betaMatrix(), occupation.getFilledBetaOrbitals(), nMOs, moDipoleMatrix);
+  }
+  return moDipoleMatrix;
+}
+
+void DipoleMatrixMOTransformer::transformOccupiedVirtualBlock(const Utils::DipoleMatrix& aoDipoleMatrix,
+                                                              const Eigen::MatrixXd& mos,
+                                                              const std::vector<int>& filledOrbitals, int offset,
+                                                              Utils::DipoleMatrix& moDipoleMatrix) {
+  const auto nMOs = static_cast<int>(mos.cols());
+  const auto nOccupied = static_cast<int>(filledOrbitals.size());
+  const auto nVirtual = nMOs - nOccupied;
+
+  // Split the MO coefficients in occupied and virtual orbitals, the filled orbitals being sorted.
+  std::vector<int> virtualOrbitals;
+  virtualOrbitals.reserve(nVirtual);
+  Eigen::MatrixXd occupiedCoefficients(mos.rows(), nOccupied);
+  Eigen::MatrixXd virtualCoefficients(mos.rows(), nVirtual);
+  int iterFilled = 0;
+  for (int i = 0; i < nMOs; ++i) {
+    if (iterFilled < nOccupied && i == filledOrbitals[iterFilled]) {
+      occupiedCoefficients.col(iterFilled) = mos.col(i);
+      ++iterFilled;
+    }
+    else {
+      virtualCoefficients.col(virtualOrbitals.size()) = mos.col(i);
+      virtualOrbitals.push_back(i);
+    }
+  }
+
+  Eigen::MatrixXd transformed(nOccupied, 3 * nVirtual);
+  transformed.noalias() = occupiedCoefficients.transpose() * halfTransform(aoDipoleMatrix, virtualCoefficients);
+
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    for (int a = 0; a < nVirtual; ++a) {
+      const int vir = offset + virtualOrbitals[a];
+      for (int i = 0; i < nOccupied; ++i) {
+        const int occ = offset + filledOrbitals[i];
+        const double value = transformed(i, dimension * nVirtual + a);
+        moDipoleMatrix[dimension](occ, vir) = value;
+        moDipoleMatrix[dimension](vir, occ) = value;
+      }
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_DIPOLEMATRIXMOTRANSFORMER_H
+#define SPARROW_DIPOLEMATRIXMOTRANSFORMER_H
+
+#include <Eigen/Core>
+#include <vector>
+
+namespace Scine {
+namespace Utils {
+class DipoleMatrix;
+class MolecularOrbitals;
+namespace LcaoUtils {
+class ElectronicOccupation;
+} // namespace LcaoUtils
+} // namespace Utils
+
+namespace Sparrow {
+
+/**
+ * @brief Transforms the AO dipole matrix, of which only the upper triangle is referenced, into the MO basis.
+ *
+ * The three Cartesian components are transformed together: the half-transformed matrices D_k * C are
+ * stacked column-wise so that the second half-transformation is a single matrix-matrix product.
+ * In the unrestricted case the alpha and beta blocks are stored on the diagonal of a matrix of twice the
+ * number of MOs, as in NDDODipoleMatrixCalculator.
+ */
+class DipoleMatrixMOTransformer {
+ public:
+  /**
+   * @brief Calculates the full MO dipole matrix.
+   */
+  static Utils::DipoleMatrix transform(const Utils::DipoleMatrix& aoDipoleMatrix, const Utils::MolecularOrbitals& mos);
+  /**
+   * @brief Calculates only the occupied-virtual (and, by symmetry, virtual-occupied) elements of the MO dipole matrix.
+   * This is all that is needed for transition dipole moments of single excitations from the reference determinant.
+   * All other elements are set to zero.
+   */
+  static Utils::DipoleMatrix transformOccupiedVirtual(const Utils::DipoleMatrix& aoDipoleMatrix,
+                                                      const Utils::MolecularOrbitals& mos,
+                                                      const Utils::LcaoUtils::ElectronicOccupation& occupation);
+
+ private:
+  /*
+   * Returns [D_x * right, D_y * right, D_z * right] with D_k the symmetric matrix stored in the upper triangle.
+   */
+  static Eigen::MatrixXd halfTransform(const Utils::DipoleMatrix& aoDipoleMatrix, const Eigen::MatrixXd& right);
+  static void transformOccupiedVirtualBlock(const Utils::DipoleMatrix& aoDipoleMatrix, const Eigen::MatrixXd& mos,
+                                            const std::vector<int>& filledOrbitals, int offset,
+                                            Utils::DipoleMatrix& moDipoleMatrix);
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_DIPOLEMATRIXMOTRANSFORMER_H
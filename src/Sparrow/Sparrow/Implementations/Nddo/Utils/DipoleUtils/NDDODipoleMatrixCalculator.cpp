@@ -7,6 +7,7 @@
 
 #include "NDDODipoleMatrixCalculator.h"
 #include "Sparrow/Implementations/Nddo/Utils/DipoleUtils/AtomPairDipole.h"
+#include "Sparrow/Implementations/Nddo/Utils/DipoleUtils/DipoleMatrixMOTransformer.h"
 #include "Sparrow/Implementations/Nddo/Utils/DipoleUtils/GTODipoleMatrixBlock.h"
 #include <Sparrow/Implementations/Nddo/Am1/AM1Method.h>
 #include <Sparrow/Implementations/Nddo/Mndo/MNDOMethod.h>
@@ -18,7 +19,9 @@
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
 #include <Eigen/Eigenvalues>
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 namespace Scine {
 namespace Sparrow {
@@ -43,21 +46,39 @@ template<class NDDOMethod>
 void NDDODipoleMatrixCalculator<NDDOMethod>::fillDipoleMatrix(const Eigen::RowVector3d& dipoleEvaluationCoordinate) {
   initialize();
   valid_ = false;
+  // Only the upper triangle is calculated. Atom pairs of the same element pair share their basis functions and are
+  // evaluated together, each batch writes to its own blocks.
+  std::map<std::pair<Utils::ElementType, Utils::ElementType>, std::vector<std::pair<int, int>>> pairsPerElementPair;
   for (int atom_i = 0; atom_i < nAtoms_; ++atom_i) {
-    auto const firstAOIndex_i = aoIndexes_.getFirstOrbitalIndex(atom_i);
-    auto const& parA = elementParameters_.get(elementTypes_[atom_i]);
-    auto const Ri = positions_.row(atom_i);
-
     for (int atom_j = atom_i; atom_j < nAtoms_; ++atom_j) {
-      auto const firstAOIndex_j = aoIndexes_.getFirstOrbitalIndex(atom_j);
-      auto const& parB = elementParameters_.get(elementTypes_[atom_j]);
-      auto const Rj = positions_.row(atom_j);
-
-      Eigen::RowVector3d Rij = Rj - Ri;
+      pairsPerElementPair[{elementTypes_[atom_i], elementTypes_[atom_j]}].emplace_back(atom_i, atom_j);
+    }
+  }
+  std::vector<std::vector<std::pair<int, int>>> atomPairBatches;
+  for (const auto& elementPair : pairsPerElementPair) {
+    const auto& pairs = elementPair.second;
+    for (std::size_t first = 0; first < pairs.size(); first += atomPairBatchSize_) {
+      auto last = std::min(pairs.size(), first + atomPairBatchSize_);
+      atomPairBatches.emplace_back(pairs.begin() + first, pairs.begin() + last);
+    }
+  }
 
-      AtomPairDipole::fillAtomPairDipoleBlock(dipoleMatrix_, firstAOIndex_i, firstAOIndex_j, integralMethod_,
-                                              parA.GTOs(), parB.GTOs(), Ri, Rj, Rij, dipoleEvaluationCoordinate);
+  const auto nBatches = static_cast<int>(atomPairBatches.size());
+#pragma omp parallel for schedule(dynamic)
+  for (int batch = 0; batch < nBatches; ++batch) {
+    const auto& atomPairs = atomPairBatches[batch];
+    auto const& parA = elementParameters_.get(elementTypes_[atomPairs.front().first]);
+    auto const& parB = elementParameters_.get(elementTypes_[atomPairs.front().second]);
+    std::vector<std::pair<int, int>> startIndices;
+    std::vector<Eigen::RowVector3d> Ris, Rjs;
+    for (const auto& atomPair : atomPairs) {
+      startIndices.emplace_back(aoIndexes_.getFirstOrbitalIndex(atomPair.first),
+                                aoIndexes_.getFirstOrbitalIndex(atomPair.second));
+      Ris.emplace_back(positions_.row(atomPair.first));
+      Rjs.emplace_back(positions_.row(atomPair.second));
     }
+    AtomPairDipole::fillAtomPairDipoleBlocks(dipoleMatrix_, startIndices, integralMethod_, parA.GTOs(), parB.GTOs(),
+                                             Ris, Rjs, dipoleEvaluationCoordinate);
   }
   valid_ = true;
 }
@@ -97,48 +118,18 @@ std::unique_ptr<NDDODipoleMatrixCalculator<NDDOMethod>> NDDODipoleMatrixCalculat
 
 template<class NDDOMethod>
 Utils::DipoleMatrix NDDODipoleMatrixCalculator<NDDOMethod>::getMODipoleMatrix() const {
-  if (molecularOrbitals_.isRestricted())
-    return calculateMODipoleMatrixRestricted();
-  else
-    return calculateMODipoleMatrixUnrestricted();
+  return DipoleMatrixMOTransformer::transform(dipoleMatrix_, molecularOrbitals_);
 }
 
 template<class NDDOMethod>
-void NDDODipoleMatrixCalculator<NDDOMethod>::invalidate() {
-  valid_ = false;
+Utils::DipoleMatrix
+NDDODipoleMatrixCalculator<NDDOMethod>::getOccupiedVirtualMODipoleMatrix(const Utils::LcaoUtils::ElectronicOccupation& occupation) const {
+  return DipoleMatrixMOTransformer::transformOccupiedVirtual(dipoleMatrix_, molecularOrbitals_, occupation);
 }
 
 template<class NDDOMethod>
-Utils::DipoleMatrix NDDODipoleMatrixCalculator<NDDOMethod>::calculateMODipoleMatrixRestricted() const {
-  Utils::DipoleMatrix moDipoleMatrix;
-  Eigen::MatrixXd MOMatrix = molecularOrbitals_.restrictedMatrix();
-  moDipoleMatrix.reset(dipoleMatrix_[0].cols());
-  // Get the MO matrix as D_{MO} = C^T * D_{AO} * C
-  for (int dimension = 0; dimension < 3; ++dimension) {
-    moDipoleMatrix[dimension] =
-        MOMatrix.transpose() * dipoleMatrix_[dimension].template selfadjointView<Eigen::Upper>() * MOMatrix;
-  }
-  return moDipoleMatrix;
-}
-
-template<class NDDOMethod>
-Utils::DipoleMatrix NDDODipoleMatrixCalculator<NDDOMethod>::calculateMODipoleMatrixUnrestricted() const {
-  Utils::DipoleMatrix moDipoleMatrix;
-  Eigen::MatrixXd alphaMOMatrix = molecularOrbitals_.alphaMatrix();
-  Eigen::MatrixXd betaMOMatrix = molecularOrbitals_.betaMatrix();
-
-  moDipoleMatrix.reset(alphaMOMatrix.cols() * 2);
-
-  for (int dimension = 0; dimension < 3; ++dimension) {
-    auto alphaContribution =
-        alphaMOMatrix.transpose() * dipoleMatrix_[dimension].template selfadjointView<Eigen::Upper>() * alphaMOMatrix;
-    auto betaContribution =
-        betaMOMatrix.transpose() * dipoleMatrix_[dimension].template selfadjointView<Eigen::Upper>() * betaMOMatrix;
-    moDipoleMatrix[dimension].block(0, 0, alphaContribution.rows(), alphaContribution.cols()) = alphaContribution;
-    moDipoleMatrix[dimension].block(alphaContribution.rows(), alphaContribution.cols(), betaContribution.rows(),
-                                    betaContribution.cols()) = betaContribution;
-  }
-  return moDipoleMatrix;
+void NDDODipoleMatrixCalculator<NDDOMethod>::invalidate() {
+  valid_ = false;
 }
 
 template class NDDODipoleMatrixCalculator<nddo::PM6Method>;
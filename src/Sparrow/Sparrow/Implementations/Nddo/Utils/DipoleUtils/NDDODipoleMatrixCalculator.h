@@ -19,6 +19,9 @@ namespace Scine {
 namespace Utils {
 class AtomsOrbitalsIndexes;
 class MolecularOrbitals;
+namespace LcaoUtils {
+class ElectronicOccupation;
+} // namespace LcaoUtils
 } // namespace Utils
 
 namespace Sparrow {
@@ -34,11 +37,13 @@ class ElementParameters;
  * This class is responsible for the calculation of the dipole matrix in both
  * atomic and molecular orbital basis. The dipole matrix in atomic orbital basis
  * is calculated by explicitly integrating in closed form or using the highly
- * efficient Obara-Saika scheme the dipole integral <\mu|r|\nu>.
+ * efficient Obara-Saika scheme the dipole integral <\mu|r|\nu>. Only its upper triangle is calculated,
+ * in parallel over batches of atom pairs of the same element pair.
  * The dipole matrix in atomic orbital basis is then transformed in molecular
  * orbital basis by D_{MO} = C^T * D_{AO} * C in restricted formalism,
  * D_{MO} = C_\alpha^T * D_{AO} * C_\alpha + C_\beta^T * D_{AO} * C_\beta in
- * unrestricted formalism.
+ * unrestricted formalism, the three Cartesian components being transformed together
+ * (see DipoleMatrixMOTransformer).
  */
 template<class NDDOMethod>
 class NDDODipoleMatrixCalculator final : public DipoleMatrixCalculator {
@@ -56,6 +61,11 @@ class NDDODipoleMatrixCalculator final : public DipoleMatrixCalculator {
    * @return The dipole matrix in MO basis.
    */
   Utils::DipoleMatrix getMODipoleMatrix() const final;
+  /**
+   * @brief Getter for the occupied-virtual elements of the dipole matrix in MO basis.
+   * Cheaper than getMODipoleMatrix() if only transition dipole moments are needed, all other elements are zero.
+   */
+  Utils::DipoleMatrix getOccupiedVirtualMODipoleMatrix(const Utils::LcaoUtils::ElectronicOccupation& occupation) const;
   /**
    * @brief Setter for the dipole matrix in AO basis.
    */
@@ -86,8 +96,8 @@ class NDDODipoleMatrixCalculator final : public DipoleMatrixCalculator {
 
  private:
   explicit NDDODipoleMatrixCalculator(NDDOMethod& method);
-  Utils::DipoleMatrix calculateMODipoleMatrixRestricted() const;
-  Utils::DipoleMatrix calculateMODipoleMatrixUnrestricted() const;
+  // Number of atom pairs of the same element pair evaluated together by AtomPairDipole::fillAtomPairDipoleBlocks.
+  static constexpr std::size_t atomPairBatchSize_ = 8;
   int nAOs_;
   const Utils::AtomsOrbitalsIndexes& aoIndexes_;
   const Utils::ElementTypeCollection& elementTypes_;
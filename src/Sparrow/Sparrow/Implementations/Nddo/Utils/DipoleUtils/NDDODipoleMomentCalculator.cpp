@@ -161,19 +161,14 @@ Eigen::RowVector3d NDDODipoleMomentCalculator<NDDOMethod>::calculateWithDipoleMa
     dipole += coreCharges[atom] * positions.row(atom);
   }
 
-  // electronic component (diagonal)
-  for (int AO = 0; AO < atomicOrbitalsNumber; ++AO) {
-    dipole.x() -= nonOrthogonalDensityMatrix(AO, AO) * dipoleMatrix.x().get<Utils::DerivativeOrder::Zero>()(AO, AO);
-    dipole.y() -= nonOrthogonalDensityMatrix(AO, AO) * dipoleMatrix.y().get<Utils::DerivativeOrder::Zero>()(AO, AO);
-    dipole.z() -= nonOrthogonalDensityMatrix(AO, AO) * dipoleMatrix.z().get<Utils::DerivativeOrder::Zero>()(AO, AO);
-  }
-  // electronic component(off-diagonal)
-  for (int nu = 0; nu < atomicOrbitalsNumber; ++nu) {
-    for (int mu = nu + 1; mu < atomicOrbitalsNumber; ++mu) {
-      dipole.x() -= 2 * nonOrthogonalDensityMatrix(nu, mu) * dipoleMatrix.x().get<Utils::DerivativeOrder::Zero>()(nu, mu);
-      dipole.y() -= 2 * nonOrthogonalDensityMatrix(nu, mu) * dipoleMatrix.y().get<Utils::DerivativeOrder::Zero>()(nu, mu);
-      dipole.z() -= 2 * nonOrthogonalDensityMatrix(nu, mu) * dipoleMatrix.z().get<Utils::DerivativeOrder::Zero>()(nu, mu);
+  // electronic component, the dipole matrix being stored in the upper triangle
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    const auto& D = dipoleMatrix[dimension];
+    double electronicContribution = nonOrthogonalDensityMatrix.diagonal().dot(D.diagonal());
+    for (int mu = 1; mu < atomicOrbitalsNumber; ++mu) {
+      electronicContribution += 2 * nonOrthogonalDensityMatrix.col(mu).head(mu).dot(D.col(mu).head(mu));
     }
+    dipole(dimension) -= electronicContribution;
   }
   return dipole;
 }
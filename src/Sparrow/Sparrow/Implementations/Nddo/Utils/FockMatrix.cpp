@@ -7,9 +7,15 @@
 
 #include "FockMatrix.h"
 #include <Sparrow/Implementations/Nddo/Utils/NDDOElectronicEnergyCalculator.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Sparrow/Implementations/ScfAccelerator.h>
 #include <Utils/DataStructures/DensityMatrix.h>
 #include <Utils/Scf/MethodInterfaces/AdditiveElectronicContribution.h>
 #include <Utils/Scf/MethodInterfaces/OverlapCalculator.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -25,6 +31,8 @@ FockMatrix::FockMatrix(const Utils::ElementTypeCollection& elements, const Utils
   : twoCenterIntegrals_(elements, positions, elementPar),
     F1_(elements, positions, densityMatrix.restrictedMatrix(), twoCenterIntegrals_, elementPar, aoIndexes),
     F2_(elements, densityMatrix, oneCIntegrals, twoCenterIntegrals_, elementPar, aoIndexes),
+    longRange_(elements, positions, densityMatrix.restrictedMatrix(), elementPar, aoIndexes),
+    densityMatrix_(densityMatrix),
     overlapCalculator_(overlapCalculator),
     unrestrictedCalculationRunning_(unrestrictedCalculationRunning) {
   electronicEnergyCalculator_ =
@@ -40,6 +48,23 @@ void FockMatrix::initialize() {
 void FockMatrix::calculateDensityIndependentPart(Utils::DerivativeOrder order) {
   twoCenterIntegrals_.update(order);
   F1_.calculate(overlapCalculator_.getOverlap()); // NEEDS TO BE AFTER twoCenterIntegrals update!
+  if (longRange_.isPeriodic()) {
+    longRange_.calculateInteractions();
+  }
+  // The single-precision copies of the integrals are outdated.
+  F2_.setSinglePrecision(false);
+  // A new SCF cycle starts in single precision if the mixed-precision mode is enabled, a continued one does not.
+  if (!continueInDoublePrecision_) {
+    nSinglePrecisionIterations_ = 0;
+  }
+  singlePrecisionActive_ = mixedPrecision_ && !continueInDoublePrecision_;
+  continueInDoublePrecision_ = false;
+  endedInSinglePrecision_ = false;
+  previousDensity_.resize(0, 0);
+  hasAcceleratedFock_ = false;
+  if (scfAccelerator_) {
+    scfAccelerator_->reset();
+  }
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
       contribution->calculate({}, order);
@@ -47,7 +72,22 @@ void FockMatrix::calculateDensityIndependentPart(Utils::DerivativeOrder order) {
 }
 
 void FockMatrix::calculateDensityDependentPart(Utils::DerivativeOrder order) {
+  updatePrecision();
+  updateDensityDependentPart(order);
+  hasAcceleratedFock_ = false;
+  if (scfAccelerator_ && scfAccelerator_->isActive()) {
+    // The NDDO basis is orthogonal: no overlap matrix
+    acceleratedFock_ = scfAccelerator_->accelerate(calculateMatrix(), densityMatrix_, {}, calculateElectronicEnergy(),
+                                                   unrestrictedCalculationRunning_);
+    hasAcceleratedFock_ = true;
+  }
+}
+
+void FockMatrix::updateDensityDependentPart(Utils::DerivativeOrder order) {
   F2_.calculate(unrestrictedCalculationRunning_);
+  if (longRange_.isPeriodic()) {
+    longRange_.calculate();
+  }
 
   for (auto& contribution : densityDependentContributions_) {
     if (contribution->isValid())
@@ -55,8 +95,29 @@ void FockMatrix::calculateDensityDependentPart(Utils::DerivativeOrder order) {
   }
 }
 
+void FockMatrix::updatePrecision() {
+  if (singlePrecisionActive_) {
+    // Below this density change the rounding errors of the single-precision matrix would prevent convergence.
+    const double threshold = std::max(mixedPrecisionHandOff_, 10.0 * std::numeric_limits<float>::epsilon());
+    const auto& density = densityMatrix_.restrictedMatrix();
+    if (previousDensity_.rows() == density.rows() && previousDensity_.cols() == density.cols() && density.size() > 0) {
+      double rmsd = std::sqrt((density - previousDensity_).squaredNorm() / density.size());
+      // Once switched to double precision, the current SCF cycle stays in double precision.
+      singlePrecisionActive_ = rmsd >= threshold;
+    }
+    previousDensity_ = density;
+  }
+  if (singlePrecisionActive_) {
+    ++nSinglePrecisionIterations_;
+  }
+  F2_.setSinglePrecision(singlePrecisionActive_);
+}
+
 void FockMatrix::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
   addDerivativesImpl<Utils::Derivative::First>(derivatives);
+  if (longRange_.isPeriodic()) {
+    longRange_.addDerivatives(derivatives);
+  }
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
       contribution->addDerivatives(derivatives);
@@ -68,6 +129,9 @@ void FockMatrix::addDerivatives(Utils::AutomaticDifferentiation::DerivativeConta
 }
 
 void FockMatrix::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondAtomic>& derivatives) const {
+  if (longRange_.isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
   addDerivativesImpl<Utils::Derivative::SecondAtomic>(derivatives);
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
@@ -80,6 +144,9 @@ void FockMatrix::addDerivatives(Utils::AutomaticDifferentiation::DerivativeConta
 }
 
 void FockMatrix::addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::SecondFull>& derivatives) const {
+  if (longRange_.isPeriodic()) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
   addDerivativesImpl<Utils::Derivative::SecondFull>(derivatives);
   for (auto& contribution : densityIndependentContributions_) {
     if (contribution->isValid())
@@ -97,6 +164,12 @@ void FockMatrix::addDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeC
   F2_.addDerivatives<O>(derivatives);
 }
 
+void FockMatrix::addOneElectronDerivatives(
+    Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
+    const Eigen::MatrixXd& densityMatrix) const {
+  F1_.addDerivatives<Utils::Derivative::First>(derivatives, overlapCalculator_.getOverlap(), densityMatrix);
+}
+
 const OneElectronMatrix& FockMatrix::getOneElectronMatrix() const {
   return F1_;
 }
@@ -106,6 +179,13 @@ const TwoElectronMatrix& FockMatrix::getTwoElectronMatrix() const {
 }
 
 Utils::SpinAdaptedMatrix FockMatrix::getMatrix() const {
+  if (hasAcceleratedFock_) {
+    return acceleratedFock_;
+  }
+  return calculateMatrix();
+}
+
+Utils::SpinAdaptedMatrix FockMatrix::calculateMatrix() const {
   Utils::SpinAdaptedMatrix fock;
   if (!unrestrictedCalculationRunning_) {
     Eigen::MatrixXd restrictedFock = F1_.getMatrix() + F2_.getMatrix();
@@ -118,6 +198,9 @@ Utils::SpinAdaptedMatrix FockMatrix::getMatrix() const {
         restrictedFock += contribution->getElectronicContribution().restrictedMatrix();
       }
     }
+    if (longRange_.isPeriodic()) {
+      longRange_.addToFockMatrix(restrictedFock);
+    }
     fock.setRestrictedMatrix(std::move(restrictedFock));
   }
   else {
@@ -134,6 +217,9 @@ Utils::SpinAdaptedMatrix FockMatrix::getMatrix() const {
                             contribution->getElectronicContribution().betaMatrix();
       }
     }
+    if (longRange_.isPeriodic()) {
+      longRange_.addToFockMatrix(unrestrictedFock);
+    }
     fock.setAlphaMatrix(unrestrictedFock + F2_.getAlpha());
     fock.setBetaMatrix(unrestrictedFock + F2_.getBeta());
   }
@@ -141,12 +227,70 @@ Utils::SpinAdaptedMatrix FockMatrix::getMatrix() const {
 }
 
 double FockMatrix::calculateElectronicEnergy() const {
-  return electronicEnergyCalculator_->calculateElectronicEnergy();
+  double energy = electronicEnergyCalculator_->calculateElectronicEnergy() + F1_.getPointChargeCoreEnergy();
+  if (longRange_.isPeriodic()) {
+    energy += longRange_.getEnergy();
+  }
+  return energy;
 }
 
 void FockMatrix::finalize(Utils::DerivativeOrder order) {
   // Recalculate the Fock matrix: make it consistent with the obtained density matrix
-  calculateDensityDependentPart(order);
+  endedInSinglePrecision_ = singlePrecisionActive_;
+  singlePrecisionActive_ = false;
+  updatePrecision();
+  updateDensityDependentPart(order);
+  hasAcceleratedFock_ = false;
+}
+
+void FockMatrix::setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding) {
+  pointCharges_ = std::move(embedding);
+  F1_.setPointChargeEmbedding(pointCharges_.get());
+}
+
+void FockMatrix::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  twoCenterIntegrals_.setPeriodicCell(cell);
+  longRange_.setPeriodicCell(std::move(cell));
+}
+
+void FockMatrix::setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator) {
+  scfAccelerator_ = std::move(accelerator);
+}
+
+Eigen::Matrix3d FockMatrix::getStrainDerivatives() const {
+  Eigen::Matrix3d strainDerivatives = F1_.getStrainDerivatives() + F2_.getStrainDerivatives();
+  if (longRange_.isPeriodic()) {
+    strainDerivatives += longRange_.getStrainDerivatives();
+  }
+  return strainDerivatives;
+}
+
+void FockMatrix::setMixedPrecision(bool enabled, double handOffThreshold) {
+  mixedPrecision_ = enabled;
+  mixedPrecisionHandOff_ = handOffThreshold;
+  if (!enabled) {
+    singlePrecisionActive_ = false;
+  }
+}
+
+bool FockMatrix::usesMixedPrecision() const {
+  return mixedPrecision_;
+}
+
+double FockMatrix::getMixedPrecisionHandOff() const {
+  return mixedPrecisionHandOff_;
+}
+
+int FockMatrix::getNumberOfSinglePrecisionIterations() const {
+  return nSinglePrecisionIterations_;
+}
+
+bool FockMatrix::endedInSinglePrecision() const {
+  return endedInSinglePrecision_;
+}
+
+void FockMatrix::continueInDoublePrecision() {
+  continueInDoublePrecision_ = true;
 }
 
 void FockMatrix::addDensityIndependentElectronicContribution(std::shared_ptr<Utils::AdditiveElectronicContribution> contribution) {
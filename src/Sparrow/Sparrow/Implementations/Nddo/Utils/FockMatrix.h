@@ -8,6 +8,7 @@
 #ifndef SPARROW_NDDO_FOCKMATRIX_H
 #define SPARROW_NDDO_FOCKMATRIX_H
 
+#include "LongRangeElectrostatics.h"
 #include "OneElectronMatrix.h"
 #include "TwoElectronMatrix.h"
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/TwoCenterIntegralContainer.h>
@@ -26,6 +27,9 @@ class AdditiveElectronicContribution;
 } // namespace Utils
 
 namespace Sparrow {
+class PeriodicCell;
+class PointChargeEmbedding;
+class ScfAccelerator;
 
 namespace nddo {
 
@@ -49,6 +53,58 @@ class FockMatrix final : public Utils::ElectronicContributionCalculator {
 
   const OneElectronMatrix& getOneElectronMatrix() const;
   const TwoElectronMatrix& getTwoElectronMatrix() const;
+  /**
+   * @brief Adds the first derivatives of tr(H D) of the one-electron matrix H for a symmetric density matrix D.
+   * Meant for response densities, see OneElectronMatrix::addDerivatives(). The derivatives of the overlap matrix must
+   * have been calculated, i.e. the last calculation must have included the gradients.
+   */
+  void addOneElectronDerivatives(
+      Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives,
+      const Eigen::MatrixXd& densityMatrix) const;
+
+  /**
+   * @brief Enables the mixed-precision SCF mode.
+   * The two-electron matrix is accumulated in single precision until the root-mean-square change of the density
+   * matrix between two SCF iterations falls below handOffThreshold, and in double precision from then on. The
+   * final Fock matrix, the electronic energy and the derivatives are always calculated in double precision.
+   */
+  void setMixedPrecision(bool enabled, double handOffThreshold);
+  bool usesMixedPrecision() const;
+  double getMixedPrecisionHandOff() const;
+  //! @brief Number of two-electron matrix evaluations in single precision during the last SCF cycle.
+  int getNumberOfSinglePrecisionIterations() const;
+  /**
+   * @brief Whether the density of the last SCF cycle was obtained from a two-electron matrix in single precision.
+   * The SCF may converge before the hand-off threshold is reached. Such a density has to be refined in double
+   * precision, see continueInDoublePrecision().
+   */
+  bool endedInSinglePrecision() const;
+  //! @brief Runs the next SCF cycle in double precision only, e.g. to refine a density of endedInSinglePrecision().
+  void continueInDoublePrecision();
+  /**
+   * @brief Sets the point charges embedding the molecule, nullptr for none.
+   * The point charges enter the one-electron matrix and the electronic energy also holds their interaction with the
+   * cores, see OneElectronMatrix::setPointChargeEmbedding().
+   */
+  void setPointChargeEmbedding(std::shared_ptr<PointChargeEmbedding> embedding);
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * The integrals of two atoms are evaluated for the closest periodic image, and the long-range electrostatics with
+   * all other images enter the Fock matrix and the electronic energy, see LongRangeElectrostatics. Only first
+   * derivatives are available with periodic boundaries. The overlap matrix and the core repulsion need the cell too.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  /**
+   * @brief Sets the SCF convergence accelerator, nullptr for none.
+   * If it is active, getMatrix() returns the extrapolated Fock matrix of the accelerator during the SCF cycle, and
+   * the Fock matrix of the density after finalize().
+   */
+  void setScfAccelerator(std::shared_ptr<ScfAccelerator> accelerator);
+  /**
+   * @brief Derivative of the electronic energy with respect to a homogeneous strain of the periodic cell and of the
+   *        positions, from the last call to addDerivatives() for first derivatives.
+   */
+  Eigen::Matrix3d getStrainDerivatives() const;
   const std::vector<std::shared_ptr<Utils::AdditiveElectronicContribution>>& getDensityDependentContributions() const;
   const std::vector<std::shared_ptr<Utils::AdditiveElectronicContribution>>& getDensityIndependentContributions() const;
 
@@ -68,12 +124,32 @@ class FockMatrix final : public Utils::ElectronicContributionCalculator {
  private:
   template<Utils::Derivative O>
   void addDerivativesImpl(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivatives) const;
+  // Decides whether the next two-electron matrix is calculated in single precision.
+  void updatePrecision();
+  // Two-electron matrix and density-dependent contributions of the current density.
+  void updateDensityDependentPart(Utils::DerivativeOrder order);
+  // Fock matrix of the current density, without convergence acceleration.
+  Utils::SpinAdaptedMatrix calculateMatrix() const;
 
   TwoCenterIntegralContainer twoCenterIntegrals_;
   OneElectronMatrix F1_;
   TwoElectronMatrix F2_;
+  LongRangeElectrostatics longRange_;
+  const Utils::DensityMatrix& densityMatrix_;
   const Utils::OverlapCalculator& overlapCalculator_;
   const bool& unrestrictedCalculationRunning_;
+  bool mixedPrecision_ = false;
+  double mixedPrecisionHandOff_ = 1e-4;
+  bool singlePrecisionActive_ = false;
+  int nSinglePrecisionIterations_ = 0;
+  bool endedInSinglePrecision_ = false;
+  bool continueInDoublePrecision_ = false;
+  Eigen::MatrixXd previousDensity_;
+  std::shared_ptr<PointChargeEmbedding> pointCharges_;
+  std::shared_ptr<ScfAccelerator> scfAccelerator_;
+  // Extrapolated Fock matrix of the current SCF iteration, if any
+  Utils::SpinAdaptedMatrix acceleratedFock_;
+  bool hasAcceleratedFock_ = false;
   std::unique_ptr<Utils::ElectronicEnergyCalculator> electronicEnergyCalculator_;
   std::vector<std::shared_ptr<Utils::AdditiveElectronicContribution>> densityDependentContributions_,
       densityIndependentContributions_;
@@ -6,6 +6,7 @@
  */
 
 #include "AtomPairOverlap.h"
+#include "BatchedGTOOverlapMatrixBlock.h"
 #include <Utils/DataStructures/AtomicGtos.h>
 #include <Utils/DataStructures/MatrixWithDerivatives.h>
 
@@ -17,44 +18,58 @@ namespace nddo {
 template<Utils::DerivativeOrder O>
 Eigen::Matrix<typename AtomPairOverlap<O>::Value3D, Eigen::Dynamic, Eigen::Dynamic>
 AtomPairOverlap<O>::getMatrixBlock(const Utils::AtomicGtos& pA, const Utils::AtomicGtos& pB, Eigen::Vector3d Rab) const {
-  auto localBlock = getInitialBlock(pA, pB);
-  GTOOverlapMatrixBlock<O> block;
+  return getMatrixBlocks(pA, pB, {Rab}).front();
+}
+
+template<Utils::DerivativeOrder O>
+std::vector<Eigen::Matrix<typename AtomPairOverlap<O>::Value3D, Eigen::Dynamic, Eigen::Dynamic>>
+AtomPairOverlap<O>::getMatrixBlocks(const Utils::AtomicGtos& pA, const Utils::AtomicGtos& pB,
+                                    const std::vector<Eigen::Vector3d>& Rabs) const {
+  std::vector<Eigen::Matrix<Value3D, Eigen::Dynamic, Eigen::Dynamic>> localBlocks(Rabs.size(), getInitialBlock(pA, pB));
+  BatchedGTOOverlapMatrixBlock<O> block;
+
+  auto fillShellPair = [&](const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB, int startRow, int startCol) {
+    auto shellBlocks = block.getMatrixBlocks(gA, gB, Rabs);
+    for (unsigned pair = 0; pair < Rabs.size(); ++pair) {
+      localBlocks[pair].block(startRow, startCol, gA.nAOs(), gB.nAOs()) = shellBlocks[pair];
+    }
+  };
 
   if (pA.s) {
     if (pB.s) {
-      localBlock.block(0, 0, 1, 1) = block.getMatrixBlock(pA.s.value(), pB.s.value(), Rab);
+      fillShellPair(pA.s.value(), pB.s.value(), 0, 0);
     }
     if (pB.p) {
-      localBlock.block(0, 1, 1, 3) = block.getMatrixBlock(pA.s.value(), pB.p.value(), Rab);
+      fillShellPair(pA.s.value(), pB.p.value(), 0, 1);
     }
     if (pB.d) {
-      localBlock.block(0, 4, 1, 5) = block.getMatrixBlock(pA.s.value(), pB.d.value(), Rab);
+      fillShellPair(pA.s.value(), pB.d.value(), 0, 4);
     }
   }
   if (pA.p) {
     if (pB.s) {
-      localBlock.block(1, 0, 3, 1) = block.getMatrixBlock(pA.p.value(), pB.s.value(), Rab);
+      fillShellPair(pA.p.value(), pB.s.value(), 1, 0);
     }
     if (pB.p) {
-      localBlock.block(1, 1, 3, 3) = block.getMatrixBlock(pA.p.value(), pB.p.value(), Rab);
+      fillShellPair(pA.p.value(), pB.p.value(), 1, 1);
     }
     if (pB.d) {
-      localBlock.block(1, 4, 3, 5) = block.getMatrixBlock(pA.p.value(), pB.d.value(), Rab);
+      fillShellPair(pA.p.value(), pB.d.value(), 1, 4);
     }
   }
   if (pA.d) {
     if (pB.s) {
-      localBlock.block(4, 0, 5, 1) = block.getMatrixBlock(pA.d.value(), pB.s.value(), Rab);
+      fillShellPair(pA.d.value(), pB.s.value(), 4, 0);
     }
     if (pB.p) {
-      localBlock.block(4, 1, 5, 3) = block.getMatrixBlock(pA.d.value(), pB.p.value(), Rab);
+      fillShellPair(pA.d.value(), pB.p.value(), 4, 1);
     }
     if (pB.d) {
-      localBlock.block(4, 4, 5, 5) = block.getMatrixBlock(pA.d.value(), pB.d.value(), Rab);
+      fillShellPair(pA.d.value(), pB.d.value(), 4, 4);
     }
   }
 
-  return localBlock;
+  return localBlocks;
 }
 
 template<Utils::DerivativeOrder O>
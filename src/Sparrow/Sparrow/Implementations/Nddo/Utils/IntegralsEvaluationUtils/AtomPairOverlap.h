@@ -11,6 +11,7 @@
 #include "GTOOverlapMatrixBlock.h"
 #include <Utils/Math/DerivOrderEnum.h>
 #include <Eigen/Core>
+#include <vector>
 
 namespace Scine {
 
@@ -24,7 +25,7 @@ namespace nddo {
 
 /**
  * @brief This class computes a block of the overlap matrix for two atoms.
- * The actual calculation is done by the GTOOverlapMatrixBlock class, here the blocks that need calculation are
+ * The actual calculation is done by the BatchedGTOOverlapMatrixBlock class, here the blocks that need calculation are
  * identified and scheduled for calculation.
  */
 
@@ -35,6 +36,14 @@ class AtomPairOverlap {
 
   Eigen::Matrix<Value3D, Eigen::Dynamic, Eigen::Dynamic>
   getMatrixBlock(const Utils::AtomicGtos& pA, const Utils::AtomicGtos& pB, Eigen::Vector3d Rab) const;
+  /**
+   * @brief Calculates the blocks of several atom pairs of the same element pair at once.
+   * All primitive pairs of all the atom pairs are evaluated together for each shell pair.
+   * @param Rabs The vectors from atom A to atom B, one for each atom pair.
+   * @return The overlap blocks, in the same order as Rabs.
+   */
+  std::vector<Eigen::Matrix<Value3D, Eigen::Dynamic, Eigen::Dynamic>>
+  getMatrixBlocks(const Utils::AtomicGtos& pA, const Utils::AtomicGtos& pB, const std::vector<Eigen::Vector3d>& Rabs) const;
 
  private:
   Eigen::Matrix<Value3D, Eigen::Dynamic, Eigen::Dynamic> getInitialBlock(const Utils::AtomicGtos& pA,
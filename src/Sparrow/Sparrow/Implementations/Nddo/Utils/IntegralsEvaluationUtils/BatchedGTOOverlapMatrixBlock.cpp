@@ -0,0 +1,280 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "BatchedGTOOverlapMatrixBlock.h"
+#include "GeneralTypes.h"
+#include <Utils/DataStructures/GtoExpansion.h>
+#include <cmath>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace Utils::AutomaticDifferentiation;
+
+namespace nddo {
+using namespace GeneralTypes;
+
+template<Utils::DerivativeOrder O>
+BatchedGTOOverlapMatrixBlock<O>::BatchedGTOOverlapMatrixBlock() : sqrt3(std::sqrt(3)), pi(4.0 * std::atan(1)) {
+  momenta_[0] = AngularMomentum(0, 0, 0);
+  momenta_[1] = AngularMomentum(1, 0, 0);
+  momenta_[2] = AngularMomentum(0, 1, 0);
+  momenta_[3] = AngularMomentum(0, 0, 1);
+  momenta_[4] = AngularMomentum(1, 0, 1);
+  momenta_[5] = AngularMomentum(0, 1, 1);
+  momenta_[6] = AngularMomentum(1, 1, 0);
+  momenta_[7] = AngularMomentum(0, 0, 2); // z2
+  momenta_[8] = AngularMomentum(0, 2, 0); // y2
+  momenta_[9] = AngularMomentum(2, 0, 0); // x2
+
+  AOIndexes_[0] = static_cast<int>(orb_t::s);
+  AOIndexes_[1] = static_cast<int>(orb_t::x) - 1;
+  AOIndexes_[2] = static_cast<int>(orb_t::y) - 1;
+  AOIndexes_[3] = static_cast<int>(orb_t::z) - 1;
+  AOIndexes_[4] = static_cast<int>(orb_t::xz) - 4;
+  AOIndexes_[5] = static_cast<int>(orb_t::yz) - 4;
+  AOIndexes_[6] = static_cast<int>(orb_t::xy) - 4;
+  AOIndexes_[7] = static_cast<int>(orb_t::z2) - 4;
+  AOIndexes_[8] = static_cast<int>(orb_t::x2y2) - 4;
+  AOIndexes_[9] = 0;
+}
+
+template<Utils::DerivativeOrder O>
+typename BatchedGTOOverlapMatrixBlock<O>::Block
+BatchedGTOOverlapMatrixBlock<O>::getMatrixBlock(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB,
+                                                const Eigen::Vector3d& Rab) {
+  return getMatrixBlocks(gA, gB, {Rab}).front();
+}
+
+template<Utils::DerivativeOrder O>
+std::vector<typename BatchedGTOOverlapMatrixBlock<O>::Block>
+BatchedGTOOverlapMatrixBlock<O>::getMatrixBlocks(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB,
+                                                 const std::vector<Eigen::Vector3d>& Rabs) {
+  startGTFA_ = (gA.nAOs() == 1) ? 0 : (gA.nAOs() == 3) ? 1 : 4;
+  startGTFB_ = (gB.nAOs() == 1) ? 0 : (gB.nAOs() == 3) ? 1 : 4;
+  nGTFsA_ = (gA.nAOs() == 5) ? 6 : gA.nAOs();
+  nGTFsB_ = (gB.nAOs() == 5) ? 6 : gB.nAOs();
+  const auto nPairs = static_cast<int>(Rabs.size());
+
+  setLanes(gA, gB, Rabs);
+  calculateOneDimensionalIntegrals(gA.angularMomentum, gB.angularMomentum);
+
+  std::vector<Block> cartesianBlocks(nPairs, Block(nGTFsA_, nGTFsB_));
+  for (int k = 0; k < nGTFsA_; k++) {   // Loop over AOs of orbitals on A
+    for (int l = 0; l < nGTFsB_; l++) { // Loop over AOs of orbitals on B
+      calculateLaneContributions(momenta_[k + startGTFA_], momenta_[l + startGTFB_]);
+      // Sum up the primitive pairs belonging to the same atom pair
+      for (int pair = 0; pair < nPairs; ++pair) {
+        Eigen::Matrix<double, 1, nComponents> components =
+            laneContributions_.middleRows(pair * nPrimitivePairs_, nPrimitivePairs_).colwise().sum().matrix();
+        cartesianBlocks[pair](k, l) = assembleValue(components);
+      }
+    }
+  }
+
+  if (nGTFsA_ != 6 && nGTFsB_ != 6)
+    return cartesianBlocks;
+
+  std::vector<Block> blocks;
+  blocks.reserve(nPairs);
+  for (const auto& cartesianBlock : cartesianBlocks)
+    blocks.push_back(toSolidHarmonics(cartesianBlock, gA.nAOs(), gB.nAOs()));
+  return blocks;
+}
+
+template<Utils::DerivativeOrder O>
+void BatchedGTOOverlapMatrixBlock<O>::setLanes(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB,
+                                               const std::vector<Eigen::Vector3d>& Rabs) {
+  const auto nGtfA = static_cast<int>(gA.gtfs.size());
+  const auto nGtfB = static_cast<int>(gB.gtfs.size());
+  const auto nPairs = static_cast<int>(Rabs.size());
+  nPrimitivePairs_ = nGtfA * nGtfB;
+  nLanes_ = nPrimitivePairs_ * nPairs;
+
+  Eigen::ArrayXd expSum(nPrimitivePairs_), factorA(nPrimitivePairs_), factorB(nPrimitivePairs_),
+      coefficients(nPrimitivePairs_);
+  for (int a = 0; a < nGtfA; ++a) {
+    for (int b = 0; b < nGtfB; ++b) {
+      const int index = a * nGtfB + b;
+      const double expA = gA.gtfs[a].exponent;
+      const double expB = gB.gtfs[b].exponent;
+      expSum[index] = expA + expB;
+      factorA[index] = expA / expSum[index];
+      factorB[index] = expB / expSum[index];
+      coefficients[index] = gA.gtfs[a].normalizedCoefficient * gB.gtfs[b].normalizedCoefficient;
+    }
+  }
+
+  factorA_ = factorA.replicate(nPairs, 1);
+  factorB_ = factorB.replicate(nPairs, 1);
+  halfInverseExpSum_ = (0.5 / expSum).replicate(nPairs, 1);
+  exponentFactor_ = -factorB_ * factorA_ * expSum.replicate(nPairs, 1);
+  for (int d = 0; d < 3; ++d) {
+    distance_[d].resize(nLanes_);
+    for (int pair = 0; pair < nPairs; ++pair)
+      distance_[d].segment(pair * nPrimitivePairs_, nPrimitivePairs_).setConstant(Rabs[pair][d]);
+    // Derivative of the exponent with respect to the distance in direction d.
+    kBase_[d] = 2 * distance_[d] * exponentFactor_;
+  }
+  const Eigen::ArrayXd squaredDistance = distance_[0].square() + distance_[1].square() + distance_[2].square();
+  prefactor_ = (exponentFactor_ * squaredDistance).exp() * coefficients.replicate(nPairs, 1);
+
+  const Eigen::ArrayXd initialOverlap = (pi / expSum).sqrt().replicate(nPairs, 1);
+  for (int d = 0; d < 3; ++d) {
+    s0_[d][0][0] = initialOverlap;
+    if (O != Utils::DerivativeOrder::Zero)
+      s1_[d][0][0].setZero(nLanes_);
+    if (O == Utils::DerivativeOrder::Two)
+      s2_[d][0][0].setZero(nLanes_);
+  }
+}
+
+template<Utils::DerivativeOrder O>
+void BatchedGTOOverlapMatrixBlock<O>::calculateOneDimensionalIntegrals(int angularMomentumA, int angularMomentumB) {
+  // Same Obara-Saika relations as in GTOOverlapMatrixBlock, for the values and the derivatives with respect
+  // to the distance, with X_PA = factorB * x and X_PB = -factorA * x:
+  // S_i,j = X_PA * S_i-1,j + 1/(2expSum) * ((i-1)*S_i-2,j + j*S_i-1,j-1)
+  // S_i,j = X_PB * S_i,j-1 + 1/(2expSum) * (i*S_i-1,j-1 + (j-1)*S_i,j-2)
+  for (int d = 0; d < 3; d++) {
+    const Eigen::ArrayXd PA = distance_[d] * factorB_;
+    const Eigen::ArrayXd PB = -distance_[d] * factorA_;
+    for (int k = 0; k <= angularMomentumA; k++) {
+      for (int l = 0; l <= angularMomentumB; l++) {
+        if (k == 0 && l == 0)
+          continue;
+        auto& s0 = s0_[d];
+        auto& s1 = s1_[d];
+        auto& s2 = s2_[d];
+        if (l == 0) { // use first formula
+          s0[k][0] = PA * s0[k - 1][0];
+          if (O != Utils::DerivativeOrder::Zero)
+            s1[k][0] = factorB_ * s0[k - 1][0] + PA * s1[k - 1][0];
+          if (O == Utils::DerivativeOrder::Two)
+            s2[k][0] = 2 * factorB_ * s1[k - 1][0] + PA * s2[k - 1][0];
+          if (k > 1) {
+            s0[k][0] += (k - 1.0) * halfInverseExpSum_ * s0[k - 2][0];
+            if (O != Utils::DerivativeOrder::Zero)
+              s1[k][0] += (k - 1.0) * halfInverseExpSum_ * s1[k - 2][0];
+            if (O == Utils::DerivativeOrder::Two)
+              s2[k][0] += (k - 1.0) * halfInverseExpSum_ * s2[k - 2][0];
+          }
+        }
+        else { // i.e. l>0, use second formula
+          s0[k][l] = PB * s0[k][l - 1];
+          if (O != Utils::DerivativeOrder::Zero)
+            s1[k][l] = PB * s1[k][l - 1] - factorA_ * s0[k][l - 1];
+          if (O == Utils::DerivativeOrder::Two)
+            s2[k][l] = PB * s2[k][l - 1] - 2 * factorA_ * s1[k][l - 1];
+          if (k > 0) {
+            s0[k][l] += k * halfInverseExpSum_ * s0[k - 1][l - 1];
+            if (O != Utils::DerivativeOrder::Zero)
+              s1[k][l] += k * halfInverseExpSum_ * s1[k - 1][l - 1];
+            if (O == Utils::DerivativeOrder::Two)
+              s2[k][l] += k * halfInverseExpSum_ * s2[k - 1][l - 1];
+          }
+          if (l > 1) {
+            s0[k][l] += (l - 1.0) * halfInverseExpSum_ * s0[k][l - 2];
+            if (O != Utils::DerivativeOrder::Zero)
+              s1[k][l] += (l - 1.0) * halfInverseExpSum_ * s1[k][l - 2];
+            if (O == Utils::DerivativeOrder::Two)
+              s2[k][l] += (l - 1.0) * halfInverseExpSum_ * s2[k][l - 2];
+          }
+        }
+      } // End loop l
+    }   // End loop k
+  }     // End loop d
+}
+
+template<Utils::DerivativeOrder O>
+void BatchedGTOOverlapMatrixBlock<O>::calculateLaneContributions(const AngularMomentum& mA, const AngularMomentum& mB) {
+  const auto& X = s0_[0][mA.x][mB.x];
+  const auto& Y = s0_[1][mA.y][mB.y];
+  const auto& Z = s0_[2][mA.z][mB.z];
+  laneContributions_.resize(nLanes_, nComponents);
+  const Eigen::ArrayXd product = X * Y * Z;
+  laneContributions_.col(0) = prefactor_ * product;
+  if (O == Utils::DerivativeOrder::Zero)
+    return;
+
+  // Product rule: d(K*XYZ)/dx = K * (kx * XYZ + X'YZ), with kx = dK/dx / K.
+  const auto& dX = s1_[0][mA.x][mB.x];
+  const auto& dY = s1_[1][mA.y][mB.y];
+  const auto& dZ = s1_[2][mA.z][mB.z];
+  const Eigen::ArrayXd dXYZ = dX * Y * Z;
+  const Eigen::ArrayXd XdYZ = X * dY * Z;
+  const Eigen::ArrayXd XYdZ = X * Y * dZ;
+  laneContributions_.col(1) = prefactor_ * (kBase_[0] * product + dXYZ);
+  laneContributions_.col(2) = prefactor_ * (kBase_[1] * product + XdYZ);
+  laneContributions_.col(3) = prefactor_ * (kBase_[2] * product + XYdZ);
+  if (O == Utils::DerivativeOrder::One)
+    return;
+
+  // d2(K*XYZ)/dx2 = K * ((kx^2 + 2*fac) * XYZ + 2 * kx * X'YZ + X''YZ)
+  // d2(K*XYZ)/dxdy = K * (kx * ky * XYZ + kx * XY'Z + ky * X'YZ + X'Y'Z)
+  const auto& kx = kBase_[0];
+  const auto& ky = kBase_[1];
+  const auto& kz = kBase_[2];
+  laneContributions_.col(4) = prefactor_ * ((kx.square() + 2 * exponentFactor_) * product + 2 * kx * dXYZ +
+                                            s2_[0][mA.x][mB.x] * Y * Z);
+  laneContributions_.col(5) = prefactor_ * ((ky.square() + 2 * exponentFactor_) * product + 2 * ky * XdYZ +
+                                            X * s2_[1][mA.y][mB.y] * Z);
+  laneContributions_.col(6) = prefactor_ * ((kz.square() + 2 * exponentFactor_) * product + 2 * kz * XYdZ +
+                                            X * Y * s2_[2][mA.z][mB.z]);
+  laneContributions_.col(7) = prefactor_ * (kx * ky * product + kx * XdYZ + ky * dXYZ + dX * dY * Z);
+  laneContributions_.col(8) = prefactor_ * (kx * kz * product + kx * XYdZ + kz * dXYZ + dX * Y * dZ);
+  laneContributions_.col(9) = prefactor_ * (ky * kz * product + ky * XYdZ + kz * XdYZ + X * dY * dZ);
+}
+
+template<>
+inline BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Zero>::Value3D
+BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Zero>::assembleValue(const Eigen::Matrix<double, 1, nComponents>& c) {
+  return c[0];
+}
+template<>
+inline BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::One>::Value3D
+BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::One>::assembleValue(const Eigen::Matrix<double, 1, nComponents>& c) {
+  return {c[0], c[1], c[2], c[3]};
+}
+template<>
+inline BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Two>::Value3D
+BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Two>::assembleValue(const Eigen::Matrix<double, 1, nComponents>& c) {
+  return {c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8], c[9]};
+}
+
+template<Utils::DerivativeOrder O>
+typename BatchedGTOOverlapMatrixBlock<O>::Block
+BatchedGTOOverlapMatrixBlock<O>::toSolidHarmonics(const Block& cartesianBlock, int nAOsA, int nAOsB) const {
+  // go from 6 d-type GTFs back to 5 d-type atomic orbitals:
+  // dz2 = 1/2*(gzz-gxx-gyy)
+  // dx2y2 = sqrt(3/4)*(gxx-gyy)
+  Block result = cartesianBlock;
+  if (nGTFsA_ == 6) {
+    for (int l = 0; l < nGTFsB_; l++) {
+      result(3, l) = (result(3, l) - 0.5 * result(4, l) - 0.5 * result(5, l)) / sqrt3;
+      result(4, l) = 0.5 * (result(5, l) - result(4, l));
+    }
+  }
+  if (nGTFsB_ == 6) {
+    for (int k = 0; k < nGTFsA_; k++) {
+      result(k, 3) = (result(k, 3) - 0.5 * result(k, 4) - 0.5 * result(k, 5)) / sqrt3;
+      result(k, 4) = 0.5 * (result(k, 5) - result(k, 4));
+    }
+  }
+  Block solidHarmonicsResult(nAOsA, nAOsB);
+  for (int l = 0; l < nAOsB; ++l)
+    for (int k = 0; k < nAOsA; ++k)
+      solidHarmonicsResult(AOIndexes_[startGTFA_ + k], AOIndexes_[startGTFB_ + l]) = result(k, l);
+  return solidHarmonicsResult;
+}
+
+template class BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Zero>;
+template class BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::One>;
+template class BatchedGTOOverlapMatrixBlock<Utils::DerivativeOrder::Two>;
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
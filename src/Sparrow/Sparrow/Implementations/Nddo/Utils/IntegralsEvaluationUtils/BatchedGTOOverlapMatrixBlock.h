@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_BATCHEDGTOOVERLAPMATRIXBLOCK_H
+#define SPARROW_BATCHEDGTOOVERLAPMATRIXBLOCK_H
+
+#include "GTOOverlapMatrixBlock.h"
+#include <Utils/Math/AutomaticDifferentiation/AutomaticDifferentiationHelpers.h>
+#include <Eigen/Core>
+#include <array>
+#include <vector>
+
+namespace Scine {
+
+namespace Utils {
+class GtoExpansion;
+} // namespace Utils
+
+namespace Sparrow {
+
+namespace nddo {
+
+/**
+ * @brief Batched version of GTOOverlapMatrixBlock.
+ *
+ * All primitive pairs of a shell pair, for one or several atom pairs sharing the same shells (i.e. the same element
+ * pair), are laid out as lanes of Eigen arrays. The Obara-Saika recursion and the derivatives with respect to the
+ * atom-pair separation are then evaluated as array expressions over all lanes at once, which lets Eigen vectorize
+ * them, and the lanes belonging to the same atom pair are finally summed up.
+ * The resulting blocks are identical to the ones of GTOOverlapMatrixBlock.
+ * An instance keeps its work arrays between calls and must therefore not be shared between threads.
+ */
+template<Utils::DerivativeOrder O>
+class BatchedGTOOverlapMatrixBlock {
+ public:
+  using Value3D = Utils::AutomaticDifferentiation::Value3DType<O>;
+  using Block = Eigen::Matrix<Value3D, Eigen::Dynamic, Eigen::Dynamic>;
+  //! @brief Constructor initializing the angular momenta and indices of the orbitals used for the calculation.
+  BatchedGTOOverlapMatrixBlock();
+  /**
+   * @brief Calculates the overlap blocks of the shells gA and gB for several atom pairs at once.
+   * @param Rabs The vectors from atom A to atom B, one for each atom pair.
+   * @return The overlap blocks, in the same order as Rabs.
+   */
+  std::vector<Block> getMatrixBlocks(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB,
+                                     const std::vector<Eigen::Vector3d>& Rabs);
+  //! @brief Getter for the matrix block of a single atom pair.
+  Block getMatrixBlock(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB, const Eigen::Vector3d& Rab);
+
+ private:
+  static constexpr int nComponents = (O == Utils::DerivativeOrder::Zero) ? 1 : (O == Utils::DerivativeOrder::One) ? 4 : 10;
+  void setLanes(const Utils::GtoExpansion& gA, const Utils::GtoExpansion& gB, const std::vector<Eigen::Vector3d>& Rabs);
+  void calculateOneDimensionalIntegrals(int angularMomentumA, int angularMomentumB);
+  void calculateLaneContributions(const AngularMomentum& mA, const AngularMomentum& mB);
+  static Value3D assembleValue(const Eigen::Matrix<double, 1, nComponents>& components);
+  Block toSolidHarmonics(const Block& cartesianBlock, int nAOsA, int nAOsB) const;
+
+  const double sqrt3, pi;
+
+  int nLanes_ = 0;
+  int nPrimitivePairs_ = 0;
+  int startGTFA_, startGTFB_;
+  int nGTFsA_, nGTFsB_;
+  AngularMomentum momenta_[10];
+  int AOIndexes_[10];
+  // Per lane quantities
+  Eigen::ArrayXd factorA_, factorB_, halfInverseExpSum_, exponentFactor_, prefactor_;
+  std::array<Eigen::ArrayXd, 3> distance_, kBase_;
+  // One-dimensional overlaps and their first and second derivatives, [direction][lA][lB]
+  std::array<std::array<std::array<Eigen::ArrayXd, 3>, 3>, 3> s0_, s1_, s2_;
+  Eigen::Array<double, Eigen::Dynamic, nComponents> laneContributions_;
+};
+
+} // namespace nddo
+
+} // namespace Sparrow
+} // namespace Scine
+#endif // SPARROW_BATCHEDGTOOVERLAPMATRIXBLOCK_H
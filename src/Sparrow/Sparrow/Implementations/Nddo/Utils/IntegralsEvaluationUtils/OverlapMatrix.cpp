@@ -7,8 +7,11 @@
 
 #include "OverlapMatrix.h"
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
 #include <Utils/Math/AutomaticDifferentiation/AutomaticDifferentiationHelpers.h>
+#include <algorithm>
+#include <map>
 
 namespace Scine {
 namespace Sparrow {
@@ -27,6 +30,22 @@ void OverlapMatrix::reset() {
     nAOs_ += elementParameters_.get(e).nAOs();
 
   S_.setBaseMatrix(Eigen::MatrixXd::Identity(nAOs_, nAOs_));
+
+  // Atom pairs of the same element pair share their basis functions and can be evaluated together.
+  std::map<std::pair<Utils::ElementType, Utils::ElementType>, std::vector<std::pair<int, int>>> pairsPerElementPair;
+  for (int i = 1; i < nAtoms_; ++i) {
+    for (int j = 0; j < i; ++j) {
+      pairsPerElementPair[{elementTypes_[i], elementTypes_[j]}].emplace_back(i, j);
+    }
+  }
+  atomPairBatches_.clear();
+  for (const auto& elementPair : pairsPerElementPair) {
+    const auto& pairs = elementPair.second;
+    for (std::size_t first = 0; first < pairs.size(); first += atomPairBatchSize_) {
+      auto last = std::min(pairs.size(), first + atomPairBatchSize_);
+      atomPairBatches_.emplace_back(pairs.begin() + first, pairs.begin() + last);
+    }
+  }
 }
 
 void OverlapMatrix::calculateOverlap(Utils::DerivativeOrder highestRequiredOrder) {
@@ -34,31 +53,40 @@ void OverlapMatrix::calculateOverlap(Utils::DerivativeOrder highestRequiredOrder
   S_.setOrder(highestRequiredOrder);
   if (nAOs_ == 0)
     return;
+  if (order == 0) {
+    fillOverlap(pairOverlapZeroOrder_);
+  }
+  else if (order == 1) {
+    fillOverlap(pairOverlapFirstOrder_);
+  }
+  else if (order == 2) {
+    fillOverlap(pairOverlapSecondOrder_);
+  }
+}
+
+template<Utils::DerivativeOrder O>
+void OverlapMatrix::fillOverlap(const AtomPairOverlap<O>& pairOverlap) {
+  const auto nBatches = static_cast<int>(atomPairBatches_.size());
+  const bool periodic = periodicCell_ && periodicCell_->isPeriodic();
 #pragma omp parallel for schedule(dynamic)
-  for (int i = 1; i < nAtoms_; ++i) {
-    auto rowIndex = aoIndexes_.getFirstOrbitalIndex(i);
-    const auto& pA = elementParameters_.get(elementTypes_[i]);
-    for (int j = 0; j < i; ++j) {
-      auto colIndex = aoIndexes_.getFirstOrbitalIndex(j);
-      const auto& pB = elementParameters_.get(elementTypes_[j]);
-      const auto& GTOsA = pA.GTOs();
-      const auto& GTOsB = pB.GTOs();
+  for (int batch = 0; batch < nBatches; ++batch) {
+    const auto& atomPairs = atomPairBatches_[batch];
+    const auto& pA = elementParameters_.get(elementTypes_[atomPairs.front().first]);
+    const auto& pB = elementParameters_.get(elementTypes_[atomPairs.front().second]);
 
-      const auto& Ri = positions_.row(i);
-      const auto& Rj = positions_.row(j);
-      Eigen::RowVector3d Rij = Rj - Ri;
-      if (order == 0) {
-        auto resultBlock = pairOverlapZeroOrder_.getMatrixBlock(GTOsA, GTOsB, Rij);
-        S_.get<Utils::DerivativeOrder::Zero>().block(rowIndex, colIndex, resultBlock.rows(), resultBlock.cols()) = resultBlock;
-      }
-      else if (order == 1) {
-        auto resultBlock = pairOverlapFirstOrder_.getMatrixBlock(GTOsA, GTOsB, Rij);
-        S_.get<Utils::DerivativeOrder::One>().block(rowIndex, colIndex, resultBlock.rows(), resultBlock.cols()) = resultBlock;
-      }
-      else if (order == 2) {
-        auto resultBlock = pairOverlapSecondOrder_.getMatrixBlock(GTOsA, GTOsB, Rij);
-        S_.get<Utils::DerivativeOrder::Two>().block(rowIndex, colIndex, resultBlock.rows(), resultBlock.cols()) = resultBlock;
-      }
+    std::vector<Eigen::Vector3d> Rabs;
+    Rabs.reserve(atomPairs.size());
+    for (const auto& atomPair : atomPairs) {
+      Eigen::Vector3d Rij = (positions_.row(atomPair.second) - positions_.row(atomPair.first)).transpose();
+      Rabs.emplace_back(periodic ? periodicCell_->getMinimumImage(Rij) : Rij);
+    }
+
+    auto resultBlocks = pairOverlap.getMatrixBlocks(pA.GTOs(), pB.GTOs(), Rabs);
+    for (std::size_t pair = 0; pair < atomPairs.size(); ++pair) {
+      auto rowIndex = aoIndexes_.getFirstOrbitalIndex(atomPairs[pair].first);
+      auto colIndex = aoIndexes_.getFirstOrbitalIndex(atomPairs[pair].second);
+      const auto& resultBlock = resultBlocks[pair];
+      S_.get<O>().block(rowIndex, colIndex, resultBlock.rows(), resultBlock.cols()) = resultBlock;
     }
   }
 }
@@ -67,6 +95,10 @@ const Utils::MatrixWithDerivatives& OverlapMatrix::getOverlap() const {
   return S_;
 }
 
+void OverlapMatrix::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
 } // namespace nddo
 } // namespace Sparrow
 } // namespace Scine
@@ -12,6 +12,9 @@
 #include <Utils/DataStructures/MatrixWithDerivatives.h>
 #include <Utils/Scf/MethodInterfaces/OverlapCalculator.h>
 #include <Utils/Typenames.h>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace Scine {
 
@@ -20,6 +23,8 @@ class AtomsOrbitalsIndexes;
 } // namespace Utils
 
 namespace Sparrow {
+class PeriodicCell;
+
 namespace nddo {
 class ElementParameters;
 
@@ -41,18 +46,31 @@ class OverlapMatrix : public Utils::OverlapCalculator {
   const Utils::MatrixWithDerivatives& getOverlap() const override;
   //! @brief (Re)-initializes the overlap matrix with its derivatives.
   void reset() override;
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * The overlap of two atoms is then the one with the periodic image of the second atom closest to the first one, as
+   * for the other integrals, see TwoCenterIntegralContainer::getPairVector().
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
 
  private:
+  // Number of atom pairs of the same element pair evaluated together by AtomPairOverlap::getMatrixBlocks.
+  static constexpr int atomPairBatchSize_ = 8;
+  template<Utils::DerivativeOrder O>
+  void fillOverlap(const AtomPairOverlap<O>& pairOverlap);
   Utils::MatrixWithDerivatives S_;
   const Utils::ElementTypeCollection& elementTypes_;
   const Utils::PositionCollection& positions_;
   const Utils::AtomsOrbitalsIndexes& aoIndexes_;
   const ElementParameters& elementParameters_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
   AtomPairOverlap<Utils::DerivativeOrder::One> pairOverlapFirstOrder_;
   AtomPairOverlap<Utils::DerivativeOrder::Zero> pairOverlapZeroOrder_;
   AtomPairOverlap<Utils::DerivativeOrder::Two> pairOverlapSecondOrder_;
   int nAOs_ = 0;
   int nAtoms_ = 0;
+  // Atom pairs (i > j) grouped by element pair and split into batches of at most atomPairBatchSize_ pairs.
+  std::vector<std::vector<std::pair<int, int>>> atomPairBatches_;
 };
 
 } // namespace nddo
@@ -8,6 +8,7 @@
 #include "TwoCenterIntegralContainer.h"
 #include "Global2c2eMatrix.h"
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/Math/DerivOrderEnum.h>
 
 namespace Scine {
@@ -59,9 +60,7 @@ void TwoCenterIntegralContainer::update(Utils::DerivativeOrder order) {
 }
 
 void TwoCenterIntegralContainer::updatePair(unsigned int i, unsigned int j, Utils::DerivativeOrder order) {
-  Eigen::RowVector3d pA = positions_.row(i);
-  Eigen::RowVector3d pB = positions_.row(j);
-  Eigen::RowVector3d Rab = pB - pA;
+  Eigen::Vector3d Rab = getPairVector(i, j);
 
   if (order == Utils::DerivativeOrder::Zero) {
     matrices_[i][j]->calculate<Utils::DerivativeOrder::Zero>(Rab);
@@ -72,7 +71,23 @@ void TwoCenterIntegralContainer::updatePair(unsigned int i, unsigned int j, Util
   else if (order == Utils::DerivativeOrder::Two) {
     matrices_[i][j]->calculate<Utils::DerivativeOrder::Two>(Rab);
   }
-} // namespace nddo
+}
+
+void TwoCenterIntegralContainer::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
+bool TwoCenterIntegralContainer::isPeriodic() const {
+  return periodicCell_ && periodicCell_->isPeriodic();
+}
+
+Eigen::Vector3d TwoCenterIntegralContainer::getPairVector(unsigned int a, unsigned int b) const {
+  Eigen::Vector3d Rab = (positions_.row(b) - positions_.row(a)).transpose();
+  if (isPeriodic()) {
+    return periodicCell_->getMinimumImage(Rab);
+  }
+  return Rab;
+}
 
 } // namespace nddo
 } // namespace Sparrow
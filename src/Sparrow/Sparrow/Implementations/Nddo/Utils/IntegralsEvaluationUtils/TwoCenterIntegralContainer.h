@@ -10,6 +10,7 @@
 
 #include "Global2c2eTerms.h"
 #include <Utils/Typenames.h>
+#include <Eigen/Core>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -17,6 +18,7 @@
 namespace Scine {
 
 namespace Sparrow {
+class PeriodicCell;
 
 namespace nddo {
 class ElementParameters;
@@ -29,6 +31,9 @@ class Global2c2eMatrix;
  *
  * This class stores for each atom pair a shared pointer to a Global2c2eMatrix, containing the ERIs between the
  * two centers.
+ * With periodic boundaries, the integrals of a pair are evaluated for the periodic image of the second atom closest
+ * to the first one (minimum-image or cyclic-cluster convention), and getPairVector() gives the corresponding distance
+ * vector to the other classes evaluating pair terms from these integrals.
  */
 class TwoCenterIntegralContainer {
  public:
@@ -75,6 +80,19 @@ class TwoCenterIntegralContainer {
     return matrices_[a][b];
   }
 
+  /**
+   * @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+   * The interaction of an atom with the other periodic images of atoms and with its own images is not part of the
+   * integrals, see LongRangeElectrostatics.
+   */
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  bool isPeriodic() const;
+  /**
+   * @brief Vector from atom a to the periodic image of atom b closest to it, R_b - R_a without periodic boundaries.
+   * This is the distance vector at which the integrals of the atom pair are evaluated.
+   */
+  Eigen::Vector3d getPairVector(unsigned int a, unsigned int b) const;
+
  private:
   // Initializes the matrix corresponding to a given atom pair.
   void initializePair(unsigned int i, unsigned int j);
@@ -87,6 +105,7 @@ class TwoCenterIntegralContainer {
   unsigned int nAtoms_;
   const Utils::ElementTypeCollection& elementTypes_;
   const Utils::PositionCollection& positions_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
 };
 
 } // namespace nddo
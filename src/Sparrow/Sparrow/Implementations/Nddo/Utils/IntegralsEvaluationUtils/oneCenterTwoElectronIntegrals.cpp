@@ -60,7 +60,10 @@ void OneCenterTwoElectronIntegrals::calculateIntegralsFromExponents() {
 }
 
 void OneCenterTwoElectronIntegrals::set(orb_index_t a, orb_index_t b, orb_index_t c, orb_index_t d, double value) {
-  int index = OneCenterTwoElectronCalculator::getIndex(a, b, c, d);
+  set(OneCenterTwoElectronCalculator::getIndex(a, b, c, d), value);
+}
+
+void OneCenterTwoElectronIntegrals::set(int index, double value) {
   integrals_[index] = value;
   alreadyGiven_[index] = true;
 }
@@ -38,6 +38,7 @@ class OneCenterTwoElectronIntegrals {
   int getNumberIntegrals() const;
 
   void set(orb_index_t a, orb_index_t b, orb_index_t c, orb_index_t d, double value);
+  void set(int index, double value);
   double get(orb_index_t a, orb_index_t b, orb_index_t c, orb_index_t d) const;
   double get(int index) const;
   const Eigen::MatrixXd getIntegralMatrix();
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "LongRangeElectrostatics.h"
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
+#include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
+#include <cmath>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace Utils::AutomaticDifferentiation;
+
+namespace nddo {
+
+LongRangeElectrostatics::LongRangeElectrostatics(const Utils::ElementTypeCollection& elements,
+                                                 const Utils::PositionCollection& positions,
+                                                 const Eigen::MatrixXd& densityMatrix,
+                                                 const ElementParameters& elementParameters,
+                                                 const Utils::AtomsOrbitalsIndexes& aoIndexes)
+  : elements_(elements),
+    positions_(positions),
+    P_(densityMatrix),
+    elementParameters_(elementParameters),
+    aoIndexes_(aoIndexes) {
+}
+
+void LongRangeElectrostatics::setPeriodicCell(std::shared_ptr<PeriodicCell> cell) {
+  periodicCell_ = std::move(cell);
+}
+
+bool LongRangeElectrostatics::isPeriodic() const {
+  return periodicCell_ && periodicCell_->isPeriodic();
+}
+
+void LongRangeElectrostatics::calculateInteractions() {
+  const int nAtoms = elements_.size();
+  ewald_.setCell(*periodicCell_, positions_);
+  interactions_.resize(nAtoms, nAtoms);
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < nAtoms; ++a) {
+    interactions_(a, a) = ewald_.getPotential(Eigen::Vector3d::Zero());
+    for (int b = a + 1; b < nAtoms; ++b) {
+      Eigen::Vector3d Rab = (positions_.row(b) - positions_.row(a)).transpose();
+      double interaction = ewald_.getPotential(Rab) - 1.0 / periodicCell_->getMinimumImage(Rab).norm();
+      interactions_(a, b) = interaction;
+      interactions_(b, a) = interaction;
+    }
+  }
+}
+
+void LongRangeElectrostatics::calculate() {
+  const int nAtoms = elements_.size();
+  charges_.resize(nAtoms);
+  for (int a = 0; a < nAtoms; ++a) {
+    const int index = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOs = aoIndexes_.getNOrbitals(a);
+    charges_[a] = elementParameters_.get(elements_[a]).coreCharge() - P_.diagonal().segment(index, nAOs).sum();
+  }
+  potentials_ = interactions_ * charges_;
+  energy_ = 0.5 * charges_.dot(potentials_);
+}
+
+void LongRangeElectrostatics::addToFockMatrix(Eigen::MatrixXd& fock) const {
+  // The electronic population of an atom enters its net charge with a negative sign
+  for (int a = 0; a < static_cast<int>(elements_.size()); ++a) {
+    const int index = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOs = aoIndexes_.getNOrbitals(a);
+    fock.diagonal().segment(index, nAOs).array() -= potentials_[a];
+  }
+}
+
+double LongRangeElectrostatics::getEnergy() const {
+  return energy_;
+}
+
+void LongRangeElectrostatics::addDerivatives(Utils::GradientCollection& derivatives) const {
+  const int nAtoms = elements_.size();
+  strainDerivatives_.setZero();
+#pragma omp parallel
+  {
+    Utils::GradientCollection threadDerivatives = Utils::GradientCollection::Zero(derivatives.rows(), 3);
+    Eigen::Matrix3d threadStrainDerivatives = Eigen::Matrix3d::Zero();
+#pragma omp for schedule(dynamic) nowait
+    for (int a = 0; a < nAtoms; ++a) {
+      // The interaction of an atom with its own images only depends on the cell
+      threadStrainDerivatives +=
+          0.5 * charges_[a] * charges_[a] * ewald_.getPotentialStrainDerivative(Eigen::Vector3d::Zero());
+      for (int b = a + 1; b < nAtoms; ++b) {
+        const double chargeProduct = charges_[a] * charges_[b];
+        Eigen::Vector3d Rab = (positions_.row(b) - positions_.row(a)).transpose();
+        Eigen::Vector3d closest = periodicCell_->getMinimumImage(Rab);
+        Eigen::Vector3d closestGradient = closest / std::pow(closest.norm(), 3);
+        Eigen::Vector3d gradient = chargeProduct * (ewald_.getPotentialGradient(Rab) + closestGradient);
+        addDerivativeToContainer<Utils::Derivative::First>(threadDerivatives, a, b, gradient);
+        threadStrainDerivatives += chargeProduct * ewald_.getPotentialStrainDerivative(Rab);
+        threadStrainDerivatives += chargeProduct * closestGradient * closest.transpose();
+      }
+    }
+#pragma omp critical(addDerivativesLongRangeElectrostatics)
+    {
+      derivatives += threadDerivatives;
+      strainDerivatives_ += threadStrainDerivatives;
+    }
+  }
+}
+
+const Eigen::Matrix3d& LongRangeElectrostatics::getStrainDerivatives() const {
+  return strainDerivatives_;
+}
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
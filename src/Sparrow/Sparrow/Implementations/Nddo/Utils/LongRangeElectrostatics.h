@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_NDDO_LONGRANGEELECTROSTATICS_H
+#define SPARROW_NDDO_LONGRANGEELECTROSTATICS_H
+
+#include <Sparrow/Implementations/EwaldSummation.h>
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <memory>
+
+namespace Scine {
+
+namespace Utils {
+class AtomsOrbitalsIndexes;
+} // namespace Utils
+
+namespace Sparrow {
+class PeriodicCell;
+
+namespace nddo {
+class ElementParameters;
+
+/**
+ * @brief Long-range electrostatics of NDDO methods with periodic boundaries.
+ *
+ * With periodic boundaries, the NDDO integrals and the core repulsion of two atoms are evaluated for the periodic
+ * image of the second atom closest to the first one only (minimum-image or cyclic-cluster convention, see
+ * TwoCenterIntegralContainer::getPairVector()). Beyond this image, the interaction of two atoms reduces to the
+ * Coulomb interaction of their net charges q = Z - sum_mu P_mumu, which is summed over all other images here with an
+ * Ewald summation:
+ *   E = 1/2 sum_ab q_a q_b (phi(R_ab) - 1/|R_ab^min|),
+ * where phi is the lattice sum of 1/r and 1/|R_ab^min| the monopole part of the closest image already contained in
+ * the integrals. For a = b, the latter term is absent and the sum holds the interaction of an atom with its own images.
+ * The cell must be large enough for the NDDO integrals of the closest images to have reached their point-charge
+ * limit at half the cell size, otherwise the energy is discontinuous when the closest image of an atom changes.
+ */
+class LongRangeElectrostatics {
+ public:
+  //! @brief Constructor, densityMatrix is the restricted (total) density matrix.
+  LongRangeElectrostatics(const Utils::ElementTypeCollection& elements, const Utils::PositionCollection& positions,
+                          const Eigen::MatrixXd& densityMatrix, const ElementParameters& elementParameters,
+                          const Utils::AtomsOrbitalsIndexes& aoIndexes);
+
+  //! @brief Sets the periodic cell, nullptr or a non-periodic cell for none.
+  void setPeriodicCell(std::shared_ptr<PeriodicCell> cell);
+  bool isPeriodic() const;
+  //! @brief Calculates the long-range interaction of unit charges for all atom pairs, once per structure.
+  void calculateInteractions();
+  //! @brief Calculates the net atomic charges, the energy and the potential at the atoms from the density matrix.
+  void calculate();
+  //! @brief Adds the derivative of the energy with respect to the density matrix, -potential on the diagonal.
+  void addToFockMatrix(Eigen::MatrixXd& fock) const;
+  //! @brief Energy of the last call to calculate(), including the interaction of the cores.
+  double getEnergy() const;
+  //! @brief Adds the gradients and stores the strain derivatives, with the charges of the last call to calculate().
+  void addDerivatives(Utils::GradientCollection& derivatives) const;
+  //! @brief Derivative of the energy with respect to a homogeneous strain, from the last call to addDerivatives().
+  const Eigen::Matrix3d& getStrainDerivatives() const;
+
+ private:
+  const Utils::ElementTypeCollection& elements_;
+  const Utils::PositionCollection& positions_;
+  const Eigen::MatrixXd& P_;
+  const ElementParameters& elementParameters_;
+  const Utils::AtomsOrbitalsIndexes& aoIndexes_;
+  std::shared_ptr<PeriodicCell> periodicCell_;
+  EwaldSummation ewald_;
+  // Long-range interaction phi(R_ab) - 1/|R_ab^min| of unit charges on the atoms a and b
+  Eigen::MatrixXd interactions_;
+  Eigen::VectorXd charges_;
+  Eigen::VectorXd potentials_;
+  double energy_ = 0.0;
+  // Filled together with the first derivatives
+  mutable Eigen::Matrix3d strainDerivatives_ = Eigen::Matrix3d::Zero();
+};
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_NDDO_LONGRANGEELECTROSTATICS_H
@@ -9,6 +9,7 @@
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/AtomicParameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/PM6DiatomicParameters.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ProcessedParametersCache.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/RawParameterProcessor.h>
 #include <Utils/Geometry/ElementInfo.h>
 #include <Utils/Scf/MethodExceptions.h>
@@ -34,7 +35,8 @@ void NDDOInitializer::applyRawParameters(const Utils::ElementTypeCollection& ele
         throw Utils::Methods::ParametersDoNotExistForElementException(e);
       }
 
-      auto par = processor.processAtomicParameters(e);
+      auto par = ProcessedParametersCache::instance().getAtomicParameters(
+          e, basisFunctions_, rawParameters_.atomic.at(Utils::ElementInfo::Z(e)), processor);
       elementParameters_.set(e, std::move(par.first));
       oneCenterIntegrals_.set(e, std::move(par.second));
     }
@@ -51,7 +53,9 @@ void NDDOInitializer::applyRawParameters(const Utils::ElementTypeCollection& ele
             throw Utils::Methods::ParametersDoNotExistForElementPairException(e1, e2);
           }
 
-          elementPairParameters_.set(e1, e2, processor.runtimeDiatomicParameters(e1, e2));
+          elementPairParameters_.set(e1, e2,
+                                     ProcessedParametersCache::instance().getDiatomicParameters(
+                                         e1, e2, rawParameters_.diatomic.at(Parameters::key(e1, e2)), processor));
         }
       }
     }
@@ -66,6 +70,14 @@ void NDDOInitializer::saveParameters(const std::string& fileName) {
   rawParameters_.write(fileName);
 }
 
+void NDDOInitializer::readProcessedParameters(const std::string& fileName) {
+  ProcessedParametersCache::instance().read(fileName);
+}
+
+void NDDOInitializer::saveProcessedParameters(const std::string& fileName) {
+  ProcessedParametersCache::instance().write(fileName);
+}
+
 void NDDOInitializer::initialize(const Utils::ElementTypeCollection& elements) {
   applyRawParameters(elements);
   nElectronsForUnchargedSpecies_ = 0;
@@ -37,6 +37,8 @@ class NDDOInitializer : public Utils::StructureDependentInitializer {
   /**
    * @brief (Re)generate values and run-time parameters from the current raw parameters.
    *         Only needed if the parameters are modified manually.
+   *         Processed parameters are taken from the ProcessedParametersCache if they were already generated
+   *         from identical raw parameters.
    * @param elements a vector containing the elements constituting the molecule.
    * @param basisFunctions Whether the method just accomodate s and p basis functions (i.e. AM1, MNDO), or if it can
    *        also activate d basis functions.
@@ -47,6 +49,10 @@ class NDDOInitializer : public Utils::StructureDependentInitializer {
   void readParameters(const std::string& parameterPath);
   /*! Save the parameters to a file. */
   void saveParameters(const std::string& fileName);
+  /*! Load processed parameters into the process-wide ProcessedParametersCache, skipping their generation. */
+  static void readProcessedParameters(const std::string& fileName);
+  /*! Save the content of the process-wide ProcessedParametersCache to a file. */
+  static void saveProcessedParameters(const std::string& fileName);
   /*! Initialize the method <b>after</b> the parameters have been set or loaded. */
   void initialize(const Utils::ElementTypeCollection& elements) override;
 
@@ -10,9 +10,12 @@
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/VuvB.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/AtomicParameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Sparrow/Implementations/PointChargeEmbedding.h>
 #include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
 #include <Utils/DataStructures/MatrixWithDerivatives.h>
 #include <algorithm>
+#include <stdexcept>
 
 namespace Scine {
 namespace Sparrow {
@@ -42,6 +45,10 @@ void OneElectronMatrix::initialize() {
 
 void OneElectronMatrix::calculate(const Utils::MatrixWithDerivatives& S) {
   H_ = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
+  pointChargeCoreEnergy_ = 0.0;
+  if (pointCharges_) {
+    pointCharges_->updateNeighbors(positions_);
+  }
 #pragma omp parallel
   {
     calculateSameAtomBlocks();
@@ -55,6 +62,7 @@ void OneElectronMatrix::calculateSameAtomBlocks() {
     auto index = aoIndexes_.getFirstOrbitalIndex(i);
     auto nAOs = aoIndexes_.getNOrbitals(i);
     calculateSameAtomBlock(i, index, nAOs);
+    calculatePointChargeBlock(i, index, nAOs);
   }
 }
 
@@ -71,9 +79,7 @@ void OneElectronMatrix::calculateSameAtomBlock(int a, int startIndex, int nAOs)
     if (b != a) {
       const auto& pB = elementParameters.get(elementTypes_[b]);
       if (pB.pCoreSpecified()) {
-        auto posA = positions_.row(a);
-        auto posB = positions_.row(b);
-        Eigen::RowVector3d Rab = posB - posA;
+        Eigen::Vector3d Rab = twoCenterIntegrals.getPairVector(a, b);
 
         V_.calculate<Utils::DerivativeOrder::Zero>(Rab, ap.chargeSeparations(), ap.klopmanParameters(), pB.pCore(),
                                                    pB.coreCharge());
@@ -108,6 +114,51 @@ void OneElectronMatrix::calculateSameAtomBlock(int a, int startIndex, int nAOs)
   }
 }
 
+void OneElectronMatrix::calculatePointChargeBlock(int a, int startIndex, int nAOs) {
+  if (!pointCharges_ || pointCharges_->empty()) {
+    return;
+  }
+  const auto& ap = elementParameters.get(elementTypes_[a]);
+  const auto& chargePositions = pointCharges_->getPositions();
+  const auto& charges = pointCharges_->getCharges();
+
+  multipole::VuvB V_((nAOs == 1) ? 0 : (nAOs == 4) ? 1 : 2);
+  Eigen::MatrixXd block = Eigen::MatrixXd::Zero(nAOs, nAOs);
+  double coreEnergy = 0.0;
+  for (int m : pointCharges_->getNeighbors(a)) {
+    Eigen::RowVector3d Ram = chargePositions.row(m) - positions_.row(a);
+    double dSwitching;
+    const double switching = pointCharges_->getSwitching(Ram.norm(), dSwitching);
+    V_.calculate<Utils::DerivativeOrder::Zero>(Ram, ap.chargeSeparations(), ap.klopmanParameters(), 0.0, charges[m]);
+    for (int i = 0; i < nAOs; i++) {
+      for (int j = 0; j <= i; j++) {
+        block(i, j) += switching * V_.get(i, j);
+      }
+    }
+    coreEnergy -= switching * ap.coreCharge() * V_.get(0, 0);
+  }
+  for (int i = 0; i < nAOs; i++) {
+    for (int j = 0; j <= i; j++) {
+#pragma omp atomic
+      H_(startIndex + i, startIndex + j) += block(i, j);
+    }
+  }
+#pragma omp atomic
+  pointChargeCoreEnergy_ += coreEnergy;
+}
+
+void OneElectronMatrix::setPointChargeEmbedding(PointChargeEmbedding* embedding) {
+  pointCharges_ = embedding;
+}
+
+double OneElectronMatrix::getPointChargeCoreEnergy() const {
+  return pointChargeCoreEnergy_;
+}
+
+const Eigen::Matrix3d& OneElectronMatrix::getStrainDerivatives() const {
+  return strainDerivatives_;
+}
+
 void OneElectronMatrix::calculateDifferentAtomsBlocks(const Utils::MatrixWithDerivatives& S) {
 #pragma omp for schedule(static)
   for (int i = 1; i < nAtoms_; ++i) {
@@ -133,13 +184,84 @@ void OneElectronMatrix::calculateDifferentAtomsBlock(int startRow, int startCol,
   }
 }
 
+void OneElectronMatrix::addPointChargeDerivatives(DerivativeContainerType<Utils::Derivative::First>& derivatives) const {
+  const auto& chargePositions = pointCharges_->getPositions();
+  const auto& charges = pointCharges_->getCharges();
+  Utils::GradientCollection pointChargeGradients = Utils::GradientCollection::Zero(pointCharges_->size(), 3);
+#pragma omp parallel
+  {
+    Utils::GradientCollection threadGradients = Utils::GradientCollection::Zero(pointCharges_->size(), 3);
+#pragma omp for schedule(dynamic)
+    for (int a = 0; a < nAtoms_; ++a) {
+      const auto& ap = elementParameters.get(elementTypes_[a]);
+      auto startIndex = aoIndexes_.getFirstOrbitalIndex(a);
+      auto nAOs = aoIndexes_.getNOrbitals(a);
+      multipole::VuvB V_((nAOs == 1) ? 0 : (nAOs == 4) ? 1 : 2);
+      Eigen::Vector3d atomGradient = Eigen::Vector3d::Zero();
+      for (int m : pointCharges_->getNeighbors(a)) {
+        Eigen::RowVector3d Ram = chargePositions.row(m) - positions_.row(a);
+        const double R = Ram.norm();
+        double dSwitching;
+        const double switching = pointCharges_->getSwitching(R, dSwitching);
+        V_.calculate<Utils::DerivativeOrder::One>(Ram, ap.chargeSeparations(), ap.klopmanParameters(), 0.0, charges[m]);
+        // Interaction energy and its derivative with respect to Ram, of the core and of the electronic interaction
+        double interaction = -ap.coreCharge() * V_.get(0, 0);
+        Eigen::Vector3d d = -ap.coreCharge() * V_.getDerivative<Utils::Derivative::First>(0, 0);
+        for (int i = 0; i < nAOs; i++) {
+          for (int j = 0; j <= i; j++) {
+            const double weight = P(startIndex + i, startIndex + j) * (i == j ? 1 : 2);
+            interaction += V_.get(i, j) * weight;
+            d += V_.getDerivative<Utils::Derivative::First>(i, j) * weight;
+          }
+        }
+        // Switched interaction
+        d = switching * d + interaction * dSwitching / R * Ram.transpose();
+        atomGradient -= d;
+        threadGradients.row(m) += d.transpose();
+      }
+      derivatives.row(a) += atomGradient.transpose();
+    }
+#pragma omp critical(addPointChargeDerivativesOneElectronMatrix)
+    { pointChargeGradients += threadGradients; }
+  }
+  pointCharges_->setGradients(std::move(pointChargeGradients));
+}
+
+template<class DerivativeContainer>
+void OneElectronMatrix::addPointChargeDerivatives(DerivativeContainer& /*derivatives*/) const {
+  throw std::runtime_error("Only first derivatives are available with point charges.");
+}
+
 template<Utils::Derivative O>
 void OneElectronMatrix::addDerivatives(DerivativeContainerType<O>& derivativeContainer,
                                        const Utils::MatrixWithDerivatives& S) const {
+  strainDerivatives_.setZero();
+  addDensityDerivatives<O>(derivativeContainer, S, P);
+  if (pointCharges_ && !pointCharges_->empty()) {
+    addPointChargeDerivatives(derivativeContainer);
+  }
+}
+
+template<Utils::Derivative O>
+void OneElectronMatrix::addDerivatives(DerivativeContainerType<O>& derivativeContainer,
+                                       const Utils::MatrixWithDerivatives& S,
+                                       const Eigen::MatrixXd& densityMatrix) const {
+  if (pointCharges_ && !pointCharges_->empty()) {
+    throw std::runtime_error("Derivatives of response densities are not available with point charges.");
+  }
+  if (twoCenterIntegrals.isPeriodic()) {
+    throw std::runtime_error("Derivatives of response densities are not available with periodic boundaries.");
+  }
+  addDensityDerivatives<O>(derivativeContainer, S, densityMatrix);
+}
+
+template<Utils::Derivative O>
+void OneElectronMatrix::addDensityDerivatives(DerivativeContainerType<O>& derivativeContainer,
+                                              const Utils::MatrixWithDerivatives& S, const Eigen::MatrixXd& D) const {
   for (int i = 0; i < nAtoms_; ++i) {
     auto index = aoIndexes_.getFirstOrbitalIndex(i);
     auto nAOs = aoIndexes_.getNOrbitals(i);
-    addDerivativesContribution1<O>(derivativeContainer, i, index, nAOs);
+    addDerivativesContribution1<O>(derivativeContainer, i, index, nAOs, D);
   }
   for (int a = 1; a < nAtoms_; ++a) {
     for (int b = 0; b < a; b++) {
@@ -148,14 +270,14 @@ void OneElectronMatrix::addDerivatives(DerivativeContainerType<O>& derivativeCon
       auto indexB = aoIndexes_.getFirstOrbitalIndex(b);
       auto nAOsB = aoIndexes_.getNOrbitals(b);
 
-      addDerivativesContribution2<O>(derivativeContainer, a, b, indexA, indexB, nAOsA, nAOsB, S);
+      addDerivativesContribution2<O>(derivativeContainer, a, b, indexA, indexB, nAOsA, nAOsB, S, D);
     }
   }
 }
 
 template<Utils::Derivative O>
 void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>& derivativeContainer, int a,
-                                                    int startIndex, int nAOs) const {
+                                                    int startIndex, int nAOs, const Eigen::MatrixXd& D) const {
   const auto& ap = elementParameters.get(elementTypes_[a]);
 
   multipole::VuvB V_((nAOs == 1) ? 0 : (nAOs == 4) ? 1 : 2);
@@ -166,14 +288,11 @@ void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>&
     if (b != a) {
       const auto& pB = elementParameters.get(elementTypes_[b]);
       if (pB.pCoreSpecified()) {
-        auto posA = positions_.row(a);
-        auto posB = positions_.row(b);
-        auto Rab = posB - posA;
-
+        Eigen::Vector3d Rab = twoCenterIntegrals.getPairVector(a, b);
         V_.calculate<UnderlyingOrder<O>>(Rab, ap.chargeSeparations(), ap.klopmanParameters(), pB.pCore(), pB.coreCharge());
         for (int i = 0; i < nAOs; i++) {
           for (int j = 0; j <= i; j++) {
-            Pij = P(startIndex + i, startIndex + j);
+            Pij = D(startIndex + i, startIndex + j);
             auto vd = V_.getDerivative<O>(i, j);
             contrib += vd * Pij * (i == j ? 1 : 2);
           }
@@ -184,7 +303,7 @@ void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>&
           const auto& m = *twoCenterIntegrals.get(a, b);
           for (int i = 0; i < nAOs; i++) {
             for (int j = 0; j <= i; j++) {
-              Pij = P(startIndex + i, startIndex + j);
+              Pij = D(startIndex + i, startIndex + j);
               auto vd = -pB.coreCharge() * m.getDerivative<O>(i, j, 0, 0);
               contrib += vd * Pij * (i == j ? 1 : 2);
             }
@@ -194,7 +313,7 @@ void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>&
           const auto& m = *twoCenterIntegrals.get(b, a);
           for (int i = 0; i < nAOs; i++) {
             for (int j = 0; j <= i; j++) {
-              Pij = P(startIndex + i, startIndex + j);
+              Pij = D(startIndex + i, startIndex + j);
               auto vd = -pB.coreCharge() * m.getDerivative<O>(0, 0, i, j);
               // other way around, since swapped a-b
               contrib += getOppositeDerivative<O>(vd * Pij * (i == j ? 1 : 2));
@@ -203,7 +322,12 @@ void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>&
         }
       }
 #pragma omp critical(addDerivativesOneElectronMatrix)
-      { addDerivativeToContainer<O>(derivativeContainer, a, b, contrib); }
+      {
+        addDerivativeToContainer<O>(derivativeContainer, a, b, contrib);
+        if (twoCenterIntegrals.isPeriodic()) {
+          PeriodicCell::addStrainDerivative(strainDerivatives_, twoCenterIntegrals.getPairVector(a, b), contrib);
+        }
+      }
     }
   }
 }
@@ -211,7 +335,8 @@ void OneElectronMatrix::addDerivativesContribution1(DerivativeContainerType<O>&
 template<Utils::Derivative O>
 void OneElectronMatrix::addDerivativesContribution2(DerivativeContainerType<O>& derivativeContainer, int a, int b,
                                                     int indexA, int indexB, int nAOsA, int nAOsB,
-                                                    const Utils::MatrixWithDerivatives& S) const {
+                                                    const Utils::MatrixWithDerivatives& S,
+                                                    const Eigen::MatrixXd& D) const {
   const auto& pA = elementParameters.get(elementTypes_[a]);
   const auto& pB = elementParameters.get(elementTypes_[b]);
   DerivativeType<O> derivativeContribution;
@@ -222,19 +347,43 @@ void OneElectronMatrix::addDerivativesContribution2(DerivativeContainerType<O>&
       double betaB = (j < 1) ? pB.betaS() : (j < 4) ? pB.betaP() : pB.betaD();
       derivativeContribution +=
           getDerivativeFromValueWithDerivatives<O>(S.get<UnderlyingOrder<O>>()(indexA + i, indexB + j)) *
-          ((betaA + betaB) * P(indexA + i, indexB + j));
+          ((betaA + betaB) * D(indexA + i, indexB + j));
     }
   }
   addDerivativeToContainer<O>(derivativeContainer, a, b, derivativeContribution);
+  if (twoCenterIntegrals.isPeriodic()) {
+    const Eigen::Vector3d Rab = twoCenterIntegrals.getPairVector(a, b);
+    PeriodicCell::addStrainDerivative(strainDerivatives_, Rab, derivativeContribution);
+  }
 }
 
 template void OneElectronMatrix::addDerivatives<Utils::Derivative::First>(DerivativeContainerType<Utils::Derivative::First>&,
                                                                           const Utils::MatrixWithDerivatives&) const;
+template void OneElectronMatrix::addDerivatives<Utils::Derivative::First>(DerivativeContainerType<Utils::Derivative::First>&,
+                                                                          const Utils::MatrixWithDerivatives&,
+                                                                          const Eigen::MatrixXd&) const;
+template void OneElectronMatrix::addDerivatives<Utils::Derivative::SecondAtomic>(
+    DerivativeContainerType<Utils::Derivative::SecondAtomic>&, const Utils::MatrixWithDerivatives&,
+    const Eigen::MatrixXd&) const;
+template void
+OneElectronMatrix::addDerivatives<Utils::Derivative::SecondFull>(DerivativeContainerType<Utils::Derivative::SecondFull>&,
+                                                                 const Utils::MatrixWithDerivatives&,
+                                                                 const Eigen::MatrixXd&) const;
 template void OneElectronMatrix::addDerivatives<Utils::Derivative::SecondAtomic>(
     DerivativeContainerType<Utils::Derivative::SecondAtomic>&, const Utils::MatrixWithDerivatives&) const;
 template void
 OneElectronMatrix::addDerivatives<Utils::Derivative::SecondFull>(DerivativeContainerType<Utils::Derivative::SecondFull>&,
                                                                  const Utils::MatrixWithDerivatives&) const;
+template void OneElectronMatrix::addDerivatives<Utils::Derivative::First>(DerivativeContainerType<Utils::Derivative::First>&,
+                                                                          const Utils::MatrixWithDerivatives&,
+                                                                          const Eigen::MatrixXd&) const;
+template void OneElectronMatrix::addDerivatives<Utils::Derivative::SecondAtomic>(
+    DerivativeContainerType<Utils::Derivative::SecondAtomic>&, const Utils::MatrixWithDerivatives&,
+    const Eigen::MatrixXd&) const;
+template void
+OneElectronMatrix::addDerivatives<Utils::Derivative::SecondFull>(DerivativeContainerType<Utils::Derivative::SecondFull>&,
+                                                                 const Utils::MatrixWithDerivatives&,
+                                                                 const Eigen::MatrixXd&) const;
 
 } // namespace nddo
 } // namespace Sparrow
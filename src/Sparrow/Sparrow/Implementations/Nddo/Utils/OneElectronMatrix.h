@@ -20,6 +20,7 @@ class AtomsOrbitalsIndexes;
 } // namespace Utils
 
 namespace Sparrow {
+class PointChargeEmbedding;
 
 namespace nddo {
 class AtomicParameters;
@@ -52,6 +53,15 @@ class OneElectronMatrix {
   template<Utils::Derivative O>
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
                       const Utils::MatrixWithDerivatives& S) const;
+  /**
+   * @brief Calculates the derivative contribution of tr(H D) for a symmetric density matrix D, up to the order
+   *        \tparam O. Meant for response densities, e.g. the relaxed density of an excited state.
+   * The strain derivatives are not updated and neither point charges nor periodic boundaries are supported.
+   */
+  template<Utils::Derivative O>
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
+                      const Utils::MatrixWithDerivatives& S,
+                      const Eigen::MatrixXd& densityMatrix) const;
   //! @brief Getter for the one-electron matrix H.
   const Eigen::MatrixXd& operator()() const {
     return H_;
@@ -59,15 +69,40 @@ class OneElectronMatrix {
   const Eigen::MatrixXd& getMatrix() const {
     return H_;
   }
+  /**
+   * @brief Sets the point charges embedding the molecule, nullptr for none.
+   * A point charge q acts on the electrons of an atom as a core of charge q without Klopman parameter, i.e. through
+   * the charge-multipole integrals V_{mu nu,B}, and on its core through the corresponding (ss|q) integral.
+   * Only first derivatives are available with point charges.
+   */
+  void setPointChargeEmbedding(PointChargeEmbedding* embedding);
+  //! @brief Interaction energy of the cores with the point charges, from the last call to calculate().
+  double getPointChargeCoreEnergy() const;
+  /**
+   * @brief Derivative of the energy contribution of H with respect to a homogeneous strain of the periodic cell and of
+   *        the positions, from the last call to addDerivatives(). Zero without periodic boundaries.
+   */
+  const Eigen::Matrix3d& getStrainDerivatives() const;
 
  private:
+  // Adds the interaction of the electrons of atom a with the point charges to the diagonal block of a.
+  void calculatePointChargeBlock(int a, int startIndex, int nAOs);
+  // Adds the gradients on the atoms and stores the gradients on the point charges in the embedding.
+  void addPointChargeDerivatives(
+      Utils::AutomaticDifferentiation::DerivativeContainerType<Utils::Derivative::First>& derivatives) const;
+  template<class DerivativeContainer>
+  void addPointChargeDerivatives(DerivativeContainer& derivatives) const;
+  // Contributions of the diagonal and of the off-diagonal blocks, contracted with the density matrix D.
   template<Utils::Derivative O>
   void addDerivativesContribution1(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
-                                   int a, int startIndex, int nAOs) const;
+                                   int a, int startIndex, int nAOs, const Eigen::MatrixXd& D) const;
   template<Utils::Derivative O>
   void addDerivativesContribution2(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
                                    int a, int b, int indexA, int indexB, int nAOsA, int nAOsB,
-                                   const Utils::MatrixWithDerivatives& S) const;
+                                   const Utils::MatrixWithDerivatives& S, const Eigen::MatrixXd& D) const;
+  template<Utils::Derivative O>
+  void addDensityDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
+                             const Utils::MatrixWithDerivatives& S, const Eigen::MatrixXd& D) const;
 
   const Eigen::MatrixXd& P;
   const TwoCenterIntegralContainer& twoCenterIntegrals;
@@ -79,6 +114,10 @@ class OneElectronMatrix {
   Eigen::MatrixXd H_;
   const Utils::ElementTypeCollection& elementTypes_;
   const Utils::PositionCollection& positions_;
+  PointChargeEmbedding* pointCharges_ = nullptr;
+  double pointChargeCoreEnergy_ = 0.0;
+  // Filled together with the first derivatives
+  mutable Eigen::Matrix3d strainDerivatives_ = Eigen::Matrix3d::Zero();
 };
 
 } // namespace nddo
@@ -0,0 +1,304 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "ProcessedParametersCache.h"
+#include "AtomicParameters.h"
+#include "PM6DiatomicParameters.h"
+#include "RawParameterProcessor.h"
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/multipoleTypes.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <boost/filesystem.hpp>
+#include <cereal/archives/json.hpp>
+#include <cereal/cereal.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace Scine {
+namespace Sparrow {
+namespace nddo {
+
+namespace {
+constexpr int nKlopmanParameters = 8;
+constexpr int nChargeSeparations = 5;
+static_assert(ProcessedParametersCache::NumberOfRuntimeParameters ==
+                  ProcessedParametersCache::ChargeSeparations + nChargeSeparations &&
+                  ProcessedParametersCache::ChargeSeparations ==
+                      ProcessedParametersCache::KlopmanParameters + nKlopmanParameters,
+              "The layout of the runtime parameters does not match the number of multipole parameters.");
+} // namespace
+
+template<class Archive>
+void ProcessedParametersCache::AtomicEntry::serialize(Archive& archive) {
+  archive(CEREAL_NVP(basisFunctions), CEREAL_NVP(rawParameters), CEREAL_NVP(runtimeParameters),
+          CEREAL_NVP(gaussianRepulsion), CEREAL_NVP(oneCenterIntegrals));
+}
+
+template<class Archive>
+void ProcessedParametersCache::DiatomicEntry::serialize(Archive& archive) {
+  archive(CEREAL_NVP(rawParameters), CEREAL_NVP(alpha), CEREAL_NVP(x));
+}
+
+ProcessedParametersCache& ProcessedParametersCache::instance() {
+  static ProcessedParametersCache cache;
+  return cache;
+}
+
+std::vector<double> ProcessedParametersCache::flatten(const Parameters::Atomic& rawParameters) {
+  const auto& p = rawParameters.pack;
+  std::vector<double> values = {p.oneCenterEnergy.s,  p.oneCenterEnergy.p,  p.oneCenterEnergy.d,  p.beta.s,
+                                p.beta.p,             p.beta.d,             p.orbitalExponent.s,  p.orbitalExponent.p,
+                                p.orbitalExponent.d,  p.internalExponent.s, p.internalExponent.p, p.internalExponent.d,
+                                p.gss,                p.gpp,                p.gsp,                p.gp2,
+                                p.hsp,                p.pcore,              p.f0sd,               p.g2sd,
+                                p.alpha};
+  for (const auto& gaussianRepulsion : rawParameters.gaussianRepulsion) {
+    values.push_back(gaussianRepulsion.a);
+    values.push_back(gaussianRepulsion.b);
+    values.push_back(gaussianRepulsion.c);
+  }
+  return values;
+}
+
+ProcessedParametersCache::AtomicEntry ProcessedParametersCache::createEntry(const AtomicParameters& parameters,
+                                                                            const OneCenterTwoElectronIntegrals& integrals) {
+  AtomicEntry entry;
+  auto& v = entry.runtimeParameters;
+  v.resize(NumberOfRuntimeParameters);
+  v[BetaS] = parameters.betaS();
+  v[BetaP] = parameters.betaP();
+  v[BetaD] = parameters.betaD();
+  v[Uss] = parameters.Uss();
+  v[Upp] = parameters.Upp();
+  v[Udd] = parameters.Udd();
+  v[Alpha] = parameters.alpha();
+  v[PCore] = parameters.pCore();
+  v[PCoreSpecified] = parameters.pCoreSpecified() ? 1.0 : 0.0;
+  for (int i = 0; i < nKlopmanParameters; ++i) {
+    v[KlopmanParameters + i] = parameters.klopmanParameters().get(static_cast<multipole::MultipolePair>(i));
+  }
+  for (int i = 0; i < nChargeSeparations; ++i) {
+    v[ChargeSeparations + i] = parameters.chargeSeparations().get(static_cast<multipole::MultipolePair>(i));
+  }
+  for (const auto& gaussianRepulsion : parameters.getGaussianRepulsionParameters()) {
+    entry.gaussianRepulsion.push_back(std::get<0>(gaussianRepulsion));
+    entry.gaussianRepulsion.push_back(std::get<1>(gaussianRepulsion));
+    entry.gaussianRepulsion.push_back(std::get<2>(gaussianRepulsion));
+  }
+  for (int i = 0; i < integrals.getNumberIntegrals(); ++i) {
+    entry.oneCenterIntegrals.push_back(integrals.get(i));
+  }
+  return entry;
+}
+
+std::pair<std::unique_ptr<AtomicParameters>, std::unique_ptr<OneCenterTwoElectronIntegrals>>
+ProcessedParametersCache::createParameters(Utils::ElementType e, BasisFunctions basisFunctions,
+                                           const Parameters::Atomic& rawParameters, const AtomicEntry& entry) {
+  auto parameters = std::make_unique<AtomicParameters>(e, basisFunctions);
+  const auto& v = entry.runtimeParameters;
+  parameters->setBetaS(v[BetaS]);
+  parameters->setBetaP(v[BetaP]);
+  parameters->setBetaD(v[BetaD]);
+  parameters->setUss(v[Uss]);
+  parameters->setUpp(v[Upp]);
+  parameters->setUdd(v[Udd]);
+  parameters->setAlpha(v[Alpha]);
+  parameters->setPCore(v[PCore]);
+  parameters->setPCoreSpecified(v[PCoreSpecified] != 0.0);
+  multipole::KlopmanParameter klopman;
+  for (int i = 0; i < nKlopmanParameters; ++i) {
+    klopman.set(static_cast<multipole::MultipolePair>(i), v[KlopmanParameters + i]);
+  }
+  parameters->setKlopmanParameters(klopman);
+  multipole::ChargeSeparationParameter chargeSeparations;
+  for (int i = 0; i < nChargeSeparations; ++i) {
+    chargeSeparations.set(static_cast<multipole::MultipolePair>(i), v[ChargeSeparations + i]);
+  }
+  parameters->setChargeSeparations(chargeSeparations);
+  for (unsigned i = 0; i + 2 < entry.gaussianRepulsion.size(); i += 3) {
+    parameters->addGaussianRepulsionParameters(entry.gaussianRepulsion[i], entry.gaussianRepulsion[i + 1],
+                                               entry.gaussianRepulsion[i + 2]);
+  }
+  // The STO-6G expansion is a cheap table lookup and is not stored.
+  RawParameterProcessor::setGtoExpansion(e, *parameters, rawParameters, basisFunctions);
+
+  auto integrals = std::make_unique<OneCenterTwoElectronIntegrals>();
+  integrals->setElement(e, basisFunctions);
+  for (int i = 0; i < static_cast<int>(entry.oneCenterIntegrals.size()); ++i) {
+    integrals->set(i, entry.oneCenterIntegrals[i]);
+  }
+  return std::make_pair(std::move(parameters), std::move(integrals));
+}
+
+std::pair<std::unique_ptr<AtomicParameters>, std::unique_ptr<OneCenterTwoElectronIntegrals>>
+ProcessedParametersCache::getAtomicParameters(Utils::ElementType e, BasisFunctions basisFunctions,
+                                              const Parameters::Atomic& rawParameters, RawParameterProcessor& processor) {
+  const int Z = Utils::ElementInfo::Z(e);
+  const int basis = static_cast<int>(basisFunctions);
+  auto rawValues = flatten(rawParameters);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = atomicEntries_.equal_range(Z);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.basisFunctions == basis && it->second.rawParameters == rawValues) {
+        return createParameters(e, basisFunctions, rawParameters, it->second);
+      }
+    }
+  }
+
+  auto processed = processor.processAtomicParameters(e);
+  auto entry = createEntry(*processed.first, *processed.second);
+  entry.basisFunctions = basis;
+  entry.rawParameters = std::move(rawValues);
+  std::lock_guard<std::mutex> lock(mutex_);
+  insert(atomicEntries_, Z, std::move(entry));
+  return processed;
+}
+
+std::unique_ptr<PM6DiatomicParameters>
+ProcessedParametersCache::getDiatomicParameters(Utils::ElementType e1, Utils::ElementType e2,
+                                                const Parameters::Diatomic& rawParameters, RawParameterProcessor& processor) {
+  const auto key = Parameters::key(e1, e2);
+  std::vector<double> rawValues = {rawParameters.exponent, rawParameters.factor};
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto range = diatomicEntries_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.rawParameters == rawValues) {
+        auto parameters = std::make_unique<PM6DiatomicParameters>(e1, e2);
+        parameters->setAlpha(it->second.alpha);
+        parameters->setX(it->second.x);
+        return parameters;
+      }
+    }
+  }
+
+  auto parameters = processor.runtimeDiatomicParameters(e1, e2);
+  DiatomicEntry entry;
+  entry.rawParameters = std::move(rawValues);
+  entry.alpha = parameters->alpha();
+  entry.x = parameters->x();
+  std::lock_guard<std::mutex> lock(mutex_);
+  insert(diatomicEntries_, key, std::move(entry));
+  return parameters;
+}
+
+void ProcessedParametersCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  atomicEntries_.clear();
+  diatomicEntries_.clear();
+}
+
+template<class Key, class Entry>
+void ProcessedParametersCache::insert(std::multimap<Key, Entry>& entries, const Key& key, Entry entry) {
+  // Equal keys are inserted after the existing ones, the first entry of a key is its oldest one.
+  entries.emplace(key, std::move(entry));
+  truncate(entries, key);
+}
+
+template<class Key, class Entry>
+void ProcessedParametersCache::truncate(std::multimap<Key, Entry>& entries, const Key& key) {
+  auto count = static_cast<int>(entries.count(key));
+  auto it = entries.lower_bound(key);
+  for (; count > maximumParameterSets_; --count) {
+    it = entries.erase(it);
+  }
+}
+
+template<class Key, class Entry>
+void ProcessedParametersCache::truncate(std::multimap<Key, Entry>& entries) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    const Key key = it->first;
+    truncate(entries, key);
+    it = entries.upper_bound(key);
+  }
+}
+
+void ProcessedParametersCache::setMaximumParameterSets(int maximum) {
+  if (maximum < 1) {
+    throw std::runtime_error("At least one parameter set per element must be cached.");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  maximumParameterSets_ = maximum;
+  truncate(atomicEntries_);
+  truncate(diatomicEntries_);
+}
+
+int ProcessedParametersCache::getMaximumParameterSets() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return maximumParameterSets_;
+}
+
+int ProcessedParametersCache::numberOfAtomicEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(atomicEntries_.size());
+}
+
+int ProcessedParametersCache::numberOfDiatomicEntries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<int>(diatomicEntries_.size());
+}
+
+void ProcessedParametersCache::write(const std::string& fileName) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::pair<int, AtomicEntry>> atomic(atomicEntries_.begin(), atomicEntries_.end());
+  std::vector<std::pair<Parameters::DiatomicKey, DiatomicEntry>> diatomic(diatomicEntries_.begin(), diatomicEntries_.end());
+  std::ofstream outfile(fileName);
+  cereal::JSONOutputArchive archive(outfile);
+  archive(cereal::make_nvp("atomic", atomic), cereal::make_nvp("diatomic", diatomic));
+}
+
+void ProcessedParametersCache::read(const std::string& fileName) {
+  if (!boost::filesystem::exists(fileName)) {
+    throw std::runtime_error("Processed parameters file to read does not exist");
+  }
+
+  std::vector<std::pair<int, AtomicEntry>> atomic;
+  std::vector<std::pair<Parameters::DiatomicKey, DiatomicEntry>> diatomic;
+  {
+    std::ifstream infile(fileName);
+    cereal::JSONInputArchive archive(infile);
+    archive(cereal::make_nvp("atomic", atomic), cereal::make_nvp("diatomic", diatomic));
+  }
+
+  for (const auto& entry : atomic) {
+    if (entry.second.runtimeParameters.size() != static_cast<std::size_t>(NumberOfRuntimeParameters)) {
+      throw std::runtime_error("Processed parameters file " + fileName + " has an incompatible format.");
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& entry : atomic) {
+    auto range = atomicEntries_.equal_range(entry.first);
+    bool known = std::any_of(range.first, range.second, [&](const std::pair<const int, AtomicEntry>& cached) {
+      return cached.second.basisFunctions == entry.second.basisFunctions &&
+             cached.second.rawParameters == entry.second.rawParameters;
+    });
+    if (!known) {
+      insert(atomicEntries_, entry.first, std::move(entry.second));
+    }
+  }
+  for (auto& entry : diatomic) {
+    auto range = diatomicEntries_.equal_range(entry.first);
+    bool known = std::any_of(range.first, range.second,
+                             [&](const std::pair<const Parameters::DiatomicKey, DiatomicEntry>& cached) {
+                               return cached.second.rawParameters == entry.second.rawParameters;
+                             });
+    if (!known) {
+      insert(diatomicEntries_, entry.first, std::move(entry.second));
+    }
+  }
+}
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_PROCESSEDPARAMETERSCACHE_H
+#define SPARROW_PROCESSEDPARAMETERSCACHE_H
+
+#include "PrincipalQuantumNumbers.h"
+#include <Sparrow/Implementations/Nddo/Parameters.h>
+#include <Utils/Geometry/ElementTypes.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+namespace nddo {
+
+class AtomicParameters;
+class PM6DiatomicParameters;
+class OneCenterTwoElectronIntegrals;
+class RawParameterProcessor;
+
+/*!
+ * Process-wide cache of the runtime parameters generated by the RawParameterProcessor.
+ *
+ * Processing the raw parameters of an element (Slater-Condon parameters, Klopman and charge-separation parameters,
+ * one-center two-electron integrals) is comparatively expensive and used to be repeated at every call to
+ * setStructure and for every clone of a calculator. The entries are keyed by the element, the basis functions and
+ * the exact values of the raw parameters they were generated from, so that modified or different parameter sets
+ * never share an entry.
+ * At most getMaximumParameterSets() parameter sets are kept for every element and element pair, the oldest one is
+ * dropped when a new one is added, such that parameter optimizations do not let the cache grow without bound.
+ * The cache can be written to and read from a JSON file, in which case a cold start skips the processing as well.
+ * All functions are thread-safe.
+ */
+class ProcessedParametersCache {
+ public:
+  //! @brief Access to the cache shared by all NDDO methods of the process.
+  static ProcessedParametersCache& instance();
+
+  /**
+   * @brief Returns the runtime atomic parameters and one-center integrals for an element.
+   * They are generated with the processor if not cached yet.
+   */
+  std::pair<std::unique_ptr<AtomicParameters>, std::unique_ptr<OneCenterTwoElectronIntegrals>>
+  getAtomicParameters(Utils::ElementType e, BasisFunctions basisFunctions, const Parameters::Atomic& rawParameters,
+                      RawParameterProcessor& processor);
+  /**
+   * @brief Returns the runtime diatomic parameters for an element pair.
+   * They are generated with the processor if not cached yet.
+   */
+  std::unique_ptr<PM6DiatomicParameters> getDiatomicParameters(Utils::ElementType e1, Utils::ElementType e2,
+                                                               const Parameters::Diatomic& rawParameters,
+                                                               RawParameterProcessor& processor);
+
+  //! @brief Removes all entries.
+  void clear();
+  /**
+   * @brief Sets the maximal number of raw parameter sets cached for every element and element pair.
+   * Surplus entries are dropped, starting with the oldest ones.
+   */
+  void setMaximumParameterSets(int maximum);
+  int getMaximumParameterSets() const;
+  //! @brief Number of cached elements.
+  int numberOfAtomicEntries() const;
+  //! @brief Number of cached element pairs.
+  int numberOfDiatomicEntries() const;
+
+  /*! Writes all entries to a JSON file. */
+  void write(const std::string& fileName) const;
+  /*! Reads entries from a JSON file written by write(), they are added to the current ones. */
+  void read(const std::string& fileName);
+
+  struct AtomicEntry {
+    int basisFunctions;
+    std::vector<double> rawParameters;
+    //! The runtime parameters in the order of RuntimeParameter
+    std::vector<double> runtimeParameters;
+    std::vector<double> gaussianRepulsion;
+    std::vector<double> oneCenterIntegrals;
+
+    template<class Archive>
+    void serialize(Archive& archive);
+  };
+  //! @brief Positions of the runtime parameters in AtomicEntry::runtimeParameters.
+  enum RuntimeParameter : int {
+    BetaS,
+    BetaP,
+    BetaD,
+    Uss,
+    Upp,
+    Udd,
+    Alpha,
+    PCore,
+    PCoreSpecified,
+    //! First of the 8 Klopman parameters, in the order of multipole::MultipolePair
+    KlopmanParameters,
+    //! First of the 5 charge separations, in the order of multipole::MultipolePair
+    ChargeSeparations = KlopmanParameters + 8,
+    NumberOfRuntimeParameters = ChargeSeparations + 5
+  };
+  struct DiatomicEntry {
+    std::vector<double> rawParameters;
+    double alpha;
+    double x;
+
+    template<class Archive>
+    void serialize(Archive& archive);
+  };
+
+ private:
+  ProcessedParametersCache() = default;
+
+  static std::vector<double> flatten(const Parameters::Atomic& rawParameters);
+  static AtomicEntry createEntry(const AtomicParameters& parameters, const OneCenterTwoElectronIntegrals& integrals);
+  static std::pair<std::unique_ptr<AtomicParameters>, std::unique_ptr<OneCenterTwoElectronIntegrals>>
+  createParameters(Utils::ElementType e, BasisFunctions basisFunctions, const Parameters::Atomic& rawParameters,
+                   const AtomicEntry& entry);
+
+  // Add an entry and drop the oldest entries of a key, or of all keys, beyond the maximal number of parameter sets.
+  template<class Key, class Entry>
+  void insert(std::multimap<Key, Entry>& entries, const Key& key, Entry entry);
+  template<class Key, class Entry>
+  void truncate(std::multimap<Key, Entry>& entries, const Key& key);
+  template<class Key, class Entry>
+  void truncate(std::multimap<Key, Entry>& entries);
+
+  // The key is the atomic number, the entries for the same element differ by their raw parameters and are ordered
+  // from the oldest to the newest.
+  std::multimap<int, AtomicEntry> atomicEntries_;
+  std::multimap<Parameters::DiatomicKey, DiatomicEntry> diatomicEntries_;
+  int maximumParameterSets_ = 8;
+  mutable std::mutex mutex_;
+};
+
+} // namespace nddo
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_PROCESSEDPARAMETERSCACHE_H
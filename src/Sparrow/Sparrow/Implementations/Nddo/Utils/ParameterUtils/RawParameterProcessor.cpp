@@ -84,7 +84,7 @@ RawParameterProcessor::processAtomicParameters(Utils::ElementType e) {
   runtimeAtomicPar->setAlpha(p.pack.alpha * Utils::Constants::angstrom_per_bohr);
   setChargeSeparations(e, *runtimeAtomicPar, p);
   setKlopman(*runtimeAtomicPar, p);
-  setGtoExpansion(e, *runtimeAtomicPar, p);
+  setGtoExpansion(e, *runtimeAtomicPar, p, basisFunctions_);
 
   for (const auto& gaussianRepulsion : p.gaussianRepulsion) {
     runtimeAtomicPar->addGaussianRepulsionParameters(gaussianRepulsion.a * Utils::Constants::bohr_per_angstrom,
@@ -173,17 +173,18 @@ void RawParameterProcessor::setChargeSeparations(Utils::ElementType e, AtomicPar
   par.setChargeSeparations(d);
 }
 
-void RawParameterProcessor::setGtoExpansion(Utils::ElementType e, AtomicParameters& par, const Parameters::Atomic& p) const {
+void RawParameterProcessor::setGtoExpansion(Utils::ElementType e, AtomicParameters& par, const Parameters::Atomic& p,
+                                            BasisFunctions basisFunctions) {
   Utils::AtomicGtos gto;
   unsigned int N = 6; // STO-6G
   unsigned int ns = PM6Elements::getQuantumNumberForSOrbital(e);
   unsigned int np = PM6Elements::getQuantumNumberForPOrbital(e);
   unsigned int nd = PM6Elements::getQuantumNumberForDOrbital(e);
   gto.s = Utils::SlaterToGaussian::getGTOExpansion(N, ns, 0, p.pack.orbitalExponent.s);
-  if (PM6Elements::getNumberOfAOs(e, basisFunctions_) >= 4) {
+  if (PM6Elements::getNumberOfAOs(e, basisFunctions) >= 4) {
     gto.p = Utils::SlaterToGaussian::getGTOExpansion(N, np, 1, p.pack.orbitalExponent.p);
   }
-  if (PM6Elements::getNumberOfAOs(e, basisFunctions_) == 9) {
+  if (PM6Elements::getNumberOfAOs(e, basisFunctions) == 9) {
     gto.d = Utils::SlaterToGaussian::getGTOExpansion(N, nd, 2, p.pack.orbitalExponent.d);
   }
   par.setGTOs(std::move(gto));
@@ -32,13 +32,15 @@ class RawParameterProcessor {
   std::unique_ptr<PM6DiatomicParameters> runtimeDiatomicParameters(Utils::ElementType e1, Utils::ElementType e2);
   std::pair<std::unique_ptr<AtomicParameters>, std::unique_ptr<OneCenterTwoElectronIntegrals>>
   processAtomicParameters(Utils::ElementType e);
+  /*! Sets the STO-6G expansion of the atomic orbitals from the raw orbital exponents. */
+  static void setGtoExpansion(Utils::ElementType e, AtomicParameters& par, const Parameters::Atomic& p,
+                              BasisFunctions basisFunctions);
 
  private:
   std::unique_ptr<OneCenterTwoElectronIntegrals> get1c2eIntegrals(Utils::ElementType e, const Parameters::Atomic& p) const;
   void computeSlaterCondonParameters(AtomicParameters& runtimeAtomicPar, const Parameters::Atomic& p);
   void setKlopman(AtomicParameters& par, const Parameters::Atomic& p) const;
   void setChargeSeparations(Utils::ElementType e, AtomicParameters& par, const Parameters::Atomic& p) const;
-  void setGtoExpansion(Utils::ElementType e, AtomicParameters& par, const Parameters::Atomic& p) const;
   static void setDiatomicExponent(PM6DiatomicParameters& par, Utils::ElementType e1, Utils::ElementType e2,
                                   const Parameters::Diatomic& p);
 
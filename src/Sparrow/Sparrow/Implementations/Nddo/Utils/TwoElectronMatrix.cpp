@@ -12,10 +12,12 @@
 #include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/AtomicParameters.h>
 #include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ElementParameters.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
 #include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
 #include <Utils/DataStructures/DensityMatrix.h>
 #include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
 #include <omp.h>
+#include <algorithm>
 
 namespace Scine {
 namespace Sparrow {
@@ -26,6 +28,22 @@ initializer(omp_priv=Eigen::MatrixXd::Zero(omp_orig.rows(), omp_orig.cols()))
 
 using namespace Utils::AutomaticDifferentiation;
 
+namespace {
+// The maximal size avoids heap allocations for the vectorized blocks of atoms with up to 9 orbitals.
+using BlockVector = Eigen::Matrix<float, Eigen::Dynamic, 1, Eigen::ColMajor, 81, 1>;
+
+// Column-wise vectorized block of a matrix.
+BlockVector vectorize(const Eigen::MatrixXf& matrix, int startRow, int startCol, int nRows, int nCols) {
+  BlockVector vector(nRows * nCols);
+  Eigen::Map<Eigen::MatrixXf>(vector.data(), nRows, nCols) = matrix.block(startRow, startCol, nRows, nCols);
+  return vector;
+}
+
+Eigen::Map<const Eigen::MatrixXf> asMatrix(const BlockVector& vector, int nRows, int nCols) {
+  return Eigen::Map<const Eigen::MatrixXf>(vector.data(), nRows, nCols);
+}
+} // namespace
+
 TwoElectronMatrix::TwoElectronMatrix(const Utils::ElementTypeCollection& elements, const Utils::DensityMatrix& densityMatrix,
                                      const OneCenterIntegralContainer& oneCIntegrals,
                                      const TwoCenterIntegralContainer& twoCIntegrals,
@@ -48,8 +66,23 @@ void TwoElectronMatrix::initialize() {
   G_ = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
 }
 
+void TwoElectronMatrix::setSinglePrecision(bool singlePrecision) {
+  singlePrecision_ = singlePrecision;
+  if (!singlePrecision_) {
+    std::vector<SinglePrecisionBlock>().swap(singlePrecisionBlocks_);
+  }
+}
+
+bool TwoElectronMatrix::usesSinglePrecision() const {
+  return singlePrecision_;
+}
+
 void TwoElectronMatrix::calculate(bool spinPolarized) {
   spinPolarized_ = spinPolarized;
+  if (singlePrecision_) {
+    calculateInSinglePrecision();
+    return;
+  }
   if (!spinPolarized_) {
     G_ = Eigen::MatrixXd::Zero(nAOs_, nAOs_);
   }
@@ -60,6 +93,147 @@ void TwoElectronMatrix::calculate(bool spinPolarized) {
   calculateBlocks();
 }
 
+void TwoElectronMatrix::calculateInSinglePrecision() {
+  if (singlePrecisionBlocks_.empty()) {
+    copyIntegralsToSinglePrecision();
+  }
+  const Eigen::MatrixXf D = P.cast<float>();
+  Eigen::MatrixXf DAlpha, DBeta, G, GAlpha, GBeta;
+  if (!spinPolarized_) {
+    G = Eigen::MatrixXf::Zero(nAOs_, nAOs_);
+  }
+  else {
+    DAlpha = PAlpha_.cast<float>();
+    DBeta = PBeta_.cast<float>();
+    GAlpha = Eigen::MatrixXf::Zero(nAOs_, nAOs_);
+    GBeta = Eigen::MatrixXf::Zero(nAOs_, nAOs_);
+  }
+  for (const auto& block : singlePrecisionBlocks_) {
+    if (block.startA == block.startB) {
+      calculateSameAtomBlockInSinglePrecision(block, D, DAlpha, DBeta, G, GAlpha, GBeta);
+    }
+    else {
+      calculateDifferentAtomsBlockInSinglePrecision(block, D, DAlpha, DBeta, G, GAlpha, GBeta);
+    }
+  }
+  if (!spinPolarized_) {
+    G_ = G.cast<double>();
+  }
+  else {
+    GAlpha_ = GAlpha.cast<double>();
+    GBeta_ = GBeta.cast<double>();
+  }
+}
+
+void TwoElectronMatrix::copyIntegralsToSinglePrecision() {
+  singlePrecisionBlocks_.clear();
+  singlePrecisionBlocks_.reserve(nAtoms_ * (nAtoms_ + 1) / 2);
+  for (int a = 0; a < nAtoms_; ++a) {
+    const int start = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOs = aoIndexes_.getNOrbitals(a);
+    const auto& m = oneCenterIntegrals.get(elementTypes_[a]);
+    SinglePrecisionBlock block{start, start, nAOs, nAOs, Eigen::MatrixXf(nAOs * nAOs, nAOs * nAOs),
+                               Eigen::MatrixXf(nAOs * nAOs, nAOs * nAOs)};
+    for (int i = 0; i < nAOs; ++i) {
+      for (int j = 0; j < nAOs; ++j) {
+        for (int k = 0; k < nAOs; ++k) {
+          for (int l = 0; l < nAOs; ++l) {
+            block.coulomb(i + nAOs * j, k + nAOs * l) = static_cast<float>(m.get(i, j, k, l));
+            block.exchange(i + nAOs * j, k + nAOs * l) = static_cast<float>(m.get(i, k, j, l));
+          }
+        }
+      }
+    }
+    singlePrecisionBlocks_.push_back(std::move(block));
+  }
+
+  for (int a = 0; a < nAtoms_; ++a) {
+    const int startA = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOsA = aoIndexes_.getNOrbitals(a);
+    for (int b = a + 1; b < nAtoms_; ++b) {
+      const int startB = aoIndexes_.getFirstOrbitalIndex(b);
+      const int nAOsB = aoIndexes_.getNOrbitals(b);
+      const auto& m = *twoCenterIntegrals.get(a, b);
+      SinglePrecisionBlock block{startA, startB, nAOsA, nAOsB, Eigen::MatrixXf(nAOsA * nAOsA, nAOsB * nAOsB),
+                                 Eigen::MatrixXf(nAOsB * nAOsA, nAOsB * nAOsA)};
+      for (int mu = 0; mu < nAOsA; ++mu) {
+        for (int nu = 0; nu < nAOsA; ++nu) {
+          for (int lambda = 0; lambda < nAOsB; ++lambda) {
+            for (int sigma = 0; sigma < nAOsB; ++sigma) {
+              // The integrals are only stored for the first orbital of each atom not preceding the second one
+              const auto integral = static_cast<float>(
+                  m.get(std::max(mu, nu), std::min(mu, nu), std::max(lambda, sigma), std::min(lambda, sigma)));
+              block.coulomb(mu + nAOsA * nu, lambda + nAOsB * sigma) = integral;
+              block.exchange(lambda + nAOsB * mu, sigma + nAOsB * nu) = integral;
+            }
+          }
+        }
+      }
+      singlePrecisionBlocks_.push_back(std::move(block));
+    }
+  }
+}
+
+void TwoElectronMatrix::calculateSameAtomBlockInSinglePrecision(const SinglePrecisionBlock& block,
+                                                                const Eigen::MatrixXf& D, const Eigen::MatrixXf& DAlpha,
+                                                                const Eigen::MatrixXf& DBeta, Eigen::MatrixXf& G,
+                                                                Eigen::MatrixXf& GAlpha, Eigen::MatrixXf& GBeta) const {
+  const int start = block.startA;
+  const int nAOs = block.nAOsA;
+  const BlockVector density = vectorize(D, start, start, nAOs, nAOs);
+  BlockVector coulomb(nAOs * nAOs);
+  coulomb.noalias() = block.coulomb * density;
+  if (!spinPolarized_) {
+    coulomb.noalias() -= 0.5f * (block.exchange * density);
+    G.block(start, start, nAOs, nAOs).triangularView<Eigen::Lower>() += asMatrix(coulomb, nAOs, nAOs);
+  }
+  else {
+    BlockVector alpha = coulomb;
+    alpha.noalias() -= block.exchange * vectorize(DAlpha, start, start, nAOs, nAOs);
+    GAlpha.block(start, start, nAOs, nAOs).triangularView<Eigen::Lower>() += asMatrix(alpha, nAOs, nAOs);
+    BlockVector beta = coulomb;
+    beta.noalias() -= block.exchange * vectorize(DBeta, start, start, nAOs, nAOs);
+    GBeta.block(start, start, nAOs, nAOs).triangularView<Eigen::Lower>() += asMatrix(beta, nAOs, nAOs);
+  }
+}
+
+void TwoElectronMatrix::calculateDifferentAtomsBlockInSinglePrecision(const SinglePrecisionBlock& block,
+                                                                      const Eigen::MatrixXf& D,
+                                                                      const Eigen::MatrixXf& DAlpha,
+                                                                      const Eigen::MatrixXf& DBeta, Eigen::MatrixXf& G,
+                                                                      Eigen::MatrixXf& GAlpha,
+                                                                      Eigen::MatrixXf& GBeta) const {
+  const int startA = block.startA;
+  const int startB = block.startB;
+  const int nAOsA = block.nAOsA;
+  const int nAOsB = block.nAOsB;
+  // Coulomb terms on the diagonal blocks of both atoms
+  BlockVector coulombA(nAOsA * nAOsA);
+  coulombA.noalias() = block.coulomb * vectorize(D, startB, startB, nAOsB, nAOsB);
+  BlockVector coulombB(nAOsB * nAOsB);
+  coulombB.noalias() = block.coulomb.transpose() * vectorize(D, startA, startA, nAOsA, nAOsA);
+  // Exchange terms on the off-diagonal block of the lower triangle
+  if (!spinPolarized_) {
+    BlockVector exchange(nAOsB * nAOsA);
+    exchange.noalias() = block.exchange * vectorize(D, startB, startA, nAOsB, nAOsA);
+    G.block(startA, startA, nAOsA, nAOsA).triangularView<Eigen::Lower>() += asMatrix(coulombA, nAOsA, nAOsA);
+    G.block(startB, startB, nAOsB, nAOsB).triangularView<Eigen::Lower>() += asMatrix(coulombB, nAOsB, nAOsB);
+    G.block(startB, startA, nAOsB, nAOsA) -= 0.5f * asMatrix(exchange, nAOsB, nAOsA);
+  }
+  else {
+    BlockVector exchangeAlpha(nAOsB * nAOsA);
+    exchangeAlpha.noalias() = block.exchange * vectorize(DAlpha, startB, startA, nAOsB, nAOsA);
+    BlockVector exchangeBeta(nAOsB * nAOsA);
+    exchangeBeta.noalias() = block.exchange * vectorize(DBeta, startB, startA, nAOsB, nAOsA);
+    for (auto* spinG : {&GAlpha, &GBeta}) {
+      spinG->block(startA, startA, nAOsA, nAOsA).triangularView<Eigen::Lower>() += asMatrix(coulombA, nAOsA, nAOsA);
+      spinG->block(startB, startB, nAOsB, nAOsB).triangularView<Eigen::Lower>() += asMatrix(coulombB, nAOsB, nAOsB);
+    }
+    GAlpha.block(startB, startA, nAOsB, nAOsA) -= asMatrix(exchangeAlpha, nAOsB, nAOsA);
+    GBeta.block(startB, startA, nAOsB, nAOsA) -= asMatrix(exchangeBeta, nAOsB, nAOsA);
+  }
+}
+
 void TwoElectronMatrix::calculateBlocks() {
   for (int i = 0; i < nAtoms_; ++i) {
     auto index = aoIndexes_.getFirstOrbitalIndex(i);
@@ -167,6 +341,7 @@ void TwoElectronMatrix::calculateDifferentAtomsBlock(int startA, int startB, int
 
 template<Utils::Derivative O>
 void TwoElectronMatrix::addDerivatives(DerivativeContainerType<O>& derivativeContainer) const {
+  strainDerivatives_.setZero();
   for (int i = 0; i < nAtoms_; ++i) {
     auto indexA = aoIndexes_.getFirstOrbitalIndex(i);
     auto nAOsA = aoIndexes_.getNOrbitals(i);
@@ -238,7 +413,52 @@ void TwoElectronMatrix::addDerivativesForBlock(DerivativeContainerType<O>& deriv
     }
   }
   Utils::AutomaticDifferentiation::addDerivativeToContainer<O>(derivativeContainer, a, b, derivativeContribution);
+  if (twoCenterIntegrals.isPeriodic()) {
+    const Eigen::Vector3d Rab = twoCenterIntegrals.getPairVector(a, b);
+    PeriodicCell::addStrainDerivative(strainDerivatives_, Rab, derivativeContribution);
+  }
+}
+
+template<Utils::Derivative O>
+void TwoElectronMatrix::addDerivatives(DerivativeContainerType<O>& derivativeContainer, const Eigen::MatrixXd& left,
+                                       const Eigen::MatrixXd& right, double coulombFactor,
+                                       double exchangeFactor) const {
+  for (int a = 0; a < nAtoms_; ++a) {
+    const int startA = aoIndexes_.getFirstOrbitalIndex(a);
+    const int nAOsA = aoIndexes_.getNOrbitals(a);
+    for (int b = a + 1; b < nAtoms_; ++b) {
+      const int startB = aoIndexes_.getFirstOrbitalIndex(b);
+      const int nAOsB = aoIndexes_.getNOrbitals(b);
+      const auto& m = *twoCenterIntegrals.get(a, b);
+      DerivativeType<O> derivativeContribution;
+      derivativeContribution.setZero();
+      for (int i = 0; i < nAOsA; i++) {
+        for (int j = 0; j <= i; j++) {
+          for (int k = 0; k < nAOsB; k++) {
+            for (int l = 0; l <= k; l++) {
+              // Sum over the orderings of the orbitals on each atom, for (mu nu|lambda sigma) and (lambda sigma|mu nu).
+              double factor = 0.0;
+              for (int p = 0; p < (i == j ? 1 : 2); ++p) {
+                const int mu = startA + (p == 0 ? i : j);
+                const int nu = startA + (p == 0 ? j : i);
+                for (int q = 0; q < (k == l ? 1 : 2); ++q) {
+                  const int lambda = startB + (q == 0 ? k : l);
+                  const int sigma = startB + (q == 0 ? l : k);
+                  factor += coulombFactor * (left(mu, nu) * right(lambda, sigma) + left(lambda, sigma) * right(mu, nu));
+                  factor -=
+                      exchangeFactor * (left(mu, lambda) * right(nu, sigma) + left(lambda, mu) * right(sigma, nu));
+                }
+              }
+              derivativeContribution += m.getDerivative<O>(i, j, k, l) * factor;
+            }
+          }
+        }
+      }
+      addDerivativeToContainer<O>(derivativeContainer, a, b, derivativeContribution);
+    }
+  }
 }
+
 const OneCenterIntegralContainer& TwoElectronMatrix::getOneCenterIntegrals() const {
   return oneCenterIntegrals;
 }
@@ -246,11 +466,24 @@ const TwoCenterIntegralContainer& TwoElectronMatrix::getTwoCenterIntegrals() con
   return twoCenterIntegrals;
 }
 
+const Eigen::Matrix3d& TwoElectronMatrix::getStrainDerivatives() const {
+  return strainDerivatives_;
+}
+
 template void TwoElectronMatrix::addDerivatives<Utils::Derivative::First>(DerivativeContainerType<Utils::Derivative::First>&) const;
 template void
 TwoElectronMatrix::addDerivatives<Utils::Derivative::SecondAtomic>(DerivativeContainerType<Utils::Derivative::SecondAtomic>&) const;
 template void
 TwoElectronMatrix::addDerivatives<Utils::Derivative::SecondFull>(DerivativeContainerType<Utils::Derivative::SecondFull>&) const;
+template void TwoElectronMatrix::addDerivatives<Utils::Derivative::First>(DerivativeContainerType<Utils::Derivative::First>&,
+                                                                          const Eigen::MatrixXd&, const Eigen::MatrixXd&,
+                                                                          double, double) const;
+template void TwoElectronMatrix::addDerivatives<Utils::Derivative::SecondAtomic>(
+    DerivativeContainerType<Utils::Derivative::SecondAtomic>&, const Eigen::MatrixXd&, const Eigen::MatrixXd&, double,
+    double) const;
+template void TwoElectronMatrix::addDerivatives<Utils::Derivative::SecondFull>(
+    DerivativeContainerType<Utils::Derivative::SecondFull>&, const Eigen::MatrixXd&, const Eigen::MatrixXd&, double,
+    double) const;
 
 } // namespace nddo
 } // namespace Sparrow
@@ -11,6 +11,7 @@
 #include <Utils/Math/AutomaticDifferentiation/MethodsTypesHelper.h>
 #include <Utils/Typenames.h>
 #include <Eigen/Core>
+#include <vector>
 
 namespace Scine {
 
@@ -37,6 +38,8 @@ class Global2c2eMatrix;
 /*!
  * @brief Class to generate the two-electron matrix G for semi-empirical methods.
  * This class is parallelized with OpenMP.
+ * The matrix can optionally be accumulated in single precision, see setSinglePrecision(); it is always stored in
+ * double precision.
  */
 
 class TwoElectronMatrix {
@@ -54,6 +57,28 @@ class TwoElectronMatrix {
                                     Eigen::MatrixXd& G, Eigen::MatrixXd& GAlpha, Eigen::MatrixXd& GBeta);
   template<Utils::Derivative O>
   void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer) const;
+  /**
+   * @brief Adds the derivatives of sum_{mu nu lambda sigma} (mu nu|lambda sigma) [c A_{mu nu} B_{lambda sigma} -
+   *        x A_{mu lambda} B_{nu sigma}] for general, not necessarily symmetric, matrices A and B.
+   * Meant for the response terms of excited-state gradients. The strain derivatives are not updated.
+   * @param left The matrix A.
+   * @param right The matrix B.
+   * @param coulombFactor The factor c of the Coulomb-type contraction.
+   * @param exchangeFactor The factor x of the exchange-type contraction.
+   */
+  template<Utils::Derivative O>
+  void addDerivatives(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer,
+                      const Eigen::MatrixXd& left, const Eigen::MatrixXd& right, double coulombFactor,
+                      double exchangeFactor) const;
+  /**
+   * @brief Sets whether the density matrix is contracted with the integrals in single precision.
+   * Meant for the early iterations of a SCF cycle, the derivatives are always calculated in double precision. The
+   * integrals are copied to single precision for the first matrix calculated in single precision, and these copies
+   * are dropped when switching back to double precision. Hence, the mode has to be switched off whenever the
+   * integrals change.
+   */
+  void setSinglePrecision(bool singlePrecision);
+  bool usesSinglePrecision() const;
   const Eigen::MatrixXd& operator()() const {
     return G_;
   }
@@ -75,13 +100,41 @@ class TwoElectronMatrix {
    * @brief Getter for the 2 center 2 electron integral matrix.
    */
   const TwoCenterIntegralContainer& getTwoCenterIntegrals() const;
+  /**
+   * @brief Derivative of the energy contribution of G with respect to a homogeneous strain of the periodic cell and of
+   *        the positions, from the last call to addDerivatives(). Zero without periodic boundaries.
+   */
+  const Eigen::Matrix3d& getStrainDerivatives() const;
 
  private:
+  /*
+   * Integrals of an atom or of an atom pair in single precision, as matrices acting on column-wise vectorized blocks
+   * of the density matrix. For an atom, coulomb holds (i j|k l) and exchange (i k|j l), both with the row index
+   * i + nAOs j and the column index k + nAOs l. For an atom pair, coulomb holds (mu nu|lambda sigma) with the row
+   * index mu + nAOsA nu and the column index lambda + nAOsB sigma, and exchange the same integral with the row index
+   * lambda + nAOsB mu and the column index sigma + nAOsB nu.
+   */
+  struct SinglePrecisionBlock {
+    int startA, startB, nAOsA, nAOsB;
+    Eigen::MatrixXf coulomb, exchange;
+  };
+
+  void calculateInSinglePrecision();
+  void copyIntegralsToSinglePrecision();
+  void calculateSameAtomBlockInSinglePrecision(const SinglePrecisionBlock& block, const Eigen::MatrixXf& D,
+                                               const Eigen::MatrixXf& DAlpha, const Eigen::MatrixXf& DBeta,
+                                               Eigen::MatrixXf& G, Eigen::MatrixXf& GAlpha,
+                                               Eigen::MatrixXf& GBeta) const;
+  void calculateDifferentAtomsBlockInSinglePrecision(const SinglePrecisionBlock& block, const Eigen::MatrixXf& D,
+                                                     const Eigen::MatrixXf& DAlpha, const Eigen::MatrixXf& DBeta,
+                                                     Eigen::MatrixXf& G, Eigen::MatrixXf& GAlpha,
+                                                     Eigen::MatrixXf& GBeta) const;
   template<Utils::Derivative O>
   void addDerivativesForBlock(Utils::AutomaticDifferentiation::DerivativeContainerType<O>& derivativeContainer, int a, int b,
                               int startA, int startB, int nAOsA, int nAOsB, const multipole::Global2c2eMatrix& m) const;
 
   bool spinPolarized_;
+  bool singlePrecision_ = false;
   const Eigen::MatrixXd &P, &PAlpha_, &PBeta_;
   const OneCenterIntegralContainer& oneCenterIntegrals;
   const TwoCenterIntegralContainer& twoCenterIntegrals;
@@ -89,9 +142,13 @@ class TwoElectronMatrix {
   const Utils::AtomsOrbitalsIndexes& aoIndexes_;
 
   Eigen::MatrixXd G_, GAlpha_, GBeta_;
+  // Copied when the first matrix of a SCF cycle is calculated in single precision
+  std::vector<SinglePrecisionBlock> singlePrecisionBlocks_;
   const Utils::ElementTypeCollection& elementTypes_;
   int nAOs_;
   int nAtoms_;
+  // Filled together with the first derivatives
+  mutable Eigen::Matrix3d strainDerivatives_ = Eigen::Matrix3d::Zero();
 };
 
 } // namespace nddo
@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "PeriodicCell.h"
+#include <Utils/Constants.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+void PeriodicCell::setLattice(const Eigen::Matrix3d& lattice) {
+  if (std::abs(lattice.determinant()) < 1e-6) {
+    throw std::runtime_error("The lattice vectors of the periodic cell are linearly dependent.");
+  }
+  lattice_ = lattice;
+  inverseLattice_ = lattice.inverse();
+  periodic_ = true;
+}
+
+void PeriodicCell::setFromString(const std::string& cell) {
+  if (cell.find_first_not_of(" \t") == std::string::npos) {
+    clear();
+    return;
+  }
+  std::stringstream ss(cell);
+  std::vector<double> parameters;
+  std::string value;
+  while (std::getline(ss, value, ',')) {
+    parameters.push_back(std::stod(value));
+  }
+  if (parameters.size() == 9) {
+    Eigen::Matrix3d lattice;
+    for (int i = 0; i < 9; ++i) {
+      lattice(i / 3, i % 3) = parameters[i] * Utils::Constants::bohr_per_angstrom;
+    }
+    setLattice(lattice);
+    return;
+  }
+  if (parameters.size() != 6) {
+    throw std::runtime_error("The periodic cell '" + cell +
+                             "' has neither the format a,b,c,alpha,beta,gamma nor nine lattice vector components.");
+  }
+  const double a = parameters[0] * Utils::Constants::bohr_per_angstrom;
+  const double b = parameters[1] * Utils::Constants::bohr_per_angstrom;
+  const double c = parameters[2] * Utils::Constants::bohr_per_angstrom;
+  const double cosAlpha = std::cos(parameters[3] * Utils::Constants::rad_per_degree);
+  const double cosBeta = std::cos(parameters[4] * Utils::Constants::rad_per_degree);
+  const double cosGamma = std::cos(parameters[5] * Utils::Constants::rad_per_degree);
+  const double sinGamma = std::sin(parameters[5] * Utils::Constants::rad_per_degree);
+
+  Eigen::Matrix3d lattice = Eigen::Matrix3d::Zero();
+  lattice.row(0) << a, 0.0, 0.0;
+  lattice.row(1) << b * cosGamma, b * sinGamma, 0.0;
+  const double cx = c * cosBeta;
+  const double cy = c * (cosAlpha - cosBeta * cosGamma) / sinGamma;
+  lattice.row(2) << cx, cy, std::sqrt(std::max(0.0, c * c - cx * cx - cy * cy));
+  setLattice(lattice);
+}
+
+void PeriodicCell::clear() {
+  lattice_.setZero();
+  inverseLattice_.setZero();
+  periodic_ = false;
+}
+
+bool PeriodicCell::isPeriodic() const {
+  return periodic_;
+}
+
+const Eigen::Matrix3d& PeriodicCell::getLattice() const {
+  return lattice_;
+}
+
+double PeriodicCell::getVolume() const {
+  return std::abs(lattice_.determinant());
+}
+
+Eigen::Matrix3d PeriodicCell::getReciprocalLattice() const {
+  // a_i . b_j = 2 pi delta_ij
+  return 2 * M_PI * lattice_.inverse().transpose();
+}
+
+std::vector<Eigen::Vector3d> PeriodicCell::getTranslations(double cutoff, const Utils::PositionCollection& positions) const {
+  if (!periodic_) {
+    return {Eigen::Vector3d::Zero()};
+  }
+  const Eigen::Matrix3d reciprocal = getReciprocalLattice();
+  // Spread of the fractional coordinates of the atoms
+  Eigen::Vector3d spread = Eigen::Vector3d::Zero();
+  if (positions.rows() > 0) {
+    Eigen::MatrixXd fractional = positions * reciprocal.transpose() / (2 * M_PI);
+    spread = fractional.colwise().maxCoeff() - fractional.colwise().minCoeff();
+  }
+  // The distance between the lattice planes of direction i is 2 pi / |b_i|
+  int n[3];
+  for (int i = 0; i < 3; ++i) {
+    n[i] = static_cast<int>(std::ceil(cutoff * reciprocal.row(i).norm() / (2 * M_PI) + spread[i]));
+  }
+  std::vector<Eigen::Vector3d> translations;
+  translations.reserve((2 * n[0] + 1) * (2 * n[1] + 1) * (2 * n[2] + 1));
+  for (int i = -n[0]; i <= n[0]; ++i) {
+    for (int j = -n[1]; j <= n[1]; ++j) {
+      for (int k = -n[2]; k <= n[2]; ++k) {
+        translations.emplace_back(i * lattice_.row(0) + j * lattice_.row(1) + k * lattice_.row(2));
+      }
+    }
+  }
+  return translations;
+}
+
+Eigen::Vector3d PeriodicCell::getMinimumImage(const Eigen::Vector3d& r) const {
+  if (!periodic_) {
+    return r;
+  }
+  // Fractional coordinates reduced to [-1/2, 1/2]
+  Eigen::Vector3d fractional = inverseLattice_.transpose() * r;
+  fractional -= fractional.array().round().matrix();
+  const Eigen::Vector3d reduced = lattice_.transpose() * fractional;
+  // In skewed cells, the closest image may be the one in a neighboring cell
+  Eigen::Vector3d closest = reduced;
+  for (int i = -1; i <= 1; ++i) {
+    for (int j = -1; j <= 1; ++j) {
+      for (int k = -1; k <= 1; ++k) {
+        Eigen::Vector3d image = reduced + (i * lattice_.row(0) + j * lattice_.row(1) + k * lattice_.row(2)).transpose();
+        if (image.squaredNorm() < closest.squaredNorm()) {
+          closest = image;
+        }
+      }
+    }
+  }
+  return closest;
+}
+
+std::string PeriodicCell::getFingerprint() const {
+  if (!periodic_) {
+    return "";
+  }
+  std::stringstream fingerprint;
+  fingerprint << std::setprecision(17);
+  for (int i = 0; i < 9; ++i) {
+    fingerprint << lattice_(i / 3, i % 3) << ",";
+  }
+  return fingerprint.str();
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_PERIODICCELL_H
+#define SPARROW_PERIODICCELL_H
+
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Unit cell of a structure with periodic boundary conditions in three dimensions.
+ *
+ * The calculations with a periodic cell are done at the Gamma point only: the matrix elements between two atoms are
+ * summed over all periodic images of the second atom, which requires cells large enough for the band structure to be
+ * flat, as in the usual supercells of condensed-phase simulations.
+ */
+class PeriodicCell {
+ public:
+  /**
+   * @brief Sets the lattice vectors.
+   * @param lattice The lattice vectors a, b and c as rows, in bohr.
+   */
+  void setLattice(const Eigen::Matrix3d& lattice);
+  /**
+   * @brief Sets the cell from the format of the setting "periodic_boundaries".
+   * @param cell Either "a,b,c,alpha,beta,gamma" with the lengths in angstrom and the angles in degrees, the vector a
+   *             then lies along x and b in the xy plane, or the nine components of the lattice vectors a, b and c in
+   *             angstrom. An empty string means no periodic boundaries.
+   */
+  void setFromString(const std::string& cell);
+  void clear();
+  bool isPeriodic() const;
+  //! @brief The lattice vectors as rows, in bohr.
+  const Eigen::Matrix3d& getLattice() const;
+  double getVolume() const;
+  //! @brief The reciprocal lattice vectors as rows, including the factor 2 pi.
+  Eigen::Matrix3d getReciprocalLattice() const;
+  /**
+   * @brief Lattice translations T such that |R_b - R_a + T| may be smaller than the cutoff for two atoms of the
+   *        structure, including T = 0.
+   * @param positions Positions of the atoms, not necessarily inside the cell.
+   */
+  std::vector<Eigen::Vector3d> getTranslations(double cutoff, const Utils::PositionCollection& positions) const;
+  /**
+   * @brief The shortest of the vectors r + T over all lattice translations T, i.e. the distance vector to the closest
+   *        periodic image for r = R_b - R_a. Returns r itself without periodicity.
+   */
+  Eigen::Vector3d getMinimumImage(const Eigen::Vector3d& r) const;
+  //! @brief Identifies the lattice, to check whether a stored result belongs to this cell. Empty without periodicity.
+  std::string getFingerprint() const;
+
+  /**
+   * @brief Adds the contribution of a pair term to the derivatives with respect to a homogeneous strain of the cell
+   *        and of the positions, r -> (1 + eps) r.
+   * @param pairVector The distance vector r of the pair.
+   * @param derivative The derivative of the pair term with respect to r.
+   */
+  static void addStrainDerivative(Eigen::Matrix3d& strainDerivatives, const Eigen::Vector3d& pairVector,
+                                  const Eigen::Vector3d& derivative) {
+    strainDerivatives += derivative * pairVector.transpose();
+  }
+  //! @brief Overload for second derivatives, which are not available with periodic boundaries.
+  template<class SecondDerivative>
+  static void addStrainDerivative(Eigen::Matrix3d& /*strainDerivatives*/, const Eigen::Vector3d& /*pairVector*/,
+                                  const SecondDerivative& /*derivative*/) {
+    throw std::runtime_error("Only first derivatives are available with periodic boundaries.");
+  }
+
+ private:
+  Eigen::Matrix3d lattice_ = Eigen::Matrix3d::Zero();
+  Eigen::Matrix3d inverseLattice_ = Eigen::Matrix3d::Zero();
+  bool periodic_ = false;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_PERIODICCELL_H
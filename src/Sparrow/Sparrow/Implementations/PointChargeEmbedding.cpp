@@ -0,0 +1,203 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "PointChargeEmbedding.h"
+#include <Utils/Constants.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+// Fraction of the cutoff at which the switching function starts to decay.
+constexpr double switchingOnset = 0.8;
+
+// Cells are identified by their three indices packed in 21 bits each.
+std::int64_t cellKey(std::int64_t ix, std::int64_t iy, std::int64_t iz) {
+  const std::int64_t offset = std::int64_t{1} << 20;
+  return ((ix + offset) << 42) | ((iy + offset) << 21) | (iz + offset);
+}
+} // namespace
+
+void PointChargeEmbedding::setPointCharges(Utils::PositionCollection positions, Eigen::VectorXd charges) {
+  if (positions.rows() != charges.size()) {
+    throw std::runtime_error("The numbers of point charge positions and charges differ.");
+  }
+  positions_ = std::move(positions);
+  charges_ = std::move(charges);
+  allIndices_.resize(charges_.size());
+  std::iota(allIndices_.begin(), allIndices_.end(), 0);
+  neighbors_.clear();
+  gradients_ = Utils::GradientCollection::Zero(charges_.size(), 3);
+}
+
+void PointChargeEmbedding::readPointCharges(const std::string& filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Impossible to open the point charges file " + filename + ".");
+  }
+  std::vector<Eigen::RowVector3d> positions;
+  std::vector<double> charges;
+  std::string line;
+  while (std::getline(file, line)) {
+    auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+    std::stringstream ss(line);
+    Eigen::RowVector3d r;
+    double q;
+    if (!(ss >> r.x() >> r.y() >> r.z() >> q)) {
+      throw std::runtime_error("Invalid line in the point charges file " + filename + ": " + line);
+    }
+    positions.push_back(r * Utils::Constants::bohr_per_angstrom);
+    charges.push_back(q);
+  }
+  Utils::PositionCollection positionCollection(positions.size(), 3);
+  for (unsigned i = 0; i < positions.size(); ++i) {
+    positionCollection.row(i) = positions[i];
+  }
+  setPointCharges(std::move(positionCollection), Eigen::Map<Eigen::VectorXd>(charges.data(), charges.size()));
+}
+
+void PointChargeEmbedding::clear() {
+  setPointCharges(Utils::PositionCollection(0, 3), Eigen::VectorXd(0));
+}
+
+bool PointChargeEmbedding::empty() const {
+  return charges_.size() == 0;
+}
+
+int PointChargeEmbedding::size() const {
+  return static_cast<int>(charges_.size());
+}
+
+const Utils::PositionCollection& PointChargeEmbedding::getPositions() const {
+  return positions_;
+}
+
+const Eigen::VectorXd& PointChargeEmbedding::getCharges() const {
+  return charges_;
+}
+
+void PointChargeEmbedding::setCutoff(double cutoff) {
+  cutoff_ = cutoff;
+}
+
+double PointChargeEmbedding::getCutoff() const {
+  return cutoff_;
+}
+
+double PointChargeEmbedding::getSwitching(double distance, double& derivative) const {
+  derivative = 0.0;
+  const double onset = switchingOnset * cutoff_;
+  if (cutoff_ <= 0.0 || distance <= onset) {
+    return 1.0;
+  }
+  if (distance >= cutoff_) {
+    return 0.0;
+  }
+  const double width = cutoff_ - onset;
+  const double x = (distance - onset) / width;
+  const double x2 = x * x;
+  derivative = -30.0 * x2 * (1.0 - x) * (1.0 - x) / width;
+  return 1.0 - x * x2 * (10.0 - 15.0 * x + 6.0 * x2);
+}
+
+std::string PointChargeEmbedding::getFingerprint() const {
+  if (empty()) {
+    return "";
+  }
+  // FNV-1a hash of the binary representation of the charges, positions and cutoff
+  std::uint64_t hash = 14695981039346656037ull;
+  auto add = [&hash](const double* data, Eigen::Index size) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < sizeof(double) * static_cast<std::size_t>(size); ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ull;
+    }
+  };
+  add(positions_.data(), positions_.size());
+  add(charges_.data(), charges_.size());
+  add(&cutoff_, 1);
+  std::stringstream fingerprint;
+  fingerprint << size() << ":" << std::hex << hash;
+  return fingerprint.str();
+}
+
+void PointChargeEmbedding::updateNeighbors(const Utils::PositionCollection& qmPositions) {
+  gradients_ = Utils::GradientCollection::Zero(size(), 3);
+  neighbors_.clear();
+  if (cutoff_ <= 0.0 || empty()) {
+    return;
+  }
+
+  // Cell list of the point charges
+  const Eigen::RowVector3d origin = positions_.colwise().minCoeff();
+  auto cellIndices = [&](const Eigen::RowVector3d& r) {
+    Eigen::RowVector3d scaled = (r - origin) / cutoff_;
+    return Eigen::Matrix<std::int64_t, 1, 3>(static_cast<std::int64_t>(std::floor(scaled.x())),
+                                             static_cast<std::int64_t>(std::floor(scaled.y())),
+                                             static_cast<std::int64_t>(std::floor(scaled.z())));
+  };
+  std::unordered_map<std::int64_t, std::vector<int>> cells;
+  for (int i = 0; i < size(); ++i) {
+    auto c = cellIndices(positions_.row(i));
+    cells[cellKey(c.x(), c.y(), c.z())].push_back(i);
+  }
+
+  const double squaredCutoff = cutoff_ * cutoff_;
+  neighbors_.resize(qmPositions.rows());
+#pragma omp parallel for schedule(dynamic)
+  for (int a = 0; a < static_cast<int>(qmPositions.rows()); ++a) {
+    const Eigen::RowVector3d r = qmPositions.row(a);
+    auto c = cellIndices(r);
+    auto& neighbors = neighbors_[a];
+    for (int dx = -1; dx <= 1; ++dx) {
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dz = -1; dz <= 1; ++dz) {
+          auto cell = cells.find(cellKey(c.x() + dx, c.y() + dy, c.z() + dz));
+          if (cell == cells.end()) {
+            continue;
+          }
+          for (int i : cell->second) {
+            if ((positions_.row(i) - r).squaredNorm() <= squaredCutoff) {
+              neighbors.push_back(i);
+            }
+          }
+        }
+      }
+    }
+    // Same summation order as without cutoff
+    std::sort(neighbors.begin(), neighbors.end());
+  }
+}
+
+const std::vector<int>& PointChargeEmbedding::getNeighbors(int qmAtom) const {
+  if (cutoff_ <= 0.0 || empty()) {
+    return allIndices_;
+  }
+  return neighbors_.at(qmAtom);
+}
+
+const Utils::GradientCollection& PointChargeEmbedding::getGradients() const {
+  return gradients_;
+}
+
+void PointChargeEmbedding::setGradients(Utils::GradientCollection gradients) {
+  gradients_ = std::move(gradients);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_POINTCHARGEEMBEDDING_H
+#define SPARROW_POINTCHARGEEMBEDDING_H
+
+#include <Utils/Typenames.h>
+#include <Eigen/Core>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Environment of point charges, e.g. the atoms of an MM region, for the electrostatic embedding of a QM region.
+ *
+ * This class holds the point charges, their interaction partners and the gradients on them; the interaction itself
+ * is calculated by the methods, with charge-multipole integrals in NDDO (see nddo::OneElectronMatrix) and with the
+ * interaction of the Mulliken charges with the point charges in DFTB (see dftb::ScfFock).
+ * With a positive cutoff, only the point charges within the cutoff radius of a QM atom interact with it. The
+ * neighbors are then found with a cell list of cubic cells with the cutoff as edge length, such that the cost of
+ * building the interactions scales linearly with the number of point charges. The interaction of an atom with a
+ * point charge is multiplied by the switching function of getSwitching(), which brings it smoothly to zero between
+ * 80% of the cutoff and the cutoff, such that the energy and the gradients are continuous.
+ */
+class PointChargeEmbedding {
+ public:
+  /**
+   * @brief Sets the point charges.
+   * @param positions Positions in bohr.
+   * @param charges   Charges in units of the elementary charge.
+   */
+  void setPointCharges(Utils::PositionCollection positions, Eigen::VectorXd charges);
+  /**
+   * @brief Reads the point charges from a file.
+   * Every line holds the x, y and z coordinates in Angstrom and the charge of one point charge. Empty lines and lines
+   * starting with '#' are ignored.
+   */
+  void readPointCharges(const std::string& filename);
+  void clear();
+  bool empty() const;
+  int size() const;
+  const Utils::PositionCollection& getPositions() const;
+  const Eigen::VectorXd& getCharges() const;
+  //! @brief Sets the cutoff radius in bohr. Values smaller or equal to zero mean no cutoff.
+  void setCutoff(double cutoff);
+  double getCutoff() const;
+  /**
+   * @brief Switching function of the interaction of a QM atom with a point charge.
+   * It is one up to 80% of the cutoff and decays to zero at the cutoff as a polynomial of fifth order, with vanishing
+   * first and second derivatives at both ends. Without cutoff, it is one at all distances.
+   * @param distance   Distance between the atom and the point charge in bohr.
+   * @param derivative Set to the derivative of the switching function with respect to the distance.
+   */
+  double getSwitching(double distance, double& derivative) const;
+  //! @brief Identifies the point charges and the cutoff, to check whether a stored result belongs to this environment.
+  std::string getFingerprint() const;
+
+  //! @brief Finds, for every QM atom, the point charges within the cutoff. Also resets the point charge gradients.
+  void updateNeighbors(const Utils::PositionCollection& qmPositions);
+  //! @brief Indices of the point charges interacting with a QM atom, as of the last call to updateNeighbors().
+  const std::vector<int>& getNeighbors(int qmAtom) const;
+
+  //! @brief Gradients on the point charges from the last gradient calculation of the QM method, in hartree/bohr.
+  const Utils::GradientCollection& getGradients() const;
+  void setGradients(Utils::GradientCollection gradients);
+
+ private:
+  Utils::PositionCollection positions_;
+  Eigen::VectorXd charges_;
+  double cutoff_ = 0.0;
+  // All point charges, the neighbors of every atom without cutoff
+  std::vector<int> allIndices_;
+  std::vector<std::vector<int>> neighbors_;
+  Utils::GradientCollection gradients_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_POINTCHARGEEMBEDDING_H
@@ -0,0 +1,472 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "ScfAccelerator.h"
+#include <Utils/DataStructures/MolecularOrbitals.h>
+#include <Utils/DataStructures/SingleParticleEnergies.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
+#include <Utils/Scf/MethodInterfaces/LcaoMethod.h>
+#include <Eigen/LU>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+// Boltzmann constant in hartree per kelvin
+constexpr double boltzmannConstant = 3.166811563e-6;
+// DIIS errors above which only the energy DIIS coefficients are used, and below which only the DIIS coefficients.
+constexpr double energyDiisThreshold = 1e-1;
+constexpr double diisThreshold = 1e-4;
+// DIIS error below which level shift and smearing are switched off.
+constexpr double releaseThreshold = 1e-3;
+// Number of iterations the energy DIIS coefficients are optimized for; 2^8 - 1 faces of the simplex.
+constexpr int maxEnergySubspaceSize = 8;
+
+Eigen::MatrixXd fullMatrix(const Eigen::MatrixXd& lowerTriangle) {
+  return lowerTriangle.selfadjointView<Eigen::Lower>();
+}
+
+// tr(A B) of two symmetric matrices
+double trace(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) {
+  return a.cwiseProduct(b).sum();
+}
+
+// Occupations in [0, 1] of orbitals with the given energies holding nElectrons with capacity electrons per orbital.
+Eigen::VectorXd fermiOccupations(const std::vector<double>& energies, double nElectrons, double capacity, double kT) {
+  const int nOrbitals = energies.size();
+  auto occupations = [&](double mu) {
+    Eigen::VectorXd f(nOrbitals);
+    for (int i = 0; i < nOrbitals; ++i) {
+      f[i] = 1.0 / (1.0 + std::exp((energies[i] - mu) / kT));
+    }
+    return f;
+  };
+  const auto bounds = std::minmax_element(energies.begin(), energies.end());
+  double lower = *bounds.first - 50 * kT;
+  double upper = *bounds.second + 50 * kT;
+  // The number of electrons increases monotonically with the chemical potential
+  for (int iteration = 0; iteration < 200 && upper - lower > 1e-14; ++iteration) {
+    const double mu = 0.5 * (lower + upper);
+    if (capacity * occupations(mu).sum() < nElectrons) {
+      lower = mu;
+    }
+    else {
+      upper = mu;
+    }
+  }
+  return occupations(0.5 * (lower + upper));
+}
+} // namespace
+
+ScfAccelerator::Mode ScfAccelerator::modeFromString(const std::string& mode) {
+  if (mode == "none") {
+    return Mode::None;
+  }
+  if (mode == "diis") {
+    return Mode::Diis;
+  }
+  if (mode == "ediis_diis") {
+    return Mode::EdiisDiis;
+  }
+  if (mode == "adiis_diis") {
+    return Mode::AdiisDiis;
+  }
+  throw std::runtime_error("Unknown SCF accelerator " + mode + ".");
+}
+
+void ScfAccelerator::setMode(Mode mode) {
+  mode_ = mode;
+}
+
+ScfAccelerator::Mode ScfAccelerator::getMode() const {
+  return mode_;
+}
+
+void ScfAccelerator::setSubspaceSize(int size) {
+  if (size < 2) {
+    throw std::invalid_argument("The DIIS subspace needs at least two iterations.");
+  }
+  subspaceSize_ = size;
+}
+
+int ScfAccelerator::getSubspaceSize() const {
+  return subspaceSize_;
+}
+
+void ScfAccelerator::setLevelShiftGap(double gap) {
+  levelShiftGap_ = gap;
+}
+
+double ScfAccelerator::getLevelShiftGap() const {
+  return levelShiftGap_;
+}
+
+void ScfAccelerator::setFermiTemperature(double temperature) {
+  fermiTemperature_ = temperature;
+}
+
+double ScfAccelerator::getFermiTemperature() const {
+  return fermiTemperature_;
+}
+
+void ScfAccelerator::setMethod(const Utils::LcaoMethod* method) {
+  method_ = method;
+}
+
+bool ScfAccelerator::isActive() const {
+  return mode_ != Mode::None || levelShiftGap_ > 0 || fermiTemperature_ > 0;
+}
+
+void ScfAccelerator::reset() {
+  history_.clear();
+  statistics_ = Statistics{};
+  lastError_ = 0.0;
+  lastShift_ = 0.0;
+  released_ = false;
+}
+
+const ScfAccelerator::Statistics& ScfAccelerator::getStatistics() const {
+  return statistics_;
+}
+
+double ScfAccelerator::getLastError() const {
+  return lastError_;
+}
+
+Eigen::VectorXd ScfAccelerator::minimizeOnSimplex(const Eigen::VectorXd& linear, const Eigen::MatrixXd& quadratic) {
+  const int n = linear.size();
+  if (n > 16) {
+    throw std::invalid_argument("The simplex minimization is limited to 16 dimensions.");
+  }
+  Eigen::VectorXd best = Eigen::VectorXd::Zero(n);
+  double bestValue = std::numeric_limits<double>::infinity();
+  // The minimum lies in the relative interior of one of the faces, where it is a stationary point of the Lagrangian
+  for (unsigned face = 1; face < (1u << n); ++face) {
+    std::vector<int> indices;
+    for (int i = 0; i < n; ++i) {
+      if (face & (1u << i)) {
+        indices.push_back(i);
+      }
+    }
+    const int k = indices.size();
+    Eigen::MatrixXd lagrangian = Eigen::MatrixXd::Zero(k + 1, k + 1);
+    Eigen::VectorXd rhs(k + 1);
+    for (int i = 0; i < k; ++i) {
+      for (int j = 0; j < k; ++j) {
+        lagrangian(i, j) = quadratic(indices[i], indices[j]);
+      }
+      lagrangian(i, k) = lagrangian(k, i) = 1.0;
+      rhs[i] = -linear[indices[i]];
+    }
+    rhs[k] = 1.0;
+    Eigen::FullPivLU<Eigen::MatrixXd> lu(lagrangian);
+    if (!lu.isInvertible()) {
+      // Then a minimum on this face is also attained on its boundary
+      continue;
+    }
+    const Eigen::VectorXd solution = lu.solve(rhs);
+    if (solution.head(k).minCoeff() < -1e-10) {
+      continue;
+    }
+    Eigen::VectorXd c = Eigen::VectorXd::Zero(n);
+    for (int i = 0; i < k; ++i) {
+      c[indices[i]] = std::max(solution[i], 0.0);
+    }
+    c /= c.sum();
+    const double value = linear.dot(c) + 0.5 * c.dot(quadratic * c);
+    if (value < bestValue) {
+      bestValue = value;
+      best = c;
+    }
+  }
+  return best;
+}
+
+Eigen::VectorXd ScfAccelerator::diisCoefficients(const Eigen::MatrixXd& errorProducts) {
+  const int n = errorProducts.rows();
+  // Scaling by the largest diagonal element keeps the system well conditioned close to convergence
+  const double scale = errorProducts.diagonal().maxCoeff();
+  if (!(scale > 0)) {
+    return Eigen::VectorXd::Unit(n, n - 1);
+  }
+  Eigen::MatrixXd system = Eigen::MatrixXd::Zero(n + 1, n + 1);
+  system.topLeftCorner(n, n) = errorProducts / scale;
+  system.row(n).head(n).setConstant(-1.0);
+  system.col(n).head(n).setConstant(-1.0);
+  Eigen::VectorXd rhs = Eigen::VectorXd::Zero(n + 1);
+  rhs[n] = -1.0;
+  Eigen::FullPivLU<Eigen::MatrixXd> lu(system);
+  if (!lu.isInvertible()) {
+    return {};
+  }
+  return lu.solve(rhs).head(n);
+}
+
+Eigen::VectorXd ScfAccelerator::diisCoefficients() {
+  while (true) {
+    const int n = history_.size();
+    Eigen::MatrixXd errorProducts(n, n);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j <= i; ++j) {
+        double product = 0.0;
+        for (unsigned s = 0; s < history_[i].errors.size(); ++s) {
+          product += history_[i].errors[s].cwiseProduct(history_[j].errors[s]).sum();
+        }
+        errorProducts(i, j) = errorProducts(j, i) = product;
+      }
+    }
+    Eigen::VectorXd coefficients = diisCoefficients(errorProducts);
+    if (coefficients.size() > 0 || n == 1) {
+      return coefficients.size() > 0 ? coefficients : Eigen::VectorXd::Ones(1);
+    }
+    // Linearly dependent errors: the oldest iteration is dropped
+    history_.pop_front();
+  }
+}
+
+Eigen::VectorXd ScfAccelerator::energyCoefficients() const {
+  const int n = history_.size();
+  const int m = std::min(n, maxEnergySubspaceSize);
+  const int first = n - m;
+  const Iteration& last = history_.back();
+  Eigen::VectorXd linear(m);
+  Eigen::MatrixXd quadratic(m, m);
+  for (int i = 0; i < m; ++i) {
+    const Iteration& a = history_[first + i];
+    if (mode_ == Mode::EdiisDiis) {
+      // E(c) = sum_i c_i E_i - 1/4 sum_ij c_i c_j tr((P_i - P_j) (F_i - F_j))
+      linear[i] = a.energy;
+      for (int j = 0; j < m; ++j) {
+        const Iteration& b = history_[first + j];
+        double product = 0.0;
+        for (unsigned s = 0; s < a.focks.size(); ++s) {
+          product += trace(a.densities[s] - b.densities[s], a.focks[s] - b.focks[s]);
+        }
+        quadratic(i, j) = -0.5 * product;
+      }
+    }
+    else {
+      // E(c) = E_n + sum_i c_i tr((P_i - P_n) F_n) + 1/2 sum_ij c_i c_j tr((P_i - P_n) (F_j - F_n))
+      linear[i] = 0.0;
+      for (unsigned s = 0; s < a.focks.size(); ++s) {
+        linear[i] += trace(a.densities[s] - last.densities[s], last.focks[s]);
+      }
+      for (int j = 0; j < m; ++j) {
+        const Iteration& b = history_[first + j];
+        double product = 0.0;
+        for (unsigned s = 0; s < a.focks.size(); ++s) {
+          product += trace(a.densities[s] - last.densities[s], b.focks[s] - last.focks[s]);
+        }
+        quadratic(i, j) = product;
+      }
+    }
+  }
+  if (mode_ == Mode::AdiisDiis) {
+    quadratic = 0.5 * (quadratic + quadratic.transpose()).eval();
+  }
+  Eigen::VectorXd coefficients = Eigen::VectorXd::Zero(n);
+  coefficients.tail(m) = minimizeOnSimplex(linear, quadratic);
+  return coefficients;
+}
+
+Utils::SpinAdaptedMatrix ScfAccelerator::accelerate(const Utils::SpinAdaptedMatrix& fock,
+                                                    const Utils::DensityMatrix& density,
+                                                    const Eigen::MatrixXd& overlap, double energy, bool unrestricted) {
+  ++statistics_.nIterations;
+  const Eigen::MatrixXd S = overlap.size() > 0 ? fullMatrix(overlap) : Eigen::MatrixXd();
+  Iteration iteration;
+  iteration.energy = energy;
+  if (unrestricted) {
+    iteration.focks = {fullMatrix(fock.alphaMatrix()), fullMatrix(fock.betaMatrix())};
+    iteration.densities = {density.alphaMatrix(), density.betaMatrix()};
+  }
+  else {
+    iteration.focks = {fullMatrix(fock.restrictedMatrix())};
+    iteration.densities = {density.restrictedMatrix()};
+  }
+  lastError_ = 0.0;
+  for (unsigned s = 0; s < iteration.focks.size(); ++s) {
+    const Eigen::MatrixXd& F = iteration.focks[s];
+    const Eigen::MatrixXd& P = iteration.densities[s];
+    Eigen::MatrixXd error = S.size() > 0 ? Eigen::MatrixXd(F * P * S) : Eigen::MatrixXd(F * P);
+    error -= error.transpose().eval();
+    lastError_ = std::max(lastError_, error.cwiseAbs().maxCoeff());
+    iteration.errors.push_back(std::move(error));
+  }
+  if (!history_.empty() && history_.back().focks.front().rows() != iteration.focks.front().rows()) {
+    history_.clear();
+  }
+  history_.push_back(std::move(iteration));
+  while (static_cast<int>(history_.size()) > subspaceSize_) {
+    history_.pop_front();
+  }
+
+  const bool smeared = fermiTemperature_ > 0 && !released_ && statistics_.nIterations > 1;
+  if (!released_ && lastError_ < releaseThreshold && statistics_.nIterations > 1) {
+    released_ = true;
+    if (smeared) {
+      // The previous iterations were calculated with the smeared densities
+      history_.erase(history_.begin(), history_.end() - 1);
+    }
+  }
+
+  std::vector<Eigen::MatrixXd> focks = history_.back().focks;
+  if (mode_ != Mode::None && history_.size() > 1) {
+    Eigen::VectorXd coefficients;
+    if (mode_ == Mode::Diis || lastError_ < diisThreshold) {
+      coefficients = diisCoefficients();
+    }
+    else {
+      // The DIIS coefficients come first, as linearly dependent iterations are dropped from the history
+      const Eigen::VectorXd diis = lastError_ < energyDiisThreshold ? diisCoefficients() : Eigen::VectorXd();
+      coefficients = energyCoefficients();
+      ++statistics_.nEnergyDiisIterations;
+      if (diis.size() > 0) {
+        const double weight = lastError_ / energyDiisThreshold;
+        coefficients = weight * coefficients + (1 - weight) * diis;
+      }
+    }
+    const int n = coefficients.size();
+    const int first = history_.size() - n;
+    for (unsigned s = 0; s < focks.size(); ++s) {
+      focks[s] = coefficients[0] * history_[first].focks[s];
+      for (int i = 1; i < n; ++i) {
+        focks[s] += coefficients[i] * history_[first + i].focks[s];
+      }
+    }
+  }
+  if (levelShiftGap_ > 0 && !released_ && statistics_.nIterations > 1) {
+    levelShift(focks, S);
+  }
+  else {
+    lastShift_ = 0.0;
+  }
+
+  Utils::SpinAdaptedMatrix result;
+  if (unrestricted) {
+    result.setAlphaMatrix(std::move(focks[0]));
+    result.setBetaMatrix(std::move(focks[1]));
+  }
+  else {
+    result.setRestrictedMatrix(std::move(focks[0]));
+  }
+  return result;
+}
+
+bool ScfAccelerator::previousOrbitals(int s, bool unrestricted, Eigen::MatrixXd& coefficients,
+                                      std::vector<double>& energies, std::vector<int>& occupied) const {
+  if (!method_) {
+    return false;
+  }
+  const auto& mos = method_->getMolecularOrbitals();
+  const auto& occupation = method_->getElectronicOccupation();
+  const auto& orbitalEnergies = method_->getSingleParticleEnergies();
+  if (!unrestricted) {
+    coefficients = mos.restrictedMatrix();
+    occupied = occupation.getFilledRestrictedOrbitals();
+    const auto& e = orbitalEnergies.getRestrictedEnergies();
+    energies.assign(e.data(), e.data() + e.size());
+  }
+  else {
+    coefficients = s == 0 ? mos.alphaMatrix() : mos.betaMatrix();
+    occupied = s == 0 ? occupation.getFilledAlphaOrbitals() : occupation.getFilledBetaOrbitals();
+    const auto& e = s == 0 ? orbitalEnergies.getAlphaEnergies() : orbitalEnergies.getBetaEnergies();
+    energies.assign(e.data(), e.data() + e.size());
+  }
+  return coefficients.cols() > 0 && static_cast<int>(energies.size()) == coefficients.cols();
+}
+
+void ScfAccelerator::levelShift(std::vector<Eigen::MatrixXd>& focks, const Eigen::MatrixXd& overlap) {
+  const bool unrestricted = focks.size() == 2;
+  std::vector<Eigen::MatrixXd> occupiedCoefficients(focks.size());
+  double gap = std::numeric_limits<double>::infinity();
+  for (unsigned s = 0; s < focks.size(); ++s) {
+    Eigen::MatrixXd coefficients;
+    std::vector<double> energies;
+    std::vector<int> occupied;
+    if (!previousOrbitals(s, unrestricted, coefficients, energies, occupied) ||
+        coefficients.rows() != focks[s].rows()) {
+      lastShift_ = 0.0;
+      return;
+    }
+    std::vector<bool> isOccupied(energies.size(), false);
+    occupiedCoefficients[s].resize(coefficients.rows(), occupied.size());
+    for (unsigned i = 0; i < occupied.size(); ++i) {
+      isOccupied[occupied[i]] = true;
+      occupiedCoefficients[s].col(i) = coefficients.col(occupied[i]);
+    }
+    double homo = -std::numeric_limits<double>::infinity();
+    double lumo = std::numeric_limits<double>::infinity();
+    for (unsigned i = 0; i < energies.size(); ++i) {
+      if (isOccupied[i]) {
+        homo = std::max(homo, energies[i]);
+      }
+      else {
+        lumo = std::min(lumo, energies[i]);
+      }
+    }
+    gap = std::min(gap, lumo - homo);
+  }
+  if (!std::isfinite(gap)) {
+    lastShift_ = 0.0;
+    return;
+  }
+  // The virtual orbitals of the previous iteration were raised by the previous shift
+  const double shift = std::max(levelShiftGap_ - (gap - lastShift_), 0.0);
+  lastShift_ = shift;
+  if (shift == 0.0) {
+    return;
+  }
+  ++statistics_.nLevelShiftIterations;
+  for (unsigned s = 0; s < focks.size(); ++s) {
+    const Eigen::MatrixXd sc =
+        overlap.size() > 0 ? Eigen::MatrixXd(overlap * occupiedCoefficients[s]) : occupiedCoefficients[s];
+    const Eigen::MatrixXd metric = overlap.size() > 0 ? overlap : Eigen::MatrixXd::Identity(sc.rows(), sc.rows());
+    focks[s] += shift * (metric - sc * sc.transpose());
+  }
+}
+
+const Utils::DensityMatrix& ScfAccelerator::getSmearedDensity(const Utils::DensityMatrix& density, bool unrestricted) {
+  // The orbitals are only those of the previous iteration after the first extrapolation of this SCF cycle
+  if (fermiTemperature_ <= 0 || released_ || statistics_.nIterations == 0) {
+    return density;
+  }
+  const double kT = boltzmannConstant * fermiTemperature_;
+  const int nSpins = unrestricted ? 2 : 1;
+  std::vector<Eigen::MatrixXd> densities(nSpins);
+  for (int s = 0; s < nSpins; ++s) {
+    Eigen::MatrixXd coefficients;
+    std::vector<double> energies;
+    std::vector<int> occupied;
+    if (!previousOrbitals(s, unrestricted, coefficients, energies, occupied) ||
+        coefficients.rows() != density.restrictedMatrix().rows()) {
+      return density;
+    }
+    const double capacity = unrestricted ? 1.0 : 2.0;
+    const double nElectrons = !unrestricted ? density.numberElectrons()
+                                            : s == 0 ? density.numberElectronsInAlphaMatrix()
+                                                     : density.numberElectronsInBetaMatrix();
+    const Eigen::VectorXd occupations = capacity * fermiOccupations(energies, nElectrons, capacity, kT);
+    densities[s] = coefficients * occupations.asDiagonal() * coefficients.transpose();
+  }
+  ++statistics_.nSmearingIterations;
+  if (unrestricted) {
+    smearedDensity_.setDensity(std::move(densities[0]), std::move(densities[1]), density.numberElectronsInAlphaMatrix(),
+                               density.numberElectronsInBetaMatrix());
+  }
+  else {
+    smearedDensity_.setDensity(std::move(densities[0]), density.numberElectrons());
+  }
+  return smearedDensity_;
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_SCFACCELERATOR_H
+#define SPARROW_SCFACCELERATOR_H
+
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/DataStructures/SpinAdaptedMatrix.h>
+#include <Eigen/Core>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Scine {
+
+namespace Utils {
+class LcaoMethod;
+} // namespace Utils
+
+namespace Sparrow {
+
+/**
+ * @brief Convergence acceleration of the SCF cycles of the Sparrow methods.
+ *
+ * The accelerator replaces the Fock matrix of every SCF iteration by an extrapolation from the Fock matrices, density
+ * matrices and energies of the previous iterations. It is called by the Fock matrix calculators after the
+ * density-dependent part has been evaluated, and replaces the mixer of the SCF method. Three extrapolations are
+ * available:
+ *  - Diis: Pulay's DIIS, minimizing the norm of the commutator F P S - S P F of the extrapolated matrices.
+ *  - EdiisDiis: the energy DIIS of Kudin, Scuseria and Cancès (J. Chem. Phys. 116, 8255, 2002), which minimizes the
+ *    energy of a convex combination of the densities, interpolated with a quadratic model, far from convergence.
+ *  - AdiisDiis: the augmented Roothaan-Hall energy DIIS of Hu and Yang (J. Chem. Phys. 132, 054109, 2010), which
+ *    minimizes the second-order expansion of the energy around the last density.
+ * In the two combined modes, the energy coefficients are used as long as the largest element of the DIIS error is
+ * above 0.1, the DIIS coefficients below 1e-4, and w c_E + (1 - w) c_DIIS with w = 10 * error in between (Garza and
+ * Scuseria, J. Chem. Phys. 137, 054110, 2012). The energy coefficients minimize over the convex hull of the last
+ * eight iterations, which is done exactly by solving the stationarity conditions on every face of the simplex.
+ *
+ * Two modifications of the extrapolated Fock matrix help when the aufbau occupation oscillates:
+ *  - Level shifting: if the HOMO-LUMO gap of the previous iteration falls below the target gap, the virtual orbitals
+ *    of the previous iteration are raised by the missing difference, F += sigma (S - S C_occ C_occ^T S).
+ *  - Fermi smearing: the atomic charges of the DFTB methods are calculated from the density with Fermi occupations
+ *    of the orbitals of the previous iteration at the given electronic temperature, see getSmearedDensity().
+ * Both are switched off for the rest of the SCF cycle once the DIIS error falls below 1e-3, such that the converged
+ * density, energy and orbital energies are those of the unmodified method.
+ */
+class ScfAccelerator {
+ public:
+  enum class Mode { None, Diis, EdiisDiis, AdiisDiis };
+  //! @brief Counts of the SCF cycle since the last reset().
+  struct Statistics {
+    //! Number of extrapolated Fock matrices, i.e. of SCF iterations
+    int nIterations = 0;
+    //! Iterations with a nonzero weight of the energy DIIS coefficients
+    int nEnergyDiisIterations = 0;
+    //! Iterations with a level shift
+    int nLevelShiftIterations = 0;
+    //! Iterations with Fermi smearing of the density
+    int nSmearingIterations = 0;
+  };
+
+  //! @brief Mode from the values of the setting "scf_accelerator": "none", "diis", "ediis_diis" or "adiis_diis".
+  static Mode modeFromString(const std::string& mode);
+  /**
+   * @brief Minimizes g^T c + 1/2 c^T H c over the simplex c_i >= 0, sum_i c_i = 1.
+   * All faces of the simplex are searched, the cost is exponential in the size of g.
+   */
+  static Eigen::VectorXd minimizeOnSimplex(const Eigen::VectorXd& linear, const Eigen::MatrixXd& quadratic);
+  /**
+   * @brief DIIS coefficients minimizing c^T B c with sum_i c_i = 1.
+   * @return An empty vector if the system is singular.
+   */
+  static Eigen::VectorXd diisCoefficients(const Eigen::MatrixXd& errorProducts);
+
+  void setMode(Mode mode);
+  Mode getMode() const;
+  //! @brief Number of iterations kept for the DIIS extrapolation, at least 2.
+  void setSubspaceSize(int size);
+  int getSubspaceSize() const;
+  //! @brief Target HOMO-LUMO gap of the level shift in hartree, 0 for no level shift.
+  void setLevelShiftGap(double gap);
+  double getLevelShiftGap() const;
+  //! @brief Electronic temperature of the Fermi smearing in kelvin, 0 for no smearing.
+  void setFermiTemperature(double temperature);
+  double getFermiTemperature() const;
+  //! @brief Sets the method whose orbitals of the previous iteration are used for level shift and smearing.
+  void setMethod(const Utils::LcaoMethod* method);
+  //! @brief Whether the accelerator modifies the Fock matrix or the density at all.
+  bool isActive() const;
+
+  //! @brief Starts a new SCF cycle: clears the history and the statistics.
+  void reset();
+  /**
+   * @brief Density with Fermi occupations of the orbitals of the previous iteration.
+   * @return The given density if there is no smearing in this iteration.
+   */
+  const Utils::DensityMatrix& getSmearedDensity(const Utils::DensityMatrix& density, bool unrestricted);
+  /**
+   * @brief Adds an iteration to the history and returns the extrapolated Fock matrix.
+   * @param fock    The Fock matrix of the density, only its lower triangle is read.
+   * @param density The density the Fock matrix was calculated from.
+   * @param overlap The overlap matrix, only its lower triangle is read. Empty for orthogonal basis sets.
+   * @param energy  The electronic energy of the density.
+   * @return The full, symmetric extrapolated Fock matrix.
+   */
+  Utils::SpinAdaptedMatrix accelerate(const Utils::SpinAdaptedMatrix& fock, const Utils::DensityMatrix& density,
+                                      const Eigen::MatrixXd& overlap, double energy, bool unrestricted);
+  const Statistics& getStatistics() const;
+  //! @brief Largest element of the DIIS error of the last iteration.
+  double getLastError() const;
+
+ private:
+  struct Iteration {
+    // Restricted, or alpha and beta matrices
+    std::vector<Eigen::MatrixXd> focks;
+    std::vector<Eigen::MatrixXd> densities;
+    std::vector<Eigen::MatrixXd> errors;
+    double energy;
+  };
+  Eigen::VectorXd diisCoefficients();
+  // Energy DIIS coefficients of the last iterations, the older ones are zero.
+  Eigen::VectorXd energyCoefficients() const;
+  // Adds the level shift of the virtual orbitals of the previous iteration.
+  void levelShift(std::vector<Eigen::MatrixXd>& focks, const Eigen::MatrixXd& overlap);
+  // Orbital coefficients, energies and occupation of the previous iteration for spin channel s.
+  bool previousOrbitals(int s, bool unrestricted, Eigen::MatrixXd& coefficients, std::vector<double>& energies,
+                        std::vector<int>& occupied) const;
+
+  Mode mode_ = Mode::None;
+  int subspaceSize_ = 8;
+  double levelShiftGap_ = 0.0;
+  double fermiTemperature_ = 0.0;
+  const Utils::LcaoMethod* method_ = nullptr;
+  // Most recent iteration last
+  std::deque<Iteration> history_;
+  Statistics statistics_;
+  double lastError_ = 0.0;
+  double lastShift_ = 0.0;
+  // Level shift and smearing are switched off for the rest of the SCF cycle
+  bool released_ = false;
+  Utils::DensityMatrix smearedDensity_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_SCFACCELERATOR_H
@@ -0,0 +1,139 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "SparrowSettingPopulator.h"
+
+namespace Scine {
+namespace Sparrow {
+
+void SparrowSettingPopulator::populateScfMethodSettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                                        bool fermiSmearing) {
+  populateFragmentGuessSettings(settings);
+  populateScfAcceleratorSettings(settings, fermiSmearing);
+  populateStateSettings(settings);
+  populateBondOrderSettings(settings);
+  populateDensityExtrapolationSettings(settings);
+  populateEmbeddingSettings(settings);
+}
+
+void SparrowSettingPopulator::populateMixedPrecisionSettings(Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::BoolDescriptor mixedPrecisionScf(
+      "Accumulates the two-electron matrix in single precision in the early SCF iterations.");
+  mixedPrecisionScf.setDefaultValue(false);
+  settings.push_back(SparrowSettingsNames::mixedPrecisionScf, std::move(mixedPrecisionScf));
+
+  Utils::UniversalSettings::DoubleDescriptor mixedPrecisionHandOff(
+      "Density RMSD between two SCF iterations below which the mixed-precision SCF switches to double precision.");
+  mixedPrecisionHandOff.setMinimum(0.0);
+  mixedPrecisionHandOff.setDefaultValue(1e-4);
+  settings.push_back(SparrowSettingsNames::mixedPrecisionHandOff, std::move(mixedPrecisionHandOff));
+}
+
+void SparrowSettingPopulator::populateFragmentGuessSettings(Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::BoolDescriptor fragmentDensityGuess(
+      "Builds the initial density matrix from the densities of separately converged fragments.");
+  fragmentDensityGuess.setDefaultValue(false);
+  settings.push_back(SparrowSettingsNames::fragmentDensityGuess, std::move(fragmentDensityGuess));
+
+  Utils::UniversalSettings::IntDescriptor maxFragmentSize(
+      "Maximal number of heavy atoms in a fragment of the fragment density guess.");
+  maxFragmentSize.setMinimum(1);
+  maxFragmentSize.setDefaultValue(16);
+  settings.push_back(SparrowSettingsNames::maxFragmentSize, std::move(maxFragmentSize));
+}
+
+void SparrowSettingPopulator::populateScfAcceleratorSettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                                             bool fermiSmearing) {
+  Utils::UniversalSettings::OptionListDescriptor scfAccelerator(
+      "SCF convergence accelerator replacing the mixer: DIIS, or energy DIIS (EDIIS or ADIIS) blended into DIIS.");
+  scfAccelerator.addOption("none");
+  scfAccelerator.addOption("diis");
+  scfAccelerator.addOption("ediis_diis");
+  scfAccelerator.addOption("adiis_diis");
+  scfAccelerator.setDefaultOption("none");
+  settings.push_back(SparrowSettingsNames::scfAccelerator, std::move(scfAccelerator));
+
+  Utils::UniversalSettings::DoubleDescriptor levelShiftGap(
+      "Target HOMO-LUMO gap in hartree of the level shift in the early SCF iterations, 0 for none.");
+  levelShiftGap.setMinimum(0.0);
+  levelShiftGap.setDefaultValue(0.0);
+  settings.push_back(SparrowSettingsNames::levelShiftGap, std::move(levelShiftGap));
+
+  if (fermiSmearing) {
+    Utils::UniversalSettings::DoubleDescriptor fermiTemperature(
+        "Electronic temperature in kelvin of the Fermi smearing in the early SCF iterations, 0 for none.");
+    fermiTemperature.setMinimum(0.0);
+    fermiTemperature.setDefaultValue(0.0);
+    settings.push_back(SparrowSettingsNames::fermiTemperature, std::move(fermiTemperature));
+  }
+}
+
+void SparrowSettingPopulator::populateStateSettings(Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::BoolDescriptor stateSnapshots(
+      "Stores the converged orbitals, Fock matrix and results in the calculation states for instant restarts.");
+  stateSnapshots.setDefaultValue(false);
+  settings.push_back(SparrowSettingsNames::stateSnapshots, std::move(stateSnapshots));
+
+  Utils::UniversalSettings::StringDescriptor checkpointFile(
+      "File from which the converged state is restored and to which it is saved after every calculation, empty for "
+      "none.");
+  checkpointFile.setDefaultValue("");
+  settings.push_back(SparrowSettingsNames::checkpointFile, std::move(checkpointFile));
+}
+
+void SparrowSettingPopulator::populateBondOrderSettings(Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::BoolDescriptor screenedBondOrders(
+      "Restricts the bond order matrix to pairs of atoms with overlapping orbitals, the other orders are zero. "
+      "Otherwise, the bond orders of all atom pairs are evaluated.");
+  screenedBondOrders.setDefaultValue(true);
+  settings.push_back(SparrowSettingsNames::screenedBondOrders, std::move(screenedBondOrders));
+}
+
+void SparrowSettingPopulator::populateDensityExtrapolationSettings(
+    Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::OptionListDescriptor densityExtrapolation(
+      "Extrapolation of the initial density matrix from the previous geometries of a trajectory or optimization.");
+  densityExtrapolation.addOption("none");
+  densityExtrapolation.addOption("aspc");
+  densityExtrapolation.addOption("lowdin");
+  densityExtrapolation.setDefaultOption("none");
+  settings.push_back(SparrowSettingsNames::densityExtrapolation, std::move(densityExtrapolation));
+
+  Utils::UniversalSettings::IntDescriptor extrapolationOrder(
+      "Order of the density extrapolation, using the densities of order + 2 previous geometries.");
+  extrapolationOrder.setMinimum(0);
+  extrapolationOrder.setMaximum(8);
+  extrapolationOrder.setDefaultValue(2);
+  settings.push_back(SparrowSettingsNames::extrapolationOrder, std::move(extrapolationOrder));
+}
+
+void SparrowSettingPopulator::populateEmbeddingSettings(Utils::UniversalSettings::DescriptorCollection& settings) {
+  Utils::UniversalSettings::StringDescriptor pointChargesFile(
+      "File with the point charges embedding the molecule, one 'x y z q' line in angstrom per charge.");
+  pointChargesFile.setDefaultValue("");
+  settings.push_back(SparrowSettingsNames::pointChargesFile, std::move(pointChargesFile));
+
+  Utils::UniversalSettings::DoubleDescriptor pointChargesCutoff(
+      "Cutoff radius in bohr for the interaction of an atom with the point charges, 0 for no cutoff. The interaction "
+      "is smoothly switched off between 80% of the cutoff and the cutoff.");
+  pointChargesCutoff.setMinimum(0.0);
+  pointChargesCutoff.setDefaultValue(0.0);
+  settings.push_back(SparrowSettingsNames::pointChargesCutoff, std::move(pointChargesCutoff));
+}
+
+void SparrowSettingPopulator::populatePeriodicBoundarySettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                                               const std::string& treatment) {
+  Utils::UniversalSettings::StringDescriptor periodicBoundaries(
+      "Periodic cell as 'a,b,c,alpha,beta,gamma' in angstrom and degrees or as the nine components of the lattice "
+      "vectors in angstrom, empty for none. " +
+      treatment);
+  periodicBoundaries.setDefaultValue("");
+  settings.push_back(SparrowSettingsNames::periodicBoundaries, std::move(periodicBoundaries));
+}
+
+} // namespace Sparrow
+} // namespace Scine
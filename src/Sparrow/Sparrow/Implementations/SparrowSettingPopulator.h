@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_SPARROWSETTINGPOPULATOR_H
+#define SPARROW_SPARROWSETTINGPOPULATOR_H
+
+#include <Utils/Settings.h>
+#include <string>
+
+namespace Scine {
+namespace Sparrow {
+
+//! @brief The names of the settings that the Sparrow methods add to the ones of Utils::SettingsNames.
+namespace SparrowSettingsNames {
+static constexpr const char* mixedPrecisionScf = "mixed_precision_scf";
+static constexpr const char* mixedPrecisionHandOff = "mixed_precision_handoff";
+static constexpr const char* fragmentDensityGuess = "fragment_density_guess";
+static constexpr const char* maxFragmentSize = "max_fragment_size";
+static constexpr const char* scfAccelerator = "scf_accelerator";
+static constexpr const char* levelShiftGap = "level_shift_gap";
+static constexpr const char* fermiTemperature = "fermi_temperature";
+static constexpr const char* stateSnapshots = "state_snapshots";
+static constexpr const char* checkpointFile = "checkpoint_file";
+static constexpr const char* screenedBondOrders = "screened_bond_orders";
+static constexpr const char* densityExtrapolation = "density_extrapolation";
+static constexpr const char* extrapolationOrder = "extrapolation_order";
+static constexpr const char* pointChargesFile = "point_charges_file";
+static constexpr const char* pointChargesCutoff = "point_charges_cutoff";
+static constexpr const char* periodicBoundaries = "periodic_boundaries";
+} // namespace SparrowSettingsNames
+
+/**
+ * @class SparrowSettingPopulator SparrowSettingPopulator.h
+ * @brief Adds the settings shared by the Sparrow methods, complementing Utils::UniversalSettings::SettingPopulator.
+ */
+class SparrowSettingPopulator {
+ public:
+  //! @brief Adds the settings of all the SCF methods: guesses, accelerators, states, bond orders and embedding.
+  static void populateScfMethodSettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                        bool fermiSmearing);
+  //! @brief Adds the single-precision accumulation of the two-electron matrix of the NDDO methods.
+  static void populateMixedPrecisionSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  //! @brief Adds the fragment density guess.
+  static void populateFragmentGuessSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  //! @brief Adds the SCF accelerator and its level shift, and the Fermi smearing if fermiSmearing is true.
+  static void populateScfAcceleratorSettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                             bool fermiSmearing);
+  //! @brief Adds the state snapshots and the checkpoint file.
+  static void populateStateSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  //! @brief Adds the screening of the bond order matrix.
+  static void populateBondOrderSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  //! @brief Adds the extrapolation of the initial density along a trajectory.
+  static void populateDensityExtrapolationSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  //! @brief Adds the point charges of the electrostatic embedding.
+  static void populateEmbeddingSettings(Utils::UniversalSettings::DescriptorCollection& settings);
+  /**
+   * @brief Adds the periodic cell.
+   * @param treatment Sentence appended to the description, stating how the method handles the periodicity.
+   */
+  static void populatePeriodicBoundarySettings(Utils::UniversalSettings::DescriptorCollection& settings,
+                                               const std::string& treatment);
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_SPARROWSETTINGPOPULATOR_H
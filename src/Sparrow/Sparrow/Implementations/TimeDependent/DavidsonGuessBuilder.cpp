@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#include "DavidsonGuessBuilder.h"
+#include <Utils/Math/IterativeDiagonalizer/SigmaVectorEvaluator.h>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+Eigen::MatrixXd DavidsonGuessBuilder::diagonalGuess(const Eigen::VectorXd& diagonal, int nGuessVectors,
+                                                    const Eigen::Matrix<bool, -1, 1>& isBeta) {
+  assert(isBeta.size() == 0 || isBeta.size() == diagonal.size());
+  const int nConfigurations = diagonal.size();
+  std::vector<int> order(nConfigurations);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return diagonal(a) < diagonal(b); });
+
+  // Extend the guess to the whole group of degenerate configurations of the last guess vector.
+  int nVectors = std::min(std::max(nGuessVectors, 1), nConfigurations);
+  while (nVectors > 0 && nVectors < nConfigurations &&
+         diagonal(order[nVectors]) - diagonal(order[nVectors - 1]) < degeneracyThreshold_) {
+    ++nVectors;
+  }
+
+  const double invSqrt2 = 1.0 / std::sqrt(2.0);
+  Eigen::MatrixXd guess = Eigen::MatrixXd::Zero(nConfigurations, nVectors);
+  int column = 0;
+  int groupStart = 0;
+  while (groupStart < nVectors) {
+    int groupEnd = groupStart + 1;
+    while (groupEnd < nVectors && diagonal(order[groupEnd]) - diagonal(order[groupEnd - 1]) < degeneracyThreshold_) {
+      ++groupEnd;
+    }
+    std::vector<int> alpha, beta;
+    for (int k = groupStart; k < groupEnd; ++k) {
+      (isBeta.size() != 0 && isBeta(order[k]) ? beta : alpha).push_back(order[k]);
+    }
+    // Degenerate alpha and beta configurations are spin-adapted, the others are kept as unit vectors.
+    const int nPairs = static_cast<int>(std::min(alpha.size(), beta.size()));
+    for (int pair = 0; pair < nPairs; ++pair) {
+      guess(alpha[pair], column) = guess(beta[pair], column) = invSqrt2;
+      ++column;
+      guess(alpha[pair], column) = invSqrt2;
+      guess(beta[pair], column) = -invSqrt2;
+      ++column;
+    }
+    for (int k = nPairs; k < static_cast<int>(alpha.size()); ++k) {
+      guess(alpha[k], column++) = 1.0;
+    }
+    for (int k = nPairs; k < static_cast<int>(beta.size()); ++k) {
+      guess(beta[k], column++) = 1.0;
+    }
+    groupStart = groupEnd;
+  }
+  assert(column == nVectors);
+  return guess;
+}
+
+Eigen::MatrixXd DavidsonGuessBuilder::subspaceGuess(Utils::SigmaVectorEvaluator& evaluator,
+                                                    const Eigen::VectorXd& diagonal, int nGuessVectors,
+                                                    int subspaceDimension, const Eigen::Matrix<bool, -1, 1>& isBeta) {
+  const int nConfigurations = diagonal.size();
+  nGuessVectors = std::min(std::max(nGuessVectors, 1), nConfigurations);
+  const Eigen::MatrixXd subspace =
+      diagonalGuess(diagonal, std::min(std::max(subspaceDimension, nGuessVectors), nConfigurations), isBeta);
+
+  // The subspace is orthonormal, its projected matrix is diagonalized as a standard eigenvalue problem.
+  Eigen::MatrixXd subspaceMatrix = subspace.transpose() * evaluator.evaluate(subspace);
+  evaluator.collapsed(0);
+  subspaceMatrix = 0.5 * (subspaceMatrix + subspaceMatrix.transpose()).eval();
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(subspaceMatrix);
+  return subspace * solver.eigenvectors().leftCols(nGuessVectors);
+}
+
+int DavidsonGuessBuilder::defaultSubspaceDimension(int nGuessVectors, int nConfigurations) {
+  return std::min(std::max(2 * nGuessVectors, nGuessVectors + 10), nConfigurations);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_DAVIDSONGUESSBUILDER_H
+#define SPARROW_DAVIDSONGUESSBUILDER_H
+
+#include <Eigen/Core>
+
+namespace Scine {
+namespace Utils {
+class SigmaVectorEvaluator;
+} // namespace Utils
+namespace Sparrow {
+
+/**
+ * @brief Builds the initial guess vectors of the Davidson diagonalizer of linear response methods.
+ * @class DavidsonGuessBuilder @file DavidsonGuessBuilder.h
+ *
+ * The guesses are built from the diagonal of the response matrix, given in the order of the Davidson problem:
+ * - the diagonal guess consists of the unit vectors of the lowest diagonal elements. Groups of degenerate diagonal
+ *   elements are never split, such that the subspace does not depend on the order of degenerate configurations.
+ *   In the unrestricted case, degenerate alpha and beta configurations are combined into the spin-adapted
+ *   combinations (alpha + beta) / sqrt(2) and (alpha - beta) / sqrt(2).
+ * - the subspace guess diagonalizes the response matrix exactly in the space spanned by the diagonal guess of a
+ *   larger dimension and returns the lowest eigenvectors, which already contain the coupling between the
+ *   configurations.
+ */
+class DavidsonGuessBuilder {
+ public:
+  /**
+   * @brief Generates the unit vectors of the lowest diagonal elements.
+   * @param diagonal The diagonal of the response matrix.
+   * @param nGuessVectors The minimal number of guess vectors, more are returned if the last ones are degenerate.
+   * @param isBeta Whether the configurations are beta excitations, empty in the restricted case.
+   * @return The orthonormal guess vectors as columns.
+   */
+  static Eigen::MatrixXd diagonalGuess(const Eigen::VectorXd& diagonal, int nGuessVectors,
+                                       const Eigen::Matrix<bool, -1, 1>& isBeta = {});
+  /**
+   * @brief Generates the lowest eigenvectors of the response matrix in the space of the diagonal guess.
+   * The sigma vectors of the subspace are evaluated with the given evaluator, which is collapsed afterwards so that
+   * it can be passed to the Davidson diagonalizer.
+   * @param evaluator The sigma vector evaluator of the response matrix.
+   * @param diagonal The diagonal of the response matrix.
+   * @param nGuessVectors The number of guess vectors.
+   * @param subspaceDimension The minimal dimension of the subspace that is diagonalized.
+   * @param isBeta Whether the configurations are beta excitations, empty in the restricted case.
+   * @return The orthonormal guess vectors as columns.
+   */
+  static Eigen::MatrixXd subspaceGuess(Utils::SigmaVectorEvaluator& evaluator, const Eigen::VectorXd& diagonal,
+                                       int nGuessVectors, int subspaceDimension,
+                                       const Eigen::Matrix<bool, -1, 1>& isBeta = {});
+  /**
+   * @brief Default dimension of the subspace guess for the given number of guess vectors.
+   */
+  static int defaultSubspaceDimension(int nGuessVectors, int nConfigurations);
+
+ private:
+  // Difference in Hartree below which two diagonal elements are degenerate.
+  static constexpr const double degeneracyThreshold_ = 1e-6;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_DAVIDSONGUESSBUILDER_H
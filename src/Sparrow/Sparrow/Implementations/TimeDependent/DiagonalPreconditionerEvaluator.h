@@ -35,6 +35,7 @@ class DiagonalPreconditionerEvaluator final : public Utils::PreconditionerEvalua
  public:
   /**
    * @brief The constructor generates a preconditioner from an ordered energy difference vector.
+   * Any ordered approximation of the diagonal can be given instead, e.g. the diagonal including the coupling.
    */
   explicit DiagonalPreconditionerEvaluator(const Eigen::VectorXd& energyDifferenceVector);
   /**
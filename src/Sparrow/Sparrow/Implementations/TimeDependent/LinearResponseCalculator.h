@@ -8,8 +8,13 @@
 #define SPARROW_LINEARRESPONSECALCULATOR_H
 
 #include <Core/Interfaces/CalculatorWithReference.h>
+#include <Utils/Typenames.h>
+#include <vector>
 
 namespace Scine {
+namespace Utils {
+enum class SpinTransition;
+} // namespace Utils
 namespace Sparrow {
 
 class LinearResponseCalculator : public Core::CalculatorWithReference {
@@ -17,6 +22,12 @@ class LinearResponseCalculator : public Core::CalculatorWithReference {
   struct GuessSpecifier {
     Eigen::MatrixXd singlet, triplet, unrestricted;
   };
+  /**
+   * @brief Davidson iteration at which every root of the spin blocks of the last calculation converged.
+   */
+  struct IterationCounts {
+    std::vector<int> singlet, triplet, unrestricted;
+  };
   ~LinearResponseCalculator() override = default;
   /**
    * @brief Sets the guess to be used in the next calculation. If empty, diagonal dominant guess will be used.
@@ -26,6 +37,19 @@ class LinearResponseCalculator : public Core::CalculatorWithReference {
    * @brief Returns the guess in the full singles space (no pruning)
    */
   virtual auto getGuess() const -> std::shared_ptr<GuessSpecifier> = 0;
+  /**
+   * @brief Returns the iteration counts per root of the last calculation, empty for the spin blocks not solved
+   * with the Davidson solver.
+   */
+  virtual auto getIterationCounts() const -> const IterationCounts& = 0;
+  /**
+   * @brief Returns the analytical gradients of the energy of an excited state of the last calculation.
+   * The gradients are the ones of the reference calculation plus the ones of the excitation energy, with the orbital
+   * relaxation from the Z-vector equations. The last reference calculation must have included the gradients.
+   * @param root The index of the excited state in increasing energy order, starting from 0.
+   * @param spinBlock The spin block of the excited state, singlet or triplet.
+   */
+  virtual Utils::GradientCollection getExcitedStateGradients(int root, Utils::SpinTransition spinBlock) = 0;
 };
 } // namespace Sparrow
 } // namespace Scine
@@ -62,6 +62,27 @@ class LinearResponseSettings : public Utils::Settings {
     gepAlgorithm.addOption("simultaneous_diag");
     gepAlgorithm.setDefaultOption("standard");
 
+    Utils::UniversalSettings::OptionListDescriptor davidsonGuess(
+        "Initial guess of the Davidson solver if none is given: unit vectors of the lowest orbital energy "
+        "differences, unit vectors of the lowest diagonal elements including the coupling, or the lowest "
+        "eigenvectors of the matrix in a small subspace of the latter.");
+    davidsonGuess.addOption("energy_differences");
+    davidsonGuess.addOption("diagonal");
+    davidsonGuess.addOption("subspace");
+    davidsonGuess.setDefaultOption("diagonal");
+
+    Utils::UniversalSettings::IntDescriptor guessSubspaceDimension(
+        "Dimension of the subspace of the subspace guess, chosen from the number of roots if 0.");
+    guessSubspaceDimension.setMinimum(0);
+    guessSubspaceDimension.setDefaultValue(0);
+
+    Utils::UniversalSettings::OptionListDescriptor preconditioner(
+        "Diagonal of the preconditioner of the Davidson solver: the orbital energy differences or the diagonal "
+        "including the coupling.");
+    preconditioner.addOption("energy_differences");
+    preconditioner.addOption("coupled_diagonal");
+    preconditioner.setDefaultOption("coupled_diagonal");
+
     _fields.push_back(Utils::SettingsNames::numberOfEigenstates, std::move(numberOfEigenstates));
     _fields.push_back(Utils::SettingsNames::initialSubspaceDimension, std::move(initialSubspaceDimension));
     _fields.push_back(Utils::SettingsNames::spinBlock, std::move(spinBlock));
@@ -69,6 +90,9 @@ class LinearResponseSettings : public Utils::Settings {
     _fields.push_back(Utils::SettingsNames::maxDavidsonIterations, std::move(maxDavidsonIterations));
     _fields.push_back(convergence, std::move(convergenceCriterionDavidson));
     _fields.push_back("gep_algo", std::move(gepAlgorithm));
+    _fields.push_back("davidson_guess", std::move(davidsonGuess));
+    _fields.push_back("guess_subspace_dimension", std::move(guessSubspaceDimension));
+    _fields.push_back("preconditioner", std::move(preconditioner));
 
     resetToDefaults();
   }
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#include "RootConvergenceMonitor.h"
+#include <Core/Log.h>
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cassert>
+
+namespace Scine {
+namespace Sparrow {
+
+RootConvergenceMonitor::RootConvergenceMonitor(std::unique_ptr<Utils::SigmaVectorEvaluator> evaluator,
+                                               int numberOfRoots, double residualTolerance,
+                                               std::vector<int>& convergenceIterations)
+  : evaluator_(std::move(evaluator)),
+    numberOfRoots_(numberOfRoots),
+    residualTolerance_(residualTolerance),
+    convergenceIterations_(convergenceIterations) {
+  convergenceIterations_.assign(numberOfRoots_, 0);
+}
+
+const Eigen::MatrixXd& RootConvergenceMonitor::evaluate(const Eigen::MatrixXd& guessVectors) const {
+  const Eigen::MatrixXd& sigmaVectors = evaluator_->evaluate(guessVectors);
+  ++iteration_;
+  update(guessVectors, sigmaVectors);
+  return sigmaVectors;
+}
+
+void RootConvergenceMonitor::collapsed(int newSubspaceDimension) {
+  evaluator_->collapsed(newSubspaceDimension);
+  overlap_ = Eigen::MatrixXd(0, 0);
+  subspaceMatrix_ = Eigen::MatrixXd(0, 0);
+}
+
+int RootConvergenceMonitor::getNumberOfIterations() const {
+  return iteration_;
+}
+
+void RootConvergenceMonitor::finalize() const {
+  for (auto& iteration : convergenceIterations_) {
+    if (iteration == 0) {
+      iteration = iteration_;
+    }
+  }
+}
+
+void RootConvergenceMonitor::print(Core::Log& log) const {
+  log.output << "Davidson iterations to convergence per root:";
+  for (const auto& iteration : convergenceIterations_) {
+    log.output << " " << iteration;
+  }
+  log.output << Core::Log::endl;
+}
+
+void RootConvergenceMonitor::update(const Eigen::MatrixXd& guessVectors, const Eigen::MatrixXd& sigmaVectors) const {
+  const int dimension = guessVectors.cols();
+  const int previousDimension = overlap_.cols();
+  const int newVectors = dimension - previousDimension;
+  assert(newVectors >= 0);
+
+  // The guess vectors of previous iterations are unchanged, only the new rows and columns are formed.
+  overlap_.conservativeResize(dimension, dimension);
+  subspaceMatrix_.conservativeResize(dimension, dimension);
+  overlap_.rightCols(newVectors) = guessVectors.transpose() * guessVectors.rightCols(newVectors);
+  overlap_.bottomLeftCorner(newVectors, previousDimension) =
+      overlap_.topRightCorner(previousDimension, newVectors).transpose();
+  subspaceMatrix_.rightCols(newVectors) = guessVectors.transpose() * sigmaVectors.rightCols(newVectors);
+  subspaceMatrix_.bottomLeftCorner(newVectors, previousDimension) =
+      subspaceMatrix_.topRightCorner(previousDimension, newVectors).transpose();
+
+  // Canonical orthogonalization of the generally non-orthogonal guess vectors: X = U s^{-1/2}.
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> overlapSolver(overlap_);
+  const Eigen::VectorXd& overlapEigenvalues = overlapSolver.eigenvalues();
+  const double threshold = linearDependenceThreshold_ * overlapEigenvalues.cwiseAbs().maxCoeff();
+  const int nDependent = static_cast<int>((overlapEigenvalues.array() <= threshold).count());
+  const int nIndependent = dimension - nDependent;
+  const int nRoots = std::min(numberOfRoots_, nIndependent);
+  if (nRoots == 0) {
+    return;
+  }
+  // The eigenvalues are in increasing order, the linearly dependent directions come first.
+  const Eigen::MatrixXd transformation =
+      overlapSolver.eigenvectors().rightCols(nIndependent) *
+      overlapEigenvalues.tail(nIndependent).cwiseSqrt().cwiseInverse().asDiagonal();
+  const Eigen::MatrixXd orthogonalMatrix =
+      transformation.transpose() * subspaceMatrix_.selfadjointView<Eigen::Upper>() * transformation;
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(orthogonalMatrix);
+  const Eigen::MatrixXd coefficients = transformation * solver.eigenvectors().leftCols(nRoots);
+
+  // r_k = A V y_k - l_k V y_k
+  Eigen::MatrixXd residuals = sigmaVectors * coefficients;
+  residuals -= (guessVectors * coefficients) * solver.eigenvalues().head(nRoots).asDiagonal();
+  for (int root = 0; root < nRoots; ++root) {
+    if (convergenceIterations_[root] == 0 && residuals.col(root).norm() < residualTolerance_) {
+      convergenceIterations_[root] = iteration_;
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_ROOTCONVERGENCEMONITOR_H
+#define SPARROW_ROOTCONVERGENCEMONITOR_H
+
+#include <Utils/Math/IterativeDiagonalizer/SigmaVectorEvaluator.h>
+#include <Eigen/Core>
+#include <memory>
+#include <vector>
+
+namespace Scine {
+namespace Core {
+class Log;
+} // namespace Core
+namespace Sparrow {
+
+/**
+ * @brief Sigma vector evaluator recording the Davidson iteration at which every root converges.
+ * @class RootConvergenceMonitor @file RootConvergenceMonitor.h
+ *
+ * The Davidson diagonalizer only reports the converged eigenpairs, this decorator forwards the evaluation of the
+ * sigma vectors to the wrapped evaluator and repeats the Rayleigh-Ritz step of every iteration on the side.
+ * The projected matrices V^T V and V^T A V are extended by the new guess vectors only and reset at subspace collapse.
+ * A root is converged from the first iteration in which the norm of its residual A x - l x falls below the tolerance.
+ * Iterations are counted as evaluations of sigma vectors, i.e. the first iteration is the one of the initial guess.
+ */
+class RootConvergenceMonitor final : public Utils::SigmaVectorEvaluator {
+ public:
+  /**
+   * @param evaluator The sigma vector evaluator of the response matrix.
+   * @param numberOfRoots The number of roots the diagonalizer solves for.
+   * @param residualTolerance The residual norm below which a root is converged.
+   * @param convergenceIterations Filled with the iteration at which every root converged, 0 if it did not.
+   */
+  RootConvergenceMonitor(std::unique_ptr<Utils::SigmaVectorEvaluator> evaluator, int numberOfRoots,
+                         double residualTolerance, std::vector<int>& convergenceIterations);
+  ~RootConvergenceMonitor() final = default;
+
+  const Eigen::MatrixXd& evaluate(const Eigen::MatrixXd& guessVectors) const final;
+  void collapsed(int newSubspaceDimension) final;
+
+  //! @brief The number of sigma vector evaluations so far.
+  int getNumberOfIterations() const;
+  /**
+   * @brief Assigns the current iteration to the roots that did not converge yet.
+   * The diagonalizer may consider a root converged with a slightly different residual than the one of the monitor.
+   */
+  void finalize() const;
+  //! @brief Writes the iteration at which every root converged to the output of the log.
+  void print(Core::Log& log) const;
+
+ private:
+  void update(const Eigen::MatrixXd& guessVectors, const Eigen::MatrixXd& sigmaVectors) const;
+  std::unique_ptr<Utils::SigmaVectorEvaluator> evaluator_;
+  int numberOfRoots_;
+  double residualTolerance_;
+  std::vector<int>& convergenceIterations_;
+  // Caching variables declared mutable in order not to influence the API design.
+  mutable Eigen::MatrixXd overlap_;
+  mutable Eigen::MatrixXd subspaceMatrix_;
+  mutable int iteration_ = 0;
+  // Relative threshold on the eigenvalues of the overlap below which subspace directions are linearly dependent.
+  static constexpr const double linearDependenceThreshold_ = 1e-10;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_ROOTCONVERGENCEMONITOR_H
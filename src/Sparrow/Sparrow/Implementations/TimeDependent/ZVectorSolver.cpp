@@ -0,0 +1,53 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+#include "ZVectorSolver.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace Scine {
+namespace Sparrow {
+
+ZVectorSolver::ZVectorSolver(Eigen::MatrixXd energyDifferences) : energyDifferences_(std::move(energyDifferences)) {
+}
+
+Eigen::MatrixXd ZVectorSolver::solve(const Eigen::MatrixXd& lagrangian, const HessianProduct& hessianProduct) {
+  Eigen::MatrixXd z = -lagrangian.cwiseQuotient(energyDifferences_);
+  Eigen::MatrixXd residual = -lagrangian - hessianProduct(z);
+  Eigen::MatrixXd preconditioned = residual.cwiseQuotient(energyDifferences_);
+  Eigen::MatrixXd direction = preconditioned;
+  double residualDotPreconditioned = residual.cwiseProduct(preconditioned).sum();
+  const double tolerance = tolerance_ * std::max(1.0, lagrangian.norm());
+  nIterations_ = 0;
+  while (residual.norm() > tolerance) {
+    if (nIterations_ == maxIterations_) {
+      throw std::runtime_error("The Z-vector equations of the excited-state gradient did not converge.");
+    }
+    ++nIterations_;
+    const Eigen::MatrixXd product = hessianProduct(direction);
+    const double curvature = direction.cwiseProduct(product).sum();
+    if (curvature <= 0.0) {
+      throw std::runtime_error("The orbital Hessian of the Z-vector equations is not positive definite, the reference "
+                               "is not a stable minimum of the SCF.");
+    }
+    const double step = residualDotPreconditioned / curvature;
+    z += step * direction;
+    residual -= step * product;
+    preconditioned = residual.cwiseQuotient(energyDifferences_);
+    const double newResidualDotPreconditioned = residual.cwiseProduct(preconditioned).sum();
+    direction = preconditioned + (newResidualDotPreconditioned / residualDotPreconditioned) * direction;
+    residualDotPreconditioned = newResidualDotPreconditioned;
+  }
+  return z;
+}
+
+int ZVectorSolver::getNumberOfIterations() const {
+  return nIterations_;
+}
+
+} // namespace Sparrow
+} // namespace Scine
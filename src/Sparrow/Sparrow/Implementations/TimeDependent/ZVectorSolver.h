@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_ZVECTORSOLVER_H
+#define SPARROW_ZVECTORSOLVER_H
+
+#include <Eigen/Core>
+#include <functional>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Solver of the Z-vector equations H z = -L of the orbital response in excited-state gradients.
+ * @class ZVectorSolver @file ZVectorSolver.h
+ *
+ * The orbital Hessian H of a stable reference is positive definite, the equations are solved by conjugate gradients
+ * preconditioned by the orbital energy differences, its diagonal without the coupling. The vectors are stored as
+ * (virtual x occupied) matrices and H is only accessed through its product with such a matrix.
+ */
+class ZVectorSolver {
+ public:
+  using HessianProduct = std::function<Eigen::MatrixXd(const Eigen::MatrixXd&)>;
+  /**
+   * @param energyDifferences The orbital energy differences e_a - e_i as a (virtual x occupied) matrix.
+   */
+  explicit ZVectorSolver(Eigen::MatrixXd energyDifferences);
+
+  /**
+   * @brief Solves the Z-vector equations.
+   * Throws if the Hessian is not positive definite along a search direction, i.e. the reference is unstable, or if
+   * the equations do not converge.
+   * @param lagrangian The Lagrangian L, the orbital derivatives of the excitation energy.
+   * @param hessianProduct The product of the orbital Hessian with a (virtual x occupied) matrix.
+   */
+  Eigen::MatrixXd solve(const Eigen::MatrixXd& lagrangian, const HessianProduct& hessianProduct);
+  //! @brief Number of conjugate gradient iterations of the last call to solve().
+  int getNumberOfIterations() const;
+
+ private:
+  Eigen::MatrixXd energyDifferences_;
+  int nIterations_ = 0;
+  static constexpr const double tolerance_ = 1e-9;
+  static constexpr const int maxIterations_ = 200;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_ZVECTORSOLVER_H
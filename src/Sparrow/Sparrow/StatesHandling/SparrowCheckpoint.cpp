@@ -0,0 +1,549 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "SparrowCheckpoint.h"
+#include "SparrowState.h"
+#include <Sparrow/Implementations/SparrowSettingPopulator.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#if defined(__unix__) || defined(__APPLE__)
+#  define SPARROW_CHECKPOINT_MMAP
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+constexpr char magic[8] = {'S', 'P', 'A', 'R', 'R', 'O', 'W', 'C'};
+enum class RecordType : std::uint8_t { Matrix = 1, String = 2 };
+
+std::string checkpointFile(const Core::CalculatorWithReference& calculator) {
+  const auto& settings = calculator.settings();
+  return settings.valueExists(SparrowSettingsNames::checkpointFile)
+             ? settings.getString(SparrowSettingsNames::checkpointFile)
+             : "";
+}
+
+// The guess of an excited states calculation is only used for the same method, number of states and spin block
+std::string excitedStatesKey(const Core::CalculatorWithReference& calculator) {
+  const auto& settings = calculator.settings();
+  std::string key = calculator.name();
+  if (settings.valueExists(Utils::SettingsNames::numberOfEigenstates)) {
+    key += ";" + std::to_string(settings.getInt(Utils::SettingsNames::numberOfEigenstates));
+  }
+  if (settings.valueExists(Utils::SettingsNames::spinBlock)) {
+    key += ";" + settings.getString(Utils::SettingsNames::spinBlock);
+  }
+  return key;
+}
+
+std::uint64_t fnv1a(const char* data, std::size_t size) {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// Appends integers byte by byte in little-endian order, independently of the host byte order.
+class ByteWriter {
+ public:
+  template<class UnsignedInteger>
+  void put(UnsignedInteger value) {
+    for (std::size_t i = 0; i < sizeof(UnsignedInteger); ++i) {
+      buffer.push_back(static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFFu));
+    }
+  }
+  void put(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(double));
+    put(bits);
+  }
+  void put(const std::string& value) {
+    buffer += value;
+  }
+  std::string buffer;
+};
+
+class ByteReader {
+ public:
+  ByteReader(const char* data, std::size_t size) : data_(data), size_(size) {
+  }
+  template<class UnsignedInteger>
+  UnsignedInteger get() {
+    require(sizeof(UnsignedInteger));
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(UnsignedInteger); ++i) {
+      value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data_[position_ + i])) << (8 * i);
+    }
+    position_ += sizeof(UnsignedInteger);
+    return static_cast<UnsignedInteger>(value);
+  }
+  double getDouble() {
+    auto bits = get<std::uint64_t>();
+    double value;
+    std::memcpy(&value, &bits, sizeof(double));
+    return value;
+  }
+  std::string getString(std::uint64_t length) {
+    require(length);
+    std::string value(data_ + position_, static_cast<std::size_t>(length));
+    position_ += static_cast<std::size_t>(length);
+    return value;
+  }
+  std::size_t position() const {
+    return position_;
+  }
+
+ private:
+  void require(std::uint64_t nBytes) const {
+    if (nBytes > size_ - position_) {
+      throw CheckpointException("unexpected end of data.");
+    }
+  }
+  const char* data_;
+  std::size_t size_;
+  std::size_t position_ = 0;
+};
+
+Eigen::MatrixXd scalar(double value) {
+  return Eigen::MatrixXd::Constant(1, 1, value);
+}
+
+std::string join(const std::string& prefix, const std::string& name) {
+  return prefix + "/" + name;
+}
+
+#ifdef SPARROW_CHECKPOINT_MMAP
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw CheckpointException("cannot open " + filename + ".");
+    }
+    struct stat fileStatus;
+    if (::fstat(fd, &fileStatus) != 0) {
+      ::close(fd);
+      throw CheckpointException("cannot access " + filename + ".");
+    }
+    size_ = static_cast<std::size_t>(fileStatus.st_size);
+    if (size_ > 0) {
+      void* address = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (address == MAP_FAILED) {
+        ::close(fd);
+        throw CheckpointException("cannot map " + filename + ".");
+      }
+      data_ = static_cast<const char*>(address);
+    }
+    ::close(fd);
+  }
+  ~MappedFile() {
+    if (data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  const char* data() const {
+    return data_;
+  }
+  std::size_t size() const {
+    return size_;
+  }
+
+ private:
+  const char* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+#endif
+} // namespace
+
+constexpr std::uint32_t SparrowCheckpoint::formatVersion;
+
+bool SparrowCheckpoint::has(const std::string& name) const {
+  return matrices_.count(name) > 0 || strings_.count(name) > 0;
+}
+
+void SparrowCheckpoint::erase(const std::string& prefix) {
+  auto startsWithPrefix = [&](const std::string& name) { return name.compare(0, prefix.size(), prefix) == 0; };
+  for (auto it = matrices_.begin(); it != matrices_.end();) {
+    it = startsWithPrefix(it->first) ? matrices_.erase(it) : std::next(it);
+  }
+  for (auto it = strings_.begin(); it != strings_.end();) {
+    it = startsWithPrefix(it->first) ? strings_.erase(it) : std::next(it);
+  }
+}
+
+std::vector<std::string> SparrowCheckpoint::getNames() const {
+  std::vector<std::string> names;
+  for (const auto& record : matrices_) {
+    names.push_back(record.first);
+  }
+  for (const auto& record : strings_) {
+    names.push_back(record.first);
+  }
+  return names;
+}
+
+void SparrowCheckpoint::setMatrix(const std::string& name, Eigen::MatrixXd matrix) {
+  strings_.erase(name);
+  matrices_[name] = std::move(matrix);
+}
+
+const Eigen::MatrixXd& SparrowCheckpoint::getMatrix(const std::string& name) const {
+  auto it = matrices_.find(name);
+  if (it == matrices_.end()) {
+    throw CheckpointException("no matrix " + name + " stored.");
+  }
+  return it->second;
+}
+
+void SparrowCheckpoint::setString(const std::string& name, std::string value) {
+  matrices_.erase(name);
+  strings_[name] = std::move(value);
+}
+
+const std::string& SparrowCheckpoint::getString(const std::string& name) const {
+  auto it = strings_.find(name);
+  if (it == strings_.end()) {
+    throw CheckpointException("no string " + name + " stored.");
+  }
+  return it->second;
+}
+
+void SparrowCheckpoint::setState(const SparrowState& state, const std::string& prefix) {
+  erase(prefix + "/");
+  const auto& density = state.getDensityMatrix();
+  if (density.unrestricted()) {
+    setMatrix(join(prefix, "density_alpha"), density.alphaMatrix());
+    setMatrix(join(prefix, "density_beta"), density.betaMatrix());
+    Eigen::MatrixXd electrons(2, 1);
+    electrons << density.numberElectronsInAlphaMatrix(), density.numberElectronsInBetaMatrix();
+    setMatrix(join(prefix, "density_electrons"), std::move(electrons));
+  }
+  else {
+    setMatrix(join(prefix, "density"), density.restrictedMatrix());
+    setMatrix(join(prefix, "density_electrons"), scalar(density.numberElectrons()));
+  }
+
+  if (!state.hasSnapshot()) {
+    return;
+  }
+  const auto& snapshot = *state.getSnapshot();
+  setString(join(prefix, "fingerprint"), snapshot.fingerprint);
+  setString(join(prefix, "results_fingerprint"), snapshot.resultsFingerprint);
+  Eigen::MatrixXd elements(snapshot.elements.size(), 1);
+  for (int i = 0; i < elements.rows(); ++i) {
+    elements(i, 0) = static_cast<double>(static_cast<unsigned>(snapshot.elements[i]));
+  }
+  setMatrix(join(prefix, "elements"), std::move(elements));
+  setMatrix(join(prefix, "positions"), snapshot.positions);
+  Eigen::MatrixXd electrons(3, 1);
+  electrons << (snapshot.unrestricted ? 1.0 : 0.0), snapshot.nAlphaElectrons, snapshot.nBetaElectrons;
+  setMatrix(join(prefix, "electrons"), std::move(electrons));
+  if (snapshot.unrestricted) {
+    setMatrix(join(prefix, "orbitals_alpha"), snapshot.molecularOrbitals.alphaMatrix());
+    setMatrix(join(prefix, "orbitals_beta"), snapshot.molecularOrbitals.betaMatrix());
+    setMatrix(join(prefix, "orbital_energies_alpha"), snapshot.singleParticleEnergies.getAlphaEnergies());
+    setMatrix(join(prefix, "orbital_energies_beta"), snapshot.singleParticleEnergies.getBetaEnergies());
+    setMatrix(join(prefix, "fock_alpha"), snapshot.fockMatrix.alphaMatrix());
+    setMatrix(join(prefix, "fock_beta"), snapshot.fockMatrix.betaMatrix());
+  }
+  else {
+    setMatrix(join(prefix, "orbitals"), snapshot.molecularOrbitals.restrictedMatrix());
+    setMatrix(join(prefix, "orbital_energies"), snapshot.singleParticleEnergies.getRestrictedEnergies());
+    setMatrix(join(prefix, "fock"), snapshot.fockMatrix.restrictedMatrix());
+  }
+  setMatrix(join(prefix, "density_independent_fock"), snapshot.densityIndependentMatrix);
+
+  // Only the results that can be represented as matrices are kept; the restored snapshot then only covers these.
+  const auto& results = snapshot.results;
+  if (results.has<Utils::Property::SuccessfulCalculation>()) {
+    setMatrix(join(prefix, "successful_calculation"),
+              scalar(results.get<Utils::Property::SuccessfulCalculation>() ? 1.0 : 0.0));
+  }
+  if (results.has<Utils::Property::Energy>()) {
+    setMatrix(join(prefix, "energy"), scalar(results.get<Utils::Property::Energy>()));
+  }
+  if (results.has<Utils::Property::Gradients>() && snapshot.properties.containsSubSet(Utils::Property::Gradients)) {
+    setMatrix(join(prefix, "gradients"), results.get<Utils::Property::Gradients>());
+  }
+  if (results.has<Utils::Property::Hessian>() && snapshot.properties.containsSubSet(Utils::Property::Hessian)) {
+    setMatrix(join(prefix, "hessian"), results.get<Utils::Property::Hessian>());
+  }
+}
+
+std::shared_ptr<SparrowState> SparrowCheckpoint::getState(const std::string& prefix) const {
+  auto stored = [&](const std::string& name) { return has(join(prefix, name)); };
+  // Copy, as the Utils data structures take ownership of the matrices
+  auto matrix = [&](const std::string& name) { return Eigen::MatrixXd(getMatrix(join(prefix, name))); };
+  if (!stored("density_electrons")) {
+    return nullptr;
+  }
+  const Eigen::MatrixXd densityElectrons = matrix("density_electrons");
+  Utils::DensityMatrix density;
+  if (stored("density_alpha")) {
+    density.setDensity(matrix("density_alpha"), matrix("density_beta"), densityElectrons(0, 0), densityElectrons(1, 0));
+  }
+  else {
+    density.setDensity(matrix("density"), densityElectrons(0, 0));
+  }
+
+  if (!stored("fingerprint")) {
+    return std::make_shared<SparrowState>(std::move(density));
+  }
+  auto snapshot = std::make_shared<SparrowStateSnapshot>();
+  snapshot->fingerprint = getString(join(prefix, "fingerprint"));
+  // Without the settings of the results, the snapshot only serves as a restart guess
+  if (stored("results_fingerprint")) {
+    snapshot->resultsFingerprint = getString(join(prefix, "results_fingerprint"));
+  }
+  const Eigen::MatrixXd elements = matrix("elements");
+  for (int i = 0; i < elements.rows(); ++i) {
+    snapshot->elements.push_back(static_cast<Utils::ElementType>(static_cast<unsigned>(elements(i, 0))));
+  }
+  snapshot->positions = matrix("positions");
+  const Eigen::MatrixXd electrons = matrix("electrons");
+  snapshot->unrestricted = electrons(0, 0) != 0.0;
+  snapshot->nAlphaElectrons = static_cast<int>(electrons(1, 0));
+  snapshot->nBetaElectrons = static_cast<int>(electrons(2, 0));
+  if (snapshot->unrestricted) {
+    snapshot->molecularOrbitals =
+        Utils::MolecularOrbitals::createFromUnrestrictedCoefficients(matrix("orbitals_alpha"), matrix("orbitals_beta"));
+    snapshot->singleParticleEnergies.setUnrestricted(matrix("orbital_energies_alpha").col(0),
+                                                     matrix("orbital_energies_beta").col(0));
+    snapshot->fockMatrix = Utils::SpinAdaptedMatrix::createUnrestricted(matrix("fock_alpha"), matrix("fock_beta"));
+  }
+  else {
+    snapshot->molecularOrbitals = Utils::MolecularOrbitals::createFromRestrictedCoefficients(matrix("orbitals"));
+    snapshot->singleParticleEnergies.setRestricted(matrix("orbital_energies").col(0));
+    snapshot->fockMatrix = Utils::SpinAdaptedMatrix::createRestricted(matrix("fock"));
+  }
+  snapshot->densityIndependentMatrix = matrix("density_independent_fock");
+
+  if (stored("successful_calculation")) {
+    snapshot->results.set<Utils::Property::SuccessfulCalculation>(matrix("successful_calculation")(0, 0) != 0.0);
+    snapshot->properties.addProperty(Utils::Property::SuccessfulCalculation);
+  }
+  if (stored("energy")) {
+    snapshot->results.set<Utils::Property::Energy>(matrix("energy")(0, 0));
+    snapshot->properties.addProperty(Utils::Property::Energy);
+  }
+  if (stored("gradients")) {
+    snapshot->results.set<Utils::Property::Gradients>(matrix("gradients"));
+    snapshot->properties.addProperty(Utils::Property::Gradients);
+  }
+  if (stored("hessian")) {
+    snapshot->results.set<Utils::Property::Hessian>(matrix("hessian"));
+    snapshot->properties.addProperty(Utils::Property::Hessian);
+  }
+  return std::make_shared<SparrowState>(std::move(density), std::move(snapshot));
+}
+
+void SparrowCheckpoint::setExcitedStatesGuess(const LinearResponseCalculator::GuessSpecifier& guess,
+                                              const std::string& prefix) {
+  erase(prefix + "/");
+  if (guess.singlet.size() != 0) {
+    setMatrix(join(prefix, "singlet"), guess.singlet);
+  }
+  if (guess.triplet.size() != 0) {
+    setMatrix(join(prefix, "triplet"), guess.triplet);
+  }
+  if (guess.unrestricted.size() != 0) {
+    setMatrix(join(prefix, "unrestricted"), guess.unrestricted);
+  }
+}
+
+std::shared_ptr<LinearResponseCalculator::GuessSpecifier>
+SparrowCheckpoint::getExcitedStatesGuess(const std::string& prefix) const {
+  auto guess = std::make_shared<LinearResponseCalculator::GuessSpecifier>();
+  bool found = false;
+  for (auto block : {std::make_pair("singlet", &guess->singlet), std::make_pair("triplet", &guess->triplet),
+                     std::make_pair("unrestricted", &guess->unrestricted)}) {
+    if (has(join(prefix, block.first))) {
+      *block.second = getMatrix(join(prefix, block.first));
+      found = true;
+    }
+  }
+  return found ? guess : nullptr;
+}
+
+std::string SparrowCheckpoint::serialize() const {
+  ByteWriter writer;
+  writer.put(std::string(magic, sizeof(magic)));
+  writer.put(formatVersion);
+  writer.put(static_cast<std::uint32_t>(matrices_.size() + strings_.size()));
+  for (const auto& record : matrices_) {
+    writer.put(static_cast<std::uint8_t>(RecordType::Matrix));
+    writer.put(static_cast<std::uint32_t>(record.first.size()));
+    writer.put(record.first);
+    writer.put(static_cast<std::uint64_t>(record.second.rows()));
+    writer.put(static_cast<std::uint64_t>(record.second.cols()));
+    writer.buffer.reserve(writer.buffer.size() + sizeof(double) * record.second.size());
+    for (Eigen::Index i = 0; i < record.second.size(); ++i) {
+      writer.put(record.second.data()[i]);
+    }
+  }
+  for (const auto& record : strings_) {
+    writer.put(static_cast<std::uint8_t>(RecordType::String));
+    writer.put(static_cast<std::uint32_t>(record.first.size()));
+    writer.put(record.first);
+    writer.put(static_cast<std::uint64_t>(record.second.size()));
+    writer.put(record.second);
+  }
+  writer.put(fnv1a(writer.buffer.data(), writer.buffer.size()));
+  return std::move(writer.buffer);
+}
+
+SparrowCheckpoint SparrowCheckpoint::deserialize(const char* data, std::size_t size) {
+  if (size < sizeof(magic) + sizeof(std::uint64_t) || std::memcmp(data, magic, sizeof(magic)) != 0) {
+    throw CheckpointException("not a Sparrow checkpoint.");
+  }
+  const std::size_t contentSize = size - sizeof(std::uint64_t);
+  ByteReader checksumReader(data + contentSize, sizeof(std::uint64_t));
+  if (checksumReader.get<std::uint64_t>() != fnv1a(data, contentSize)) {
+    throw CheckpointException("checksum mismatch, the file is corrupted or incomplete.");
+  }
+
+  ByteReader reader(data, contentSize);
+  reader.getString(sizeof(magic));
+  auto version = reader.get<std::uint32_t>();
+  if (version != formatVersion) {
+    throw CheckpointException("unsupported format version " + std::to_string(version) + ".");
+  }
+  SparrowCheckpoint checkpoint;
+  auto nRecords = reader.get<std::uint32_t>();
+  for (std::uint32_t record = 0; record < nRecords; ++record) {
+    auto type = static_cast<RecordType>(reader.get<std::uint8_t>());
+    std::string name = reader.getString(reader.get<std::uint32_t>());
+    if (type == RecordType::Matrix) {
+      auto rows = reader.get<std::uint64_t>();
+      auto cols = reader.get<std::uint64_t>();
+      if (cols != 0 && rows > (contentSize - reader.position()) / sizeof(double) / cols) {
+        throw CheckpointException("unexpected end of data.");
+      }
+      Eigen::MatrixXd matrix(static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols));
+      for (Eigen::Index i = 0; i < matrix.size(); ++i) {
+        matrix.data()[i] = reader.getDouble();
+      }
+      checkpoint.matrices_[name] = std::move(matrix);
+    }
+    else if (type == RecordType::String) {
+      checkpoint.strings_[name] = reader.getString(reader.get<std::uint64_t>());
+    }
+    else {
+      throw CheckpointException("unknown record type for " + name + ".");
+    }
+  }
+  if (reader.position() != contentSize) {
+    throw CheckpointException("trailing data after the last record.");
+  }
+  return checkpoint;
+}
+
+void SparrowCheckpoint::write(const std::string& filename) const {
+  const std::string temporaryFilename = filename + ".tmp";
+  {
+    std::ofstream out(temporaryFilename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      throw CheckpointException("cannot write " + temporaryFilename + ".");
+    }
+    const std::string data = serialize();
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    out.flush();
+    if (!out) {
+      throw CheckpointException("error while writing " + temporaryFilename + ".");
+    }
+  }
+#ifdef _WIN32
+  std::remove(filename.c_str());
+#endif
+  if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0) {
+    throw CheckpointException("cannot move " + temporaryFilename + " to " + filename + ".");
+  }
+}
+
+SparrowCheckpoint SparrowCheckpoint::read(const std::string& filename, bool memoryMapped) {
+#ifdef SPARROW_CHECKPOINT_MMAP
+  if (memoryMapped) {
+    MappedFile file(filename);
+    return deserialize(file.data(), file.size());
+  }
+#else
+  (void)memoryMapped;
+#endif
+  std::ifstream in(filename, std::ios::binary);
+  if (!in.is_open()) {
+    throw CheckpointException("cannot open " + filename + ".");
+  }
+  std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  return deserialize(data.data(), data.size());
+}
+
+void SparrowCheckpoint::updateState(const std::string& filename, const SparrowState& state) {
+  SparrowCheckpoint checkpoint;
+  if (std::ifstream(filename).good()) {
+    try {
+      checkpoint = read(filename);
+    }
+    catch (const CheckpointException&) {
+      checkpoint = SparrowCheckpoint{};
+    }
+  }
+  // The excited states are only valid for the same reference calculation
+  auto previous = checkpoint.getState();
+  bool sameReference = previous && previous->hasSnapshot() && state.hasSnapshot() &&
+                       previous->getSnapshot()->fingerprint == state.getSnapshot()->fingerprint &&
+                       previous->getSnapshot()->positions.isApprox(state.getSnapshot()->positions, 1e-12);
+  if (!sameReference) {
+    checkpoint.erase("excited_states");
+  }
+  checkpoint.setState(state);
+  checkpoint.write(filename);
+}
+
+void SparrowCheckpoint::loadExcitedStatesGuess(LinearResponseCalculator& calculator) {
+  const std::string filename = checkpointFile(calculator);
+  if (filename.empty() || !std::ifstream(filename).good()) {
+    return;
+  }
+  const auto checkpoint = read(filename);
+  auto guess = checkpoint.getExcitedStatesGuess();
+  if (guess && checkpoint.has("excited_states_key") &&
+      checkpoint.getString("excited_states_key") == excitedStatesKey(calculator)) {
+    calculator.setGuess(std::move(guess));
+  }
+}
+
+void SparrowCheckpoint::saveExcitedStatesGuess(const LinearResponseCalculator& calculator) {
+  const std::string filename = checkpointFile(calculator);
+  if (filename.empty() || !std::ifstream(filename).good()) {
+    return;
+  }
+  auto guess = calculator.getGuess();
+  if (!guess) {
+    return;
+  }
+  auto checkpoint = read(filename);
+  checkpoint.setExcitedStatesGuess(*guess);
+  checkpoint.setString("excited_states_key", excitedStatesKey(calculator));
+  checkpoint.write(filename);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,111 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_SPARROWCHECKPOINT_H
+#define SPARROW_SPARROWCHECKPOINT_H
+
+#include <Sparrow/Implementations/TimeDependent/LinearResponseCalculator.h>
+#include <Eigen/Core>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Scine {
+namespace Sparrow {
+
+struct SparrowState;
+
+/**
+ * @brief Exception thrown if a checkpoint file cannot be read or written, or if its content is corrupted.
+ */
+class CheckpointException : public std::runtime_error {
+ public:
+  explicit CheckpointException(const std::string& message) : std::runtime_error("Checkpoint: " + message) {
+  }
+};
+
+/**
+ * @brief Versioned binary checkpoint of named matrices and strings, used to resume interrupted calculations.
+ *
+ * File layout, all integers little-endian irrespective of the host byte order and doubles in IEEE 754 binary64:
+ *  - 8 bytes magic "SPARROWC", uint32 format version, uint32 number of records;
+ *  - for each record: uint8 type, uint32 name length, name, and the payload. Matrices store uint64 rows, uint64 cols
+ *    and the column-major values, strings store uint64 length and the characters;
+ *  - uint64 FNV-1a checksum of all preceding bytes.
+ * Files are written to a temporary file first and then renamed, so that an interrupted write never corrupts an
+ * existing checkpoint. Reading can use a memory mapping of the file where supported.
+ *
+ * Besides the generic records, the checkpoint converts calculation states (see SparrowState) and excited states
+ * guesses (see LinearResponseCalculator::GuessSpecifier) from and to records with a common name prefix.
+ */
+class SparrowCheckpoint {
+ public:
+  static constexpr std::uint32_t formatVersion = 1;
+
+  bool has(const std::string& name) const;
+  //! @brief Removes all records whose name starts with prefix.
+  void erase(const std::string& prefix);
+  std::vector<std::string> getNames() const;
+
+  void setMatrix(const std::string& name, Eigen::MatrixXd matrix);
+  //! @throws CheckpointException if there is no matrix record with this name.
+  const Eigen::MatrixXd& getMatrix(const std::string& name) const;
+  void setString(const std::string& name, std::string value);
+  //! @throws CheckpointException if there is no string record with this name.
+  const std::string& getString(const std::string& name) const;
+
+  //! @brief Stores the density matrix and, if present, the snapshot of the state.
+  void setState(const SparrowState& state, const std::string& prefix = "ground_state");
+  //! @brief Reconstructs the state stored under prefix, nullptr if there is none.
+  std::shared_ptr<SparrowState> getState(const std::string& prefix = "ground_state") const;
+  void setExcitedStatesGuess(const LinearResponseCalculator::GuessSpecifier& guess,
+                             const std::string& prefix = "excited_states");
+  //! @brief The excited states guess stored under prefix, nullptr if there is none.
+  std::shared_ptr<LinearResponseCalculator::GuessSpecifier>
+  getExcitedStatesGuess(const std::string& prefix = "excited_states") const;
+
+  //! @brief Serializes all records in the binary format described above.
+  std::string serialize() const;
+  //! @throws CheckpointException if the data is truncated, has a wrong checksum or an unknown version.
+  static SparrowCheckpoint deserialize(const char* data, std::size_t size);
+  //! @brief Writes the checkpoint atomically to filename.
+  void write(const std::string& filename) const;
+  /**
+   * @brief Reads a checkpoint file.
+   * @param memoryMapped If true and supported by the platform, the file is memory-mapped instead of read into a buffer.
+   */
+  static SparrowCheckpoint read(const std::string& filename, bool memoryMapped = true);
+
+  /**
+   * @brief Stores the state in the checkpoint file, keeping its other records.
+   * The excited states guesses are removed if the state belongs to another reference calculation, i.e. another
+   * method or structure. A missing or corrupted file is replaced.
+   */
+  static void updateState(const std::string& filename, const SparrowState& state);
+  /**
+   * @brief Sets the excited states guess stored in the file of the setting "checkpoint_file" of the calculator.
+   * Nothing is set if there is no such file or if it holds the guess of another number of states or spin block.
+   */
+  static void loadExcitedStatesGuess(LinearResponseCalculator& calculator);
+  /**
+   * @brief Stores the excited states of the last calculation in the file of the setting "checkpoint_file", keeping
+   * the state. Nothing is stored if the file does not exist, as the guess belongs to the reference stored in it.
+   */
+  static void saveExcitedStatesGuess(const LinearResponseCalculator& calculator);
+
+ private:
+  std::map<std::string, Eigen::MatrixXd> matrices_;
+  std::map<std::string, std::string> strings_;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_SPARROWCHECKPOINT_H
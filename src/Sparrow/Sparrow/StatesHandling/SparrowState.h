@@ -9,8 +9,16 @@
 #define SPARROW_SPARROWSTATE_H
 
 #include <Core/BaseClasses/StateHandableObject.h>
+#include <Utils/CalculatorBasics/PropertyList.h>
+#include <Utils/CalculatorBasics/Results.h>
 #include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/DataStructures/MolecularOrbitals.h>
+#include <Utils/DataStructures/SingleParticleEnergies.h>
+#include <Utils/DataStructures/SpinAdaptedMatrix.h>
+#include <Utils/Typenames.h>
 #include <exception>
+#include <memory>
+#include <string>
 
 namespace Scine {
 namespace Sparrow {
@@ -24,21 +32,58 @@ class IncompatibleStateException : public std::exception {
   }
 };
 
+/**
+ * @brief Converged wave function and results stored in a SparrowState in addition to the density matrix.
+ * A snapshot is only created if the setting "state_snapshots" is enabled. It allows to reload a calculation at the
+ * same geometry without any SCF iteration, and to restart at a nearby geometry from the stored Fock matrix.
+ */
+struct SparrowStateSnapshot {
+  //! Identifies the method, its parameters and the electronic state settings, see GenericMethodWrapper.
+  std::string fingerprint;
+  //! Identifies the SCF, dipole and thermochemistry settings the results depend on, see GenericMethodWrapper.
+  std::string resultsFingerprint;
+  Utils::ElementTypeCollection elements;
+  Utils::PositionCollection positions;
+  Utils::MolecularOrbitals molecularOrbitals;
+  Utils::SingleParticleEnergies singleParticleEnergies;
+  //! Converged Fock matrix, restricted or alpha/beta.
+  Utils::SpinAdaptedMatrix fockMatrix;
+  //! Density-independent part of the Fock matrix, empty if not available for the method.
+  Eigen::MatrixXd densityIndependentMatrix;
+  bool unrestricted = false;
+  int nAlphaElectrons = 0;
+  int nBetaElectrons = 0;
+  //! Results of the calculation and the properties they were calculated for, empty if the calculation failed.
+  Utils::Results results;
+  Utils::PropertyList properties;
+};
+
 /**
  * @brief Definition of a calculation state for methods implemented in Sparrow.
  * The calculation state is defined as the density matrix and the coefficient matrix at some point.
  * If the density matrix is empty, an exception is thrown at loading time.
+ * Optionally, the state holds a snapshot of the converged calculation, see SparrowStateSnapshot.
  */
 struct SparrowState final : public Core::State {
   explicit SparrowState(Utils::DensityMatrix densityMatrix) : densityMatrix_(std::move(densityMatrix)){};
+  SparrowState(Utils::DensityMatrix densityMatrix, std::shared_ptr<const SparrowStateSnapshot> snapshot)
+    : densityMatrix_(std::move(densityMatrix)), snapshot_(std::move(snapshot)){};
   ~SparrowState() final = default;
 
   const Utils::DensityMatrix& getDensityMatrix() const {
     return densityMatrix_;
   }
+  bool hasSnapshot() const {
+    return static_cast<bool>(snapshot_);
+  }
+  //! @brief The snapshot of the converged calculation, nullptr if the state only holds the density matrix.
+  const std::shared_ptr<const SparrowStateSnapshot>& getSnapshot() const {
+    return snapshot_;
+  }
 
  private:
   Utils::DensityMatrix densityMatrix_;
+  std::shared_ptr<const SparrowStateSnapshot> snapshot_;
 };
 
 } // namespace Sparrow
@@ -18,6 +18,7 @@
 #include <Utils/DataStructures/SlaterToGaussian.h>
 #include <Utils/Geometry/AtomCollection.h>
 #include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/LcaoUtils/ElectronicOccupation.h>
 #include <Utils/Scf/LcaoUtils/SpinMode.h>
 #include <Utils/Settings.h>
 #include <Utils/Typenames.h>
@@ -275,6 +276,33 @@ TEST_F(SlaterToGaussianDipoleTest, ObaraSaikaAndAnalyticalAreEqual) {
   }
 }
 
+TEST_F(SlaterToGaussianDipoleTest, FusedMODipoleMatrixTransformationIsCorrect) {
+  underlyingMethod.setStructure(Ethanol);
+  underlyingMethod.convergedCalculation(log, Utils::Derivative::None);
+
+  matrixCalculator = NDDODipoleMatrixCalculator<nddo::PM6Method>::create(underlyingMethod);
+  matrixCalculator->fillDipoleMatrix(evaluationCoordinate);
+  const auto& aoDipoleMatrix = matrixCalculator->getAODipoleMatrix();
+  const auto moDipoleMatrix = matrixCalculator->getMODipoleMatrix();
+  const auto occupiedVirtualDipoleMatrix =
+      matrixCalculator->getOccupiedVirtualMODipoleMatrix(underlyingMethod.getElectronicOccupation());
+
+  const Eigen::MatrixXd& C = underlyingMethod.getMolecularOrbitals().restrictedMatrix();
+  const auto& filledOrbitals = underlyingMethod.getElectronicOccupation().getFilledRestrictedOrbitals();
+  const int nMOs = static_cast<int>(C.cols());
+  const int nOccupied = static_cast<int>(filledOrbitals.size());
+  for (int dimension = 0; dimension < 3; ++dimension) {
+    Eigen::MatrixXd reference = C.transpose() * aoDipoleMatrix[dimension].selfadjointView<Eigen::Upper>() * C;
+    for (int i = 0; i < nMOs; ++i) {
+      for (int j = 0; j < nMOs; ++j) {
+        ASSERT_NEAR(moDipoleMatrix[dimension](i, j), reference(i, j), 1e-10);
+        bool occupiedVirtual = (i < nOccupied) != (j < nOccupied);
+        ASSERT_NEAR(occupiedVirtualDipoleMatrix[dimension](i, j), occupiedVirtual ? reference(i, j) : 0.0, 1e-10);
+      }
+    }
+  }
+}
+
 TEST_F(SlaterToGaussianDipoleTest, NuclearDipoleContribution) {
   // pyscf nuclear dipole = [42.0259269  15.37531606 -1.03465377]
   /*
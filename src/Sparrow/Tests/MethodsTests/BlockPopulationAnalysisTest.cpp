@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/BlockPopulationAnalysis.h>
+#include <Sparrow/Implementations/Dftb/Dftb2/Wrapper/DFTB2MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Utils/Bonds/BondOrderCollection.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <numeric>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class ABlockPopulationAnalysis : public Test {
+ public:
+  Utils::AtomsOrbitalsIndexes aoIndexes;
+  Eigen::MatrixXd overlap;
+  Utils::DensityMatrix density;
+  std::vector<double> coreCharges = {6.0, 1.0, 4.0, 1.0};
+
+  void SetUp() override {
+    for (int nAOs : {4, 1, 4, 1}) {
+      aoIndexes.addAtom(nAOs);
+    }
+    const int nAOs = aoIndexes.getNAtomicOrbitals();
+    srand(42);
+    Eigen::MatrixXd random = Eigen::MatrixXd::Random(nAOs, nAOs);
+    overlap = Eigen::MatrixXd::Identity(nAOs, nAOs) + 0.05 * (random + random.transpose());
+    overlap.diagonal().setOnes();
+    // The first and the last atom are far apart
+    overlap.block(9, 0, 1, 4).setZero();
+    overlap.block(0, 9, 4, 1).setZero();
+    density.setDensity(randomDensity(nAOs), randomDensity(nAOs), 6, 4);
+  }
+
+  static Eigen::MatrixXd randomDensity(int nAOs) {
+    Eigen::MatrixXd random = Eigen::MatrixXd::Random(nAOs, nAOs);
+    return random * random.transpose() / nAOs;
+  }
+
+  // Mayer bond orders of the full matrix product P S
+  Eigen::MatrixXd denseBondOrders(const Eigen::MatrixXd& P) const {
+    const Eigen::MatrixXd PS = P * overlap;
+    const int nAtoms = aoIndexes.getNAtoms();
+    Eigen::MatrixXd orders(nAtoms, nAtoms);
+    for (int a = 0; a < nAtoms; ++a) {
+      for (int b = 0; b < nAtoms; ++b) {
+        const int indexA = aoIndexes.getFirstOrbitalIndex(a);
+        const int indexB = aoIndexes.getFirstOrbitalIndex(b);
+        const int nA = aoIndexes.getNOrbitals(a);
+        const int nB = aoIndexes.getNOrbitals(b);
+        auto blockBA = PS.block(indexB, indexA, nB, nA);
+        orders(a, b) = PS.block(indexA, indexB, nA, nB).cwiseProduct(blockBA.transpose()).sum();
+      }
+    }
+    return orders;
+  }
+
+  Eigen::VectorXd densePopulations(const Eigen::MatrixXd& P) const {
+    const Eigen::VectorXd orbitalPopulations = (P * overlap).diagonal();
+    Eigen::VectorXd populations(aoIndexes.getNAtoms());
+    for (int a = 0; a < aoIndexes.getNAtoms(); ++a) {
+      populations[a] = orbitalPopulations.segment(aoIndexes.getFirstOrbitalIndex(a), aoIndexes.getNOrbitals(a)).sum();
+    }
+    return populations;
+  }
+};
+
+TEST_F(ABlockPopulationAnalysis, FindsNeighborsFromOverlapBlocks) {
+  BlockPopulationAnalysis analysis(density, overlap, aoIndexes, coreCharges, false);
+  EXPECT_THAT(analysis.getNeighbors()[0], ElementsAre(0, 1, 2));
+  EXPECT_THAT(analysis.getNeighbors()[3], ElementsAre(1, 2, 3));
+}
+
+TEST_F(ABlockPopulationAnalysis, ReproducesDenseMullikenPopulations) {
+  BlockPopulationAnalysis analysis(density, overlap, aoIndexes, coreCharges, false);
+  const Eigen::VectorXd populations = densePopulations(density.restrictedMatrix());
+  const Eigen::VectorXd spinPopulations = densePopulations(density.alphaMatrix() - density.betaMatrix());
+  const std::vector<double> charges = analysis.getMullikenCharges();
+  for (int a = 0; a < aoIndexes.getNAtoms(); ++a) {
+    EXPECT_THAT(charges[a], DoubleNear(coreCharges[a] - populations[a], 1e-12));
+    EXPECT_THAT(analysis.getMullikenSpinPopulations()[a], DoubleNear(spinPopulations[a], 1e-12));
+  }
+}
+
+TEST_F(ABlockPopulationAnalysis, ConservesTotalChargeInLowdinPopulations) {
+  BlockPopulationAnalysis analysis(density, overlap, aoIndexes, coreCharges, false);
+  const std::vector<double> mulliken = analysis.getMullikenCharges();
+  const std::vector<double> lowdin = analysis.getLowdinCharges();
+  EXPECT_THAT(std::accumulate(lowdin.begin(), lowdin.end(), 0.0),
+              DoubleNear(std::accumulate(mulliken.begin(), mulliken.end(), 0.0), 1e-10));
+  EXPECT_THAT(lowdin[0], Not(DoubleNear(mulliken[0], 1e-6)));
+}
+
+TEST_F(ABlockPopulationAnalysis, ReproducesDenseMayerBondOrders) {
+  BlockPopulationAnalysis analysis(density, overlap, aoIndexes, coreCharges, false);
+  const Eigen::MatrixXd expected = 2 * (denseBondOrders(density.alphaMatrix()) + denseBondOrders(density.betaMatrix()));
+  for (int a = 0; a < aoIndexes.getNAtoms(); ++a) {
+    for (int b = a + 1; b < aoIndexes.getNAtoms(); ++b) {
+      EXPECT_THAT(analysis.getBondOrder(a, b), DoubleNear(expected(a, b), 1e-12));
+    }
+  }
+  // Only requested pairs are evaluated
+  Utils::BondOrderCollection orders = analysis.getBondOrders({{0, 2}});
+  EXPECT_THAT(orders.getOrder(0, 2), DoubleNear(expected(0, 2), 1e-12));
+  EXPECT_THAT(orders.getOrder(0, 1), DoubleEq(0.0));
+  // All pairs of neighbors
+  orders = analysis.getBondOrders();
+  EXPECT_THAT(orders.getOrder(1, 2), DoubleNear(expected(1, 2), 1e-12));
+  EXPECT_THAT(orders.getOrder(0, 3), DoubleEq(0.0));
+  // All pairs, also those of atoms without overlap
+  orders = analysis.getAllBondOrders();
+  EXPECT_THAT(orders.getOrder(1, 2), DoubleNear(expected(1, 2), 1e-12));
+  EXPECT_THAT(orders.getOrder(0, 3), DoubleNear(expected(0, 3), 1e-12));
+  EXPECT_THAT(orders.getOrder(0, 3), Not(DoubleEq(0.0)));
+}
+
+TEST_F(ABlockPopulationAnalysis, ReducesToWibergBondOrdersInOrthogonalBasis) {
+  Utils::DensityMatrix restricted;
+  restricted.setDensity(Eigen::MatrixXd(density.restrictedMatrix()), 10);
+  BlockPopulationAnalysis analysis(restricted, overlap, aoIndexes, coreCharges, true);
+  const Eigen::MatrixXd& P = restricted.restrictedMatrix();
+  EXPECT_THAT(analysis.getBondOrder(0, 2), DoubleNear(P.block(0, 5, 4, 4).cwiseAbs2().sum(), 1e-12));
+  const std::vector<double> charges = analysis.getMullikenCharges();
+  EXPECT_THAT(charges[2], DoubleNear(coreCharges[2] - P.diagonal().segment(5, 4).sum(), 1e-12));
+  EXPECT_THAT(analysis.getLowdinCharges()[2], DoubleNear(charges[2], 1e-12));
+}
+
+TEST_F(ABlockPopulationAnalysis, ReproducesChargesOfTheMethods) {
+  std::stringstream ss("3\n\n"
+                       "O      0.0000000000    0.0000000000    0.1173000000\n"
+                       "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                       "H      0.0000000000   -0.7572000000   -0.4692000000\n");
+  const auto water = Utils::XyzStreamHandler::read(ss);
+  PM6MethodWrapper pm6;
+  DFTB2MethodWrapper dftb2;
+  for (GenericMethodWrapper* calculator : std::vector<GenericMethodWrapper*>{&pm6, &dftb2}) {
+    calculator->setLog(Core::Log::silent());
+    // Only the bond orders of neighbors unless the full matrix is requested
+    EXPECT_TRUE(calculator->settings().getBool("screened_bond_orders"));
+    calculator->setStructure(water);
+    calculator->setRequiredProperties(Utils::Property::Energy | Utils::Property::AtomicCharges |
+                                      Utils::Property::BondOrderMatrix);
+    const auto& results = calculator->calculate("");
+    const std::vector<double> charges = calculator->getPopulationAnalysis().getMullikenCharges();
+    for (int a = 0; a < water.size(); ++a) {
+      EXPECT_THAT(charges[a], DoubleNear(results.get<Utils::Property::AtomicCharges>()[a], 1e-8));
+    }
+    EXPECT_THAT(results.get<Utils::Property::BondOrderMatrix>().getOrder(0, 1), DoubleNear(0.9, 0.1));
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
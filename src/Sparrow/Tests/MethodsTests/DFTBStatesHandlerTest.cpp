@@ -5,6 +5,7 @@
  *            See LICENSE.txt for details.
  */
 
+#include "IterationCounter.h"
 #include <Core/Interfaces/Calculator.h>
 #include <Core/Log.h>
 #include <Core/ModuleManager.h>
@@ -15,6 +16,7 @@
 #include <Utils/CalculatorBasics.h>
 #include <Utils/Geometry/AtomCollection.h>
 #include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
 #include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingsNames.h>
 #include <gmock/gmock.h>
@@ -194,5 +196,39 @@ TEST_F(ADFTBStatesHandlerTest, CanUseStatesToCloneCalculator) {
   auto clonedCalculator = interfaceDFTB0_->clone();
   clonedCalculator->loadState(state);
 }
+
+TEST_F(ADFTBStatesHandlerTest, RestartsFromSnapshotWithDFTB3) {
+  interfaceDFTB3_->settings().modifyBool("state_snapshots", true);
+  interfaceDFTB3_->settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+  auto reference = interfaceDFTB3_->calculate("");
+  auto state = interfaceDFTB3_->getState();
+
+  auto runScf = [&](const Utils::PositionCollection& positions, bool restart) {
+    auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceDFTB3_->clone());
+    calculator->setStructure(ethanol_);
+    if (restart) {
+      calculator->loadState(state);
+    }
+    calculator->modifyPositions(positions);
+    auto counter = std::make_shared<IterationCounter>();
+    dynamic_cast<Utils::ScfMethod&>(calculator->getLcaoMethod()).addModifier(counter);
+    double energy = calculator->calculate("").get<Utils::Property::Energy>();
+    return std::make_pair(energy, counter->nIterations);
+  };
+
+  // Same geometry: no SCF iteration
+  auto restored = runScf(ethanol_.getPositions(), true);
+  ASSERT_THAT(restored.first, DoubleNear(reference.get<Utils::Property::Energy>(), 1e-12));
+  ASSERT_THAT(restored.second, Eq(0));
+
+  // Nearby geometry: the stored Fock matrix in the new overlap metric is a better guess than the standard one
+  Utils::PositionCollection displaced = ethanol_.getPositions();
+  displaced(7, 0) += 0.05;
+  displaced(8, 1) -= 0.05;
+  auto standard = runScf(displaced, false);
+  auto restarted = runScf(displaced, true);
+  ASSERT_THAT(restarted.first, DoubleNear(standard.first, 1e-7));
+  ASSERT_THAT(restarted.second, Lt(standard.second));
+}
 } // namespace Sparrow
 } // namespace Scine
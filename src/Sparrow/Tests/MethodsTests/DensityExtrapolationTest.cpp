@@ -0,0 +1,213 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "IterationCounter.h"
+#include <Core/Log.h>
+#include <Sparrow/Implementations/DensityExtrapolator.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/Wrapper/DFTB3MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <Eigen/Eigenvalues>
+#include <numeric>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class ADensityExtrapolator : public Test {
+ public:
+  DensityExtrapolator extrapolator;
+  Utils::PositionCollection positions = Utils::PositionCollection::Zero(2, 3);
+
+  Utils::PositionCollection at(double x) const {
+    Utils::PositionCollection shifted = positions;
+    shifted(1, 0) = x;
+    return shifted;
+  }
+
+  // Idempotent density of nOccupied doubly occupied orbitals orthonormal in the metric S.
+  static Eigen::MatrixXd idempotentDensity(const Eigen::MatrixXd& overlap, int nOccupied, double angle) {
+    const int n = static_cast<int>(overlap.rows());
+    Eigen::MatrixXd rotation = Eigen::MatrixXd::Identity(n, n);
+    rotation(0, 0) = rotation(n - 1, n - 1) = std::cos(angle);
+    rotation(0, n - 1) = std::sin(angle);
+    rotation(n - 1, 0) = -std::sin(angle);
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(overlap);
+    Eigen::MatrixXd occupied = solver.operatorInverseSqrt() * rotation.leftCols(nOccupied);
+    return 2 * occupied * occupied.transpose();
+  }
+
+  static Eigen::MatrixXd overlapAt(double x) {
+    Eigen::MatrixXd overlap = Eigen::MatrixXd::Identity(4, 4);
+    overlap(0, 2) = overlap(2, 0) = 0.3 * std::exp(-0.5 * x);
+    overlap(1, 3) = overlap(3, 1) = 0.2 * std::exp(-0.5 * x);
+    return overlap;
+  }
+};
+
+TEST_F(ADensityExtrapolator, HasTimeReversibleCoefficients) {
+  EXPECT_THAT(DensityExtrapolator::aspcCoefficients(0), ElementsAre(DoubleEq(2.0), DoubleEq(-1.0)));
+  EXPECT_THAT(DensityExtrapolator::aspcCoefficients(1), ElementsAre(DoubleEq(2.5), DoubleEq(-2.0), DoubleEq(0.5)));
+  for (int order = 0; order <= 8; ++order) {
+    auto coefficients = DensityExtrapolator::aspcCoefficients(order);
+    ASSERT_THAT(coefficients.size(), Eq(order + 2));
+    EXPECT_THAT(std::accumulate(coefficients.begin(), coefficients.end(), 0.0), DoubleNear(1.0, 1e-12));
+  }
+}
+
+TEST_F(ADensityExtrapolator, ExtrapolatesLinearSequenceExactly) {
+  extrapolator.setMode(DensityExtrapolator::Mode::Aspc, 2);
+  const Eigen::MatrixXd a = Eigen::MatrixXd::Identity(4, 4);
+  Eigen::MatrixXd b = Eigen::MatrixXd::Random(4, 4);
+  b = 0.01 * (b + b.transpose()).eval();
+  Utils::DensityMatrix guess;
+  for (int step = 0; step < 6; ++step) {
+    const double x = 0.1 * step;
+    bool extrapolated = extrapolator.extrapolate(at(x), {}, guess);
+    ASSERT_THAT(extrapolated, Eq(step >= 2));
+    if (extrapolated) {
+      EXPECT_TRUE(guess.restrictedMatrix().isApprox(a + step * b, 1e-10));
+      EXPECT_THAT(guess.numberElectrons(), Eq(4));
+    }
+    Utils::DensityMatrix density;
+    density.setDensity(a + step * b, 4);
+    extrapolator.addStep(at(x), {}, density);
+  }
+  EXPECT_THAT(extrapolator.historySize(), Eq(4));
+}
+
+TEST_F(ADensityExtrapolator, GivesIdempotentDensityInLowdinMode) {
+  extrapolator.setMode(DensityExtrapolator::Mode::Lowdin, 1);
+  for (int step = 0; step < 3; ++step) {
+    const double x = 1.0 + 0.1 * step;
+    Utils::DensityMatrix density;
+    density.setDensity(idempotentDensity(overlapAt(x), 2, 0.05 * step), 4);
+    extrapolator.addStep(at(x), overlapAt(x), density);
+  }
+  Utils::DensityMatrix guess;
+  const Eigen::MatrixXd overlap = overlapAt(1.3);
+  ASSERT_TRUE(extrapolator.extrapolate(at(1.3), overlap, guess));
+  const Eigen::MatrixXd& p = guess.restrictedMatrix();
+  EXPECT_TRUE((p * overlap * p).isApprox(2 * p, 1e-10));
+  EXPECT_THAT((p * overlap).trace(), DoubleNear(4.0, 1e-10));
+  // Close to the density continuing the sequence
+  EXPECT_THAT((p - idempotentDensity(overlap, 2, 0.15)).norm(), Lt(1e-2));
+}
+
+TEST_F(ADensityExtrapolator, RestartsHistoryAfterLargeDisplacement) {
+  extrapolator.setMode(DensityExtrapolator::Mode::Aspc, 1);
+  Utils::DensityMatrix density;
+  density.setDensity(Eigen::MatrixXd::Identity(4, 4), 4);
+  extrapolator.addStep(at(0.0), {}, density);
+  extrapolator.addStep(at(0.1), {}, density);
+  Utils::DensityMatrix guess;
+  EXPECT_FALSE(extrapolator.extrapolate(at(2.0), {}, guess));
+  extrapolator.addStep(at(2.0), {}, density);
+  EXPECT_THAT(extrapolator.historySize(), Eq(1));
+  // Different number of electrons
+  density.setDensity(Eigen::MatrixXd::Identity(4, 4), 2);
+  extrapolator.addStep(at(2.1), {}, density);
+  EXPECT_THAT(extrapolator.historySize(), Eq(1));
+}
+
+TEST_F(ADensityExtrapolator, IsDisabledByDefault) {
+  PM6MethodWrapper calculator;
+  ASSERT_THAT(calculator.settings().getString("density_extrapolation"), Eq("none"));
+}
+
+/**
+ * Velocity Verlet trajectory of a vibrating water molecule with a fixed time step. The extrapolation must save SCF
+ * iterations without increasing the drift of the total energy.
+ */
+class ADensityExtrapolationTrajectory : public Test {
+ public:
+  struct Trajectory {
+    double energyDrift = 0;
+    int nIterations = 0;
+  };
+
+  Utils::AtomCollection water;
+
+  void SetUp() override {
+    // Stretched O-H bonds
+    std::stringstream ss("3\n\n"
+                         "O      0.0000000000    0.0000000000    0.1173000000\n"
+                         "H      0.0000000000    0.8400000000   -0.5000000000\n"
+                         "H      0.0000000000   -0.7300000000   -0.4692000000\n");
+    water = Utils::XyzStreamHandler::read(ss);
+  }
+
+  Trajectory run(GenericMethodWrapper& calculator, const std::string& extrapolation) {
+    // Atomic mass units in electron masses
+    const double massConversion = 1822.888486;
+    const double timeStep = 10.0;
+    const int nSteps = 40;
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-9);
+    calculator.settings().modifyString("density_extrapolation", extrapolation);
+    calculator.setStructure(water);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    auto counter = std::make_shared<IterationCounter>();
+    dynamic_cast<Utils::ScfMethod&>(calculator.getLcaoMethod()).addModifier(counter);
+
+    Eigen::VectorXd masses(water.size());
+    for (int i = 0; i < water.size(); ++i) {
+      masses[i] = Utils::ElementInfo::mass(water.getElement(i)) * massConversion;
+    }
+    Utils::PositionCollection positions = water.getPositions();
+    Utils::PositionCollection velocities = Utils::PositionCollection::Zero(water.size(), 3);
+    auto results = calculator.calculate("");
+    Utils::GradientCollection gradients = results.get<Utils::Property::Gradients>();
+    const double initialEnergy = results.get<Utils::Property::Energy>();
+
+    Trajectory trajectory;
+    for (int step = 0; step < nSteps; ++step) {
+      Utils::PositionCollection accelerations = -(masses.cwiseInverse().asDiagonal() * gradients);
+      positions += timeStep * velocities + 0.5 * timeStep * timeStep * accelerations;
+      calculator.modifyPositions(positions);
+      results = calculator.calculate("");
+      EXPECT_TRUE(results.get<Utils::Property::SuccessfulCalculation>());
+      gradients = results.get<Utils::Property::Gradients>();
+      velocities += 0.5 * timeStep * (accelerations - masses.cwiseInverse().asDiagonal() * gradients);
+      double kineticEnergy = 0.5 * (masses.asDiagonal() * velocities.rowwise().squaredNorm()).sum();
+      double drift = std::abs(results.get<Utils::Property::Energy>() + kineticEnergy - initialEnergy);
+      trajectory.energyDrift = std::max(trajectory.energyDrift, drift);
+    }
+    trajectory.nIterations = counter->nIterations;
+    return trajectory;
+  }
+
+  template<class Wrapper>
+  void compareExtrapolations() {
+    Wrapper standard, aspc, lowdin;
+    auto reference = run(standard, "none");
+    for (auto extrapolated : {run(aspc, "aspc"), run(lowdin, "lowdin")}) {
+      EXPECT_THAT(extrapolated.nIterations, Lt(reference.nIterations));
+      EXPECT_THAT(extrapolated.energyDrift, Lt(reference.energyDrift + 1e-6));
+    }
+    EXPECT_THAT(reference.energyDrift, Lt(1e-4));
+  }
+};
+
+TEST_F(ADensityExtrapolationTrajectory, ConservesEnergyWithPM6) {
+  compareExtrapolations<PM6MethodWrapper>();
+}
+
+TEST_F(ADensityExtrapolationTrajectory, ConservesEnergyWithDFTB3) {
+  compareExtrapolations<DFTB3MethodWrapper>();
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb0/Wrapper/DFTB0MethodWrapper.h>
+#include <Sparrow/Implementations/Dftb/Dftb2/Wrapper/DFTB2MethodWrapper.h>
+#include <Sparrow/Implementations/EwaldSummation.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <iomanip>
+#include <sstream>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class APeriodicDftbCalculation : public Test {
+ public:
+  Utils::AtomCollection water;
+  // Small monoclinic cell, such that the molecule interacts with its images
+  Eigen::Matrix3d lattice;
+
+  void SetUp() override {
+    std::stringstream ss("3\n\n"
+                         "O      0.0000000000    0.0000000000    0.1173000000\n"
+                         "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                         "H      0.0000000000   -0.7572000000   -0.4692000000\n");
+    water = Utils::XyzStreamHandler::read(ss);
+    lattice << 4.2, 0.0, 0.0, 0.3, 4.6, 0.0, 0.0, 0.4, 4.4;
+    lattice *= Utils::Constants::bohr_per_angstrom;
+  }
+
+  // The setting "periodic_boundaries" for a lattice in bohr
+  static std::string cellString(const Eigen::Matrix3d& cellLattice) {
+    std::stringstream ss;
+    ss << std::setprecision(17);
+    for (int i = 0; i < 9; ++i) {
+      ss << (i > 0 ? "," : "") << cellLattice(i / 3, i % 3) * Utils::Constants::angstrom_per_bohr;
+    }
+    return ss.str();
+  }
+
+  static double energy(GenericMethodWrapper& calculator) {
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    return calculator.calculate("").get<Utils::Property::Energy>();
+  }
+
+  template<class Wrapper>
+  void setUp(Wrapper& calculator, const std::string& parameters) {
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyString(Utils::SettingsNames::methodParameters, parameters);
+    if (calculator.settings().valueExists(Utils::SettingsNames::selfConsistenceCriterion)) {
+      calculator.settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-10);
+      calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-9);
+    }
+    calculator.setStructure(water);
+    calculator.settings().modifyString("periodic_boundaries", cellString(lattice));
+  }
+
+  template<class Wrapper>
+  void checkGradients(const std::string& parameters) {
+    const double step = 1e-4;
+    Wrapper calculator;
+    setUp(calculator, parameters);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    Utils::GradientCollection gradients = calculator.calculate("").template get<Utils::Property::Gradients>();
+
+    const Utils::PositionCollection positions = water.getPositions();
+    for (int atom = 0; atom < water.size(); ++atom) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        Utils::PositionCollection displaced = positions;
+        displaced(atom, dimension) += step;
+        calculator.modifyPositions(displaced);
+        double forward = energy(calculator);
+        displaced(atom, dimension) -= 2 * step;
+        calculator.modifyPositions(displaced);
+        double backward = energy(calculator);
+        EXPECT_THAT(gradients(atom, dimension), DoubleNear((forward - backward) / (2 * step), 1e-6));
+      }
+    }
+  }
+
+  template<class Wrapper>
+  void checkStress(const std::string& parameters) {
+    const double step = 1e-4;
+    Wrapper calculator;
+    setUp(calculator, parameters);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    calculator.calculate("");
+    const Eigen::Matrix3d strainDerivatives = calculator.getStressTensor() * calculator.getPeriodicCell().getVolume();
+
+    // Homogeneous strain of the lattice vectors and of the positions
+    const Utils::PositionCollection positions = water.getPositions();
+    auto strainedEnergy = [&](int i, int j, double strain) {
+      Eigen::Matrix3d deformation = Eigen::Matrix3d::Identity();
+      deformation(i, j) += strain;
+      Utils::PositionCollection strainedPositions = positions * deformation.transpose();
+      calculator.modifyPositions(strainedPositions);
+      calculator.settings().modifyString("periodic_boundaries", cellString(lattice * deformation.transpose()));
+      return energy(calculator);
+    };
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        double numerical = (strainedEnergy(i, j, step) - strainedEnergy(i, j, -step)) / (2 * step);
+        EXPECT_THAT(strainDerivatives(i, j), DoubleNear(numerical, 1e-6));
+      }
+    }
+  }
+};
+
+TEST_F(APeriodicDftbCalculation, EwaldSummationGivesMadelungConstantOfRockSalt) {
+  // Conventional cell of NaCl with 4 formula units
+  const double a = 10.0;
+  Utils::PositionCollection positions(8, 3);
+  Eigen::VectorXd charges(8);
+  int ion = 0;
+  for (int x = 0; x < 2; ++x) {
+    for (int y = 0; y < 2; ++y) {
+      for (int z = 0; z < 2; ++z) {
+        positions.row(ion) << 0.5 * a * x, 0.5 * a * y, 0.5 * a * z;
+        charges[ion] = ((x + y + z) % 2 == 0) ? 1.0 : -1.0;
+        ++ion;
+      }
+    }
+  }
+  PeriodicCell cell;
+  cell.setLattice(a * Eigen::Matrix3d::Identity());
+  EwaldSummation ewald;
+  ewald.setCell(cell, positions);
+
+  double energy = 0.0;
+  for (int i = 0; i < 8; ++i) {
+    energy += 0.5 * charges[i] * charges[i] * ewald.getPotential(Eigen::Vector3d::Zero());
+    for (int j = i + 1; j < 8; ++j) {
+      energy += charges[i] * charges[j] * ewald.getPotential((positions.row(j) - positions.row(i)).transpose());
+    }
+  }
+  const double nearestNeighborDistance = 0.5 * a;
+  EXPECT_THAT(-energy * nearestNeighborDistance / 4, DoubleNear(1.747564594633, 1e-8));
+}
+
+TEST_F(APeriodicDftbCalculation, ReadsCellFromLengthsAndAngles) {
+  PeriodicCell cell;
+  cell.setFromString("4.0,5.0,6.0,90,90,120");
+  const auto& vectors = cell.getLattice();
+  const double bohrPerAngstrom = Utils::Constants::bohr_per_angstrom;
+  EXPECT_THAT(vectors.row(0).norm(), DoubleNear(4.0 * bohrPerAngstrom, 1e-10));
+  EXPECT_THAT(vectors.row(1).norm(), DoubleNear(5.0 * bohrPerAngstrom, 1e-10));
+  EXPECT_THAT(vectors.row(2).norm(), DoubleNear(6.0 * bohrPerAngstrom, 1e-10));
+  EXPECT_THAT(vectors.row(0).dot(vectors.row(1)) / (vectors.row(0).norm() * vectors.row(1).norm()), DoubleNear(-0.5, 1e-10));
+  EXPECT_THAT(cell.getVolume(), DoubleNear(4.0 * 5.0 * 6.0 * std::sqrt(0.75) * std::pow(bohrPerAngstrom, 3), 1e-8));
+  cell.setFromString("");
+  EXPECT_FALSE(cell.isPeriodic());
+}
+
+TEST_F(APeriodicDftbCalculation, ReproducesIsolatedMoleculeInLargeCell) {
+  DFTB2MethodWrapper calculator;
+  setUp(calculator, "mio-1-1");
+  calculator.settings().modifyString("periodic_boundaries", "");
+  const double isolated = energy(calculator);
+  calculator.settings().modifyString("periodic_boundaries", "40,40,40,90,90,90");
+  // The remaining difference is the interaction of the dipole with its images
+  EXPECT_THAT(energy(calculator), DoubleNear(isolated, 1e-5));
+  calculator.settings().modifyString("periodic_boundaries", cellString(lattice));
+  EXPECT_THAT(std::abs(energy(calculator) - isolated), Gt(1e-4));
+}
+
+TEST_F(APeriodicDftbCalculation, HasAnalyticalGradientsWithDFTB0) {
+  checkGradients<DFTB0MethodWrapper>("3ob-2-1");
+}
+
+TEST_F(APeriodicDftbCalculation, HasAnalyticalGradientsWithDFTB2) {
+  checkGradients<DFTB2MethodWrapper>("mio-1-1");
+}
+
+TEST_F(APeriodicDftbCalculation, HasAnalyticalStressWithDFTB0) {
+  checkStress<DFTB0MethodWrapper>("3ob-2-1");
+}
+
+TEST_F(APeriodicDftbCalculation, HasAnalyticalStressWithDFTB2) {
+  checkStress<DFTB2MethodWrapper>("mio-1-1");
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,283 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Interfaces/Calculator.h>
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/DFTB3.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/Wrapper/DFTB3MethodWrapper.h>
+#include <Sparrow/Implementations/FragmentDensityGuess.h>
+#include <Sparrow/Implementations/Nddo/Pm6/PM6Method.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/DataStructures/AtomsOrbitalsIndexes.h>
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/Geometry/ElementInfo.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <atomic>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+namespace {
+// Standard guess returning a vanishing density, such that the fragment blocks can be identified in the tests.
+class ZeroDensityGuess : public Utils::DensityMatrixGuessCalculator {
+ public:
+  explicit ZeroDensityGuess(const Utils::AtomsOrbitalsIndexes& aoIndexes) : aoIndexes_(aoIndexes) {
+  }
+  Utils::DensityMatrix calculateGuess() const override {
+    Utils::DensityMatrix d;
+    const int nAOs = aoIndexes_.getNAtomicOrbitals();
+    d.setDensity(Eigen::MatrixXd::Zero(nAOs, nAOs), 0);
+    return d;
+  }
+
+ private:
+  const Utils::AtomsOrbitalsIndexes& aoIndexes_;
+};
+} // namespace
+
+class AFragmentDensityGuess : public Test {
+ public:
+  Utils::ElementTypeCollection elements;
+  Utils::PositionCollection positions;
+  Utils::AtomsOrbitalsIndexes aoIndexes;
+  std::vector<double> coreCharges;
+  int nElectrons = 0;
+  std::atomic<int> nCalls{0};
+  std::unique_ptr<FragmentDensityGuess> guess;
+
+  std::string waterTrimer = "9\n\n"
+                            "O      0.0000000000    0.0000000000    0.1173000000\n"
+                            "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                            "H      0.0000000000   -0.7572000000   -0.4692000000\n"
+                            "O      4.0000000000    0.0000000000    0.1173000000\n"
+                            "H      4.0000000000    0.7572000000   -0.4692000000\n"
+                            "H      4.0000000000   -0.7572000000   -0.4692000000\n"
+                            "O      0.0000000000    4.0000000000    0.1173000000\n"
+                            "H      0.0000000000    4.7572000000   -0.4692000000\n"
+                            "H      0.0000000000    3.2428000000   -0.4692000000\n";
+  std::string pentane = "17\n\n"
+                        "C     -2.5500000000    0.2600000000    0.0000000000\n"
+                        "C     -1.2700000000   -0.5700000000    0.0000000000\n"
+                        "C      0.0000000000    0.2800000000    0.0000000000\n"
+                        "C      1.2700000000   -0.5700000000    0.0000000000\n"
+                        "C      2.5500000000    0.2600000000    0.0000000000\n"
+                        "H     -3.4300000000   -0.4000000000    0.0000000000\n"
+                        "H     -2.5900000000    0.9100000000    0.8900000000\n"
+                        "H     -2.5900000000    0.9100000000   -0.8900000000\n"
+                        "H     -1.2500000000   -1.2300000000    0.8800000000\n"
+                        "H     -1.2500000000   -1.2300000000   -0.8800000000\n"
+                        "H      0.0000000000    0.9400000000    0.8800000000\n"
+                        "H      0.0000000000    0.9400000000   -0.8800000000\n"
+                        "H      1.2500000000   -1.2300000000    0.8800000000\n"
+                        "H      1.2500000000   -1.2300000000   -0.8800000000\n"
+                        "H      3.4300000000   -0.4000000000    0.0000000000\n"
+                        "H      2.5900000000    0.9100000000    0.8900000000\n"
+                        "H      2.5900000000    0.9100000000   -0.8900000000\n";
+
+  // Sets up the structure with a minimal sp basis, as for PM6 without d orbitals.
+  void setStructure(const std::string& xyz, int charge = 0) {
+    std::stringstream ss(xyz);
+    auto structure = Utils::XyzStreamHandler::read(ss);
+    elements = structure.getElements();
+    positions = structure.getPositions();
+    aoIndexes = Utils::AtomsOrbitalsIndexes(structure.size());
+    coreCharges.clear();
+    nElectrons = -charge;
+    for (auto e : elements) {
+      bool isHydrogen = e == Utils::ElementType::H;
+      aoIndexes.addAtom(isHydrogen ? 1 : 4);
+      coreCharges.push_back(isHydrogen ? 1.0 : Utils::ElementInfo::Z(e) - 2.0);
+      nElectrons += static_cast<int>(coreCharges.back());
+    }
+    guess = std::make_unique<FragmentDensityGuess>(
+        elements, positions, aoIndexes, coreCharges, nElectrons, std::make_unique<ZeroDensityGuess>(aoIndexes),
+        [this](const Utils::AtomCollection& fragment, int fragmentCharge, Eigen::MatrixXd& density,
+               Eigen::VectorXd& populations) {
+          ++nCalls;
+          nddo::PM6Method method;
+          return FragmentDensityGuess::convergeFragment(method, fragment, fragmentCharge, true, density, populations);
+        });
+  }
+};
+
+TEST_F(AFragmentDensityGuess, DetectsNonBondedMolecules) {
+  setStructure(waterTrimer);
+  auto fragments = guess->detectFragments();
+  ASSERT_THAT(fragments.size(), Eq(3));
+  for (const auto& fragment : fragments) {
+    EXPECT_THAT(fragment.atoms.size(), Eq(3));
+    EXPECT_TRUE(fragment.cutBonds.empty());
+  }
+}
+
+TEST_F(AFragmentDensityGuess, CutsLargeFragmentsAtHeavyAtomBonds) {
+  setStructure(pentane);
+  guess->setMaxFragmentSize(2);
+  auto fragments = guess->detectFragments();
+  ASSERT_THAT(fragments.size(), Ge(3));
+
+  std::vector<int> occurrences(elements.size(), 0);
+  int nCutBonds = 0;
+  for (const auto& fragment : fragments) {
+    int nHeavyAtoms = 0;
+    for (int atom : fragment.atoms) {
+      ++occurrences[atom];
+      nHeavyAtoms += elements[atom] != Utils::ElementType::H ? 1 : 0;
+    }
+    EXPECT_THAT(nHeavyAtoms, Le(2));
+    for (const auto& bond : fragment.cutBonds) {
+      EXPECT_THAT(elements[bond.first], Ne(Utils::ElementType::H));
+      EXPECT_THAT(elements[bond.second], Ne(Utils::ElementType::H));
+    }
+    nCutBonds += static_cast<int>(fragment.cutBonds.size());
+  }
+  // Every atom belongs to exactly one fragment and every cut bond is seen from both sides
+  for (int count : occurrences) {
+    EXPECT_THAT(count, Eq(1));
+  }
+  EXPECT_THAT(nCutBonds, Eq(2 * (static_cast<int>(fragments.size()) - 1)));
+}
+
+TEST_F(AFragmentDensityGuess, CalculatesEachTopologyOnlyOnce) {
+  setStructure(waterTrimer);
+  auto density = guess->calculateGuess();
+  EXPECT_THAT(nCalls.load(), Eq(1));
+  EXPECT_THAT(guess->getNumberOfFragmentCalculations(), Eq(1));
+  EXPECT_THAT(guess->getNumberOfCachedFragments(), Eq(1));
+
+  // All three waters have the density of the isolated molecule
+  const Eigen::MatrixXd& P = density.restrictedMatrix();
+  Eigen::MatrixXd firstBlock = P.block(0, 0, 6, 6);
+  EXPECT_THAT(firstBlock.trace(), DoubleNear(8.0, 1e-5));
+  EXPECT_TRUE(P.block(6, 6, 6, 6).isApprox(firstBlock, 1e-8));
+  EXPECT_TRUE(P.block(12, 12, 6, 6).isApprox(firstBlock, 1e-8));
+  EXPECT_THAT(P.block(0, 6, 6, 12).norm(), DoubleNear(0.0, 1e-12));
+
+  // The second guess for the same structure only uses the cache
+  guess->calculateGuess();
+  EXPECT_THAT(nCalls.load(), Eq(1));
+  EXPECT_THAT(guess->getNumberOfFragmentCalculations(), Eq(0));
+  guess->clearCache();
+  EXPECT_THAT(guess->getNumberOfCachedFragments(), Eq(0));
+}
+
+TEST_F(AFragmentDensityGuess, ReusesRotatedFragments) {
+  setStructure(waterTrimer);
+  // Rotate the third water by 90 degrees around the z axis through its oxygen
+  for (int i = 7; i < 9; ++i) {
+    Eigen::RowVector3d r = positions.row(i) - positions.row(6);
+    positions.row(i) = positions.row(6) + Eigen::RowVector3d(-r.y(), r.x(), r.z());
+  }
+  auto density = guess->calculateGuess();
+  EXPECT_THAT(nCalls.load(), Eq(1));
+
+  // The p block of the rotated oxygen has its x and y components exchanged
+  const Eigen::MatrixXd& P = density.restrictedMatrix();
+  EXPECT_THAT(P(13, 13), DoubleNear(P(2, 2), 1e-6));
+  EXPECT_THAT(P(14, 14), DoubleNear(P(1, 1), 1e-6));
+}
+
+TEST_F(AFragmentDensityGuess, AssignsMolecularChargeToFragments) {
+  setStructure(waterTrimer, 2);
+  auto density = guess->calculateGuess();
+  EXPECT_THAT(density.restrictedMatrix().trace(), DoubleNear(nElectrons, 1e-5));
+}
+
+TEST_F(AFragmentDensityGuess, ScalesDensityToElectronCountWithoutLinkAtoms) {
+  setStructure(pentane);
+  guess->setMaxFragmentSize(2);
+  auto density = guess->calculateGuess();
+  EXPECT_THAT(density.restrictedMatrix().trace(), DoubleNear(nElectrons, 1e-8));
+}
+
+TEST_F(AFragmentDensityGuess, IsOnlyReplacedWhenSwitchedOnOrOff) {
+  setStructure(waterTrimer);
+  auto standardGuess = [this]() { return std::make_unique<ZeroDensityGuess>(aoIndexes); };
+  auto methodFactory = []() { return std::make_unique<nddo::PM6Method>(); };
+  auto switchGuess = [&](Utils::DensityMatrixGuessCalculator* currentGuess, bool enabled) {
+    return FragmentDensityGuess::switchGuess(currentGuess, enabled, 4, elements, positions, aoIndexes, coreCharges,
+                                             nElectrons, standardGuess, methodFactory, true);
+  };
+  ZeroDensityGuess zeroGuess(aoIndexes);
+  ASSERT_THAT(switchGuess(&zeroGuess, false), IsNull());
+  ASSERT_THAT(switchGuess(guess.get(), true), IsNull());
+  ASSERT_THAT(guess->getMaxFragmentSize(), Eq(4));
+  ASSERT_THAT(dynamic_cast<ZeroDensityGuess*>(switchGuess(guess.get(), false).get()), NotNull());
+  auto fragmentGuess = switchGuess(&zeroGuess, true);
+  ASSERT_THAT(dynamic_cast<FragmentDensityGuess*>(fragmentGuess.get()), NotNull());
+  EXPECT_THAT(fragmentGuess->calculateGuess().restrictedMatrix().trace(), DoubleNear(nElectrons, 1e-8));
+}
+
+TEST_F(AFragmentDensityGuess, LoadsDFTBParametersOnlyOnceForTheFragments) {
+  std::stringstream ss(waterTrimer);
+  auto structure = Utils::XyzStreamHandler::read(ss);
+  dftb::DFTB3 method;
+  method.setAtomCollection(structure);
+  method.initializeFromParameterPath("3ob-3-1");
+  auto parameters = method.getInitializer()->getFragmentParameterSet();
+  ASSERT_THAT(method.getInitializer()->getFragmentParameterSet(), Eq(parameters));
+
+  // A fragment method initialized with the shared parameters gives the same energy as one reading them
+  auto calculateEnergy = [&](std::shared_ptr<const dftb::ParameterSet> parameterSet) {
+    dftb::DFTB3 fragmentMethod;
+    fragmentMethod.getInitializer()->setParameterSet(std::move(parameterSet));
+    fragmentMethod.setAtomCollection(structure);
+    fragmentMethod.initializeFromParameterPath("3ob-3-1");
+    auto log = Core::Log::silent();
+    fragmentMethod.convergedCalculation(log, Utils::Derivative::None);
+    return fragmentMethod.getEnergy();
+  };
+  EXPECT_THAT(calculateEnergy(parameters), DoubleNear(calculateEnergy(nullptr), 1e-10));
+}
+
+TEST_F(AFragmentDensityGuess, IsDisabledByDefault) {
+  PM6MethodWrapper calculator;
+  ASSERT_FALSE(calculator.settings().getBool("fragment_density_guess"));
+}
+
+TEST_F(AFragmentDensityGuess, GivesSamePM6EnergyAsStandardGuess) {
+  for (const auto& xyz : {waterTrimer, pentane}) {
+    std::stringstream ss(xyz);
+    auto structure = Utils::XyzStreamHandler::read(ss);
+    auto calculate = [&](bool fragmentGuess) {
+      PM6MethodWrapper calculator;
+      calculator.setLog(Core::Log::silent());
+      calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+      calculator.settings().modifyBool("fragment_density_guess", fragmentGuess);
+      calculator.settings().modifyInt("max_fragment_size", 2);
+      calculator.setStructure(structure);
+      calculator.setRequiredProperties(Utils::Property::Energy);
+      return calculator.calculate("").get<Utils::Property::Energy>();
+    };
+    EXPECT_THAT(calculate(true), DoubleNear(calculate(false), 1e-7));
+  }
+}
+
+TEST_F(AFragmentDensityGuess, GivesSameDFTB3EnergyAsStandardGuess) {
+  std::stringstream ss(waterTrimer);
+  auto structure = Utils::XyzStreamHandler::read(ss);
+  auto calculate = [&](bool fragmentGuess) {
+    DFTB3MethodWrapper calculator;
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+    calculator.settings().modifyBool("fragment_density_guess", fragmentGuess);
+    calculator.setStructure(structure);
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    return calculator.calculate("").get<Utils::Property::Energy>();
+  };
+  EXPECT_THAT(calculate(true), DoubleNear(calculate(false), 1e-7));
+}
+
+} // namespace Sparrow
+} // namespace Scine
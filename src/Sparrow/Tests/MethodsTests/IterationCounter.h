@@ -0,0 +1,30 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#ifndef SPARROW_TESTS_ITERATIONCOUNTER_H
+#define SPARROW_TESTS_ITERATIONCOUNTER_H
+
+#include <Utils/Scf/MethodInterfaces/ScfModifier.h>
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * @brief Counts the SCF iterations of a method through the number of Fock matrix constructions.
+ */
+class IterationCounter : public Utils::ScfModifier {
+ public:
+  void onFockCalculated() override {
+    ++nIterations;
+  }
+  int nIterations = 0;
+};
+
+} // namespace Sparrow
+} // namespace Scine
+
+#endif // SPARROW_TESTS_ITERATIONCOUNTER_H
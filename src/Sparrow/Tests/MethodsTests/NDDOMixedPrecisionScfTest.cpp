@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Interfaces/Calculator.h>
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Nddo/Am1/Wrapper/AM1TypeMethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Mndo/Wrapper/MNDOMethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/PM6Method.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Utils/FockMatrix.h>
+#include <Sparrow/Implementations/Nddo/Utils/TwoElectronMatrix.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class ANDDOMixedPrecisionScf : public Test {
+ public:
+  Core::Log log;
+  // Reference molecules of the PM6, AM1 and MNDO tests
+  std::vector<std::string> molecules = {"9\n\n"
+                                        "H      1.9655905060   -0.0263662325    1.0690084915\n"
+                                        "C      1.3088788172   -0.0403821764    0.1943189946\n"
+                                        "H      1.5790293586    0.8034866305   -0.4554748131\n"
+                                        "H      1.5186511399   -0.9518066799   -0.3824432806\n"
+                                        "C     -0.1561112248    0.0249676675    0.5877379610\n"
+                                        "H     -0.4682794700   -0.8500294693    1.1854276282\n"
+                                        "H     -0.4063173598    0.9562730342    1.1264955766\n"
+                                        "O     -0.8772416674    0.0083263307   -0.6652828084\n"
+                                        "H     -1.8356000997    0.0539308952   -0.5014877498\n",
+                                        "5\n\n"
+                                        "C      0.0000000000    0.0000000000    0.0000000000\n"
+                                        "H      0.6287000000    0.6287000000    0.6287000000\n"
+                                        "H     -0.6287000000   -0.6287000000    0.6287000000\n"
+                                        "H     -0.6287000000    0.6287000000   -0.6287000000\n"
+                                        "H      0.6287000000   -0.6287000000   -0.6287000000\n",
+                                        "4\n\n"
+                                        "C      0.0000000000    0.0000000000    0.0000000000\n"
+                                        "H      0.6287000000    0.6287000000    0.6287000000\n"
+                                        "H     -0.6287000000   -0.6287000000    0.6287000000\n"
+                                        "O     -0.6287000000    0.6287000000   -0.6287000000\n",
+                                        "2\n\n"
+                                        "Cl    -0.9900000000    0.0000000000   -0.0000000000\n"
+                                        "Cl     0.9900000000    0.0000000000    0.0000000000\n"};
+
+  void SetUp() override {
+    log = Core::Log::silent();
+  }
+
+  // Calculates energy and gradients with and without the mixed-precision mode and compares them.
+  template<class MethodWrapper>
+  void expectSameResultsInMixedPrecision(const std::string& xyz, bool unrestricted = false) {
+    std::stringstream ss(xyz);
+    auto structure = Utils::XyzStreamHandler::read(ss);
+
+    auto calculate = [&](bool mixedPrecision) {
+      MethodWrapper calculator;
+      calculator.setLog(Core::Log::silent());
+      calculator.settings().modifyInt(Utils::SettingsNames::maxScfIterations, 10000);
+      calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+      calculator.settings().modifyBool("mixed_precision_scf", mixedPrecision);
+      if (unrestricted) {
+        calculator.settings().modifyString(Utils::SettingsNames::spinMode, "unrestricted");
+        calculator.settings().modifyInt(Utils::SettingsNames::spinMultiplicity, 3);
+      }
+      calculator.setStructure(structure);
+      calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+      return calculator.calculate("");
+    };
+
+    auto reference = calculate(false);
+    auto mixed = calculate(true);
+    EXPECT_THAT(mixed.template get<Utils::Property::Energy>(),
+                DoubleNear(reference.template get<Utils::Property::Energy>(), 1e-6));
+    const auto& referenceGradients = reference.template get<Utils::Property::Gradients>();
+    const auto& gradients = mixed.template get<Utils::Property::Gradients>();
+    for (int i = 0; i < gradients.rows(); ++i) {
+      for (int j = 0; j < 3; ++j) {
+        EXPECT_THAT(gradients(i, j), DoubleNear(referenceGradients(i, j), 1e-5));
+      }
+    }
+  }
+};
+
+TEST_F(ANDDOMixedPrecisionScf, IsDisabledByDefault) {
+  PM6MethodWrapper calculator;
+  ASSERT_FALSE(calculator.settings().getBool("mixed_precision_scf"));
+  nddo::PM6Method method;
+  ASSERT_FALSE(method.getFockMatrix().usesMixedPrecision());
+}
+
+TEST_F(ANDDOMixedPrecisionScf, StartsInSinglePrecisionAndFinishesInDoublePrecision) {
+  std::stringstream ss(molecules[0]);
+  auto structure = Utils::XyzStreamHandler::read(ss);
+  nddo::PM6Method method;
+  method.setConvergenceCriteria({1e-7, 1e-8});
+  method.getFockMatrix().setMixedPrecision(true, 1e-4);
+  method.setStructure(structure);
+  method.convergedCalculation(log, Utils::Derivative::First);
+
+  ASSERT_THAT(method.getFockMatrix().getNumberOfSinglePrecisionIterations(), Gt(0));
+  ASSERT_FALSE(method.getTwoElectronMatrix().usesSinglePrecision());
+}
+
+TEST_F(ANDDOMixedPrecisionScf, ConvergesForVanishingHandOffThreshold) {
+  std::stringstream ss(molecules[0]);
+  auto structure = Utils::XyzStreamHandler::read(ss);
+  nddo::PM6Method reference;
+  reference.setConvergenceCriteria({1e-7, 1e-8});
+  reference.setStructure(structure);
+  reference.convergedCalculation(log);
+
+  nddo::PM6Method method;
+  method.setConvergenceCriteria({1e-7, 1e-8});
+  method.getFockMatrix().setMixedPrecision(true, 0.0);
+  method.setStructure(structure);
+  method.convergedCalculation(log);
+  ASSERT_THAT(method.getEnergy(), DoubleNear(reference.getEnergy(), 1e-6));
+}
+
+TEST_F(ANDDOMixedPrecisionScf, RefinesDensityConvergedInSinglePrecision) {
+  std::stringstream ss(molecules[0]);
+  auto structure = Utils::XyzStreamHandler::read(ss);
+  nddo::PM6Method reference;
+  reference.setConvergenceCriteria({1e-7, 1e-8});
+  reference.setStructure(structure);
+  reference.convergedCalculation(log);
+
+  // The loose criteria are met before the hand-off threshold is reached
+  nddo::PM6Method method;
+  method.setConvergenceCriteria({1e-6, 1e-4});
+  method.getFockMatrix().setMixedPrecision(true, 0.0);
+  method.setStructure(structure);
+  method.convergedCalculation(log);
+  ASSERT_TRUE(method.getFockMatrix().endedInSinglePrecision());
+  ASSERT_THAT(method.getEnergy(), DoubleNear(reference.getEnergy(), 1e-4));
+
+  method.setConvergenceCriteria({1e-7, 1e-8});
+  method.getFockMatrix().continueInDoublePrecision();
+  method.convergedCalculation(log);
+  ASSERT_FALSE(method.getFockMatrix().endedInSinglePrecision());
+  ASSERT_THAT(method.getFockMatrix().getNumberOfSinglePrecisionIterations(), Gt(0));
+  ASSERT_THAT(method.getEnergy(), DoubleNear(reference.getEnergy(), 1e-6));
+}
+
+TEST_F(ANDDOMixedPrecisionScf, GivesSamePM6EnergiesAndGradients) {
+  for (const auto& molecule : molecules) {
+    expectSameResultsInMixedPrecision<PM6MethodWrapper>(molecule);
+  }
+}
+
+TEST_F(ANDDOMixedPrecisionScf, GivesSameAM1EnergiesAndGradients) {
+  for (const auto& molecule : molecules) {
+    expectSameResultsInMixedPrecision<AM1MethodWrapper>(molecule);
+  }
+}
+
+TEST_F(ANDDOMixedPrecisionScf, GivesSameMNDOEnergiesAndGradients) {
+  for (const auto& molecule : molecules) {
+    expectSameResultsInMixedPrecision<MNDOMethodWrapper>(molecule);
+  }
+}
+
+TEST_F(ANDDOMixedPrecisionScf, GivesSameUnrestrictedEnergiesAndGradients) {
+  expectSameResultsInMixedPrecision<PM6MethodWrapper>("2\n\n"
+                                                      "O     0.0000000000    0.0000000000    0.0000000000\n"
+                                                      "O     1.2100000000    0.0000000000    0.0000000000\n",
+                                                      true);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -5,19 +5,24 @@
  *            See LICENSE.txt for details.
  */
 
+#include "IterationCounter.h"
 #include <Core/Interfaces/Calculator.h>
 #include <Core/Log.h>
 #include <Core/ModuleManager.h>
 #include <Sparrow/Implementations/GenericMethodWrapper.h>
 #include <Sparrow/Implementations/Nddo/Pm6/PM6Method.h>
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISLinearResponseTimeDependentCalculator.h>
 #include <Sparrow/Implementations/Nddo/Utils/OneElectronMatrix.h>
 #include <Sparrow/Implementations/Nddo/Utils/TwoElectronMatrix.h>
 #include <Sparrow/StatesHandling/SparrowState.h>
 #include <Utils/CalculatorBasics/PropertyList.h>
 #include <Utils/Geometry/AtomCollection.h>
 #include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
+#include <Utils/Settings.h>
 #include <Utils/UniversalSettings/SettingsNames.h>
 #include <gmock/gmock.h>
+#include <functional>
 
 using namespace testing;
 
@@ -130,5 +135,151 @@ TEST_F(ANDDOStatesHandlerTest, GetsCurrentStateCorrectly) {
     }
   }
 }
+
+TEST_F(ANDDOStatesHandlerTest, StoresSnapshotsOnlyIfEnabled) {
+  interfaceMethod_->calculate("");
+  ASSERT_FALSE(std::dynamic_pointer_cast<SparrowState>(interfaceMethod_->getState())->hasSnapshot());
+
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->calculate("");
+  auto state = std::dynamic_pointer_cast<SparrowState>(interfaceMethod_->getState());
+  ASSERT_TRUE(state->hasSnapshot());
+  const auto& snapshot = *state->getSnapshot();
+  ASSERT_THAT(snapshot.positions.rows(), Eq(ethanol_.size()));
+  ASSERT_THAT(snapshot.results.get<Utils::Property::Energy>(),
+              DoubleNear(interfaceMethod_->results().get<Utils::Property::Energy>(), 1e-12));
+  // The stored Fock matrix reproduces the orbital energies
+  const Eigen::MatrixXd& C = snapshot.molecularOrbitals.restrictedMatrix();
+  Eigen::MatrixXd orbitalFock = C.transpose() * snapshot.fockMatrix.restrictedMatrix() * C;
+  const auto& energies = snapshot.singleParticleEnergies.getRestrictedEnergies();
+  for (int i = 0; i < orbitalFock.rows(); ++i) {
+    ASSERT_THAT(orbitalFock(i, i), DoubleNear(energies[i], 1e-8));
+  }
+}
+
+TEST_F(ANDDOStatesHandlerTest, ReloadsSnapshotWithoutScf) {
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+  auto reference = interfaceMethod_->calculate("");
+  auto state = interfaceMethod_->getState();
+
+  auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceMethod_->clone());
+  calculator->setStructure(ethanol_);
+  calculator->loadState(state);
+  auto counter = std::make_shared<IterationCounter>();
+  dynamic_cast<Utils::ScfMethod&>(calculator->getLcaoMethod()).addModifier(counter);
+  calculator->setRequiredProperties(Utils::Property::Energy);
+  auto results = calculator->calculate("restored");
+
+  ASSERT_TRUE(calculator->resultsRestoredFromSnapshot());
+  ASSERT_THAT(counter->nIterations, Eq(0));
+  ASSERT_THAT(results.get<Utils::Property::Energy>(), DoubleNear(reference.get<Utils::Property::Energy>(), 1e-12));
+  ASSERT_THAT(results.get<Utils::Property::Description>(), Eq("restored"));
+  // A further calculation is a regular one
+  calculator->calculate("");
+  ASSERT_FALSE(calculator->resultsRestoredFromSnapshot());
+  ASSERT_THAT(counter->nIterations, Gt(0));
+}
+
+TEST_F(ANDDOStatesHandlerTest, RestoresMethodStateForExcitedStates) {
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-9);
+  interfaceMethod_->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixAO);
+  interfaceMethod_->calculate("");
+  auto state = interfaceMethod_->getState();
+
+  auto excitationEnergies = [](std::shared_ptr<Core::Calculator> reference) -> Eigen::VectorXd {
+    CISLinearResponseTimeDependentCalculator cis;
+    cis.setLog(Core::Log::silent());
+    cis.setReferenceCalculator(std::move(reference));
+    cis.referenceCalculation();
+    cis.settings().modifyString(Utils::SettingsNames::spinBlock, "singlet");
+    cis.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 3);
+    return cis.calculate().get<Utils::Property::ExcitedStates>().singlet->eigenStates.eigenValues;
+  };
+
+  // Before the restore, the underlying method holds the orbitals of another geometry
+  auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceMethod_->clone());
+  calculator->setStructure(ethanol_);
+  Utils::PositionCollection displaced = ethanol_.getPositions();
+  displaced(0, 0) += 0.3;
+  calculator->modifyPositions(displaced);
+  calculator->calculate("");
+  calculator->modifyPositions(ethanol_.getPositions());
+  calculator->loadState(state);
+  calculator->calculate("restored");
+  ASSERT_TRUE(calculator->resultsRestoredFromSnapshot());
+
+  Eigen::VectorXd restored = excitationEnergies(calculator);
+  Eigen::VectorXd regular = excitationEnergies(interfaceMethod_);
+  ASSERT_THAT(restored.size(), Eq(regular.size()));
+  for (int i = 0; i < regular.size(); ++i) {
+    ASSERT_THAT(restored(i), DoubleNear(regular(i), 1e-7));
+  }
+}
+
+TEST_F(ANDDOStatesHandlerTest, RestartsNearbyGeometryFromStoredFockMatrix) {
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+  interfaceMethod_->calculate("");
+  auto state = interfaceMethod_->getState();
+
+  Utils::PositionCollection displaced = ethanol_.getPositions();
+  displaced(7, 0) += 0.05;
+  displaced(8, 1) -= 0.05;
+
+  auto runScf = [&](bool restart) {
+    auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceMethod_->clone());
+    calculator->setStructure(ethanol_);
+    if (restart) {
+      calculator->loadState(state);
+    }
+    calculator->modifyPositions(displaced);
+    auto counter = std::make_shared<IterationCounter>();
+    dynamic_cast<Utils::ScfMethod&>(calculator->getLcaoMethod()).addModifier(counter);
+    double energy = calculator->calculate("").get<Utils::Property::Energy>();
+    EXPECT_FALSE(calculator->resultsRestoredFromSnapshot());
+    return std::make_pair(energy, counter->nIterations);
+  };
+  auto standard = runScf(false);
+  auto restarted = runScf(true);
+  ASSERT_THAT(restarted.first, DoubleNear(standard.first, 1e-7));
+  ASSERT_THAT(restarted.second, Lt(standard.second));
+}
+
+TEST_F(ANDDOStatesHandlerTest, IgnoresSnapshotsOfOtherSettings) {
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->calculate("");
+  auto state = interfaceMethod_->getState();
+
+  auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceMethod_->clone());
+  calculator->settings().modifyString(Utils::SettingsNames::spinMode, "unrestricted");
+  calculator->settings().modifyInt(Utils::SettingsNames::spinMultiplicity, 3);
+  calculator->setStructure(ethanol_);
+  calculator->loadState(state);
+  calculator->calculate("");
+  ASSERT_FALSE(calculator->resultsRestoredFromSnapshot());
+}
+
+TEST_F(ANDDOStatesHandlerTest, RecalculatesSnapshotsOfOtherConvergenceSettings) {
+  interfaceMethod_->settings().modifyBool("state_snapshots", true);
+  interfaceMethod_->calculate("");
+  auto state = interfaceMethod_->getState();
+
+  auto restores = [&](const std::function<void(Utils::Settings&)>& modify) {
+    auto calculator = std::dynamic_pointer_cast<GenericMethodWrapper>(interfaceMethod_->clone());
+    modify(calculator->settings());
+    calculator->setStructure(ethanol_);
+    calculator->loadState(state);
+    calculator->calculate("");
+    return calculator->resultsRestoredFromSnapshot();
+  };
+  ASSERT_TRUE(restores([](Utils::Settings& /*settings*/) {}));
+  ASSERT_FALSE(restores([](Utils::Settings& settings) {
+    settings.modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-10);
+  }));
+  ASSERT_FALSE(restores([](Utils::Settings& settings) { settings.modifyInt(Utils::SettingsNames::maxScfIterations, 3); }));
+  ASSERT_FALSE(restores([](Utils::Settings& settings) { settings.modifyString("scf_accelerator", "diis"); }));
+}
 } // namespace Sparrow
 } // namespace Scine
@@ -0,0 +1,173 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Nddo/Am1/Wrapper/AM1TypeMethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Mndo/Wrapper/MNDOMethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Sparrow/Implementations/PeriodicCell.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <iomanip>
+#include <sstream>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class APeriodicNddoCalculation : public Test {
+ public:
+  Utils::AtomCollection water;
+  // Skewed cell, such that the molecule interacts with its images beyond the closest ones
+  Eigen::Matrix3d lattice;
+
+  void SetUp() override {
+    std::stringstream ss("3\n\n"
+                         "O      0.0000000000    0.0000000000    0.1173000000\n"
+                         "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                         "H      0.0000000000   -0.7572000000   -0.4692000000\n");
+    water = Utils::XyzStreamHandler::read(ss);
+    lattice << 8.2, 0.0, 0.0, 0.6, 8.6, 0.0, 0.0, 0.8, 8.4;
+    lattice *= Utils::Constants::bohr_per_angstrom;
+  }
+
+  // The setting "periodic_boundaries" for a lattice in bohr
+  static std::string cellString(const Eigen::Matrix3d& cellLattice) {
+    std::stringstream ss;
+    ss << std::setprecision(17);
+    for (int i = 0; i < 9; ++i) {
+      ss << (i > 0 ? "," : "") << cellLattice(i / 3, i % 3) * Utils::Constants::angstrom_per_bohr;
+    }
+    return ss.str();
+  }
+
+  static double energy(GenericMethodWrapper& calculator) {
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    return calculator.calculate("").get<Utils::Property::Energy>();
+  }
+
+  template<class Wrapper>
+  void setUp(Wrapper& calculator) {
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-10);
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-9);
+    calculator.setStructure(water);
+    calculator.settings().modifyString("periodic_boundaries", cellString(lattice));
+  }
+
+  template<class Wrapper>
+  void checkGradients() {
+    const double step = 1e-4;
+    Wrapper calculator;
+    setUp(calculator);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    Utils::GradientCollection gradients = calculator.calculate("").template get<Utils::Property::Gradients>();
+
+    const Utils::PositionCollection positions = water.getPositions();
+    for (int atom = 0; atom < water.size(); ++atom) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        Utils::PositionCollection displaced = positions;
+        displaced(atom, dimension) += step;
+        calculator.modifyPositions(displaced);
+        double forward = energy(calculator);
+        displaced(atom, dimension) -= 2 * step;
+        calculator.modifyPositions(displaced);
+        double backward = energy(calculator);
+        EXPECT_THAT(gradients(atom, dimension), DoubleNear((forward - backward) / (2 * step), 1e-6));
+      }
+    }
+  }
+
+  template<class Wrapper>
+  void checkStress() {
+    const double step = 1e-4;
+    Wrapper calculator;
+    setUp(calculator);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    calculator.calculate("");
+    const Eigen::Matrix3d strainDerivatives = calculator.getStressTensor() * calculator.getPeriodicCell().getVolume();
+
+    // Homogeneous strain of the lattice vectors and of the positions
+    const Utils::PositionCollection positions = water.getPositions();
+    auto strainedEnergy = [&](int i, int j, double strain) {
+      Eigen::Matrix3d deformation = Eigen::Matrix3d::Identity();
+      deformation(i, j) += strain;
+      Utils::PositionCollection strainedPositions = positions * deformation.transpose();
+      calculator.modifyPositions(strainedPositions);
+      calculator.settings().modifyString("periodic_boundaries", cellString(lattice * deformation.transpose()));
+      return energy(calculator);
+    };
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        double numerical = (strainedEnergy(i, j, step) - strainedEnergy(i, j, -step)) / (2 * step);
+        EXPECT_THAT(strainDerivatives(i, j), DoubleNear(numerical, 1e-6));
+      }
+    }
+  }
+};
+
+TEST_F(APeriodicNddoCalculation, FindsClosestImageInSkewedCell) {
+  PeriodicCell cell;
+  Eigen::Matrix3d skewed;
+  skewed << 10.0, 0.0, 0.0, 9.0, 3.0, 0.0, 0.0, 0.0, 10.0;
+  cell.setLattice(skewed);
+  // r = 0.45 a + 0.45 b has reduced fractional coordinates, whereas its image r - b is much closer
+  const Eigen::Vector3d r(8.55, 1.35, 0.0);
+  const Eigen::Vector3d closest = cell.getMinimumImage(r);
+  EXPECT_TRUE(closest.isApprox(Eigen::Vector3d(-0.45, -1.65, 0.0), 1e-12));
+  EXPECT_TRUE((r - closest).isApprox(skewed.row(1).transpose(), 1e-12));
+  cell.clear();
+  EXPECT_TRUE(cell.getMinimumImage(r).isApprox(r));
+}
+
+TEST_F(APeriodicNddoCalculation, ReproducesIsolatedMoleculeInLargeCell) {
+  PM6MethodWrapper calculator;
+  setUp(calculator);
+  calculator.settings().modifyString("periodic_boundaries", "");
+  const double isolated = energy(calculator);
+  calculator.settings().modifyString("periodic_boundaries", "40,40,40,90,90,90");
+  // The remaining difference is the interaction of the dipole with its images
+  EXPECT_THAT(energy(calculator), DoubleNear(isolated, 1e-5));
+  calculator.settings().modifyString("periodic_boundaries", cellString(lattice));
+  EXPECT_THAT(std::abs(energy(calculator) - isolated), Gt(1e-5));
+}
+
+TEST_F(APeriodicNddoCalculation, HasAnalyticalGradientsWithPM6) {
+  checkGradients<PM6MethodWrapper>();
+}
+
+TEST_F(APeriodicNddoCalculation, HasAnalyticalGradientsWithAM1) {
+  checkGradients<AM1MethodWrapper>();
+}
+
+TEST_F(APeriodicNddoCalculation, HasAnalyticalGradientsWithMNDO) {
+  checkGradients<MNDOMethodWrapper>();
+}
+
+TEST_F(APeriodicNddoCalculation, HasAnalyticalStressWithPM6) {
+  checkStress<PM6MethodWrapper>();
+}
+
+TEST_F(APeriodicNddoCalculation, HasAnalyticalStressWithMNDO) {
+  checkStress<MNDOMethodWrapper>();
+}
+
+TEST_F(APeriodicNddoCalculation, RefusesExcitedStates) {
+  PM6MethodWrapper calculator;
+  setUp(calculator);
+  energy(calculator);
+  EXPECT_THROW(calculator.getCISData(), std::runtime_error);
+}
+
+} // namespace Sparrow
+} // namespace Scine
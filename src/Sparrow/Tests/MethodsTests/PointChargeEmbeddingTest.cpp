@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb0/Wrapper/DFTB0MethodWrapper.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/Wrapper/DFTB3MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Sparrow/Implementations/PointChargeEmbedding.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+class APointChargeEmbedding : public Test {
+ public:
+  Utils::AtomCollection water;
+  Utils::PositionCollection chargePositions;
+  Eigen::VectorXd charges;
+
+  void SetUp() override {
+    std::stringstream ss("3\n\n"
+                         "O      0.0000000000    0.0000000000    0.1173000000\n"
+                         "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                         "H      0.0000000000   -0.7572000000   -0.4692000000\n");
+    water = Utils::XyzStreamHandler::read(ss);
+    // Neutral set of point charges around the molecule, at least 4 bohr away from the origin
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    const int nCharges = 40;
+    chargePositions.resize(nCharges, 3);
+    charges.resize(nCharges);
+    for (int i = 0; i < nCharges; ++i) {
+      Eigen::RowVector3d direction(distribution(generator), distribution(generator), distribution(generator));
+      chargePositions.row(i) = (4.0 + 4.0 * std::abs(distribution(generator))) * direction.normalized();
+      charges[i] = (i % 2 == 0 ? 0.4 : -0.4);
+    }
+  }
+
+  static double energy(GenericMethodWrapper& calculator) {
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    return calculator.calculate("").get<Utils::Property::Energy>();
+  }
+
+  template<class Wrapper>
+  void checkGradients(double cutoff = 0.0) {
+    const double step = 1e-4;
+    Wrapper calculator;
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-10);
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-9);
+    calculator.settings().modifyDouble("point_charges_cutoff", cutoff);
+    calculator.setStructure(water);
+    calculator.setPointCharges(chargePositions, charges);
+    calculator.setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients |
+                                     Utils::Property::PointChargesGradients);
+    auto results = calculator.calculate("");
+    ASSERT_TRUE(results.get<Utils::Property::SuccessfulCalculation>());
+    Utils::GradientCollection gradients = results.get<Utils::Property::Gradients>();
+    Utils::GradientCollection pointChargeGradients = results.get<Utils::Property::PointChargesGradients>();
+    ASSERT_THAT(pointChargeGradients.rows(), Eq(chargePositions.rows()));
+
+    // Gradients on the atoms
+    const Utils::PositionCollection positions = water.getPositions();
+    for (int atom = 0; atom < water.size(); ++atom) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        Utils::PositionCollection displaced = positions;
+        displaced(atom, dimension) += step;
+        calculator.modifyPositions(displaced);
+        double forward = energy(calculator);
+        displaced(atom, dimension) -= 2 * step;
+        calculator.modifyPositions(displaced);
+        double backward = energy(calculator);
+        EXPECT_THAT(gradients(atom, dimension), DoubleNear((forward - backward) / (2 * step), 1e-5));
+      }
+    }
+    calculator.modifyPositions(positions);
+
+    // Gradients on some of the point charges
+    for (int charge : {0, 7, 13, 38}) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        Utils::PositionCollection displaced = chargePositions;
+        displaced(charge, dimension) += step;
+        calculator.setPointCharges(displaced, charges);
+        double forward = energy(calculator);
+        displaced(charge, dimension) -= 2 * step;
+        calculator.setPointCharges(displaced, charges);
+        double backward = energy(calculator);
+        EXPECT_THAT(pointChargeGradients(charge, dimension), DoubleNear((forward - backward) / (2 * step), 1e-5));
+      }
+    }
+  }
+
+  template<class Wrapper>
+  void checkCutoff() {
+    Wrapper calculator;
+    calculator.setLog(Core::Log::silent());
+    calculator.setStructure(water);
+    const double isolated = energy(calculator);
+    calculator.setPointCharges(chargePositions, charges);
+    const double embedded = energy(calculator);
+    EXPECT_THAT(std::abs(embedded - isolated), Gt(1e-4));
+    // A cutoff including all point charges gives the same energy
+    calculator.settings().modifyDouble("point_charges_cutoff", 20.0);
+    EXPECT_THAT(energy(calculator), DoubleNear(embedded, 1e-7));
+    // A cutoff excluding all point charges gives the energy of the isolated molecule
+    calculator.settings().modifyDouble("point_charges_cutoff", 1.0);
+    EXPECT_THAT(energy(calculator), DoubleNear(isolated, 1e-7));
+  }
+};
+
+TEST_F(APointChargeEmbedding, FindsSameNeighborsAsBruteForce) {
+  PointChargeEmbedding embedding;
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> distribution(-15.0, 15.0);
+  Utils::PositionCollection positions(2000, 3);
+  for (int i = 0; i < positions.rows(); ++i) {
+    positions.row(i) << distribution(generator), distribution(generator), distribution(generator);
+  }
+  embedding.setPointCharges(positions, Eigen::VectorXd::Ones(positions.rows()));
+  const double cutoff = 6.0;
+  embedding.setCutoff(cutoff);
+  Utils::PositionCollection qmPositions = 0.5 * positions.topRows(20);
+  embedding.updateNeighbors(qmPositions);
+  for (int atom = 0; atom < qmPositions.rows(); ++atom) {
+    std::vector<int> reference;
+    for (int i = 0; i < positions.rows(); ++i) {
+      if ((positions.row(i) - qmPositions.row(atom)).norm() <= cutoff) {
+        reference.push_back(i);
+      }
+    }
+    EXPECT_THAT(embedding.getNeighbors(atom), ContainerEq(reference));
+  }
+}
+
+TEST_F(APointChargeEmbedding, SwitchesInteractionsSmoothlyOffAtCutoff) {
+  PointChargeEmbedding embedding;
+  double derivative;
+  EXPECT_THAT(embedding.getSwitching(50.0, derivative), DoubleEq(1.0));
+  EXPECT_THAT(derivative, DoubleEq(0.0));
+  embedding.setCutoff(5.0);
+  EXPECT_THAT(embedding.getSwitching(3.0, derivative), DoubleEq(1.0));
+  EXPECT_THAT(derivative, DoubleEq(0.0));
+  EXPECT_THAT(embedding.getSwitching(5.0, derivative), DoubleEq(0.0));
+  EXPECT_THAT(derivative, DoubleEq(0.0));
+  // Continuous at the onset and at the cutoff
+  EXPECT_THAT(embedding.getSwitching(4.0 + 1e-9, derivative), DoubleNear(1.0, 1e-12));
+  EXPECT_THAT(derivative, DoubleNear(0.0, 1e-9));
+  EXPECT_THAT(embedding.getSwitching(5.0 - 1e-9, derivative), DoubleNear(0.0, 1e-12));
+  EXPECT_THAT(derivative, DoubleNear(0.0, 1e-9));
+  // Monotonic decay with the analytical derivative
+  const double step = 1e-6;
+  double previous = 1.0;
+  for (double distance : {4.1, 4.3, 4.5, 4.7, 4.9}) {
+    const double value = embedding.getSwitching(distance, derivative);
+    EXPECT_THAT(value, Lt(previous));
+    double unused;
+    const double forward = embedding.getSwitching(distance + step, unused);
+    const double backward = embedding.getSwitching(distance - step, unused);
+    EXPECT_THAT(derivative, DoubleNear((forward - backward) / (2 * step), 1e-7));
+    previous = value;
+  }
+  EXPECT_THAT(embedding.getSwitching(4.5, derivative), DoubleNear(0.5, 1e-12));
+}
+
+TEST_F(APointChargeEmbedding, ReadsPointChargesFile) {
+  const std::string filename = "point_charges_test.pc";
+  {
+    std::ofstream file(filename);
+    file << "# x y z q\n"
+         << "1.0 0.0 0.0 0.5\n"
+         << "\n"
+         << "0.0 2.0 0.0 -0.5\n";
+  }
+  PM6MethodWrapper calculator;
+  calculator.setLog(Core::Log::silent());
+  calculator.setStructure(water);
+  calculator.settings().modifyString("point_charges_file", filename);
+  energy(calculator);
+  const auto& embedding = calculator.getPointChargeEmbedding();
+  ASSERT_THAT(embedding.size(), Eq(2));
+  EXPECT_THAT(embedding.getCharges()[1], DoubleEq(-0.5));
+  EXPECT_THAT(embedding.getPositions()(1, 1), DoubleNear(2.0 * Utils::Constants::bohr_per_angstrom, 1e-12));
+  std::remove(filename.c_str());
+}
+
+TEST_F(APointChargeEmbedding, IsRejectedByDFTB0) {
+  DFTB0MethodWrapper calculator;
+  calculator.setLog(Core::Log::silent());
+  calculator.setStructure(water);
+  calculator.setPointCharges(chargePositions, charges);
+  EXPECT_THROW(energy(calculator), std::runtime_error);
+}
+
+TEST_F(APointChargeEmbedding, HasConsistentCutoffWithPM6) {
+  checkCutoff<PM6MethodWrapper>();
+}
+
+TEST_F(APointChargeEmbedding, HasConsistentCutoffWithDFTB3) {
+  checkCutoff<DFTB3MethodWrapper>();
+}
+
+TEST_F(APointChargeEmbedding, HasAnalyticalGradientsWithPM6) {
+  checkGradients<PM6MethodWrapper>();
+}
+
+TEST_F(APointChargeEmbedding, HasAnalyticalGradientsWithDFTB3) {
+  checkGradients<DFTB3MethodWrapper>();
+}
+
+TEST_F(APointChargeEmbedding, HasAnalyticalGradientsInSwitchingRegionWithPM6) {
+  // Part of the point charges are in the switching region between 4.8 and 6 bohr of the atoms
+  checkGradients<PM6MethodWrapper>(6.0);
+}
+
+TEST_F(APointChargeEmbedding, HasAnalyticalGradientsInSwitchingRegionWithDFTB3) {
+  checkGradients<DFTB3MethodWrapper>(6.0);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,208 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb2/Wrapper/DFTB2MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Sparrow/Implementations/ScfAccelerator.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/DataStructures/DensityMatrix.h>
+#include <Utils/DataStructures/SpinAdaptedMatrix.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <Eigen/Eigenvalues>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+/**
+ * Restricted Hubbard-like model in an orthogonal basis, F(P) = h + G(P) with G(P)_ii = U P_ii / 2, whose plain SCF
+ * iterations oscillate for a large U.
+ */
+class AScfAccelerator : public Test {
+ public:
+  struct Run {
+    double energy = 0;
+    int nIterations = 0;
+    bool converged = false;
+  };
+
+  const int nOrbitals = 8;
+  const int nElectrons = 6;
+  const double U = 5.0;
+  Eigen::MatrixXd h;
+
+  void SetUp() override {
+    h = Eigen::MatrixXd::Zero(nOrbitals, nOrbitals);
+    for (int i = 0; i < nOrbitals; ++i) {
+      h(i, i) = 0.3 * (i % 3);
+      if (i > 0) {
+        h(i, i - 1) = h(i - 1, i) = -1.0;
+      }
+    }
+  }
+
+  Eigen::MatrixXd twoElectronMatrix(const Eigen::MatrixXd& P) const {
+    return (0.5 * U * P.diagonal()).asDiagonal();
+  }
+
+  Eigen::MatrixXd occupiedDensity(const Eigen::MatrixXd& F) const {
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(F);
+    Eigen::MatrixXd occupied = solver.eigenvectors().leftCols(nElectrons / 2);
+    return 2 * occupied * occupied.transpose();
+  }
+
+  Run run(ScfAccelerator& accelerator) const {
+    accelerator.reset();
+    Eigen::MatrixXd P = occupiedDensity(h);
+    Run result;
+    for (result.nIterations = 1; result.nIterations <= 200; ++result.nIterations) {
+      const Eigen::MatrixXd G = twoElectronMatrix(P);
+      result.energy = P.cwiseProduct(h + 0.5 * G).sum();
+      Utils::SpinAdaptedMatrix fock;
+      fock.setRestrictedMatrix(h + G);
+      Utils::DensityMatrix density;
+      density.setDensity(Eigen::MatrixXd(P), nElectrons);
+      const Eigen::MatrixXd newP =
+          occupiedDensity(accelerator.accelerate(fock, density, {}, result.energy, false).restrictedMatrix());
+      if ((newP - P).cwiseAbs().maxCoeff() < 1e-9) {
+        result.converged = true;
+        break;
+      }
+      P = newP;
+    }
+    return result;
+  }
+};
+
+TEST_F(AScfAccelerator, ReadsModesFromSettings) {
+  EXPECT_THAT(ScfAccelerator::modeFromString("none"), Eq(ScfAccelerator::Mode::None));
+  EXPECT_THAT(ScfAccelerator::modeFromString("diis"), Eq(ScfAccelerator::Mode::Diis));
+  EXPECT_THAT(ScfAccelerator::modeFromString("ediis_diis"), Eq(ScfAccelerator::Mode::EdiisDiis));
+  EXPECT_THAT(ScfAccelerator::modeFromString("adiis_diis"), Eq(ScfAccelerator::Mode::AdiisDiis));
+  EXPECT_THROW(ScfAccelerator::modeFromString("broyden"), std::runtime_error);
+  EXPECT_FALSE(ScfAccelerator().isActive());
+}
+
+TEST_F(AScfAccelerator, MinimizesInsideTheSimplex) {
+  // (c - m)^2 with m inside the simplex
+  const Eigen::Vector3d m(0.2, 0.3, 0.5);
+  const Eigen::MatrixXd quadratic = 2 * Eigen::MatrixXd::Identity(3, 3);
+  const Eigen::VectorXd c = ScfAccelerator::minimizeOnSimplex(-2 * m, quadratic);
+  EXPECT_TRUE(c.isApprox(m, 1e-10));
+}
+
+TEST_F(AScfAccelerator, MinimizesOnTheBoundaryOfTheSimplex) {
+  // (c - m)^2 with m outside of the simplex, the minimum is its projection on the edge c_2 = 0
+  const Eigen::Vector3d m(0.8, 0.6, -0.4);
+  const Eigen::MatrixXd quadratic = 2 * Eigen::MatrixXd::Identity(3, 3);
+  const Eigen::VectorXd c = ScfAccelerator::minimizeOnSimplex(-2 * m, quadratic);
+  EXPECT_TRUE(c.isApprox(Eigen::Vector3d(0.6, 0.4, 0.0), 1e-10));
+  // Linear function: the vertex with the lowest value
+  EXPECT_TRUE(ScfAccelerator::minimizeOnSimplex(Eigen::Vector3d(1.0, -2.0, 0.5), Eigen::MatrixXd::Zero(3, 3))
+                  .isApprox(Eigen::Vector3d(0.0, 1.0, 0.0)));
+  // Concave function: the minimum is at a vertex too
+  const Eigen::VectorXd concave = ScfAccelerator::minimizeOnSimplex(Eigen::Vector3d(0.0, 0.1, 0.0), -quadratic);
+  EXPECT_THAT(concave.maxCoeff(), DoubleNear(1.0, 1e-12));
+  EXPECT_THAT(concave[1], DoubleEq(0.0));
+}
+
+TEST_F(AScfAccelerator, CancelsLinearlyDependentErrors) {
+  // e_2 = -e_1 / 2: 1/3 e_1 + 2/3 e_2 = 0
+  Eigen::Matrix2d errorProducts;
+  errorProducts << 4.0, -2.0, -2.0, 1.0;
+  const Eigen::VectorXd c = ScfAccelerator::diisCoefficients(errorProducts);
+  ASSERT_THAT(c.size(), Eq(2));
+  EXPECT_THAT(c[0], DoubleNear(1.0 / 3.0, 1e-12));
+  EXPECT_THAT(c[1], DoubleNear(2.0 / 3.0, 1e-12));
+  EXPECT_THAT(ScfAccelerator::diisCoefficients(Eigen::Matrix2d::Ones()).size(), Eq(0));
+}
+
+TEST_F(AScfAccelerator, ConvergesOscillatingModelWithAllModes) {
+  ScfAccelerator plain;
+  plain.setLevelShiftGap(0.0);
+  // Plain iterations do not converge
+  plain.setMode(ScfAccelerator::Mode::None);
+  EXPECT_FALSE(run(plain).converged);
+
+  ScfAccelerator diis;
+  diis.setMode(ScfAccelerator::Mode::Diis);
+  const Run reference = run(diis);
+  ASSERT_TRUE(reference.converged);
+  EXPECT_THAT(diis.getStatistics().nEnergyDiisIterations, Eq(0));
+  for (auto mode : {ScfAccelerator::Mode::EdiisDiis, ScfAccelerator::Mode::AdiisDiis}) {
+    ScfAccelerator accelerator;
+    accelerator.setMode(mode);
+    const Run result = run(accelerator);
+    ASSERT_TRUE(result.converged);
+    EXPECT_THAT(result.energy, DoubleNear(reference.energy, 1e-8));
+    EXPECT_THAT(accelerator.getStatistics().nIterations, Eq(result.nIterations));
+    EXPECT_THAT(accelerator.getStatistics().nEnergyDiisIterations, Gt(0));
+    EXPECT_THAT(accelerator.getLastError(), Lt(1e-6));
+  }
+}
+
+class AScfAcceleratedCalculation : public Test {
+ public:
+  Utils::AtomCollection water;
+
+  void SetUp() override {
+    std::stringstream ss("3\n\n"
+                         "O      0.0000000000    0.0000000000    0.1173000000\n"
+                         "H      0.0000000000    0.7572000000   -0.4692000000\n"
+                         "H      0.0000000000   -0.7572000000   -0.4692000000\n");
+    water = Utils::XyzStreamHandler::read(ss);
+  }
+
+  double energy(GenericMethodWrapper& calculator) const {
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-9);
+    calculator.setStructure(water);
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    const auto& results = calculator.calculate("");
+    EXPECT_TRUE(results.get<Utils::Property::SuccessfulCalculation>());
+    return results.get<Utils::Property::Energy>();
+  }
+
+  template<class Wrapper>
+  void compareModes(bool withSmearing) {
+    Wrapper standard;
+    const double reference = energy(standard);
+    for (std::string mode : {"diis", "ediis_diis", "adiis_diis"}) {
+      Wrapper accelerated;
+      accelerated.settings().modifyString("scf_accelerator", mode);
+      accelerated.settings().modifyDouble("level_shift_gap", 0.5);
+      if (withSmearing) {
+        accelerated.settings().modifyDouble("fermi_temperature", 5000.0);
+      }
+      EXPECT_THAT(energy(accelerated), DoubleNear(reference, 1e-7));
+      const auto& statistics = accelerated.getScfAccelerator().getStatistics();
+      EXPECT_THAT(statistics.nIterations, Gt(1));
+      EXPECT_THAT(statistics.nLevelShiftIterations, Lt(statistics.nIterations));
+      if (withSmearing) {
+        EXPECT_THAT(statistics.nSmearingIterations, Gt(0));
+        EXPECT_THAT(statistics.nSmearingIterations, Lt(statistics.nIterations));
+      }
+    }
+  }
+};
+
+TEST_F(AScfAcceleratedCalculation, ReproducesPM6Energy) {
+  compareModes<PM6MethodWrapper>(false);
+}
+
+TEST_F(AScfAcceleratedCalculation, ReproducesDFTB2Energy) {
+  compareModes<DFTB2MethodWrapper>(true);
+}
+
+} // namespace Sparrow
+} // namespace Scine
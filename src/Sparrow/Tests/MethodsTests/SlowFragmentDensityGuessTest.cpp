@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/DFTB3.h>
+#include <Sparrow/Implementations/Nddo/Pm6/PM6Method.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <gmock/gmock.h>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+/**
+ * Comparison of the fragment density guess with the standard guess on larger structures, the SCF has to converge to
+ * the same energy.
+ */
+class SlowFragmentDensityGuess : public Test {
+ public:
+  Core::Log log = Core::Log::silent();
+
+  // Cubic cluster of n^3 water molecules with 2.9 Angstrom O-O distance and alternating orientations.
+  static Utils::AtomCollection waterCluster(int n) {
+    Utils::AtomCollection cluster;
+    const double spacing = 2.9 * Utils::Constants::bohr_per_angstrom;
+    const Eigen::RowVector3d h1(0.0, 0.7572, -0.5865), h2(0.0, -0.7572, -0.5865);
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        for (int k = 0; k < n; ++k) {
+          Eigen::RowVector3d o(i * spacing, j * spacing, k * spacing);
+          Eigen::RowVector3d a = h1, b = h2;
+          if ((i + j + k) % 2 == 1) {
+            a = Eigen::RowVector3d(h1.y(), h1.x(), h1.z());
+            b = Eigen::RowVector3d(h2.y(), h2.x(), h2.z());
+          }
+          cluster.push_back(Utils::Atom(Utils::ElementType::O, o));
+          cluster.push_back(Utils::Atom(Utils::ElementType::H, o + a * Utils::Constants::bohr_per_angstrom));
+          cluster.push_back(Utils::Atom(Utils::ElementType::H, o + b * Utils::Constants::bohr_per_angstrom));
+        }
+      }
+    }
+    return cluster;
+  }
+
+  // All-trans alkane chain with n carbon atoms.
+  static Utils::AtomCollection alkane(int n) {
+    Utils::AtomCollection chain;
+    const double toBohr = Utils::Constants::bohr_per_angstrom;
+    for (int i = 0; i < n; ++i) {
+      const double sign = i % 2 == 0 ? 1.0 : -1.0;
+      Eigen::RowVector3d c(1.27 * i, 0.43 * sign, 0.0);
+      chain.push_back(Utils::Atom(Utils::ElementType::C, c * toBohr));
+      chain.push_back(Utils::Atom(Utils::ElementType::H, (c + Eigen::RowVector3d(0.0, 0.63 * sign, 0.88)) * toBohr));
+      chain.push_back(Utils::Atom(Utils::ElementType::H, (c + Eigen::RowVector3d(0.0, 0.63 * sign, -0.88)) * toBohr));
+      if (i == 0 || i == n - 1) {
+        const double direction = i == 0 ? -1.0 : 1.0;
+        chain.push_back(
+            Utils::Atom(Utils::ElementType::H, (c + Eigen::RowVector3d(1.02 * direction, -0.36 * sign, 0.0)) * toBohr));
+      }
+    }
+    return chain;
+  }
+
+  // The structure must already be set for the method.
+  template<class Method>
+  void converge(Method& method, bool fragmentGuess) {
+    method.setConvergenceCriteria({1e-7, 1e-7});
+    method.setMaxIterations(10000);
+    method.setFragmentDensityGuess(fragmentGuess, 8);
+    method.convergedCalculation(log, Utils::Derivative::None);
+    ASSERT_TRUE(method.hasConverged());
+  }
+
+  void comparePM6(const Utils::AtomCollection& structure) {
+    nddo::PM6Method standard, fragment;
+    standard.setStructure(structure);
+    fragment.setStructure(structure);
+    converge(standard, false);
+    converge(fragment, true);
+    EXPECT_THAT(fragment.getEnergy(), DoubleNear(standard.getEnergy(), 1e-6));
+  }
+
+  void compareDFTB3(const Utils::AtomCollection& structure) {
+    dftb::DFTB3 standard, fragment;
+    standard.setAtomCollection(structure);
+    standard.initializeFromParameterPath("3ob-3-1");
+    fragment.setAtomCollection(structure);
+    fragment.initializeFromParameterPath("3ob-3-1");
+    converge(standard, false);
+    converge(fragment, true);
+    EXPECT_THAT(fragment.getEnergy(), DoubleNear(standard.getEnergy(), 1e-6));
+  }
+};
+
+TEST_F(SlowFragmentDensityGuess, WaterCluster) {
+  auto cluster = waterCluster(4);
+  comparePM6(cluster);
+  compareDFTB3(cluster);
+}
+
+TEST_F(SlowFragmentDensityGuess, LongAlkane) {
+  auto chain = alkane(40);
+  comparePM6(chain);
+  compareDFTB3(chain);
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "IterationCounter.h"
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Dftb/Dftb2/Wrapper/DFTB2MethodWrapper.h>
+#include <Sparrow/Implementations/Dftb/Dftb3/Wrapper/DFTB3MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/Constants.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+/**
+ * SCF accelerators on hard cases: an open-shell transition metal complex, a stretched bond, an anion and a conjugated
+ * chain with a small gap. The accelerated calculations must converge, and wherever the standard mixer converges, they
+ * must reach its energy in at most as many SCF iterations.
+ */
+class SlowScfAccelerator : public Test {
+ public:
+  struct Run {
+    bool converged = false;
+    double energy = 0;
+    int nIterations = 0;
+  };
+
+  // All-trans polyene C_nH_(n+2) with equal C-C bonds of 1.40 Angstrom, which closes the HOMO-LUMO gap.
+  static Utils::AtomCollection polyene(int n) {
+    Utils::AtomCollection chain;
+    const double toBohr = Utils::Constants::bohr_per_angstrom;
+    for (int i = 0; i < n; ++i) {
+      const double sign = i % 2 == 0 ? 1.0 : -1.0;
+      Eigen::RowVector3d c(1.212 * i, 0.35 * sign, 0.0);
+      chain.push_back(Utils::Atom(Utils::ElementType::C, c * toBohr));
+      chain.push_back(Utils::Atom(Utils::ElementType::H, (c + Eigen::RowVector3d(0.0, 1.09 * sign, 0.0)) * toBohr));
+      if (i == 0 || i == n - 1) {
+        const double direction = i == 0 ? -1.0 : 1.0;
+        chain.push_back(
+            Utils::Atom(Utils::ElementType::H, (c + Eigen::RowVector3d(0.94 * direction, -0.54 * sign, 0.0)) * toBohr));
+      }
+    }
+    return chain;
+  }
+
+  static Utils::AtomCollection fromXyz(const std::string& xyz) {
+    std::stringstream ss(xyz);
+    return Utils::XyzStreamHandler::read(ss);
+  }
+
+  template<class Wrapper>
+  Run run(const Utils::AtomCollection& structure, const std::string& accelerator, int charge, int multiplicity,
+          double fermiTemperature) {
+    Wrapper calculator;
+    calculator.setLog(Core::Log::silent());
+    calculator.settings().modifyInt(Utils::SettingsNames::molecularCharge, charge);
+    calculator.settings().modifyInt(Utils::SettingsNames::spinMultiplicity, multiplicity);
+    calculator.settings().modifyInt(Utils::SettingsNames::maxScfIterations, 500);
+    calculator.settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+    calculator.settings().modifyString("scf_accelerator", accelerator);
+    if (accelerator != "none") {
+      calculator.settings().modifyDouble("level_shift_gap", 0.1);
+    }
+    if (calculator.settings().valueExists("fermi_temperature")) {
+      calculator.settings().modifyDouble("fermi_temperature", accelerator != "none" ? fermiTemperature : 0.0);
+    }
+    calculator.setStructure(structure);
+    calculator.setRequiredProperties(Utils::Property::Energy);
+    auto counter = std::make_shared<IterationCounter>();
+    dynamic_cast<Utils::ScfMethod&>(calculator.getLcaoMethod()).addModifier(counter);
+
+    Run result;
+    try {
+      const auto& results = calculator.calculate("");
+      result.converged = results.get<Utils::Property::SuccessfulCalculation>();
+      result.energy = results.get<Utils::Property::Energy>();
+    }
+    catch (...) {
+      result.converged = false;
+    }
+    result.nIterations = counter->nIterations;
+    return result;
+  }
+
+  template<class Wrapper>
+  void compare(const Utils::AtomCollection& structure, const std::string& name, int charge = 0,
+               int multiplicity = 1, double fermiTemperature = 0.0) {
+    const Run reference = run<Wrapper>(structure, "none", charge, multiplicity, fermiTemperature);
+    for (std::string accelerator : {"diis", "ediis_diis", "adiis_diis"}) {
+      const Run accelerated = run<Wrapper>(structure, accelerator, charge, multiplicity, fermiTemperature);
+      EXPECT_TRUE(accelerated.converged) << name << " " << accelerator;
+      if (reference.converged && accelerated.converged) {
+        EXPECT_THAT(accelerated.energy, DoubleNear(reference.energy, 1e-5)) << name << " " << accelerator;
+        EXPECT_THAT(accelerated.nIterations, Le(reference.nIterations)) << name << " " << accelerator;
+      }
+    }
+  }
+};
+
+TEST_F(SlowScfAccelerator, HighSpinIronComplex) {
+  // Tetrahedral [FeCl4]2-, quintet
+  auto complex = fromXyz("5\n\n"
+                         "Fe     0.0000000000    0.0000000000    0.0000000000\n"
+                         "Cl     1.3280000000    1.3280000000    1.3280000000\n"
+                         "Cl    -1.3280000000   -1.3280000000    1.3280000000\n"
+                         "Cl    -1.3280000000    1.3280000000   -1.3280000000\n"
+                         "Cl     1.3280000000   -1.3280000000   -1.3280000000\n");
+  compare<PM6MethodWrapper>(complex, "[FeCl4]2-", -2, 5);
+}
+
+TEST_F(SlowScfAccelerator, StretchedBond) {
+  auto nitrogen = fromXyz("2\n\n"
+                          "N      0.0000000000    0.0000000000    0.0000000000\n"
+                          "N      0.0000000000    0.0000000000    1.9000000000\n");
+  compare<PM6MethodWrapper>(nitrogen, "N2 at 1.9 Angstrom");
+  compare<DFTB3MethodWrapper>(nitrogen, "N2 at 1.9 Angstrom");
+}
+
+TEST_F(SlowScfAccelerator, Anion) {
+  auto acetate = fromXyz("7\n\n"
+                         "C      0.0000000000    0.0000000000    0.0000000000\n"
+                         "C      1.5400000000    0.0000000000    0.0000000000\n"
+                         "O      2.1100000000    1.1000000000    0.0000000000\n"
+                         "O      2.1100000000   -1.1000000000    0.0000000000\n"
+                         "H     -0.3600000000    1.0300000000    0.0000000000\n"
+                         "H     -0.3600000000   -0.5100000000    0.8900000000\n"
+                         "H     -0.3600000000   -0.5100000000   -0.8900000000\n");
+  compare<DFTB3MethodWrapper>(acetate, "Acetate", -1);
+}
+
+TEST_F(SlowScfAccelerator, ConjugatedChainWithSmearing) {
+  auto chain = polyene(20);
+  compare<DFTB2MethodWrapper>(chain, "C20H22", 0, 1, 3000.0);
+  compare<PM6MethodWrapper>(chain, "C20H22");
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,234 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include "IterationCounter.h"
+#include <Core/Interfaces/Calculator.h>
+#include <Core/Log.h>
+#include <Core/ModuleManager.h>
+#include <Sparrow/Implementations/GenericMethodWrapper.h>
+#include <Sparrow/StatesHandling/SparrowCheckpoint.h>
+#include <Sparrow/StatesHandling/SparrowState.h>
+#include <Utils/CalculatorBasics/PropertyList.h>
+#include <Utils/Geometry/AtomCollection.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Scf/MethodInterfaces/ScfMethod.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+class ASparrowCheckpoint : public Test {
+ public:
+  const std::string filename = "sparrow_checkpoint_test.chk";
+  std::shared_ptr<Core::Calculator> calculator;
+  Utils::AtomCollection ethanol;
+
+  void SetUp() override {
+    calculator = Core::ModuleManager::getInstance().get<Core::Calculator>("PM6");
+    calculator->setLog(Core::Log::silent());
+    calculator->settings().modifyBool("state_snapshots", true);
+    calculator->setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    std::stringstream ss("9\n\n"
+                         "H      1.9655905060   -0.0263662325    1.0690084915\n"
+                         "C      1.3088788172   -0.0403821764    0.1943189946\n"
+                         "H      1.5790293586    0.8034866305   -0.4554748131\n"
+                         "H      1.5186511399   -0.9518066799   -0.3824432806\n"
+                         "C     -0.1561112248    0.0249676675    0.5877379610\n"
+                         "H     -0.4682794700   -0.8500294693    1.1854276282\n"
+                         "H     -0.4063173598    0.9562730342    1.1264955766\n"
+                         "O     -0.8772416674    0.0083263307   -0.6652828084\n"
+                         "H     -1.8356000997    0.0539308952   -0.5014877498\n");
+    ethanol = Utils::XyzStreamHandler::read(ss);
+  }
+
+  void TearDown() override {
+    std::remove(filename.c_str());
+  }
+
+  // Loads the state, if any, in a new calculator and runs it, returning the energy and the number of SCF iterations.
+  std::pair<double, int> calculateFrom(std::shared_ptr<Core::State> state, bool& restored) {
+    auto restarted = std::dynamic_pointer_cast<GenericMethodWrapper>(calculator->clone());
+    restarted->setStructure(ethanol);
+    restarted->setRequiredProperties(calculator->getRequiredProperties());
+    if (state) {
+      restarted->loadState(std::move(state));
+    }
+    auto counter = std::make_shared<IterationCounter>();
+    dynamic_cast<Utils::ScfMethod&>(restarted->getLcaoMethod()).addModifier(counter);
+    double energy = restarted->calculate("").get<Utils::Property::Energy>();
+    restored = restarted->resultsRestoredFromSnapshot();
+    return {energy, counter->nIterations};
+  }
+};
+
+TEST_F(ASparrowCheckpoint, StoresMatricesAndStringsBitwise) {
+  SparrowCheckpoint checkpoint;
+  Eigen::MatrixXd special(2, 3);
+  special << -0.0, std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::infinity(),
+      std::numeric_limits<double>::max(), -1.0 / 3.0, 1e-300;
+  checkpoint.setMatrix("special", special);
+  checkpoint.setMatrix("random", Eigen::MatrixXd::Random(17, 5));
+  checkpoint.setMatrix("empty", Eigen::MatrixXd(0, 4));
+  checkpoint.setString("text", std::string("with\0null", 9));
+  checkpoint.write(filename);
+
+  for (bool memoryMapped : {true, false}) {
+    auto read = SparrowCheckpoint::read(filename, memoryMapped);
+    ASSERT_THAT(read.getNames().size(), Eq(4));
+    for (const std::string name : {"special", "random", "empty"}) {
+      const auto& matrix = read.getMatrix(name);
+      ASSERT_THAT(matrix.rows(), Eq(checkpoint.getMatrix(name).rows()));
+      ASSERT_THAT(matrix.cols(), Eq(checkpoint.getMatrix(name).cols()));
+      ASSERT_THAT(std::memcmp(matrix.data(), checkpoint.getMatrix(name).data(), sizeof(double) * matrix.size()), Eq(0));
+    }
+    ASSERT_THAT(read.getString("text"), Eq(std::string("with\0null", 9)));
+  }
+}
+
+TEST_F(ASparrowCheckpoint, WritesLittleEndianHeader) {
+  SparrowCheckpoint checkpoint;
+  checkpoint.setMatrix("a", Eigen::MatrixXd::Constant(1, 1, 1.0));
+  checkpoint.setString("b", "c");
+  std::string data = checkpoint.serialize();
+  ASSERT_THAT(data.substr(0, 8), Eq("SPARROWC"));
+  // Version and number of records
+  std::vector<unsigned char> header(data.begin() + 8, data.begin() + 16);
+  ASSERT_THAT(header, ElementsAre(SparrowCheckpoint::formatVersion, 0, 0, 0, 2, 0, 0, 0));
+  // The double 1.0 is 0x3FF0000000000000, stored after the type, the name and the dimensions of the record
+  const std::size_t valueOffset = 16 + 1 + 4 + 1 + 8 + 8;
+  std::vector<unsigned char> value(data.begin() + valueOffset, data.begin() + valueOffset + 8);
+  ASSERT_THAT(value, ElementsAre(0, 0, 0, 0, 0, 0, 0xF0, 0x3F));
+}
+
+TEST_F(ASparrowCheckpoint, RejectsTruncatedAndCorruptedData) {
+  SparrowCheckpoint checkpoint;
+  checkpoint.setMatrix("random", Eigen::MatrixXd::Random(4, 4));
+  std::string data = checkpoint.serialize();
+  for (std::size_t size : {std::size_t{0}, std::size_t{12}, data.size() - 9, data.size() - 1}) {
+    ASSERT_THROW(SparrowCheckpoint::deserialize(data.data(), size), CheckpointException);
+  }
+  data[40] ^= 0x01;
+  ASSERT_THROW(SparrowCheckpoint::deserialize(data.data(), data.size()), CheckpointException);
+  ASSERT_THROW(SparrowCheckpoint::read("non_existing_checkpoint.chk"), CheckpointException);
+}
+
+TEST_F(ASparrowCheckpoint, OverwritesExistingFileAtomically) {
+  SparrowCheckpoint first, second;
+  first.setString("step", "first");
+  second.setString("step", "second");
+  first.write(filename);
+  second.write(filename);
+  ASSERT_THAT(SparrowCheckpoint::read(filename).getString("step"), Eq("second"));
+  ASSERT_FALSE(std::ifstream(filename + ".tmp").good());
+}
+
+TEST_F(ASparrowCheckpoint, ErasesRecordsByPrefix) {
+  SparrowCheckpoint checkpoint;
+  checkpoint.setMatrix("hessian/column_0", Eigen::MatrixXd::Zero(3, 1));
+  checkpoint.setMatrix("hessian/column_1", Eigen::MatrixXd::Zero(3, 1));
+  checkpoint.setString("ground_state/fingerprint", "PM6");
+  checkpoint.erase("hessian/");
+  ASSERT_THAT(checkpoint.getNames(), ElementsAre("ground_state/fingerprint"));
+}
+
+TEST_F(ASparrowCheckpoint, ReloadsStateWithoutScf) {
+  calculator->setStructure(ethanol);
+  auto reference = calculator->calculate("");
+  SparrowCheckpoint checkpoint;
+  checkpoint.setState(*std::dynamic_pointer_cast<SparrowState>(calculator->getState()));
+  checkpoint.write(filename);
+
+  auto state = SparrowCheckpoint::read(filename).getState();
+  ASSERT_TRUE(state);
+  ASSERT_TRUE(state->hasSnapshot());
+  bool restored = false;
+  auto restarted = calculateFrom(state, restored);
+  ASSERT_TRUE(restored);
+  ASSERT_THAT(restarted.second, Eq(0));
+  ASSERT_THAT(restarted.first, DoubleNear(reference.get<Utils::Property::Energy>(), 1e-12));
+}
+
+TEST_F(ASparrowCheckpoint, RestartsUnrestrictedCalculationFromStoredFockMatrix) {
+  calculator->settings().modifyString(Utils::SettingsNames::spinMode, "unrestricted");
+  calculator->settings().modifyInt(Utils::SettingsNames::spinMultiplicity, 3);
+  calculator->settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-8);
+  calculator->setStructure(ethanol);
+  auto reference = calculator->calculate("");
+  SparrowCheckpoint checkpoint;
+  checkpoint.setState(*std::dynamic_pointer_cast<SparrowState>(calculator->getState()));
+  checkpoint.write(filename);
+  auto state = SparrowCheckpoint::read(filename).getState();
+  ASSERT_TRUE(state->getDensityMatrix().unrestricted());
+
+  // Requiring more properties than stored prevents the restoration, the SCF starts from the stored Fock matrix
+  calculator->setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients | Utils::Property::Dipole);
+  bool restored = true;
+  auto standard = calculateFrom(nullptr, restored);
+  auto restarted = calculateFrom(state, restored);
+  ASSERT_FALSE(restored);
+  ASSERT_THAT(restarted.second, Lt(standard.second));
+  ASSERT_THAT(restarted.first, DoubleNear(reference.get<Utils::Property::Energy>(), 1e-7));
+}
+
+TEST_F(ASparrowCheckpoint, StoresStatesWithoutSnapshot) {
+  calculator->settings().modifyBool("state_snapshots", false);
+  calculator->setStructure(ethanol);
+  calculator->calculate("");
+  auto state = std::dynamic_pointer_cast<SparrowState>(calculator->getState());
+  SparrowCheckpoint checkpoint;
+  checkpoint.setState(*state, "reference");
+  ASSERT_FALSE(checkpoint.getState());
+  const std::string data = checkpoint.serialize();
+  auto reloaded = SparrowCheckpoint::deserialize(data.data(), data.size());
+  auto reloadedState = reloaded.getState("reference");
+  ASSERT_FALSE(reloadedState->hasSnapshot());
+  const auto& density = reloadedState->getDensityMatrix();
+  ASSERT_TRUE(density.restrictedMatrix().isApprox(state->getDensityMatrix().restrictedMatrix()));
+  ASSERT_THAT(density.numberElectrons(), Eq(state->getDensityMatrix().numberElectrons()));
+}
+
+TEST_F(ASparrowCheckpoint, IsWrittenAndRestoredThroughTheSettings) {
+  calculator->settings().modifyBool("state_snapshots", false);
+  calculator->settings().modifyString("checkpoint_file", filename);
+  calculator->setStructure(ethanol);
+  const double energy = calculator->calculate("").get<Utils::Property::Energy>();
+  ASSERT_TRUE(SparrowCheckpoint::read(filename).getState()->hasSnapshot());
+
+  // A new calculator with the same checkpoint file resumes without SCF
+  bool restored = false;
+  auto restarted = calculateFrom(nullptr, restored);
+  ASSERT_TRUE(restored);
+  ASSERT_THAT(restarted.second, Eq(0));
+  ASSERT_THAT(restarted.first, DoubleNear(energy, 1e-12));
+}
+
+TEST_F(ASparrowCheckpoint, StoresExcitedStatesGuess) {
+  SparrowCheckpoint checkpoint;
+  ASSERT_FALSE(checkpoint.getExcitedStatesGuess());
+  LinearResponseCalculator::GuessSpecifier guess;
+  guess.singlet = Eigen::MatrixXd::Random(30, 4);
+  guess.triplet = Eigen::MatrixXd::Random(30, 2);
+  checkpoint.setExcitedStatesGuess(guess);
+  checkpoint.write(filename);
+
+  auto read = SparrowCheckpoint::read(filename).getExcitedStatesGuess();
+  ASSERT_TRUE(read);
+  ASSERT_TRUE(read->singlet.isApprox(guess.singlet));
+  ASSERT_TRUE(read->triplet.isApprox(guess.triplet));
+  ASSERT_THAT(read->unrestricted.size(), Eq(0));
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/BatchedGTODipoleMatrixBlock.h>
+#include <Sparrow/Implementations/Nddo/Utils/DipoleUtils/GTODipoleMatrixBlock.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/BatchedGTOOverlapMatrixBlock.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/GTOOverlapMatrixBlock.h>
+#include <Utils/DataStructures/GtoExpansion.h>
+#include <Utils/DataStructures/SlaterToGaussian.h>
+#include <Utils/Math/AutomaticDifferentiation/AutomaticDifferentiationHelpers.h>
+#include <gmock/gmock.h>
+#include <Eigen/Core>
+#include <random>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+using namespace nddo;
+using namespace Utils::AutomaticDifferentiation;
+
+namespace {
+std::vector<double> components(double v) {
+  return {v};
+}
+std::vector<double> components(const First3D& v) {
+  return {v.value(), v.dx(), v.dy(), v.dz()};
+}
+std::vector<double> components(const Second3D& v) {
+  return {v.value(), v.dx(), v.dy(), v.dz(), v.XX(), v.YY(), v.ZZ(), v.XY(), v.XZ(), v.YZ()};
+}
+} // namespace
+
+class ABatchedIntegralBlock : public Test {
+ public:
+  std::vector<Utils::GtoExpansion> shells;
+  std::vector<Eigen::Vector3d> randomDistances;
+  std::vector<Eigen::RowVector3d> randomPositionsA, randomPositionsB;
+  std::mt19937 generator{42};
+
+  void SetUp() override {
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 1, 0));
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 4, 0, 1.42));
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 2, 1, 2.2));
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 3, 1));
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 5, 2, 0.92));
+    shells.push_back(Utils::SlaterToGaussian::getGTOExpansion(6, 4, 2));
+
+    std::uniform_real_distribution<double> distribution(-3.0, 3.0);
+    for (int i = 0; i < 7; ++i) {
+      randomDistances.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+      randomPositionsA.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+      randomPositionsB.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+    }
+  }
+
+  template<Utils::DerivativeOrder O>
+  void expectSameOverlapBlocks() {
+    BatchedGTOOverlapMatrixBlock<O> batchedBlock;
+    for (const auto& gA : shells) {
+      for (const auto& gB : shells) {
+        auto batchedResult = batchedBlock.getMatrixBlocks(gA, gB, randomDistances);
+        ASSERT_THAT(batchedResult.size(), Eq(randomDistances.size()));
+        for (unsigned pair = 0; pair < randomDistances.size(); ++pair) {
+          GTOOverlapMatrixBlock<O> referenceBlock;
+          auto reference = referenceBlock.getMatrixBlock(gA, gB, randomDistances[pair]);
+          ASSERT_THAT(batchedResult[pair].rows(), Eq(reference.rows()));
+          ASSERT_THAT(batchedResult[pair].cols(), Eq(reference.cols()));
+          for (int i = 0; i < reference.rows(); ++i) {
+            for (int j = 0; j < reference.cols(); ++j) {
+              auto expected = components(reference(i, j));
+              auto actual = components(batchedResult[pair](i, j));
+              for (unsigned c = 0; c < expected.size(); ++c) {
+                EXPECT_THAT(actual[c], DoubleNear(expected[c], 1e-12));
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+TEST_F(ABatchedIntegralBlock, GivesSameOverlapAsScalarImplementationWithoutDerivatives) {
+  expectSameOverlapBlocks<Utils::DerivativeOrder::Zero>();
+}
+
+TEST_F(ABatchedIntegralBlock, GivesSameOverlapAsScalarImplementationWithFirstDerivatives) {
+  expectSameOverlapBlocks<Utils::DerivativeOrder::One>();
+}
+
+TEST_F(ABatchedIntegralBlock, GivesSameOverlapAsScalarImplementationWithSecondDerivatives) {
+  expectSameOverlapBlocks<Utils::DerivativeOrder::Two>();
+}
+
+TEST_F(ABatchedIntegralBlock, GivesSameDipoleAsScalarImplementation) {
+  Eigen::RowVector3d evaluationCoordinate(0.3, -0.2, 0.1);
+  BatchedGTODipoleMatrixBlock batchedBlock;
+  for (const auto& gA : shells) {
+    for (const auto& gB : shells) {
+      auto batchedResult = batchedBlock.createSTOBlocks(gA, gB, randomPositionsA, randomPositionsB, evaluationCoordinate);
+      ASSERT_THAT(batchedResult.size(), Eq(randomPositionsA.size()));
+      for (unsigned pair = 0; pair < randomPositionsA.size(); ++pair) {
+        GTODipoleMatrixBlock referenceBlock;
+        Eigen::Vector3d Rab = (randomPositionsB[pair] - randomPositionsA[pair]).transpose();
+        auto reference = referenceBlock.createSTOBlock(gA, gB, randomPositionsA[pair], randomPositionsB[pair], Rab,
+                                                       evaluationCoordinate.transpose());
+        for (int dimension = 0; dimension < 3; ++dimension) {
+          ASSERT_TRUE(batchedResult[pair][dimension].isApprox(reference[dimension], 1e-10) ||
+                      (batchedResult[pair][dimension] - reference[dimension]).isZero(1e-12));
+        }
+      }
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,159 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Nddo/Am1/AM1PairwiseRepulsion.h>
+#include <Sparrow/Implementations/Nddo/Mndo/MNDOPairwiseRepulsion.h>
+#include <Sparrow/Implementations/Nddo/Pm6/PM6PairwiseRepulsion.h>
+#include <Sparrow/Implementations/Nddo/Utils/CoreRepulsionEngine.h>
+#include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
+#include <Utils/Math/AutomaticDifferentiation/MethodsHelpers.h>
+#include <Utils/Typenames.h>
+#include <gmock/gmock.h>
+#include <random>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+using namespace nddo;
+using namespace Utils::AutomaticDifferentiation;
+
+class ACoreRepulsionEngine : public Test {
+ public:
+  Utils::ElementTypeCollection elements;
+  Utils::PositionCollection positions;
+  std::mt19937 generator{42};
+
+  void SetUp() override {
+    const std::vector<Utils::ElementType> types = {Utils::ElementType::H, Utils::ElementType::C, Utils::ElementType::N,
+                                                   Utils::ElementType::O, Utils::ElementType::Si};
+    std::uniform_real_distribution<double> distribution(-6.0, 6.0);
+    const int nAtoms = 20;
+    positions.resize(nAtoms, 3);
+    for (int i = 0; i < nAtoms; ++i) {
+      elements.push_back(types[i % types.size()]);
+      // Avoid unphysically close atoms
+      bool tooClose = true;
+      while (tooClose) {
+        positions.row(i) = Eigen::RowVector3d(distribution(generator), distribution(generator), distribution(generator));
+        tooClose = false;
+        for (int j = 0; j < i; ++j) {
+          tooClose = tooClose || (positions.row(i) - positions.row(j)).norm() < 1.5;
+        }
+      }
+    }
+  }
+
+  // Places the second half of the atoms far away, such that their short-range repulsion with the first half vanishes.
+  void separateFragments() {
+    for (int i = positions.rows() / 2; i < positions.rows(); ++i) {
+      positions(i, 0) += 60.0;
+    }
+  }
+
+  template<class PairwiseRepulsion, class... PairParameters>
+  void expectSameAsPairwiseRepulsion(CoreRepulsionEngine& engine, const ElementParameters& elementParameters,
+                                     const PairParameters*... pairParameters) {
+    const int nAtoms = elements.size();
+    double referenceEnergy = 0;
+    Utils::GradientCollection referenceGradients = Utils::GradientCollection::Zero(nAtoms, 3);
+    for (int i = 0; i < nAtoms; ++i) {
+      for (int j = i + 1; j < nAtoms; ++j) {
+        PairwiseRepulsion repulsion(elementParameters.get(elements[i]), elementParameters.get(elements[j]),
+                                    pairParameters->get(elements[i], elements[j])...);
+        Eigen::Vector3d Rab = positions.row(j) - positions.row(i);
+        repulsion.calculate(Rab, Utils::DerivativeOrder::One);
+        referenceEnergy += repulsion.getRepulsionEnergy();
+        addDerivativeToContainer<Utils::Derivative::First>(referenceGradients, i, j,
+                                                           repulsion.template getDerivative<Utils::Derivative::First>());
+      }
+    }
+
+    engine.initialize();
+    engine.calculate(Utils::DerivativeOrder::One);
+    Utils::GradientCollection gradients = Utils::GradientCollection::Zero(nAtoms, 3);
+    engine.addDerivatives(gradients);
+
+    ASSERT_THAT(engine.getNumberOfPairs(), Eq(nAtoms * (nAtoms - 1) / 2));
+    EXPECT_THAT(engine.getRepulsionEnergy(), DoubleNear(referenceEnergy, 1e-10));
+    for (int i = 0; i < nAtoms; ++i) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        EXPECT_THAT(gradients(i, dimension), DoubleNear(referenceGradients(i, dimension), 1e-10));
+      }
+    }
+  }
+};
+
+TEST_F(ACoreRepulsionEngine, GivesSameRepulsionAsPM6PairwiseRepulsion) {
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  CoreRepulsionEngine engine(CoreRepulsionEngine::Model::PM6, elements, positions, initializer.getElementParameters(),
+                             &initializer.getElementPairParameters());
+  expectSameAsPairwiseRepulsion<PM6PairwiseRepulsion>(engine, initializer.getElementParameters(),
+                                                      &initializer.getElementPairParameters());
+}
+
+TEST_F(ACoreRepulsionEngine, GivesSameRepulsionAsAM1PairwiseRepulsion) {
+  NDDOInitializer initializer(BasisFunctions::sp, false);
+  initializer.getRawParameters() = am1();
+  initializer.initialize(elements);
+  CoreRepulsionEngine engine(CoreRepulsionEngine::Model::AM1, elements, positions, initializer.getElementParameters());
+  expectSameAsPairwiseRepulsion<AM1PairwiseRepulsion>(engine, initializer.getElementParameters());
+}
+
+TEST_F(ACoreRepulsionEngine, GivesSameRepulsionAsMNDOPairwiseRepulsion) {
+  NDDOInitializer initializer(BasisFunctions::sp, false);
+  initializer.getRawParameters() = mndo();
+  initializer.initialize(elements);
+  CoreRepulsionEngine engine(CoreRepulsionEngine::Model::MNDO, elements, positions, initializer.getElementParameters());
+  expectSameAsPairwiseRepulsion<MNDOPairwiseRepulsion>(engine, initializer.getElementParameters());
+}
+
+TEST_F(ACoreRepulsionEngine, SkipsShortRangeTermsOfDistantPairs) {
+  separateFragments();
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  CoreRepulsionEngine engine(CoreRepulsionEngine::Model::PM6, elements, positions, initializer.getElementParameters(),
+                             &initializer.getElementPairParameters());
+  expectSameAsPairwiseRepulsion<PM6PairwiseRepulsion>(engine, initializer.getElementParameters(),
+                                                      &initializer.getElementPairParameters());
+
+  const int nAtoms = elements.size();
+  const int nIntraFragmentPairs = 2 * (nAtoms / 2) * (nAtoms / 2 - 1) / 2;
+  EXPECT_THAT(engine.getNumberOfShortRangePairs(), Le(nIntraFragmentPairs));
+  EXPECT_THAT(engine.getNumberOfShortRangePairs(), Gt(0));
+}
+
+TEST_F(ACoreRepulsionEngine, DerivativesAreConsistentWithEnergy) {
+  NDDOInitializer initializer(BasisFunctions::sp, false);
+  initializer.getRawParameters() = am1();
+  initializer.initialize(elements);
+  CoreRepulsionEngine engine(CoreRepulsionEngine::Model::AM1, elements, positions, initializer.getElementParameters());
+  engine.initialize();
+  engine.calculate(Utils::DerivativeOrder::One);
+  Utils::GradientCollection gradients = Utils::GradientCollection::Zero(elements.size(), 3);
+  engine.addDerivatives(gradients);
+
+  const double step = 1e-5;
+  for (int i = 0; i < 3; ++i) {
+    for (int dimension = 0; dimension < 3; ++dimension) {
+      positions(i, dimension) += step;
+      engine.calculate(Utils::DerivativeOrder::Zero);
+      double plus = engine.getRepulsionEnergy();
+      positions(i, dimension) -= 2 * step;
+      engine.calculate(Utils::DerivativeOrder::Zero);
+      double minus = engine.getRepulsionEnergy();
+      positions(i, dimension) += step;
+      EXPECT_THAT(gradients(i, dimension), DoubleNear((plus - minus) / (2 * step), 1e-6));
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
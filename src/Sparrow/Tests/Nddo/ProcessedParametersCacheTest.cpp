@@ -0,0 +1,153 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/multipoleTypes.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h>
+#include <Sparrow/Implementations/Nddo/Utils/NDDOInitializer.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/AtomicParameters.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/PM6DiatomicParameters.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/ProcessedParametersCache.h>
+#include <Sparrow/Implementations/Nddo/Utils/ParameterUtils/RawParameterProcessor.h>
+#include <gmock/gmock.h>
+#include <boost/filesystem.hpp>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+using namespace nddo;
+
+class AProcessedParametersCache : public Test {
+ public:
+  Utils::ElementTypeCollection elements{Utils::ElementType::H, Utils::ElementType::C, Utils::ElementType::O,
+                                        Utils::ElementType::Cl, Utils::ElementType::S};
+
+  void SetUp() override {
+    ProcessedParametersCache::instance().clear();
+  }
+  void TearDown() override {
+    ProcessedParametersCache::instance().clear();
+    ProcessedParametersCache::instance().setMaximumParameterSets(8);
+  }
+
+  // Reference processed directly from the raw parameters, without cache
+  void expectSameAsDirectProcessing(NDDOInitializer& initializer) {
+    RawParameterProcessor processor(initializer.getRawParameters());
+    for (auto e : elements) {
+      auto reference = processor.processAtomicParameters(e);
+      const auto& cached = initializer.getElementParameters().get(e);
+      EXPECT_THAT(cached.nAOs(), Eq(reference.first->nAOs()));
+      EXPECT_THAT(cached.betaS(), DoubleEq(reference.first->betaS()));
+      EXPECT_THAT(cached.betaD(), DoubleEq(reference.first->betaD()));
+      EXPECT_THAT(cached.Upp(), DoubleEq(reference.first->Upp()));
+      EXPECT_THAT(cached.alpha(), DoubleEq(reference.first->alpha()));
+      EXPECT_THAT(cached.pCore(), DoubleEq(reference.first->pCore()));
+      EXPECT_THAT(cached.pCoreSpecified(), Eq(reference.first->pCoreSpecified()));
+      EXPECT_THAT(cached.getGaussianRepulsionParameters().size(),
+                  Eq(reference.first->getGaussianRepulsionParameters().size()));
+      EXPECT_THAT(cached.GTOs().s.value().gtfs[0].exponent, DoubleEq(reference.first->GTOs().s.value().gtfs[0].exponent));
+      for (unsigned i = 0; i < 8; ++i) {
+        auto type = static_cast<multipole::MultipolePair>(i);
+        EXPECT_THAT(cached.klopmanParameters().get(type), DoubleEq(reference.first->klopmanParameters().get(type)));
+      }
+      for (unsigned i = 0; i < 5; ++i) {
+        auto type = static_cast<multipole::MultipolePair>(i);
+        EXPECT_THAT(cached.chargeSeparations().get(type), DoubleEq(reference.first->chargeSeparations().get(type)));
+      }
+      const auto& integrals = initializer.getOneCenterIntegrals().get(e);
+      ASSERT_THAT(integrals.getNumberIntegrals(), Eq(reference.second->getNumberIntegrals()));
+      for (int i = 0; i < integrals.getNumberIntegrals(); ++i) {
+        EXPECT_THAT(integrals.get(i), DoubleEq(reference.second->get(i)));
+      }
+    }
+    for (auto e1 : elements) {
+      for (auto e2 : elements) {
+        auto reference = processor.runtimeDiatomicParameters(e1, e2);
+        EXPECT_THAT(initializer.getElementPairParameters().get(e1, e2).alpha(), DoubleEq(reference->alpha()));
+        EXPECT_THAT(initializer.getElementPairParameters().get(e1, e2).x(), DoubleEq(reference->x()));
+      }
+    }
+  }
+};
+
+TEST_F(AProcessedParametersCache, ProcessesEachElementOnlyOnce) {
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfAtomicEntries(), Eq(5));
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfDiatomicEntries(), Eq(15));
+
+  NDDOInitializer secondInitializer;
+  secondInitializer.getRawParameters() = pm6();
+  secondInitializer.initialize(elements);
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfAtomicEntries(), Eq(5));
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfDiatomicEntries(), Eq(15));
+  expectSameAsDirectProcessing(secondInitializer);
+}
+
+TEST_F(AProcessedParametersCache, DoesNotMixDifferentRawParameters) {
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  const double originalBetaS = initializer.getElementParameters().get(Utils::ElementType::C).betaS();
+
+  initializer.getRawParameters().atomic.at(6).pack.beta.s *= 2;
+  initializer.applyRawParameters(elements);
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfAtomicEntries(), Eq(6));
+  ASSERT_THAT(initializer.getElementParameters().get(Utils::ElementType::C).betaS(), DoubleEq(2 * originalBetaS));
+  expectSameAsDirectProcessing(initializer);
+}
+
+TEST_F(AProcessedParametersCache, KeepsBoundedNumberOfParameterSetsPerElement) {
+  auto& cache = ProcessedParametersCache::instance();
+  ASSERT_THAT(cache.getMaximumParameterSets(), Eq(8));
+  cache.setMaximumParameterSets(2);
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  for (int i = 0; i < 4; ++i) {
+    initializer.getRawParameters().atomic.at(6).pack.beta.s *= 1.1;
+    initializer.getRawParameters().diatomic.at(Parameters::key(Utils::ElementType::C, Utils::ElementType::H)).factor *=
+        1.1;
+    initializer.applyRawParameters(elements);
+    expectSameAsDirectProcessing(initializer);
+  }
+  ASSERT_THAT(cache.numberOfAtomicEntries(), Eq(4 + 2));
+  ASSERT_THAT(cache.numberOfDiatomicEntries(), Eq(14 + 2));
+
+  cache.setMaximumParameterSets(1);
+  ASSERT_THAT(cache.numberOfAtomicEntries(), Eq(5));
+  ASSERT_THAT(cache.numberOfDiatomicEntries(), Eq(15));
+  // The newest parameter sets are kept
+  initializer.applyRawParameters(elements);
+  ASSERT_THAT(cache.numberOfAtomicEntries(), Eq(5));
+  expectSameAsDirectProcessing(initializer);
+  EXPECT_THROW(cache.setMaximumParameterSets(0), std::runtime_error);
+}
+
+TEST_F(AProcessedParametersCache, CanBeWrittenAndReadFromFile) {
+  const std::string fileName = "processed_pm6_parameters.json";
+  NDDOInitializer initializer;
+  initializer.getRawParameters() = pm6();
+  initializer.initialize(elements);
+  NDDOInitializer::saveProcessedParameters(fileName);
+
+  ProcessedParametersCache::instance().clear();
+  NDDOInitializer::readProcessedParameters(fileName);
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfAtomicEntries(), Eq(5));
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfDiatomicEntries(), Eq(15));
+
+  NDDOInitializer coldInitializer;
+  coldInitializer.getRawParameters() = pm6();
+  coldInitializer.initialize(elements);
+  ASSERT_THAT(ProcessedParametersCache::instance().numberOfAtomicEntries(), Eq(5));
+  expectSameAsDirectProcessing(coldInitializer);
+  boost::filesystem::remove(fileName);
+}
+
+} // namespace Sparrow
+} // namespace Scine
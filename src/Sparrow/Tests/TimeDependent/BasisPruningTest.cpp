@@ -476,5 +476,72 @@ TEST_F(ABasisPruningTest, BinaryTestPrunedUHF) {
                 std::sqrt((eigenvalues2 - eigenvalues1).array().square().sum() / eigenvalues2.size());
   ASSERT_LE(rmsd, 0.05);
 }
+
+TEST_F(ABasisPruningTest, IncrementalPruningOfSameFrameReproducesSelection) {
+  auto dftbMethod = std::dynamic_pointer_cast<DFTBMethodWrapper>(calculator);
+  dftbMethod->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixMO);
+  dftbMethod->calculate("TDDFTB reference calculation.");
+
+  auto tddftbData = dftbMethod->getTDDFTBData();
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::VectorXd> energyDifferenceVector;
+  TimeDependentUtils::generateEnergyDifferenceVector(tddftbData.MOEnergies, tddftbData.occupation, energyDifferenceVector);
+  TransitionChargesCalculator tcCalculator(tddftbData.molecularOrbitals, tddftbData.overlapMatrix, tddftbData.AOInfo);
+  auto excitations = TimeDependentUtils::generateExcitations<Utils::Reference::Restricted>(tddftbData.molecularOrbitals,
+                                                                                           tddftbData.occupation);
+  Eigen::MatrixXd transitionCharges =
+      tcCalculator.calculateAtomicTransitionChargeMatrices<Utils::Reference::Restricted>(tddftbData.occupation);
+  auto orderMap = TimeDependentUtils::generateEnergyOrderMap(energyDifferenceVector);
+  OrderedInput<Utils::Reference::Restricted> input{energyDifferenceVector, excitations, transitionCharges, orderMap};
+
+  BasisPruner<Utils::Reference::Restricted> basisPruner(input, tddftbData.gammaMatrix, tddftbData.spinConstants);
+  auto prunedData =
+      basisPruner.prune(EnergyThreshold{0.5}, PerturbativeThreshold{1e-4}, Utils::SpinTransition::Singlet);
+  const int nSecondary = input.energyDifferences().size() - basisPruner.getNumberOfRootsUnderThreshold();
+  ASSERT_THAT(basisPruner.getNumberOfTestedConfigurations(), Eq(nSecondary));
+
+  BasisPruner<Utils::Reference::Restricted> incrementalPruner(input, tddftbData.gammaMatrix, tddftbData.spinConstants);
+  incrementalPruner.setPreviousSelection(basisPruner.getSelection());
+  auto incrementalData =
+      incrementalPruner.prune(EnergyThreshold{0.5}, PerturbativeThreshold{1e-4}, Utils::SpinTransition::Singlet);
+  EXPECT_THAT(incrementalPruner.getNumberOfTestedConfigurations(), Lt(nSecondary));
+  ASSERT_THAT(incrementalPruner.getNumberOfConfigurationsAfterPruning(),
+              Eq(basisPruner.getNumberOfConfigurationsAfterPruning()));
+  for (int i = 0; i < static_cast<int>(prunedData.excitations().size()); ++i) {
+    EXPECT_EQ(incrementalData.excitations()[i].occ, prunedData.excitations()[i].occ);
+    EXPECT_EQ(incrementalData.excitations()[i].vir, prunedData.excitations()[i].vir);
+  }
+
+  // A different perturbative threshold invalidates the previous selection.
+  BasisPruner<Utils::Reference::Restricted> otherPruner(input, tddftbData.gammaMatrix, tddftbData.spinConstants);
+  otherPruner.setPreviousSelection(basisPruner.getSelection());
+  otherPruner.prune(EnergyThreshold{0.5}, PerturbativeThreshold{1e-3}, Utils::SpinTransition::Singlet);
+  EXPECT_THAT(otherPruner.getNumberOfTestedConfigurations(), Eq(nSecondary));
+}
+
+TEST_F(ABasisPruningTest, CalculatorReportsPrunedSpaceAndReusesSelection) {
+  calculatorOxa->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixMO);
+  tddftbCalculator.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 3);
+  tddftbCalculator.settings().modifyString(Utils::SettingsNames::pruneBasis, "energy");
+  tddftbCalculator.settings().modifyDouble(Utils::SettingsNames::perturbativeThreshold, 1e-4);
+  tddftbCalculator.settings().modifyBool("incremental_pruning", true);
+  tddftbCalculator.applySettings();
+  calculatorOxa->calculate("");
+  tddftbCalculator.setReferenceCalculator(calculatorOxa);
+
+  auto results = tddftbCalculator.calculate();
+  Eigen::VectorXd eigenvalues1 = results.get<Utils::Property::ExcitedStates>().singlet->eigenStates.eigenValues;
+  const auto statistics = tddftbCalculator.getPruningStatistics();
+  EXPECT_THAT(statistics.nPrunedConfigurations, Gt(3));
+  EXPECT_THAT(statistics.nPrunedConfigurations, Lt(statistics.nConfigurations));
+  EXPECT_THAT(statistics.nTestedConfigurations, Eq(statistics.nConfigurations - 3));
+  EXPECT_THAT(statistics.pruningTime, Ge(0.0));
+
+  // Same frame again: only the configurations close to the perturbative threshold are tested.
+  results = tddftbCalculator.calculate();
+  Eigen::VectorXd eigenvalues2 = results.get<Utils::Property::ExcitedStates>().singlet->eigenStates.eigenValues;
+  EXPECT_THAT(tddftbCalculator.getPruningStatistics().nPrunedConfigurations, Eq(statistics.nPrunedConfigurations));
+  EXPECT_THAT(tddftbCalculator.getPruningStatistics().nTestedConfigurations, Lt(statistics.nTestedConfigurations));
+  EXPECT_TRUE(eigenvalues2.isApprox(eigenvalues1, 1e-8));
+}
 } // namespace Sparrow
 } // namespace Scine
@@ -0,0 +1,372 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Log.h>
+#include <Sparrow/Implementations/Nddo/Pm6/Wrapper/PM6MethodWrapper.h>
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISData.h>
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISIntegralArena.h>
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISMatrixAOFockBuilder.h>
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISPseudoDensityBuilder.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/Global2c2eMatrix.h>
+#include <Sparrow/Implementations/Nddo/Utils/IntegralsEvaluationUtils/oneCenterTwoElectronIntegrals.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+TEST(ACISIntegralArena, StoresDisjointBlocksOfAllAtomPairs) {
+  const int nAtoms = 5;
+  EXPECT_THAT(CISIntegralArena::numberOfPairs(nAtoms), Eq(10));
+  std::vector<int> rows, cols;
+  int expectedIndex = 0;
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    for (int atomJ = atomI + 1; atomJ < nAtoms; ++atomJ) {
+      ASSERT_THAT(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms), Eq(expectedIndex++));
+      rows.push_back(atomI + 1);
+      cols.push_back(atomJ + 2);
+    }
+  }
+  CISIntegralArena arena;
+  arena.allocate(rows, cols);
+  ASSERT_THAT(arena.getNumberOfBlocks(), Eq(10));
+  EXPECT_THAT(CISIntegralArena::numberOfElements(rows, cols), Eq(std::size_t{105}));
+  EXPECT_THAT(arena.getMemory(), Ge(105 * sizeof(double)));
+  for (int b = 0; b < arena.getNumberOfBlocks(); ++b) {
+    ASSERT_THAT(arena.block(b).rows(), Eq(rows[b]));
+    ASSERT_THAT(arena.block(b).cols(), Eq(cols[b]));
+    EXPECT_TRUE(arena.block(b).isZero());
+    arena.block(b).setConstant(b);
+  }
+  for (int b = 0; b < arena.getNumberOfBlocks(); ++b) {
+    EXPECT_TRUE(arena.block(b).isConstant(b));
+  }
+}
+
+TEST(ACISIntegralArena, KeepsBlocksOutOfCoreAfterRelease) {
+  const int nAtoms = 40;
+  std::vector<int> rows, cols;
+  for (int pair = 0; pair < CISIntegralArena::numberOfPairs(nAtoms); ++pair) {
+    rows.push_back(10);
+    cols.push_back(9);
+  }
+  CISIntegralArena arena;
+  arena.allocateOutOfCore(rows, cols, "");
+  ASSERT_TRUE(arena.isOutOfCore());
+  EXPECT_THAT(arena.getScratchSize(), Eq(CISIntegralArena::numberOfElements(rows, cols) * sizeof(double)));
+  EXPECT_THAT(arena.getMemory(), Lt(arena.getScratchSize()));
+  for (int atomI = 0; atomI < nAtoms; ++atomI) {
+    const int firstPair = CISIntegralArena::firstPairIndex(atomI, nAtoms);
+    for (int atomJ = atomI + 1; atomJ < nAtoms; ++atomJ) {
+      ASSERT_THAT(CISIntegralArena::pairIndex(atomI, atomJ, nAtoms), Eq(firstPair + atomJ - atomI - 1));
+      const int pair = CISIntegralArena::pairIndex(atomI, atomJ, nAtoms);
+      EXPECT_TRUE(arena.block(pair).isZero());
+      arena.block(pair).setConstant(pair);
+    }
+    arena.release(firstPair, firstPair + nAtoms - atomI - 1);
+  }
+  arena.prefetch(0, arena.getNumberOfBlocks());
+  for (int b = 0; b < arena.getNumberOfBlocks(); ++b) {
+    EXPECT_TRUE(arena.block(b).isConstant(b));
+  }
+  arena.clear();
+  EXPECT_FALSE(arena.isOutOfCore());
+  EXPECT_THAT(arena.getScratchSize(), Eq(std::size_t{0}));
+}
+
+/**
+ * Compares the pseudo-Fock matrices of the builder with the explicit contraction of the NDDO two-electron integrals
+ * with a random, non-symmetric pseudo-density, for a molecule with d orbitals.
+ */
+class ACISMatrixAOFockBuilder : public Test {
+ public:
+  PM6MethodWrapper method;
+  std::unique_ptr<CISData> cisData;
+  ExcitedStatesParam param{0.9, 1.1, 1.0};
+  std::vector<int> atomOfOrbital, localIndex;
+  std::map<int, std::vector<int>> allPairs;
+  Eigen::MatrixXd densityA, densityB;
+
+  void SetUp() override {
+    std::stringstream ss("4\n\n"
+                         "C      0.0000000000    0.0000000000    0.0000000000\n"
+                         "S      0.0000000000    0.0000000000    1.6110000000\n"
+                         "H      0.9300000000    0.0000000000   -0.5600000000\n"
+                         "H     -0.9300000000    0.0000000000   -0.5600000000\n");
+    method.setLog(Core::Log::silent());
+    method.setStructure(Utils::XyzStreamHandler::read(ss));
+    method.calculate("");
+    cisData = std::make_unique<CISData>(method.getCISData());
+    const auto& aoInfo = cisData->AOInfo;
+    for (int atom = 0; atom < aoInfo.getNAtoms(); ++atom) {
+      for (int orbital = 0; orbital < aoInfo.getNOrbitals(atom); ++orbital) {
+        atomOfOrbital.push_back(atom);
+        localIndex.push_back(orbital);
+      }
+      for (int other = atom + 1; other < aoInfo.getNAtoms(); ++other) {
+        allPairs[atom].push_back(other);
+      }
+      allPairs[atom];
+    }
+    srand(42);
+    densityA = Eigen::MatrixXd::Random(aoInfo.getNAtomicOrbitals(), aoInfo.getNAtomicOrbitals());
+    densityB = Eigen::MatrixXd::Random(aoInfo.getNAtomicOrbitals(), aoInfo.getNAtomicOrbitals());
+  }
+
+  // (a b|c d) of the NDDO approximation: zero unless a, b and c, d are on the same atom.
+  double integral(int a, int b, int c, int d) const {
+    const int atomA = atomOfOrbital[a];
+    const int atomC = atomOfOrbital[c];
+    if (atomOfOrbital[b] != atomA || atomOfOrbital[d] != atomC) {
+      return 0.0;
+    }
+    const int mu = localIndex[a], nu = localIndex[b], lambda = localIndex[c], sigma = localIndex[d];
+    if (atomA == atomC) {
+      return cisData->oneCenterIntegrals.get(cisData->elements[atomA]).get(mu, nu, lambda, sigma);
+    }
+    if (atomA < atomC) {
+      return cisData->twoCenterIntegrals.get(atomA, atomC)->get(mu, nu, lambda, sigma);
+    }
+    return cisData->twoCenterIntegrals.get(atomC, atomA)->get(lambda, sigma, mu, nu);
+  }
+
+  // J_nu,mu = sum_lambda,sigma (mu nu|lambda sigma) P_sigma,lambda
+  Eigen::MatrixXd coulomb(const Eigen::MatrixXd& P) const {
+    const int n = P.rows();
+    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(n, n);
+    for (int mu = 0; mu < n; ++mu) {
+      for (int nu = 0; nu < n; ++nu) {
+        for (int lambda = 0; lambda < n; ++lambda) {
+          for (int sigma = 0; sigma < n; ++sigma) {
+            result(nu, mu) += integral(mu, nu, lambda, sigma) * P(sigma, lambda);
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+  // K_nu,mu = sum_lambda,sigma (mu sigma|lambda nu) P_sigma,lambda
+  Eigen::MatrixXd exchange(const Eigen::MatrixXd& P) const {
+    const int n = P.rows();
+    Eigen::MatrixXd result = Eigen::MatrixXd::Zero(n, n);
+    for (int mu = 0; mu < n; ++mu) {
+      for (int nu = 0; nu < n; ++nu) {
+        for (int lambda = 0; lambda < n; ++lambda) {
+          for (int sigma = 0; sigma < n; ++sigma) {
+            result(nu, mu) += integral(mu, sigma, lambda, nu) * P(sigma, lambda);
+          }
+        }
+      }
+    }
+    return result;
+  }
+};
+
+TEST_F(ACISMatrixAOFockBuilder, ReproducesExplicitContractionForRestrictedSinglets) {
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> builder(*cisData, param);
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> pseudoDensity;
+  pseudoDensity.restricted = densityA;
+  const Eigen::MatrixXd expected = 2 * param.c1 * coulomb(densityA) - param.c2 * exchange(densityA);
+  EXPECT_TRUE(builder.getAOFock(pseudoDensity, allPairs).restricted.isApprox(expected, 1e-10));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, ReproducesExplicitContractionForRestrictedTriplets) {
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet> builder(*cisData, param);
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> pseudoDensity;
+  pseudoDensity.restricted = densityA;
+  const Eigen::MatrixXd expected = -param.c2 * exchange(densityA);
+  EXPECT_TRUE(builder.getAOFock(pseudoDensity, allPairs).restricted.isApprox(expected, 1e-10));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, ReproducesExplicitContractionForUnrestrictedReference) {
+  CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> builder(*cisData, param);
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> pseudoDensity;
+  pseudoDensity.alpha = densityA;
+  pseudoDensity.beta = densityB;
+  const auto fock = builder.getAOFock(pseudoDensity, allPairs);
+  const Eigen::MatrixXd totalCoulomb = param.c1 * coulomb(densityA + densityB);
+  EXPECT_TRUE(fock.alpha.isApprox(totalCoulomb - param.c2 * exchange(densityA), 1e-10));
+  EXPECT_TRUE(fock.beta.isApprox(totalCoulomb - param.c2 * exchange(densityB), 1e-10));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, GivesSameFockMatricesOutOfCore) {
+  CISIntegralStorage outOfCore;
+  outOfCore.mode = CISIntegralStorage::Mode::OutOfCore;
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> restrictedDensity;
+  restrictedDensity.restricted = densityA;
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> unrestrictedDensity;
+  unrestrictedDensity.alpha = densityA;
+  unrestrictedDensity.beta = densityB;
+
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> singlet(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> singletOutOfCore(*cisData, param,
+                                                                                                        outOfCore);
+  EXPECT_THAT(singletOutOfCore.getScratchSize(), Gt(std::size_t{0}));
+  EXPECT_THAT(singletOutOfCore.getIntegralMemory(), Lt(singlet.getIntegralMemory()));
+  EXPECT_TRUE(singletOutOfCore.getAOFock(restrictedDensity, allPairs).restricted.isApprox(
+      singlet.getAOFock(restrictedDensity, allPairs).restricted, 1e-14));
+
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet> triplet(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet> tripletOutOfCore(*cisData, param,
+                                                                                                        outOfCore);
+  EXPECT_TRUE(tripletOutOfCore.getAOFock(restrictedDensity, allPairs).restricted.isApprox(
+      triplet.getAOFock(restrictedDensity, allPairs).restricted, 1e-14));
+
+  CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> unrestricted(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> unrestrictedOutOfCore(
+      *cisData, param, outOfCore);
+  const auto fock = unrestricted.getAOFock(unrestrictedDensity, allPairs);
+  const auto fockOutOfCore = unrestrictedOutOfCore.getAOFock(unrestrictedDensity, allPairs);
+  EXPECT_TRUE(fockOutOfCore.alpha.isApprox(fock.alpha, 1e-14));
+  EXPECT_TRUE(fockOutOfCore.beta.isApprox(fock.beta, 1e-14));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, GivesSameFockMatricesIntegralDirect) {
+  CISIntegralStorage direct;
+  direct.mode = CISIntegralStorage::Mode::Direct;
+  direct.screeningThreshold = 0.0;
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> restrictedDensity;
+  restrictedDensity.restricted = densityA;
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> unrestrictedDensity;
+  unrestrictedDensity.alpha = densityA;
+  unrestrictedDensity.beta = densityB;
+
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> singlet(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> singletDirect(*cisData, param,
+                                                                                                     direct);
+  EXPECT_THAT(singletDirect.getScratchSize(), Eq(std::size_t{0}));
+  EXPECT_THAT(singletDirect.getIntegralMemory(), Lt(singlet.getIntegralMemory()));
+  EXPECT_TRUE(singletDirect.getAOFock(restrictedDensity, allPairs).restricted.isApprox(
+      singlet.getAOFock(restrictedDensity, allPairs).restricted, 1e-12));
+
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet> triplet(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet> tripletDirect(*cisData, param,
+                                                                                                     direct);
+  EXPECT_TRUE(tripletDirect.getAOFock(restrictedDensity, allPairs).restricted.isApprox(
+      triplet.getAOFock(restrictedDensity, allPairs).restricted, 1e-12));
+
+  CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> unrestricted(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> unrestrictedDirect(
+      *cisData, param, direct);
+  const auto fock = unrestricted.getAOFock(unrestrictedDensity, allPairs);
+  const auto fockDirect = unrestrictedDirect.getAOFock(unrestrictedDensity, allPairs);
+  EXPECT_TRUE(fockDirect.alpha.isApprox(fock.alpha, 1e-12));
+  EXPECT_TRUE(fockDirect.beta.isApprox(fock.beta, 1e-12));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, ScreenedPairsDoNotChangeIntegralDirectFockMatrix) {
+  CISIntegralStorage direct;
+  direct.mode = CISIntegralStorage::Mode::Direct;
+  direct.screeningThreshold = 1e-10;
+  // Pseudo-density on the first atom only: all pairs without it are screened out.
+  const auto& aoInfo = cisData->AOInfo;
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> pseudoDensity;
+  pseudoDensity.restricted = Eigen::MatrixXd::Zero(aoInfo.getNAtomicOrbitals(), aoInfo.getNAtomicOrbitals());
+  pseudoDensity.restricted.topLeftCorner(aoInfo.getNOrbitals(0), aoInfo.getNOrbitals(0)) =
+      densityA.topLeftCorner(aoInfo.getNOrbitals(0), aoInfo.getNOrbitals(0));
+
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> builder(*cisData, param);
+  CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet> directBuilder(*cisData, param,
+                                                                                                     direct);
+  const Eigen::MatrixXd expected =
+      2 * param.c1 * coulomb(pseudoDensity.restricted) - param.c2 * exchange(pseudoDensity.restricted);
+  const Eigen::MatrixXd fock = directBuilder.getAOFock(pseudoDensity, allPairs).restricted;
+  EXPECT_TRUE(fock.isApprox(expected, 1e-10));
+  EXPECT_TRUE(fock.isApprox(builder.getAOFock(pseudoDensity, allPairs).restricted, 1e-12));
+}
+
+TEST_F(ACISMatrixAOFockBuilder, BuildsStackedFockMatricesOfSeveralPseudoDensities) {
+  const int nAOs = cisData->AOInfo.getNAtomicOrbitals();
+  const std::vector<Eigen::MatrixXd> densities = {densityA, densityB, densityA - 0.5 * densityB};
+  const int nVectors = static_cast<int>(densities.size());
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> restrictedDensities, restrictedFocks;
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> unrestrictedDensities, unrestrictedFocks;
+  restrictedDensities.restricted.resize(nVectors * nAOs, nAOs);
+  unrestrictedDensities.alpha.resize(nVectors * nAOs, nAOs);
+  unrestrictedDensities.beta.resize(nVectors * nAOs, nAOs);
+  for (int k = 0; k < nVectors; ++k) {
+    restrictedDensities.restricted.middleRows(k * nAOs, nAOs) = densities[k];
+    unrestrictedDensities.alpha.middleRows(k * nAOs, nAOs) = densities[k];
+    unrestrictedDensities.beta.middleRows(k * nAOs, nAOs) = densities[(k + 1) % nVectors];
+  }
+  CISIntegralStorage direct;
+  direct.mode = CISIntegralStorage::Mode::Direct;
+  direct.screeningThreshold = 0.0;
+
+  auto expectSameRestrictedFocks = [&](const CISMatrixAOFockBuilderBase<Utils::Reference::Restricted>& builder) {
+    builder.getAOFocks(restrictedDensities, allPairs, restrictedFocks);
+    ASSERT_THAT(restrictedFocks.restricted.rows(), Eq(nVectors * nAOs));
+    for (int k = 0; k < nVectors; ++k) {
+      Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> density;
+      density.restricted = densities[k];
+      EXPECT_TRUE(restrictedFocks.restricted.middleRows(k * nAOs, nAOs)
+                      .isApprox(builder.getAOFock(density, allPairs).restricted, 1e-12));
+    }
+  };
+  for (const auto& storage : {CISIntegralStorage{}, direct}) {
+    using Singlet = CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>;
+    using Triplet = CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Triplet>;
+    expectSameRestrictedFocks(Singlet(*cisData, param, storage));
+    expectSameRestrictedFocks(Triplet(*cisData, param, storage));
+
+    CISMatrixAOFockBuilder<Utils::Reference::Unrestricted, Utils::SpinTransition::Singlet> unrestricted(*cisData, param,
+                                                                                                        storage);
+    unrestricted.getAOFocks(unrestrictedDensities, allPairs, unrestrictedFocks);
+    for (int k = 0; k < nVectors; ++k) {
+      Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, Eigen::MatrixXd> density;
+      density.alpha = densities[k];
+      density.beta = densities[(k + 1) % nVectors];
+      const auto fock = unrestricted.getAOFock(density, allPairs);
+      EXPECT_TRUE(unrestrictedFocks.alpha.middleRows(k * nAOs, nAOs).isApprox(fock.alpha, 1e-12));
+      EXPECT_TRUE(unrestrictedFocks.beta.middleRows(k * nAOs, nAOs).isApprox(fock.beta, 1e-12));
+    }
+  }
+}
+
+TEST_F(ACISMatrixAOFockBuilder, StacksPseudoDensitiesOfSeveralGuessVectors) {
+  CISPseudoDensityBuilder<Utils::Reference::Restricted> builder(cisData->molecularOrbitals, cisData->occupation);
+  const int nAOs = cisData->AOInfo.getNAtomicOrbitals();
+  const int nExcitations =
+      builder.getOccupiedOrbitals().restricted.cols() * builder.getVirtualOrbitals().restricted.cols();
+  Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::MatrixXd> guessVectors, pseudoDensities;
+  guessVectors.restricted = Eigen::MatrixXd::Random(nExcitations, 4);
+  builder.getPseudoDensityMatrices(guessVectors, pseudoDensities);
+  ASSERT_THAT(pseudoDensities.restricted.rows(), Eq(4 * nAOs));
+  for (int k = 0; k < 4; ++k) {
+    Utils::SpinAdaptedContainer<Utils::Reference::Restricted, Eigen::VectorXd> guessVector;
+    guessVector.restricted = guessVectors.restricted.col(k);
+    EXPECT_TRUE(pseudoDensities.restricted.middleRows(k * nAOs, nAOs)
+                    .isApprox(builder.getPseudoDensityMatrix(guessVector).restricted, 1e-12));
+  }
+}
+
+TEST_F(ACISMatrixAOFockBuilder, ReportsMemoryOfStoredIntegrals) {
+  using Builder = CISMatrixAOFockBuilder<Utils::Reference::Restricted, Utils::SpinTransition::Singlet>;
+  Builder builder(*cisData, param);
+  const std::size_t expected = Builder::getIntegralMemory(cisData->AOInfo);
+  EXPECT_THAT(builder.getIntegralMemory(), Ge(expected));
+  EXPECT_THAT(builder.getIntegralMemory(), Lt(expected + 4096));
+  // The Coulomb blocks of the pairs are stored by charge distribution, for mu <= nu and lambda <= sigma only
+  std::size_t fullStorage = 0;
+  const auto& aoInfo = cisData->AOInfo;
+  for (int atomI = 0; atomI < aoInfo.getNAtoms(); ++atomI) {
+    const std::size_t nI = aoInfo.getNOrbitals(atomI);
+    fullStorage += nI * nI * nI * nI;
+    for (int atomJ = atomI + 1; atomJ < aoInfo.getNAtoms(); ++atomJ) {
+      const std::size_t nJ = aoInfo.getNOrbitals(atomJ);
+      fullStorage += 2 * nI * nI * nJ * nJ;
+    }
+  }
+  EXPECT_THAT(expected, Lt(fullStorage * sizeof(double)));
+}
+
+} // namespace Sparrow
+} // namespace Scine
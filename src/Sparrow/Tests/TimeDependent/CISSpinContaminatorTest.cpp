@@ -0,0 +1,226 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Nddo/TimeDependent/LinearResponse/CISSpinContaminator.h>
+#include <Utils/DataStructures/MolecularOrbitals.h>
+#include <gmock/gmock.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <numeric>
+
+namespace Scine {
+namespace Sparrow {
+
+using namespace testing;
+
+namespace {
+// Element-wise evaluation of <S^2> with nested loops over the orbital index lists, as a reference.
+Eigen::VectorXd loopSpinContamination(const Eigen::MatrixXd& spatialOverlap, const Eigen::MatrixXd& alphaCoefficients,
+                                      const Eigen::MatrixXd& betaCoefficients, const std::vector<int>& occupiedAlpha,
+                                      const std::vector<int>& occupiedBeta) {
+  std::vector<int> virtualAlpha(spatialOverlap.rows() - occupiedAlpha.size());
+  std::vector<int> virtualBeta(spatialOverlap.cols() - occupiedBeta.size());
+  TimeDependentUtils::generateVirtualOrbitalIndices(occupiedAlpha, virtualAlpha);
+  TimeDependentUtils::generateVirtualOrbitalIndices(occupiedBeta, virtualBeta);
+  const int nOccA = occupiedAlpha.size();
+  const int nOccB = occupiedBeta.size();
+  const int nVirA = virtualAlpha.size();
+  const int nVirB = virtualBeta.size();
+
+  const double nDiff = (nOccA - nOccB) / 2.;
+  double sUHF = nDiff * (nDiff + 1.) + nOccB;
+  for (int i : occupiedAlpha) {
+    for (int j : occupiedBeta) {
+      sUHF -= spatialOverlap(i, j) * spatialOverlap(i, j);
+    }
+  }
+  Eigen::VectorXd result(alphaCoefficients.cols());
+  for (int root = 0; root < alphaCoefficients.cols(); ++root) {
+    auto x = [&](int i, int a) { return alphaCoefficients(i * nVirA + a, root); };
+    auto y = [&](int i, int a) { return betaCoefficients(i * nVirB + a, root); };
+    double s2 = sUHF;
+    for (int a = 0; a < nVirA; ++a) {
+      for (int b = 0; b < nVirA; ++b) {
+        for (int i = 0; i < nOccA; ++i) {
+          for (int j : occupiedBeta) {
+            s2 -= x(i, a) * x(i, b) * spatialOverlap(virtualAlpha[a], j) * spatialOverlap(virtualAlpha[b], j);
+          }
+        }
+      }
+    }
+    for (int a = 0; a < nVirB; ++a) {
+      for (int b = 0; b < nVirB; ++b) {
+        for (int i = 0; i < nOccB; ++i) {
+          for (int j : occupiedAlpha) {
+            s2 -= y(i, a) * y(i, b) * spatialOverlap(j, virtualBeta[a]) * spatialOverlap(j, virtualBeta[b]);
+          }
+        }
+      }
+    }
+    for (int i = 0; i < nOccA; ++i) {
+      for (int j = 0; j < nOccA; ++j) {
+        for (int a = 0; a < nVirA; ++a) {
+          for (int k : occupiedBeta) {
+            s2 += x(i, a) * x(j, a) * spatialOverlap(occupiedAlpha[i], k) * spatialOverlap(occupiedAlpha[j], k);
+          }
+        }
+      }
+    }
+    for (int i = 0; i < nOccB; ++i) {
+      for (int j = 0; j < nOccB; ++j) {
+        for (int a = 0; a < nVirB; ++a) {
+          for (int k : occupiedAlpha) {
+            s2 += y(i, a) * y(j, a) * spatialOverlap(k, occupiedBeta[i]) * spatialOverlap(k, occupiedBeta[j]);
+          }
+        }
+      }
+    }
+    for (int i = 0; i < nOccA; ++i) {
+      for (int j = 0; j < nOccB; ++j) {
+        for (int a = 0; a < nVirA; ++a) {
+          for (int b = 0; b < nVirB; ++b) {
+            s2 -= 2 * spatialOverlap(occupiedAlpha[i], occupiedBeta[j]) *
+                  spatialOverlap(virtualAlpha[a], virtualBeta[b]) * x(i, a) * y(j, b);
+          }
+        }
+      }
+    }
+    result[root] = s2;
+  }
+  return result;
+}
+} // namespace
+
+class ACISSpinContaminator : public Test {
+ public:
+  Eigen::MatrixXd alphaOrbitals, betaOrbitals;
+  std::vector<int> occupiedAlpha, occupiedBeta;
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, std::vector<int>> excitationIndices;
+
+  void SetUp() override {
+    std::srand(42);
+  }
+
+  void setUpSystem(int nOrbitals, int nAlpha, int nBeta) {
+    // Slightly different orthonormal alpha and beta orbitals
+    alphaOrbitals = Eigen::HouseholderQR<Eigen::MatrixXd>(Eigen::MatrixXd::Random(nOrbitals, nOrbitals)).householderQ();
+    Eigen::MatrixXd perturbed = alphaOrbitals + 0.1 * Eigen::MatrixXd::Random(nOrbitals, nOrbitals);
+    betaOrbitals = Eigen::HouseholderQR<Eigen::MatrixXd>(perturbed).householderQ();
+    occupiedAlpha.resize(nAlpha);
+    occupiedBeta.resize(nBeta);
+    std::iota(occupiedAlpha.begin(), occupiedAlpha.end(), 0);
+    std::iota(occupiedBeta.begin(), occupiedBeta.end(), 0);
+    excitationIndices.alpha.resize(nAlpha * (nOrbitals - nAlpha));
+    excitationIndices.beta.resize(nBeta * (nOrbitals - nBeta));
+    std::iota(excitationIndices.alpha.begin(), excitationIndices.alpha.end(), 0);
+    std::iota(excitationIndices.beta.begin(), excitationIndices.beta.end(), 0);
+  }
+
+  Utils::MolecularOrbitals orbitals() const {
+    return Utils::MolecularOrbitals::createFromUnrestrictedCoefficients(alphaOrbitals, betaOrbitals);
+  }
+};
+
+TEST_F(ACISSpinContaminator, GivesSingletAndTripletForSpinAdaptedCombinations) {
+  setUpSystem(6, 2, 2);
+  betaOrbitals = alphaOrbitals;
+  const int nExcitations = excitationIndices.alpha.size();
+  // HOMO -> LUMO in alpha and beta, in phase for the singlet and out of phase for the triplet
+  const int homoLumo = 1 * 4 + 0;
+  Eigen::MatrixXd eigenVectors = Eigen::MatrixXd::Zero(2 * nExcitations, 2);
+  eigenVectors(homoLumo, 0) = std::sqrt(0.5);
+  eigenVectors(nExcitations + homoLumo, 0) = std::sqrt(0.5);
+  eigenVectors(homoLumo, 1) = std::sqrt(0.5);
+  eigenVectors(nExcitations + homoLumo, 1) = -std::sqrt(0.5);
+
+  Eigen::VectorXd s2 = CISSpinContaminator::calculateSpinContaminationOpenShell(orbitals(), eigenVectors, occupiedAlpha,
+                                                                                 occupiedBeta, excitationIndices);
+  EXPECT_THAT(s2[0], DoubleNear(0.0, 1e-12));
+  EXPECT_THAT(s2[1], DoubleNear(2.0, 1e-12));
+}
+
+TEST_F(ACISSpinContaminator, GivesExactValuesForRotatedBetaOrbitals) {
+  // Doublet with two alpha and one beta electron in four orbitals, the beta orbitals being rotations of the alpha
+  // ones. The values are the expectation values of S^2 of the CIS states expanded in determinants, they differ from
+  // the ones of the original loops, which confused the virtual and occupied indices in three of the terms.
+  setUpSystem(4, 2, 1);
+  auto rotation = [](int p, int q, double angle) {
+    Eigen::MatrixXd givens = Eigen::MatrixXd::Identity(4, 4);
+    givens(p, p) = givens(q, q) = std::cos(angle);
+    givens(p, q) = -std::sin(angle);
+    givens(q, p) = std::sin(angle);
+    return givens;
+  };
+  alphaOrbitals = Eigen::MatrixXd::Identity(4, 4);
+  betaOrbitals = rotation(0, 2, 0.3) * rotation(1, 3, 0.2) * rotation(0, 1, 0.25) * rotation(2, 3, 0.15);
+  // Alpha excitations 0->2, 0->3, 1->2, 1->3 followed by the beta excitations 0->1, 0->2, 0->3
+  Eigen::MatrixXd eigenVectors = Eigen::MatrixXd::Zero(7, 4);
+  eigenVectors(4, 0) = 1.0;
+  eigenVectors(2, 1) = 1.0;
+  eigenVectors(0, 2) = std::sqrt(0.5);
+  eigenVectors(5, 2) = std::sqrt(0.5);
+  eigenVectors.col(3) << 0.4, -0.3, 0.5, 0.2, 0.3, -0.5, 0.35;
+  eigenVectors.col(3).normalize();
+
+  Eigen::VectorXd s2 = CISSpinContaminator::calculateSpinContaminationOpenShell(orbitals(), eigenVectors, occupiedAlpha,
+                                                                                 occupiedBeta, excitationIndices);
+  EXPECT_THAT(s2[0], DoubleNear(0.792399116916, 1e-10));
+  EXPECT_THAT(s2[1], DoubleNear(0.811208719055, 1e-10));
+  EXPECT_THAT(s2[2], DoubleNear(0.762113067615, 1e-10));
+  EXPECT_THAT(s2[3], DoubleNear(2.137095473287, 1e-10));
+}
+
+TEST_F(ACISSpinContaminator, AgreesWithElementWiseEvaluation) {
+  setUpSystem(14, 6, 4);
+  const int nRoots = 5;
+  const int nExcitations = excitationIndices.alpha.size() + excitationIndices.beta.size();
+  Eigen::MatrixXd eigenVectors = Eigen::MatrixXd::Random(nExcitations, nRoots);
+  eigenVectors.colwise().normalize();
+
+  Eigen::VectorXd s2 = CISSpinContaminator::calculateSpinContaminationOpenShell(orbitals(), eigenVectors, occupiedAlpha,
+                                                                                 occupiedBeta, excitationIndices);
+  const Eigen::MatrixXd spatialOverlap = alphaOrbitals.transpose() * betaOrbitals;
+  Eigen::VectorXd reference =
+      loopSpinContamination(spatialOverlap, eigenVectors.topRows(excitationIndices.alpha.size()),
+                            eigenVectors.bottomRows(excitationIndices.beta.size()), occupiedAlpha, occupiedBeta);
+  for (int root = 0; root < nRoots; ++root) {
+    EXPECT_THAT(s2[root], DoubleNear(reference[root], 1e-10));
+  }
+}
+
+TEST_F(ACISSpinContaminator, ScattersPrunedExcitationSpace) {
+  setUpSystem(10, 4, 3);
+  const int nAlphaExcitations = excitationIndices.alpha.size();
+  const int nBetaExcitations = excitationIndices.beta.size();
+  Eigen::MatrixXd completeVectors = Eigen::MatrixXd::Random(nAlphaExcitations + nBetaExcitations, 3);
+  // Keep every second excitation, the others have vanishing coefficients
+  Utils::SpinAdaptedContainer<Utils::Reference::Unrestricted, std::vector<int>> prunedIndices;
+  std::vector<int> keptRows;
+  for (int exc = 0; exc < nAlphaExcitations; exc += 2) {
+    prunedIndices.alpha.push_back(exc);
+    keptRows.push_back(exc);
+  }
+  for (int exc = 0; exc < nBetaExcitations; exc += 2) {
+    prunedIndices.beta.push_back(exc);
+    keptRows.push_back(nAlphaExcitations + exc);
+  }
+  Eigen::MatrixXd prunedVectors(keptRows.size(), completeVectors.cols());
+  Eigen::MatrixXd scatteredVectors = Eigen::MatrixXd::Zero(completeVectors.rows(), completeVectors.cols());
+  for (int row = 0; row < static_cast<int>(keptRows.size()); ++row) {
+    prunedVectors.row(row) = completeVectors.row(keptRows[row]);
+    scatteredVectors.row(keptRows[row]) = completeVectors.row(keptRows[row]);
+  }
+
+  Eigen::VectorXd pruned = CISSpinContaminator::calculateSpinContaminationOpenShell(
+      orbitals(), prunedVectors, occupiedAlpha, occupiedBeta, prunedIndices);
+  Eigen::VectorXd complete = CISSpinContaminator::calculateSpinContaminationOpenShell(
+      orbitals(), scatteredVectors, occupiedAlpha, occupiedBeta, excitationIndices);
+  ASSERT_TRUE(pruned.isApprox(complete, 1e-12));
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -188,6 +188,54 @@ TEST_F(ACISTestCalculation, ThrowsIfNoReferenceCalculationPerformed) {
   ASSERT_THROW(CISCalculator.calculate(), InvalidReferenceCalculationException);
 }
 
+TEST_F(ACISTestCalculation, DoesNotRecalculateTightlyConvergedReference) {
+  auto reference = calculator->clone();
+  reference->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-9);
+  reference->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixAO);
+  reference->calculate("Converged reference.");
+  CISCalculator.setReferenceCalculator(reference);
+  CISCalculator.referenceCalculation();
+  EXPECT_THAT(reference->results().get<Utils::Property::Description>(), Eq("Converged reference."));
+  EXPECT_THAT(reference->settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion), DoubleEq(1e-9));
+
+  CISCalculator.settings().modifyString(Utils::SettingsNames::spinBlock, "singlet");
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 5);
+  const auto& reused = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  Eigen::VectorXd singletEnergies = reused.singlet->eigenStates.eigenValues;
+  reference->modifyPositions(reference->getPositions());
+  CISCalculator.referenceCalculation();
+  EXPECT_THAT(reference->results().get<Utils::Property::Description>(), Eq("CIS reference calculation."));
+  const auto& recalculated = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  for (int i = 0; i < singletEnergies.size(); ++i) {
+    EXPECT_THAT(recalculated.singlet->eigenStates.eigenValues(i), DoubleNear(singletEnergies(i), 1e-8));
+  }
+}
+
+TEST_F(ACISTestCalculation, ConvergesLooselyConvergedReferenceAgain) {
+  auto reference = calculator->clone();
+  reference->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-5);
+  reference->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixAO);
+  reference->calculate("Loose reference.");
+  CISCalculator.setReferenceCalculator(reference);
+  CISCalculator.referenceCalculation();
+  EXPECT_THAT(reference->results().get<Utils::Property::Description>(), Eq("CIS reference calculation."));
+  EXPECT_THAT(reference->settings().getDouble(Utils::SettingsNames::selfConsistenceCriterion), DoubleEq(1e-8));
+  // The transition dipoles are transformed from the AO dipole matrix, the full MO transformation is not done
+  EXPECT_TRUE(reference->results().has<Utils::Property::DipoleMatrixAO>());
+  EXPECT_FALSE(reference->results().has<Utils::Property::DipoleMatrixMO>());
+}
+
+TEST_F(ACISTestCalculation, ConvergesReferenceWhoseCriterionWasTightenedAfterTheCalculation) {
+  auto reference = calculator->clone();
+  reference->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-5);
+  reference->setRequiredProperties(Utils::Property::Energy | Utils::Property::DipoleMatrixAO);
+  reference->calculate("Loose reference.");
+  reference->settings().modifyDouble(Utils::SettingsNames::selfConsistenceCriterion, 1e-9);
+  CISCalculator.setReferenceCalculator(reference);
+  CISCalculator.referenceCalculation();
+  EXPECT_THAT(reference->results().get<Utils::Property::Description>(), Eq("CIS reference calculation."));
+}
+
 TEST_F(ACISTestCalculation, RHFCISPreconditionerEvaluatedCorrectly) {
   Utils::SingleParticleEnergies energies;
   auto mos = Utils::MolecularOrbitals::createFromRestrictedCoefficients(Eigen::MatrixXd::Random(5, 5));
@@ -404,6 +452,87 @@ TEST_F(ACISTestCalculation, CanPerformDenseCalculationOnTripletBlockForBiggerSys
   }
 }
 
+TEST_F(ACISTestCalculation, OutOfCoreIntegralsGiveSameExcitationEnergies) {
+  CISCalculator.settings().modifyString(Utils::SettingsNames::spinBlock, "both");
+  CISCalculator.setReferenceCalculator(calculator->clone());
+  CISCalculator.referenceCalculation();
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 5);
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::initialSubspaceDimension, 10);
+  CISCalculator.settings().modifyString("integral_storage", "in_memory");
+  const auto& inMemory = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  Eigen::VectorXd singletEnergies = inMemory.singlet->eigenStates.eigenValues;
+  Eigen::VectorXd tripletEnergies = inMemory.triplet->eigenStates.eigenValues;
+
+  CISCalculator.settings().modifyString("integral_storage", "out_of_core");
+  const auto& outOfCore = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  ASSERT_THAT(outOfCore.singlet->eigenStates.eigenValues.size(), Eq(singletEnergies.size()));
+  for (int i = 0; i < singletEnergies.size(); ++i) {
+    EXPECT_THAT(outOfCore.singlet->eigenStates.eigenValues(i), DoubleNear(singletEnergies(i), 1e-10));
+    EXPECT_THAT(outOfCore.triplet->eigenStates.eigenValues(i), DoubleNear(tripletEnergies(i), 1e-10));
+  }
+}
+
+TEST_F(ACISTestCalculation, IntegralDirectFockBuildGivesSameExcitationEnergies) {
+  CISCalculator.settings().modifyString(Utils::SettingsNames::spinBlock, "both");
+  CISCalculator.setReferenceCalculator(calculator->clone());
+  CISCalculator.referenceCalculation();
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 5);
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::initialSubspaceDimension, 10);
+  CISCalculator.settings().modifyString("integral_storage", "in_memory");
+  const auto& inMemory = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  Eigen::VectorXd singletEnergies = inMemory.singlet->eigenStates.eigenValues;
+  Eigen::VectorXd tripletEnergies = inMemory.triplet->eigenStates.eigenValues;
+
+  CISCalculator.settings().modifyString("integral_storage", "direct");
+  CISCalculator.settings().modifyDouble("direct_screening_threshold", 1e-12);
+  const auto& direct = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  ASSERT_THAT(direct.singlet->eigenStates.eigenValues.size(), Eq(singletEnergies.size()));
+  for (int i = 0; i < singletEnergies.size(); ++i) {
+    EXPECT_THAT(direct.singlet->eigenStates.eigenValues(i), DoubleNear(singletEnergies(i), 1e-8));
+    EXPECT_THAT(direct.triplet->eigenStates.eigenValues(i), DoubleNear(tripletEnergies(i), 1e-8));
+  }
+}
+
+TEST_F(ACISTestCalculation, DavidsonGuessesAndPreconditionersGiveSameExcitationEnergies) {
+  CISCalculator.settings().modifyString(Utils::SettingsNames::spinBlock, "both");
+  CISCalculator.setReferenceCalculator(calculator->clone());
+  CISCalculator.referenceCalculation();
+  CISCalculator.settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 5);
+  CISCalculator.settings().modifyDouble("convergence", 1e-7);
+  CISCalculator.settings().modifyString("davidson_guess", "energy_differences");
+  CISCalculator.settings().modifyString("preconditioner", "energy_differences");
+  const auto& reference = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+  Eigen::VectorXd singletEnergies = reference.singlet->eigenStates.eigenValues;
+  Eigen::VectorXd tripletEnergies = reference.triplet->eigenStates.eigenValues;
+
+  for (const auto* guess : {"energy_differences", "diagonal", "subspace"}) {
+    for (const auto* preconditioner : {"energy_differences", "coupled_diagonal"}) {
+      CISCalculator.settings().modifyString("davidson_guess", guess);
+      CISCalculator.settings().modifyString("preconditioner", preconditioner);
+      const auto& excitedStates = CISCalculator.calculate().get<Utils::Property::ExcitedStates>();
+      ASSERT_THAT(excitedStates.singlet->eigenStates.eigenValues.size(), Eq(singletEnergies.size()));
+      for (int i = 0; i < singletEnergies.size(); ++i) {
+        EXPECT_THAT(excitedStates.singlet->eigenStates.eigenValues(i), DoubleNear(singletEnergies(i), 1e-8));
+        EXPECT_THAT(excitedStates.triplet->eigenStates.eigenValues(i), DoubleNear(tripletEnergies(i), 1e-8));
+      }
+      const auto& iterationCounts = CISCalculator.getIterationCounts();
+      ASSERT_THAT(iterationCounts.singlet.size(), Eq(5u));
+      ASSERT_THAT(iterationCounts.triplet.size(), Eq(5u));
+      EXPECT_THAT(iterationCounts.unrestricted, IsEmpty());
+      EXPECT_THAT(iterationCounts.singlet, Each(Gt(0)));
+      EXPECT_THAT(iterationCounts.triplet, Each(Gt(0)));
+    }
+  }
+}
+
+TEST_F(ACISTestCalculation, ThrowsIfOutOfCoreIntegralsExceedMaximumMemory) {
+  CISCalculator.setReferenceCalculator(calculator->clone());
+  CISCalculator.referenceCalculation();
+  CISCalculator.settings().modifyString("integral_storage", "auto");
+  CISCalculator.settings().modifyDouble(Utils::SettingsNames::maxMemory, 1e-9);
+  EXPECT_THROW(CISCalculator.calculate(), std::runtime_error);
+}
+
 TEST_F(ACISTestCalculation, CanAskForCISThroughInterface) {
   auto& manager = Core::ModuleManager::getInstance();
 
@@ -0,0 +1,149 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/TimeDependent/DavidsonGuessBuilder.h>
+#include <Sparrow/Implementations/TimeDependent/RootConvergenceMonitor.h>
+#include <Utils/Math/IterativeDiagonalizer/SigmaVectorEvaluator.h>
+#include <gmock/gmock.h>
+#include <Eigen/Eigenvalues>
+#include <cmath>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+namespace {
+// Sigma vectors as products with an explicit matrix, recording the number of evaluated vectors.
+class MatrixSigmaVectorEvaluator : public Utils::SigmaVectorEvaluator {
+ public:
+  explicit MatrixSigmaVectorEvaluator(Eigen::MatrixXd matrix) : matrix_(std::move(matrix)) {
+  }
+  const Eigen::MatrixXd& evaluate(const Eigen::MatrixXd& guessVectors) const final {
+    sigmaVectors_ = matrix_ * guessVectors;
+    return sigmaVectors_;
+  }
+  void collapsed(int /*newSubspaceDimension*/) final {
+    ++collapses;
+  }
+  int collapses = 0;
+
+ private:
+  Eigen::MatrixXd matrix_;
+  mutable Eigen::MatrixXd sigmaVectors_;
+};
+} // namespace
+
+/**
+ * Diagonally dominant symmetric test matrix with a degenerate pair on the diagonal.
+ */
+class ADavidsonGuessBuilder : public Test {
+ public:
+  const int nConfigurations = 20;
+  Eigen::VectorXd diagonal;
+  Eigen::MatrixXd matrix;
+
+  void SetUp() override {
+    srand(42);
+    diagonal = Eigen::VectorXd::LinSpaced(nConfigurations, 1.0, 3.0);
+    diagonal(7) = 0.5;
+    diagonal(3) = 0.5;
+    Eigen::MatrixXd random = 0.01 * Eigen::MatrixXd::Random(nConfigurations, nConfigurations);
+    matrix = random + random.transpose();
+    matrix.diagonal() = diagonal;
+  }
+};
+
+TEST_F(ADavidsonGuessBuilder, GivesUnitVectorsOfLowestDiagonalElements) {
+  const Eigen::MatrixXd guess = DavidsonGuessBuilder::diagonalGuess(diagonal, 3);
+  ASSERT_THAT(guess.cols(), Eq(3));
+  EXPECT_THAT(guess(3, 0), DoubleEq(1.0));
+  EXPECT_THAT(guess(7, 1), DoubleEq(1.0));
+  EXPECT_THAT(guess(0, 2), DoubleEq(1.0));
+  EXPECT_TRUE((guess.transpose() * guess).isIdentity(1e-14));
+}
+
+TEST_F(ADavidsonGuessBuilder, DoesNotSplitDegenerateDiagonalElements) {
+  const Eigen::MatrixXd guess = DavidsonGuessBuilder::diagonalGuess(diagonal, 1);
+  ASSERT_THAT(guess.cols(), Eq(2));
+  EXPECT_THAT(guess(3, 0), DoubleEq(1.0));
+  EXPECT_THAT(guess(7, 1), DoubleEq(1.0));
+}
+
+TEST_F(ADavidsonGuessBuilder, SpinAdaptsDegenerateAlphaAndBetaConfigurations) {
+  Eigen::Matrix<bool, -1, 1> isBeta = Eigen::Matrix<bool, -1, 1>::Constant(nConfigurations, false);
+  isBeta(7) = true;
+  const Eigen::MatrixXd guess = DavidsonGuessBuilder::diagonalGuess(diagonal, 2, isBeta);
+  ASSERT_THAT(guess.cols(), Eq(2));
+  const double component = 1.0 / std::sqrt(2.0);
+  EXPECT_THAT(guess(3, 0), DoubleEq(component));
+  EXPECT_THAT(guess(7, 0), DoubleEq(component));
+  EXPECT_THAT(guess(3, 1), DoubleEq(component));
+  EXPECT_THAT(guess(7, 1), DoubleEq(-component));
+  EXPECT_TRUE((guess.transpose() * guess).isIdentity(1e-14));
+}
+
+TEST_F(ADavidsonGuessBuilder, SubspaceGuessInFullSpaceGivesEigenvectors) {
+  MatrixSigmaVectorEvaluator evaluator(matrix);
+  const int nRoots = 4;
+  const Eigen::MatrixXd guess =
+      DavidsonGuessBuilder::subspaceGuess(evaluator, diagonal, nRoots, nConfigurations);
+  ASSERT_THAT(guess.cols(), Eq(nRoots));
+  EXPECT_THAT(evaluator.collapses, Eq(1));
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(matrix);
+  for (int root = 0; root < nRoots; ++root) {
+    EXPECT_THAT(std::abs(guess.col(root).dot(solver.eigenvectors().col(root))), DoubleNear(1.0, 1e-10));
+  }
+}
+
+TEST_F(ADavidsonGuessBuilder, SubspaceGuessIsCloserToEigenvectorsThanDiagonalGuess) {
+  MatrixSigmaVectorEvaluator evaluator(matrix);
+  const Eigen::MatrixXd diagonalGuess = DavidsonGuessBuilder::diagonalGuess(diagonal, 1);
+  const Eigen::MatrixXd subspaceGuess = DavidsonGuessBuilder::subspaceGuess(
+      evaluator, diagonal, 1, DavidsonGuessBuilder::defaultSubspaceDimension(1, nConfigurations));
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(matrix);
+  const Eigen::VectorXd lowest = solver.eigenvectors().col(0);
+  EXPECT_THAT(std::abs(subspaceGuess.col(0).dot(lowest)), Gt(std::abs(diagonalGuess.col(0).dot(lowest))));
+}
+
+TEST_F(ADavidsonGuessBuilder, MonitorRecordsIterationOfConvergedRoots) {
+  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(matrix);
+  std::vector<int> iterations;
+  RootConvergenceMonitor monitor(std::make_unique<MatrixSigmaVectorEvaluator>(matrix), 2, 1e-8, iterations);
+  // First iteration: only the lowest eigenvector is in the subspace, non-orthogonal to the second guess vector.
+  Eigen::MatrixXd subspace(nConfigurations, 2);
+  subspace.col(0) = solver.eigenvectors().col(0);
+  subspace.col(1) = solver.eigenvectors().col(0) + Eigen::VectorXd::Unit(nConfigurations, 0);
+  monitor.evaluate(subspace);
+  ASSERT_THAT(iterations.size(), Eq(2u));
+  EXPECT_THAT(iterations[0], Eq(1));
+  EXPECT_THAT(iterations[1], Eq(0));
+  // Second iteration: the second eigenvector completes the subspace.
+  subspace.conservativeResize(Eigen::NoChange, 3);
+  subspace.col(2) = solver.eigenvectors().col(1);
+  monitor.evaluate(subspace);
+  EXPECT_THAT(iterations[0], Eq(1));
+  EXPECT_THAT(iterations[1], Eq(2));
+  EXPECT_THAT(monitor.getNumberOfIterations(), Eq(2));
+}
+
+TEST_F(ADavidsonGuessBuilder, MonitorForwardsCollapseAndFinalizesUnconvergedRoots) {
+  std::vector<int> iterations;
+  auto evaluator = std::make_unique<MatrixSigmaVectorEvaluator>(matrix);
+  const auto* matrixEvaluator = evaluator.get();
+  RootConvergenceMonitor monitor(std::move(evaluator), 3, 1e-12, iterations);
+  const Eigen::MatrixXd guess = DavidsonGuessBuilder::diagonalGuess(diagonal, 4);
+  monitor.evaluate(guess);
+  monitor.collapsed(3);
+  EXPECT_THAT(matrixEvaluator->collapses, Eq(1));
+  monitor.evaluate(guess.leftCols(3));
+  monitor.finalize();
+  EXPECT_THAT(iterations, ElementsAre(2, 2, 2));
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -0,0 +1,166 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Core/Interfaces/Calculator.h>
+#include <Core/ModuleManager.h>
+#include <Sparrow/Implementations/TimeDependent/LinearResponseCalculator.h>
+#include <Sparrow/Implementations/TimeDependent/ZVectorSolver.h>
+#include <Utils/CalculatorBasics.h>
+#include <Utils/IO/ChemicalFileFormats/XyzStreamHandler.h>
+#include <Utils/Settings.h>
+#include <Utils/UniversalSettings/SettingsNames.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * Compares the analytical gradients of the lowest excited states of a slightly distorted formaldehyde with
+ * central finite differences of the sum of the energy of the reference and of the excitation energy.
+ */
+class AnExcitedStateGradient : public Test {
+ public:
+  Utils::AtomCollection structure;
+  const double step = 1e-4;
+
+  void SetUp() override {
+    std::stringstream formaldehyde("4\n\n"
+                                   "C   0.0102   -0.0054    0.0031\n"
+                                   "O  -0.0121    0.0087    1.2153\n"
+                                   "H   0.0215    0.9421   -0.5812\n"
+                                   "H  -0.0138   -0.9376   -0.5935\n");
+    structure = Utils::XyzStreamHandler::read(formaldehyde);
+  }
+
+  std::shared_ptr<LinearResponseCalculator> createCalculator(const std::string& excitedStatesModel,
+                                                             const std::string& referenceModel,
+                                                             const std::string& spinBlock) const {
+    auto& manager = Core::ModuleManager::getInstance();
+    auto reference = manager.get<Core::Calculator>(referenceModel);
+    reference->setLog(Core::Log::silent());
+    reference->settings().modifyDouble(Utils::SettingsNames::densityRmsdCriterion, 1e-11);
+    reference->setRequiredProperties(Utils::Property::Energy | Utils::Property::Gradients);
+    reference->setStructure(structure);
+    auto calculator = std::dynamic_pointer_cast<LinearResponseCalculator>(
+        manager.get<Core::CalculatorWithReference>(excitedStatesModel));
+    calculator->setLog(Core::Log::silent());
+    calculator->setReferenceCalculator(reference);
+    calculator->settings().modifyString(Utils::SettingsNames::spinBlock, spinBlock);
+    calculator->settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 3);
+    calculator->settings().modifyDouble("convergence", 1e-9);
+    calculator->applySettings();
+    return calculator;
+  }
+
+  double excitedStateEnergy(LinearResponseCalculator& calculator, const Utils::PositionCollection& positions, int root,
+                            Utils::SpinTransition spinBlock) const {
+    calculator.getReferenceCalculator().modifyPositions(positions);
+    calculator.referenceCalculation();
+    const auto& excitedStates = calculator.calculate().get<Utils::Property::ExcitedStates>();
+    const auto& transitionResult =
+        spinBlock == Utils::SpinTransition::Singlet ? excitedStates.singlet : excitedStates.triplet;
+    return calculator.getReferenceCalculator().results().get<Utils::Property::Energy>() +
+           transitionResult->eigenStates.eigenValues(root);
+  }
+
+  void expectFiniteDifferenceGradients(LinearResponseCalculator& calculator, int root,
+                                       Utils::SpinTransition spinBlock) {
+    const Utils::PositionCollection positions = structure.getPositions();
+    calculator.referenceCalculation();
+    calculator.calculate();
+    const Utils::GradientCollection gradients = calculator.getExcitedStateGradients(root, spinBlock);
+    for (int atom = 0; atom < positions.rows(); ++atom) {
+      for (int dimension = 0; dimension < 3; ++dimension) {
+        Utils::PositionCollection displaced = positions;
+        displaced(atom, dimension) += step;
+        const double forward = excitedStateEnergy(calculator, displaced, root, spinBlock);
+        displaced(atom, dimension) -= 2 * step;
+        const double backward = excitedStateEnergy(calculator, displaced, root, spinBlock);
+        EXPECT_THAT(gradients(atom, dimension), DoubleNear((forward - backward) / (2 * step), 1e-5));
+      }
+    }
+    calculator.getReferenceCalculator().modifyPositions(positions);
+  }
+};
+
+TEST_F(AnExcitedStateGradient, CISSingletGradientMatchesFiniteDifferences) {
+  auto calculator = createCalculator("CIS-NDDO", "PM6", "singlet");
+  expectFiniteDifferenceGradients(*calculator, 0, Utils::SpinTransition::Singlet);
+}
+
+TEST_F(AnExcitedStateGradient, CISTripletGradientMatchesFiniteDifferences) {
+  auto calculator = createCalculator("CIS-NDDO", "AM1", "triplet");
+  expectFiniteDifferenceGradients(*calculator, 1, Utils::SpinTransition::Triplet);
+}
+
+TEST_F(AnExcitedStateGradient, TDDFTBSingletGradientMatchesFiniteDifferences) {
+  auto calculator = createCalculator("TD-DFTB", "DFTB2", "singlet");
+  expectFiniteDifferenceGradients(*calculator, 0, Utils::SpinTransition::Singlet);
+}
+
+TEST_F(AnExcitedStateGradient, TDDFTBTripletGradientMatchesFiniteDifferences) {
+  auto calculator = createCalculator("TD-DFTB", "DFTB2", "triplet");
+  expectFiniteDifferenceGradients(*calculator, 1, Utils::SpinTransition::Triplet);
+}
+
+TEST_F(AnExcitedStateGradient, TDASingletGradientMatchesFiniteDifferences) {
+  auto calculator = createCalculator("TD-DFTB", "DFTB2", "singlet");
+  calculator->settings().modifyBool("tda", true);
+  expectFiniteDifferenceGradients(*calculator, 0, Utils::SpinTransition::Singlet);
+}
+
+TEST_F(AnExcitedStateGradient, ThrowsWithoutGradientsOfReference) {
+  auto calculator = createCalculator("CIS-NDDO", "PM6", "singlet");
+  calculator->getReferenceCalculator().setRequiredProperties(Utils::Property::Energy);
+  calculator->referenceCalculation();
+  calculator->calculate();
+  EXPECT_THROW(calculator->getExcitedStateGradients(0, Utils::SpinTransition::Singlet), std::runtime_error);
+}
+
+TEST_F(AnExcitedStateGradient, ThrowsForDFTB0) {
+  auto calculator = createCalculator("TD-DFTB", "DFTB0", "singlet");
+  calculator->referenceCalculation();
+  calculator->calculate();
+  EXPECT_THROW(calculator->getExcitedStateGradients(0, Utils::SpinTransition::Singlet), std::runtime_error);
+}
+
+TEST(AZVectorSolver, SolvesPositiveDefiniteEquations) {
+  Eigen::MatrixXd energyDifferences(3, 2);
+  energyDifferences << 0.5, 0.7, 0.9, 1.1, 1.3, 1.5;
+  Eigen::MatrixXd coupling = Eigen::MatrixXd::Random(6, 6);
+  const Eigen::VectorXd diagonal = Eigen::Map<const Eigen::VectorXd>(energyDifferences.data(), 6);
+  const Eigen::MatrixXd hessian = Eigen::MatrixXd(diagonal.asDiagonal()) + 0.05 * coupling * coupling.transpose();
+  const Eigen::MatrixXd lagrangian = Eigen::MatrixXd::Random(3, 2);
+  auto product = [&](const Eigen::MatrixXd& z) -> Eigen::MatrixXd {
+    Eigen::VectorXd result = hessian * Eigen::Map<const Eigen::VectorXd>(z.data(), z.size());
+    return Eigen::Map<const Eigen::MatrixXd>(result.data(), z.rows(), z.cols());
+  };
+  ZVectorSolver solver(energyDifferences);
+  const Eigen::MatrixXd z = solver.solve(lagrangian, product);
+  ASSERT_THAT((product(z) + lagrangian).norm(), Lt(1e-8));
+  ASSERT_THAT(solver.getNumberOfIterations(), Le(6));
+}
+
+TEST(AZVectorSolver, ThrowsForIndefiniteHessian) {
+  Eigen::MatrixXd energyDifferences(2, 1);
+  energyDifferences << 0.5, 0.7;
+  // The coupling of an unstable reference makes the Hessian indefinite
+  auto product = [](const Eigen::MatrixXd& z) -> Eigen::MatrixXd {
+    Eigen::MatrixXd result(2, 1);
+    result << 0.5 * z(0, 0) + 2.0 * z(1, 0), 2.0 * z(0, 0) + 0.7 * z(1, 0);
+    return result;
+  };
+  ZVectorSolver solver(energyDifferences);
+  Eigen::MatrixXd lagrangian(2, 1);
+  lagrangian << 1.0, -1.0;
+  ASSERT_THROW(solver.solve(lagrangian, product), std::runtime_error);
+}
+
+} // namespace Sparrow
+} // namespace Scine
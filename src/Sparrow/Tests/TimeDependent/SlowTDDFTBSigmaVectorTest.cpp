@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Dftb/TimeDependent/LinearResponse/OrderedInput.h>
+#include <Sparrow/Implementations/Dftb/TimeDependent/LinearResponse/TDDFTBSigmaVectorEvaluator.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * Sigma vectors of TD-DFTB for a 500-atom chromophore, the all-trans polyene C249H251, in a pruned space of 20000
+ * transitions. The gamma matrix is the Klopman-Ohno approximation for the polyene geometry, the transition charges
+ * are random. The blocked evaluation of all guess vectors is compared with the evaluation of one guess vector at a
+ * time with matrix-vector products, as before the blocking.
+ */
+class SlowTDDFTBSigmaVector : public Test {
+ public:
+  const int nTransitions = 20000;
+  std::shared_ptr<Eigen::MatrixXd> gamma;
+  std::shared_ptr<Eigen::VectorXd> spinConstants;
+  OrderedInput<Utils::Reference::Restricted> input;
+
+  void SetUp() override {
+    // Positions in bohr and Hubbard parameters of the carbon and hydrogen atoms of the chain
+    std::vector<Eigen::Vector3d> positions;
+    std::vector<double> hubbard;
+    const int nCarbons = 249;
+    for (int i = 0; i < nCarbons; ++i) {
+      const double sign = i % 2 == 0 ? 1.0 : -1.0;
+      const Eigen::Vector3d carbon(2.29 * i, 0.66 * sign, 0.0);
+      positions.push_back(carbon);
+      hubbard.push_back(0.3647);
+      positions.emplace_back(carbon + Eigen::Vector3d(0.0, 2.06 * sign, 0.0));
+      hubbard.push_back(0.4195);
+      if (i == 0 || i == nCarbons - 1) {
+        positions.emplace_back(carbon + Eigen::Vector3d(i == 0 ? -1.78 : 1.78, -1.02 * sign, 0.0));
+        hubbard.push_back(0.4195);
+      }
+    }
+    const int nAtoms = positions.size();
+    gamma = std::make_shared<Eigen::MatrixXd>(nAtoms, nAtoms);
+    for (int a = 0; a < nAtoms; ++a) {
+      for (int b = 0; b < nAtoms; ++b) {
+        const double a0 = 2.0 / (hubbard[a] + hubbard[b]);
+        (*gamma)(a, b) = 1.0 / std::sqrt((positions[a] - positions[b]).squaredNorm() + a0 * a0);
+      }
+    }
+    spinConstants = std::make_shared<Eigen::VectorXd>(Eigen::VectorXd::Constant(nAtoms, -0.023));
+
+    srand(42);
+    input.energyDifferences() = Eigen::VectorXd::Random(nTransitions).cwiseAbs();
+    input.energyDifferences().array() += 0.1;
+    std::sort(input.energyDifferences().data(), input.energyDifferences().data() + nTransitions);
+    input.transitionCharges() = 0.05 * Eigen::MatrixXd::Random(nTransitions, nAtoms);
+  }
+};
+
+TEST_F(SlowTDDFTBSigmaVector, BlockedSigmaVectorsEqualTheOnesOfSingleGuessVectors) {
+  // h_{ia, A} = q_{ia, A} * sqrt(Delta_{ia})
+  const Eigen::MatrixXd h = input.transitionCharges().array().colwise() * input.energyDifferences().cwiseSqrt().array();
+  for (auto spinBlock : {Utils::SpinTransition::Singlet, Utils::SpinTransition::Triplet}) {
+    for (int nRoots : {1, 8, 64}) {
+      const Eigen::MatrixXd guessVectors = Eigen::MatrixXd::Random(nTransitions, nRoots);
+      TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> evaluator(gamma, spinConstants, input, spinBlock);
+      const Eigen::MatrixXd sigmaVectors = evaluator.evaluate(guessVectors);
+      ASSERT_THAT(sigmaVectors.cols(), Eq(nRoots));
+      for (int root = 0; root < nRoots; ++root) {
+        // R_{ia} = Delta_{ia}^2 * T_{ia} + 4 * \sum_{A} h_{ia, A} * Y_A, with Y = gamma X or W X and X = h^T T
+        const Eigen::VectorXd& guessVector = guessVectors.col(root);
+        const Eigen::VectorXd x = h.transpose() * guessVector;
+        const Eigen::VectorXd y =
+            spinBlock == Utils::SpinTransition::Singlet ? Eigen::VectorXd(*gamma * x) : spinConstants->cwiseProduct(x);
+        const Eigen::VectorXd expected =
+            input.energyDifferences().cwiseAbs2().cwiseProduct(guessVector) + 4.0 * h * y;
+        EXPECT_TRUE(sigmaVectors.col(root).isApprox(expected, 1e-10));
+      }
+    }
+  }
+}
+
+} // namespace Sparrow
+} // namespace Scine
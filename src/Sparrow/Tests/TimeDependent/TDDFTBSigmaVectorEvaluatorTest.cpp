@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @copyright This code is licensed under the 3-clause BSD license.\n
+ *            Copyright ETH Zurich, Laboratory of Physical Chemistry, Reiher Group.\n
+ *            See LICENSE.txt for details.
+ */
+
+#include <Sparrow/Implementations/Dftb/TimeDependent/LinearResponse/OrderedInput.h>
+#include <Sparrow/Implementations/Dftb/TimeDependent/LinearResponse/TDDFTBSigmaVectorEvaluator.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+
+using namespace testing;
+
+namespace Scine {
+namespace Sparrow {
+
+/**
+ * Compares the blocked sigma vectors with the product of the explicitly constructed TD-DFTB matrix, for random
+ * transition charges, gamma matrix and spin constants.
+ */
+class ATDDFTBSigmaVectorEvaluator : public Test {
+ public:
+  const int nAtoms = 7;
+  const int nTransitions = 60;
+  std::shared_ptr<Eigen::MatrixXd> gamma;
+  std::shared_ptr<Eigen::VectorXd> spinConstants;
+  OrderedInput<Utils::Reference::Restricted> restrictedInput;
+  OrderedInput<Utils::Reference::Unrestricted> unrestrictedInput;
+  Eigen::MatrixXd guessVectors;
+
+  void SetUp() override {
+    srand(42);
+    Eigen::MatrixXd random = Eigen::MatrixXd::Random(nAtoms, nAtoms);
+    gamma = std::make_shared<Eigen::MatrixXd>(random + random.transpose());
+    spinConstants = std::make_shared<Eigen::VectorXd>(-0.07 * Eigen::VectorXd::Random(nAtoms).cwiseAbs());
+    Eigen::VectorXd energyDifferences = Eigen::VectorXd::Random(nTransitions).cwiseAbs();
+    energyDifferences.array() += 0.1;
+    std::sort(energyDifferences.data(), energyDifferences.data() + nTransitions);
+    const Eigen::MatrixXd transitionCharges = Eigen::MatrixXd::Random(nTransitions, nAtoms);
+    restrictedInput.energyDifferences() = energyDifferences;
+    restrictedInput.transitionCharges() = transitionCharges;
+    unrestrictedInput.energyDifferences() = energyDifferences;
+    unrestrictedInput.transitionCharges() = transitionCharges;
+    unrestrictedInput.isBeta() = Eigen::Matrix<bool, -1, 1>::Constant(nTransitions, false);
+    for (int transition = 0; transition < nTransitions; transition += 3) {
+      unrestrictedInput.isBeta()(transition) = true;
+    }
+    guessVectors = Eigen::MatrixXd::Random(nTransitions, 9);
+  }
+
+  // Energy-weighted transition charges h, the bare transition charges for TDA
+  Eigen::MatrixXd weightedCharges(bool tda) const {
+    const Eigen::MatrixXd& charges = restrictedInput.transitionCharges();
+    return tda ? charges : Eigen::MatrixXd(restrictedInput.energyDifferences().cwiseSqrt().asDiagonal() * charges);
+  }
+
+  // Delta^2 + factor * h W h^T, or Delta + factor * q W q^T for TDA
+  Eigen::MatrixXd matrix(const Eigen::MatrixXd& coupling, double factor, bool tda) const {
+    const Eigen::VectorXd& energyDifferences = restrictedInput.energyDifferences();
+    const Eigen::MatrixXd h = weightedCharges(tda);
+    Eigen::MatrixXd result = factor * h * coupling * h.transpose();
+    result.diagonal() += tda ? energyDifferences : Eigen::VectorXd(energyDifferences.cwiseAbs2());
+    return result;
+  }
+};
+
+TEST_F(ATDDFTBSigmaVectorEvaluator, ReproducesRestrictedMatrixProducts) {
+  for (auto type : {TDDFTBType::TDDFTB, TDDFTBType::TDA}) {
+    const bool tda = type == TDDFTBType::TDA;
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> singlet(gamma, spinConstants, restrictedInput,
+                                                                     Utils::SpinTransition::Singlet, type);
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> triplet(gamma, spinConstants, restrictedInput,
+                                                                     Utils::SpinTransition::Triplet, type);
+    const Eigen::MatrixXd singletMatrix = matrix(*gamma, tda ? 2.0 : 4.0, tda);
+    const Eigen::MatrixXd tripletMatrix = matrix(Eigen::MatrixXd(spinConstants->asDiagonal()), tda ? 2.0 : 4.0, tda);
+    EXPECT_TRUE(singlet.evaluate(guessVectors).isApprox(singletMatrix * guessVectors, 1e-12));
+    EXPECT_TRUE(triplet.evaluate(guessVectors).isApprox(tripletMatrix * guessVectors, 1e-12));
+  }
+}
+
+TEST_F(ATDDFTBSigmaVectorEvaluator, ReproducesUnrestrictedMatrixProducts) {
+  const Eigen::VectorXd signs = unrestrictedInput.isBeta().select(-Eigen::VectorXd::Ones(nTransitions),
+                                                                    Eigen::VectorXd::Ones(nTransitions));
+  for (auto type : {TDDFTBType::TDDFTB, TDDFTBType::TDA}) {
+    const bool tda = type == TDDFTBType::TDA;
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Unrestricted> evaluator(gamma, spinConstants, unrestrictedInput,
+                                                                         Utils::SpinTransition::Singlet, type);
+    // The magnetization term couples alpha and beta transitions with opposite signs
+    const Eigen::MatrixXd h = signs.asDiagonal() * weightedCharges(tda);
+    const Eigen::MatrixXd magnetization = 2.0 * h * spinConstants->asDiagonal() * h.transpose();
+    const Eigen::MatrixXd expected = matrix(*gamma, tda ? 1.0 : 2.0, tda) + magnetization;
+    EXPECT_TRUE(evaluator.evaluate(guessVectors).isApprox(expected * guessVectors, 1e-12));
+  }
+}
+
+TEST_F(ATDDFTBSigmaVectorEvaluator, GivesDiagonalOfExplicitMatrix) {
+  const Eigen::VectorXd signs = unrestrictedInput.isBeta().select(-Eigen::VectorXd::Ones(nTransitions),
+                                                                    Eigen::VectorXd::Ones(nTransitions));
+  for (auto type : {TDDFTBType::TDDFTB, TDDFTBType::TDA}) {
+    const bool tda = type == TDDFTBType::TDA;
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> singlet(gamma, spinConstants, restrictedInput,
+                                                                     Utils::SpinTransition::Singlet, type);
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> triplet(gamma, spinConstants, restrictedInput,
+                                                                     Utils::SpinTransition::Triplet, type);
+    TDDFTBSigmaVectorEvaluator<Utils::Reference::Unrestricted> unrestricted(gamma, spinConstants, unrestrictedInput,
+                                                                            Utils::SpinTransition::Singlet, type);
+    const Eigen::MatrixXd tripletMatrix = matrix(Eigen::MatrixXd(spinConstants->asDiagonal()), tda ? 2.0 : 4.0, tda);
+    const Eigen::MatrixXd h = signs.asDiagonal() * weightedCharges(tda);
+    const Eigen::MatrixXd unrestrictedMatrix =
+        matrix(*gamma, tda ? 1.0 : 2.0, tda) + 2.0 * h * spinConstants->asDiagonal() * h.transpose();
+    EXPECT_TRUE(singlet.diagonal().isApprox(matrix(*gamma, tda ? 2.0 : 4.0, tda).diagonal(), 1e-12));
+    EXPECT_TRUE(triplet.diagonal().isApprox(tripletMatrix.diagonal(), 1e-12));
+    EXPECT_TRUE(unrestricted.diagonal().isApprox(unrestrictedMatrix.diagonal(), 1e-12));
+  }
+}
+
+TEST_F(ATDDFTBSigmaVectorEvaluator, AppendsNewBlocksToCachedSigmaVectors) {
+  TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> blocked(gamma, spinConstants, restrictedInput);
+  TDDFTBSigmaVectorEvaluator<Utils::Reference::Restricted> columnwise(gamma, spinConstants, restrictedInput);
+  const Eigen::MatrixXd expected = blocked.evaluate(guessVectors);
+  // One guess vector at a time, then two blocks of different size
+  for (int nColumns = 1; nColumns <= guessVectors.cols(); ++nColumns) {
+    columnwise.evaluate(guessVectors.leftCols(nColumns));
+  }
+  EXPECT_TRUE(columnwise.evaluate(guessVectors).isApprox(expected, 1e-12));
+  // Subspace collapse through the diagonalizer interface
+  static_cast<Utils::SigmaVectorEvaluator&>(blocked).collapsed(0);
+  ASSERT_THAT(blocked.evaluate(guessVectors.leftCols(2)).cols(), Eq(2));
+  EXPECT_TRUE(blocked.evaluate(guessVectors).isApprox(expected, 1e-12));
+}
+
+} // namespace Sparrow
+} // namespace Scine
@@ -187,6 +187,57 @@ TEST_F(ATDDFTBTestCalculation, CanCalculateTransitionCharges) {
               DoubleNear(chargeOnC34Beta, 1e-5));
 }
 
+TEST_F(ATDDFTBTestCalculation, StreamedTransitionChargeTilesCoverFullMatrix) {
+  std::stringstream ss("5\n\n"
+                       "C      0.0000000000    0.0000000000    0.0000000000\n"
+                       "H      0.7    0.72    0.64\n"
+                       "H     -0.635   -0.635    0.635\n"
+                       "H     -0.71     0.7287000000   -0.7287000000\n"
+                       "H      0.6287000000   -0.6287000000   -0.6287000000\n");
+  dftb::DFTB2 method;
+  method.setAtomCollection(Utils::XyzStreamHandler::read(ss));
+  method.initializeFromParameterPath("mio-1-1");
+  method.setConvergenceCriteria({{}, 1e-9});
+  method.calculate(Utils::Derivative::None, log);
+
+  transChargeCalc = std::make_unique<TransitionChargesCalculator>(
+      method.getMolecularOrbitals(), method.getOverlapMatrix(), method.getAtomsOrbitalsIndexesHolder());
+  Eigen::MatrixXd streamedCharges;
+  Eigen::VectorXi timesStreamed;
+  auto recordTile = [&](int firstTransition, const Eigen::MatrixXd& tile) {
+#pragma omp critical
+    {
+      streamedCharges.middleRows(firstTransition, tile.rows()) = tile;
+      timesStreamed.segment(firstTransition, tile.rows()).array() += 1;
+    }
+  };
+
+  Eigen::MatrixXd charges =
+      transChargeCalc->calculateAtomicTransitionChargeMatrices<Utils::Reference::Restricted>(method.getElectronicOccupation());
+  for (int nOccupiedPerTile : {1, 3, 100}) {
+    streamedCharges.setZero(charges.rows(), charges.cols());
+    timesStreamed.setZero(charges.rows());
+    transChargeCalc->streamAtomicTransitionChargeMatrices<Utils::Reference::Restricted>(
+        method.getElectronicOccupation(), recordTile, nOccupiedPerTile);
+    EXPECT_TRUE(timesStreamed.isOnes());
+    EXPECT_TRUE(streamedCharges.isApprox(charges, 1e-12));
+  }
+
+  method.setUnrestrictedCalculation(true);
+  method.calculate(Utils::Derivative::None, log);
+  transChargeCalc->fillOverlapProductMatrix();
+  charges =
+      transChargeCalc->calculateAtomicTransitionChargeMatrices<Utils::Reference::Unrestricted>(method.getElectronicOccupation());
+  for (int nOccupiedPerTile : {1, 3, 100}) {
+    streamedCharges.setZero(charges.rows(), charges.cols());
+    timesStreamed.setZero(charges.rows());
+    transChargeCalc->streamAtomicTransitionChargeMatrices<Utils::Reference::Unrestricted>(
+        method.getElectronicOccupation(), recordTile, nOccupiedPerTile);
+    EXPECT_TRUE(timesStreamed.isOnes());
+    EXPECT_TRUE(streamedCharges.isApprox(charges, 1e-12));
+  }
+}
+
 // Check Gamma Matrix against gamma matrix calculated with DFTB+
 TEST_F(ATDDFTBTestCalculation, TDDFTBDataRecordsRightConstants) {
   std::stringstream ss("5\n\n"
@@ -474,6 +525,44 @@ TEST_F(ATDDFTBTestCalculation, CanCalculateEtheneThroughTDDFTBCalculator) {
     EXPECT_THAT(actualEigenvalues(i), DoubleNear(std::sqrt(referenceEigenvalues(i)), 1e-6));
   }
 }
+TEST_F(ATDDFTBTestCalculation, DavidsonGuessesAndPreconditionersGiveSameExcitationEnergies) {
+  std::stringstream etene{"6\n\n"
+                          "C          0.94815        0.05810        0.05008\n"
+                          "C          2.28393        0.05810        0.05008\n"
+                          "H          0.38826       -0.56287        0.74233\n"
+                          "H          0.38826        0.67907       -0.64217\n"
+                          "H          2.84382       -0.56287        0.74233\n"
+                          "H          2.84382        0.67907       -0.64217\n"};
+  dftbMethod->setStructure(Utils::XyzStreamHandler::read(etene));
+  tddftbCalculator->setReferenceCalculator(dftbMethod);
+  tddftbCalculator->referenceCalculation();
+  tddftbCalculator->settings().modifyString(Utils::SettingsNames::spinBlock, "both");
+  tddftbCalculator->settings().modifyInt(Utils::SettingsNames::numberOfEigenstates, 6);
+  tddftbCalculator->settings().modifyDouble("convergence", 1e-7);
+  tddftbCalculator->settings().modifyString("davidson_guess", "energy_differences");
+  tddftbCalculator->settings().modifyString("preconditioner", "energy_differences");
+  const auto reference = tddftbCalculator->calculate().get<Utils::Property::ExcitedStates>();
+
+  for (const auto* guess : {"energy_differences", "diagonal", "subspace"}) {
+    for (const auto* preconditioner : {"energy_differences", "coupled_diagonal"}) {
+      tddftbCalculator->settings().modifyString("davidson_guess", guess);
+      tddftbCalculator->settings().modifyString("preconditioner", preconditioner);
+      const auto excitedStates = tddftbCalculator->calculate().get<Utils::Property::ExcitedStates>();
+      for (int i = 0; i < 6; ++i) {
+        EXPECT_THAT(excitedStates.singlet->eigenStates.eigenValues(i),
+                    DoubleNear(reference.singlet->eigenStates.eigenValues(i), 1e-7));
+        EXPECT_THAT(excitedStates.triplet->eigenStates.eigenValues(i),
+                    DoubleNear(reference.triplet->eigenStates.eigenValues(i), 1e-7));
+      }
+      const auto& iterationCounts = tddftbCalculator->getIterationCounts();
+      ASSERT_THAT(iterationCounts.singlet.size(), Eq(6u));
+      ASSERT_THAT(iterationCounts.triplet.size(), Eq(6u));
+      EXPECT_THAT(iterationCounts.singlet, Each(Gt(0)));
+      EXPECT_THAT(iterationCounts.triplet, Each(Gt(0)));
+    }
+  }
+}
+
 TEST_F(ATDDFTBTestCalculation, CanCalculatePorphyrineThroughTDDFTBCalculator) {
   tddftbCalculator->setReferenceCalculator(dftbPorphMethod);
   tddftbCalculator->referenceCalculation();